@@ -0,0 +1,135 @@
+/**
+ * @file motion_scaling_bench.cpp
+ * @brief Times the motion update of a crowd of characters, serially and on thread pools of growing size.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "linden_common.h"
+
+#include "lltimer.h"
+#include "threadpool.h"
+#include "../tests/testcrowd.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tmotion_scaling_bench [options]\n"
+		"\n"
+		"Plays a crowd of characters through keyframe animations, overlays\n"
+		"and gestures started and stopped the way the simulator would, and\n"
+		"times the motion update per frame: first serially, through\n"
+		"LLCharacter::updateMotions(), then through\n"
+		"LLCharacter::updateMotionsParallel() with one core up to the\n"
+		"largest pool.  The calling thread works too, so n cores is a pool\n"
+		"of n - 1 threads.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -c <count>      Characters in the crowd.  Default:  100\n"
+		" -f <frames>     Frames timed for each pool.  Default:  300\n"
+		" -t <cores>      Largest pool, the calling thread included.  Default:  hardware threads, at most 16\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	S32 characters_count = 100;
+	S32 frames = 300;
+	S32 max_cores = llclamp((S32)std::thread::hardware_concurrency(), 1, 16);
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-c" && i + 1 < argc)
+		{
+			characters_count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-f" && i + 1 < argc)
+		{
+			frames = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-t" && i + 1 < argc)
+		{
+			max_cores = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	AnimSet anims;
+	character_list_t characters;
+	make_characters(characters, characters_count, anims);
+
+	// Serial baseline
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 frame = 0; frame < frames; ++frame)
+	{
+		TestFrameTimer::advance(1.0 / 30.0);
+		script_frame(characters, anims, frame);
+		update_serial(characters);
+	}
+	F64 serial_ms = (LLTimer::getTotalSeconds() - start) * 1000.0 / frames;
+	if (pose_sum(characters) == 0.0)
+	{
+		fprintf(stderr, "The skeletons did not move\n");
+		return 1;
+	}
+
+	fprintf(stdout, "%d characters, %d frames\n", characters_count, frames);
+	fprintf(stdout, "  serial   %8.3f ms per frame\n", serial_ms);
+
+	for (S32 cores = 1; cores <= max_cores; ++cores)
+	{
+		// Pools register a listener under their name, give each its own.
+		const std::string pool_name = llformat("MotionScalingBench%d", cores);
+		LL::ThreadPool pool(pool_name, cores - 1);
+		pool.start();
+
+		start = LLTimer::getTotalSeconds();
+		for (S32 frame = 0; frame < frames; ++frame)
+		{
+			TestFrameTimer::advance(1.0 / 30.0);
+			script_frame(characters, anims, frame);
+			LLCharacter::updateMotionsParallel(characters, pool_name);
+		}
+		F64 parallel_ms = (LLTimer::getTotalSeconds() - start) * 1000.0 / frames;
+		pool.close();
+
+		fprintf(stdout, "  %2d %s %8.3f ms per frame, %.2fx\n", cores, cores > 1 ? "cores" : "core ",
+				parallel_ms, serial_ms / parallel_ms);
+	}
+
+	delete_characters(characters);
+	LLKeyframeDataCache::clear();
+	return 0;
+}
@@ -217,6 +217,29 @@ void LLCharacter::updateMotions(e_update_t update_type)
 	}
 }
 
+// <FS:Kadah> Parallel motion evaluation
+//-----------------------------------------------------------------------------
+// updateMotionsParallel()
+//-----------------------------------------------------------------------------
+// static
+void LLCharacter::updateMotionsParallel(const std::vector<LLCharacter*>& characters,
+										const std::string& pool_name)
+{
+	std::vector<LLMotionController*> controllers;
+	controllers.reserve(characters.size());
+	for (LLCharacter* character : characters)
+	{
+		// as in updateMotions()
+		if (character->mMotionController.isPaused() && character->mPauseRequest->getNumRefs() == 1)
+		{
+			character->mMotionController.unpauseAllMotions();
+		}
+		controllers.push_back(&character->mMotionController);
+	}
+	LLMotionController::updateMotionsParallel(controllers, pool_name);
+}
+// </FS:Kadah>
+
 
 //-----------------------------------------------------------------------------
 // deactivateAllMotions()
@@ -161,6 +161,14 @@ public:
 	enum e_update_t { NORMAL_UPDATE, HIDDEN_UPDATE, FORCE_UPDATE };
 	void updateMotions(e_update_t update_type);
 
+	// <FS:Kadah> Parallel motion evaluation
+	// updateMotions(NORMAL_UPDATE) for several characters at once, with the
+	// keyframe sampling and pose blending of all of them spread over the
+	// named thread pool (see LLMotionController::updateMotionsParallel()).
+	static void updateMotionsParallel(const std::vector<LLCharacter*>& characters,
+									  const std::string& pool_name = "General");
+	// </FS:Kadah>
+
 	LLAnimPauseRequest requestPause();
 	BOOL areAnimationsPaused() const { return mMotionController.isPaused(); }
 	void setAnimTimeFactor(F32 factor) { mMotionController.setTimeFactor(factor); }
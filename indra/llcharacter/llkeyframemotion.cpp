@@ -130,6 +130,101 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo()
 //-----------------------------------------------------------------------------
 
 
+// <FS:Kadah> Flat keyframe tracks
+namespace
+{
+	// Forward steps taken from the cursor before falling back to a binary search
+	const S32 MAX_CURSOR_STEPS = 4;
+
+	// Index of the first key at or after time, as std::lower_bound() would
+	// return it.  Starts from the index of the previous lookup, which normal
+	// forward playback only moves by a key or so per frame.
+	S32 find_key(const std::vector<F32>& times, F32 time, S32& cursor)
+	{
+		const S32 count = (S32)times.size();
+		S32 right = llclamp(cursor, 0, count);
+		if (right > 0 && times[right - 1] >= time)
+		{
+			// Went back, looped or restarted
+			right = (S32)(std::lower_bound(times.begin(), times.end(), time) - times.begin());
+		}
+		else
+		{
+			S32 steps = 0;
+			while (right < count && times[right] < time)
+			{
+				if (++steps > MAX_CURSOR_STEPS)
+				{
+					right = (S32)(std::lower_bound(times.begin() + right, times.end(), time) - times.begin());
+					break;
+				}
+				++right;
+			}
+		}
+		cursor = right;
+		return right;
+	}
+
+	inline LLVector3 to_vector3(const LLVector4a& v)
+	{
+		return LLVector3(v.getF32ptr());
+	}
+
+	inline LLQuaternion to_quaternion(const LLVector4a& v)
+	{
+		LLQuaternion q;
+		const F32* src = v.getF32ptr();
+		q.mQ[VX] = src[VX];
+		q.mQ[VY] = src[VY];
+		q.mQ[VZ] = src[VZ];
+		q.mQ[VW] = src[VW];
+		return q;
+	}
+
+	// nlerp() on LLVector4a:  lerp and normalize when both are on the same
+	// hemisphere, slerp() otherwise.
+	inline LLQuaternion nlerp4a(F32 u, const LLVector4a& a, const LLVector4a& b)
+	{
+		LLVector4a result;
+		F32 cos_t = a.dot4(b).getF32();
+		if (cos_t < 0.f)
+		{
+			// b is on the opposite hemisphere from a, use -a instead
+			cos_t = -cos_t;
+			F32 alpha;
+			F32 beta;
+			if (1.f - cos_t < 0.00001f)
+			{
+				beta = 1.f - u;
+				alpha = u;
+			}
+			else
+			{
+				F32 theta = acosf(cos_t);
+				F32 sin_t = sinf(theta);
+				beta = sinf(theta - u * theta) / sin_t;
+				alpha = sinf(u * theta) / sin_t;
+			}
+			LLVector4a scaled_b(b);
+			scaled_b.mul(alpha);
+			result = a;
+			result.mul(-beta);
+			result.add(scaled_b);
+		}
+		else
+		{
+			result.setLerp(a, b, u);
+			if (result.dot4(result).getF32() <= FP_MAG_THRESHOLD * FP_MAG_THRESHOLD)
+			{
+				return LLQuaternion::DEFAULT;
+			}
+			result.normalize4();
+		}
+		return to_quaternion(result);
+	}
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // ScaleCurve::ScaleCurve()
 //-----------------------------------------------------------------------------
@@ -142,53 +237,86 @@ LLKeyframeMotion::ScaleCurve::ScaleCurve()
 //-----------------------------------------------------------------------------
 // ScaleCurve::~ScaleCurve()
 //-----------------------------------------------------------------------------
-LLKeyframeMotion::ScaleCurve::~ScaleCurve() 
+LLKeyframeMotion::ScaleCurve::~ScaleCurve()
 {
-	mKeys.clear();
+	// <FS:Kadah> Flat keyframe tracks
+	//mKeys.clear();
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	// </FS:Kadah>
 	mNumKeys = 0;
 }
 
+// <FS:Kadah> Flat keyframe tracks
 //-----------------------------------------------------------------------------
-// getValue()
+// ScaleCurve::setKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::ScaleCurve::setKeys(const key_map_t& keys)
+{
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(keys.size());
+	mKeyValues.reserve(keys.size());
+	for (const key_map_t::value_type& key : keys)
+	{
+		LLVector4a value;
+		value.load3(key.second.mScale.mV);
+		mKeyTimes.push_back(key.first);
+		mKeyValues.push_back(value);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// ScaleCurve::getKey()
+//-----------------------------------------------------------------------------
+LLKeyframeMotion::ScaleKey LLKeyframeMotion::ScaleCurve::getKey(S32 index) const
+{
+	llassert(index >= 0 && index < getKeyCount());
+	return ScaleKey(mKeyTimes[index], to_vector3(mKeyValues[index]));
+}
+
+//-----------------------------------------------------------------------------
+// ScaleCurve::getValue()
 //-----------------------------------------------------------------------------
 LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
+{
+	S32 cursor = 0;
+	return getValue(time, duration, cursor);
+}
+
+//-----------------------------------------------------------------------------
+// ScaleCurve::getValue()
+//-----------------------------------------------------------------------------
+LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration, S32& cursor) const
 {
 	LLVector3 value;
 
-	if (mKeys.empty())
+	if (mKeyTimes.empty())
 	{
 		value.clearVec();
 		return value;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	const S32 count = (S32)mKeyTimes.size();
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == count)
 	{
 		// Past last key
-		--right;
-		value = right->second.mScale;
+		value = to_vector3(mKeyValues[count - 1]);
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	else if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mScale;
+		value = to_vector3(mKeyValues[right]);
 	}
 	else
 	{
 		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		ScaleKey& scale_before = left->second;
-		ScaleKey& scale_after = right->second;
-		if (right == mKeys.end())
-		{
-			scale_after = mLoopInKey;
-			index_after = duration;
-		}
+		F32 index_before = mKeyTimes[right - 1];
+		F32 index_after = mKeyTimes[right];
 
 		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, scale_before, scale_after);
+		value = interp(u, mKeyValues[right - 1], mKeyValues[right]);
 	}
 	return value;
 }
@@ -196,19 +324,24 @@ LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, ScaleKey& before, ScaleKey& after)
+LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, const LLVector4a& before, const LLVector4a& after) const
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mScale;
+		return to_vector3(before);
 
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return lerp(before.mScale, after.mScale, u);
+	{
+		LLVector4a value;
+		value.setLerp(before, after, u);
+		return to_vector3(value);
+	}
 	}
 }
+// </FS:Kadah>
 
 //-----------------------------------------------------------------------------
 // RotationCurve::RotationCurve()
@@ -224,51 +357,84 @@ LLKeyframeMotion::RotationCurve::RotationCurve()
 //-----------------------------------------------------------------------------
 LLKeyframeMotion::RotationCurve::~RotationCurve()
 {
-	mKeys.clear();
+	// <FS:Kadah> Flat keyframe tracks
+	//mKeys.clear();
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	// </FS:Kadah>
 	mNumKeys = 0;
 }
 
+// <FS:Kadah> Flat keyframe tracks
+//-----------------------------------------------------------------------------
+// RotationCurve::setKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::RotationCurve::setKeys(const key_map_t& keys)
+{
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(keys.size());
+	mKeyValues.reserve(keys.size());
+	for (const key_map_t::value_type& key : keys)
+	{
+		LLVector4a value;
+		value.loadua(key.second.mRotation.mQ);
+		mKeyTimes.push_back(key.first);
+		mKeyValues.push_back(value);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// RotationCurve::getKey()
+//-----------------------------------------------------------------------------
+LLKeyframeMotion::RotationKey LLKeyframeMotion::RotationCurve::getKey(S32 index) const
+{
+	llassert(index >= 0 && index < getKeyCount());
+	return RotationKey(mKeyTimes[index], to_quaternion(mKeyValues[index]));
+}
+
 //-----------------------------------------------------------------------------
 // RotationCurve::getValue()
 //-----------------------------------------------------------------------------
 LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
+{
+	S32 cursor = 0;
+	return getValue(time, duration, cursor);
+}
+
+//-----------------------------------------------------------------------------
+// RotationCurve::getValue()
+//-----------------------------------------------------------------------------
+LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration, S32& cursor) const
 {
 	LLQuaternion value;
 
-	if (mKeys.empty())
+	if (mKeyTimes.empty())
 	{
 		value = LLQuaternion::DEFAULT;
 		return value;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	const S32 count = (S32)mKeyTimes.size();
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == count)
 	{
 		// Past last key
-		--right;
-		value = right->second.mRotation;
+		value = to_quaternion(mKeyValues[count - 1]);
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	else if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mRotation;
+		value = to_quaternion(mKeyValues[right]);
 	}
 	else
 	{
 		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		RotationKey& rot_before = left->second;
-		RotationKey& rot_after = right->second;
-		if (right == mKeys.end())
-		{
-			rot_after = mLoopInKey;
-			index_after = duration;
-		}
+		F32 index_before = mKeyTimes[right - 1];
+		F32 index_after = mKeyTimes[right];
 
 		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, rot_before, rot_after);
+		value = interp(u, mKeyValues[right - 1], mKeyValues[right]);
 	}
 	return value;
 }
@@ -276,20 +442,20 @@ LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, RotationKey& before, RotationKey& after)
+LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, const LLVector4a& before, const LLVector4a& after) const
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mRotation;
+		return to_quaternion(before);
 
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return nlerp(u, before.mRotation, after.mRotation);
+		return nlerp4a(u, before, after);
 	}
 }
-
+// </FS:Kadah>
 
 //-----------------------------------------------------------------------------
 // PositionCurve::PositionCurve()
@@ -305,73 +471,111 @@ LLKeyframeMotion::PositionCurve::PositionCurve()
 //-----------------------------------------------------------------------------
 LLKeyframeMotion::PositionCurve::~PositionCurve()
 {
-	mKeys.clear();
+	// <FS:Kadah> Flat keyframe tracks
+	//mKeys.clear();
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	// </FS:Kadah>
 	mNumKeys = 0;
 }
 
+// <FS:Kadah> Flat keyframe tracks
+//-----------------------------------------------------------------------------
+// PositionCurve::setKeys()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::PositionCurve::setKeys(const key_map_t& keys)
+{
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(keys.size());
+	mKeyValues.reserve(keys.size());
+	for (const key_map_t::value_type& key : keys)
+	{
+		LLVector4a value;
+		value.load3(key.second.mPosition.mV);
+		mKeyTimes.push_back(key.first);
+		mKeyValues.push_back(value);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// PositionCurve::getKey()
+//-----------------------------------------------------------------------------
+LLKeyframeMotion::PositionKey LLKeyframeMotion::PositionCurve::getKey(S32 index) const
+{
+	llassert(index >= 0 && index < getKeyCount());
+	return PositionKey(mKeyTimes[index], to_vector3(mKeyValues[index]));
+}
+
 //-----------------------------------------------------------------------------
 // PositionCurve::getValue()
 //-----------------------------------------------------------------------------
 LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
+{
+	S32 cursor = 0;
+	return getValue(time, duration, cursor);
+}
+
+//-----------------------------------------------------------------------------
+// PositionCurve::getValue()
+//-----------------------------------------------------------------------------
+LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration, S32& cursor) const
 {
 	LLVector3 value;
 
-	if (mKeys.empty())
+	if (mKeyTimes.empty())
 	{
 		value.clearVec();
 		return value;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	const S32 count = (S32)mKeyTimes.size();
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == count)
 	{
 		// Past last key
-		--right;
-		value = right->second.mPosition;
+		value = to_vector3(mKeyValues[count - 1]);
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	else if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mPosition;
+		value = to_vector3(mKeyValues[right]);
 	}
 	else
 	{
 		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		PositionKey& pos_before = left->second;
-		PositionKey& pos_after = right->second;
-		if (right == mKeys.end())
-		{
-			pos_after = mLoopInKey;
-			index_after = duration;
-		}
+		F32 index_before = mKeyTimes[right - 1];
+		F32 index_after = mKeyTimes[right];
 
 		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, pos_before, pos_after);
+		value = interp(u, mKeyValues[right - 1], mKeyValues[right]);
 	}
 
 	llassert(value.isFinite());
-	
 	return value;
 }
 
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, PositionKey& after)
+LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, const LLVector4a& before, const LLVector4a& after) const
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mPosition;
+		return to_vector3(before);
+
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return lerp(before.mPosition, after.mPosition, u);
+	{
+		LLVector4a value;
+		value.setLerp(before, after, u);
+		return to_vector3(value);
+	}
 	}
 }
+// </FS:Kadah>
 
 
 //-----------------------------------------------------------------------------
@@ -383,7 +587,10 @@ LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, Po
 //-----------------------------------------------------------------------------
 // JointMotion::update()
 //-----------------------------------------------------------------------------
-void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time, F32 duration)
+// <FS:Kadah> Flat keyframe tracks
+//void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time, F32 duration)
+void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time, F32 duration, JointCursor& cursor)
+// </FS:Kadah>
 {
 	// this value being 0 is the cause of https://jira.lindenlab.com/browse/SL-22678 but I haven't 
 	// managed to get a stack to see how it got here. Testing for 0 here will stop the crash.
@@ -399,7 +606,10 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
 	//-------------------------------------------------------------------------
 	if ((usage & LLJointState::SCALE) && mScaleCurve.mNumKeys)
 	{
-		joint_state->setScale( mScaleCurve.getValue( time, duration ) );
+		// <FS:Kadah> Flat keyframe tracks
+		//joint_state->setScale( mScaleCurve.getValue( time, duration ) );
+		joint_state->setScale( mScaleCurve.getValue( time, duration, cursor.mScale ) );
+		// </FS:Kadah>
 	}
 
 	//-------------------------------------------------------------------------
@@ -407,7 +617,10 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
 	//-------------------------------------------------------------------------
 	if ((usage & LLJointState::ROT) && mRotationCurve.mNumKeys)
 	{
-		joint_state->setRotation( mRotationCurve.getValue( time, duration ) );
+		// <FS:Kadah> Flat keyframe tracks
+		//joint_state->setRotation( mRotationCurve.getValue( time, duration ) );
+		joint_state->setRotation( mRotationCurve.getValue( time, duration, cursor.mRotation ) );
+		// </FS:Kadah>
 	}
 
 	//-------------------------------------------------------------------------
@@ -415,7 +628,10 @@ void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time,
 	//-------------------------------------------------------------------------
 	if ((usage & LLJointState::POS) && mPositionCurve.mNumKeys)
 	{
-		joint_state->setPosition( mPositionCurve.getValue( time, duration ) );
+		// <FS:Kadah> Flat keyframe tracks
+		//joint_state->setPosition( mPositionCurve.getValue( time, duration ) );
+		joint_state->setPosition( mPositionCurve.getValue( time, duration, cursor.mPosition ) );
+		// </FS:Kadah>
 	}
 }
 
@@ -725,17 +941,37 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 	return mLastLoopedTime <= mJointMotionList->mDuration;
 }
 
+// <FS:Kadah> Parallel motion evaluation
+//-----------------------------------------------------------------------------
+// LLKeyframeMotion::canUpdateOffMainThread()
+//-----------------------------------------------------------------------------
+BOOL LLKeyframeMotion::canUpdateOffMainThread()
+{
+	return mJointMotionList && mConstraints.empty();
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // applyKeyframes()
 //-----------------------------------------------------------------------------
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
 	llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
+	// <FS:Kadah> Flat keyframe tracks
+	if (mJointCursors.size() != mJointStates.size())
+	{
+		mJointCursors.resize(mJointStates.size());
+	}
+	// </FS:Kadah>
 	for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
 	{
 		mJointMotionList->getJointMotion(i)->update(mJointStates[i],
 													  time, 
-													  mJointMotionList->mDuration );
+													  // <FS:Kadah> Flat keyframe tracks
+													  //mJointMotionList->mDuration );
+													  mJointMotionList->mDuration,
+													  mJointCursors[i] );
+													  // </FS:Kadah>
 	}
 
 	LLJoint::JointPriority* pose_priority = (LLJoint::JointPriority* )mCharacter->getAnimationData("Hand Pose Priority");
@@ -1527,6 +1763,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 		// scan rotation curve keys
 		//---------------------------------------------------------------------
 		RotationCurve *rCurve = &joint_motion->mRotationCurve;
+		RotationCurve::key_map_t rot_keys; // <FS:Kadah/> Flat keyframe tracks
 
 		for (S32 k = 0; k < joint_motion->mRotationCurve.mNumKeys; k++)
 		{
@@ -1623,10 +1860,17 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 				return FALSE;
 			}
 
-			rCurve->mKeys[time] = rot_key;
+			// <FS:Kadah> Flat keyframe tracks
+			//rCurve->mKeys[time] = rot_key;
+			rot_keys[time] = rot_key;
+			// </FS:Kadah>
 		}
+		rCurve->setKeys(rot_keys); // <FS:Kadah/> Flat keyframe tracks
 
-        if (joint_motion->mRotationCurve.mNumKeys > joint_motion->mRotationCurve.mKeys.size())
+        // <FS:Kadah> Flat keyframe tracks
+        //if (joint_motion->mRotationCurve.mNumKeys > joint_motion->mRotationCurve.mKeys.size())
+        if (joint_motion->mRotationCurve.mNumKeys > rCurve->getKeyCount())
+        // </FS:Kadah>
         {
             rotation_dupplicates++;
             LL_INFOS() << "Motion: " << asset_id << " had dupplicate rotation keys that were removed" << LL_ENDL;
@@ -1652,6 +1896,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 		// scan position curve keys
 		//---------------------------------------------------------------------
 		PositionCurve *pCurve = &joint_motion->mPositionCurve;
+		PositionCurve::key_map_t pos_keys; // <FS:Kadah/> Flat keyframe tracks
 		BOOL is_pelvis = joint_motion->mJointName == "mPelvis";
 		for (S32 k = 0; k < joint_motion->mPositionCurve.mNumKeys; k++)
 		{
@@ -1726,7 +1971,10 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 				return FALSE;
 			}
 			
-			pCurve->mKeys[pos_key.mTime] = pos_key;
+			// <FS:Kadah> Flat keyframe tracks
+			//pCurve->mKeys[pos_key.mTime] = pos_key;
+			pos_keys[pos_key.mTime] = pos_key;
+			// </FS:Kadah>
 
 			if (is_pelvis)
 			{
@@ -1734,7 +1982,12 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id, boo
 			}
 		}
 
-        if (joint_motion->mPositionCurve.mNumKeys > joint_motion->mPositionCurve.mKeys.size())
+		pCurve->setKeys(pos_keys); // <FS:Kadah/> Flat keyframe tracks
+
+        // <FS:Kadah> Flat keyframe tracks
+        //if (joint_motion->mPositionCurve.mNumKeys > joint_motion->mPositionCurve.mKeys.size())
+        if (joint_motion->mPositionCurve.mNumKeys > pCurve->getKeyCount())
+        // </FS:Kadah>
         {
             position_dupplicates++;
         }
@@ -2031,15 +2284,28 @@ BOOL LLKeyframeMotion::serialize(LLDataPacker& dp) const
 		JointMotion* joint_motionp = mJointMotionList->getJointMotion(i);
 		success &= dp.packString(joint_motionp->mJointName, "joint_name");
 		success &= dp.packS32(joint_motionp->mPriority, "joint_priority");
-        success &= dp.packS32(joint_motionp->mRotationCurve.mKeys.size(), "num_rot_keys");
+        // <FS:Kadah> Flat keyframe tracks
+        //success &= dp.packS32(joint_motionp->mRotationCurve.mKeys.size(), "num_rot_keys");
+        const RotationCurve& rot_curve = joint_motionp->mRotationCurve;
+        const PositionCurve& pos_curve = joint_motionp->mPositionCurve;
+        success &= dp.packS32(rot_curve.getKeyCount(), "num_rot_keys");
+        // </FS:Kadah>
 
         LL_DEBUGS("BVH") << "Joint " << i
             << " name: " << joint_motionp->mJointName
-            << " Rotation keys: " << joint_motionp->mRotationCurve.mKeys.size()
-            << " Position keys: " << joint_motionp->mPositionCurve.mKeys.size() << LL_ENDL;
-        for (RotationCurve::key_map_t::value_type& rot_pair : joint_motionp->mRotationCurve.mKeys)
+            // <FS:Kadah> Flat keyframe tracks
+            //<< " Rotation keys: " << joint_motionp->mRotationCurve.mKeys.size()
+            //<< " Position keys: " << joint_motionp->mPositionCurve.mKeys.size() << LL_ENDL;
+        //for (RotationCurve::key_map_t::value_type& rot_pair : joint_motionp->mRotationCurve.mKeys)
+            << " Rotation keys: " << rot_curve.getKeyCount()
+            << " Position keys: " << pos_curve.getKeyCount() << LL_ENDL;
+        for (S32 k = 0; k < rot_curve.getKeyCount(); ++k)
+        // </FS:Kadah>
 		{
-			RotationKey& rot_key = rot_pair.second;
+			// <FS:Kadah> Flat keyframe tracks
+			//RotationKey& rot_key = rot_pair.second;
+			RotationKey rot_key = rot_curve.getKey(k);
+			// </FS:Kadah>
 			U16 time_short = F32_to_U16(rot_key.mTime, 0.f, mJointMotionList->mDuration);
 			success &= dp.packU16(time_short, "time");
 
@@ -2057,10 +2323,17 @@ BOOL LLKeyframeMotion::serialize(LLDataPacker& dp) const
 			LL_DEBUGS("BVH") << "  rot: t " << rot_key.mTime << " angles " << rot_angles.mV[VX] <<","<< rot_angles.mV[VY] <<","<< rot_angles.mV[VZ] << LL_ENDL;
 		}
 
-		success &= dp.packS32(joint_motionp->mPositionCurve.mKeys.size(), "num_pos_keys");
-		for (PositionCurve::key_map_t::value_type& pos_pair : joint_motionp->mPositionCurve.mKeys)
+		// <FS:Kadah> Flat keyframe tracks
+		//success &= dp.packS32(joint_motionp->mPositionCurve.mKeys.size(), "num_pos_keys");
+		//for (PositionCurve::key_map_t::value_type& pos_pair : joint_motionp->mPositionCurve.mKeys)
+		success &= dp.packS32(pos_curve.getKeyCount(), "num_pos_keys");
+		for (S32 k = 0; k < pos_curve.getKeyCount(); ++k)
+		// </FS:Kadah>
 		{
-			PositionKey& pos_key = pos_pair.second;
+			// <FS:Kadah> Flat keyframe tracks
+			//PositionKey& pos_key = pos_pair.second;
+			PositionKey pos_key = pos_curve.getKey(k);
+			// </FS:Kadah>
 			U16 time_short = F32_to_U16(pos_key.mTime, 0.f, mJointMotionList->mDuration);
 			success &= dp.packU16(time_short, "time");
 
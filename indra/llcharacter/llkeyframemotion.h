@@ -39,6 +39,7 @@
 #include "lljointstate.h"
 #include "llmotion.h"
 #include "llquaternion.h"
+#include "llvector4a.h" // <FS:Kadah/> Flat keyframe tracks
 #include "v3dmath.h"
 #include "v3math.h"
 #include "llbvhconsts.h"
@@ -144,6 +145,12 @@ public:
 	// must return FALSE when the motion is completed.
 	virtual BOOL onUpdate(F32 time, U8* joint_mask);
 
+	// <FS:Kadah> Parallel motion evaluation
+	// Plain keyframe sampling only; constraints read the world positions of
+	// joints and the ground.
+	virtual BOOL canUpdateOffMainThread();
+	// </FS:Kadah>
+
 	// called when a motion is deactivated
 	virtual void onDeactivate();
 
@@ -326,12 +333,25 @@ public:
 		ScaleCurve();
 		~ScaleCurve();
 		LLVector3 getValue(F32 time, F32 duration);
-		LLVector3 interp(F32 u, ScaleKey& before, ScaleKey& after);
+		// <FS:Kadah> Flat keyframe tracks
+		//LLVector3 interp(F32 u, ScaleKey& before, ScaleKey& after);
+		LLVector3 getValue(F32 time, F32 duration, S32& cursor) const;
+		LLVector3 interp(F32 u, const LLVector4a& before, const LLVector4a& after) const;
+
+		// Replaces the keys with the sorted contents of the map
+		void setKeys(const std::map<F32, ScaleKey>& keys);
+		S32 getKeyCount() const { return (S32)mKeyTimes.size(); }
+		ScaleKey getKey(S32 index) const;
+		// </FS:Kadah>
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
 		typedef std::map<F32, ScaleKey> key_map_t;
-		key_map_t 			mKeys;
+		// <FS:Kadah> Key times and values in separate sorted arrays, looked up from a cursor
+		//key_map_t 			mKeys;
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLVector4a>	mKeyValues;
+		// </FS:Kadah>
 		ScaleKey			mLoopInKey;
 		ScaleKey			mLoopOutKey;
 	};
@@ -345,12 +365,25 @@ public:
 		RotationCurve();
 		~RotationCurve();
 		LLQuaternion getValue(F32 time, F32 duration);
-		LLQuaternion interp(F32 u, RotationKey& before, RotationKey& after);
+		// <FS:Kadah> Flat keyframe tracks
+		//LLQuaternion interp(F32 u, RotationKey& before, RotationKey& after);
+		LLQuaternion getValue(F32 time, F32 duration, S32& cursor) const;
+		LLQuaternion interp(F32 u, const LLVector4a& before, const LLVector4a& after) const;
+
+		// Replaces the keys with the sorted contents of the map
+		void setKeys(const std::map<F32, RotationKey>& keys);
+		S32 getKeyCount() const { return (S32)mKeyTimes.size(); }
+		RotationKey getKey(S32 index) const;
+		// </FS:Kadah>
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
 		typedef std::map<F32, RotationKey> key_map_t;
-		key_map_t		mKeys;
+		// <FS:Kadah> Key times and values in separate sorted arrays, looked up from a cursor
+		//key_map_t		mKeys;
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLVector4a>	mKeyValues;
+		// </FS:Kadah>
 		RotationKey		mLoopInKey;
 		RotationKey		mLoopOutKey;
 	};
@@ -364,16 +397,46 @@ public:
 		PositionCurve();
 		~PositionCurve();
 		LLVector3 getValue(F32 time, F32 duration);
-		LLVector3 interp(F32 u, PositionKey& before, PositionKey& after);
+		// <FS:Kadah> Flat keyframe tracks
+		//LLVector3 interp(F32 u, PositionKey& before, PositionKey& after);
+		LLVector3 getValue(F32 time, F32 duration, S32& cursor) const;
+		LLVector3 interp(F32 u, const LLVector4a& before, const LLVector4a& after) const;
+
+		// Replaces the keys with the sorted contents of the map
+		void setKeys(const std::map<F32, PositionKey>& keys);
+		S32 getKeyCount() const { return (S32)mKeyTimes.size(); }
+		PositionKey getKey(S32 index) const;
+		// </FS:Kadah>
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
 		typedef std::map<F32, PositionKey> key_map_t;
-		key_map_t		mKeys;
+		// <FS:Kadah> Key times and values in separate sorted arrays, looked up from a cursor
+		//key_map_t		mKeys;
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLVector4a>	mKeyValues;
+		// </FS:Kadah>
 		PositionKey		mLoopInKey;
 		PositionKey		mLoopOutKey;
 	};
 
+	// <FS:Kadah> Flat keyframe tracks
+	//-------------------------------------------------------------------------
+	// JointCursor
+	// Key index of the last lookup on each curve.  Kept per motion instance,
+	// the curves are shared through LLKeyframeDataCache.
+	//-------------------------------------------------------------------------
+	class JointCursor
+	{
+	public:
+		JointCursor() : mScale(0), mRotation(0), mPosition(0) {}
+
+		S32 mScale;
+		S32 mRotation;
+		S32 mPosition;
+	};
+	// </FS:Kadah>
+
 	//-------------------------------------------------------------------------
 	// JointMotion
 	//-------------------------------------------------------------------------
@@ -387,7 +450,10 @@ public:
 		U32				mUsage;
 		LLJoint::JointPriority	mPriority;
 
-		void update(LLJointState* joint_state, F32 time, F32 duration);
+		// <FS:Kadah> Flat keyframe tracks
+		//void update(LLJointState* joint_state, F32 time, F32 duration);
+		void update(LLJointState* joint_state, F32 time, F32 duration, JointCursor& cursor);
+		// </FS:Kadah>
 	};
 	
 	//-------------------------------------------------------------------------
@@ -424,6 +490,7 @@ public:
 protected:
 	JointMotionList*				mJointMotionList;
 	std::vector<LLPointer<LLJointState> > mJointStates;
+	std::vector<JointCursor>		mJointCursors; // <FS:Kadah/> Parallel to mJointStates
 	LLJoint*						mPelvisp;
 	LLCharacter*					mCharacter;
 	typedef std::list<JointConstraint*>	constraint_list_t;
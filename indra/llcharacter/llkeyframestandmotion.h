@@ -67,6 +67,9 @@ public:
 	void	onDeactivate();
 	virtual BOOL onUpdate(F32 time, U8* joint_mask);
 
+	// <FS:Kadah/> Reads world positions of the skeleton, stays on the main thread
+	virtual BOOL canUpdateOffMainThread() { return FALSE; }
+
 public:
 	//-------------------------------------------------------------------------
 	// Member Data
@@ -148,6 +148,14 @@ public:
 	// must return FALSE when the motion is completed.
 	virtual BOOL onUpdate(F32 activeTime, U8* joint_mask) = 0;
 
+	// <FS:Kadah> Parallel motion evaluation
+	// TRUE if onUpdate() may run on a worker thread, concurrently with the
+	// updates of other characters. It may then touch nothing but the motion
+	// itself, its joint states and the character's animation data, and the
+	// joints it reads must not be animated in the same frame.
+	virtual BOOL canUpdateOffMainThread() { return FALSE; }
+	// </FS:Kadah>
+
 	// called when a motion is deactivated
 	virtual void onDeactivate() = 0;
 
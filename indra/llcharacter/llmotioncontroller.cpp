@@ -36,6 +36,7 @@
 #include "lltimer.h"
 #include "llanimationstates.h"
 #include "llstl.h"
+#include "parallelfor.h" // <FS:Kadah/> Parallel motion evaluation
 
 // This is why LL_CHARACTER_MAX_ANIMATED_JOINTS needs to be a multiple of 4.
 const S32 NUM_JOINT_SIGNATURE_STRIDES = LL_CHARACTER_MAX_ANIMATED_JOINTS / 4;
@@ -141,6 +142,8 @@ LLMotionController::LLMotionController()
 	  mTimeStepCount(0),
 	  mLastInterp(0.f),
 	  mIsSelf(FALSE),
+	  mDeferUpdates(false), // <FS:Kadah/> Parallel motion evaluation
+	  mBlendPending(false), // <FS:Kadah/> Parallel motion evaluation
 	  mLastCountAfterPurge(0)
 {
 }
@@ -661,7 +664,10 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 				// if not, let's stop it this time through and deactivate it the next
 
 				posep->setWeight(motionp->getFadeWeight());
-				motionp->onUpdate(motionp->getStopTime() - motionp->mActivationTimestamp, last_joint_signature);
+				// <FS:Kadah> Parallel motion evaluation
+				//motionp->onUpdate(motionp->getStopTime() - motionp->mActivationTimestamp, last_joint_signature);
+				runMotionUpdate(motionp, motionp->getStopTime() - motionp->mActivationTimestamp, last_joint_signature);
+				// </FS:Kadah>
 			}
 			else
 			{
@@ -693,7 +699,10 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 			}
 
 			// perform motion update
-			update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			// <FS:Kadah> Parallel motion evaluation
+			//update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			update_result = runMotionUpdate(motionp, mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			// </FS:Kadah>
 		}
 
 		//**********************
@@ -717,7 +726,10 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 
 			// perform motion update
 			{
-				update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+				// <FS:Kadah> Parallel motion evaluation
+				//update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+				update_result = runMotionUpdate(motionp, mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+				// </FS:Kadah>
 			}
 		}
 
@@ -740,12 +752,18 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 				posep->setWeight(motionp->getFadeWeight() * motionp->mResidualWeight + (1.f - motionp->mResidualWeight) * cubic_step((mAnimTime - motionp->mActivationTimestamp) / motionp->getEaseInDuration()));
 			}
 			// perform motion update
-			update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			// <FS:Kadah> Parallel motion evaluation
+			//update_result = motionp->onUpdate(mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			update_result = runMotionUpdate(motionp, mAnimTime - motionp->mActivationTimestamp, last_joint_signature);
+			// </FS:Kadah>
 		}
 		else
 		{
 			posep->setWeight(0.f);
-			update_result = motionp->onUpdate(0.f, last_joint_signature);
+			// <FS:Kadah> Parallel motion evaluation
+			//update_result = motionp->onUpdate(0.f, last_joint_signature);
+			update_result = runMotionUpdate(motionp, 0.f, last_joint_signature);
+			// </FS:Kadah>
 		}
 		
 		// allow motions to deactivate themselves 
@@ -900,6 +918,13 @@ void LLMotionController::updateMotions(bool force_update)
 		{
 			mPoseBlender.blendAndCache(TRUE);
 		}
+		// <FS:Kadah> Parallel motion evaluation
+		else if (mDeferUpdates)
+		{
+			// blended by runDeferredUpdates(), applied by finishDeferredUpdates()
+			mBlendPending = true;
+		}
+		// </FS:Kadah>
 		else
 		{
 			mPoseBlender.blendAndApply();
@@ -910,6 +935,109 @@ void LLMotionController::updateMotions(bool force_update)
 //	LL_INFOS() << "Motion controller time " << motionTimer.getElapsedTimeF32() << LL_ENDL;
 }
 
+// <FS:Kadah> Parallel motion evaluation
+//-----------------------------------------------------------------------------
+// updateMotionsParallel()
+//-----------------------------------------------------------------------------
+// static
+void LLMotionController::updateMotionsParallel(const std::vector<LLMotionController*>& controllers,
+											   const std::string& pool_name)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+	std::vector<LLMotionController*> deferred;
+	deferred.reserve(controllers.size());
+	for (LLMotionController* controller : controllers)
+	{
+		// the time quantum path interpolates towards its own cached pose
+		controller->mDeferUpdates = (controller->mTimeStep == 0.f);
+		controller->updateMotions();
+		controller->mDeferUpdates = false;
+		if (controller->hasDeferredUpdates())
+		{
+			deferred.push_back(controller);
+		}
+	}
+
+	if (deferred.empty())
+	{
+		return;
+	}
+
+	LL::parallelFor(pool_name, deferred.size(), [&deferred](size_t i)
+	{
+		deferred[i]->runDeferredUpdates();
+	});
+
+	for (LLMotionController* controller : deferred)
+	{
+		controller->finishDeferredUpdates();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// runMotionUpdate()
+//-----------------------------------------------------------------------------
+BOOL LLMotionController::runMotionUpdate(LLMotion* motionp, F32 time, U8* joint_mask)
+{
+	if (!mDeferUpdates || !motionp->canUpdateOffMainThread())
+	{
+		return motionp->onUpdate(time, joint_mask);
+	}
+
+	DeferredUpdate update;
+	update.mMotion = motionp;
+	update.mTime = time;
+	update.mResult = TRUE;
+	memcpy(update.mJointMask, joint_mask, sizeof(update.mJointMask));
+	mDeferredUpdates.push_back(update);
+
+	// the result is acted upon by finishDeferredUpdates()
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// runDeferredUpdates()
+//-----------------------------------------------------------------------------
+void LLMotionController::runDeferredUpdates()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+	for (DeferredUpdate& update : mDeferredUpdates)
+	{
+		update.mResult = update.mMotion->onUpdate(update.mTime, update.mJointMask);
+	}
+
+	if (mBlendPending)
+	{
+		mPoseBlender.blendAndCache(TRUE);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// finishDeferredUpdates()
+//-----------------------------------------------------------------------------
+void LLMotionController::finishDeferredUpdates()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+	for (const DeferredUpdate& update : mDeferredUpdates)
+	{
+		LLMotion* motionp = update.mMotion;
+		// same as in updateMotionsByType(), allow motions to deactivate themselves
+		if (!update.mResult && (!motionp->isStopped() || motionp->getStopTime() > mAnimTime))
+		{
+			mCharacter->requestStopMotion( motionp );
+			stopMotionInstance(motionp, FALSE);
+		}
+	}
+	mDeferredUpdates.clear();
+
+	if (mBlendPending)
+	{
+		mPoseBlender.applyCache();
+		mBlendPending = false;
+	}
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // updateMotionsMinimal()
 // minimal update (e.g. while hidden)
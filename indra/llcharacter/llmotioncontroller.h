@@ -33,6 +33,7 @@
 #include <string>
 #include <map>
 #include <deque>
+#include <vector>
 
 #include "llmotion.h"
 #include "llpose.h"
@@ -132,6 +133,17 @@ public:
 	// deactivates terminated motions`
 	void updateMotions(bool force_update = false);
 
+	// <FS:Kadah> Parallel motion evaluation
+	// updateMotions() for several controllers at once. Everything but the
+	// updates of motions that canUpdateOffMainThread() and the pose blending
+	// runs in place, as in updateMotions(). Those run next on the named
+	// LL::ThreadPool, one task per controller, with the calling thread
+	// taking its share. The blended poses are then written to the skeletons
+	// on the calling thread.
+	static void updateMotionsParallel(const std::vector<LLMotionController*>& controllers,
+									  const std::string& pool_name = "General");
+	// </FS:Kadah>
+
 	// minimal update (e.g. while hidden)
 	void updateMotionsMinimal();
 
@@ -195,6 +207,24 @@ protected:
 	void purgeExcessMotions();
 	void deactivateStoppedMotions();
 
+	// <FS:Kadah> Parallel motion evaluation
+	struct DeferredUpdate
+	{
+		LLMotion*	mMotion;
+		F32			mTime;
+		BOOL		mResult;
+		U8			mJointMask[LL_CHARACTER_MAX_ANIMATED_JOINTS];
+	};
+
+	// onUpdate(), or queues it while mDeferUpdates is set
+	BOOL runMotionUpdate(LLMotion* motionp, F32 time, U8* joint_mask);
+	// worker thread part of updateMotionsParallel()
+	void runDeferredUpdates();
+	// main thread part of updateMotionsParallel(), after runDeferredUpdates()
+	void finishDeferredUpdates();
+	bool hasDeferredUpdates() const { return mBlendPending || !mDeferredUpdates.empty(); }
+	// </FS:Kadah>
+
 protected:
 	F32					mTimeFactor;			// 1.f for normal speed
 	static F32			sCurrentTimeFactor;		// Value to use for initialization
@@ -232,6 +262,12 @@ protected:
 	F32					mLastInterp;
 
 	U8					mJointSignature[2][LL_CHARACTER_MAX_ANIMATED_JOINTS];
+
+	// <FS:Kadah> Parallel motion evaluation
+	bool				mDeferUpdates;
+	bool				mBlendPending;
+	std::vector<DeferredUpdate>	mDeferredUpdates;
+	// </FS:Kadah>
 private:
 	U32					mLastCountAfterPurge; //for logging and debugging purposes
 };
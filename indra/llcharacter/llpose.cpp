@@ -450,6 +450,27 @@ void LLJointStateBlender::resetCachedJoint()
 	mJointCache.setRotation(source_joint->getRotation());
 }
 
+// <FS:Kadah> Parallel motion evaluation
+//-----------------------------------------------------------------------------
+// applyCachedJoint()
+//-----------------------------------------------------------------------------
+void LLJointStateBlender::applyCachedJoint()
+{
+	if (mJointStates[0].isNull())
+	{
+		return;
+	}
+	LLJoint* target_joint = mJointStates[0]->getJoint();
+
+    // SL-315
+	target_joint->setPosition(mJointCache.getPosition());
+	target_joint->setScale(mJointCache.getScale());
+	target_joint->setRotation(mJointCache.getRotation());
+
+	clear();
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // LLPoseBlender
 //-----------------------------------------------------------------------------
@@ -552,6 +573,24 @@ void LLPoseBlender::interpolate(F32 u)
 	}
 }
 
+// <FS:Kadah> Parallel motion evaluation
+//-----------------------------------------------------------------------------
+// applyCache()
+//-----------------------------------------------------------------------------
+void LLPoseBlender::applyCache()
+{
+	for (blender_list_t::iterator iter = mActiveBlenders.begin();
+		 iter != mActiveBlenders.end(); ++iter)
+	{
+		LLJointStateBlender* jsbp = *iter;
+		jsbp->applyCachedJoint();
+	}
+
+	// we're done now so there are no more active blenders for this frame
+	mActiveBlenders.clear();
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // clearBlenders()
 //-----------------------------------------------------------------------------
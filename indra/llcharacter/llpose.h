@@ -96,6 +96,7 @@ public:
 	void interpolate(F32 u);
 	void clear();
 	void resetCachedJoint();
+	void applyCachedJoint();	// <FS:Kadah/> Parallel motion evaluation
 
 public:
 	LL_ALIGN_16(LLJoint mJointCache);
@@ -134,6 +135,12 @@ public:
 	// interpolate all joints towards cached values
 	void interpolate(F32 u);
 
+	// <FS:Kadah> Parallel motion evaluation
+	// apply the results of blendAndCache(TRUE) to the skeleton, the same
+	// as blendAndApply() would have done
+	void applyCache();
+	// </FS:Kadah>
+
 	LLPose* getBlendedPose() { return &mBlendedPose; }
 };
 
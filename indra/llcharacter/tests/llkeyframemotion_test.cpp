@@ -0,0 +1,330 @@
+/**
+ * @file llkeyframemotion_test.cpp
+ * @brief Tests and benchmark for the keyframe curves of LLKeyframeMotion.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "lldiriterator.h"
+#include "lltimer.h"
+#include "testcharacter.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	// Exposes the curves and joint states for evaluation outside of onUpdate()
+	class TestKeyframeMotion : public LLKeyframeMotion
+	{
+	public:
+		TestKeyframeMotion() : LLKeyframeMotion(LLUUID::generateNewID()) {}
+
+		const JointMotionList* getJointMotionList() const { return mJointMotionList; }
+		LLJointState* getJointState(U32 index) const { return mJointStates[index]; }
+	};
+
+	bool load_anim(TestKeyframeMotion& motion, LLCharacter& character, std::vector<U8>& data)
+	{
+		motion.setCharacter(&character);
+		LLDataPackerBinaryBuffer dp(&data[0], (S32)data.size());
+		return motion.deserialize(dp, motion.getID());
+	}
+
+	// The std::map lookup and scalar interpolation the curves used to do
+	struct MapJoint
+	{
+		std::map<F32, LLQuaternion> mRotations;
+		std::map<F32, LLVector3> mPositions;
+	};
+	typedef std::vector<MapJoint> map_motion_t;
+
+	map_motion_t make_map_motion(const LLKeyframeMotion::JointMotionList* list)
+	{
+		map_motion_t joints(list->getNumJointMotions());
+		for (U32 i = 0; i < list->getNumJointMotions(); ++i)
+		{
+			const LLKeyframeMotion::JointMotion* joint = list->getJointMotion(i);
+			for (S32 k = 0; k < joint->mRotationCurve.getKeyCount(); ++k)
+			{
+				LLKeyframeMotion::RotationKey key = joint->mRotationCurve.getKey(k);
+				joints[i].mRotations[key.mTime] = key.mRotation;
+			}
+			for (S32 k = 0; k < joint->mPositionCurve.getKeyCount(); ++k)
+			{
+				LLKeyframeMotion::PositionKey key = joint->mPositionCurve.getKey(k);
+				joints[i].mPositions[key.mTime] = key.mPosition;
+			}
+		}
+		return joints;
+	}
+
+	LLQuaternion map_rotation(const std::map<F32, LLQuaternion>& keys, F32 time)
+	{
+		if (keys.empty())
+		{
+			return LLQuaternion::DEFAULT;
+		}
+		std::map<F32, LLQuaternion>::const_iterator right = keys.lower_bound(time);
+		if (right == keys.end())
+		{
+			return (--right)->second;
+		}
+		if (right == keys.begin() || right->first == time)
+		{
+			return right->second;
+		}
+		std::map<F32, LLQuaternion>::const_iterator left = right; --left;
+		F32 u = (time - left->first) / (right->first - left->first);
+		return nlerp(u, left->second, right->second);
+	}
+
+	LLVector3 map_position(const std::map<F32, LLVector3>& keys, F32 time)
+	{
+		if (keys.empty())
+		{
+			return LLVector3::zero;
+		}
+		std::map<F32, LLVector3>::const_iterator right = keys.lower_bound(time);
+		if (right == keys.end())
+		{
+			return (--right)->second;
+		}
+		if (right == keys.begin() || right->first == time)
+		{
+			return right->second;
+		}
+		std::map<F32, LLVector3>::const_iterator left = right; --left;
+		F32 u = (time - left->first) / (right->first - left->first);
+		return lerp(left->second, right->second, u);
+	}
+
+	// Looping playback at 30 fps, as LLKeyframeMotion::onUpdate() wraps it
+	F32 frame_time(S32 frame, F32 duration, S32 offset)
+	{
+		return fmodf((frame + offset) / 30.f, duration);
+	}
+}
+
+namespace tut
+{
+	struct LLKeyframeMotionFixture
+	{
+		~LLKeyframeMotionFixture()
+		{
+			LLKeyframeDataCache::clear();
+		}
+
+		TestCharacter mCharacter;
+	};
+
+	typedef test_group<LLKeyframeMotionFixture> LLKeyframeMotionTestGroup;
+	typedef LLKeyframeMotionTestGroup::object LLKeyframeMotionTestObject;
+	LLKeyframeMotionTestGroup keyframeMotionTestGroup("LLKeyframeMotion");
+
+	template<> template<>
+	void LLKeyframeMotionTestObject::test<1>()
+	{
+		set_test_name("curves match the map lookup");
+		std::vector<U8> data = make_anim(40, 25, 4.f);
+		TestKeyframeMotion motion;
+		ensure("deserialize", load_anim(motion, mCharacter, data));
+
+		const LLKeyframeMotion::JointMotionList* list = motion.getJointMotionList();
+		map_motion_t map_motion = make_map_motion(list);
+		std::vector<LLKeyframeMotion::JointCursor> cursors(list->getNumJointMotions());
+
+		// Forward, backward and random times, on and between keys
+		std::vector<F32> times;
+		for (S32 i = -5; i <= 130; ++i)
+		{
+			times.push_back(i * 4.f / 120.f);
+		}
+		for (S32 i = 130; i >= -5; i -= 7)
+		{
+			times.push_back(i * 4.f / 120.f);
+		}
+		for (S32 i = 0; i < 200; ++i)
+		{
+			times.push_back(ll_frand(4.4f) - 0.2f);
+		}
+
+		for (F32 time : times)
+		{
+			for (U32 i = 0; i < list->getNumJointMotions(); ++i)
+			{
+				const LLKeyframeMotion::JointMotion* joint = list->getJointMotion(i);
+				LLQuaternion expected_rot = map_rotation(map_motion[i].mRotations, time);
+				LLQuaternion rot = joint->mRotationCurve.getValue(time, list->mDuration, cursors[i].mRotation);
+				for (S32 c = 0; c < 4; ++c)
+				{
+					ensure_approximately_equals("rotation", rot.mQ[c], expected_rot.mQ[c], 16);
+				}
+				LLVector3 expected_pos = map_position(map_motion[i].mPositions, time);
+				LLVector3 pos = joint->mPositionCurve.getValue(time, list->mDuration, cursors[i].mPosition);
+				ensure("position", dist_vec(pos, expected_pos) < 0.00001f);
+			}
+		}
+	}
+
+	template<> template<>
+	void LLKeyframeMotionTestObject::test<2>()
+	{
+		set_test_name("serialize round trip");
+		std::vector<U8> data = make_anim(12, 8, 2.f);
+		TestKeyframeMotion motion;
+		ensure("deserialize", load_anim(motion, mCharacter, data));
+
+		std::vector<U8> out(motion.getFileSize());
+		LLDataPackerBinaryBuffer dp(&out[0], (S32)out.size());
+		ensure("serialize", motion.serialize(dp));
+		TestKeyframeMotion copy;
+		ensure("deserialize copy", load_anim(copy, mCharacter, out));
+
+		const LLKeyframeMotion::JointMotionList* list = motion.getJointMotionList();
+		const LLKeyframeMotion::JointMotionList* copy_list = copy.getJointMotionList();
+		ensure_equals("joints", copy_list->getNumJointMotions(), list->getNumJointMotions());
+		for (U32 i = 0; i < list->getNumJointMotions(); ++i)
+		{
+			const LLKeyframeMotion::RotationCurve& curve = list->getJointMotion(i)->mRotationCurve;
+			const LLKeyframeMotion::RotationCurve& copy_curve = copy_list->getJointMotion(i)->mRotationCurve;
+			ensure_equals("rotation keys", copy_curve.getKeyCount(), curve.getKeyCount());
+			for (S32 k = 0; k < curve.getKeyCount(); ++k)
+			{
+				ensure_approximately_equals("key time", copy_curve.getKey(k).mTime, curve.getKey(k).mTime, 12);
+			}
+			ensure_equals("position keys", copy_list->getJointMotion(i)->mPositionCurve.getKeyCount(),
+						  list->getJointMotion(i)->mPositionCurve.getKeyCount());
+		}
+	}
+
+	template<> template<>
+	void LLKeyframeMotionTestObject::test<3>()
+	{
+		set_test_name("benchmark");
+		// Real animations from LL_TEST_ANIM_DIR when given, synthetic ones otherwise
+		std::vector<std::vector<U8> > assets;
+		const char* anim_dir = getenv("LL_TEST_ANIM_DIR");
+		if (anim_dir)
+		{
+			LLDirIterator iter(anim_dir, "*.anim");
+			std::string name;
+			while (iter.next(name))
+			{
+				std::ifstream in((std::string(anim_dir) + "/" + name).c_str(), std::ios::binary);
+				std::vector<U8> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+				if (!data.empty())
+				{
+					assets.push_back(data);
+				}
+			}
+		}
+		if (assets.empty())
+		{
+			for (S32 i = 0; i < 200; ++i)
+			{
+				assets.push_back(make_anim(10 + ll_rand(80), 10 + ll_rand(40), 1.f + ll_frand(9.f)));
+			}
+		}
+
+		std::vector<TestKeyframeMotion*> motions;
+		std::vector<map_motion_t> map_motions;
+		U32 joints = 0;
+		for (std::vector<U8>& data : assets)
+		{
+			TestKeyframeMotion* motion = new TestKeyframeMotion;
+			if (!load_anim(*motion, mCharacter, data))
+			{
+				delete motion;
+				continue;
+			}
+			motions.push_back(motion);
+			map_motions.push_back(make_map_motion(motion->getJointMotionList()));
+			joints += motion->getJointMotionList()->getNumJointMotions();
+		}
+		ensure("animations loaded", !motions.empty());
+
+		// Every animation plays each frame, as on a crowd of avatars
+		const S32 FRAMES = 2000;
+		F64 map_sum = 0.0;
+		F64 start = LLTimer::getTotalSeconds();
+		for (S32 frame = 0; frame < FRAMES; ++frame)
+		{
+			for (size_t m = 0; m < motions.size(); ++m)
+			{
+				const LLKeyframeMotion::JointMotionList* list = motions[m]->getJointMotionList();
+				const map_motion_t& map_motion = map_motions[m];
+				F32 time = frame_time(frame, llmax(list->mDuration, 0.1f), (S32)m);
+				for (U32 i = 0; i < list->getNumJointMotions(); ++i)
+				{
+					map_sum += map_rotation(map_motion[i].mRotations, time).mQ[VW];
+					map_sum += map_position(map_motion[i].mPositions, time).mV[VZ];
+				}
+			}
+		}
+		F64 map_seconds = LLTimer::getTotalSeconds() - start;
+
+		std::vector<std::vector<LLKeyframeMotion::JointCursor> > cursors(motions.size());
+		for (size_t m = 0; m < motions.size(); ++m)
+		{
+			cursors[m].resize(motions[m]->getJointMotionList()->getNumJointMotions());
+		}
+		F64 flat_sum = 0.0;
+		start = LLTimer::getTotalSeconds();
+		for (S32 frame = 0; frame < FRAMES; ++frame)
+		{
+			for (size_t m = 0; m < motions.size(); ++m)
+			{
+				const LLKeyframeMotion::JointMotionList* list = motions[m]->getJointMotionList();
+				const F32 duration = llmax(list->mDuration, 0.1f);
+				F32 time = frame_time(frame, duration, (S32)m);
+				for (U32 i = 0; i < list->getNumJointMotions(); ++i)
+				{
+					const LLKeyframeMotion::JointMotion* joint = list->getJointMotion(i);
+					LLKeyframeMotion::JointCursor& cursor = cursors[m][i];
+					flat_sum += joint->mRotationCurve.getValue(time, duration, cursor.mRotation).mQ[VW];
+					flat_sum += joint->mPositionCurve.getValue(time, duration, cursor.mPosition).mV[VZ];
+				}
+			}
+		}
+		F64 flat_seconds = LLTimer::getTotalSeconds() - start;
+		ensure_approximately_equals_range("same results", (F32)flat_sum, (F32)map_sum, (F32)(fabs(map_sum) * 0.0001 + 0.01));
+
+		F64 evaluations = (F64)joints * FRAMES;
+		std::cout << "\n" << motions.size() << " animations, " << joints << " joints, " << FRAMES << " frames\n"
+				  << "  map  " << map_seconds * 1000.0 << " ms, " << map_seconds * 1.0e9 / evaluations << " ns per joint\n"
+				  << "  flat " << flat_seconds * 1000.0 << " ms, " << flat_seconds * 1.0e9 / evaluations << " ns per joint"
+				  << std::endl;
+
+		for (TestKeyframeMotion* motion : motions)
+		{
+			delete motion;
+		}
+	}
+}
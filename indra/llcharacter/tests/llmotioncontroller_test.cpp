@@ -0,0 +1,96 @@
+/**
+ * @file llmotioncontroller_test.cpp
+ * @brief Tests for the parallel motion update of LLMotionController.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "threadpool.h"
+#include "testcrowd.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLMotionControllerFixture
+	{
+		~LLMotionControllerFixture()
+		{
+			LLKeyframeDataCache::clear();
+		}
+
+		AnimSet mAnims;
+	};
+
+	typedef test_group<LLMotionControllerFixture> LLMotionControllerTestGroup;
+	typedef LLMotionControllerTestGroup::object LLMotionControllerTestObject;
+	LLMotionControllerTestGroup motionControllerTestGroup("LLMotionController");
+
+	template<> template<>
+	void LLMotionControllerTestObject::test<1>()
+	{
+		set_test_name("parallel update matches the serial one");
+		const S32 CHARACTERS = 12;
+		character_list_t serial;
+		character_list_t parallel;
+		make_characters(serial, CHARACTERS, mAnims);
+		make_characters(parallel, CHARACTERS, mAnims);
+
+		LL::ThreadPool pool("LLMotionControllerTest", 3);
+		pool.start();
+
+		for (S32 frame = 0; frame < 400; ++frame)
+		{
+			TestFrameTimer::advance(1.0 / 30.0);
+			script_frame(serial, mAnims, frame);
+			script_frame(parallel, mAnims, frame);
+			update_serial(serial);
+			LLCharacter::updateMotionsParallel(parallel, "LLMotionControllerTest");
+
+			for (S32 c = 0; c < CHARACTERS; ++c)
+			{
+				ensure_equals("active motions", parallel[c]->getMotionController().getActiveMotions().size(),
+							  serial[c]->getMotionController().getActiveMotions().size());
+				for (S32 i = 0; i < SKELETON_SIZE; ++i)
+				{
+					LLJoint* expected = serial[c]->getCharacterJoint(i);
+					LLJoint* joint = parallel[c]->getCharacterJoint(i);
+					ensure_equals("position", joint->getPosition(), expected->getPosition());
+					ensure_equals("scale", joint->getScale(), expected->getScale());
+					for (S32 q = 0; q < 4; ++q)
+					{
+						ensure_approximately_equals("rotation", joint->getRotation().mQ[q], expected->getRotation().mQ[q], 20);
+					}
+				}
+			}
+		}
+
+		ensure("skeletons animated", pose_sum(parallel) != 0.0);
+
+		pool.close();
+		delete_characters(serial);
+		delete_characters(parallel);
+	}
+}
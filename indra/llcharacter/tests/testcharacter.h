@@ -0,0 +1,172 @@
+/**
+ * @file testcharacter.h
+ * @brief Synthetic skeleton and animations for the llcharacter tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_TESTCHARACTER_H
+#define LL_TESTCHARACTER_H
+
+#include "../llcharacter.h"
+#include "../llkeyframemotion.h"
+#include "lldatapacker.h"
+#include "llquantize.h"
+#include "llrand.h"
+
+namespace
+{
+	// Base avatar skeleton, enough for the joints most animations use
+	const char* SKELETON[][2] =
+	{
+		{ "mPelvis", "" },
+		{ "mTorso", "mPelvis" },
+		{ "mChest", "mTorso" },
+		{ "mNeck", "mChest" },
+		{ "mHead", "mNeck" },
+		{ "mSkull", "mHead" },
+		{ "mEyeLeft", "mHead" },
+		{ "mEyeRight", "mHead" },
+		{ "mCollarLeft", "mChest" },
+		{ "mShoulderLeft", "mCollarLeft" },
+		{ "mElbowLeft", "mShoulderLeft" },
+		{ "mWristLeft", "mElbowLeft" },
+		{ "mCollarRight", "mChest" },
+		{ "mShoulderRight", "mCollarRight" },
+		{ "mElbowRight", "mShoulderRight" },
+		{ "mWristRight", "mElbowRight" },
+		{ "mHipLeft", "mPelvis" },
+		{ "mKneeLeft", "mHipLeft" },
+		{ "mAnkleLeft", "mKneeLeft" },
+		{ "mFootLeft", "mAnkleLeft" },
+		{ "mToeLeft", "mFootLeft" },
+		{ "mHipRight", "mPelvis" },
+		{ "mKneeRight", "mHipRight" },
+		{ "mAnkleRight", "mKneeRight" },
+		{ "mFootRight", "mAnkleRight" },
+		{ "mToeRight", "mFootRight" },
+	};
+	const S32 SKELETON_SIZE = LL_ARRAY_SIZE(SKELETON);
+
+	class TestCharacter : public LLCharacter
+	{
+	public:
+		TestCharacter()
+		:	mRoot("mRoot"),
+			mID(LLUUID::generateNewID())
+		{
+			for (S32 i = 0; i < SKELETON_SIZE; ++i)
+			{
+				LLJoint* parent = SKELETON[i][1][0] ? mRoot.findJoint(SKELETON[i][1]) : &mRoot;
+				LLJoint* joint = new LLJoint(SKELETON[i][0], parent);
+				joint->setJointNum(i);
+				mJoints.push_back(joint);
+			}
+		}
+
+		~TestCharacter()
+		{
+			for (LLJoint* joint : mJoints)
+			{
+				delete joint;
+			}
+		}
+
+		virtual const char* getAnimationPrefix() { return "avatar"; }
+		virtual LLJoint* getRootJoint() { return &mRoot; }
+		virtual LLVector3 getCharacterPosition() { return LLVector3::zero; }
+		virtual LLQuaternion getCharacterRotation() { return LLQuaternion::DEFAULT; }
+		virtual LLVector3 getCharacterVelocity() { return LLVector3::zero; }
+		virtual LLVector3 getCharacterAngularVelocity() { return LLVector3::zero; }
+		virtual void getGround(const LLVector3& inPos, LLVector3& outPos, LLVector3& outNorm) { outPos = inPos; outNorm = LLVector3::z_axis; }
+		virtual LLJoint* getCharacterJoint(U32 i) { return i < mJoints.size() ? mJoints[i] : NULL; }
+		virtual F32 getTimeDilation() { return 1.f; }
+		virtual F32 getPixelArea() const { return 1000000.f; }
+		virtual LLPolyMesh* getHeadMesh() { return NULL; }
+		virtual LLPolyMesh* getUpperBodyMesh() { return NULL; }
+		virtual LLVector3d getPosGlobalFromAgent(const LLVector3& position) { return LLVector3d(position); }
+		virtual LLVector3 getPosAgentFromGlobal(const LLVector3d& position) { return LLVector3(position); }
+		virtual void addDebugText(const std::string& text) {}
+		virtual const LLUUID& getID() const { return mID; }
+
+	private:
+		LLJoint mRoot;
+		std::vector<LLJoint*> mJoints;
+		LLUUID mID;
+	};
+
+	// Animation asset with random keys on joint_count joints of the base
+	// skeleton, starting at first_joint. Position keys go on the first one.
+	std::vector<U8> make_anim(S32 rot_keys, S32 pos_keys, F32 duration,
+							  LLJoint::JointPriority priority = LLJoint::MEDIUM_PRIORITY,
+							  S32 first_joint = 0, S32 joint_count = SKELETON_SIZE, bool loop = true)
+	{
+		std::vector<U8> buffer(64 + joint_count * (64 + 8 * (rot_keys + pos_keys)));
+		LLDataPackerBinaryBuffer dp(&buffer[0], (S32)buffer.size());
+		dp.packU16(KEYFRAME_MOTION_VERSION, "version");
+		dp.packU16(KEYFRAME_MOTION_SUBVERSION, "sub_version");
+		dp.packS32(priority, "base_priority");
+		dp.packF32(duration, "duration");
+		dp.packString(std::string(), "emote_name");
+		dp.packF32(0.f, "loop_in_point");
+		dp.packF32(duration, "loop_out_point");
+		dp.packS32(loop ? 1 : 0, "loop");
+		dp.packF32(0.3f, "ease_in_duration");
+		dp.packF32(0.3f, "ease_out_duration");
+		dp.packU32(LLHandMotion::HAND_POSE_RELAXED, "hand_pose");
+		dp.packU32(joint_count, "num_joints");
+		for (S32 i = first_joint; i < first_joint + joint_count; ++i)
+		{
+			dp.packString(SKELETON[i][0], "joint_name");
+			dp.packS32(LLJoint::USE_MOTION_PRIORITY, "joint_priority");
+			dp.packS32(rot_keys, "num_rot_keys");
+			// Small steps between keys, as motion capture has them
+			S32 angle[3] = { U16_MAX / 2, U16_MAX / 2, U16_MAX / 2 };
+			for (S32 k = 0; k < rot_keys; ++k)
+			{
+				for (S32 c = 0; c < 3; ++c)
+				{
+					angle[c] = llclamp(angle[c] + ll_rand(4001) - 2000, U16_MAX / 4, U16_MAX * 3 / 4);
+				}
+				dp.packU16(F32_to_U16(duration * k / llmax(rot_keys - 1, 1), 0.f, duration), "time");
+				dp.packU16(angle[VX], "rot_angle_x");
+				dp.packU16(angle[VY], "rot_angle_y");
+				dp.packU16(angle[VZ], "rot_angle_z");
+			}
+			S32 joint_pos_keys = i == first_joint ? pos_keys : 0;
+			dp.packS32(joint_pos_keys, "num_pos_keys");
+			for (S32 k = 0; k < joint_pos_keys; ++k)
+			{
+				dp.packU16(F32_to_U16(duration * k / llmax(joint_pos_keys - 1, 1), 0.f, duration), "time");
+				dp.packU16(ll_rand(U16_MAX), "pos_x");
+				dp.packU16(ll_rand(U16_MAX), "pos_y");
+				dp.packU16(ll_rand(U16_MAX), "pos_z");
+			}
+		}
+		dp.packS32(0, "num_constraints");
+		buffer.resize(dp.getCurrentSize());
+		return buffer;
+	}
+}
+
+#endif // LL_TESTCHARACTER_H
@@ -0,0 +1,194 @@
+/**
+ * @file testcrowd.h
+ * @brief A crowd of test characters playing typical animations, for the llcharacter tests and benches.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_TESTCROWD_H
+#define LL_TESTCROWD_H
+
+#include "llframetimer.h"
+#include "testcharacter.h"
+
+namespace
+{
+	// Steps the frame time LLMotionController reads, independent of the clock
+	class TestFrameTimer : public LLFrameTimer
+	{
+	public:
+		static void advance(F64 seconds) { sFrameTime += seconds; }
+	};
+
+	// Stays on the main thread, turns the head on top of the keyframes as
+	// LLHeadRotMotion does
+	class TestHeadMotion : public LLMotion
+	{
+	public:
+		TestHeadMotion(const LLUUID& id) : LLMotion(id), mHeadState(new LLJointState) {}
+		static LLMotion* create(const LLUUID& id) { return new TestHeadMotion(id); }
+
+		virtual BOOL getLoop() { return TRUE; }
+		virtual F32 getDuration() { return 0.f; }
+		virtual F32 getEaseInDuration() { return 0.5f; }
+		virtual F32 getEaseOutDuration() { return 0.5f; }
+		virtual LLJoint::JointPriority getPriority() { return LLJoint::HIGH_PRIORITY; }
+		virtual LLMotionBlendType getBlendType() { return NORMAL_BLEND; }
+		virtual F32 getMinPixelArea() { return 0.f; }
+
+		virtual LLMotionInitStatus onInitialize(LLCharacter* character)
+		{
+			mHeadState->setJoint(character->getJoint("mHead"));
+			mHeadState->setUsage(LLJointState::ROT);
+			addJointState(mHeadState);
+			return STATUS_SUCCESS;
+		}
+		virtual BOOL onActivate() { return TRUE; }
+		virtual BOOL onUpdate(F32 time, U8* joint_mask)
+		{
+			mHeadState->setRotation(LLQuaternion(sinf(time) * 0.5f, LLVector3::z_axis));
+			return TRUE;
+		}
+		virtual void onDeactivate() {}
+
+	private:
+		LLPointer<LLJointState> mHeadState;
+	};
+
+	const LLUUID HEAD_MOTION_ID("8b2c6f4e-1d3a-4c5b-9e7f-0a1b2c3d4e5f");
+
+	// Puts an animation into the keyframe cache, where the motions of all
+	// characters find it, and returns its id
+	LLUUID cache_anim(std::vector<U8> data)
+	{
+		TestCharacter character;
+		LLKeyframeMotion motion(LLUUID::generateNewID());
+		motion.setCharacter(&character);
+		LLDataPackerBinaryBuffer dp(&data[0], (S32)data.size());
+		return motion.deserialize(dp, motion.getID()) ? motion.getID() : LLUUID::null;
+	}
+
+	// What a typical avatar plays: a looping stand or walk over the whole
+	// body, a higher priority overlay on one arm and now and then a gesture
+	// that runs out by itself.
+	struct AnimSet
+	{
+		AnimSet()
+		{
+			for (S32 i = 0; i < 8; ++i)
+			{
+				mBases.push_back(cache_anim(make_anim(20 + ll_rand(60), 20 + ll_rand(20), 1.f + ll_frand(6.f))));
+			}
+			for (S32 i = 0; i < 4; ++i)
+			{
+				mOverlays.push_back(cache_anim(make_anim(10 + ll_rand(20), 0, 2.f + ll_frand(2.f),
+														 LLJoint::HIGH_PRIORITY, 8, 8)));
+			}
+			for (S32 i = 0; i < 4; ++i)
+			{
+				mGestures.push_back(cache_anim(make_anim(10 + ll_rand(20), 5, 0.5f + ll_frand(1.f),
+														 LLJoint::HIGHER_PRIORITY, 1, 15, false)));
+			}
+		}
+
+		void start(LLCharacter& character, S32 index) const
+		{
+			character.startMotion(mBases[index % mBases.size()], 0.f);
+			character.startMotion(mOverlays[index % mOverlays.size()], 0.f);
+			if (index % 3 == 0)
+			{
+				character.startMotion(HEAD_MOTION_ID, 0.f);
+			}
+		}
+
+		std::vector<LLUUID> mBases;
+		std::vector<LLUUID> mOverlays;
+		std::vector<LLUUID> mGestures;
+	};
+
+	typedef std::vector<LLCharacter*> character_list_t;
+
+	void make_characters(character_list_t& characters, S32 count, const AnimSet& anims)
+	{
+		for (S32 i = 0; i < count; ++i)
+		{
+			TestCharacter* character = new TestCharacter;
+			character->registerMotion(HEAD_MOTION_ID, TestHeadMotion::create);
+			anims.start(*character, i);
+			characters.push_back(character);
+		}
+	}
+
+	void delete_characters(character_list_t& characters)
+	{
+		for (LLCharacter* character : characters)
+		{
+			delete character;
+		}
+		characters.clear();
+	}
+
+	// Starts and stops motions the way the simulator would over a session
+	void script_frame(character_list_t& characters, const AnimSet& anims, S32 frame)
+	{
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			if ((frame + i) % 47 == 0)
+			{
+				characters[i]->startMotion(anims.mGestures[(frame + i) % anims.mGestures.size()], 0.f);
+			}
+			if ((frame + i) % 113 == 0)
+			{
+				characters[i]->stopMotion(anims.mOverlays[i % anims.mOverlays.size()]);
+			}
+			if ((frame + i) % 113 == 60)
+			{
+				characters[i]->startMotion(anims.mOverlays[i % anims.mOverlays.size()], 0.f);
+			}
+		}
+	}
+
+	void update_serial(character_list_t& characters)
+	{
+		for (LLCharacter* character : characters)
+		{
+			character->updateMotions(LLCharacter::NORMAL_UPDATE);
+		}
+	}
+
+	F64 pose_sum(character_list_t& characters)
+	{
+		F64 sum = 0.0;
+		for (LLCharacter* character : characters)
+		{
+			for (S32 i = 0; i < SKELETON_SIZE; ++i)
+			{
+				LLJoint* joint = character->getCharacterJoint(i);
+				sum += joint->getRotation().mQ[VW] + joint->getPosition().mV[VZ];
+			}
+		}
+		return sum;
+	}
+}
+
+#endif // LL_TESTCROWD_H
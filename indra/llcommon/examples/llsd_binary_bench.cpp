@@ -0,0 +1,340 @@
+/**
+ * @file llsd_binary_bench.cpp
+ * @brief Compares binary LLSD parse throughput of the stream and buffer parsers, with and without an LLSDArena.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include "llsd.h"
+#include "llsdarena.h"
+#include "llsdserialize.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tllsd_binary_bench [options]\n"
+		"\n"
+		"Parses binary LLSD samples with LLSDBinaryParser::parse() on a stream\n"
+		"and with LLSDBinaryParser::parseBuffer(), the latter also inside an\n"
+		"LLSDArena, checks that all give the same result and reports the\n"
+		"throughput of each.  Without sample files a synthetic mesh header and\n"
+		"inventory list are used.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -m <file>       Mesh asset, as stored in the mesh cache.  Its header\n"
+		"                 is the sample.  May be repeated.\n"
+		" -i <file>       Inventory cache (gunzipped *.inv.llsd).  Its items are\n"
+		"                 converted to one binary LLSD array.\n"
+		" -n <count>      Items in the synthetic inventory.  Default:  5000\n"
+		" -r <count>      Repetitions per measurement.  Default:  200\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+struct Sample
+{
+	std::string	mName;
+	std::string	mData;	// binary LLSD, without header
+};
+typedef std::vector<Sample> sample_list_t;
+
+static std::string to_binary(const LLSD& sd)
+{
+	std::ostringstream ostr;
+	LLSDSerialize::toBinary(sd, ostr);
+	return ostr.str();
+}
+
+static LLSD make_lod_block(S32& offset, S32 size)
+{
+	LLSD block;
+	block["offset"] = offset;
+	block["size"] = size;
+	offset += size;
+	return block;
+}
+
+// Same layout as the headers written by LLModel::writeModel().
+static LLSD make_mesh_header()
+{
+	S32 offset = 0;
+	LLSD header;
+	header["version"] = 1;
+	header["creator"] = LLUUID::generateNewID();
+	header["date"] = LLDate::now();
+	header["physics_convex"] = make_lod_block(offset, 1832);
+	header["skin"] = make_lod_block(offset, 2610);
+	header["high_lod"] = make_lod_block(offset, 48211);
+	header["medium_lod"] = make_lod_block(offset, 12876);
+	header["low_lod"] = make_lod_block(offset, 3421);
+	header["lowest_lod"] = make_lod_block(offset, 982);
+	header["physics_mesh"] = make_lod_block(offset, 3104);
+	return header;
+}
+
+// Same fields as LLInventoryItem::asLLSD().
+static LLSD make_inventory(S32 count)
+{
+	LLSD items = LLSD::emptyArray();
+	LLUUID parent_id = LLUUID::generateNewID();
+	LLUUID owner_id = LLUUID::generateNewID();
+	for (S32 i = 0; i < count; ++i)
+	{
+		if (i % 100 == 0)
+		{
+			parent_id.generate();
+		}
+		LLSD item;
+		item["item_id"] = LLUUID::generateNewID();
+		item["parent_id"] = parent_id;
+		LLSD& perm = item["permissions"];
+		perm["creator_id"] = LLUUID::generateNewID();
+		perm["owner_id"] = owner_id;
+		perm["last_owner_id"] = LLUUID::generateNewID();
+		perm["group_id"] = LLUUID::null;
+		perm["base_mask"] = (S32)0x7fffffff;
+		perm["owner_mask"] = (S32)0x7fffffff;
+		perm["group_mask"] = 0;
+		perm["everyone_mask"] = 0;
+		perm["next_owner_mask"] = (S32)0x82000;
+		perm["is_owner_group"] = false;
+		item["asset_id"] = LLUUID::generateNewID();
+		item["type"] = "object";
+		item["inv_type"] = "object";
+		item["flags"] = 0;
+		item["sale_info"]["sale_type"] = "not";
+		item["sale_info"]["sale_price"] = 10;
+		item["name"] = llformat("Inventory item number %d", i);
+		item["desc"] = "(No Description)";
+		item["created_at"] = 1600000000 + i;
+		items.append(item);
+	}
+	return items;
+}
+
+static bool read_file(const std::string& filename, std::string& data)
+{
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in.is_open())
+	{
+		return false;
+	}
+	std::ostringstream ostr;
+	ostr << in.rdbuf();
+	data = ostr.str();
+	return true;
+}
+
+static bool load_mesh(const std::string& filename, sample_list_t& samples)
+{
+	std::string data;
+	if (!read_file(filename, data))
+	{
+		return false;
+	}
+	U32 size = (U32)data.size();
+	char* start = strip_deprecated_header(&data[0], size);
+
+	// Only keep the header, as LLMeshRepoThread::headerReceived() sees it.
+	LLPointer<LLSDBinaryParser> parser = new LLSDBinaryParser;
+	LLSD header;
+	size_t header_bytes = 0;
+	if (parser->parseBuffer((const U8*)start, size, header, size, -1, &header_bytes) <= 0)
+	{
+		return false;
+	}
+	Sample sample = { "mesh " + filename, std::string(start, header_bytes) };
+	samples.push_back(sample);
+	return true;
+}
+
+static bool load_inventory(const std::string& filename, sample_list_t& samples)
+{
+	std::ifstream in(filename.c_str());
+	if (!in.is_open())
+	{
+		return false;
+	}
+	// Line per item, as in LLInventoryModel::loadFromFile().
+	LLPointer<LLSDParser> parser = new LLSDNotationParser();
+	LLSD items = LLSD::emptyArray();
+	std::string line;
+	while (std::getline(in, line))
+	{
+		LLSD item;
+		std::istringstream iss(line);
+		if (parser->parse(iss, item, line.length()) > 0)
+		{
+			items.append(item);
+		}
+	}
+	if (!items.size())
+	{
+		return false;
+	}
+	Sample sample = { "inventory " + filename, to_binary(items) };
+	samples.push_back(sample);
+	return true;
+}
+
+static void run(const Sample& sample, S32 repeat)
+{
+	const std::string& data = sample.mData;
+	LLPointer<LLSDBinaryParser> parser = new LLSDBinaryParser;
+
+	LLSD from_stream;
+	LLSD from_buffer;
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		boost::iostreams::stream<boost::iostreams::array_source> istr(data.data(), data.size());
+		from_stream.clear();
+		parser->parse(istr, from_stream, data.size());
+	}
+	F64 stream_seconds = LLTimer::getTotalSeconds() - start;
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		from_buffer.clear();
+		parser->parseBuffer((const U8*)data.data(), data.size(), from_buffer, data.size());
+	}
+	F64 buffer_seconds = LLTimer::getTotalSeconds() - start;
+
+	LLSD from_arena;
+	U64 arena_nodes = 0;
+	start = LLTimer::getTotalSeconds();
+	{
+		LLSDArena arena;
+		for (S32 i = 0; i < repeat; ++i)
+		{
+			from_arena.clear();
+			parser->parseBuffer((const U8*)data.data(), data.size(), from_arena, data.size());
+		}
+		arena_nodes = arena.getNodeCount();
+	}
+	F64 arena_seconds = LLTimer::getTotalSeconds() - start;
+
+	// Compare through the notation form; LLSD has no deep operator==.
+	std::ostringstream stream_str;
+	std::ostringstream buffer_str;
+	std::ostringstream arena_str;
+	stream_str << from_stream;
+	buffer_str << from_buffer;
+	arena_str << from_arena;
+	bool same = stream_str.str() == buffer_str.str();
+	bool arena_same = stream_str.str() == arena_str.str();
+
+	F64 mb = (F64)data.size() * repeat / (1024.0 * 1024.0);
+	fprintf(stdout, "%s (%d bytes)\n", sample.mName.c_str(), (S32)data.size());
+	fprintf(stdout, "  stream %9.3f ms %9.1f MB/s\n", stream_seconds * 1000.0 / repeat,
+			stream_seconds > 0.0 ? mb / stream_seconds : 0.0);
+	fprintf(stdout, "  buffer %9.3f ms %9.1f MB/s %6.2fx %s\n", buffer_seconds * 1000.0 / repeat,
+			buffer_seconds > 0.0 ? mb / buffer_seconds : 0.0,
+			buffer_seconds > 0.0 ? stream_seconds / buffer_seconds : 0.0,
+			same ? "" : "MISMATCH");
+	fprintf(stdout, "  arena  %9.3f ms %9.1f MB/s %6.2fx %s(%llu nodes)\n", arena_seconds * 1000.0 / repeat,
+			arena_seconds > 0.0 ? mb / arena_seconds : 0.0,
+			arena_seconds > 0.0 ? stream_seconds / arena_seconds : 0.0,
+			arena_same ? "" : "MISMATCH ", (unsigned long long)arena_nodes);
+}
+
+int main(int argc, char** argv)
+{
+	S32 count = 5000;
+	S32 repeat = 200;
+	std::vector<std::string> mesh_files;
+	std::vector<std::string> inventory_files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-m" && i + 1 < argc)
+		{
+			mesh_files.push_back(argv[++i]);
+		}
+		else if (arg == "-i" && i + 1 < argc)
+		{
+			inventory_files.push_back(argv[++i]);
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	sample_list_t samples;
+	for (const std::string& filename : mesh_files)
+	{
+		if (!load_mesh(filename, samples))
+		{
+			std::cerr << "Unable to read a mesh header from " << filename << std::endl;
+			return 1;
+		}
+	}
+	for (const std::string& filename : inventory_files)
+	{
+		if (!load_inventory(filename, samples))
+		{
+			std::cerr << "Unable to read inventory items from " << filename << std::endl;
+			return 1;
+		}
+	}
+	if (samples.empty())
+	{
+		Sample mesh = { "synthetic mesh header", to_binary(make_mesh_header()) };
+		samples.push_back(mesh);
+		Sample inventory = { llformat("synthetic inventory, %d items", count), to_binary(make_inventory(count)) };
+		samples.push_back(inventory);
+	}
+
+	for (const Sample& sample : samples)
+	{
+		// Headers are tiny, keep the timings above the timer resolution.
+		run(sample, sample.mData.size() < 4096 ? repeat * 100 : repeat);
+	}
+	return 0;
+}
@@ -34,6 +34,7 @@
 #include "../llmath/llmath.h"
 #include "llformat.h"
 #include "llsdserialize.h"
+#include "llsdarena.h" // <FS:Kadah/>
 #include "stringize.h"
 
 #include <limits>
@@ -100,8 +101,14 @@ protected:
 	bool shared() const							{ return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
 	
 	U32 mUseCount;
+	bool mArenaAllocated; // <FS:Kadah/> from an LLSDArena, see reset()
 
 public:
+	// <FS:Kadah> Nodes come from the thread's LLSDArena when one is open
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr);
+	// </FS:Kadah>
+
 	static void reset(Impl*& var, Impl* impl);
 		///< safely set var to refer to the new impl (possibly shared)
 		
@@ -657,6 +664,7 @@ namespace
 
 LLSD::Impl::Impl()
 	: mUseCount(0)
+	, mArenaAllocated(LLSDArena::isLastAllocation(this)) // <FS:Kadah/>
 {
 	++sAllocationCount;
 	++sOutstandingCount;
@@ -664,6 +672,7 @@ LLSD::Impl::Impl()
 
 LLSD::Impl::Impl(StaticAllocationMarker)
 	: mUseCount(0)
+	, mArenaAllocated(false) // <FS:Kadah/>
 {
 }
 
@@ -672,6 +681,26 @@ LLSD::Impl::~Impl()
 	--sOutstandingCount;
 }
 
+// <FS:Kadah> Nodes come from the thread's LLSDArena when one is open
+// static
+void* LLSD::Impl::operator new(size_t size)
+{
+	void* ptr = LLSDArena::allocate(size);
+	return ptr ? ptr : ::operator new(size);
+}
+
+// static
+void LLSD::Impl::operator delete(void* ptr)
+{
+	// Only reached for arena nodes when their constructor throws, reset()
+	// hands released arena nodes back itself.
+	if (!LLSDArena::rollback(ptr))
+	{
+		::operator delete(ptr);
+	}
+}
+// </FS:Kadah>
+
 void LLSD::Impl::reset(Impl*& var, Impl* impl)
 {
 	if (impl && impl->mUseCount != STATIC_USAGE_COUNT) 
@@ -680,7 +709,19 @@ void LLSD::Impl::reset(Impl*& var, Impl* impl)
 	}
 	if (var  &&  var->mUseCount != STATIC_USAGE_COUNT && --var->mUseCount == 0)
 	{
-		delete var;
+		// <FS:Kadah> Arena nodes are destroyed in place, the arena frees
+		// its blocks once all of them are gone.
+		//delete var;
+		if (var->mArenaAllocated)
+		{
+			var->~Impl();
+			LLSDArena::release(var);
+		}
+		else
+		{
+			delete var;
+		}
+		// </FS:Kadah>
 	}
 	var = impl;
 }
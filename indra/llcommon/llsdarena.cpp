@@ -0,0 +1,231 @@
+/**
+ * @file llsdarena.cpp
+ * @brief Scoped bump arena for the nodes of short lived LLSD documents.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsdarena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "lltimer.h"
+#include "lltrace.h"
+
+static LLTrace::MemStatHandle sArenaMemStat("LLSDArena");
+static LLTrace::CountStatHandle<> sArenaNodeCount("llsdarenanodes", "LLSD values allocated from an LLSDArena instead of the heap");
+static LLTrace::EventStatHandle<F64Milliseconds> sArenaLifetime("llsdarenalifetime", "Time from opening an LLSDArena to freeing its blocks");
+
+// Blocks start with a Block header and every node with a pointer back to
+// its Block, padded so the node itself keeps the alignment operator new
+// would have given it.
+static const size_t NODE_ALIGNMENT = alignof(std::max_align_t);
+
+static size_t align_up(size_t size)
+{
+	return (size + NODE_ALIGNMENT - 1) & ~(NODE_ALIGNMENT - 1);
+}
+
+static thread_local LLSDArena* sCurrentArena = nullptr;
+
+struct LLSDArena::Block
+{
+	Blocks*				mOwner;
+	std::atomic<U32>	mLive;	// nodes in this block still referenced
+	size_t				mSize;	// whole block, header included
+
+	U8* begin()	{ return (U8*)this + align_up(sizeof(Block)); }
+	U8* end()	{ return (U8*)this + mSize; }
+};
+
+static const size_t NODE_HEADER_SIZE = align_up(sizeof(void*));
+
+struct LLSDArena::Blocks
+{
+	Blocks(size_t block_size)
+	:	mBlockSize(block_size),
+		mCurrent(nullptr),
+		mPos(nullptr),
+		mEnd(nullptr),
+		mLastNode(nullptr),
+		mLive(1), // the open scope
+		mNodeCount(0),
+		mReservedBytes(0),
+		mStartTime(LLTimer::getTotalSeconds())
+	{}
+
+	~Blocks()
+	{
+		for (Block* block : mBlocks)
+		{
+			disclaim_alloc(sArenaMemStat, block->mSize);
+			block->~Block();
+			delete[] (U8*)block;
+		}
+		add(sArenaNodeCount, (F64)mNodeCount);
+		record(sArenaLifetime, F64Seconds(LLTimer::getTotalSeconds() - mStartTime));
+	}
+
+	void* allocate(size_t size)
+	{
+		size_t needed = NODE_HEADER_SIZE + align_up(size);
+
+		if (mCurrent && 0 == mCurrent->mLive.load(std::memory_order_acquire))
+		{
+			// Everything handed out from this block has been released.
+			mPos = mCurrent->begin();
+		}
+		if ((size_t)(mEnd - mPos) < needed)
+		{
+			nextBlock(needed);
+		}
+
+		*(Block**)mPos = mCurrent;
+		mLastNode = mPos;
+		mPos += needed;
+		++mNodeCount;
+		mCurrent->mLive.fetch_add(1, std::memory_order_relaxed);
+		mLive.fetch_add(1, std::memory_order_relaxed);
+		return mLastNode + NODE_HEADER_SIZE;
+	}
+
+	// Moves on to a block whose nodes have all been released, so that a few
+	// long lived values only pin the blocks they are in, or to a new block.
+	void nextBlock(size_t needed)
+	{
+		Block* next = nullptr;
+		for (Block* block : mBlocks)
+		{
+			if (block != mCurrent && 0 == block->mLive.load(std::memory_order_acquire)
+				&& (size_t)(block->end() - block->begin()) >= needed)
+			{
+				next = block;
+				break;
+			}
+		}
+		if (!next)
+		{
+			size_t block_size = llmax(mBlockSize, align_up(sizeof(Block)) + needed);
+			next = new (new U8[block_size]) Block;
+			next->mOwner = this;
+			next->mLive = 0;
+			next->mSize = block_size;
+			mBlocks.push_back(next);
+			mReservedBytes += block_size;
+			claim_alloc(sArenaMemStat, block_size);
+		}
+		mCurrent = next;
+		mPos = next->begin();
+		mEnd = next->end();
+	}
+
+	static void releaseNode(void* ptr)
+	{
+		Block* block = *(Block**)((U8*)ptr - NODE_HEADER_SIZE);
+		Blocks* owner = block->mOwner;
+		block->mLive.fetch_sub(1, std::memory_order_acq_rel);
+		owner->release();
+	}
+
+	// Deletes the arena when this was the last reference.
+	void release()
+	{
+		if (1 == mLive.fetch_sub(1, std::memory_order_acq_rel))
+		{
+			delete this;
+		}
+	}
+
+	std::vector<Block*>		mBlocks;
+	size_t					mBlockSize;
+	Block*					mCurrent;
+	U8*						mPos;
+	U8*						mEnd;
+	U8*						mLastNode;
+	std::atomic<U32>		mLive;		// nodes still referenced, plus one while the scope is open
+	U64						mNodeCount;
+	size_t					mReservedBytes;
+	F64						mStartTime;
+};
+
+LLSDArena::LLSDArena(size_t block_size)
+:	mBlocks(new Blocks(block_size)),
+	mPrevious(sCurrentArena)
+{
+	sCurrentArena = this;
+}
+
+LLSDArena::~LLSDArena()
+{
+	llassert(sCurrentArena == this);
+	sCurrentArena = mPrevious;
+	mBlocks->release();
+}
+
+U64 LLSDArena::getNodeCount() const
+{
+	return mBlocks->mNodeCount;
+}
+
+size_t LLSDArena::getReservedBytes() const
+{
+	return mBlocks->mReservedBytes;
+}
+
+// static
+void* LLSDArena::allocate(size_t size)
+{
+	return sCurrentArena ? sCurrentArena->mBlocks->allocate(size) : nullptr;
+}
+
+// static
+void LLSDArena::release(void* ptr)
+{
+	Blocks::releaseNode(ptr);
+}
+
+// static
+bool LLSDArena::isLastAllocation(const void* ptr)
+{
+	return sCurrentArena && sCurrentArena->mBlocks->mLastNode
+		&& (const U8*)ptr - NODE_HEADER_SIZE == sCurrentArena->mBlocks->mLastNode;
+}
+
+// static
+bool LLSDArena::rollback(void* ptr)
+{
+	if (!isLastAllocation(ptr))
+	{
+		return false;
+	}
+	Blocks* blocks = sCurrentArena->mBlocks;
+	blocks->mPos = blocks->mLastNode;
+	blocks->mLastNode = nullptr;
+	--blocks->mNodeCount;
+	Blocks::releaseNode(ptr);
+	return true;
+}
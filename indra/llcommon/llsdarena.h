@@ -0,0 +1,81 @@
+/**
+ * @file llsdarena.h
+ * @brief Scoped bump arena for the nodes of short lived LLSD documents.
+ *
+ * @Description:
+ * While an LLSDArena is alive, every LLSD value created on its thread takes
+ * its node (the hidden LLSD::Impl) from the arena instead of the heap. The
+ * arena memory is released in one go once the scope has ended and the last
+ * of its nodes has been released, so values that escape the scope stay
+ * valid; they only keep the arena's blocks around for longer. When all nodes
+ * of a block are released while the scope is still open (a parse loop that
+ * drops each document before reading the next one), the block is reused
+ * instead of the arena growing; a value kept past its iteration only pins
+ * the block it was allocated from.
+ *
+ * Maps and arrays still keep their std::map and std::vector storage on the
+ * heap; only the value nodes come from the arena.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSDARENA_H
+#define LL_LLSDARENA_H
+
+#include "llpreprocessor.h"
+#include "stdtypes.h"
+
+class LL_COMMON_API LLSDArena
+{
+public:
+	enum { DEFAULT_BLOCK_SIZE = 64 * 1024 };
+
+	LLSDArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+	~LLSDArena();
+
+	// Nodes handed out so far, each one a heap allocation and free saved.
+	U64 getNodeCount() const;
+	// Bytes of arena blocks currently reserved.
+	size_t getReservedBytes() const;
+
+	// Used by LLSD::Impl. allocate() returns nullptr when no arena is open
+	// on the calling thread. release() may be called from any thread.
+	static void* allocate(size_t size);
+	static void release(void* ptr);
+	// True if ptr is the most recent allocate() of this thread's arena.
+	static bool isLastAllocation(const void* ptr);
+	// Gives back the most recent allocate() of this thread's arena, for
+	// constructors that throw. Returns false if ptr is not that allocation.
+	static bool rollback(void* ptr);
+
+private:
+	LLSDArena(const LLSDArena&);
+	LLSDArena& operator=(const LLSDArena&);
+
+	struct Block;
+	struct Blocks;
+	Blocks*		mBlocks;
+	LLSDArena*	mPrevious;
+};
+
+#endif // LL_LLSDARENA_H
@@ -268,6 +268,21 @@ llssize deserialize_string(std::istream& istr, std::string& value, llssize max_b
  */
 llssize deserialize_string_delim(std::istream& istr, std::string& value, char d);
 
+// <FS:Kadah> Parse binary LLSD in place
+/**
+ * @brief Parse a delimited string out of a buffer.
+ *
+ * @param pos The read position, just past the opening delimiter. Advanced
+ * past the closing delimiter.
+ * @param end One past the last readable byte.
+ * @param value [out] The string which was found.
+ * @param d The delimiter to use.
+ * @return Returns number of bytes consumed. Returns PARSE_FAILURE (-1)
+ * if the buffer ends before the delimiter.
+ */
+llssize deserialize_string_delim(const U8*& pos, const U8* end, std::string& value, char d);
+// </FS:Kadah>
+
 /**
  * @brief Read a raw string off the stream.
  *
@@ -1234,6 +1249,342 @@ bool LLSDBinaryParser::parseString(
 	return true;
 }
 
+// <FS:Kadah> Parse binary LLSD in place
+namespace
+{
+	// Copies a fixed size value out of the buffer, false if it is too short.
+	inline bool read_buffer(const U8*& pos, const U8* end, void* value, size_t size)
+	{
+		if ((size_t)(end - pos) < size)
+		{
+			return false;
+		}
+		memcpy(value, pos, size);
+		pos += size;
+		return true;
+	}
+
+	// Reads the 4 byte network order size in front of strings, maps and
+	// arrays. Fails on sizes that cannot fit in what is left of the buffer.
+	inline bool read_size(const U8*& pos, const U8* end, S32& size)
+	{
+		U32 size_nbo = 0;
+		if (!read_buffer(pos, end, &size_nbo, sizeof(U32)))
+		{
+			return false;
+		}
+		size = (S32)ntohl(size_nbo);
+		return size >= 0 && size <= end - pos;
+	}
+}
+
+S32 LLSDBinaryParser::parseBuffer(const U8* buffer, size_t size, LLSD& data, llssize max_bytes,
+								  S32 max_depth, size_t* bytes_read) const
+{
+	if (LLSDSerialize::SIZE_UNLIMITED != max_bytes)
+	{
+		size = llmin(size, (size_t)llmax(max_bytes, (llssize)0));
+	}
+	const U8* pos = buffer;
+	S32 parse_count = buffer ? doParseBuffer(pos, buffer + size, data, max_depth) : 0;
+	if (bytes_read)
+	{
+		*bytes_read = pos - buffer;
+	}
+	return parse_count;
+}
+
+S32 LLSDBinaryParser::doParseBuffer(const U8*& pos, const U8* end, LLSD& data, S32 max_depth) const
+{
+	// See doParse() for the format.
+	if (pos >= end)
+	{
+		return 0;
+	}
+	char c = (char)*pos++;
+	if (max_depth == 0)
+	{
+		return PARSE_FAILURE;
+	}
+	S32 parse_count = 1;
+	switch(c)
+	{
+	case '{':
+	{
+		S32 child_count = parseMapBuffer(pos, end, data, max_depth - 1);
+		if((child_count == PARSE_FAILURE) || data.isUndefined())
+		{
+			parse_count = PARSE_FAILURE;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '[':
+	{
+		S32 child_count = parseArrayBuffer(pos, end, data, max_depth - 1);
+		if((child_count == PARSE_FAILURE) || data.isUndefined())
+		{
+			parse_count = PARSE_FAILURE;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '!':
+		data.clear();
+		break;
+
+	case '0':
+		data = false;
+		break;
+
+	case '1':
+		data = true;
+		break;
+
+	case 'i':
+	{
+		U32 value_nbo = 0;
+		if (read_buffer(pos, end, &value_nbo, sizeof(U32)))
+		{
+			data = (S32)ntohl(value_nbo);
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary integer." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'r':
+	{
+		F64 real_nbo = 0.0;
+		if (read_buffer(pos, end, &real_nbo, sizeof(F64)))
+		{
+			data = ll_ntohd(real_nbo);
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary real." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'u':
+	{
+		LLUUID id;
+		if (read_buffer(pos, end, id.mData, UUID_BYTES))
+		{
+			data = id;
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary uuid." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case '\'':
+	case '"':
+	{
+		std::string value;
+		if (PARSE_FAILURE == deserialize_string_delim(pos, end, value, c))
+		{
+			LL_INFOS() << "BUFFER END reading binary (notation-style) string."
+				<< LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		else
+		{
+			data = value;
+		}
+		break;
+	}
+
+	case 's':
+	{
+		std::string value;
+		if (parseStringBuffer(pos, end, value))
+		{
+			data = value;
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary string." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'l':
+	{
+		std::string value;
+		if (parseStringBuffer(pos, end, value))
+		{
+			data = LLURI(value);
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary link." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'd':
+	{
+		F64 real = 0.0;
+		if (read_buffer(pos, end, &real, sizeof(F64)))
+		{
+			data = LLDate(real);
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary date." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'b':
+	{
+		S32 size = 0;
+		if (read_size(pos, end, size))
+		{
+			data = LLSD::Binary(pos, pos + size);
+			pos += size;
+		}
+		else
+		{
+			LL_INFOS() << "BUFFER END reading binary." << LL_ENDL;
+			parse_count = PARSE_FAILURE;
+		}
+		break;
+	}
+
+	default:
+		parse_count = PARSE_FAILURE;
+		LL_INFOS() << "Unrecognized character while parsing: int(" << int(c)
+			<< ")" << LL_ENDL;
+		break;
+	}
+	if(PARSE_FAILURE == parse_count)
+	{
+		data.clear();
+	}
+	return parse_count;
+}
+
+S32 LLSDBinaryParser::parseMapBuffer(const U8*& pos, const U8* end, LLSD& map, S32 max_depth) const
+{
+	map = LLSD::emptyMap();
+	S32 size = 0;
+	if (!read_size(pos, end, size))
+	{
+		return PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	// Reused across keys to save an allocation per entry.
+	std::string name;
+	while (pos < end && *pos != '}' && count < size)
+	{
+		char c = (char)*pos++;
+		name.clear();
+		switch(c)
+		{
+		case 'k':
+			if(!parseStringBuffer(pos, end, name))
+			{
+				return PARSE_FAILURE;
+			}
+			break;
+		case '\'':
+		case '"':
+			if (PARSE_FAILURE == deserialize_string_delim(pos, end, name, c))
+			{
+				return PARSE_FAILURE;
+			}
+			break;
+		}
+		LLSD child;
+		S32 child_count = doParseBuffer(pos, end, child, max_depth);
+		if(child_count > 0)
+		{
+			// There must be a value for every key, thus child_count
+			// must be greater than 0.
+			parse_count += child_count;
+			map.insert(name, child);
+		}
+		else
+		{
+			return PARSE_FAILURE;
+		}
+		++count;
+	}
+	if (pos >= end || *pos++ != '}' || count < size)
+	{
+		// Make sure it is correctly terminated and we parsed as many
+		// as were said to be there.
+		return PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+S32 LLSDBinaryParser::parseArrayBuffer(const U8*& pos, const U8* end, LLSD& array, S32 max_depth) const
+{
+	array = LLSD::emptyArray();
+	S32 size = 0;
+	if (!read_size(pos, end, size))
+	{
+		return PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	while (pos < end && *pos != ']' && count < size)
+	{
+		LLSD child;
+		S32 child_count = doParseBuffer(pos, end, child, max_depth);
+		if(PARSE_FAILURE == child_count)
+		{
+			return PARSE_FAILURE;
+		}
+		parse_count += child_count;
+		array.append(child);
+		++count;
+	}
+	if (pos >= end || *pos++ != ']' || count < size)
+	{
+		// Make sure it is correctly terminated and we parsed as many
+		// as were said to be there.
+		return PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+bool LLSDBinaryParser::parseStringBuffer(const U8*& pos, const U8* end, std::string& value) const
+{
+	S32 size = 0;
+	if (!read_size(pos, end, size))
+	{
+		return false;
+	}
+	value.assign((const char*)pos, size);
+	pos += size;
+	return true;
+}
+// </FS:Kadah>
+
 
 /**
  * LLSDFormatter
@@ -1728,6 +2079,87 @@ llssize deserialize_string_delim(
 	return count;
 }
 
+// <FS:Kadah> Parse binary LLSD in place
+llssize deserialize_string_delim(
+	const U8*& pos,
+	const U8* end,
+	std::string& value,
+	char delim)
+{
+	const U8* start = pos;
+	value.clear();
+
+	// Most strings have no escapes: find the delimiter and copy in one go.
+	const U8* run = pos;
+	while (run < end && *run != delim && *run != '\\')
+	{
+		++run;
+	}
+	value.append((const char*)pos, run - pos);
+	pos = run;
+
+	while (pos < end)
+	{
+		char next_char = (char)*pos++;
+		if (next_char == delim)
+		{
+			return pos - start;
+		}
+		if (next_char != '\\')
+		{
+			value += next_char;
+			continue;
+		}
+		if (pos >= end)
+		{
+			break;
+		}
+		next_char = (char)*pos++;
+		switch (next_char)
+		{
+		case 'x':
+		{
+			if (end - pos < 2)
+			{
+				pos = end;
+				break;
+			}
+			U8 byte = hex_as_nybble((char)pos[0]) << 4;
+			byte |= hex_as_nybble((char)pos[1]);
+			pos += 2;
+			value += (char)byte;
+			break;
+		}
+		case 'a':
+			value += '\a';
+			break;
+		case 'b':
+			value += '\b';
+			break;
+		case 'f':
+			value += '\f';
+			break;
+		case 'n':
+			value += '\n';
+			break;
+		case 'r':
+			value += '\r';
+			break;
+		case 't':
+			value += '\t';
+			break;
+		case 'v':
+			value += '\v';
+			break;
+		default:
+			value += next_char;
+			break;
+		}
+	}
+	return LLSDParser::PARSE_FAILURE;
+}
+// </FS:Kadah>
+
 llssize deserialize_string_raw(
 	std::istream& istr,
 	std::string& value,
@@ -2278,9 +2710,12 @@ LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, const U8* in, S32
 	{
 		char* result_ptr = strip_deprecated_header((char*)result, cur_size);
 
-		boost::iostreams::stream<boost::iostreams::array_source> istrm(result_ptr, cur_size);
-		
-		if (!LLSDSerialize::fromBinary(data, istrm, cur_size, UNZIP_LLSD_MAX_DEPTH))
+		// <FS:Kadah> Parse the inflated block in place
+		//boost::iostreams::stream<boost::iostreams::array_source> istrm(result_ptr, cur_size);
+		//
+		//if (!LLSDSerialize::fromBinary(data, istrm, cur_size, UNZIP_LLSD_MAX_DEPTH))
+		if (!LLSDSerialize::fromBinary(data, (const U8*)result_ptr, cur_size, cur_size, UNZIP_LLSD_MAX_DEPTH))
+		// </FS:Kadah>
 		{
 			// free(result);
 			if( result )
@@ -358,6 +358,29 @@ public:
 	 */
 	LLSDBinaryParser();
 
+	// <FS:Kadah> Parse binary LLSD in place
+	/** 
+	 * @brief Call this method to parse a buffer for LLSD.
+	 *
+	 * Same format, result and return value as parse() on a stream,
+	 * but the bytes are read in place rather than pulled one value at
+	 * a time through std::istream. Nothing past buffer + size or past
+	 * max_bytes is read.
+	 * @param buffer The serialized data.
+	 * @param size The number of bytes available at buffer.
+	 * @param data[out] The newly parse structured data.
+	 * @param max_bytes The maximum number of bytes to consume. Pass in
+	 *  LLSDSerialize::SIZE_UNLIMITED (-1) to only stop at size.
+	 * @param max_depth Max depth parser will check before exiting
+	 *  with parse error, -1 - unlimited.
+	 * @param bytes_read[out] If not null, the number of bytes consumed.
+	 * @return Returns the number of LLSD objects parsed into
+	 * data. Returns PARSE_FAILURE (-1) on parse failure.
+	 */
+	S32 parseBuffer(const U8* buffer, size_t size, LLSD& data, llssize max_bytes,
+					S32 max_depth = -1, size_t* bytes_read = nullptr) const;
+	// </FS:Kadah>
+
 protected:
 	/** 
 	 * @brief Call this method to parse a stream for LLSD.
@@ -406,6 +429,14 @@ private:
 	 * @return Retuns true if a complete string was parsed.
 	 */
 	bool parseString(std::istream& istr, std::string& value) const;
+
+	// <FS:Kadah> Buffer counterparts of the above. pos is advanced past
+	// whatever was consumed and never moves beyond end.
+	S32 doParseBuffer(const U8*& pos, const U8* end, LLSD& data, S32 max_depth) const;
+	S32 parseMapBuffer(const U8*& pos, const U8* end, LLSD& map, S32 max_depth) const;
+	S32 parseArrayBuffer(const U8*& pos, const U8* end, LLSD& array, S32 max_depth) const;
+	bool parseStringBuffer(const U8*& pos, const U8* end, std::string& value) const;
+	// </FS:Kadah>
 };
 
 
@@ -846,6 +877,13 @@ public:
 		(void)p->parse(str, sd, max_bytes, max_depth);
 		return sd;
 	}
+	// <FS:Kadah> Parse binary LLSD straight from memory
+	static S32 fromBinary(LLSD& sd, const U8* buffer, size_t size, llssize max_bytes, S32 max_depth = -1)
+	{
+		LLPointer<LLSDBinaryParser> p = new LLSDBinaryParser;
+		return p->parseBuffer(buffer, size, sd, max_bytes, max_depth);
+	}
+	// </FS:Kadah>
 };
 
 class LL_COMMON_API LLUZipHelper : public LLRefCount
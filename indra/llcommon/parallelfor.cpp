@@ -0,0 +1,96 @@
+/**
+ * @file parallelfor.cpp
+ * @brief Implementation for LL::parallelFor().
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "parallelfor.h"
+// STL headers
+#include <atomic>
+#include <memory>
+// other Linden headers
+#include "llcond.h"
+#include "threadpool.h"
+
+namespace
+{
+
+    // Shared with the pool tasks, which may start after parallelFor() has
+    // returned. By then every item is claimed and mWork is not called.
+    struct Batch
+    {
+        Batch(size_t count, const std::function<void(size_t)>& work):
+            mWork(work),
+            mCount(count),
+            mNext(0),
+            mDone(0)
+        {}
+
+        // Runs items until none are left.
+        void run()
+        {
+            for (size_t i = mNext++; i < mCount; i = mNext++)
+            {
+                mWork(i);
+                mDone.update_one([](size_t& done) { ++done; });
+            }
+        }
+
+        const std::function<void(size_t)>& mWork;
+        const size_t                        mCount;
+        std::atomic<size_t>                 mNext;
+        LLScalarCond<size_t>                mDone;
+    };
+
+} // anonymous namespace
+
+void LL::parallelFor(const std::string& pool_name, size_t count,
+                     const std::function<void(size_t)>& work)
+{
+    if (!count)
+    {
+        return;
+    }
+
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>(count, work);
+
+    LL::ThreadPool::ptr_t pool = LL::ThreadPool::getInstance(pool_name);
+    size_t tasks = pool ? llmin(count - 1, pool->getWidth()) : 0;
+    for (size_t i = 0; i < tasks; ++i)
+    {
+        if (!pool->getQueue().postIfOpen([batch]() { batch->run(); }))
+        {
+            break;
+        }
+    }
+
+    batch->run();
+    {
+        LL_PROFILE_ZONE_NAMED("parallelFor - wait");
+        batch->mDone.wait_equal(count);
+    }
+}
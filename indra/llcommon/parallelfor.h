@@ -0,0 +1,53 @@
+/**
+ * @file parallelfor.h
+ * @brief Spread the items of a loop over a ThreadPool and the calling thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#if ! defined(LL_PARALLELFOR_H)
+#define LL_PARALLELFOR_H
+
+#include <functional>
+#include <string>
+
+namespace LL
+{
+
+    /**
+     * Calls work(i) once for every i in [0, count) and returns when all of
+     * those calls have returned. The calling thread works through the items
+     * along with up to one task per thread of the named ThreadPool, each
+     * claiming the next item as it is done with the last, so uneven items
+     * balance out. work must be safe to call for different items at once.
+     *
+     * Without that pool, or once it is closing, every item runs on the
+     * calling thread. Posting to the pool and waking its threads has a cost
+     * of its own; the callers decide how much work makes that worthwhile.
+     */
+    void parallelFor(const std::string& pool_name, size_t count,
+                     const std::function<void(size_t)>& work);
+
+} // namespace LL
+
+#endif /* ! defined(LL_PARALLELFOR_H) */
@@ -0,0 +1,164 @@
+/**
+ * @file llsdarena_test.cpp
+ * @brief LLSDArena test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <sstream>
+#include <thread>
+
+#include "../llsd.h"
+#include "../llsdarena.h"
+#include "../llsdserialize.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLSDArenaFixture
+	{
+		static LLSD makeDocument(S32 n)
+		{
+			LLSD doc;
+			doc["id"] = n;
+			doc["name"] = llformat("document %d", n);
+			doc["list"].append(1.5);
+			doc["list"].append(LLSD::emptyMap());
+			doc["list"][1]["flag"] = true;
+			return doc;
+		}
+
+		// LLSD has no deep operator==, compare through the notation form.
+		static std::string toString(const LLSD& sd)
+		{
+			std::ostringstream ostr;
+			ostr << sd;
+			return ostr.str();
+		}
+	};
+	typedef test_group<LLSDArenaFixture> LLSDArena_factory;
+	typedef LLSDArena_factory::object LLSDArena_t;
+	LLSDArena_factory tf("LLSDArena");
+
+	template<> template<>
+	void LLSDArena_t::test<1>()
+	{
+		set_test_name("values built in an arena");
+		std::string expected = toString(makeDocument(7));
+		LLSDArena arena;
+		ensure_equals("nothing allocated yet", arena.getNodeCount(), U64(0));
+		LLSD doc = makeDocument(7);
+		ensure_equals("same document", toString(doc), expected);
+		ensure("nodes came from the arena", arena.getNodeCount() > 0);
+		ensure("blocks reserved", arena.getReservedBytes() >= LLSDArena::DEFAULT_BLOCK_SIZE);
+	}
+
+	template<> template<>
+	void LLSDArena_t::test<2>()
+	{
+		set_test_name("values outliving the arena");
+		LLSD kept;
+		LLSD shared = LLSD::emptyArray();
+		{
+			LLSDArena arena;
+			LLSD doc = makeDocument(1);
+			kept = doc["list"];
+			shared.append(doc);
+		}
+		ensure_equals("kept", toString(kept), toString(makeDocument(1)["list"]));
+		ensure_equals("shared", toString(shared[0]), toString(makeDocument(1)));
+
+		// The last reference may go away on another thread.
+		std::thread([&]()
+		{
+			shared.clear();
+		}).join();
+		ensure("cleared", shared.isUndefined());
+	}
+
+	template<> template<>
+	void LLSDArena_t::test<3>()
+	{
+		set_test_name("blocks reused by a parse loop");
+		std::ostringstream ostr;
+		LLSDSerialize::toBinary(makeDocument(3), ostr);
+		std::string data = ostr.str();
+		LLPointer<LLSDBinaryParser> parser = new LLSDBinaryParser;
+
+		LLSDArena arena(4096);
+		LLSD kept = LLSD::emptyArray();
+		size_t reserved = 0;
+		for (S32 i = 0; i < 5000; ++i)
+		{
+			LLSD doc;
+			ensure("parsed", parser->parseBuffer((const U8*)data.data(), data.size(), doc, data.size()) > 0);
+			if (i % 1000 == 0)
+			{
+				// Only pins the block this value lives in.
+				kept.append(doc["id"]);
+			}
+			if (10 == i)
+			{
+				reserved = arena.getReservedBytes();
+			}
+		}
+		ensure("several documents per block", arena.getNodeCount() > 5000);
+		ensure("arena did not keep growing", arena.getReservedBytes() <= reserved + 5 * 4096);
+		ensure_equals("kept values", kept.size(), 5);
+		ensure_equals("kept value", kept[4].asInteger(), 3);
+	}
+
+	template<> template<>
+	void LLSDArena_t::test<4>()
+	{
+		set_test_name("nested arenas");
+		LLSDArena outer;
+		LLSD a = "outer";
+		U64 outer_nodes = outer.getNodeCount();
+		LLSD b;
+		{
+			LLSDArena inner;
+			b = "inner";
+			ensure_equals("inner node", inner.getNodeCount(), U64(1));
+		}
+		ensure_equals("outer untouched while inner was open", outer.getNodeCount(), outer_nodes);
+		LLSD c = "outer again";
+		ensure_equals("outer node", outer.getNodeCount(), outer_nodes + 1);
+		ensure_equals("inner value", b.asString(), "inner");
+	}
+
+	template<> template<>
+	void LLSDArena_t::test<5>()
+	{
+		set_test_name("no arena");
+		LLSD doc = makeDocument(5);
+		{
+			LLSDArena arena;
+		}
+		ensure_equals("heap document", doc["id"].asInteger(), 5);
+		ensure_equals("allocations go to the heap again", LLSDArena::allocate(16), (void*)NULL);
+	}
+}
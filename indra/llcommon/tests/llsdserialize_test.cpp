@@ -1171,6 +1171,25 @@ namespace tut
 	{
 	public:
 		TestLLSDBinaryParsing() {}
+
+		// <FS:Kadah> Every binary parse test also goes through parseBuffer()
+		void ensureParse(
+			const std::string& msg,
+			const std::string& in,
+			const LLSD& expected_value,
+			S32 expected_count,
+			S32 depth_limit = -1)
+		{
+			TestLLSDParsing<LLSDBinaryParser>::ensureParse(
+				msg, in, expected_value, expected_count, depth_limit);
+
+			LLSD parsed_result;
+			S32 parsed_count = mParser->parseBuffer(
+				(const U8*)in.data(), in.size(), parsed_result, in.size(), depth_limit);
+			ensure_equals(msg + " (buffer)", parsed_result, expected_value);
+			ensure_equals(msg + " (buffer count)", parsed_count, expected_count);
+		}
+		// </FS:Kadah>
 	};
 
 	typedef tut::test_group<TestLLSDBinaryParsing> TestLLSDBinaryParsingGroup;
@@ -1488,12 +1507,52 @@ namespace tut
 			1);
 	}
 
-/*
+	// <FS:Kadah> parseBuffer() limits and unzip_llsd()
 	template<> template<> 
 	void TestLLSDBinaryParsingObject::test<11>()
 	{
+		LLSD val;
+		val["name"] = "amy";
+		val["list"].append(LLUUID::generateNewID());
+		val["list"].append(LLSD::emptyMap());
+		val["list"][1]["age"] = 23;
+		val["list"][1]["weight"] = 1.5;
+		val["blob"] = string_to_vector("some bytes");
+		std::ostringstream ostr;
+		LLSDSerialize::toBinary(val, ostr);
+		std::string str = ostr.str();
+		const U8* buffer = (const U8*)str.data();
+
+		LLSD parsed;
+		// The values inside the innermost map sit at depth 4.
+		ensure_equals("depth 4", mParser->parseBuffer(buffer, str.size(), parsed, str.size(), 4), 8);
+		ensure_equals("depth 4 data", parsed, val);
+		ensure_equals("depth 3", mParser->parseBuffer(buffer, str.size(), parsed, str.size(), 3),
+					  (S32)LLSDParser::PARSE_FAILURE);
+		ensure("depth 3 data", parsed.isUndefined());
+
+		// max_bytes caps what is read even when the buffer holds more.
+		ensure_equals("max_bytes", mParser->parseBuffer(buffer, str.size(), parsed, str.size() - 1),
+					  (S32)LLSDParser::PARSE_FAILURE);
+		ensure_equals("short buffer", mParser->parseBuffer(buffer, str.size() - 1, parsed, str.size()),
+					  (S32)LLSDParser::PARSE_FAILURE);
+
+		// One object is read, whatever follows is left alone.
+		std::string trailing = str + "garbage";
+		size_t bytes_read = 0;
+		ensure_equals("trailing", mParser->parseBuffer((const U8*)trailing.data(), trailing.size(), parsed,
+													   LLSDSerialize::SIZE_UNLIMITED, -1, &bytes_read), 8);
+		ensure_equals("trailing data", parsed, val);
+		ensure_equals("trailing bytes read", bytes_read, str.size());
+
+		std::string zipped = zip_llsd(val);
+		ensure("zipped", !zipped.empty());
+		LLSD unzipped;
+		ensure_equals("unzip_llsd", LLUZipHelper::unzip_llsd(unzipped, (const U8*)zipped.data(), (S32)zipped.size()),
+					  LLUZipHelper::ZR_OK);
+		ensure_equals("unzip_llsd data", unzipped, val);
 	}
-*/
+	// </FS:Kadah>
 
    /**
 	 * @class TestLLSDCrossCompatible
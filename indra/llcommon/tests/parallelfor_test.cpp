@@ -0,0 +1,95 @@
+/**
+ * @file parallelfor_test.cpp
+ * @brief LL::parallelFor() test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "parallelfor.h"
+// STL headers
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+// other Linden headers
+#include "../test/lltut.h"
+#include "threadpool.h"
+
+namespace tut
+{
+    struct parallelfor_data
+    {
+    };
+    typedef test_group<parallelfor_data> parallelfor_group;
+    typedef parallelfor_group::object object;
+    parallelfor_group parallelforgrp("parallelfor");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("every item once, on the pool and the caller");
+        LL::ThreadPool pool("parallelfor_test", 3);
+        pool.start();
+
+        const size_t COUNT = 1000;
+        std::unique_ptr<std::atomic<int>[]> calls(new std::atomic<int>[COUNT]());
+        std::vector<std::thread::id> threads(COUNT);
+        LL::parallelFor("parallelfor_test", COUNT, [&](size_t i)
+        {
+            ++calls[i];
+            threads[i] = std::this_thread::get_id();
+            // long enough for the pool threads to take their share
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        });
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            ensure_equals("calls of item", calls[i].load(), 1);
+        }
+        std::set<std::thread::id> used(threads.begin(), threads.end());
+        ensure("caller worked", used.count(std::this_thread::get_id()) == 1);
+        ensure("pool worked", used.size() > 1);
+        pool.close();
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("runs in place without the pool");
+        const size_t COUNT = 10;
+        std::vector<int> calls(COUNT, 0);
+        LL::parallelFor("no such pool", COUNT, [&](size_t i)
+        {
+            ++calls[i];
+        });
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            ensure_equals("calls of item", calls[i], 1);
+        }
+        LL::parallelFor("no such pool", 0, [&](size_t) { ensure("no items, no calls", false); });
+    }
+}
@@ -163,6 +163,12 @@ const long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 // request, ready and active queues.
 const int HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS = 2;
 
+// <FS:Kadah> Longest the worker thread blocks on the sockets of
+// active requests before taking another pass.  Completions and
+// new requests end the wait early.
+const int HTTP_SERVICE_LOOP_WAIT_MAX_MS = 100;
+// </FS:Kadah>
+
 // Block allocation size (a tuning parameter) is found
 // in bufferarray.h.
 
@@ -32,6 +32,12 @@
 #include "_httppolicy.h"
 
 #include "llhttpconstants.h"
+#include "lltimer.h" // <FS:Kadah/>
+
+// <FS:Kadah/> close() for the socket callbacks
+#if ! LL_WINDOWS
+#include <unistd.h>
+#endif
 
 namespace
 {
@@ -51,6 +57,53 @@ void check_curl_multi_setopt(CURLM* handle, CURLMoption option, ARG argument)
 
 static const char * const LOG_CORE("CoreHttp");
 
+// <FS:Kadah> Event driven service loop.  curl_multi_wakeup() is the
+// newer of the two calls needed.
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define LLCORE_HTTP_MULTI_POLL 1
+#else
+#define LLCORE_HTTP_MULTI_POLL 0
+#endif
+
+#if LLCORE_HTTP_MULTI_POLL
+void add_wait_fd(curl_socket_t fd, short events, std::vector<curl_waitfd> & wait_fds)
+{
+	for (std::vector<curl_waitfd>::iterator iter(wait_fds.begin()); wait_fds.end() != iter; ++iter)
+	{
+		if (iter->fd == fd)
+		{
+			iter->events |= events;
+			return;
+		}
+	}
+	curl_waitfd wait_fd;
+	wait_fd.fd = fd;
+	wait_fd.events = events;
+	wait_fd.revents = 0;
+	wait_fds.push_back(wait_fd);
+}
+
+void add_wait_fds(const fd_set & fds, int max_fd, short events, std::vector<curl_waitfd> & wait_fds)
+{
+#if LL_WINDOWS
+	// Winsock fd_sets are arrays of sockets rather than bitmaps
+	for (u_int i(0); i < fds.fd_count; ++i)
+	{
+		add_wait_fd(fds.fd_array[i], events, wait_fds);
+	}
+#else
+	for (int fd(0); fd <= max_fd; ++fd)
+	{
+		if (FD_ISSET(fd, &fds))
+		{
+			add_wait_fd(fd, events, wait_fds);
+		}
+	}
+#endif
+}
+#endif // LLCORE_HTTP_MULTI_POLL
+// </FS:Kadah>
+
 } // end anonymous namespace
 
 
@@ -64,7 +117,11 @@ HttpLibcurl::HttpLibcurl(HttpService * service)
 	  mPolicyCount(0),
 	  mMultiHandles(NULL),
 	  mActiveHandles(NULL),
-	  mDirtyPolicy(NULL)
+	  mDirtyPolicy(NULL),
+	  // <FS:Kadah> Event driven service loop
+	  mWakeHandle(NULL),
+	  mUnsetSockets(0)
+	  // </FS:Kadah>
 {}
 
 
@@ -107,6 +164,14 @@ void HttpLibcurl::shutdown()
 		mDirtyPolicy = NULL;
 	}
 
+	// <FS:Kadah> Event driven service loop
+	if (mWakeHandle)
+	{
+		curl_multi_cleanup(mWakeHandle);
+		mWakeHandle = NULL;
+	}
+	// </FS:Kadah>
+
 	mPolicyCount = 0;
 }
 
@@ -132,6 +197,17 @@ void HttpLibcurl::start(int policy_count)
 		mDirtyPolicy[policy_class] = false;
 		policyUpdated(policy_class);
 	}
+
+	// <FS:Kadah> Event driven service loop.  Without it the service
+	// thread sleeps between passes as it always did.
+#if LLCORE_HTTP_MULTI_POLL
+	if (NULL == (mWakeHandle = curl_multi_init()))
+	{
+		LL_WARNS(LOG_CORE) << "Failed to allocate wakeup multi handle in libcurl."
+						   << LL_ENDL;
+	}
+#endif
+	// </FS:Kadah>
 }
 
 
@@ -205,12 +281,130 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
 
 	if (! mActiveOps.empty())
 	{
-		ret = HttpService::NORMAL;
+		// <FS:Kadah> Socket activity ends the wait, no need to poll.
+		//ret = HttpService::NORMAL;
+		ret = (std::min)(ret, HttpService::TRANSPORT_WAIT);
+		// </FS:Kadah>
 	}
 	return ret;
 }
 
 
+// <FS:Kadah> Event driven service loop
+void HttpLibcurl::waitForActivity(int max_ms)
+{
+#if LLCORE_HTTP_MULTI_POLL
+	if (! mWakeHandle)
+	{
+		ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+		return;
+	}
+
+	// Sockets of all classes are polled as extra fds of the wakeup
+	// handle, it has no transfers of its own.
+	long timeout_ms(max_ms);
+	mWaitFds.clear();
+	for (int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+	{
+		if (! mMultiHandles[policy_class] || ! mActiveHandles[policy_class])
+		{
+			continue;
+		}
+
+		long curl_timeout(-1);
+		curl_multi_timeout(mMultiHandles[policy_class], &curl_timeout);
+		if (curl_timeout >= 0)
+		{
+			timeout_ms = (std::min)(timeout_ms, curl_timeout);
+		}
+
+		fd_set read_fds, write_fds, exc_fds;
+		FD_ZERO(&read_fds);
+		FD_ZERO(&write_fds);
+		FD_ZERO(&exc_fds);
+		int max_fd(-1);
+		check_curl_multi_code(curl_multi_fdset(mMultiHandles[policy_class], &read_fds, &write_fds, &exc_fds, &max_fd));
+		if (max_fd < 0)
+		{
+			// Nothing to wait on while resolving, keep polling this class.
+			timeout_ms = (std::min)(timeout_ms, long(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS));
+			continue;
+		}
+		add_wait_fds(read_fds, max_fd, CURL_WAIT_POLLIN, mWaitFds);
+		add_wait_fds(write_fds, max_fd, CURL_WAIT_POLLOUT, mWaitFds);
+		add_wait_fds(exc_fds, max_fd, CURL_WAIT_POLLPRI, mWaitFds);
+#if LL_WINDOWS
+		if (read_fds.fd_count >= FD_SETSIZE || write_fds.fd_count >= FD_SETSIZE || exc_fds.fd_count >= FD_SETSIZE)
+		{
+			// A full set may have dropped sockets
+			timeout_ms = (std::min)(timeout_ms, long(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS));
+		}
+#endif
+	}
+
+	// curl_multi_fdset() leaves out sockets numbered FD_SETSIZE and up,
+	// those transfers only progress when the poll times out.
+	if (mUnsetSockets > 0)
+	{
+		timeout_ms = (std::min)(timeout_ms, long(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS));
+	}
+
+	if (timeout_ms > 0)
+	{
+		CURLMcode status(curl_multi_poll(mWakeHandle,
+										 mWaitFds.empty() ? NULL : &mWaitFds[0],
+										 (unsigned int) mWaitFds.size(),
+										 int(timeout_ms),
+										 NULL));
+		if (CURLM_OK != status)
+		{
+			check_curl_multi_code(status);
+			ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+		}
+	}
+#else
+	ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+#endif
+}
+
+
+void HttpLibcurl::wakeup()
+{
+#if LLCORE_HTTP_MULTI_POLL
+	if (mWakeHandle)
+	{
+		curl_multi_wakeup(mWakeHandle);
+	}
+#endif
+}
+
+
+#if ! LL_WINDOWS
+curl_socket_t HttpLibcurl::openSocketCallback(void * userdata, curlsocktype purpose, curl_sockaddr * address)
+{
+	curl_socket_t socket(::socket(address->family, address->socktype, address->protocol));
+	if (CURL_SOCKET_BAD != socket && socket >= FD_SETSIZE)
+	{
+		HttpLibcurl * transport(static_cast<HttpLibcurl *>(userdata));
+		++transport->mUnsetSockets;
+	}
+	return socket;
+}
+
+
+int HttpLibcurl::closeSocketCallback(void * userdata, curl_socket_t socket)
+{
+	if (socket >= FD_SETSIZE)
+	{
+		HttpLibcurl * transport(static_cast<HttpLibcurl *>(userdata));
+		--transport->mUnsetSockets;
+	}
+	return ::close(socket);
+}
+#endif
+// </FS:Kadah>
+
+
 // Caller has provided us with a ref count on op.
 void HttpLibcurl::addOp(const HttpOpRequest::ptr_t &op)
 {
@@ -33,6 +33,7 @@
 #include <curl/multi.h>
 
 #include <set>
+#include <vector> // <FS:Kadah/>
 
 #include "httprequest.h"
 #include "_httpservice.h"
@@ -103,6 +104,33 @@ public:
 	/// Threading:  called by worker thread.
 	void shutdown();
 
+	// <FS:Kadah> Event driven service loop
+	/// Block until a socket of an active request is ready, libcurl
+	/// wants to run its timers, wakeup() is called or @max_ms
+	/// milliseconds pass, whichever is first.  Falls back to
+	/// sleeping when libcurl is too old for curl_multi_poll().
+	///
+	/// Threading:  called by worker thread.
+	void waitForActivity(int max_ms);
+
+	/// End a waitForActivity() call early, or the next one if
+	/// none is in progress.
+	///
+	/// Threading:  callable by any thread between start() and
+	/// shutdown().
+	void wakeup();
+
+#if ! LL_WINDOWS
+	/// libcurl socket callbacks, installed by HttpOpRequest with
+	/// this instance as client data.  They count the sockets that
+	/// curl_multi_fdset() cannot return to waitForActivity().
+	///
+	/// Threading:  called by worker thread.
+	static curl_socket_t openSocketCallback(void * userdata, curlsocktype purpose, curl_sockaddr * address);
+	static int closeSocketCallback(void * userdata, curl_socket_t socket);
+#endif
+	// </FS:Kadah>
+
 	/// Return global and per-class counts of active requests.
 	///
 	/// Threading:  called by worker thread.
@@ -215,6 +243,11 @@ protected:
 	CURLM **			mMultiHandles;		// One handle per policy class
 	int *				mActiveHandles;		// Active count per policy class
 	bool *				mDirtyPolicy;		// Dirty policy update waiting for stall (per pc)
+	// <FS:Kadah> Event driven service loop
+	CURLM *				mWakeHandle;		// Polled with the sockets of all classes, target of wakeup()
+	std::vector<curl_waitfd> mWaitFds;		// Scratch for waitForActivity()
+	int					mUnsetSockets;		// Open sockets too large for an fd_set
+	// </FS:Kadah>
 	
 }; // end class HttpLibcurl
 
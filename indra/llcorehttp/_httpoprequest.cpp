@@ -510,6 +510,14 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 	check_curl_easy_setopt(mCurlHandle, CURLOPT_NOPROGRESS, 1);
 	check_curl_easy_setopt(mCurlHandle, CURLOPT_URL, mReqURL.c_str());
 	check_curl_easy_setopt(mCurlHandle, CURLOPT_PRIVATE, getHandle());
+	// <FS:Kadah> Let the transport count sockets too large for an fd_set
+#if ! LL_WINDOWS
+	check_curl_easy_setopt(mCurlHandle, CURLOPT_OPENSOCKETFUNCTION, HttpLibcurl::openSocketCallback);
+	check_curl_easy_setopt(mCurlHandle, CURLOPT_OPENSOCKETDATA, &service->getTransport());
+	check_curl_easy_setopt(mCurlHandle, CURLOPT_CLOSESOCKETFUNCTION, HttpLibcurl::closeSocketCallback);
+	check_curl_easy_setopt(mCurlHandle, CURLOPT_CLOSESOCKETDATA, &service->getTransport());
+#endif
+	// </FS:Kadah>
 
 // <FS:ND/> Newer versions of curl are stricter with checkinng Cotent-Encoding: header
 // Aws returns Content-Encoding: binary/octet-stream which is no valid scheme defined by HTTP/1.1 (compress,deflate, gzip)
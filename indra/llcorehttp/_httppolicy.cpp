@@ -323,7 +323,12 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
 		if (! readyq.empty() || ! retryq.empty())
 		{
 			// If anything is ready, continue looping...
-			result = HttpService::NORMAL;
+			// <FS:Kadah> Unless it only waits for a connection to
+			// free up, a completion ends the transport's wait.
+			//result = HttpService::NORMAL;
+			const bool timed(! retryq.empty() || (throttle_enabled && state.mThrottleLeft <= 0));
+			result = (std::min)(result, timed ? HttpService::NORMAL : HttpService::TRANSPORT_WAIT);
+			// </FS:Kadah>
 		}
 	} // end foreach policy_class
 
@@ -81,6 +81,12 @@ HttpStatus HttpRequestQueue::addOp(const HttpRequestQueue::opPtr_t &op)
 		}
 		wake = mQueue.empty();
 		mQueue.push_back(op);
+		// <FS:Kadah> Under the lock, see setWakeup()
+		if (wake && mWakeup)
+		{
+			mWakeup();
+		}
+		// </FS:Kadah>
 	}
 	if (wake)
 	{
@@ -142,6 +148,16 @@ void HttpRequestQueue::wakeAll()
 }
 
 
+// <FS:Kadah> Event driven service loop
+void HttpRequestQueue::setWakeup(const wakeup_t & wakeup)
+{
+	HttpScopedLock lock(mQueueMutex);
+
+	mWakeup = wakeup;
+}
+// </FS:Kadah>
+
+
 bool HttpRequestQueue::stopQueue()
 {
 	{
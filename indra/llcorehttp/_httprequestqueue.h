@@ -29,6 +29,7 @@
 
 
 #include <vector>
+#include <boost/function.hpp> // <FS:Kadah/>
 
 #include "httpcommon.h"
 #include "_refcounted.h"
@@ -116,6 +117,19 @@ public:
 	/// Threading:  callable by any thread.
 	void wakeAll();
 
+	// <FS:Kadah> Event driven service loop
+	typedef boost::function<void ()> wakeup_t;
+
+	/// Install a function called whenever an operation is added to
+	/// an empty queue, so a worker that is waiting on something
+	/// other than the queue's condition variable can be woken.
+	/// Called with the queue locked; clearing it with an empty
+	/// function guarantees no call is in progress on return.
+	///
+	/// Threading:  callable by any thread.
+	void setWakeup(const wakeup_t & wakeup);
+	// </FS:Kadah>
+
 	/// Disallow further request queuing.  Callers to @addOp will
 	/// get a failure status (LLCORE, HE_SHUTTING_DOWN).  Callers
 	/// to @fetchAll or @fetchOp will get requests that are on the
@@ -134,6 +148,7 @@ protected:
 	LLCoreInt::HttpMutex				mQueueMutex;
 	LLCoreInt::HttpConditionVariable	mQueueCV;
 	bool								mQueueStopped;
+	wakeup_t							mWakeup; // <FS:Kadah/>
 	
 }; // end class HttpRequestQueue
 
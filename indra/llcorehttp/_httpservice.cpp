@@ -207,6 +207,8 @@ void HttpService::startThread()
 	// Push current policy definitions, enable policy & transport components
 	mPolicy->start();
 	mTransport->start(mLastPolicy + 1);
+	// <FS:Kadah/> New requests end the transport's wait
+	mRequestQueue->setWakeup(boost::bind(&HttpLibcurl::wakeup, mTransport));
 
 	mThread = new LLCoreInt::HttpThread(boost::bind(&HttpService::threadRun, this, _1));
 	sState = RUNNING;
@@ -278,6 +280,9 @@ void HttpService::shutdown()
     }
     ops.clear();
 
+	// <FS:Kadah/> Must not be called once the transport is gone
+	mRequestQueue->setWakeup(HttpRequestQueue::wakeup_t());
+
 	// Shutdown transport canceling requests, freeing resources
 	mTransport->shutdown();
 
@@ -305,17 +310,39 @@ void HttpService::threadRun(LLCoreInt::HttpThread * thread)
 		    loop = processRequestQueue(loop);
 
 		    // Process ready queue issuing new requests as needed
-		    ELoopSpeed new_loop = mPolicy->processReadyQueue();
-		    loop = (std::min)(loop, new_loop);
+		    // <FS:Kadah> Event driven service loop
+		    //ELoopSpeed new_loop = mPolicy->processReadyQueue();
+		    //loop = (std::min)(loop, new_loop);
+		    ELoopSpeed policy_loop = mPolicy->processReadyQueue();
+		    // </FS:Kadah>
 		
 		    // Give libcurl some cycles
-		    new_loop = mTransport->processTransport();
-		    loop = (std::min)(loop, new_loop);
+		    // <FS:Kadah> Event driven service loop
+		    //new_loop = mTransport->processTransport();
+		    //loop = (std::min)(loop, new_loop);
+		    ELoopSpeed transport_loop = mTransport->processTransport();
+		    if (NORMAL == transport_loop)
+		    {
+			    // Completions may have freed connections, issue the
+			    // waiting requests now rather than after the wait.
+			    policy_loop = mPolicy->processReadyQueue();
+			    transport_loop = mTransport->getActiveCount() ? TRANSPORT_WAIT : REQUEST_SLEEP;
+		    }
+		    loop = (std::min)(loop, (std::min)(policy_loop, transport_loop));
+		    // </FS:Kadah>
 		
 		    // Determine whether to spin, sleep briefly or sleep for next request
 		    if (REQUEST_SLEEP != loop)
 		    {
-			    ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+			    // <FS:Kadah> Wait on the sockets of active requests and
+			    // for new requests instead of sleeping a fixed time.
+			    // Policy timers (retries, throttles) still want a pass
+			    // every HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS.
+			    //ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+			    mTransport->waitForActivity(NORMAL == loop
+											? HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS
+											: HTTP_SERVICE_LOOP_WAIT_MAX_MS);
+			    // </FS:Kadah>
 		    }
         }
         catch (const LLContinueError&)
@@ -48,6 +48,7 @@
 #endif
 #include "test_httpheaders.hpp"
 #include "test_httprequestqueue.hpp"
+#include "test_httplatency.hpp" // <FS:Kadah/>
 #include "_httpservice.h"
 
 #include "llproxy.h"
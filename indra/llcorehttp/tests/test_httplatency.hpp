@@ -0,0 +1,161 @@
+/**
+ * @file test_httplatency.hpp
+ * @brief Turnaround benchmark of HttpRequest against the local test server
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+#ifndef TEST_LLCORE_HTTP_LATENCY_H_
+#define TEST_LLCORE_HTTP_LATENCY_H_
+
+#include "httprequest.h"
+#include "httphandler.h"
+#include "httpresponse.h"
+#include "httpoptions.h"
+#include "httpheaders.h"
+#include "_httpservice.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "lltimer.h"
+
+#include "llcorehttp_test.h"
+
+
+namespace tut
+{
+
+struct HttpLatencyTestData
+{
+};
+
+// Records when the response to the current request was handed back.
+class LatencyHandler : public LLCore::HttpHandler
+{
+public:
+	LatencyHandler()
+		: mCompleted(0),
+		  mFailed(0),
+		  mCompletedAt(0)
+		{}
+
+	virtual void onCompleted(LLCore::HttpHandle, LLCore::HttpResponse * response)
+		{
+			mCompletedAt = LLTimer::getTotalTime();
+			if (! response || ! response->getStatus())
+			{
+				++mFailed;
+			}
+			++mCompleted;
+		}
+
+	int		mCompleted;
+	int		mFailed;
+	U64		mCompletedAt;
+};
+
+typedef test_group<HttpLatencyTestData> HttpLatencyTestGroupType;
+typedef HttpLatencyTestGroupType::object HttpLatencyTestObjectType;
+HttpLatencyTestGroupType HttpLatencyTestGroup("HttpLatency Tests");
+
+// Issues GETs one at a time so each one's turnaround is the time the
+// service thread takes to pick the request up, run it and hand the
+// response back, and reports the percentiles.  The pump spins rather
+// than sleeping between updates so it does not add to the numbers.
+template <> template <>
+void HttpLatencyTestObjectType::test<1>()
+{
+	ScopedCurlInit ready;
+
+	std::string url_base(get_base_url());
+
+	set_test_name("HttpRequest GET turnaround");
+
+	const int REQUEST_COUNT(200);
+	const U64 REQUEST_TIMEOUT_US(10000000);
+
+	LatencyHandler handler;
+	LLCore::HttpHandler::ptr_t handlerp(&handler, [](LLCore::HttpHandler *) {});
+
+	LLCore::HttpRequest * req = NULL;
+
+	try
+	{
+		LLCore::HttpRequest::createService();
+		LLCore::HttpRequest::startThread();
+		req = new LLCore::HttpRequest();
+
+		std::vector<U64> turnaround;
+		turnaround.reserve(REQUEST_COUNT);
+
+		// One extra to open the connection, not counted.
+		for (int i(0); i <= REQUEST_COUNT; ++i)
+		{
+			const int completed(handler.mCompleted);
+			const U64 start(LLTimer::getTotalTime());
+			LLCore::HttpHandle handle = req->requestGet(LLCore::HttpRequest::DEFAULT_POLICY_ID,
+														0U,
+														url_base,
+														LLCore::HttpOptions::ptr_t(),
+														LLCore::HttpHeaders::ptr_t(),
+														handlerp);
+			ensure("Valid handle returned for request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+			while (handler.mCompleted == completed
+				   && LLTimer::getTotalTime() - start < REQUEST_TIMEOUT_US)
+			{
+				req->update(0);
+			}
+			ensure("Request executed in reasonable time", handler.mCompleted > completed);
+			if (i > 0)
+			{
+				turnaround.push_back(handler.mCompletedAt - start);
+			}
+		}
+		ensure("All requests succeeded", 0 == handler.mFailed);
+
+		std::sort(turnaround.begin(), turnaround.end());
+		std::cout << "GET turnaround over " << turnaround.size() << " requests:  p50 "
+				  << turnaround[turnaround.size() / 2] << " us, p99 "
+				  << turnaround[(turnaround.size() * 99) / 100] << " us, max "
+				  << turnaround.back() << " us" << std::endl;
+
+		stop_thread(req);
+		delete req;
+		req = NULL;
+
+		LLCore::HttpRequest::destroyService();
+	}
+	catch (...)
+	{
+		stop_thread(req);
+		delete req;
+		LLCore::HttpRequest::destroyService();
+		throw;
+	}
+}
+
+}  // end namespace tut
+
+#endif  // TEST_LLCORE_HTTP_LATENCY_H_
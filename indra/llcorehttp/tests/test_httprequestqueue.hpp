@@ -151,6 +151,42 @@ void HttpRequestqueueTestObjectType::test<4>()
 	}
 }
 
+// <FS:Kadah> Event driven service loop
+template <> template <>
+void HttpRequestqueueTestObjectType::test<5>()
+{
+	set_test_name("HttpRequestQueue wakeup on first op");
+
+	HttpRequestQueue::init();
+
+	HttpRequestQueue * rq = HttpRequestQueue::instanceOf();
+
+	int wakeups(0);
+	rq->setWakeup([&wakeups]() { ++wakeups; });
+
+	HttpOperation::ptr_t op (new HttpOpNull());
+	rq->addOp(op);
+	ensure("Wakeup when the queue was empty", 1 == wakeups);
+
+	op.reset(new HttpOpNull());
+	rq->addOp(op);
+	ensure("No wakeup when it was not", 1 == wakeups);
+
+	HttpRequestQueue::OpContainer ops;
+	rq->fetchAll(false, ops);
+	ensure("Both ops queued", 2 == ops.size());
+	ops.clear();
+
+	rq->setWakeup(HttpRequestQueue::wakeup_t());
+	op.reset(new HttpOpNull());
+	rq->addOp(op);
+	ensure("No wakeup once cleared", 1 == wakeups);
+
+	op.reset();
+	HttpRequestQueue::term();
+}
+// </FS:Kadah>
+
 }  // end namespace tut
 
 
@@ -0,0 +1,228 @@
+/**
+ * @file disk_cache_bench.cpp
+ * @brief Times starting and purging LLDiskCache on a large synthetic cache, against the directory scans it used to do.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "llassettype.h"
+#include "lldir.h"
+#include "lldiskcache.h"
+#include "llfile.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+#include <boost/filesystem.hpp>
+
+static const char* SUBDIRS = "0123456789abcdef";
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tdisk_cache_bench [options]\n"
+		"\n"
+		"Fills a scratch disk cache with synthetic asset files and times\n"
+		"starting LLDiskCache and purging it, against the recursive scan\n"
+		"that purge() and the cache size used to do for the same files.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -d <dir>        Scratch directory.  Default:  system temp dir\n"
+		" -n <count>      Files in the cache.  Default:  200000\n"
+		" -s <bytes>      Average file size.  Default:  512\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+// Asset sizes vary a lot, their access times spread over a month
+static uintmax_t populate(const std::string& cache_dir, S32 count, S32 average_size)
+{
+	LLFile::mkdir(cache_dir);
+	for (S32 i = 0; i < 16; ++i)
+	{
+		LLFile::mkdir(cache_dir + gDirUtilp->getDirDelimiter() + SUBDIRS[i]);
+	}
+
+	const std::time_t now = std::time(nullptr);
+	std::string data(average_size * 2, 'x');
+	uintmax_t total = 0;
+	boost::system::error_code ec;
+	for (S32 i = 0; i < count; ++i)
+	{
+		const std::string id = LLUUID::generateNewID().asString();
+		const std::string path = llformat("%s%s%c%ssl_cache_%s_0.asset", cache_dir.c_str(),
+										  gDirUtilp->getDirDelimiter().c_str(), id[0],
+										  gDirUtilp->getDirDelimiter().c_str(), id.c_str());
+		const size_t size = 1 + rand() % (average_size * 2);
+		LLUniqueFile file = LLFile::fopen(path, "wb");
+		if (!file || fwrite(data.data(), 1, size, file) != size)
+		{
+			std::cerr << "Unable to write " << path << std::endl;
+			return 0;
+		}
+		file.close();
+		boost::filesystem::last_write_time(path, now - rand() % (30 * 24 * 60 * 60), ec);
+		total += size;
+	}
+	return total;
+}
+
+// What purge() did before the index, every minute: stat every file in the
+// cache and sort them all by time. dirFileSize() was the same scan without
+// the sort.
+static F64 legacy_scan(const std::string& cache_dir, bool sort, uintmax_t& total, size_t& files)
+{
+	F64 start = LLTimer::getTotalSeconds();
+	typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
+	std::vector<file_info_t> file_info;
+	total = 0;
+
+	boost::system::error_code ec;
+	boost::filesystem::recursive_directory_iterator iter(cache_dir, ec);
+	while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
+	{
+		if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed()
+			&& (*iter).path().string().find("sl_cache") != std::string::npos)
+		{
+			uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
+			const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
+			if (!ec.failed())
+			{
+				total += file_size;
+				file_info.push_back(file_info_t(file_time, { file_size, (*iter).path().string() }));
+			}
+		}
+		iter.increment(ec);
+	}
+	if (sort)
+	{
+		std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
+		{
+			return x.first < y.first;
+		});
+	}
+	files = file_info.size();
+	return LLTimer::getTotalSeconds() - start;
+}
+
+static F64 start_cache(const std::string& cache_dir, uintmax_t max_size)
+{
+	F64 start = LLTimer::getTotalSeconds();
+	LLDiskCache::initParamSingleton(cache_dir, max_size, false, 95.f, 70.f);
+	return LLTimer::getTotalSeconds() - start;
+}
+
+static F64 purge_cache()
+{
+	F64 start = LLTimer::getTotalSeconds();
+	LLDiskCache::instance().purge();
+	return LLTimer::getTotalSeconds() - start;
+}
+
+int main(int argc, char** argv)
+{
+	std::string dir = LLFile::tmpdir();
+	S32 count = 200000;
+	S32 average_size = 512;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-d" && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-s" && i + 1 < argc)
+		{
+			average_size = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	const std::string cache_dir = gDirUtilp->add(dir, "disk_cache_bench");
+	srand(1);
+	F64 start = LLTimer::getTotalSeconds();
+	const uintmax_t total = populate(cache_dir, count, average_size);
+	if (!total)
+	{
+		return 1;
+	}
+	F64 populate_seconds = LLTimer::getTotalSeconds() - start;
+	fprintf(stdout, "%d files, %.1f MB, written in %.1f s\n", count, total / (1024.0 * 1024.0), populate_seconds);
+
+	uintmax_t scanned = 0;
+	size_t files = 0;
+	F64 legacy_size_seconds = legacy_scan(cache_dir, false, scanned, files);
+	F64 legacy_purge_seconds = legacy_scan(cache_dir, true, scanned, files);
+	fprintf(stdout, "scan:   cache size %8.1f ms   purge without deleting %8.1f ms  (%d files)\n",
+			legacy_size_seconds * 1000.0, legacy_purge_seconds * 1000.0, (S32)files);
+
+	// No index yet, the first start scans once and writes it
+	const uintmax_t roomy = total * 2;
+	F64 first_start_seconds = start_cache(cache_dir, roomy);
+	F64 idle_purge_seconds = purge_cache();
+
+	// Over the high water mark, down to the low one
+	LLDiskCache::instance().setMaxSizeBytes(total);
+	F64 purge_seconds = purge_cache();
+	legacy_scan(cache_dir, false, scanned, files);
+	const uintmax_t purged_size = scanned;
+	const size_t purged_files = files;
+
+	// A param singleton cannot be started twice, the next run's start is
+	// the index it closed being read back
+	LLDiskCache::deleteSingleton();
+	LLDiskCacheIndex index;
+	start = LLTimer::getTotalSeconds();
+	bool opened = index.open(cache_dir + gDirUtilp->getDirDelimiter() + LLDiskCache::INDEX_FILENAME);
+	F64 startup_seconds = LLTimer::getTotalSeconds() - start;
+	const bool consistent = opened && index.getEntryCount() == purged_files && index.getTotalSize() == purged_size;
+	index.close();
+
+	fprintf(stdout, "index:  first start %8.1f ms   start %8.1f ms%s   purge below high water %8.3f ms\n",
+			first_start_seconds * 1000.0, startup_seconds * 1000.0, consistent ? "" : " (INDEX MISMATCH)",
+			idle_purge_seconds * 1000.0);
+	fprintf(stdout, "        purge %8.1f ms, %d files left (%.0f%% of the size)\n",
+			purge_seconds * 1000.0, (S32)purged_files, purged_size * 100.0 / total);
+	fprintf(stdout, "speedup: start %.0fx, idle purge %.0fx\n",
+			legacy_size_seconds / llmax(startup_seconds, 1e-6),
+			legacy_purge_seconds / llmax(idle_purge_seconds, 1e-6));
+
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(cache_dir, ec);
+	return 0;
+}
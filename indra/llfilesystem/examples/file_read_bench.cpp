@@ -0,0 +1,304 @@
+/**
+ * @file file_read_bench.cpp
+ * @brief Times small range reads of asset cache files, per call opens against kept open handles and batches.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+
+#include "linden_common.h"
+
+#include "llassettype.h"
+#include "lldir.h"
+#include "lldiskcache.h"
+#include "llfile.h"
+#include "llfilesystem.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+#include <boost/filesystem.hpp>
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tfile_read_bench [options]\n"
+		"\n"
+		"Fills a scratch disk cache with synthetic assets and reads a header\n"
+		"and a few small ranges of each, the way the mesh and asset loaders\n"
+		"do, through LLFileSystem opening the file for every read, through\n"
+		"kept open handles and as batches, on io_uring and with pread().\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -d <dir>        Scratch directory.  Default:  system temp dir\n"
+		" -n <count>      Assets in the cache.  Default:  2000\n"
+		" -s <bytes>      Asset size.  Default:  32768\n"
+		" -r <ranges>     Ranges read after the header.  Default:  4\n"
+		" -p <passes>     Passes over all assets.  Default:  5\n"
+		" -l <handles>    Handles kept open.  Default:  64\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+static const S32 HEADER_SIZE = 256;
+static const S32 RANGE_SIZE = 1024;
+
+// Where the ranges of an asset start, spread over it the same way each pass
+static S32 range_offset(S32 asset, S32 range, S32 asset_size)
+{
+	return HEADER_SIZE + ((asset * 7919 + range * 104729) % (asset_size - HEADER_SIZE - RANGE_SIZE));
+}
+
+// Header first, then the ranges it points at, one LLFileSystem each
+static F64 read_serial(const std::vector<LLUUID>& ids, S32 ranges, S32 asset_size, S32 passes, U64& checksum)
+{
+	std::vector<U8> buffer(RANGE_SIZE);
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (S32 asset = 0; asset < (S32)ids.size(); ++asset)
+		{
+			LLFileSystem file(ids[asset], LLAssetType::AT_MESH);
+			file.read(buffer.data(), HEADER_SIZE);
+			checksum += buffer[0];
+			for (S32 range = 0; range < ranges; ++range)
+			{
+				file.seek(range_offset(asset, range, asset_size), 0);
+				file.read(buffer.data(), RANGE_SIZE);
+				checksum += buffer[RANGE_SIZE - 1];
+			}
+		}
+	}
+	return LLTimer::getTotalSeconds() - start;
+}
+
+// Headers of 64 assets as one batch, then all of their ranges as another
+static F64 read_batched(LLAsyncFileReader& reader, const std::vector<LLUUID>& ids, S32 ranges, S32 asset_size,
+						S32 passes, U64& checksum)
+{
+	const S32 BATCH = 64;
+	std::vector<U8> buffers(BATCH * ranges * RANGE_SIZE);
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (S32 first = 0; first < (S32)ids.size(); first += BATCH)
+		{
+			const S32 last = llmin(first + BATCH, (S32)ids.size());
+			LLAsyncFileReader::request_list_t headers;
+			for (S32 asset = first; asset < last; ++asset)
+			{
+				headers.push_back(LLFileSystem::makeReadRequest(ids[asset], LLAssetType::AT_MESH, 0, HEADER_SIZE,
+																&buffers[(asset - first) * HEADER_SIZE]));
+			}
+			reader.read(headers);
+			checksum += buffers[0];
+
+			LLAsyncFileReader::request_list_t requests;
+			for (S32 asset = first; asset < last; ++asset)
+			{
+				for (S32 range = 0; range < ranges; ++range)
+				{
+					U8* buffer = &buffers[((asset - first) * ranges + range) * RANGE_SIZE];
+					requests.push_back(LLFileSystem::makeReadRequest(ids[asset], LLAssetType::AT_MESH,
+																	 range_offset(asset, range, asset_size),
+																	 RANGE_SIZE, buffer));
+				}
+			}
+			reader.read(requests);
+			for (const LLAsyncFileReader::Request& request : requests)
+			{
+				checksum += request.mBuffer[RANGE_SIZE - 1];
+			}
+		}
+	}
+	return LLTimer::getTotalSeconds() - start;
+}
+
+// All batches posted at once, what a loader that does not wait for them
+// does. They are made up front, so that posting does not compete with the
+// workers.
+static F64 read_async(LLAsyncFileReader& reader, const std::vector<LLUUID>& ids, S32 ranges, S32 asset_size,
+					  S32 passes, U64& checksum)
+{
+	const S32 BATCH = 64;
+	std::vector<U8> buffers(ids.size() * (ranges + 1) * RANGE_SIZE);
+	std::vector<LLAsyncFileReader::request_list_ptr_t> batches;
+	for (S32 first = 0; first < (S32)ids.size(); first += BATCH)
+	{
+		const S32 last = llmin(first + BATCH, (S32)ids.size());
+		LLAsyncFileReader::request_list_ptr_t requests = std::make_shared<LLAsyncFileReader::request_list_t>();
+		for (S32 asset = first; asset < last; ++asset)
+		{
+			U8* buffer = &buffers[asset * (ranges + 1) * RANGE_SIZE];
+			requests->push_back(LLFileSystem::makeReadRequest(ids[asset], LLAssetType::AT_MESH, 0, HEADER_SIZE, buffer));
+			for (S32 range = 0; range < ranges; ++range)
+			{
+				requests->push_back(LLFileSystem::makeReadRequest(ids[asset], LLAssetType::AT_MESH,
+																  range_offset(asset, range, asset_size),
+																  RANGE_SIZE, buffer + (range + 1) * RANGE_SIZE));
+			}
+		}
+		batches.push_back(requests);
+	}
+
+	std::mutex mutex;
+	std::condition_variable done;
+	size_t pending = 0;
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		pending = batches.size();
+		for (const LLAsyncFileReader::request_list_ptr_t& requests : batches)
+		{
+			reader.readAsync(requests, [&](const LLAsyncFileReader::request_list_ptr_t& batch)
+				{
+					U64 sum = 0;
+					for (const LLAsyncFileReader::Request& request : *batch)
+					{
+						sum += request.mBuffer[0];
+					}
+					std::lock_guard<std::mutex> lock(mutex);
+					checksum += sum;
+					if (!--pending)
+					{
+						done.notify_one();
+					}
+				});
+		}
+		// The passes reuse the buffers
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&pending]() { return pending == 0; });
+	}
+	return LLTimer::getTotalSeconds() - start;
+}
+
+static void report_batches(LLAsyncFileReader& reader, const std::vector<LLUUID>& ids, S32 ranges, S32 asset_size,
+						   S32 passes, F64 reads, F64 legacy_seconds)
+{
+	const char* backend = reader.usesIOUring() ? "io_uring" : "pread";
+	U64 checksum = 0;
+	F64 seconds = read_batched(reader, ids, ranges, asset_size, passes, checksum);
+	fprintf(stdout, "batches, %-8s  %8.1f ms  %8.0f reads/s  %.2fx\n", backend, seconds * 1000.0, reads / seconds,
+			legacy_seconds / seconds);
+	seconds = read_async(reader, ids, ranges, asset_size, passes, checksum);
+	fprintf(stdout, "async,   %-8s  %8.1f ms  %8.0f reads/s  %.2fx\n", backend, seconds * 1000.0, reads / seconds,
+			legacy_seconds / seconds);
+}
+
+int main(int argc, char** argv)
+{
+	std::string dir = LLFile::tmpdir();
+	S32 count = 2000;
+	S32 asset_size = 32768;
+	S32 ranges = 4;
+	S32 passes = 5;
+	U32 handles = 64;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-d" && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-s" && i + 1 < argc)
+		{
+			asset_size = llmax(atoi(argv[++i]), HEADER_SIZE + RANGE_SIZE + 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			ranges = llmax(atoi(argv[++i]), 0);
+		}
+		else if (arg == "-p" && i + 1 < argc)
+		{
+			passes = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-l" && i + 1 < argc)
+		{
+			handles = (U32)llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	const std::string cache_dir = gDirUtilp->add(dir, "file_read_bench");
+	LLDiskCache::initParamSingleton(cache_dir, (uintmax_t)count * asset_size * 2, false, 95.f, 70.f);
+
+	srand(1);
+	std::vector<LLUUID> ids;
+	std::vector<U8> data(asset_size);
+	for (S32 i = 0; i < count; ++i)
+	{
+		for (U8& byte : data)
+		{
+			byte = (U8)rand();
+		}
+		ids.push_back(LLUUID::generateNewID());
+		LLFileSystem file(ids.back(), LLAssetType::AT_MESH, LLFileSystem::WRITE);
+		if (!file.write(data.data(), asset_size))
+		{
+			std::cerr << "Unable to write asset " << i << std::endl;
+			return 1;
+		}
+	}
+
+	const F64 reads = (F64)count * passes * (ranges + 1);
+	fprintf(stdout, "%d assets of %d bytes, header and %d ranges of %d bytes each, %d passes\n",
+			count, asset_size, ranges, RANGE_SIZE, passes);
+
+	U64 expected = 0;
+	LLDiskCache::instance().setFileHandleLimit(0);
+	F64 legacy_seconds = read_serial(ids, ranges, asset_size, passes, expected);
+	fprintf(stdout, "open per read:     %8.1f ms  %8.0f reads/s\n", legacy_seconds * 1000.0, reads / legacy_seconds);
+
+	U64 checksum = 0;
+	LLDiskCache::instance().setFileHandleLimit(handles);
+	F64 handle_seconds = read_serial(ids, ranges, asset_size, passes, checksum);
+	fprintf(stdout, "%3u open handles:  %8.1f ms  %8.0f reads/s  %.2fx%s\n", handles, handle_seconds * 1000.0,
+			reads / handle_seconds, legacy_seconds / handle_seconds, checksum == expected ? "" : " (MISMATCH)");
+
+	LLAsyncFileReader& reader = LLDiskCache::instance().getFileReader();
+	report_batches(reader, ids, ranges, asset_size, passes, reads, legacy_seconds);
+	if (reader.usesIOUring())
+	{
+		LLAsyncFileReader pool_reader("FileReadBenchPool", LLDiskCache::instance().getFileHandles(), 2, false);
+		report_batches(pool_reader, ids, ranges, asset_size, passes, reads, legacy_seconds);
+		pool_reader.close();
+	}
+
+	LLDiskCache::deleteSingleton();
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(cache_dir, ec);
+	return 0;
+}
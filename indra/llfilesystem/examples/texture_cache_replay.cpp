@@ -0,0 +1,320 @@
+/**
+ * @file texture_cache_replay.cpp
+ * @brief Replays a texture cache workload against the per-file and slab body layouts.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "lldir.h"
+#include "llfile.h"
+#include "llslabstore.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+// Mirrors the body split done by LLTextureCache: the first FIRST_PACKET_SIZE
+// bytes of every texture live in texture.cache, only the rest is a body.
+static const S32 HEADER_BYTES = 600;
+
+struct Spec
+{
+	LLUUID	mID;
+	S32		mSize; // body size
+};
+typedef std::vector<Spec> spec_list_t;
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\ttexture_cache_replay [options] [workload_file]\n"
+		"\n"
+		"Replays a list of texture ids and sizes (one '<uuid> <bytes>' pair per\n"
+		"line, e.g. collected from texture.entries) against the one-file-per-body\n"
+		"texture cache layout and against the slab arena, and reports write,\n"
+		"cold read (first read after reopening the cache) and warm read throughput.\n"
+		"Without a workload file a synthetic crowded-region workload is used.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -d <dir>        Scratch directory.  Default:  system temp dir\n"
+		" -n <count>      Synthetic workload size.  Default:  4000\n"
+		" -s <MB>         Slab arena capacity.  Default:  2x the workload\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+static void load_workload(std::istream& in, spec_list_t& specs)
+{
+	std::string id;
+	S32 size;
+	while (in >> id >> size)
+	{
+		Spec spec;
+		if (spec.mID.set(id, false) && size > HEADER_BYTES)
+		{
+			spec.mSize = size - HEADER_BYTES;
+			specs.push_back(spec);
+		}
+	}
+}
+
+static void make_workload(S32 count, spec_list_t& specs)
+{
+	// Rough texture mix of a busy region: mostly 256/512 px, some 1024 px.
+	static const S32 sizes[] = { 8000, 22000, 45000, 90000, 180000, 350000 };
+	for (S32 i = 0; i < count; ++i)
+	{
+		Spec spec;
+		spec.mID.generate();
+		spec.mSize = sizes[rand() % LL_ARRAY_SIZE(sizes)] + rand() % 4096;
+		specs.push_back(spec);
+	}
+}
+
+struct Result
+{
+	F64 mSeconds;
+	U64 mBytes;
+	S32 mOps;
+};
+
+static void report(const char* layout, const char* phase, const Result& result)
+{
+	F64 mb = (F64)result.mBytes / (1024.0 * 1024.0);
+	fprintf(stdout, "%-6s %-10s %8d ops %10.1f MB %9.3f s %10.1f MB/s %10.0f ops/s\n",
+			layout, phase, result.mOps, mb, result.mSeconds,
+			result.mSeconds > 0.0 ? mb / result.mSeconds : 0.0,
+			result.mSeconds > 0.0 ? result.mOps / result.mSeconds : 0.0);
+}
+
+//----------------------------------------------------------------------------
+// One body file per texture, as in cache/texturecache/[0-F]/UUID.texture
+
+static std::string body_filename(const std::string& dir, const LLUUID& id)
+{
+	std::string idstr = id.asString();
+	return gDirUtilp->add(dir, idstr.substr(0, 1), idstr + ".texture");
+}
+
+static Result write_files(const std::string& dir, const spec_list_t& specs, const std::vector<U8>& payload)
+{
+	Result result = { 0.0, 0, 0 };
+	LLFile::mkdir(dir);
+	const char* subdirs = "0123456789abcdef";
+	for (S32 i = 0; i < 16; ++i)
+	{
+		LLFile::mkdir(gDirUtilp->add(dir, std::string(1, subdirs[i])));
+	}
+
+	F64 start = LLTimer::getTotalSeconds();
+	for (const Spec& spec : specs)
+	{
+		LLUniqueFile file = LLFile::fopen(body_filename(dir, spec.mID), "wb");
+		if (file && fwrite(&payload[0], 1, spec.mSize, file) == (size_t)spec.mSize)
+		{
+			result.mBytes += spec.mSize;
+			++result.mOps;
+		}
+	}
+	result.mSeconds = LLTimer::getTotalSeconds() - start;
+	return result;
+}
+
+static Result read_files(const std::string& dir, const spec_list_t& specs, std::vector<U8>& buffer)
+{
+	Result result = { 0.0, 0, 0 };
+	F64 start = LLTimer::getTotalSeconds();
+	for (const Spec& spec : specs)
+	{
+		// LLTextureCacheRemoteWorker::doRead(): size the body, then open/seek/read/close it.
+		std::string filename = body_filename(dir, spec.mID);
+		llstat st;
+		if (LLFile::stat(filename, &st) != 0)
+		{
+			continue;
+		}
+		LLUniqueFile file = LLFile::fopen(filename, "rb");
+		if (file && fread(&buffer[0], 1, (size_t)st.st_size, file) == (size_t)st.st_size)
+		{
+			result.mBytes += st.st_size;
+			++result.mOps;
+		}
+	}
+	result.mSeconds = LLTimer::getTotalSeconds() - start;
+	return result;
+}
+
+static void remove_files(const std::string& dir)
+{
+	const char* subdirs = "0123456789abcdef";
+	for (S32 i = 0; i < 16; ++i)
+	{
+		std::string subdir = gDirUtilp->add(dir, std::string(1, subdirs[i]));
+		gDirUtilp->deleteFilesInDir(subdir, "*");
+		LLFile::rmdir(subdir);
+	}
+	LLFile::rmdir(dir);
+}
+
+//----------------------------------------------------------------------------
+// Slab arena
+
+static Result write_slabs(LLSlabStore& store, const spec_list_t& specs, const std::vector<U8>& payload)
+{
+	Result result = { 0.0, 0, 0 };
+	F64 start = LLTimer::getTotalSeconds();
+	for (const Spec& spec : specs)
+	{
+		if (store.write(spec.mID, &payload[0], spec.mSize))
+		{
+			result.mBytes += spec.mSize;
+			++result.mOps;
+		}
+	}
+	result.mSeconds = LLTimer::getTotalSeconds() - start;
+	return result;
+}
+
+static Result read_slabs(LLSlabStore& store, const spec_list_t& specs, std::vector<U8>& buffer)
+{
+	Result result = { 0.0, 0, 0 };
+	F64 start = LLTimer::getTotalSeconds();
+	for (const Spec& spec : specs)
+	{
+		S32 size = store.getSize(spec.mID);
+		if (size > 0 && store.read(spec.mID, &buffer[0], 0, size) == size)
+		{
+			result.mBytes += size;
+			++result.mOps;
+		}
+	}
+	result.mSeconds = LLTimer::getTotalSeconds() - start;
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	std::string dir = LLFile::tmpdir();
+	S32 count = 4000;
+	U64 capacity_mb = 0;
+	std::string workload_file;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-d" && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-s" && i + 1 < argc)
+		{
+			capacity_mb = (U64)atoi(argv[++i]);
+		}
+		else if (arg[0] == '-')
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+		else
+		{
+			workload_file = arg;
+		}
+	}
+
+	spec_list_t specs;
+	if (!workload_file.empty())
+	{
+		llifstream in(workload_file.c_str());
+		if (!in.is_open())
+		{
+			std::cerr << "Unable to open " << workload_file << std::endl;
+			return 1;
+		}
+		load_workload(in, specs);
+	}
+	else
+	{
+		srand(1);
+		make_workload(count, specs);
+	}
+	if (specs.empty())
+	{
+		std::cerr << "Empty workload" << std::endl;
+		return 1;
+	}
+
+	U64 total = 0;
+	S32 largest = 0;
+	for (const Spec& spec : specs)
+	{
+		total += spec.mSize;
+		largest = llmax(largest, spec.mSize);
+	}
+	std::vector<U8> payload(largest, 0x5a);
+	std::vector<U8> buffer(largest);
+	U64 capacity = capacity_mb ? capacity_mb << 20 : llmax(total * 2, (U64)LLSlabStore::DEFAULT_SLAB_SIZE * 2);
+
+	fprintf(stdout, "Workload: %d textures, %.1f MB of bodies, slab arena %llu MB\n",
+			(S32)specs.size(), (F64)total / (1024.0 * 1024.0), (unsigned long long)(capacity >> 20));
+
+	std::string files_dir = gDirUtilp->add(dir, "texture_cache_replay_files");
+	report("files", "write", write_files(files_dir, specs, payload));
+	report("files", "cold read", read_files(files_dir, specs, buffer));
+	report("files", "warm read", read_files(files_dir, specs, buffer));
+	remove_files(files_dir);
+
+	std::string slab_name = "texture_cache_replay";
+	LLSlabStore::removeFiles(dir, slab_name);
+	{
+		LLSlabStore store;
+		if (!store.open(dir, slab_name, capacity))
+		{
+			std::cerr << "Unable to open the slab arena in " << dir << std::endl;
+			return 1;
+		}
+		report("slabs", "write", write_slabs(store, specs, payload));
+	}
+	{
+		// Cold: reopen the arena and load its index, as on viewer startup.
+		F64 start = LLTimer::getTotalSeconds();
+		LLSlabStore store;
+		store.open(dir, slab_name, capacity);
+		Result open_result = { LLTimer::getTotalSeconds() - start, 0, 1 };
+		report("slabs", "open", open_result);
+		report("slabs", "cold read", read_slabs(store, specs, buffer));
+		report("slabs", "warm read", read_slabs(store, specs, buffer));
+	}
+	LLSlabStore::removeFiles(dir, slab_name);
+
+	return 0;
+}
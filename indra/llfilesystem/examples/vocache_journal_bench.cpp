@@ -0,0 +1,325 @@
+/**
+ * @file vocache_journal_bench.cpp
+ * @brief Compares rewriting a region object cache file on every save with appending to an LLRecordJournal.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "lldir.h"
+#include "llfile.h"
+#include "llrand.h"
+#include "llrecordjournal.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+// LLVOCacheEntry::writeToBuffer() layout: local id, crc, hit count, dupe
+// count, crc change count and body size, then the body.
+static const S32 ENTRY_HEADER_SIZE = 6 * sizeof(S32);
+static const S32 MAX_ENTRY_BODY_SIZE = 10000;
+
+typedef std::map<U32, std::string> entry_map_t; // local id -> whole entry
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tvocache_journal_bench [options] [objects_X_Y.slc]\n"
+		"\n"
+		"Saves a region's object cache entries the way LLVOCache did before\n"
+		"(the whole file rewritten on every save) and as an LLRecordJournal\n"
+		"(only the changed entries appended), for several fractions of changed\n"
+		"entries, and times reading the region back both ways.  The entries\n"
+		"come from an object cache file of the old format or, without one,\n"
+		"from a synthetic region.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -d <dir>        Scratch directory.  Default:  system temp dir\n"
+		" -n <count>      Objects in the synthetic region.  Default:  15000\n"
+		" -r <count>      Saves per measurement.  Default:  20\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+static std::string make_entry(U32 local_id, U32 crc, S32 body_size)
+{
+	std::string entry(ENTRY_HEADER_SIZE + body_size, '\0');
+	S32 header[6] = { (S32)local_id, (S32)crc, 0, 0, 0, body_size };
+	memcpy(&entry[0], header, sizeof(header));
+	for (S32 i = 0; i < body_size; ++i)
+	{
+		entry[ENTRY_HEADER_SIZE + i] = (char)rand();
+	}
+	return entry;
+}
+
+// Object updates are mostly a few hundred bytes, with a tail of large
+// prims (long names, texture entries, extra params).
+static void make_region(S32 count, entry_map_t& entries)
+{
+	for (S32 i = 0; i < count; ++i)
+	{
+		S32 body_size = (i % 20) ? 120 + rand() % 400 : 600 + rand() % 2400;
+		U32 local_id = 100000 + i * 7;
+		entries[local_id] = make_entry(local_id, rand(), body_size);
+	}
+}
+
+// Old format: region id, entry count, then writeToBuffer() entries.
+static bool load_legacy(const std::string& filename, entry_map_t& entries)
+{
+	LLUniqueFile file = LLFile::fopen(filename, "rb");
+	U8 id[UUID_BYTES];
+	S32 count = 0;
+	if (!file || fread(id, UUID_BYTES, 1, file) != 1 || fread(&count, sizeof(S32), 1, file) != 1)
+	{
+		return false;
+	}
+	for (S32 i = 0; i < count; ++i)
+	{
+		S32 header[6];
+		if (fread(header, sizeof(header), 1, file) != 1 || header[5] < 1 || header[5] > MAX_ENTRY_BODY_SIZE)
+		{
+			break;
+		}
+		std::string entry(ENTRY_HEADER_SIZE + header[5], '\0');
+		memcpy(&entry[0], header, sizeof(header));
+		if (fread(&entry[ENTRY_HEADER_SIZE], header[5], 1, file) != 1)
+		{
+			break;
+		}
+		entries[(U32)header[0]] = entry;
+	}
+	return !entries.empty();
+}
+
+// LLVOCache::writeToCache() before journaling: the whole region, gathered in
+// a 32KB buffer.
+static bool write_legacy(const std::string& filename, const LLUUID& id, const entry_map_t& entries)
+{
+	LLUniqueFile file = LLFile::fopen(filename, "wb");
+	if (!file)
+	{
+		return false;
+	}
+	setvbuf(file, NULL, _IONBF, 0);
+	S32 count = entries.size();
+	bool success = fwrite(id.mData, UUID_BYTES, 1, file) == 1 && fwrite(&count, sizeof(S32), 1, file) == 1;
+	std::string buffer;
+	for (entry_map_t::const_iterator iter = entries.begin(); success && iter != entries.end(); ++iter)
+	{
+		buffer += iter->second;
+		if (buffer.size() > 32768 - (MAX_ENTRY_BODY_SIZE + ENTRY_HEADER_SIZE))
+		{
+			success = fwrite(buffer.data(), buffer.size(), 1, file) == 1;
+			buffer.clear();
+		}
+	}
+	return success && (buffer.empty() || fwrite(buffer.data(), buffer.size(), 1, file) == 1);
+}
+
+// LLVOCache::readFromCache() before journaling: unbuffered reads of each
+// entry header and body.
+static S32 read_legacy(const std::string& filename)
+{
+	LLUniqueFile file = LLFile::fopen(filename, "rb");
+	if (!file)
+	{
+		return 0;
+	}
+	setvbuf(file, NULL, _IONBF, 0);
+	U8 id[UUID_BYTES];
+	S32 count = 0;
+	if (fread(id, UUID_BYTES, 1, file) != 1 || fread(&count, sizeof(S32), 1, file) != 1)
+	{
+		return 0;
+	}
+	S32 read = 0;
+	std::vector<U8> body(MAX_ENTRY_BODY_SIZE);
+	for (; read < count; ++read)
+	{
+		S32 header[6];
+		if (fread(header, sizeof(header), 1, file) != 1 || header[5] < 1 || header[5] > MAX_ENTRY_BODY_SIZE
+			|| fread(&body[0], header[5], 1, file) != 1)
+		{
+			break;
+		}
+	}
+	return read;
+}
+
+static S32 read_journal(const std::string& filename, const LLUUID& id, LLRecordJournal::Stats& stats)
+{
+	S32 read = 0;
+	LLRecordJournal::read(filename, id, [&read](U32, const U8*, U32)
+	{
+		++read;
+		return true;
+	}, &stats);
+	return read;
+}
+
+static void run(const std::string& dir, const entry_map_t& region, F32 changed, S32 repeat)
+{
+	LLUUID id;
+	id.generate();
+	std::string legacy_name = gDirUtilp->add(dir, "vocache_bench_legacy.slc");
+	std::string journal_name = gDirUtilp->add(dir, "vocache_bench_journal.slc");
+	entry_map_t entries = region;
+
+	LLRecordJournal::Batch all;
+	for (entry_map_t::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+	{
+		all.add(iter->first, (const U8*)iter->second.data(), iter->second.size());
+	}
+	LLRecordJournal::rewrite(journal_name, id, all);
+	U32 records = entries.size();
+	S32 rewrites = 0;
+
+	F64 legacy_seconds = 0.0;
+	F64 journal_seconds = 0.0;
+	size_t legacy_bytes = 0;
+	size_t journal_bytes = 0;
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		// Change a fraction of the objects, as LLVOCacheEntry::updateEntry() does.
+		LLRecordJournal::Batch batch;
+		for (entry_map_t::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+		{
+			if (ll_frand() < changed)
+			{
+				iter->second = make_entry(iter->first, rand(), iter->second.size() - ENTRY_HEADER_SIZE);
+				batch.add(iter->first, (const U8*)iter->second.data(), iter->second.size());
+			}
+		}
+
+		F64 start = LLTimer::getTotalSeconds();
+		write_legacy(legacy_name, id, entries);
+		legacy_seconds += LLTimer::getTotalSeconds() - start;
+		legacy_bytes += all.getBytes();
+
+		start = LLTimer::getTotalSeconds();
+		records += batch.getRecordCount();
+		if (LLRecordJournal::needsCompaction(records, entries.size()))
+		{
+			LLRecordJournal::Batch current;
+			for (entry_map_t::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+			{
+				current.add(iter->first, (const U8*)iter->second.data(), iter->second.size());
+			}
+			LLRecordJournal::rewrite(journal_name, id, current);
+			records = entries.size();
+			journal_bytes += current.getBytes();
+			++rewrites;
+		}
+		else
+		{
+			LLRecordJournal::append(journal_name, id, batch);
+			journal_bytes += batch.getBytes();
+		}
+		journal_seconds += LLTimer::getTotalSeconds() - start;
+	}
+
+	F64 start = LLTimer::getTotalSeconds();
+	S32 legacy_read = read_legacy(legacy_name);
+	F64 legacy_read_seconds = LLTimer::getTotalSeconds() - start;
+
+	LLRecordJournal::Stats stats;
+	start = LLTimer::getTotalSeconds();
+	S32 journal_read = read_journal(journal_name, id, stats);
+	F64 journal_read_seconds = LLTimer::getTotalSeconds() - start;
+
+	fprintf(stdout, "%5.1f%% changed  save: legacy %8.3f ms %8.1f KB  journal %8.3f ms %8.1f KB %6.2fx (%d rewrites)\n",
+			changed * 100.f,
+			legacy_seconds * 1000.0 / repeat, legacy_bytes / 1024.0 / repeat,
+			journal_seconds * 1000.0 / repeat, journal_bytes / 1024.0 / repeat,
+			journal_seconds > 0.0 ? legacy_seconds / journal_seconds : 0.0, rewrites);
+	fprintf(stdout, "                load: legacy %8.3f ms (%d)  journal %8.3f ms (%d of %u records) %s\n",
+			legacy_read_seconds * 1000.0, legacy_read, journal_read_seconds * 1000.0, journal_read, stats.mRecords,
+			journal_read == legacy_read ? "" : "MISMATCH");
+
+	LLFile::remove(legacy_name);
+	LLFile::remove(journal_name);
+}
+
+int main(int argc, char** argv)
+{
+	std::string dir = LLFile::tmpdir();
+	std::string legacy_file;
+	S32 count = 15000;
+	S32 repeat = 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-d" && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg[0] != '-' && legacy_file.empty())
+		{
+			legacy_file = arg;
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	entry_map_t region;
+	srand(1);
+	if (!legacy_file.empty())
+	{
+		if (!load_legacy(legacy_file, region))
+		{
+			std::cerr << "Unable to read object cache entries from " << legacy_file << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		make_region(count, region);
+	}
+	fprintf(stdout, "%d objects\n", (S32)region.size());
+
+	static const F32 fractions[] = { 0.01f, 0.05f, 0.2f, 0.5f };
+	for (F32 changed : fractions)
+	{
+		run(dir, region, changed, repeat);
+	}
+	return 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file llasyncfilereader.cpp
+ * @brief Batched file range reads, on io_uring where there is one.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llasyncfilereader.h"
+
+
+#include "llevents.h"
+
+#if LL_LINUX && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LL_IO_URING 1
+#endif
+#endif
+
+#if LL_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if LL_IO_URING
+// Talks to io_uring through the raw system calls, so that there is no
+// liburing to ship. Reads are IORING_OP_READV, which every kernel with
+// io_uring (5.1) knows.
+class LLIOUring
+{
+	LOG_CLASS(LLIOUring);
+public:
+	LLIOUring() {}
+	~LLIOUring()
+	{
+		if (mSQEs)
+		{
+			munmap(mSQEs, mSQEsSize);
+		}
+		if (mCQRing && mCQRing != mSQRing)
+		{
+			munmap(mCQRing, mCQRingSize);
+		}
+		if (mSQRing)
+		{
+			munmap(mSQRing, mSQRingSize);
+		}
+		if (mFD >= 0)
+		{
+			::close(mFD);
+		}
+	}
+
+	bool init(U32 entries)
+	{
+		io_uring_params params = {};
+		mFD = (int)syscall(__NR_io_uring_setup, entries, &params);
+		if (mFD < 0)
+		{
+			// No io_uring in this kernel, or a sandbox forbids it
+			LL_INFOS() << "io_uring unavailable, errno: " << errno << LL_ENDL;
+			return false;
+		}
+
+		mSQRingSize = params.sq_off.array + params.sq_entries * sizeof(U32);
+		mCQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single_mmap)
+		{
+			mSQRingSize = mCQRingSize = llmax(mSQRingSize, mCQRingSize);
+		}
+		mSQRing = map(mSQRingSize, IORING_OFF_SQ_RING);
+		if (!mSQRing)
+		{
+			return false;
+		}
+		mCQRing = single_mmap ? mSQRing : map(mCQRingSize, IORING_OFF_CQ_RING);
+		mSQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+		mSQEs = (io_uring_sqe*)map(mSQEsSize, IORING_OFF_SQES);
+		if (!mCQRing || !mSQEs)
+		{
+			return false;
+		}
+
+		mSQHead = (U32*)(mSQRing + params.sq_off.head);
+		mSQTail = (U32*)(mSQRing + params.sq_off.tail);
+		mSQMask = *(U32*)(mSQRing + params.sq_off.ring_mask);
+		mSQArray = (U32*)(mSQRing + params.sq_off.array);
+		mCQHead = (U32*)(mCQRing + params.cq_off.head);
+		mCQTail = (U32*)(mCQRing + params.cq_off.tail);
+		mCQMask = *(U32*)(mCQRing + params.cq_off.ring_mask);
+		mCQEs = (io_uring_cqe*)(mCQRing + params.cq_off.cqes);
+		mEntries = params.sq_entries;
+		return true;
+	}
+
+	/**
+	 * Reads the ranges of fds into the buffers of requests, fds[i] < 0 is
+	 * skipped. results[i] is the bytes read or -errno.
+	 *
+	 * @return False when the ring stopped working, what has not been read
+	 *         then has a result of -ECANCELED.
+	 */
+	bool read(const std::vector<int>& fds, LLAsyncFileReader::request_list_t& requests, std::vector<S32>& results)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mFailed)
+		{
+			return false;
+		}
+
+		std::vector<iovec> iovecs(requests.size());
+		results.assign(requests.size(), -ECANCELED);
+		size_t next = 0;
+		while (next < requests.size())
+		{
+			// As many as fit in the submission queue
+			U32 queued = 0;
+			U32 tail = *mSQTail;
+			for (; next < requests.size() && queued < mEntries; ++next)
+			{
+				if (fds[next] < 0)
+				{
+					continue;
+				}
+				LLAsyncFileReader::Request& request = requests[next];
+				iovecs[next].iov_base = request.mBuffer;
+				iovecs[next].iov_len = request.mSize;
+
+				const U32 index = tail & mSQMask;
+				io_uring_sqe* sqe = &mSQEs[index];
+				memset(sqe, 0, sizeof(*sqe));
+				sqe->opcode = IORING_OP_READV;
+				sqe->fd = fds[next];
+				sqe->off = (U64)request.mOffset;
+				sqe->addr = (U64)(uintptr_t)&iovecs[next];
+				sqe->len = 1;
+				sqe->user_data = next;
+				mSQArray[index] = index;
+				++tail;
+				++queued;
+			}
+			__atomic_store_n(mSQTail, tail, __ATOMIC_RELEASE);
+
+			// One call submits them all and waits for all of them
+			U32 submitted = 0;
+			U32 completed = 0;
+			while (completed < queued)
+			{
+				int ret = (int)syscall(__NR_io_uring_enter, mFD, queued - submitted, queued - completed,
+									   IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (ret < 0)
+				{
+					if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+					{
+						completed += reap(results);
+						continue;
+					}
+					// Entries left in the ring are never submitted, what is
+					// in flight is waited for below
+					LL_WARNS() << "io_uring_enter failed, errno: " << errno << LL_ENDL;
+					mFailed = true;
+					break;
+				}
+				submitted += ret;
+				completed += reap(results);
+			}
+			if (mFailed)
+			{
+				while (completed < submitted)
+				{
+					completed += reap(results);
+				}
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	U8* map(size_t size, U64 offset)
+	{
+		void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFD, offset);
+		if (ptr == MAP_FAILED)
+		{
+			LL_WARNS() << "io_uring mmap failed, errno: " << errno << LL_ENDL;
+			return nullptr;
+		}
+		return (U8*)ptr;
+	}
+
+	U32 reap(std::vector<S32>& results)
+	{
+		U32 count = 0;
+		U32 head = *mCQHead;
+		const U32 tail = __atomic_load_n(mCQTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; ++head, ++count)
+		{
+			const io_uring_cqe& cqe = mCQEs[head & mCQMask];
+			results[cqe.user_data] = cqe.res;
+		}
+		__atomic_store_n(mCQHead, head, __ATOMIC_RELEASE);
+		return count;
+	}
+
+	std::mutex mMutex;
+	int mFD = -1;
+	bool mFailed = false;
+	U32 mEntries = 0;
+
+	U8* mSQRing = nullptr;
+	size_t mSQRingSize = 0;
+	U8* mCQRing = nullptr;
+	size_t mCQRingSize = 0;
+	io_uring_sqe* mSQEs = nullptr;
+	size_t mSQEsSize = 0;
+
+	U32* mSQHead = nullptr;
+	U32* mSQTail = nullptr;
+	U32 mSQMask = 0;
+	U32* mSQArray = nullptr;
+	U32* mCQHead = nullptr;
+	U32* mCQTail = nullptr;
+	U32 mCQMask = 0;
+	io_uring_cqe* mCQEs = nullptr;
+};
+#else
+class LLIOUring
+{
+};
+#endif // LL_IO_URING
+
+LLAsyncFileReader::LLAsyncFileReader(const std::string& name, LLFileHandleCache& handles, S32 threads, bool use_io_uring)
+:	mHandles(handles),
+	mPool(name, llmax(threads, 1), 1024 * 1024)
+{
+#if LL_IO_URING
+	if (use_io_uring)
+	{
+		mRing.reset(new LLIOUring);
+		if (!mRing->init(64))
+		{
+			mRing.reset();
+		}
+	}
+#endif
+	mPool.start();
+}
+
+LLAsyncFileReader::~LLAsyncFileReader()
+{
+	close();
+}
+
+void LLAsyncFileReader::close()
+{
+	mPool.close();
+	// The pool listens for application shutdown under its name; it may be
+	// going away before the application does.
+	if (LLEventPumps::instanceExists())
+	{
+		LLEventPumps::instance().obtain("LLApp").stopListening(mPool.getName());
+	}
+}
+
+void LLAsyncFileReader::readRange(Request& request)
+{
+	LLFileHandleCache::handle_ptr_t handle = mHandles.get(request.mFilename, false);
+	request.mBytesRead = handle ? handle->read(request.mBuffer, request.mSize, request.mOffset) : -1;
+}
+
+void LLAsyncFileReader::read(request_list_t& requests)
+{
+	if (requests.empty())
+	{
+		return;
+	}
+
+#if LL_IO_URING
+	if (mRing)
+	{
+		// The handles stay open until the kernel is done with them
+		std::vector<LLFileHandleCache::handle_ptr_t> handles(requests.size());
+		std::vector<int> fds(requests.size(), -1);
+		for (size_t i = 0; i < requests.size(); ++i)
+		{
+			handles[i] = mHandles.get(requests[i].mFilename, false);
+			if (handles[i])
+			{
+				fds[i] = handles[i]->getFD();
+			}
+		}
+
+		std::vector<S32> results;
+		mRing->read(fds, requests, results);
+		for (size_t i = 0; i < requests.size(); ++i)
+		{
+			Request& request = requests[i];
+			if (!handles[i])
+			{
+				request.mBytesRead = -1;
+			}
+			else if (results[i] == -ECANCELED)
+			{
+				request.mBytesRead = handles[i]->read(request.mBuffer, request.mSize, request.mOffset);
+			}
+			else if (results[i] < 0)
+			{
+				request.mBytesRead = -1;
+			}
+			else if (results[i] > 0 && results[i] < request.mSize)
+			{
+				// Short, but not necessarily at the end of the file
+				S32 rest = handles[i]->read(request.mBuffer + results[i], request.mSize - results[i],
+											request.mOffset + results[i]);
+				request.mBytesRead = results[i] + llmax(rest, 0);
+			}
+			else
+			{
+				request.mBytesRead = results[i];
+			}
+		}
+		return;
+	}
+#endif
+
+	// Waking a worker for every batch costs more than the preads of a batch
+	// of cached files take; only readAsync() spreads them over the pool
+	for (Request& request : requests)
+	{
+		readRange(request);
+	}
+}
+
+bool LLAsyncFileReader::readAsync(const request_list_ptr_t& requests, const callback_t& callback)
+{
+	// A batch is a job: one worker keeps a whole batch in flight on
+	// io_uring, with pread() batches spread over the workers
+	return mPool.getQueue().postIfOpen([this, requests, callback]()
+		{
+			read(*requests);
+			callback(requests);
+		});
+}
@@ -0,0 +1,107 @@
+/**
+ * @file llasyncfilereader.h
+ * @brief Batched file range reads, on io_uring where there is one.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLASYNCFILEREADER_H
+#define LL_LLASYNCFILEREADER_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "llfilehandlecache.h"
+#include "threadpool.h"
+
+class LLIOUring;
+
+/**
+ * @brief Reads batches of file ranges at once.
+ *
+ * On Linux a batch goes to the kernel through io_uring, one system call for
+ * all of its reads. Where io_uring is missing or not allowed the ranges are
+ * read with pread(), by the calling thread in read() and by a small thread
+ * pool, a batch per worker, in readAsync(). Files are opened
+ * through an LLFileHandleCache, so reading more ranges of a file later does
+ * not open it again. Thread safe.
+ */
+class LLAsyncFileReader
+{
+	LOG_CLASS(LLAsyncFileReader);
+public:
+	struct Request
+	{
+		std::string mFilename;
+		S64 mOffset = 0;
+		S32 mSize = 0;
+		U8* mBuffer = nullptr;
+		// Bytes read, short at the end of the file, -1 when the file could
+		// not be opened or read
+		S32 mBytesRead = 0;
+	};
+	typedef std::vector<Request> request_list_t;
+	typedef std::shared_ptr<request_list_t> request_list_ptr_t;
+	typedef std::function<void(const request_list_ptr_t&)> callback_t;
+
+	/**
+	 * @param[in] name Name of the thread pool, must be unique.
+	 * @param[in] handles Where files are opened, must outlive the reader.
+	 * @param[in] threads Workers of the thread pool.
+	 * @param[in] use_io_uring Try io_uring first.
+	 */
+	LLAsyncFileReader(const std::string& name, LLFileHandleCache& handles, S32 threads, bool use_io_uring = true);
+	~LLAsyncFileReader();
+
+	/**
+	 * Finishes the batches already posted and stops the workers.
+	 */
+	void close();
+
+	/**
+	 * Reads all ranges of a batch and returns when they are done.
+	 */
+	void read(request_list_t& requests);
+
+	/**
+	 * Reads a batch on the workers and hands it to callback, on a worker
+	 * thread, when all of its ranges are done. The buffers must stay valid
+	 * until then.
+	 *
+	 * @return False when the reader is closed, callback is never called.
+	 */
+	bool readAsync(const request_list_ptr_t& requests, const callback_t& callback);
+
+	bool usesIOUring() const { return mRing != nullptr; }
+
+private:
+	void readRange(Request& request);
+
+	LLFileHandleCache& mHandles;
+	std::unique_ptr<LLIOUring> mRing;
+	LL::ThreadPool mPool;
+};
+
+#endif // LL_LLASYNCFILEREADER_H
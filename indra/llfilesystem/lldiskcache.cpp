@@ -65,6 +65,16 @@ LLDiskCache::LLDiskCache(const std::string cache_dir,
         LLFile::mkdir(dirname);
     }
     // </FS:Ansariel>
+    // <FS:Kadah> Disk cache index
+    auto start_time = std::chrono::high_resolution_clock::now();
+    if (!mIndex.open(cache_dir + gDirUtilp->getDirDelimiter() + INDEX_FILENAME))
+    {
+        rebuildIndex();
+    }
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+    LL_INFOS("LLDiskCache") << "Indexed " << mIndex.getEntryCount() << " files, " << mIndex.getTotalSize()
+                            << " bytes, in " << execute_time << " ms" << LL_ENDL;
+    // </FS:Kadah>
     // <FS:Beq> add static assets into the new cache after clear.
     // Only missing entries are copied on init, skiplist is setup
     // For everything we populate FS specific assets to allow future updates
@@ -72,6 +82,33 @@ LLDiskCache::LLDiskCache(const std::string cache_dir,
     // </FS:Beq>
 }
 
+// <FS:Kadah> Disk cache index
+LLDiskCache::~LLDiskCache()
+{
+    // <FS:Kadah> Open file handles
+    if (mFileReader)
+    {
+        mFileReader->close();
+    }
+    mFileHandles.clear();
+    // </FS:Kadah>
+    mIndex.close();
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Open file handles
+LLAsyncFileReader& LLDiskCache::getFileReader()
+{
+    std::lock_guard<std::mutex> lock(mFileReaderMutex);
+    if (!mFileReader)
+    {
+        mFileReader.reset(new LLAsyncFileReader("AssetFileReader", mFileHandles, 2));
+        LL_INFOS("LLDiskCache") << "Batched reads on " << (mFileReader->usesIOUring() ? "io_uring" : "worker threads") << LL_ENDL;
+    }
+    return *mFileReader;
+}
+// </FS:Kadah>
+
 // WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
 // NOT touch any LLDiskCache data without introducing and locking a mutex!
 
@@ -102,237 +139,333 @@ LLDiskCache::LLDiskCache(const std::string cache_dir,
 // asset will have to be re-requested.
 void LLDiskCache::purge()
 {
-    if (mEnableCacheDebugInfo)
+// <FS:Kadah> Purge from the index instead of scanning the directory
+//    if (mEnableCacheDebugInfo)
+//    {
+//        LL_INFOS() << "Total dir size before purge is " << dirFileSize(mCacheDir) << LL_ENDL;
+//    }
+//
+//    boost::system::error_code ec;
+//    auto start_time = std::chrono::high_resolution_clock::now();
+//
+//    typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
+//    std::vector<file_info_t> file_info;
+//
+//#if LL_WINDOWS
+//    std::wstring cache_path(utf8str_to_utf16str(mCacheDir));
+//#else
+//    std::string cache_path(mCacheDir);
+//#endif
+//    uintmax_t file_size_total = 0; // <FS:Beq/> try to make simple cache less naive.
+//
+//    if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
+//    {
+//        // <FS:Ansariel> Optimize asset simple disk cache
+//        //boost::filesystem::directory_iterator iter(cache_path, ec);
+//        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
+//        boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
+//        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
+//        // </FS:Ansariel>
+//        {
+//            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
+//            {
+//                if ((*iter).path().string().find(mCacheFilenamePrefix) != std::string::npos)
+//                {
+//                    uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
+//                    if (ec.failed())
+//                    {
+//                        continue;
+//                    }
+//                    const std::string file_path = (*iter).path().string();
+//                    const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
+//                    if (ec.failed())
+//                    {
+//                        continue;
+//                    }
+//                    file_size_total += file_size; // <FS:Beq/> try to make simple cache less naive.
+//
+//                    file_info.push_back(file_info_t(file_time, { file_size, file_path }));
+//                }
+//            }
+//            iter.increment(ec);
+//        }
+//    }
+//
+//    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
+//    LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
+//    if( file_size_total < mMaxSizeBytes * (mHighPercent/100) )
+//    {
+//        // Nothing to do here 
+//        LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
+//        return;
+//    }
+//    // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
+//    // </FS:Beq>
+//    std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
+//    {
+//        return x.first < y.first; // <FS:Beq/> sort oldest to newest, to we can remove the oldest files first.
+//    });
+//
+//
+//    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
+//    auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
+//    LL_INFOS() << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
+//    // </FS:Beq>
+//
+//    // <FS:Beq> Extra accounting to track the retention of static assets
+//    //std::vector<bool> file_removed;
+//    enum class purge_action { delete_file=0, keep_file, skip_file };
+//    std::map<std::string,purge_action> file_removed;
+//    auto keep{file_info.size()};
+//    auto del{0};
+//    auto skip{0};
+//    // </FS:Beq>
+//    // <FS:Beq> revised purge logic to track amount removed not retained to shortern loop
+//    // uintmax_t file_size_total = 0;
+//    // if (mEnableCacheDebugInfo)
+//    // {
+//    //     file_removed.reserve(file_info.size());
+//    // }
+//    // uintmax_t file_size_total = 0;
+//    // for (file_info_t& entry : file_info)
+//    // {
+//    //     file_size_total += entry.second.first;
+//
+//    //     bool should_remove = file_size_total > mMaxSizeBytes;
+//    //     // <FS> Make sure static assets are not eliminated
+//    //     S32 action{ should_remove ? 0 : 1 };
+//    //     if (should_remove)
+//    //     {
+//    //         auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
+//    //         uuid_as_string = uuid_as_string.substr(mCacheFilenamePrefix.size() + 1, 36);// skip "sl_cache_" and trailing "_N"
+//    //         // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
+//    //         if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
+//    //         {
+//    //             // this is one of our protected items so no purging
+//    //             should_remove = false;
+//    //             action = 2;
+//    //             updateFileAccessTime(entry.second.second); // force these to the front of the list next time so that purge size works 
+//    //         }
+//    //     }
+//    //     // </FS>
+//    //     if (mEnableCacheDebugInfo)
+//    //     {
+//    //         // <FS> Static asset stuff
+//    //         //file_removed.push_back(should_remove);
+//    //         file_removed.push_back(action);
+//    //     }
+//    uintmax_t deleted_size_total = 0;
+//    for (file_info_t& entry : file_info)
+//    {
+//        // first check if we still need to delete more files
+//        bool should_remove = (file_size_total - deleted_size_total) > target_size;
+//
+//        // <FS> Make sure static assets are not eliminated
+//        auto action{ should_remove ? purge_action::delete_file : purge_action::keep_file };
+//        if (!should_remove)
+//        {
+//            break;
+//        }
+//
+//        auto this_file_size = entry.second.first;
+//        deleted_size_total += this_file_size;
+//        auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
+//        uuid_as_string = uuid_as_string.substr(mCacheFilenamePrefix.size() + 1, 36);// skip "sl_cache_" and trailing "_N"
+//        // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
+//        if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
+//        {
+//            // this is one of our protected items so no purging
+//            should_remove = false;
+//            action = purge_action::skip_file;
+//            updateFileAccessTime(entry.second.second); // force these to the front of the list next time so that purge size works 
+//            skip++;
+//        }
+//        else{
+//            del++;
+//        }
+//        keep--;
+//        if (mEnableCacheDebugInfo)
+//        {
+//        // <FS> Static asset stuff
+//        //file_removed.push_back(should_remove);
+//            file_removed.emplace(entry.second.second, action);
+//        }
+//        // </FS>
+//        if (should_remove)
+//        {
+//            boost::filesystem::remove(entry.second.second, ec);
+//            if (ec.failed())
+//            {
+//                LL_WARNS() << "Failed to delete cache file " << entry.second.second << ": " << ec.message() << LL_ENDL;
+//            }
+//        }
+//    }
+//// <FS:Beq> update the debug logging to be more useful
+//    auto end_time = std::chrono::high_resolution_clock::now();
+//    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+//// </FS:Beq>
+//    if (mEnableCacheDebugInfo)
+//    {
+//        // <FS:Beq> update the debug logging to be more useful
+//        // auto end_time = std::chrono::high_resolution_clock::now();
+//        // auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+//        // </FS:Beq>
+//
+//        // Log afterward so it doesn't affect the time measurement
+//        // Logging thousands of file results can take hundreds of milliseconds
+//        auto deleted_so_far = 0; // <FS:Beq/> update the debug logging to be more useful
+//        for (size_t i = 0; i < file_info.size(); ++i)
+//        {
+//            const file_info_t& entry = file_info[i];
+//            // <FS> Static asset stuff
+//            deleted_so_far += entry.second.first; // <FS:Beq/> update the debug logging to be more useful
+//            //const bool removed = file_removed[i];
+//            //const std::string action = removed ? "DELETE:" : "KEEP:";
+//            std::string action{};
+//
+//            // Check if the file exists in the map
+//            auto& filename{ entry.second.second };
+//            if (file_removed.find(filename) != file_removed.end()) {
+//            // File found in the map, retrieve the corresponding enum value
+//            switch (file_removed[filename]) {
+//                case purge_action::delete_file:
+//                    action = "DELETE";
+//                    del++;
+//                break;
+//                case purge_action::skip_file:
+//                    action = "STATIC";
+//                    skip++;
+//                break;
+//                default:
+//                // Handle any unexpected enum value
+//                    action = "UNKNOWN";
+//                break;
+//            }
+//            }
+//            else 
+//            {
+//                action = "KEEP";
+//            }            
+//            // </FS>
+//
+//            // have to do this because of LL_INFO/LL_END weirdness
+//            std::ostringstream line;
+//
+//            line << action << "  ";
+//            line << entry.first << "  ";
+//            line << entry.second.first << "  ";
+//            line << entry.second.second;
+//            line << " (" << file_size_total - deleted_so_far << "/" << mMaxSizeBytes << ")"; // <FS:Beq/> update the debug logging to be more useful
+//            LL_INFOS() << line.str() << LL_ENDL;
+//        }
+//// <FS:Beq> make the summary stats more easily enabled.
+//    }
+//    // <FS:Beq> update the debug logging to be more useful
+//        // LL_INFOS() << "Total dir size after purge is " << dirFileSize(mCacheDir) << LL_ENDL;
+//        // LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
+//
+//    auto newCacheSize = updateCacheSize(file_size_total - deleted_size_total); 
+//    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << newCacheSize << LL_ENDL; 
+//    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
+//// </FS:Beq>
+//    LL_INFOS("LLDiskCache") << "Deleted: " << del << " Skipped: " << skip << " Kept: " << keep << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
+//    LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
+//    // } <FS:Beq/> this bracket was moved up a few lines.
+    // The viewer that owns the index purges for everyone sharing the cache
+    if (mIndex.isReadOnly())
     {
-        LL_INFOS() << "Total dir size before purge is " << dirFileSize(mCacheDir) << LL_ENDL;
+        return;
     }
 
-    boost::system::error_code ec;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
-    std::vector<file_info_t> file_info;
-
-#if LL_WINDOWS
-    std::wstring cache_path(utf8str_to_utf16str(mCacheDir));
-#else
-    std::string cache_path(mCacheDir);
-#endif
-    uintmax_t file_size_total = 0; // <FS:Beq/> try to make simple cache less naive.
-    
-    if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
-    {
-        // <FS:Ansariel> Optimize asset simple disk cache
-        //boost::filesystem::directory_iterator iter(cache_path, ec);
-        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
-        boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
-        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
-        // </FS:Ansariel>
-        {
-            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
-            {
-                if ((*iter).path().string().find(mCacheFilenamePrefix) != std::string::npos)
-                {
-                    uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
-                    if (ec.failed())
-                    {
-                        continue;
-                    }
-                    const std::string file_path = (*iter).path().string();
-                    const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
-                    if (ec.failed())
-                    {
-                        continue;
-                    }
-                    file_size_total += file_size; // <FS:Beq/> try to make simple cache less naive.
-
-                    file_info.push_back(file_info_t(file_time, { file_size, file_path }));
-                }
-            }
-            iter.increment(ec);
-        }
-    }
-
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
+    // The index is up to date, below the high water mark there is nothing to
+    // do but write down the accesses since the last purge
+    const uintmax_t file_size_total = mIndex.getTotalSize();
     LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
-    if( file_size_total < mMaxSizeBytes * (mHighPercent/100) )
+    if (file_size_total < mMaxSizeBytes * (mHighPercent/100))
     {
-        // Nothing to do here 
         LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
+        mIndex.flush();
         return;
     }
-    // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
-    // </FS:Beq>
-    std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
-    {
-        return x.first < y.first; // <FS:Beq/> sort oldest to newest, to we can remove the oldest files first.
-    });
-
 
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
     auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
     LL_INFOS() << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
-    // </FS:Beq>
 
-    // <FS:Beq> Extra accounting to track the retention of static assets
-    //std::vector<bool> file_removed;
-    enum class purge_action { delete_file=0, keep_file, skip_file };
-    std::map<std::string,purge_action> file_removed;
-    auto keep{file_info.size()};
-    auto del{0};
-    auto skip{0};
-    // </FS:Beq>
-    // <FS:Beq> revised purge logic to track amount removed not retained to shortern loop
-    // uintmax_t file_size_total = 0;
-    // if (mEnableCacheDebugInfo)
-    // {
-    //     file_removed.reserve(file_info.size());
-    // }
-    // uintmax_t file_size_total = 0;
-    // for (file_info_t& entry : file_info)
-    // {
-    //     file_size_total += entry.second.first;
-
-    //     bool should_remove = file_size_total > mMaxSizeBytes;
-    //     // <FS> Make sure static assets are not eliminated
-    //     S32 action{ should_remove ? 0 : 1 };
-    //     if (should_remove)
-    //     {
-    //         auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
-    //         uuid_as_string = uuid_as_string.substr(mCacheFilenamePrefix.size() + 1, 36);// skip "sl_cache_" and trailing "_N"
-    //         // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
-    //         if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
-    //         {
-    //             // this is one of our protected items so no purging
-    //             should_remove = false;
-    //             action = 2;
-    //             updateFileAccessTime(entry.second.second); // force these to the front of the list next time so that purge size works 
-    //         }
-    //     }
-    //     // </FS>
-    //     if (mEnableCacheDebugInfo)
-    //     {
-    //         // <FS> Static asset stuff
-    //         //file_removed.push_back(should_remove);
-    //         file_removed.push_back(action);
-    //     }
+    // Static assets are never picked
+    LLDiskCacheIndex::entry_list_t evicted;
+    mIndex.evict(target_size, evicted);
+
+    boost::system::error_code ec;
     uintmax_t deleted_size_total = 0;
-    for (file_info_t& entry : file_info)
+    for (const LLDiskCacheIndex::Entry& entry : evicted)
     {
-        // first check if we still need to delete more files
-        bool should_remove = (file_size_total - deleted_size_total) > target_size;
-
-        // <FS> Make sure static assets are not eliminated
-        auto action{ should_remove ? purge_action::delete_file : purge_action::keep_file };
-        if (!should_remove)
+        const std::string file_path = mCacheDir + gDirUtilp->getDirDelimiter() + entry.mName;
+        mFileHandles.close(file_path); // <FS:Kadah/> Open file handles
+#if LL_WINDOWS
+        boost::filesystem::remove(utf8str_to_utf16str(file_path), ec);
+#else
+        boost::filesystem::remove(file_path, ec);
+#endif
+        if (ec.failed())
         {
-            break;
+            // Still there, back in the index so that a later purge retries
+            LL_WARNS() << "Failed to delete cache file " << file_path << ": " << ec.message() << LL_ENDL;
+            mIndex.update(entry.mName, entry.mSize, entry.mAccessTime);
+            continue;
         }
+        deleted_size_total += entry.mSize;
 
-        auto this_file_size = entry.second.first;
-        deleted_size_total += this_file_size;
-        auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
-        uuid_as_string = uuid_as_string.substr(mCacheFilenamePrefix.size() + 1, 36);// skip "sl_cache_" and trailing "_N"
-        // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
-        if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
-        {
-            // this is one of our protected items so no purging
-            should_remove = false;
-            action = purge_action::skip_file;
-            updateFileAccessTime(entry.second.second); // force these to the front of the list next time so that purge size works 
-            skip++;
-        }
-        else{
-            del++;
-        }
-        keep--;
-        if (mEnableCacheDebugInfo)
+        // A writer may have re-created the file since evict(), putting its
+        // entry back. If the unlink above took the new file with it, or the
+        // writer still had it open, that entry stands for nothing on disk.
+        LLDiskCacheIndex::Entry current;
+        if (mIndex.getEntry(entry.mName, current) && current.mAccessTime >= entry.mAccessTime)
         {
-        // <FS> Static asset stuff
-        //file_removed.push_back(should_remove);
-            file_removed.emplace(entry.second.second, action);
-        }
-        // </FS>
-        if (should_remove)
-        {
-            boost::filesystem::remove(entry.second.second, ec);
-            if (ec.failed())
+#if LL_WINDOWS
+            const bool recreated = boost::filesystem::exists(utf8str_to_utf16str(file_path), ec);
+#else
+            const bool recreated = boost::filesystem::exists(file_path, ec);
+#endif
+            if (!recreated)
             {
-                LL_WARNS() << "Failed to delete cache file " << entry.second.second << ": " << ec.message() << LL_ENDL;
+                removeFileEntry(file_path);
             }
         }
     }
-// <FS:Beq> update the debug logging to be more useful
+    mIndex.flush();
+
     auto end_time = std::chrono::high_resolution_clock::now();
     auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-// </FS:Beq>
+
     if (mEnableCacheDebugInfo)
     {
-        // <FS:Beq> update the debug logging to be more useful
-        // auto end_time = std::chrono::high_resolution_clock::now();
-        // auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-        // </FS:Beq>
-
         // Log afterward so it doesn't affect the time measurement
         // Logging thousands of file results can take hundreds of milliseconds
-        auto deleted_so_far = 0; // <FS:Beq/> update the debug logging to be more useful
-        for (size_t i = 0; i < file_info.size(); ++i)
+        uintmax_t deleted_so_far = 0;
+        for (const LLDiskCacheIndex::Entry& entry : evicted)
         {
-            const file_info_t& entry = file_info[i];
-            // <FS> Static asset stuff
-            deleted_so_far += entry.second.first; // <FS:Beq/> update the debug logging to be more useful
-            //const bool removed = file_removed[i];
-            //const std::string action = removed ? "DELETE:" : "KEEP:";
-            std::string action{};
-
-            // Check if the file exists in the map
-            auto& filename{ entry.second.second };
-            if (file_removed.find(filename) != file_removed.end()) {
-            // File found in the map, retrieve the corresponding enum value
-            switch (file_removed[filename]) {
-                case purge_action::delete_file:
-                    action = "DELETE";
-                    del++;
-                break;
-                case purge_action::skip_file:
-                    action = "STATIC";
-                    skip++;
-                break;
-                default:
-                // Handle any unexpected enum value
-                    action = "UNKNOWN";
-                break;
-            }
-            }
-            else 
-            {
-                action = "KEEP";
-            }            
-            // </FS>
+            deleted_so_far += entry.mSize;
 
             // have to do this because of LL_INFO/LL_END weirdness
             std::ostringstream line;
 
-            line << action << "  ";
-            line << entry.first << "  ";
-            line << entry.second.first << "  ";
-            line << entry.second.second;
-            line << " (" << file_size_total - deleted_so_far << "/" << mMaxSizeBytes << ")"; // <FS:Beq/> update the debug logging to be more useful
+            line << "DELETE  ";
+            line << entry.mAccessTime << "  ";
+            line << entry.mSize << "  ";
+            line << entry.mName;
+            line << " (" << file_size_total - deleted_so_far << "/" << mMaxSizeBytes << ")";
             LL_INFOS() << line.str() << LL_ENDL;
         }
-// <FS:Beq> make the summary stats more easily enabled.
     }
-    // <FS:Beq> update the debug logging to be more useful
-        // LL_INFOS() << "Total dir size after purge is " << dirFileSize(mCacheDir) << LL_ENDL;
-        // LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
 
-    auto newCacheSize = updateCacheSize(file_size_total - deleted_size_total); 
-    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << newCacheSize << LL_ENDL; 
-    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
-// </FS:Beq>
-    LL_INFOS("LLDiskCache") << "Deleted: " << del << " Skipped: " << skip << " Kept: " << keep << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
-    LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
-    // } <FS:Beq/> this bracket was moved up a few lines.
+    const U32 kept = mIndex.getEntryCount();
+    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << mIndex.getTotalSize() << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << kept + evicted.size() << " files" << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Deleted: " << evicted.size() << " Skipped: " << mIndex.getStaticCount() << " Kept: " << kept << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;
+// </FS:Kadah>
 }
 
 const std::string LLDiskCache::assetTypeToString(LLAssetType::EType at)
@@ -419,71 +552,168 @@ const std::string LLDiskCache::metaDataToFilepath(const std::string& id,
 void LLDiskCache::updateFileAccessTime(const std::string& file_path)
 // </FS:Ansariel>
 {
-    /**
-     * Threshold in time_t units that is used to decide if the last access time
-     * time of the file is updated or not. Added as a precaution for the concern
-     * outlined in SL-14582  about frequent writes on older SSDs reducing their
-     * lifespan. I think this is the right place for the threshold value - rather
-     * than it being a pref - do comment on that Jira if you disagree...
-     *
-     * Let's start with 1 hour in time_t units and see how that unfolds
-     */
-    const std::time_t time_threshold = 1 * 60 * 60;
-
-    // current time
-    const std::time_t cur_time = std::time(nullptr);
-
-    boost::system::error_code ec;
-#if LL_WINDOWS
-    // file last write time
-    const std::time_t last_write_time = boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), ec);
-    if (ec.failed())
+    // <FS:Kadah> Disk cache index
+    // Kept in the index rather than the file time, the purge thread writes
+    // the accesses down in one go
+//    /**
+//     * Threshold in time_t units that is used to decide if the last access time
+//     * time of the file is updated or not. Added as a precaution for the concern
+//     * outlined in SL-14582  about frequent writes on older SSDs reducing their
+//     * lifespan. I think this is the right place for the threshold value - rather
+//     * than it being a pref - do comment on that Jira if you disagree...
+//     *
+//     * Let's start with 1 hour in time_t units and see how that unfolds
+//     */
+//    const std::time_t time_threshold = 1 * 60 * 60;
+//
+//    // current time
+//    const std::time_t cur_time = std::time(nullptr);
+//
+//    boost::system::error_code ec;
+//#if LL_WINDOWS
+//    // file last write time
+//    const std::time_t last_write_time = boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), ec);
+//    if (ec.failed())
+//    {
+//        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
+//        return;
+//    }
+//
+//    // delta between cur time and last time the file was written
+//    const std::time_t delta_time = cur_time - last_write_time;
+//
+//    // we only write the new value if the time in time_threshold has elapsed
+//    // before the last one
+//    if (delta_time > time_threshold)
+//    {
+//        boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), cur_time, ec);
+//    }
+//#else
+//    // file last write time
+//    const std::time_t last_write_time = boost::filesystem::last_write_time(file_path, ec);
+//    if (ec.failed())
+//    {
+//        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
+//        return;
+//    }
+//
+//    // delta between cur time and last time the file was written
+//    const std::time_t delta_time = cur_time - last_write_time;
+//
+//    // we only write the new value if the time in time_threshold has elapsed
+//    // before the last one
+//    if (delta_time > time_threshold)
+//    {
+//        boost::filesystem::last_write_time(file_path, cur_time, ec);
+//    }
+//#endif
+//
+//    if (ec.failed())
+//    {
+//        LL_WARNS() << "Failed to update last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
+//    }
+    const std::string name = getIndexName(file_path);
+    if (!name.empty())
     {
-        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
-        return;
+        mIndex.touch(name, std::time(nullptr));
     }
+    // </FS:Kadah>
+}
 
-    // delta between cur time and last time the file was written
-    const std::time_t delta_time = cur_time - last_write_time;
-
-    // we only write the new value if the time in time_threshold has elapsed
-    // before the last one
-    if (delta_time > time_threshold)
+// <FS:Kadah> Disk cache index
+void LLDiskCache::updateFileSize(const std::string& file_path, uintmax_t size)
+{
+    const std::string name = getIndexName(file_path);
+    if (!name.empty())
     {
-        boost::filesystem::last_write_time(utf8str_to_utf16str(file_path), cur_time, ec);
+        mIndex.update(name, size, std::time(nullptr));
     }
-#else
-    // file last write time
-    const std::time_t last_write_time = boost::filesystem::last_write_time(file_path, ec);
-    if (ec.failed())
+}
+
+void LLDiskCache::removeFileEntry(const std::string& file_path)
+{
+    mFileHandles.close(file_path);
+    const std::string name = getIndexName(file_path);
+    if (!name.empty())
     {
-        LL_WARNS() << "Failed to read last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
-        return;
+        mIndex.remove(name);
     }
+}
 
-    // delta between cur time and last time the file was written
-    const std::time_t delta_time = cur_time - last_write_time;
+void LLDiskCache::renameFileEntry(const std::string& old_path, const std::string& new_path)
+{
+    mFileHandles.close(old_path);
+    mFileHandles.close(new_path);
+    const std::string old_name = getIndexName(old_path);
+    const std::string new_name = getIndexName(new_path);
+    if (!old_name.empty() && !new_name.empty())
+    {
+        mIndex.rename(old_name, new_name);
+    }
+}
 
-    // we only write the new value if the time in time_threshold has elapsed
-    // before the last one
-    if (delta_time > time_threshold)
+std::string LLDiskCache::getIndexName(const std::string& file_path) const
+{
+    const size_t prefix_length = mCacheDir.size() + gDirUtilp->getDirDelimiter().size();
+    if (file_path.size() > prefix_length && file_path.compare(0, mCacheDir.size(), mCacheDir) == 0)
     {
-        boost::filesystem::last_write_time(file_path, cur_time, ec);
+        return file_path.substr(prefix_length);
     }
-#endif
+    return std::string();
+}
 
-    if (ec.failed())
+void LLDiskCache::rebuildIndex()
+{
+    LLDiskCacheIndex::entry_list_t entries;
+
+    boost::system::error_code ec;
+#if LL_WINDOWS
+    std::wstring cache_path(utf8str_to_utf16str(mCacheDir));
+#else
+    std::string cache_path(mCacheDir);
+#endif
+    if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
     {
-        LL_WARNS() << "Failed to update last write time for cache file " << file_path << ": " << ec.message() << LL_ENDL;
+        boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
+        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
+        {
+            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
+            {
+                const std::string file_path = (*iter).path().string();
+                if (file_path.find(mCacheFilenamePrefix) != std::string::npos)
+                {
+                    LLDiskCacheIndex::Entry entry;
+                    entry.mName = getIndexName(file_path);
+                    entry.mSize = boost::filesystem::file_size(*iter, ec);
+                    if (!ec.failed())
+                    {
+                        entry.mAccessTime = boost::filesystem::last_write_time(*iter, ec);
+                    }
+                    if (!ec.failed() && !entry.mName.empty())
+                    {
+                        entries.push_back(entry);
+                    }
+                }
+            }
+            iter.increment(ec);
+        }
     }
+
+    LL_INFOS("LLDiskCache") << "Rebuilt the cache index from " << entries.size() << " files" << LL_ENDL;
+    mIndex.rebuild(entries);
+    mIndex.flush();
 }
+// </FS:Kadah>
 
 const std::string LLDiskCache::getCacheInfo()
 {
     std::ostringstream cache_info;
 
     F32 max_in_mb = (F32)mMaxSizeBytes / (1024.0 * 1024.0);
-    F32 percent_used = ((F32)dirFileSize(mCacheDir) / (F32)mMaxSizeBytes) * 100.0;
+    // <FS:Kadah> Disk cache index
+    //F32 percent_used = ((F32)dirFileSize(mCacheDir) / (F32)mMaxSizeBytes) * 100.0;
+    F32 percent_used = ((F32)mIndex.getTotalSize() / (F32)mMaxSizeBytes) * 100.0;
+    // </FS:Kadah>
 
     cache_info << std::fixed;
     cache_info << std::setprecision(1);
@@ -526,7 +756,18 @@ void LLDiskCache::prepopulateCacheWithStatic()
                     {
                         LL_WARNS("LLDiskCache") << "Failed to copy " << from_asset_file << " to " << to_asset_file << LL_ENDL;
                     }
+                    // <FS:Kadah> Disk cache index
+                    else
+                    {
+                        llstat file_stat;
+                        if (LLFile::stat(to_asset_file, &file_stat) == 0)
+                        {
+                            updateFileSize(to_asset_file, file_stat.st_size);
+                        }
+                    }
+                    // </FS:Kadah>
                 }
+                mIndex.setFlags(getIndexName(to_asset_file), LLDiskCacheIndex::FLAG_STATIC); // <FS:Kadah/> Disk cache index
                 if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) == mSkipList.end())
                 {
                     if (mEnableCacheDebugInfo)
@@ -543,6 +784,13 @@ void LLDiskCache::prepopulateCacheWithStatic()
 
 void LLDiskCache::clearCache()
 {
+    // <FS:Kadah> Disk cache index
+    if (mIndex.isReadOnly())
+    {
+        LL_WARNS() << "Not clearing cache " << mCacheDir << ", it is in use by another viewer" << LL_ENDL;
+        return;
+    }
+    // </FS:Kadah>
     LL_INFOS() << "clearing cache " << mCacheDir << LL_ENDL;
     /**
      * See notes on performance in dirFileSize(..) - there may be
@@ -556,6 +804,7 @@ void LLDiskCache::clearCache()
 #else
     std::string cache_path(mCacheDir);
 #endif
+    mFileHandles.clear(); // <FS:Kadah/> Open file handles
     if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
     {
         // <FS:Ansariel> Optimize asset simple disk cache
@@ -578,9 +827,11 @@ void LLDiskCache::clearCache()
             }
             iter.increment(ec);
         }
+        mIndex.clear(); // <FS:Kadah/> Disk cache index
         // <FS:Beq> add static assets into the new cache after clear
     LL_INFOS() << "prepopulating new cache " << LL_ENDL;
         prepopulateCacheWithStatic();
+        mIndex.flush(); // <FS:Kadah/> Disk cache index
     }
     LL_INFOS() << "Cleared cache " << mCacheDir << LL_ENDL;
 }
@@ -619,78 +870,80 @@ void LLDiskCache::removeOldVFSFiles()
     }
 }
 
-// <FS:Beq> Lets not scan every single time if we can avoid it eh?
-// uintmax_t LLDiskCache::dirFileSize(const std::string& dir)
-// {
-uintmax_t LLDiskCache::updateCacheSize(const uintmax_t newsize)
-{
-    mStoredCacheSize = newsize;
-    mLastScanTime = system_clock::now();
-    return mStoredCacheSize;
-}
-
-uintmax_t LLDiskCache::dirFileSize(const std::string& dir, bool force )
-{
-    using namespace std::chrono;
-    const seconds cache_duration{ 120 };// A rather arbitrary number. it takes 5 seconds+ on a fast drive to scan 80K+ items. purge runs every minute and will update. so 120 should mean we never need a superfluous cache scan.
-
-    const auto current_time = system_clock::now();
-
-    const auto time_difference = duration_cast<seconds>(current_time - mLastScanTime);
-
-    // Check if the cached result can be used
-    if( !force && time_difference < cache_duration )
-    {
-        LL_DEBUGS("LLDiskCache") << "Using cached result: " << mStoredCacheSize << LL_ENDL;
-        return mStoredCacheSize;
-    }
-// </FS:Beq>
-    uintmax_t total_file_size = 0;
-
-    /**
-     * There may be a better way that works directly on the folder (similar to
-     * right clicking on a folder in the OS and asking for size vs right clicking
-     * on all files and adding up manually) but this is very fast - less than 100ms
-     * for 10,000 files in my testing so, so long as it's not called frequently,
-     * it should be okay. Note that's it's only currently used for logging/debugging
-     * so if performance is ever an issue, optimizing this or removing it altogether,
-     * is an easy win.
-     */
-    boost::system::error_code ec;
-#if LL_WINDOWS
-    std::wstring dir_path(utf8str_to_utf16str(dir));
-#else
-    std::string dir_path(dir);
-#endif
-    if (boost::filesystem::is_directory(dir_path, ec) && !ec.failed())
-    {
-        // <FS:Ansariel> Optimize asset simple disk cache
-        //boost::filesystem::directory_iterator iter(dir_path, ec);
-        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
-        boost::filesystem::recursive_directory_iterator iter(dir_path, ec);
-        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
-            // </FS:Ansariel>
-        {
-            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
-            {
-                if ((*iter).path().string().find(mCacheFilenamePrefix) != std::string::npos)
-                {
-                    uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
-                    if (!ec.failed())
-                    {
-                        total_file_size += file_size;
-                    }
-                }
-            }
-            iter.increment(ec);
-        }
-    }
-
-// <FS:Beq> Lets not scan every single time if we can avoid it eh?
-    // return total_file_size;
-    return updateCacheSize(total_file_size);
-// </FS:Beq>
-}
+// <FS:Kadah> Disk cache index, the size comes from mIndex
+//// <FS:Beq> Lets not scan every single time if we can avoid it eh?
+//// uintmax_t LLDiskCache::dirFileSize(const std::string& dir)
+//// {
+//uintmax_t LLDiskCache::updateCacheSize(const uintmax_t newsize)
+//{
+//    mStoredCacheSize = newsize;
+//    mLastScanTime = system_clock::now();
+//    return mStoredCacheSize;
+//}
+//
+//uintmax_t LLDiskCache::dirFileSize(const std::string& dir, bool force )
+//{
+//    using namespace std::chrono;
+//    const seconds cache_duration{ 120 };// A rather arbitrary number. it takes 5 seconds+ on a fast drive to scan 80K+ items. purge runs every minute and will update. so 120 should mean we never need a superfluous cache scan.
+//
+//    const auto current_time = system_clock::now();
+//
+//    const auto time_difference = duration_cast<seconds>(current_time - mLastScanTime);
+//
+//    // Check if the cached result can be used
+//    if( !force && time_difference < cache_duration )
+//    {
+//        LL_DEBUGS("LLDiskCache") << "Using cached result: " << mStoredCacheSize << LL_ENDL;
+//        return mStoredCacheSize;
+//    }
+//// </FS:Beq>
+//    uintmax_t total_file_size = 0;
+//
+//    /**
+//     * There may be a better way that works directly on the folder (similar to
+//     * right clicking on a folder in the OS and asking for size vs right clicking
+//     * on all files and adding up manually) but this is very fast - less than 100ms
+//     * for 10,000 files in my testing so, so long as it's not called frequently,
+//     * it should be okay. Note that's it's only currently used for logging/debugging
+//     * so if performance is ever an issue, optimizing this or removing it altogether,
+//     * is an easy win.
+//     */
+//    boost::system::error_code ec;
+//#if LL_WINDOWS
+//    std::wstring dir_path(utf8str_to_utf16str(dir));
+//#else
+//    std::string dir_path(dir);
+//#endif
+//    if (boost::filesystem::is_directory(dir_path, ec) && !ec.failed())
+//    {
+//        // <FS:Ansariel> Optimize asset simple disk cache
+//        //boost::filesystem::directory_iterator iter(dir_path, ec);
+//        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
+//        boost::filesystem::recursive_directory_iterator iter(dir_path, ec);
+//        while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
+//            // </FS:Ansariel>
+//        {
+//            if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
+//            {
+//                if ((*iter).path().string().find(mCacheFilenamePrefix) != std::string::npos)
+//                {
+//                    uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
+//                    if (!ec.failed())
+//                    {
+//                        total_file_size += file_size;
+//                    }
+//                }
+//            }
+//            iter.increment(ec);
+//        }
+//    }
+//
+//// <FS:Beq> Lets not scan every single time if we can avoid it eh?
+//    // return total_file_size;
+//    return updateCacheSize(total_file_size);
+//// </FS:Beq>
+//}
+// </FS:Kadah>
 
 LLPurgeDiskCacheThread::LLPurgeDiskCacheThread() :
     LLThread("PurgeDiskCacheThread", nullptr)
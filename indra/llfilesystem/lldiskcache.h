@@ -30,6 +30,9 @@
  *    the files is less than the maximum size specified.
  * 4/ An LLSingleton idiom is used since there will only ever be
  *    a single cache and we want to access it from numerous places.
+ * <FS:Kadah> The sizes and access times of 2/ and 3/ live in an
+ *    LLDiskCacheIndex, journaled next to the files, rather than being
+ *    read back from the file system on every purge. </FS:Kadah>
  * 5/ Performance on my modest system seems very acceptable. For
  *    example, in testing, I was able to purge a directory of
  *    10,000 files, deleting about half of them in ~ 1700ms. For
@@ -63,6 +66,11 @@
 #define _LLDISKCACHE
 
 #include "llsingleton.h"
+#include "lldiskcacheindex.h" // <FS:Kadah/> Disk cache index
+// <FS:Kadah> Open file handles
+#include "llasyncfilereader.h"
+#include "llfilehandlecache.h"
+// </FS:Kadah>
 #include <chrono>
 using namespace std::chrono;
 
@@ -108,7 +116,10 @@ class LLDiskCache :
                     // </FS:Beq>
                     );
 
-        virtual ~LLDiskCache() = default;
+        // <FS:Kadah> Disk cache index
+        //virtual ~LLDiskCache() = default;
+        virtual ~LLDiskCache();
+        // </FS:Kadah>
 
     public:
         /**
@@ -137,12 +148,44 @@ class LLDiskCache :
         void updateFileAccessTime(const std::string& file_path);
         // </FS:Ansariel>
 
+        // <FS:Kadah> Disk cache index
+        /**
+         * Journal of the index, in the cache directory
+         */
+        static constexpr const char* INDEX_FILENAME = "cache_index.journal";
+
+        /**
+         * Keep the index in step with the files. Everything that writes,
+         * removes or renames a file in the cache directory must call these,
+         * purge() only ever deletes files the index knows about.
+         */
+        void updateFileSize(const std::string& file_path, uintmax_t size);
+        void removeFileEntry(const std::string& file_path);
+        void renameFileEntry(const std::string& old_path, const std::string& new_path);
+        // </FS:Kadah>
+
+        // <FS:Kadah> Open file handles
+        /**
+         * Cache files kept open between reads and writes. With a limit of 0,
+         * the default, LLFileSystem opens the file for every call.
+         */
+        LLFileHandleCache& getFileHandles() { return mFileHandles; }
+        void setFileHandleLimit(U32 limit) { mFileHandles.setLimit(limit); }
+
+        /**
+         * Reads batches of ranges of cache files, started on first use
+         */
+        LLAsyncFileReader& getFileReader();
+        // </FS:Kadah>
+
         /**
          * Purge the oldest items in the cache so that the combined size of all files
          * is no bigger than mMaxSizeBytes.
          *
          * WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
          * NOT touch any LLDiskCache data without introducing and locking a mutex!
+         * <FS:Kadah/> mIndex locks its own. Does nothing while another
+         * viewer owns the index.
          *
          * Purging the disk cache involves nontrivial work on the viewer's
          * filesystem. If called on the main thread, this causes a noticeable
@@ -159,6 +202,7 @@ class LLDiskCache :
          * Clear the cache by removing all the files in the specified cache
          * directory individually. Only the files that contain a prefix defined
          * by mCacheFilenamePrefix will be removed.
+         * <FS:Kadah/> Does nothing while another viewer owns the index.
          */
         void clearCache();
 
@@ -177,13 +221,27 @@ class LLDiskCache :
         // </FS:Beq>
 
     private:
+        // <FS:Kadah> Disk cache index
+        ///**
+        // * Utility function to gather the total size the files in a given
+        // * directory. Primarily used here to determine the directory size
+        // * before and after the cache purge
+        // */
+        //uintmax_t updateCacheSize(const uintmax_t newsize); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
+        //uintmax_t dirFileSize(const std::string& dir, bool force=false); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
+
         /**
-         * Utility function to gather the total size the files in a given
-         * directory. Primarily used here to determine the directory size
-         * before and after the cache purge
+         * Fills the index from the files in the cache directory. Only needed
+         * when there is no index or the last session did not close it.
          */
-        uintmax_t updateCacheSize(const uintmax_t newsize); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
-        uintmax_t dirFileSize(const std::string& dir, bool force=false); // <FS:Beq/> enable time based caching of dirfilesize except when force is true.
+        void rebuildIndex();
+
+        /**
+         * Name of a file in the index, its path relative to the cache
+         * directory. Empty for files elsewhere.
+         */
+        std::string getIndexName(const std::string& file_path) const;
+        // </FS:Kadah>
 
         /**
          * Utility function to convert an LLAssetType enum into a
@@ -191,12 +249,26 @@ class LLDiskCache :
          */
         const std::string assetTypeToString(LLAssetType::EType at);
 
+        // <FS:Kadah> Disk cache index
+        ///**
+        // * cache the directory size cos it takes forever to calculate it
+        // * 
+        // */
+        //uintmax_t mStoredCacheSize{ 0 };
+        //time_point<system_clock> mLastScanTime{ };
+
         /**
-         * cache the directory size cos it takes forever to calculate it
-         * 
+         * Size and last access of every cache file, so that neither purge()
+         * nor getCacheInfo() scan the directory
          */
-        uintmax_t mStoredCacheSize{ 0 };
-        time_point<system_clock> mLastScanTime{ };
+        LLDiskCacheIndex mIndex;
+        // </FS:Kadah>
+
+        // <FS:Kadah> Open file handles
+        LLFileHandleCache mFileHandles { 0 };
+        std::mutex mFileReaderMutex;
+        std::unique_ptr<LLAsyncFileReader> mFileReader;
+        // </FS:Kadah>
 
     private:
         /**
@@ -0,0 +1,556 @@
+/**
+ * @file lldiskcacheindex.cpp
+ * @brief In-memory index of the files in the disk cache, persisted as a record journal.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lldiskcacheindex.h"
+#include "llfile.h"
+#include "llrecordjournal.h"
+#include "llstring.h"
+
+#include <algorithm>
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+// Identifies the journal, a new id invalidates old indexes.
+static const LLUUID INDEX_JOURNAL_ID("5b0e3d1c-7a2f-4e86-9c41-d2f6a8b3e017");
+// Journal key of the session record, files use slot + 1.
+static const U32 SESSION_KEY = 0;
+static const U32 SESSION_OPEN = 1;
+static const U32 SESSION_CLOSED = 2;
+// Next to the journal: held by the process that owns it, and left by a
+// read-only session that changed the files
+static const char LOCK_SUFFIX[] = ".lock";
+static const char STALE_SUFFIX[] = ".stale";
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+struct EntryRecord
+{
+	U64 mSize;
+	S64 mAccessTime;
+	U32 mFlags;
+	// followed by the name
+};
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+
+static const U32 NO_SLOT = U32_MAX;
+
+static void add_entry_record(LLRecordJournal::Batch& batch, U32 slot, const LLDiskCacheIndex::Entry& entry)
+{
+	std::string data(sizeof(EntryRecord) + entry.mName.size(), '\0');
+	EntryRecord record = { entry.mSize, entry.mAccessTime, entry.mFlags };
+	memcpy(&data[0], &record, sizeof(record));
+	memcpy(&data[sizeof(record)], entry.mName.data(), entry.mName.size());
+	batch.add(slot + 1, (const U8*)data.data(), (U32)data.size());
+}
+
+static void add_session_record(LLRecordJournal::Batch& batch, U32 state)
+{
+	batch.add(SESSION_KEY, (const U8*)&state, sizeof(state));
+}
+
+LLDiskCacheIndex::LLDiskCacheIndex()
+:	mTotalSize(0),
+	mJournalRecords(0),
+	mRewrite(false),
+	mReadOnly(false),
+	mFilesChanged(false),
+#if LL_WINDOWS
+	mLockFile(INVALID_HANDLE_VALUE)
+#else
+	mLockFile(-1)
+#endif
+{
+}
+
+LLDiskCacheIndex::~LLDiskCacheIndex()
+{
+	releaseLock();
+}
+
+bool LLDiskCacheIndex::open(const std::string& filename)
+{
+	LLMutexLock flush_lock(&mFlushMutex);
+	LLMutexLock lock(&mMutex);
+	resetLocked();
+	mFileName = filename;
+	mFilesChanged = false;
+	mReadOnly = !acquireLock(filename);
+	if (mReadOnly)
+	{
+		LL_INFOS() << filename << " is in use by another viewer, the disk cache index is read-only" << LL_ENDL;
+	}
+
+	U32 session = 0;
+	LLRecordJournal::Stats stats;
+	bool read = LLRecordJournal::read(filename, INDEX_JOURNAL_ID,
+		[this, &session](U32 key, const U8* data, U32 size)
+		{
+			if (key == SESSION_KEY)
+			{
+				if (size == sizeof(session))
+				{
+					memcpy(&session, data, sizeof(session));
+				}
+				return true;
+			}
+			if (size <= sizeof(EntryRecord))
+			{
+				return false;
+			}
+			EntryRecord record;
+			memcpy(&record, data, sizeof(record));
+			const U32 slot = key - 1;
+			if (slot >= mEntries.size())
+			{
+				mEntries.resize(slot + 1);
+			}
+			Entry& entry = mEntries[slot];
+			entry.mName.assign((const char*)data + sizeof(record), size - sizeof(record));
+			entry.mSize = record.mSize;
+			entry.mAccessTime = record.mAccessTime;
+			entry.mFlags = record.mFlags;
+			mSlots[entry.mName] = slot;
+			mTotalSize += entry.mSize;
+			return true;
+		}, &stats);
+
+	const std::string stale_name = filename + STALE_SUFFIX;
+	bool stale = false;
+	if (!mReadOnly && read && session == SESSION_CLOSED && LLFile::isfile(stale_name))
+	{
+		LL_INFOS() << "Another viewer changed the cache since " << filename << " was closed, the cache has to be scanned" << LL_ENDL;
+		// Marked open before the marker goes, a crash ahead of the rescan
+		// being flushed still rescans
+		LLRecordJournal::Batch batch;
+		add_session_record(batch, SESSION_OPEN);
+		if (LLRecordJournal::append(filename, INDEX_JOURNAL_ID, batch))
+		{
+			LLFile::remove(stale_name);
+		}
+		stale = true;
+	}
+
+	// The owner keeps the journal open while it runs, a read-only index
+	// takes it as it is
+	if (!read || stale || (session != SESSION_CLOSED && !mReadOnly))
+	{
+		if (read && !stale)
+		{
+			LL_INFOS() << filename << " was not closed, the cache has to be scanned" << LL_ENDL;
+		}
+		resetLocked();
+		mRewrite = true;
+		return false;
+	}
+
+	for (U32 slot = 0; slot < mEntries.size(); ++slot)
+	{
+		if (mEntries[slot].mName.empty())
+		{
+			mFreeSlots.push_back(slot);
+		}
+	}
+	mDirty.assign(mEntries.size(), false);
+	mJournalRecords = stats.mRecords;
+	// A partial record at the end has to go before anything is appended
+	mRewrite = stats.mTruncated;
+
+	if (mReadOnly)
+	{
+		return true;
+	}
+
+	// Marked open until close(), so that a crash makes the next run rescan
+	LLRecordJournal::Batch batch;
+	add_session_record(batch, SESSION_OPEN);
+	++mJournalRecords;
+	if (!mRewrite && !LLRecordJournal::append(filename, INDEX_JOURNAL_ID, batch))
+	{
+		mRewrite = true;
+	}
+	return true;
+}
+
+void LLDiskCacheIndex::close()
+{
+	if (mFileName.empty())
+	{
+		return;
+	}
+	if (mReadOnly)
+	{
+		// The owner does not know about the files this session wrote or
+		// deleted, its next open() rescans
+		LLMutexLock lock(&mMutex);
+		if (mFilesChanged)
+		{
+			LLFILE* file = LLFile::fopen(mFileName + STALE_SUFFIX, "wb");
+			if (file)
+			{
+				LLFile::close(file);
+			}
+		}
+	}
+	// Left open if the last changes did not make it, the next run rescans
+	else if (flush())
+	{
+		LLMutexLock flush_lock(&mFlushMutex);
+		LLRecordJournal::Batch batch;
+		add_session_record(batch, SESSION_CLOSED);
+		LLRecordJournal::append(mFileName, INDEX_JOURNAL_ID, batch);
+	}
+	LLMutexLock lock(&mMutex);
+	mFileName.clear();
+	releaseLock();
+}
+
+void LLDiskCacheIndex::rebuild(const entry_list_t& entries)
+{
+	LLMutexLock lock(&mMutex);
+	resetLocked();
+	for (const Entry& entry : entries)
+	{
+		U32 slot = allocateSlot(entry.mName);
+		Entry& indexed = mEntries[slot];
+		indexed.mSize = entry.mSize;
+		indexed.mAccessTime = entry.mAccessTime;
+		indexed.mFlags = entry.mFlags;
+		mTotalSize += entry.mSize;
+	}
+	mRewrite = true;
+}
+
+void LLDiskCacheIndex::clear()
+{
+	LLMutexLock lock(&mMutex);
+	resetLocked();
+	mRewrite = true;
+}
+
+void LLDiskCacheIndex::update(const std::string& name, U64 size, S64 now)
+{
+	LLMutexLock lock(&mMutex);
+	U32 slot = findSlot(name);
+	if (slot == NO_SLOT)
+	{
+		slot = allocateSlot(name);
+	}
+	Entry& entry = mEntries[slot];
+	mTotalSize = mTotalSize - entry.mSize + size;
+	mFilesChanged = true;
+	entry.mSize = size;
+	entry.mAccessTime = now;
+	markDirty(slot);
+}
+
+void LLDiskCacheIndex::touch(const std::string& name, S64 now)
+{
+	LLMutexLock lock(&mMutex);
+	U32 slot = findSlot(name);
+	if (slot != NO_SLOT && mEntries[slot].mAccessTime < now)
+	{
+		mEntries[slot].mAccessTime = now;
+		markDirty(slot);
+	}
+}
+
+void LLDiskCacheIndex::remove(const std::string& name)
+{
+	LLMutexLock lock(&mMutex);
+	U32 slot = findSlot(name);
+	if (slot != NO_SLOT)
+	{
+		mTotalSize -= mEntries[slot].mSize;
+		mEntries[slot] = Entry();
+		mSlots.erase(name);
+		mFreeSlots.push_back(slot);
+		markDirty(slot);
+		mFilesChanged = true;
+	}
+}
+
+void LLDiskCacheIndex::rename(const std::string& old_name, const std::string& new_name)
+{
+	Entry entry;
+	if (getEntry(old_name, entry))
+	{
+		remove(old_name);
+		update(new_name, entry.mSize, entry.mAccessTime);
+	}
+}
+
+void LLDiskCacheIndex::setFlags(const std::string& name, U32 flags)
+{
+	LLMutexLock lock(&mMutex);
+	U32 slot = findSlot(name);
+	if (slot != NO_SLOT && mEntries[slot].mFlags != flags)
+	{
+		mEntries[slot].mFlags = flags;
+		markDirty(slot);
+	}
+}
+
+bool LLDiskCacheIndex::getEntry(const std::string& name, Entry& entry) const
+{
+	LLMutexLock lock(&mMutex);
+	U32 slot = findSlot(name);
+	if (slot == NO_SLOT)
+	{
+		return false;
+	}
+	entry = mEntries[slot];
+	return true;
+}
+
+void LLDiskCacheIndex::evict(U64 target_size, entry_list_t& evicted)
+{
+	LLMutexLock lock(&mMutex);
+	if (mTotalSize <= target_size)
+	{
+		return;
+	}
+
+	// Only the oldest files go, order just enough of them
+	typedef std::pair<S64, U32> candidate_t;
+	std::vector<candidate_t> candidates;
+	candidates.reserve(mSlots.size());
+	for (U32 slot = 0; slot < mEntries.size(); ++slot)
+	{
+		const Entry& entry = mEntries[slot];
+		if (!entry.mName.empty() && !(entry.mFlags & FLAG_STATIC))
+		{
+			candidates.push_back(candidate_t(entry.mAccessTime, slot));
+		}
+	}
+
+	size_t sorted = 0;
+	for (size_t i = 0; i < candidates.size() && mTotalSize > target_size; ++i)
+	{
+		if (i == sorted)
+		{
+			sorted = std::min(candidates.size(), std::max(sorted * 2, (size_t)1024));
+			std::partial_sort(candidates.begin() + i, candidates.begin() + sorted, candidates.end());
+		}
+		U32 slot = candidates[i].second;
+		evicted.push_back(mEntries[slot]);
+		mTotalSize -= mEntries[slot].mSize;
+		mSlots.erase(mEntries[slot].mName);
+		mEntries[slot] = Entry();
+		mFreeSlots.push_back(slot);
+		markDirty(slot);
+	}
+}
+
+bool LLDiskCacheIndex::flush()
+{
+	LLMutexLock flush_lock(&mFlushMutex);
+	LLRecordJournal::Batch batch;
+	bool rewrite = false;
+	{
+		LLMutexLock lock(&mMutex);
+		if (mFileName.empty() || mReadOnly || (!mRewrite && mDirtySlots.empty()))
+		{
+			return true;
+		}
+
+		rewrite = mRewrite || LLRecordJournal::needsCompaction(mJournalRecords + (U32)mDirtySlots.size(), (U32)mSlots.size() + 1);
+		if (rewrite)
+		{
+			add_session_record(batch, SESSION_OPEN);
+			for (U32 slot = 0; slot < mEntries.size(); ++slot)
+			{
+				if (!mEntries[slot].mName.empty())
+				{
+					add_entry_record(batch, slot, mEntries[slot]);
+				}
+			}
+		}
+		else
+		{
+			for (U32 slot : mDirtySlots)
+			{
+				if (mEntries[slot].mName.empty())
+				{
+					batch.remove(slot + 1);
+				}
+				else
+				{
+					add_entry_record(batch, slot, mEntries[slot]);
+				}
+			}
+		}
+		for (U32 slot : mDirtySlots)
+		{
+			mDirty[slot] = false;
+		}
+		mDirtySlots.clear();
+		mRewrite = false;
+	}
+
+	// Written outside mMutex, readers and writers of the cache carry on
+	bool written = rewrite ? LLRecordJournal::rewrite(mFileName, INDEX_JOURNAL_ID, batch)
+						   : LLRecordJournal::append(mFileName, INDEX_JOURNAL_ID, batch);
+
+	LLMutexLock lock(&mMutex);
+	if (written)
+	{
+		mJournalRecords = (rewrite ? 0 : mJournalRecords) + batch.getRecordCount();
+	}
+	else
+	{
+		// Whatever made it to the file, the next flush starts over
+		LL_WARNS() << "Unable to write the disk cache index " << mFileName << LL_ENDL;
+		mRewrite = true;
+	}
+	return written;
+}
+
+U64 LLDiskCacheIndex::getTotalSize() const
+{
+	LLMutexLock lock(&mMutex);
+	return mTotalSize;
+}
+
+U32 LLDiskCacheIndex::getEntryCount() const
+{
+	LLMutexLock lock(&mMutex);
+	return (U32)mSlots.size();
+}
+
+U32 LLDiskCacheIndex::getStaticCount() const
+{
+	LLMutexLock lock(&mMutex);
+	U32 count = 0;
+	for (const Entry& entry : mEntries)
+	{
+		count += (entry.mFlags & FLAG_STATIC) ? 1 : 0;
+	}
+	return count;
+}
+
+U32 LLDiskCacheIndex::findSlot(const std::string& name) const
+{
+	std::unordered_map<std::string, U32>::const_iterator iter = mSlots.find(name);
+	return iter != mSlots.end() ? iter->second : NO_SLOT;
+}
+
+U32 LLDiskCacheIndex::allocateSlot(const std::string& name)
+{
+	U32 slot;
+	if (!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		slot = (U32)mEntries.size();
+		mEntries.push_back(Entry());
+		mDirty.push_back(false);
+	}
+	mEntries[slot].mName = name;
+	mSlots[name] = slot;
+	return slot;
+}
+
+void LLDiskCacheIndex::markDirty(U32 slot)
+{
+	if (!mDirty[slot])
+	{
+		mDirty[slot] = true;
+		mDirtySlots.push_back(slot);
+	}
+}
+
+void LLDiskCacheIndex::resetLocked()
+{
+	mEntries.clear();
+	mFreeSlots.clear();
+	mSlots.clear();
+	mDirty.clear();
+	mDirtySlots.clear();
+	mTotalSize = 0;
+	mJournalRecords = 0;
+}
+
+bool LLDiskCacheIndex::acquireLock(const std::string& filename)
+{
+	releaseLock();
+	const std::string lock_name = filename + LOCK_SUFFIX;
+#if LL_WINDOWS
+	// Not shared, a second viewer cannot open it until this one exits
+	HANDLE file = CreateFileW(ll_convert_string_to_wide(lock_name).c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+							  NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	mLockFile = file;
+#else
+	// Released by the kernel if the viewer crashes
+	int fd = ::open(lock_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0)
+	{
+		return false;
+	}
+	if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+	mLockFile = fd;
+#endif
+	return true;
+}
+
+void LLDiskCacheIndex::releaseLock()
+{
+#if LL_WINDOWS
+	if (mLockFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mLockFile);
+		mLockFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (mLockFile >= 0)
+	{
+		::close(mLockFile);
+		mLockFile = -1;
+	}
+#endif
+}
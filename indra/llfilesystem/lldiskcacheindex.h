@@ -0,0 +1,161 @@
+/**
+ * @file lldiskcacheindex.h
+ * @brief In-memory index of the files in the disk cache, persisted as a record journal.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLDISKCACHEINDEX_H
+#define LL_LLDISKCACHEINDEX_H
+
+#include "llmutex.h"
+
+#include <unordered_map>
+
+/**
+ * Size, last access and flags of every file in LLDiskCache, so that
+ * purging and sizing the cache do not have to stat the whole directory.
+ * Files are named relative to the cache directory. Changes are kept in
+ * memory and appended to an LLRecordJournal by flush(). All methods are
+ * thread safe.
+ *
+ * Only one process owns the journal, the one holding the lock file next
+ * to it. Any other viewer sharing the cache gets a read-only index: it
+ * never writes the journal, and the cache must not purge or clear files
+ * for it. The files such a viewer adds or removes are unknown to the
+ * owner, so its close() leaves a marker that makes the next owner rescan.
+ */
+class LLDiskCacheIndex
+{
+	LOG_CLASS(LLDiskCacheIndex);
+public:
+	enum
+	{
+		FLAG_STATIC = 1 << 0,	// shipped with the viewer, never evicted
+	};
+
+	struct Entry
+	{
+		Entry() : mSize(0), mAccessTime(0), mFlags(0) {}
+		std::string mName;
+		U64 mSize;
+		S64 mAccessTime;		// seconds since the epoch
+		U32 mFlags;
+	};
+	typedef std::vector<Entry> entry_list_t;
+
+	LLDiskCacheIndex();
+	~LLDiskCacheIndex();
+
+	/**
+	 * Locks and reads the journal in filename and marks it open. Returns
+	 * false if there is none, it cannot be read, the session that last had
+	 * it open did not close() it, or a read-only session changed the files
+	 * since; the index is then empty and should be rebuilt from the files.
+	 * If another process holds the lock, the journal is only read and
+	 * isReadOnly() is true.
+	 */
+	bool open(const std::string& filename);
+
+	/**
+	 * Flushes and marks the journal closed, so that the next open() can
+	 * trust it, and releases the lock.
+	 */
+	void close();
+
+	bool isReadOnly() const		{ return mReadOnly; }
+
+	/**
+	 * Replaces every entry, with the files a directory scan found. The
+	 * journal is rewritten on the next flush().
+	 */
+	void rebuild(const entry_list_t& entries);
+
+	/**
+	 * Drops every entry.
+	 */
+	void clear();
+
+	/**
+	 * Adds name, or updates its size, as written at now.
+	 */
+	void update(const std::string& name, U64 size, S64 now);
+
+	/**
+	 * Notes a read of name at now. Unknown names are ignored.
+	 */
+	void touch(const std::string& name, S64 now);
+
+	void remove(const std::string& name);
+	void rename(const std::string& old_name, const std::string& new_name);
+	void setFlags(const std::string& name, U32 flags);
+
+	bool getEntry(const std::string& name, Entry& entry) const;
+
+	/**
+	 * Removes the least recently used entries that are not FLAG_STATIC
+	 * until the total size is at most target_size, and returns them,
+	 * oldest first, for the caller to delete.
+	 */
+	void evict(U64 target_size, entry_list_t& evicted);
+
+	/**
+	 * Appends the entries changed since the last flush to the journal, or
+	 * rewrites it once superseded records outnumber the live ones.
+	 */
+	bool flush();
+
+	U64 getTotalSize() const;
+	U32 getEntryCount() const;
+	U32 getStaticCount() const;
+
+private:
+	U32 findSlot(const std::string& name) const;
+	U32 allocateSlot(const std::string& name);
+	void markDirty(U32 slot);
+	void resetLocked();
+	bool acquireLock(const std::string& filename);
+	void releaseLock();
+
+private:
+	mutable LLMutex mMutex;
+	LLMutex mFlushMutex;		// keeps flush() writes in order
+	std::string mFileName;
+	std::vector<Entry> mEntries;	// journal key - 1 -> entry, an empty name is a free slot
+	std::vector<U32> mFreeSlots;
+	std::unordered_map<std::string, U32> mSlots;
+	std::vector<bool> mDirty;
+	std::vector<U32> mDirtySlots;
+	U64 mTotalSize;
+	U32 mJournalRecords;		// records in the file, superseded ones included
+	bool mRewrite;
+	bool mReadOnly;			// another process owns the journal
+	bool mFilesChanged;		// files were added or removed since open()
+#if LL_WINDOWS
+	void* mLockFile;
+#else
+	int mLockFile;
+#endif
+};
+
+#endif // LL_LLDISKCACHEINDEX_H
@@ -0,0 +1,424 @@
+/**
+ * @file llfastcachetable.cpp
+ * @brief UUID keyed table of small decoded images living in a memory mapped file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llfastcachetable.h"
+#include "llfile.h"
+#include "llmemory.h"
+
+// File layout:
+//  FileHeader, padded to SLOT_ALIGN
+//  mSlotCount slots of mSlotSize bytes: SlotHeader + pixels
+
+static const U32 FAST_CACHE_MAGIC = 0x32434653; // "SFC2"
+static const U32 FAST_CACHE_VERSION = 1;
+static const U32 SLOT_ALIGN = 64;
+static const U32 MIN_SLOTS = 64;
+// Last access times are only refreshed this often, so that hits do not
+// dirty a page of the mapping each time.
+static const U32 ACCESS_GRANULARITY = 600; // seconds
+
+enum ESlotState
+{
+	SLOT_EMPTY = 0,
+	SLOT_USED = 1,
+	SLOT_REMOVED = 2 // keeps probe sequences going past it
+};
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+struct FileHeader
+{
+	U32 mMagic;
+	U32 mVersion;
+	U32 mResolution;
+	U32 mSlotSize;
+	U32 mSlotCount;
+	U32 mEntryCount;
+};
+
+struct LLFastCacheTable::SlotHeader
+{
+	LLUUID mID;
+	U16 mWidth;
+	U16 mHeight;
+	U8 mComponents;
+	S8 mDiscardLevel;
+	U8 mState;
+	U8 mPad;
+	U32 mLastAccess;
+	U32 mChecksum;
+};
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+
+static const U32 SLOTS_OFFSET = SLOT_ALIGN;
+
+static inline U32 now_seconds()
+{
+	return (U32)time(NULL);
+}
+
+static inline U32 home_slot(const LLUUID& id, U32 slot_count)
+{
+	U64 h;
+	memcpy(&h, id.mData, sizeof(h));
+	return (U32)(h % slot_count);
+}
+
+static U32 pixels_checksum(const U8* data, S32 size)
+{
+	// Word at a time rolling sum, good enough to catch torn writes
+	U32 sum = 0x811c9dc5;
+	S32 words = size / 4;
+	for (S32 i = 0; i < words; ++i)
+	{
+		U32 word;
+		memcpy(&word, data + i * 4, 4);
+		sum = (sum ^ word) * 0x01000193;
+	}
+	for (S32 i = words * 4; i < size; ++i)
+	{
+		sum = (sum ^ data[i]) * 0x01000193;
+	}
+	return sum;
+}
+
+LLFastCacheTable::LLFastCacheTable()
+:	mResolution(MIN_RESOLUTION),
+	mSlotSize(0),
+	mSlotCount(0),
+	mEvictionCount(0)
+{
+}
+
+LLFastCacheTable::~LLFastCacheTable()
+{
+	close();
+}
+
+bool LLFastCacheTable::open(const std::string& filename, U32 resolution, U64 capacity)
+{
+	LLMutexLock lock(&mMutex);
+
+	mFileName = filename;
+	mResolution = MIN_RESOLUTION;
+	while (mResolution * 2 <= llmin(resolution, MAX_RESOLUTION))
+	{
+		mResolution *= 2;
+	}
+	static_assert(sizeof(SlotHeader) == 32, "fast cache slot header is part of the file format");
+	mSlotSize = ((U32)sizeof(SlotHeader) + mResolution * mResolution * 4 + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1);
+
+#if ADDRESS_SIZE == 32
+	// The whole table is mapped at once; keep 32 bits builds within reason.
+	capacity = llmin(capacity, (U64)256 * 1024 * 1024);
+#endif
+	mSlotCount = (U32)llmax(capacity / mSlotSize, (U64)MIN_SLOTS);
+	mEvictionCount = 0;
+
+	if (!mapFile(false))
+	{
+		return false;
+	}
+
+	LL_INFOS("FastCache") << "Opened " << mFileName << " slots: " << mSlotCount
+						  << " x " << mResolution << "px, entries: " << getEntryCount() << LL_ENDL;
+	return true;
+}
+
+void LLFastCacheTable::close()
+{
+	LLMutexLock lock(&mMutex);
+	if (!mFile.isOpen())
+	{
+		return;
+	}
+	mFile.flush();
+	mFile.close();
+}
+
+void LLFastCacheTable::clear()
+{
+	LLMutexLock lock(&mMutex);
+	bool was_open = mFile.isOpen();
+	mFile.close();
+	LLFile::remove(mFileName, ENOENT);
+	mEvictionCount = 0;
+	if (was_open)
+	{
+		mapFile(true);
+	}
+}
+
+bool LLFastCacheTable::write(const LLUUID& id, const Image& image, const U8* data)
+{
+	S32 size = image.getDataSize();
+	if (!data || size <= 0 || size > getMaxDataSize()
+		|| image.mWidth > U16_MAX || image.mHeight > U16_MAX
+		|| image.mComponents > 4 || image.mDiscardLevel < 0 || image.mDiscardLevel > S8_MAX)
+	{
+		return false;
+	}
+
+	LLMutexLock lock(&mMutex);
+	if (!mFile.isOpen())
+	{
+		return false;
+	}
+
+	// Look for id in its probe window, remembering the first free slot and
+	// the least recently used one on the way.
+	U32 home = home_slot(id, mSlotCount);
+	S32 target = -1;
+	S32 free_slot = -1;
+	S32 victim = -1;
+	U32 oldest = U32_MAX;
+	for (U32 i = 0; i < PROBE_LENGTH; ++i)
+	{
+		U32 slot = (home + i) % mSlotCount;
+		SlotHeader* header = getSlot(slot);
+		if (header->mState == SLOT_USED)
+		{
+			if (header->mID == id)
+			{
+				if (header->mDiscardLevel <= image.mDiscardLevel)
+				{
+					return true; // never trade detail away
+				}
+				target = slot;
+				break;
+			}
+			if (header->mLastAccess < oldest)
+			{
+				oldest = header->mLastAccess;
+				victim = slot;
+			}
+		}
+		else if (free_slot < 0)
+		{
+			free_slot = slot;
+		}
+		if (header->mState == SLOT_EMPTY)
+		{
+			break; // nothing was ever stored further along
+		}
+	}
+
+	if (target < 0)
+	{
+		if (free_slot >= 0)
+		{
+			target = free_slot;
+			setEntryCount(getEntryCount() + 1);
+		}
+		else
+		{
+			target = victim;
+			++mEvictionCount;
+		}
+	}
+
+	SlotHeader* header = getSlot(target);
+	header->mState = SLOT_REMOVED;
+	memcpy(getSlotData(target), data, size);
+
+	SlotHeader updated;
+	updated.mID = id;
+	updated.mWidth = (U16)image.mWidth;
+	updated.mHeight = (U16)image.mHeight;
+	updated.mComponents = (U8)image.mComponents;
+	updated.mDiscardLevel = (S8)image.mDiscardLevel;
+	updated.mState = SLOT_USED;
+	updated.mPad = 0;
+	updated.mLastAccess = now_seconds();
+	updated.mChecksum = pixels_checksum(data, size);
+	memcpy(header, &updated, sizeof(SlotHeader));
+	return true;
+}
+
+U8* LLFastCacheTable::read(const LLUUID& id, Image& image)
+{
+	LLMutexLock lock(&mMutex);
+	S32 slot = findSlot(id);
+	if (slot < 0)
+	{
+		return NULL;
+	}
+
+	SlotHeader* header = getSlot(slot);
+	image.mWidth = header->mWidth;
+	image.mHeight = header->mHeight;
+	image.mComponents = header->mComponents;
+	image.mDiscardLevel = header->mDiscardLevel;
+	S32 size = image.getDataSize();
+	const U8* pixels = getSlotData(slot);
+	if (size <= 0 || size > getMaxDataSize() || pixels_checksum(pixels, size) != header->mChecksum)
+	{
+		LL_WARNS("FastCache") << "Dropping corrupted entry for " << id << LL_ENDL;
+		header->mState = SLOT_REMOVED;
+		setEntryCount(getEntryCount() - 1);
+		return NULL;
+	}
+
+	U8* data = (U8*)ll_aligned_malloc_16(size);
+	if (!data)
+	{
+		return NULL;
+	}
+	memcpy(data, pixels, size);
+
+	U32 now = now_seconds();
+	if (now - header->mLastAccess > ACCESS_GRANULARITY)
+	{
+		header->mLastAccess = now;
+	}
+	return data;
+}
+
+S32 LLFastCacheTable::getDiscardLevel(const LLUUID& id)
+{
+	LLMutexLock lock(&mMutex);
+	S32 slot = findSlot(id);
+	return slot < 0 ? -1 : getSlot(slot)->mDiscardLevel;
+}
+
+bool LLFastCacheTable::remove(const LLUUID& id)
+{
+	LLMutexLock lock(&mMutex);
+	S32 slot = findSlot(id);
+	if (slot < 0)
+	{
+		return false;
+	}
+	getSlot(slot)->mState = SLOT_REMOVED;
+	setEntryCount(getEntryCount() - 1);
+	return true;
+}
+
+U32 LLFastCacheTable::getEntryCount()
+{
+	if (!mFile.isOpen())
+	{
+		return 0;
+	}
+	return ((const FileHeader*)mFile.getData())->mEntryCount;
+}
+
+LLFastCacheTable::SlotHeader* LLFastCacheTable::getSlot(U32 slot)
+{
+	return (SlotHeader*)(mFile.getData() + SLOTS_OFFSET + (size_t)slot * mSlotSize);
+}
+
+U8* LLFastCacheTable::getSlotData(U32 slot)
+{
+	return mFile.getData() + SLOTS_OFFSET + (size_t)slot * mSlotSize + sizeof(SlotHeader);
+}
+
+// mMutex must be locked
+S32 LLFastCacheTable::findSlot(const LLUUID& id)
+{
+	if (!mFile.isOpen())
+	{
+		return -1;
+	}
+	U32 home = home_slot(id, mSlotCount);
+	for (U32 i = 0; i < PROBE_LENGTH; ++i)
+	{
+		U32 slot = (home + i) % mSlotCount;
+		const SlotHeader* header = getSlot(slot);
+		if (header->mState == SLOT_EMPTY)
+		{
+			break;
+		}
+		if (header->mState == SLOT_USED && header->mID == id)
+		{
+			return slot;
+		}
+	}
+	return -1;
+}
+
+// mMutex must be locked
+void LLFastCacheTable::setEntryCount(U32 count)
+{
+	((FileHeader*)mFile.getData())->mEntryCount = count;
+}
+
+// mMutex must be locked
+bool LLFastCacheTable::mapFile(bool discard)
+{
+	size_t file_size = SLOTS_OFFSET + (size_t)mSlotSize * mSlotCount;
+	if (!discard && LLFile::isfile(mFileName))
+	{
+		// Keep the existing table only if it has the same geometry
+		llstat stat_data;
+		FileHeader header;
+		bool keep = false;
+		if (LLFile::stat(mFileName, &stat_data) == 0 && (size_t)stat_data.st_size == file_size)
+		{
+			LLUniqueFile file = LLFile::fopen(mFileName, "rb");
+			keep = file && fread(&header, sizeof(header), 1, file) == 1
+				&& header.mMagic == FAST_CACHE_MAGIC
+				&& header.mVersion == FAST_CACHE_VERSION
+				&& header.mResolution == mResolution
+				&& header.mSlotSize == mSlotSize
+				&& header.mSlotCount == mSlotCount;
+		}
+		if (!keep)
+		{
+			LL_INFOS("FastCache") << "Fast cache geometry changed, discarding " << mFileName << LL_ENDL;
+			discard = true;
+		}
+	}
+	if (discard)
+	{
+		LLFile::remove(mFileName, ENOENT);
+	}
+
+	bool created = !LLFile::isfile(mFileName);
+	if (!mFile.open(mFileName, file_size, true))
+	{
+		LL_WARNS("FastCache") << "Unable to map fast cache " << mFileName << LL_ENDL;
+		return false;
+	}
+	if (created)
+	{
+		// New files read back as zeroes, so every slot starts out SLOT_EMPTY
+		FileHeader* header = (FileHeader*)mFile.getData();
+		header->mMagic = FAST_CACHE_MAGIC;
+		header->mVersion = FAST_CACHE_VERSION;
+		header->mResolution = mResolution;
+		header->mSlotSize = mSlotSize;
+		header->mSlotCount = mSlotCount;
+		header->mEntryCount = 0;
+	}
+	return true;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file llfastcachetable.h
+ * @brief UUID keyed table of small decoded images living in a memory mapped file.
+ *
+ * @Description:
+ * The file is a fixed number of equally sized slots, each big enough for a
+ * resolution x resolution RGBA image plus a small slot header (UUID, size,
+ * discard level, last access and a checksum of the pixels). Slots are found
+ * by open addressing: an id hashes to a home slot and may live in any of the
+ * PROBE_LENGTH slots that follow it. When all of them are taken the least
+ * recently accessed one is overwritten, so the table never needs rehashing
+ * or a separate index, and a lookup touches at most a few slot headers.
+ *
+ * The pixels are written before the slot header is marked used and are
+ * checked against the checksum on every read, so a table left half written
+ * by a crash only loses the slots that were being written.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFASTCACHETABLE_H
+#define LL_LLFASTCACHETABLE_H
+
+#include "llmappedfile.h"
+#include "llmutex.h"
+#include "lluuid.h"
+
+class LLFastCacheTable
+{
+	LOG_CLASS(LLFastCacheTable);
+public:
+	static const U32 MIN_RESOLUTION = 16;
+	static const U32 MAX_RESOLUTION = 256;
+	static const U32 PROBE_LENGTH = 8;
+
+	struct Image
+	{
+		Image() : mWidth(0), mHeight(0), mComponents(0), mDiscardLevel(-1) {}
+		S32 mWidth;
+		S32 mHeight;
+		S32 mComponents;
+		S32 mDiscardLevel;
+		S32 getDataSize() const { return mWidth * mHeight * mComponents; }
+	};
+
+	LLFastCacheTable();
+	~LLFastCacheTable();
+
+	/**
+	 * Opens (or creates) the table in filename. resolution is rounded down to
+	 * a power of two within [MIN_RESOLUTION, MAX_RESOLUTION] and capacity to a
+	 * whole number of slots. A table created with another resolution or
+	 * capacity is discarded.
+	 */
+	bool open(const std::string& filename, U32 resolution, U64 capacity);
+
+	/**
+	 * Unmaps the table. Its content stays on disk for the next run.
+	 */
+	void close();
+
+	/**
+	 * Drops every image. The file is removed and recreated empty.
+	 */
+	void clear();
+
+	bool isOpen() const { return mFile.isOpen(); }
+
+	/**
+	 * Largest number of pixel bytes a slot holds, resolution^2 * 4.
+	 */
+	S32 getMaxDataSize() const { return (S32)(mResolution * mResolution * 4); }
+	U32 getResolution() const { return mResolution; }
+
+	/**
+	 * Stores the image for id. An image already stored for id at a lower
+	 * discard level (more detail) is kept and the call succeeds without
+	 * writing anything. May overwrite the least recently used image in the
+	 * probe window of id.
+	 */
+	bool write(const LLUUID& id, const Image& image, const U8* data);
+
+	/**
+	 * Returns a copy of the pixels stored for id, allocated with
+	 * ll_aligned_malloc_16() and owned by the caller, and fills image.
+	 * Returns NULL on a miss or if the slot failed its checksum.
+	 */
+	U8* read(const LLUUID& id, Image& image);
+
+	/**
+	 * Discard level of the image stored for id, -1 if there is none.
+	 */
+	S32 getDiscardLevel(const LLUUID& id);
+
+	bool remove(const LLUUID& id);
+
+	// stats
+	U32 getSlotCount() const { return mSlotCount; }
+	U32 getEntryCount();
+	U32 getEvictionCount() const { return mEvictionCount; }
+
+private:
+	struct SlotHeader;
+
+	SlotHeader* getSlot(U32 slot);
+	U8* getSlotData(U32 slot);
+	S32 findSlot(const LLUUID& id);
+	void setEntryCount(U32 count);
+	bool mapFile(bool discard);
+
+private:
+	LLMutex mMutex;
+	LLMappedFile mFile;
+	std::string mFileName;
+	U32 mResolution;
+	U32 mSlotSize;
+	U32 mSlotCount;
+	U32 mEvictionCount;
+};
+
+#endif // LL_LLFASTCACHETABLE_H
@@ -0,0 +1,354 @@
+/**
+ * @file llfilehandlecache.cpp
+ * @brief Bounded LRU of open file handles with positional reads and writes.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llfilehandlecache.h"
+#include "llstring.h"
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+class LLFileHandlePlatformImpl
+{
+public:
+#if LL_WINDOWS
+	LLFileHandlePlatformImpl() : mFile(INVALID_HANDLE_VALUE) {}
+	HANDLE mFile;
+#else
+	LLFileHandlePlatformImpl() : mFD(-1) {}
+	int mFD;
+#endif
+};
+
+LLFileHandle::LLFileHandle(const std::string& filename)
+:	mImpl(new LLFileHandlePlatformImpl),
+	mFilename(filename),
+	mWritable(false)
+{
+}
+
+LLFileHandle::~LLFileHandle()
+{
+#if LL_WINDOWS
+	if (mImpl->mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mImpl->mFile);
+	}
+#else
+	if (mImpl->mFD >= 0)
+	{
+		::close(mImpl->mFD);
+	}
+#endif
+	delete mImpl;
+}
+
+bool LLFileHandle::open(bool writable)
+{
+	mWritable = writable;
+#if LL_WINDOWS
+	std::wstring wfilename = ll_convert_string_to_wide(mFilename);
+	DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+	DWORD disposition = writable ? OPEN_ALWAYS : OPEN_EXISTING;
+	// Others may delete or rename the file while it is open, as they could
+	// between two fopen() calls
+	mImpl->mFile = CreateFileW(wfilename.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							   NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+	return mImpl->mFile != INVALID_HANDLE_VALUE;
+#else
+	do
+	{
+		mImpl->mFD = ::open(mFilename.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0666);
+	} while (mImpl->mFD < 0 && errno == EINTR);
+	return mImpl->mFD >= 0;
+#endif
+}
+
+int LLFileHandle::getFD() const
+{
+#if LL_WINDOWS
+	return -1;
+#else
+	return mImpl->mFD;
+#endif
+}
+
+S32 LLFileHandle::read(U8* buffer, S32 size, S64 offset)
+{
+	S32 total = 0;
+	while (total < size)
+	{
+#if LL_WINDOWS
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = (DWORD)((offset + total) & 0xFFFFFFFF);
+		overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+		DWORD bytes_read = 0;
+		if (!ReadFile(mImpl->mFile, buffer + total, (DWORD)(size - total), &bytes_read, &overlapped))
+		{
+			if (GetLastError() == ERROR_HANDLE_EOF)
+			{
+				break;
+			}
+			LL_WARNS() << "Unable to read " << mFilename << " error: " << GetLastError() << LL_ENDL;
+			return -1;
+		}
+#else
+		ssize_t bytes_read = pread(mImpl->mFD, buffer + total, size - total, offset + total);
+		if (bytes_read < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			LL_WARNS() << "Unable to read " << mFilename << " errno: " << errno << LL_ENDL;
+			return -1;
+		}
+#endif
+		if (!bytes_read)
+		{
+			break;
+		}
+		total += (S32)bytes_read;
+	}
+	return total;
+}
+
+S32 LLFileHandle::write(const U8* buffer, S32 size, S64 offset)
+{
+	if (!mWritable)
+	{
+		return -1;
+	}
+
+	S32 total = 0;
+	while (total < size)
+	{
+#if LL_WINDOWS
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = (DWORD)((offset + total) & 0xFFFFFFFF);
+		overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+		DWORD bytes_written = 0;
+		if (!WriteFile(mImpl->mFile, buffer + total, (DWORD)(size - total), &bytes_written, &overlapped))
+		{
+			LL_WARNS() << "Unable to write " << mFilename << " error: " << GetLastError() << LL_ENDL;
+			return -1;
+		}
+#else
+		ssize_t bytes_written = pwrite(mImpl->mFD, buffer + total, size - total, offset + total);
+		if (bytes_written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			LL_WARNS() << "Unable to write " << mFilename << " errno: " << errno << LL_ENDL;
+			return -1;
+		}
+#endif
+		if (!bytes_written)
+		{
+			return -1;
+		}
+		total += (S32)bytes_written;
+	}
+	return total;
+}
+
+S64 LLFileHandle::append(const U8* buffer, S32 size)
+{
+	std::lock_guard<std::mutex> lock(mWriteMutex);
+	S64 file_size = getSize();
+	if (file_size < 0 || write(buffer, size, file_size) != size)
+	{
+		return -1;
+	}
+	return file_size + size;
+}
+
+S32 LLFileHandle::replace(const U8* buffer, S32 size)
+{
+	if (!mWritable)
+	{
+		return -1;
+	}
+
+	std::lock_guard<std::mutex> lock(mWriteMutex);
+#if LL_WINDOWS
+	FILE_END_OF_FILE_INFO end_of_file = {};
+	if (!SetFileInformationByHandle(mImpl->mFile, FileEndOfFileInfo, &end_of_file, sizeof(end_of_file)))
+	{
+		LL_WARNS() << "Unable to truncate " << mFilename << " error: " << GetLastError() << LL_ENDL;
+		return -1;
+	}
+#else
+	if (ftruncate(mImpl->mFD, 0) != 0)
+	{
+		LL_WARNS() << "Unable to truncate " << mFilename << " errno: " << errno << LL_ENDL;
+		return -1;
+	}
+#endif
+	return write(buffer, size, 0);
+}
+
+S64 LLFileHandle::getSize()
+{
+#if LL_WINDOWS
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(mImpl->mFile, &file_size))
+	{
+		return -1;
+	}
+	return (S64)file_size.QuadPart;
+#else
+	struct stat st;
+	if (fstat(mImpl->mFD, &st) != 0)
+	{
+		return -1;
+	}
+	return (S64)st.st_size;
+#endif
+}
+
+LLFileHandleCache::LLFileHandleCache(U32 limit)
+:	mLimit(limit),
+	mHits(0),
+	mMisses(0)
+{
+}
+
+LLFileHandleCache::~LLFileHandleCache()
+{
+	clear();
+}
+
+LLFileHandleCache::handle_ptr_t LLFileHandleCache::get(const std::string& filename, bool writable)
+{
+	if (isEnabled())
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		handle_map_t::iterator found = mHandles.find(filename);
+		if (found != mHandles.end() && (!writable || (*found->second)->isWritable()))
+		{
+			mLRU.splice(mLRU.begin(), mLRU, found->second);
+			++mHits;
+			return *found->second;
+		}
+	}
+	++mMisses;
+
+	// Not under the lock, other threads keep using their handles meanwhile
+	handle_ptr_t handle = std::make_shared<LLFileHandle>(filename);
+	if (!handle->open(writable))
+	{
+		return handle_ptr_t();
+	}
+	if (!isEnabled())
+	{
+		return handle;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	handle_map_t::iterator found = mHandles.find(filename);
+	if (found != mHandles.end())
+	{
+		// Another thread opened it too, or this replaces a read-only handle
+		if (!writable && (*found->second)->isWritable())
+		{
+			mLRU.splice(mLRU.begin(), mLRU, found->second);
+			return *found->second;
+		}
+		mLRU.erase(found->second);
+		mHandles.erase(found);
+	}
+	mLRU.push_front(handle);
+	mHandles[filename] = mLRU.begin();
+	trim();
+	return handle;
+}
+
+LLFileHandleCache::handle_ptr_t LLFileHandleCache::find(const std::string& filename)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	handle_map_t::iterator found = mHandles.find(filename);
+	return found != mHandles.end() ? *found->second : handle_ptr_t();
+}
+
+void LLFileHandleCache::close(const std::string& filename)
+{
+	handle_ptr_t handle;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		handle_map_t::iterator found = mHandles.find(filename);
+		if (found == mHandles.end())
+		{
+			return;
+		}
+		handle = *found->second;
+		mLRU.erase(found->second);
+		mHandles.erase(found);
+	}
+	// Closed here, unless still in use, not under the lock
+}
+
+void LLFileHandleCache::clear()
+{
+	lru_list_t handles;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		handles.swap(mLRU);
+		mHandles.clear();
+	}
+}
+
+void LLFileHandleCache::setLimit(U32 limit)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mLimit = limit;
+	trim();
+}
+
+U32 LLFileHandleCache::getHandleCount()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return (U32)mHandles.size();
+}
+
+void LLFileHandleCache::trim()
+{
+	while (mLRU.size() > mLimit)
+	{
+		mHandles.erase(mLRU.back()->getFilename());
+		mLRU.pop_back();
+	}
+}
@@ -0,0 +1,183 @@
+/**
+ * @file llfilehandlecache.h
+ * @brief Bounded LRU of open file handles with positional reads and writes.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFILEHANDLECACHE_H
+#define LL_LLFILEHANDLECACHE_H
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class LLFileHandlePlatformImpl;
+
+/**
+ * @brief An open file that is read and written at explicit offsets.
+ *
+ * There is no file position, so one handle serves any number of threads
+ * at once. Writes that depend on the size of the file (appending,
+ * truncating) are serialized on the handle.
+ */
+class LLFileHandle
+{
+	LOG_CLASS(LLFileHandle);
+public:
+	LLFileHandle(const std::string& filename);
+	~LLFileHandle();
+
+	/**
+	 * Opens the file, creating it when writable and it does not exist.
+	 *
+	 * @return False when the file cannot be opened, true otherwise.
+	 */
+	bool open(bool writable);
+
+	/**
+	 * Reads up to size bytes at offset. Only stops short at the end of the
+	 * file.
+	 *
+	 * @return The number of bytes read, -1 on error.
+	 */
+	S32 read(U8* buffer, S32 size, S64 offset);
+
+	/**
+	 * Writes size bytes at offset.
+	 *
+	 * @return The number of bytes written, -1 on error.
+	 */
+	S32 write(const U8* buffer, S32 size, S64 offset);
+
+	/**
+	 * Writes size bytes after the current end of the file.
+	 *
+	 * @return The size of the file afterwards, -1 on error.
+	 */
+	S64 append(const U8* buffer, S32 size);
+
+	/**
+	 * Truncates the file and writes size bytes at its start, what opening
+	 * it "wb" and writing does.
+	 *
+	 * @return The number of bytes written, -1 on error.
+	 */
+	S32 replace(const U8* buffer, S32 size);
+
+	/**
+	 * @return The current size of the file, -1 on error.
+	 */
+	S64 getSize();
+
+	bool isWritable() const { return mWritable; }
+	const std::string& getFilename() const { return mFilename; }
+
+	/**
+	 * The native descriptor, for backends that issue their own reads.
+	 * -1 on Windows, where only read() is available.
+	 */
+	int getFD() const;
+
+private:
+	LLFileHandlePlatformImpl* mImpl;
+	std::string mFilename;
+	bool mWritable;
+	// Held by the writes that need the size of the file to stay put
+	std::mutex mWriteMutex;
+};
+
+/**
+ * @brief A bounded LRU of open LLFileHandles, keyed by path.
+ *
+ * Reading a header and then a few ranges of a cache file no longer opens
+ * and closes it every time. Handles are shared: one evicted from the cache
+ * while in use is only closed when its last user lets go of it.
+ *
+ * Everything that removes or renames a cached file must close() it first;
+ * on Windows a file cannot be replaced while a handle to it is open. Thread
+ * safe.
+ */
+class LLFileHandleCache
+{
+	LOG_CLASS(LLFileHandleCache);
+public:
+	typedef std::shared_ptr<LLFileHandle> handle_ptr_t;
+
+	/**
+	 * @param[in] limit Handles kept open. With 0 get() still opens handles
+	 *                  but nothing is cached.
+	 */
+	LLFileHandleCache(U32 limit);
+	~LLFileHandleCache();
+
+	/**
+	 * Returns an open handle to filename, from the cache if there is one.
+	 * A cached read-only handle is replaced by a writable one when asked
+	 * for.
+	 *
+	 * @return An empty pointer when the file cannot be opened.
+	 */
+	handle_ptr_t get(const std::string& filename, bool writable);
+
+	/**
+	 * @return The cached handle of filename, without opening one.
+	 */
+	handle_ptr_t find(const std::string& filename);
+
+	/**
+	 * Drops the handle of filename from the cache.
+	 */
+	void close(const std::string& filename);
+
+	/**
+	 * Drops all handles.
+	 */
+	void clear();
+
+	void setLimit(U32 limit);
+	U32 getLimit() const { return mLimit; }
+	bool isEnabled() const { return mLimit > 0; }
+
+	U32 getHandleCount();
+	U64 getHits() const { return mHits; }
+	U64 getMisses() const { return mMisses; }
+
+private:
+	void trim();
+
+	typedef std::list<handle_ptr_t> lru_list_t;
+	typedef std::unordered_map<std::string, lru_list_t::iterator> handle_map_t;
+
+	std::mutex mMutex;
+	// Most recently used first
+	lru_list_t mLRU;
+	handle_map_t mHandles;
+	std::atomic<U32> mLimit;
+	std::atomic<U64> mHits;
+	std::atomic<U64> mMisses;
+};
+
+#endif // LL_LLFILEHANDLECACHE_H
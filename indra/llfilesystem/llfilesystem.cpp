@@ -64,11 +64,14 @@ LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_
         // even though we are reading and not writing because this is the
         // way the cache works - it relies on a valid "last accessed time" for
         // each file so it knows how to remove the oldest, unused files
-        bool exists = gDirUtilp->fileExists(filename);
-        if (exists)
-        {
-            LLDiskCache::getInstance()->updateFileAccessTime(filename);
-        }
+        // <FS:Kadah> Disk cache index, files it does not know are ignored
+        //bool exists = gDirUtilp->fileExists(filename);
+        //if (exists)
+        //{
+        //    LLDiskCache::getInstance()->updateFileAccessTime(filename);
+        //}
+        LLDiskCache::getInstance()->updateFileAccessTime(filename);
+        // </FS:Kadah>
     }
 }
 
@@ -111,7 +114,9 @@ bool LLFileSystem::removeFile(const LLUUID& file_id, const LLAssetType::EType fi
     const std::string extra_info = "";
     const std::string filename =  LLDiskCache::getInstance()->metaDataToFilepath(id_str, file_type, extra_info);
 
+    LLDiskCache::getInstance()->getFileHandles().close(filename); // <FS:Kadah/> Open file handles, Windows cannot delete open files
     LLFile::remove(filename.c_str(), suppress_error);
+    LLDiskCache::getInstance()->removeFileEntry(filename); // <FS:Kadah/> Disk cache index
 
     return true;
 }
@@ -133,6 +138,7 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
     // Rename needs the new file to not exist.
     LLFileSystem::removeFile(new_file_id, new_file_type, ENOENT);
 
+    LLDiskCache::getInstance()->getFileHandles().close(old_filename); // <FS:Kadah/> Open file handles
     if (LLFile::rename(old_filename, new_filename) != 0)
     {
         // We would like to return FALSE here indicating the operation
@@ -141,6 +147,12 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
         //return FALSE;
         LL_WARNS() << "Failed to rename " << old_file_id << " to " << new_id_str << " reason: "  << strerror(errno) << LL_ENDL;
     }
+    // <FS:Kadah> Disk cache index
+    else
+    {
+        LLDiskCache::getInstance()->renameFileEntry(old_filename, new_filename);
+    }
+    // </FS:Kadah>
 
     return TRUE;
 }
@@ -162,6 +174,13 @@ S32 LLFileSystem::getFileSize(const LLUUID& file_id, const LLAssetType::EType fi
     //    file.seekg(0, std::ios::end);
     //    file_size = file.tellg();
     //}
+    // <FS:Kadah> Open file handles, no stat() while it is open anyway
+    LLFileHandleCache::handle_ptr_t handle = LLDiskCache::getInstance()->getFileHandles().find(filename);
+    if (handle)
+    {
+        return (S32)llmax(handle->getSize(), (S64)0);
+    }
+    // </FS:Kadah>
     llstat file_stat;
     if (LLFile::stat(filename, &file_stat) == 0)
     {
@@ -207,6 +226,12 @@ BOOL LLFileSystem::read(U8* buffer, S32 bytes)
     //        success = TRUE;
     //    }
     //}
+    // <FS:Kadah> Open file handles
+    if (LLDiskCache::getInstance()->getFileHandles().isEnabled())
+    {
+        return readHandle(filename, buffer, bytes);
+    }
+    // </FS:Kadah>
     LLFILE* file = LLFile::fopen(filename, "rb");
     if (file)
     {
@@ -250,6 +275,7 @@ BOOL LLFileSystem::write(const U8* buffer, S32 bytes)
     const std::string filename =  LLDiskCache::getInstance()->metaDataToFilepath(id_str, mFileType, extra_info);
 
     BOOL success = FALSE;
+    long file_size = 0; // <FS:Kadah/> Disk cache index
 
     // <FS:Ansariel> IO-streams replacement
     //if (mMode == APPEND)
@@ -301,13 +327,21 @@ BOOL LLFileSystem::write(const U8* buffer, S32 bytes)
     //        success = TRUE;
     //    }
     //}
-    if (mMode == APPEND)
+    // <FS:Kadah> Open file handles
+    //if (mMode == APPEND)
+    if (LLDiskCache::getInstance()->getFileHandles().isEnabled())
+    {
+        success = writeHandle(filename, buffer, bytes, file_size);
+    }
+    else if (mMode == APPEND)
+    // </FS:Kadah>
     {
         LLFILE* ofs = LLFile::fopen(filename, "a+b");
         if (ofs)
         {
             S32 bytes_written = fwrite(buffer, 1, bytes, ofs);
             mPosition = ftell(ofs);
+            file_size = mPosition; // <FS:Kadah/> Disk cache index
             fclose(ofs);
             success = (bytes_written == bytes);
         }
@@ -321,6 +355,10 @@ BOOL LLFileSystem::write(const U8* buffer, S32 bytes)
             {
                 S32 bytes_written = fwrite(buffer, 1, bytes, ofs);
                 mPosition = ftell(ofs);
+                // <FS:Kadah> Disk cache index, written into the middle maybe
+                fseek(ofs, 0, SEEK_END);
+                file_size = ftell(ofs);
+                // </FS:Kadah>
                 fclose(ofs);
                 success = (bytes_written == bytes);
             }
@@ -332,6 +370,7 @@ BOOL LLFileSystem::write(const U8* buffer, S32 bytes)
             {
                 S32 bytes_written = fwrite(buffer, 1, bytes, ofs);
                 mPosition = ftell(ofs);
+                file_size = mPosition; // <FS:Kadah/> Disk cache index
                 fclose(ofs);
                 success = (bytes_written == bytes);
             }
@@ -344,15 +383,117 @@ BOOL LLFileSystem::write(const U8* buffer, S32 bytes)
         {
             S32 bytes_written = fwrite(buffer, 1, bytes, ofs);
             mPosition = ftell(ofs);
+            file_size = mPosition; // <FS:Kadah/> Disk cache index
             fclose(ofs);
             success = (bytes_written == bytes);
         }
     }
     // </FS:Ansariel>
 
+    // <FS:Kadah> Disk cache index
+    if (success)
+    {
+        LLDiskCache::getInstance()->updateFileSize(filename, file_size);
+    }
+    // </FS:Kadah>
+
     return success;
 }
 
+// <FS:Kadah> Open file handles
+BOOL LLFileSystem::readHandle(const std::string& filename, U8* buffer, S32 bytes)
+{
+    LLFileHandleCache::handle_ptr_t handle = LLDiskCache::getInstance()->getFileHandles().get(filename, false);
+    if (!handle)
+    {
+        return FALSE;
+    }
+
+    S32 bytes_read = handle->read(buffer, bytes, mPosition);
+    if (bytes_read < 0)
+    {
+        return FALSE;
+    }
+    mBytesRead = bytes_read;
+    mPosition += mBytesRead;
+    // Short reads succeed, as they do in read()
+    return mBytesRead > 0;
+}
+
+// Same modes as write(): APPEND adds to the end, READ_WRITE writes at the
+// current position, WRITE replaces the whole file.
+BOOL LLFileSystem::writeHandle(const std::string& filename, const U8* buffer, S32 bytes, long& file_size)
+{
+    LLFileHandleCache::handle_ptr_t handle = LLDiskCache::getInstance()->getFileHandles().get(filename, true);
+    if (!handle)
+    {
+        return FALSE;
+    }
+
+    if (mMode == APPEND)
+    {
+        S64 new_size = handle->append(buffer, bytes);
+        if (new_size < 0)
+        {
+            return FALSE;
+        }
+        mPosition = (S32)new_size;
+        file_size = (long)new_size;
+    }
+    else if (mMode == READ_WRITE)
+    {
+        if (handle->write(buffer, bytes, mPosition) != bytes)
+        {
+            return FALSE;
+        }
+        mPosition += bytes;
+        file_size = (long)handle->getSize();
+    }
+    else
+    {
+        if (handle->replace(buffer, bytes) != bytes)
+        {
+            return FALSE;
+        }
+        mPosition = bytes;
+        file_size = bytes;
+    }
+    return TRUE;
+}
+
+// static
+LLAsyncFileReader::Request LLFileSystem::makeReadRequest(const LLUUID& file_id, const LLAssetType::EType file_type,
+                                                         S32 offset, S32 bytes, U8* buffer)
+{
+    std::string id_str;
+    file_id.toString(id_str);
+    const std::string extra_info = "";
+
+    LLAsyncFileReader::Request request;
+    request.mFilename = LLDiskCache::getInstance()->metaDataToFilepath(id_str, file_type, extra_info);
+    request.mOffset = offset;
+    request.mSize = bytes;
+    request.mBuffer = buffer;
+    // Read, as far as purging is concerned, see the constructor
+    LLDiskCache::getInstance()->updateFileAccessTime(request.mFilename);
+    return request;
+}
+
+// static
+void LLFileSystem::readBatch(LLAsyncFileReader::request_list_t& requests)
+{
+    LL_PROFILE_ZONE_COLOR(tracy::Color::Gold);
+    LLDiskCache::getInstance()->getFileReader().read(requests);
+}
+
+// static
+bool LLFileSystem::readBatchAsync(const LLAsyncFileReader::request_list_ptr_t& requests,
+                                  const LLAsyncFileReader::callback_t& callback)
+{
+    return LLDiskCache::getInstance()->getFileReader().readAsync(requests, callback);
+}
+// </FS:Kadah>
+
 BOOL LLFileSystem::seek(S32 offset, S32 origin)
 {
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
@@ -59,6 +59,26 @@ class LLFileSystem
                                const LLUUID& new_file_id, const LLAssetType::EType new_file_type);
         static S32 getFileSize(const LLUUID& file_id, const LLAssetType::EType file_type);
 
+        // <FS:Kadah> Batched reads
+        /**
+         * Range of a cache file to read with readBatch()
+         */
+        static LLAsyncFileReader::Request makeReadRequest(const LLUUID& file_id, const LLAssetType::EType file_type,
+                                                          S32 offset, S32 bytes, U8* buffer);
+
+        /**
+         * Reads all the ranges at once, through io_uring where there is one
+         */
+        static void readBatch(LLAsyncFileReader::request_list_t& requests);
+
+        /**
+         * Reads the ranges on a worker thread and calls callback there when
+         * they are all done.
+         */
+        static bool readBatchAsync(const LLAsyncFileReader::request_list_ptr_t& requests,
+                                   const LLAsyncFileReader::callback_t& callback);
+        // </FS:Kadah>
+
     public:
         static const S32 READ;
         static const S32 WRITE;
@@ -71,6 +91,11 @@ class LLFileSystem
         S32     mPosition;
         S32     mMode;
         S32     mBytesRead;
+        // <FS:Kadah> Open file handles
+    private:
+        BOOL readHandle(const std::string& filename, U8* buffer, S32 bytes);
+        BOOL writeHandle(const std::string& filename, const U8* buffer, S32 bytes, long& file_size);
+        // </FS:Kadah>
 //private:
 //    static const std::string idToFilepath(const std::string id, LLAssetType::EType at);
 };
@@ -0,0 +1,291 @@
+/**
+ * @file llmappedfile.cpp
+ * @brief Read/write memory mapping of a regular file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmappedfile.h"
+#include "llstring.h"
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+class LLMappedFilePlatformImpl
+{
+public:
+#if LL_WINDOWS
+	LLMappedFilePlatformImpl() : mFile(INVALID_HANDLE_VALUE), mMapping(NULL) {}
+	HANDLE mFile;
+	HANDLE mMapping;
+#else
+	LLMappedFilePlatformImpl() : mFD(-1) {}
+	int mFD;
+#endif
+};
+
+LLMappedFile::LLMappedFile()
+:	mImpl(new LLMappedFilePlatformImpl),
+	mData(NULL),
+	mSize(0),
+	mWritable(false)
+{
+}
+
+LLMappedFile::~LLMappedFile()
+{
+	close();
+	delete mImpl;
+}
+
+bool LLMappedFile::open(const std::string& filename, size_t size, bool writable)
+{
+	close();
+
+	mFilename = filename;
+	mWritable = writable;
+	mSize = size;
+
+#if LL_WINDOWS
+	std::wstring wfilename = ll_convert_string_to_wide(filename);
+	DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+	DWORD disposition = writable ? OPEN_ALWAYS : OPEN_EXISTING;
+	mImpl->mFile = CreateFileW(wfilename.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							   NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mImpl->mFile == INVALID_HANDLE_VALUE)
+	{
+		LL_WARNS() << "Unable to open " << filename << " error: " << GetLastError() << LL_ENDL;
+		return false;
+	}
+	if (!mSize)
+	{
+		LARGE_INTEGER file_size;
+		if (GetFileSizeEx(mImpl->mFile, &file_size))
+		{
+			mSize = (size_t)file_size.QuadPart;
+		}
+	}
+#else
+	mImpl->mFD = ::open(filename.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0600);
+	if (mImpl->mFD < 0)
+	{
+		LL_WARNS() << "Unable to open " << filename << " errno: " << errno << LL_ENDL;
+		return false;
+	}
+	if (!mSize)
+	{
+		struct stat st;
+		if (fstat(mImpl->mFD, &st) == 0)
+		{
+			mSize = (size_t)st.st_size;
+		}
+	}
+#endif
+
+	if (!map())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void LLMappedFile::close()
+{
+	unmap();
+#if LL_WINDOWS
+	if (mImpl->mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mImpl->mFile);
+		mImpl->mFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (mImpl->mFD >= 0)
+	{
+		::close(mImpl->mFD);
+		mImpl->mFD = -1;
+	}
+#endif
+	mSize = 0;
+}
+
+bool LLMappedFile::resize(size_t size)
+{
+	unmap();
+	mSize = size;
+	if (!map())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void LLMappedFile::flush(size_t offset, size_t length)
+{
+	if (!mData || !mWritable || offset >= mSize)
+	{
+		return;
+	}
+	if (!length || offset + length > mSize)
+	{
+		length = mSize - offset;
+	}
+#if LL_WINDOWS
+	FlushViewOfFile(mData + offset, length);
+#else
+	// msync() wants a page aligned address
+	static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t aligned = offset - (offset % page_size);
+	msync(mData + aligned, length + (offset - aligned), MS_ASYNC);
+#endif
+}
+
+bool LLMappedFile::map()
+{
+	if (!mSize)
+	{
+		// Nothing to map; an empty read-only file is not an error.
+		return !mWritable;
+	}
+
+#if LL_WINDOWS
+	LARGE_INTEGER file_size;
+	file_size.QuadPart = (LONGLONG)mSize;
+	if (mWritable)
+	{
+		// Extending a file that is not marked sparse reserves its clusters,
+		// a full disk fails here instead of in a write through the view.
+		LARGE_INTEGER current_size;
+		if (!GetFileSizeEx(mImpl->mFile, &current_size) || current_size.QuadPart < file_size.QuadPart)
+		{
+			if (!SetFilePointerEx(mImpl->mFile, file_size, NULL, FILE_BEGIN) || !SetEndOfFile(mImpl->mFile))
+			{
+				LL_WARNS() << "Unable to grow " << mFilename << " to " << mSize << " error: " << GetLastError() << LL_ENDL;
+				return false;
+			}
+		}
+	}
+	mImpl->mMapping = CreateFileMappingW(mImpl->mFile, NULL, mWritable ? PAGE_READWRITE : PAGE_READONLY,
+										 file_size.HighPart, file_size.LowPart, NULL);
+	if (!mImpl->mMapping)
+	{
+		LL_WARNS() << "CreateFileMapping failed for " << mFilename << " error: " << GetLastError() << LL_ENDL;
+		return false;
+	}
+	mData = (U8*)MapViewOfFile(mImpl->mMapping, mWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, mSize);
+	if (!mData)
+	{
+		LL_WARNS() << "MapViewOfFile failed for " << mFilename << " error: " << GetLastError() << LL_ENDL;
+		CloseHandle(mImpl->mMapping);
+		mImpl->mMapping = NULL;
+		return false;
+	}
+#else
+	if (mWritable && !allocate())
+	{
+		return false;
+	}
+	void* addr = ::mmap(NULL, mSize, mWritable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, mImpl->mFD, 0);
+	if (addr == MAP_FAILED)
+	{
+		LL_WARNS() << "mmap failed for " << mFilename << " errno: " << errno << LL_ENDL;
+		return false;
+	}
+	mData = (U8*)addr;
+#endif
+	return true;
+}
+
+#if !LL_WINDOWS
+bool LLMappedFile::allocate()
+{
+	// A page of a sparse file only gets its block when first written, and
+	// when the disk is full by then the write through the mapping raises
+	// SIGBUS. Allocate every block now, holes left by an older file too.
+	struct stat st;
+	if (fstat(mImpl->mFD, &st) != 0)
+	{
+		LL_WARNS() << "Unable to stat " << mFilename << " errno: " << errno << LL_ENDL;
+		return false;
+	}
+#if LL_DARWIN
+	if ((size_t)st.st_size < mSize)
+	{
+		fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)(mSize - st.st_size), 0 };
+		if (fcntl(mImpl->mFD, F_PREALLOCATE, &store) == -1)
+		{
+			store.fst_flags = F_ALLOCATEALL;
+			if (fcntl(mImpl->mFD, F_PREALLOCATE, &store) == -1)
+			{
+				LL_WARNS() << "Unable to allocate " << mSize << " bytes for " << mFilename << " errno: " << errno << LL_ENDL;
+				return false;
+			}
+		}
+		if (ftruncate(mImpl->mFD, (off_t)mSize) != 0)
+		{
+			LL_WARNS() << "Unable to grow " << mFilename << " to " << mSize << " errno: " << errno << LL_ENDL;
+			return false;
+		}
+	}
+#else
+	// posix_fallocate() returns the error instead of setting errno, ENOSPC
+	// on a full disk
+	int err = posix_fallocate(mImpl->mFD, 0, (off_t)mSize);
+	if (err)
+	{
+		LL_WARNS() << "Unable to allocate " << mSize << " bytes for " << mFilename << " error: " << err << LL_ENDL;
+		return false;
+	}
+#endif
+	return true;
+}
+#endif
+
+void LLMappedFile::unmap()
+{
+	if (!mData)
+	{
+		return;
+	}
+#if LL_WINDOWS
+	UnmapViewOfFile(mData);
+	if (mImpl->mMapping)
+	{
+		CloseHandle(mImpl->mMapping);
+		mImpl->mMapping = NULL;
+	}
+#else
+	::munmap(mData, mSize);
+#endif
+	mData = NULL;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file llmappedfile.h
+ * @brief Read/write memory mapping of a regular file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMAPPEDFILE_H
+#define LL_LLMAPPEDFILE_H
+
+class LLMappedFilePlatformImpl;
+
+/**
+ * @brief LLMappedFile maps a whole file into the address space of the viewer.
+ *
+ * The file is created if needed and grown (never shrunk) to the requested
+ * size when opened for writing. Its disk space is allocated up front, so a
+ * full disk fails open() or resize() rather than a later write through the
+ * mapping. Pages are faulted in by the OS on demand. Not thread safe: callers
+ * that share a mapping between threads must provide their own locking.
+ */
+class LLMappedFile
+{
+	LOG_CLASS(LLMappedFile);
+public:
+	LLMappedFile();
+	~LLMappedFile();
+
+	/**
+	 * Opens and maps filename.
+	 *
+	 * @param[in] filename UTF-8 path of the file to map.
+	 * @param[in] size Size in bytes of the mapping. When writable, the file is
+	 *                 extended to at least this size. When 0, the current file
+	 *                 size is used.
+	 * @param[in] writable Map read/write (and create the file) or read-only.
+	 *
+	 * @return False on failure, true otherwise.
+	 */
+	bool open(const std::string& filename, size_t size, bool writable);
+
+	/**
+	 * Unmaps and closes the file. Dirty pages are left to the OS to write back.
+	 */
+	void close();
+
+	/**
+	 * Remaps the file with a new size. Any pointer previously obtained through
+	 * getData() is invalidated.
+	 *
+	 * @return False on failure (the file is then closed), true otherwise.
+	 */
+	bool resize(size_t size);
+
+	/**
+	 * Asks the OS to write dirty pages in [offset, offset + length) back to
+	 * disk. A length of 0 flushes the whole mapping.
+	 */
+	void flush(size_t offset = 0, size_t length = 0);
+
+	bool isOpen() const			{ return mData != NULL; }
+	bool isWritable() const		{ return mWritable; }
+	U8* getData()				{ return mData; }
+	const U8* getData() const	{ return mData; }
+	size_t getSize() const		{ return mSize; }
+	const std::string& getFilename() const { return mFilename; }
+
+private:
+	bool map();
+	void unmap();
+#if !LL_WINDOWS
+	// Gives every block of a writable file its disk space
+	bool allocate();
+#endif
+
+	LLMappedFilePlatformImpl* mImpl;
+	std::string mFilename;
+	U8* mData;
+	size_t mSize;
+	bool mWritable;
+};
+
+#endif // LL_LLMAPPEDFILE_H
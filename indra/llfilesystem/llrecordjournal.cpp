@@ -0,0 +1,248 @@
+/**
+ * @file llrecordjournal.cpp
+ * @brief Append-only file of records keyed by a 32 bit id.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llrecordjournal.h"
+#include "llfile.h"
+
+#include <map>
+
+// File layout:
+//  JournalHeader
+//  records: RecordHeader + mSize bytes of data, mSize 0 removes mKey
+
+static const U32 JOURNAL_MAGIC = 0x4a52524c; // "LRRJ"
+static const U32 JOURNAL_VERSION = 1;
+// Nothing we journal comes close, anything larger is damage.
+static const U32 MAX_RECORD_SIZE = 16 * 1024 * 1024;
+// Superseded records tolerated on top of the live ones before rewriting.
+static const U32 COMPACTION_SLACK = 64;
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+struct JournalHeader
+{
+	U32 mMagic;
+	U32 mVersion;
+	LLUUID mID;
+};
+
+struct RecordHeader
+{
+	U32 mKey;
+	U32 mSize;
+};
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+
+void LLRecordJournal::Batch::add(U32 key, const U8* data, U32 size)
+{
+	llassert(size > 0);
+	RecordHeader header = { key, size };
+	mData.append((const char*)&header, sizeof(header));
+	mData.append((const char*)data, size);
+	++mRecords;
+}
+
+void LLRecordJournal::Batch::remove(U32 key)
+{
+	RecordHeader header = { key, 0 };
+	mData.append((const char*)&header, sizeof(header));
+	++mRecords;
+}
+
+//static
+bool LLRecordJournal::read(const std::string& filename, const LLUUID& id, const visitor_t& visitor, Stats* stats)
+{
+	Stats local_stats;
+	Stats& st = stats ? *stats : local_stats;
+	st = Stats();
+
+	// One read for the whole file, the records are parsed in memory.
+	std::string data;
+	{
+		LLUniqueFile file = LLFile::fopen(filename, "rb");
+		if (!file)
+		{
+			return false;
+		}
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size < (long)sizeof(JournalHeader))
+		{
+			return false;
+		}
+		data.resize(size);
+		if (fread(&data[0], 1, size, file) != (size_t)size)
+		{
+			LL_WARNS() << "Unable to read " << filename << LL_ENDL;
+			return false;
+		}
+	}
+	st.mBytes = data.size();
+
+	const U8* pos = (const U8*)data.data();
+	const U8* end = pos + data.size();
+
+	JournalHeader header;
+	memcpy(&header, pos, sizeof(header));
+	pos += sizeof(header);
+	if (header.mMagic != JOURNAL_MAGIC || header.mVersion != JOURNAL_VERSION)
+	{
+		LL_WARNS() << filename << " is not a journal this viewer can read" << LL_ENDL;
+		return false;
+	}
+	if (header.mID != id)
+	{
+		LL_INFOS() << filename << " belongs to " << header.mID << ", not " << id << LL_ENDL;
+		return false;
+	}
+
+	// Latest record of every key, pointing into data.
+	typedef std::map<U32, std::pair<const U8*, U32> > latest_map_t;
+	latest_map_t latest;
+	while (pos < end)
+	{
+		RecordHeader record;
+		if ((size_t)(end - pos) < sizeof(record))
+		{
+			st.mTruncated = true;
+			break;
+		}
+		memcpy(&record, pos, sizeof(record));
+		if (record.mSize > MAX_RECORD_SIZE)
+		{
+			LL_WARNS() << "Bogus record size " << record.mSize << " in " << filename << LL_ENDL;
+			return false;
+		}
+		if ((size_t)(end - pos) - sizeof(record) < record.mSize)
+		{
+			st.mTruncated = true;
+			break;
+		}
+		pos += sizeof(record);
+		++st.mRecords;
+		if (record.mSize)
+		{
+			latest[record.mKey] = std::make_pair(pos, record.mSize);
+		}
+		else
+		{
+			latest.erase(record.mKey);
+		}
+		pos += record.mSize;
+	}
+	if (st.mTruncated)
+	{
+		LL_WARNS() << filename << " ends in a partial record, ignoring it" << LL_ENDL;
+	}
+
+	st.mLive = (U32)latest.size();
+	for (const latest_map_t::value_type& entry : latest)
+	{
+		if (!visitor(entry.first, entry.second.first, entry.second.second))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool write_journal(LLFILE* file, const LLUUID& id, const std::string& data, bool with_header)
+{
+	if (with_header)
+	{
+		JournalHeader header = { JOURNAL_MAGIC, JOURNAL_VERSION, id };
+		if (fwrite(&header, sizeof(header), 1, file) != 1)
+		{
+			return false;
+		}
+	}
+	return data.empty() || fwrite(data.data(), 1, data.size(), file) == data.size();
+}
+
+//static
+bool LLRecordJournal::append(const std::string& filename, const LLUUID& id, const Batch& batch)
+{
+	if (!LLFile::isfile(filename))
+	{
+		return rewrite(filename, id, batch);
+	}
+	LLUniqueFile file = LLFile::fopen(filename, "ab");
+	if (!file)
+	{
+		LL_WARNS() << "Unable to open " << filename << " for appending" << LL_ENDL;
+		return false;
+	}
+	if (!write_journal(file, id, batch.mData, false))
+	{
+		LL_WARNS() << "Unable to append to " << filename << LL_ENDL;
+		return false;
+	}
+	return true;
+}
+
+//static
+bool LLRecordJournal::rewrite(const std::string& filename, const LLUUID& id, const Batch& batch)
+{
+	std::string temp_name = filename + ".tmp";
+	{
+		LLUniqueFile file = LLFile::fopen(temp_name, "wb");
+		if (!file)
+		{
+			LL_WARNS() << "Unable to create " << temp_name << LL_ENDL;
+			return false;
+		}
+		if (!write_journal(file, id, batch.mData, true))
+		{
+			LL_WARNS() << "Unable to write " << temp_name << LL_ENDL;
+			file.close();
+			LLFile::remove(temp_name);
+			return false;
+		}
+	}
+#if LL_WINDOWS
+	// _wrename() does not replace existing files.
+	LLFile::remove(filename, ENOENT);
+#endif
+	if (LLFile::rename(temp_name, filename) != 0)
+	{
+		LLFile::remove(temp_name);
+		return false;
+	}
+	return true;
+}
+
+//static
+bool LLRecordJournal::needsCompaction(U32 records, U32 live)
+{
+	return records > 2 * live + COMPACTION_SLACK;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file llrecordjournal.h
+ * @brief Append-only file of records keyed by a 32 bit id.
+ *
+ * @Description:
+ * A journal file starts with an id (the owner's idea of what the file belongs
+ * to) followed by records of key, size and data. Writing a record for a key
+ * supersedes all earlier records for it; a record of size 0 removes the key.
+ * Only changed records need to be appended, and a reader replays the file to
+ * get the latest data of every live key. Once the superseded records outweigh
+ * the live ones the owner rewrites the file with just the live records.
+ *
+ * The functions here are stateless and can be called from any thread, as long
+ * as the caller makes sure only one of them works on a given file at a time.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRECORDJOURNAL_H
+#define LL_LLRECORDJOURNAL_H
+
+#include "lluuid.h"
+
+#include <functional>
+
+class LLRecordJournal
+{
+	LOG_CLASS(LLRecordJournal);
+public:
+	/**
+	 * Records to append to a journal or to rewrite it with.
+	 */
+	class Batch
+	{
+	public:
+		Batch() : mRecords(0) {}
+
+		void add(U32 key, const U8* data, U32 size);
+		void remove(U32 key);
+
+		bool empty() const { return !mRecords; }
+		U32 getRecordCount() const { return mRecords; }
+		size_t getBytes() const { return mData.size(); }
+
+	private:
+		friend class LLRecordJournal;
+		std::string mData;
+		U32 mRecords;
+	};
+
+	struct Stats
+	{
+		Stats() : mRecords(0), mLive(0), mBytes(0), mTruncated(false) {}
+		U32 mRecords;	// records in the file, superseded ones included
+		U32 mLive;		// keys left after replaying them
+		size_t mBytes;
+		bool mTruncated; // the file ends in a partial record
+	};
+
+	// Return false to stop reading.
+	typedef std::function<bool(U32 key, const U8* data, U32 size)> visitor_t;
+
+	/**
+	 * Replays filename and calls visitor once per live key, in key order,
+	 * with the latest data written for it. A partial record at the end (an
+	 * append cut short by a crash) is ignored and flagged in stats; the file
+	 * should then be rewritten before anything is appended to it again.
+	 * Returns false if the file is missing, belongs to another id, is
+	 * damaged, or visitor stopped the read.
+	 */
+	static bool read(const std::string& filename, const LLUUID& id, const visitor_t& visitor, Stats* stats = nullptr);
+
+	/**
+	 * Appends batch to filename, creating the file for id if needed.
+	 */
+	static bool append(const std::string& filename, const LLUUID& id, const Batch& batch);
+
+	/**
+	 * Replaces filename with a journal holding only batch. The new file is
+	 * written next to the old one and renamed over it.
+	 */
+	static bool rewrite(const std::string& filename, const LLUUID& id, const Batch& batch);
+
+	/**
+	 * True once a journal of records records with live keys left should be
+	 * rewritten rather than appended to.
+	 */
+	static bool needsCompaction(U32 records, U32 live);
+};
+
+#endif // LL_LLRECORDJOURNAL_H
@@ -0,0 +1,637 @@
+/**
+ * @file llslabstore.cpp
+ * @brief UUID keyed blob store living in a single memory mapped arena file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llslabstore.h"
+#include "lldir.h"
+#include "llfile.h"
+
+// Arena layout:
+// <name>.slabs
+//  mSlabs.size() slabs of mSlabSize bytes. Each slab is a sequence of
+//  RecordHeader + blob (padded to RECORD_ALIGN) followed by a zeroed header.
+// <name>.slabindex
+//  IndexHeader, IndexSlab[num_slabs], IndexEntry[num_entries]
+
+static const U32 SLAB_RECORD_MAGIC = 0x424c5331; // "1SLB"
+static const U32 SLAB_INDEX_MAGIC = 0x58444953;  // "SIDX"
+static const U32 SLAB_INDEX_VERSION = 1;
+static const U32 RECORD_ALIGN = 16;
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+struct RecordHeader
+{
+	U32 mMagic;
+	U32 mSize;
+	U32 mSeq;
+	U32 mPad;
+	LLUUID mID;
+};
+
+struct IndexHeader
+{
+	U32 mMagic;
+	U32 mVersion;
+	U32 mSlabSize;
+	U32 mNumSlabs;
+	U32 mCurrentSlab;
+	U32 mSequence;
+	U32 mNumEntries;
+	U32 mClean; // 0 while the store is open, so a crash forces a rescan
+};
+
+struct IndexSlab
+{
+	U32 mUsed;
+	U32 mLastAccess;
+};
+
+struct IndexEntry
+{
+	LLUUID mID;
+	U32 mSlab;
+	U32 mOffset;
+	U32 mSize;
+	U32 mSeq;
+};
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+
+static const U32 RECORD_HEADER_SIZE = sizeof(RecordHeader);
+
+static inline U32 record_span(U32 size)
+{
+	return RECORD_HEADER_SIZE + ((size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1));
+}
+
+static inline U32 now_seconds()
+{
+	return (U32)time(NULL);
+}
+
+LLSlabStore::LLSlabStore()
+:	mSlabSize(DEFAULT_SLAB_SIZE),
+	mCurrentSlab(0),
+	mSequence(0),
+	mEvictionCount(0),
+	mHasEvicted(false)
+{
+}
+
+LLSlabStore::~LLSlabStore()
+{
+	close();
+}
+
+//static
+bool LLSlabStore::exists(const std::string& dir, const std::string& name)
+{
+	return LLFile::isfile(gDirUtilp->add(dir, name + ".slabs"));
+}
+
+//static
+void LLSlabStore::removeFiles(const std::string& dir, const std::string& name)
+{
+	LLFile::remove(gDirUtilp->add(dir, name + ".slabs"), ENOENT);
+	LLFile::remove(gDirUtilp->add(dir, name + ".slabindex"), ENOENT);
+}
+
+bool LLSlabStore::open(const std::string& dir, const std::string& name, U64 capacity, U32 slab_size)
+{
+	LLMutexLock lock(&mMutex);
+
+	mArenaFileName = gDirUtilp->add(dir, name + ".slabs");
+	mIndexFileName = gDirUtilp->add(dir, name + ".slabindex");
+	mSlabSize = llmax(slab_size, (U32)(RECORD_HEADER_SIZE * 2));
+
+#if ADDRESS_SIZE == 32
+	// The whole arena is mapped at once; keep 32 bits builds within reason.
+	capacity = llmin(capacity, (U64)512 * 1024 * 1024);
+#endif
+	U32 num_slabs = (U32)llmax(capacity / mSlabSize, (U64)2);
+	mSlabs.clear();
+	mSlabs.resize(num_slabs);
+	mIndex.clear();
+	mEvicted.clear();
+	mHasEvicted = false;
+	mCurrentSlab = 0;
+	mSequence = 0;
+
+	bool have_index = loadIndex();
+	bool rescan = !have_index && exists(dir, name);
+	if (!mapArena(!have_index && !rescan))
+	{
+		mSlabs.clear();
+		mIndex.clear();
+		return false;
+	}
+	if (rescan)
+	{
+		rebuildIndex();
+	}
+
+	// Mark the index as stale while we run. It gets rewritten on close().
+	saveIndex(false);
+
+	LL_INFOS("SlabStore") << "Opened " << mArenaFileName << " slabs: " << mSlabs.size()
+						  << " x " << (mSlabSize >> 20) << " MB, entries: " << mIndex.size()
+						  << (rescan ? " (rebuilt)" : "") << LL_ENDL;
+	return true;
+}
+
+void LLSlabStore::close()
+{
+	LLMutexLock lock(&mMutex);
+	if (!mArena.isOpen())
+	{
+		return;
+	}
+	mArena.flush();
+	saveIndex(true);
+	mArena.close();
+	mIndex.clear();
+	mSlabs.clear();
+}
+
+void LLSlabStore::clear()
+{
+	LLMutexLock lock(&mMutex);
+	bool was_open = mArena.isOpen();
+	mArena.close();
+	LLFile::remove(mArenaFileName, ENOENT);
+	LLFile::remove(mIndexFileName, ENOENT);
+
+	for (U32 i = 0; i < mSlabs.size(); ++i)
+	{
+		mSlabs[i] = Slab();
+	}
+	mIndex.clear();
+	mEvicted.clear();
+	mHasEvicted = false;
+	mCurrentSlab = 0;
+	mSequence = 0;
+
+	if (was_open && mapArena(true))
+	{
+		saveIndex(false);
+	}
+}
+
+bool LLSlabStore::write(const LLUUID& id, const U8* data, S32 size)
+{
+	if (size <= 0 || !data)
+	{
+		return false;
+	}
+
+	LLMutexLock lock(&mMutex);
+	if (!mArena.isOpen())
+	{
+		return false;
+	}
+
+	index_map_t::iterator iter = mIndex.find(id);
+	if (iter != mIndex.end())
+	{
+		dropLocation(id, iter->second);
+		mIndex.erase(iter);
+	}
+
+	U32 slab, offset;
+	if (!allocate(record_span((U32)size), slab, offset))
+	{
+		return false;
+	}
+
+	U8* dst = getSlabData(slab) + offset;
+	RecordHeader header;
+	header.mMagic = SLAB_RECORD_MAGIC;
+	header.mSize = (U32)size;
+	header.mSeq = ++mSequence;
+	header.mPad = 0;
+	header.mID = id;
+	memcpy(dst + RECORD_HEADER_SIZE, data, size);
+	memcpy(dst, &header, RECORD_HEADER_SIZE);
+
+	Slab& s = mSlabs[slab];
+	s.mUsed = offset + record_span((U32)size);
+	s.mLive += (U32)size;
+	s.mLastAccess = now_seconds();
+	s.mIDs.push_back(id);
+	writeTerminator(slab, s.mUsed);
+
+	Location& loc = mIndex[id];
+	loc.mSlab = slab;
+	loc.mOffset = offset;
+	loc.mSize = (U32)size;
+	loc.mSeq = header.mSeq;
+	return true;
+}
+
+S32 LLSlabStore::read(const LLUUID& id, U8* dst, S32 offset, S32 size)
+{
+	LLMutexLock lock(&mMutex);
+	index_map_t::const_iterator iter = mIndex.find(id);
+	if (iter == mIndex.end() || offset < 0)
+	{
+		return -1;
+	}
+	const Location& loc = iter->second;
+	if ((U32)offset >= loc.mSize)
+	{
+		return 0;
+	}
+	S32 bytes = llmin(size, (S32)(loc.mSize - offset));
+	memcpy(dst, getSlabData(loc.mSlab) + loc.mOffset + RECORD_HEADER_SIZE + offset, bytes);
+	mSlabs[loc.mSlab].mLastAccess = now_seconds();
+	return bytes;
+}
+
+S32 LLSlabStore::getSize(const LLUUID& id)
+{
+	LLMutexLock lock(&mMutex);
+	index_map_t::const_iterator iter = mIndex.find(id);
+	return iter == mIndex.end() ? -1 : (S32)iter->second.mSize;
+}
+
+bool LLSlabStore::contains(const LLUUID& id)
+{
+	LLMutexLock lock(&mMutex);
+	return mIndex.find(id) != mIndex.end();
+}
+
+bool LLSlabStore::remove(const LLUUID& id)
+{
+	LLMutexLock lock(&mMutex);
+	index_map_t::iterator iter = mIndex.find(id);
+	if (iter == mIndex.end())
+	{
+		return false;
+	}
+	dropLocation(id, iter->second);
+	mIndex.erase(iter);
+	return true;
+}
+
+void LLSlabStore::takeEvicted(std::vector<LLUUID>& ids)
+{
+	LLMutexLock lock(&mMutex);
+	if (ids.empty())
+	{
+		ids.swap(mEvicted);
+	}
+	else
+	{
+		ids.insert(ids.end(), mEvicted.begin(), mEvicted.end());
+		mEvicted.clear();
+	}
+	mHasEvicted = false;
+}
+
+U64 LLSlabStore::getLiveBytes()
+{
+	LLMutexLock lock(&mMutex);
+	U64 total = 0;
+	for (const Slab& s : mSlabs)
+	{
+		total += s.mLive;
+	}
+	return total;
+}
+
+U32 LLSlabStore::getEntryCount()
+{
+	LLMutexLock lock(&mMutex);
+	return (U32)mIndex.size();
+}
+
+//----------------------------------------------------------------------------
+// mMutex must be locked for the following functions!
+
+bool LLSlabStore::allocate(U32 needed, U32& slab, U32& offset)
+{
+	// Keep room for the terminating header, unless the record fills the slab exactly.
+	if (needed > mSlabSize)
+	{
+		LL_DEBUGS("SlabStore") << "Blob of " << needed << " bytes does not fit in a slab" << LL_ENDL;
+		return false;
+	}
+
+	Slab& current = mSlabs[mCurrentSlab];
+	if (current.mUsed + needed > mSlabSize)
+	{
+		// Prefer a slab that has never been written to, otherwise recycle the oldest one.
+		U32 next = (U32)mSlabs.size();
+		for (U32 i = 0; i < mSlabs.size(); ++i)
+		{
+			U32 candidate = (mCurrentSlab + 1 + i) % mSlabs.size();
+			if (candidate != mCurrentSlab && mSlabs[candidate].mUsed == 0)
+			{
+				next = candidate;
+				break;
+			}
+		}
+		if (next == mSlabs.size())
+		{
+			next = pickVictim();
+			evictSlab(next);
+		}
+		mCurrentSlab = next;
+	}
+
+	slab = mCurrentSlab;
+	offset = mSlabs[mCurrentSlab].mUsed;
+	return true;
+}
+
+U32 LLSlabStore::pickVictim() const
+{
+	U32 victim = (mCurrentSlab + 1) % mSlabs.size();
+	for (U32 i = 0; i < mSlabs.size(); ++i)
+	{
+		if (i != mCurrentSlab && mSlabs[i].mLastAccess < mSlabs[victim].mLastAccess)
+		{
+			victim = i;
+		}
+	}
+	return victim;
+}
+
+void LLSlabStore::evictSlab(U32 slab)
+{
+	Slab& s = mSlabs[slab];
+	for (const LLUUID& id : s.mIDs)
+	{
+		index_map_t::iterator iter = mIndex.find(id);
+		if (iter != mIndex.end() && iter->second.mSlab == slab)
+		{
+			mIndex.erase(iter);
+			mEvicted.push_back(id);
+		}
+	}
+	mHasEvicted = !mEvicted.empty();
+	++mEvictionCount;
+	LL_DEBUGS("SlabStore") << "Evicted slab " << slab << " (" << s.mIDs.size() << " records, "
+						   << s.mLive << " live bytes)" << LL_ENDL;
+	resetSlab(slab);
+}
+
+void LLSlabStore::resetSlab(U32 slab)
+{
+	mSlabs[slab] = Slab();
+	writeTerminator(slab, 0);
+}
+
+void LLSlabStore::writeTerminator(U32 slab, U32 offset)
+{
+	if (offset + RECORD_HEADER_SIZE <= mSlabSize)
+	{
+		memset(getSlabData(slab) + offset, 0, RECORD_HEADER_SIZE);
+	}
+}
+
+void LLSlabStore::dropLocation(const LLUUID& id, const Location& loc)
+{
+	Slab& s = mSlabs[loc.mSlab];
+	s.mLive -= llmin(s.mLive, loc.mSize);
+}
+
+bool LLSlabStore::mapArena(bool discard)
+{
+	if (discard)
+	{
+		LLFile::remove(mArenaFileName, ENOENT);
+	}
+	size_t arena_size = (size_t)mSlabSize * mSlabs.size();
+	if (!mArena.open(mArenaFileName, arena_size, true))
+	{
+		LL_WARNS("SlabStore") << "Unable to map slab arena " << mArenaFileName << LL_ENDL;
+		return false;
+	}
+	if (discard)
+	{
+		for (U32 i = 0; i < mSlabs.size(); ++i)
+		{
+			writeTerminator(i, 0);
+		}
+	}
+	return true;
+}
+
+bool LLSlabStore::loadIndex()
+{
+	LLUniqueFile file = LLFile::fopen(mIndexFileName, "rb");
+	if (!file)
+	{
+		return false;
+	}
+
+	IndexHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1
+		|| header.mMagic != SLAB_INDEX_MAGIC
+		|| header.mVersion != SLAB_INDEX_VERSION)
+	{
+		return false;
+	}
+	if (header.mSlabSize != mSlabSize || header.mNumSlabs != mSlabs.size())
+	{
+		LL_INFOS("SlabStore") << "Slab geometry changed, discarding " << mArenaFileName << LL_ENDL;
+		file.close();
+		removeFiles(gDirUtilp->getDirName(mArenaFileName), gDirUtilp->getBaseFileName(mArenaFileName, true));
+		return false;
+	}
+	if (!header.mClean)
+	{
+		LL_INFOS("SlabStore") << "Slab index was not closed cleanly, rebuilding" << LL_ENDL;
+		return false;
+	}
+
+	std::vector<IndexSlab> slabs(header.mNumSlabs);
+	if (fread(&slabs[0], sizeof(IndexSlab), slabs.size(), file) != slabs.size())
+	{
+		return false;
+	}
+	for (U32 i = 0; i < slabs.size(); ++i)
+	{
+		mSlabs[i].mUsed = llmin(slabs[i].mUsed, mSlabSize);
+		mSlabs[i].mLastAccess = slabs[i].mLastAccess;
+	}
+
+	std::vector<IndexEntry> entries(header.mNumEntries);
+	if (header.mNumEntries
+		&& fread(&entries[0], sizeof(IndexEntry), entries.size(), file) != entries.size())
+	{
+		for (U32 i = 0; i < mSlabs.size(); ++i)
+		{
+			mSlabs[i] = Slab();
+		}
+		return false;
+	}
+
+	mIndex.reserve(entries.size());
+	for (const IndexEntry& entry : entries)
+	{
+		if (entry.mSlab >= mSlabs.size()
+			|| entry.mOffset + record_span(entry.mSize) > mSlabs[entry.mSlab].mUsed)
+		{
+			continue;
+		}
+		Location& loc = mIndex[entry.mID];
+		loc.mSlab = entry.mSlab;
+		loc.mOffset = entry.mOffset;
+		loc.mSize = entry.mSize;
+		loc.mSeq = entry.mSeq;
+		mSlabs[entry.mSlab].mLive += entry.mSize;
+		mSlabs[entry.mSlab].mIDs.push_back(entry.mID);
+	}
+	mCurrentSlab = llmin(header.mCurrentSlab, (U32)mSlabs.size() - 1);
+	mSequence = header.mSequence;
+	return true;
+}
+
+bool LLSlabStore::saveIndex(bool clean)
+{
+	LLUniqueFile file = LLFile::fopen(mIndexFileName, "wb");
+	if (!file)
+	{
+		LL_WARNS("SlabStore") << "Unable to write " << mIndexFileName << LL_ENDL;
+		return false;
+	}
+
+	IndexHeader header;
+	header.mMagic = SLAB_INDEX_MAGIC;
+	header.mVersion = SLAB_INDEX_VERSION;
+	header.mSlabSize = mSlabSize;
+	header.mNumSlabs = (U32)mSlabs.size();
+	header.mCurrentSlab = mCurrentSlab;
+	header.mSequence = mSequence;
+	header.mNumEntries = clean ? (U32)mIndex.size() : 0;
+	header.mClean = clean ? 1 : 0;
+	if (fwrite(&header, sizeof(header), 1, file) != 1)
+	{
+		return false;
+	}
+	if (!clean)
+	{
+		return true;
+	}
+
+	std::vector<IndexSlab> slabs(mSlabs.size());
+	for (U32 i = 0; i < mSlabs.size(); ++i)
+	{
+		slabs[i].mUsed = mSlabs[i].mUsed;
+		slabs[i].mLastAccess = mSlabs[i].mLastAccess;
+	}
+	fwrite(&slabs[0], sizeof(IndexSlab), slabs.size(), file);
+
+	std::vector<IndexEntry> entries;
+	entries.reserve(mIndex.size());
+	for (const index_map_t::value_type& pair : mIndex)
+	{
+		IndexEntry entry;
+		entry.mID = pair.first;
+		entry.mSlab = pair.second.mSlab;
+		entry.mOffset = pair.second.mOffset;
+		entry.mSize = pair.second.mSize;
+		entry.mSeq = pair.second.mSeq;
+		entries.push_back(entry);
+	}
+	if (!entries.empty()
+		&& fwrite(&entries[0], sizeof(IndexEntry), entries.size(), file) != entries.size())
+	{
+		LL_WARNS("SlabStore") << "Short write on " << mIndexFileName << LL_ENDL;
+		return false;
+	}
+	return true;
+}
+
+void LLSlabStore::rebuildIndex()
+{
+	mIndex.clear();
+	mSequence = 0;
+
+	// (newest record sequence, slab) used to recover the slab write order
+	std::vector<std::pair<U32, U32> > slab_order;
+	slab_order.reserve(mSlabs.size());
+
+	for (U32 slab = 0; slab < mSlabs.size(); ++slab)
+	{
+		Slab& s = mSlabs[slab];
+		s = Slab();
+		U8* base = getSlabData(slab);
+		U32 offset = 0;
+		U32 slab_seq = 0;
+		while (offset + RECORD_HEADER_SIZE <= mSlabSize)
+		{
+			RecordHeader header;
+			memcpy(&header, base + offset, RECORD_HEADER_SIZE);
+			if (header.mMagic != SLAB_RECORD_MAGIC
+				|| !header.mSize
+				|| offset + record_span(header.mSize) > mSlabSize)
+			{
+				break;
+			}
+
+			index_map_t::iterator iter = mIndex.find(header.mID);
+			if (iter == mIndex.end() || iter->second.mSeq < header.mSeq)
+			{
+				if (iter != mIndex.end())
+				{
+					dropLocation(header.mID, iter->second);
+				}
+				Location& loc = mIndex[header.mID];
+				loc.mSlab = slab;
+				loc.mOffset = offset;
+				loc.mSize = header.mSize;
+				loc.mSeq = header.mSeq;
+				s.mLive += header.mSize;
+				s.mIDs.push_back(header.mID);
+			}
+			slab_seq = llmax(slab_seq, header.mSeq);
+			offset += record_span(header.mSize);
+		}
+		s.mUsed = offset;
+		mSequence = llmax(mSequence, slab_seq);
+		if (offset)
+		{
+			slab_order.push_back(std::make_pair(slab_seq, slab));
+		}
+	}
+
+	// Access times are lost; the write order is the best approximation we have.
+	std::sort(slab_order.begin(), slab_order.end());
+	U32 stamp = now_seconds() - (U32)slab_order.size();
+	for (U32 i = 0; i < slab_order.size(); ++i)
+	{
+		mSlabs[slab_order[i].second].mLastAccess = stamp + i;
+	}
+	mCurrentSlab = slab_order.empty() ? 0 : slab_order.back().second;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file llslabstore.h
+ * @brief UUID keyed blob store living in a single memory mapped arena file.
+ *
+ * @Description:
+ * The arena is split into fixed size slabs. New blobs are appended to the
+ * current slab; once it is full the store moves on to an unused slab or, if
+ * there is none left, evicts the least recently accessed slab as a whole.
+ * This turns cache trimming into a handful of index updates instead of
+ * unlinking thousands of small files, and turns reads and writes into a
+ * memcpy to or from the mapping.
+ *
+ * Every blob is prefixed in the arena by a small record header (magic, size,
+ * sequence number and UUID) so that the in-memory index can be rebuilt by
+ * scanning the slabs if the viewer did not shut down cleanly. On a clean
+ * close the index is saved next to the arena and reloaded on the next run.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSLABSTORE_H
+#define LL_LLSLABSTORE_H
+
+#include "llmappedfile.h"
+#include "llmutex.h"
+#include "lluuid.h"
+
+#include <atomic>
+#include <unordered_map>
+
+class LLSlabStore
+{
+	LOG_CLASS(LLSlabStore);
+public:
+	static const U32 DEFAULT_SLAB_SIZE = 32 * 1024 * 1024;
+
+	LLSlabStore();
+	~LLSlabStore();
+
+	/**
+	 * True if an arena named name already exists in dir.
+	 */
+	static bool exists(const std::string& dir, const std::string& name);
+
+	/**
+	 * Removes the arena and index files of the store named name in dir.
+	 */
+	static void removeFiles(const std::string& dir, const std::string& name);
+
+	/**
+	 * Opens (or creates) the store. capacity is rounded down to a whole number
+	 * of slabs. If the existing arena was created with a different geometry
+	 * it is discarded.
+	 */
+	bool open(const std::string& dir, const std::string& name, U64 capacity, U32 slab_size = DEFAULT_SLAB_SIZE);
+
+	/**
+	 * Saves the index and unmaps the arena.
+	 */
+	void close();
+
+	/**
+	 * Drops every blob. The arena files are removed and recreated empty.
+	 */
+	void clear();
+
+	bool isOpen() const { return mArena.isOpen(); }
+
+	/**
+	 * Stores size bytes for id, replacing any previous blob for that id.
+	 * May evict a whole slab to make room; evicted ids can be collected with
+	 * takeEvicted().
+	 */
+	bool write(const LLUUID& id, const U8* data, S32 size);
+
+	/**
+	 * Copies up to size bytes of the blob for id, starting at offset, into dst.
+	 * Returns the number of bytes copied or -1 if id is not in the store.
+	 */
+	S32 read(const LLUUID& id, U8* dst, S32 offset, S32 size);
+
+	/**
+	 * Returns the size of the blob for id, or -1 if it is not in the store.
+	 */
+	S32 getSize(const LLUUID& id);
+
+	bool contains(const LLUUID& id);
+
+	/**
+	 * Forgets the blob for id. The space is reclaimed when its slab is evicted.
+	 */
+	bool remove(const LLUUID& id);
+
+	/**
+	 * Moves the ids dropped by slab evictions since the last call into ids.
+	 */
+	void takeEvicted(std::vector<LLUUID>& ids);
+	// Safe to poll from any thread, the ids themselves are taken under the lock
+	bool hasEvicted() const { return mHasEvicted.load(std::memory_order_acquire); }
+
+	// stats
+	U64 getCapacity() const { return (U64)mSlabSize * mSlabs.size(); }
+	U64 getLiveBytes();
+	U32 getEntryCount();
+	U32 getEvictionCount() const { return mEvictionCount; }
+
+private:
+	struct Location
+	{
+		U32 mSlab;
+		U32 mOffset; // of the record header, within the slab
+		U32 mSize;   // of the blob, header excluded
+		U32 mSeq;
+	};
+
+	struct Slab
+	{
+		Slab() : mUsed(0), mLive(0), mLastAccess(0) {}
+		U32 mUsed;       // bytes appended so far
+		U32 mLive;       // bytes still referenced from the index
+		U32 mLastAccess; // seconds since epoch
+		std::vector<LLUUID> mIDs; // may contain stale ids, checked against the index
+	};
+
+	U8* getSlabData(U32 slab) { return mArena.getData() + (size_t)slab * mSlabSize; }
+	bool allocate(U32 needed, U32& slab, U32& offset);
+	U32 pickVictim() const;
+	void evictSlab(U32 slab);
+	void resetSlab(U32 slab);
+	void writeTerminator(U32 slab, U32 offset);
+	void dropLocation(const LLUUID& id, const Location& loc);
+
+	bool loadIndex();
+	bool saveIndex(bool clean);
+	void rebuildIndex();
+	bool mapArena(bool discard);
+
+private:
+	LLMutex mMutex;
+	LLMappedFile mArena;
+	std::string mArenaFileName;
+	std::string mIndexFileName;
+	U32 mSlabSize;
+	U32 mCurrentSlab;
+	U32 mSequence;
+	U32 mEvictionCount;
+	std::atomic<bool> mHasEvicted;
+	std::vector<Slab> mSlabs;
+	typedef std::unordered_map<LLUUID, Location> index_map_t;
+	index_map_t mIndex;
+	std::vector<LLUUID> mEvicted;
+};
+
+#endif // LL_LLSLABSTORE_H
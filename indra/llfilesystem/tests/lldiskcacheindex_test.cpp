@@ -0,0 +1,275 @@
+/**
+ * @file lldiskcacheindex_test.cpp
+ * @brief LLDiskCacheIndex test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../lldiskcacheindex.h"
+#include "../lldir.h"
+#include "llfile.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLDiskCacheIndexFixture
+	{
+		LLDiskCacheIndexFixture()
+		:	mFileName(gDirUtilp->add(LLFile::tmpdir(), "lldiskcacheindex_test_" + LLUUID::generateNewID().asString()))
+		{
+		}
+
+		~LLDiskCacheIndexFixture()
+		{
+			LLFile::remove(mFileName, ENOENT);
+			LLFile::remove(mFileName + ".lock", ENOENT);
+			LLFile::remove(mFileName + ".stale", ENOENT);
+		}
+
+		static std::string makeName(U32 i)
+		{
+			return llformat("%x/sl_cache_%08x-0000-0000-0000-000000000000_0.asset", i % 16, i);
+		}
+
+		std::string mFileName;
+	};
+	typedef test_group<LLDiskCacheIndexFixture> LLDiskCacheIndex_factory;
+	typedef LLDiskCacheIndex_factory::object LLDiskCacheIndex_t;
+	LLDiskCacheIndex_factory tf("LLDiskCacheIndex");
+
+	template<> template<>
+	void LLDiskCacheIndex_t::test<1>()
+	{
+		set_test_name("writes, reads, removes and renames keep the totals");
+		LLDiskCacheIndex index;
+		for (U32 i = 0; i < 100; ++i)
+		{
+			index.update(makeName(i), 1000 + i, 10);
+		}
+		ensure_equals("entries", index.getEntryCount(), 100U);
+		ensure_equals("size", index.getTotalSize(), (U64)(100 * 1000 + 99 * 50));
+
+		index.update(makeName(7), 10, 20);
+		LLDiskCacheIndex::Entry entry;
+		ensure("rewritten", index.getEntry(makeName(7), entry));
+		ensure_equals("new size", entry.mSize, (U64)10);
+		ensure_equals("written time", entry.mAccessTime, (S64)20);
+		ensure_equals("size after rewrite", index.getTotalSize(), (U64)(100 * 1000 + 99 * 50 - 1007 + 10));
+
+		index.touch(makeName(8), 30);
+		index.touch(makeName(8), 25);
+		index.touch("not/in/the/index", 30);
+		ensure("touched", index.getEntry(makeName(8), entry) && entry.mAccessTime == 30);
+		ensure_equals("touch adds nothing", index.getEntryCount(), 100U);
+
+		index.rename(makeName(8), "renamed");
+		ensure("old name gone", !index.getEntry(makeName(8), entry));
+		ensure("new name", index.getEntry("renamed", entry) && entry.mSize == 1008 && entry.mAccessTime == 30);
+
+		const U64 size = index.getTotalSize();
+		index.remove("renamed");
+		index.remove("renamed");
+		ensure_equals("removed", index.getEntryCount(), 99U);
+		ensure_equals("size after remove", index.getTotalSize(), size - 1008);
+
+		index.clear();
+		ensure_equals("cleared", index.getEntryCount(), 0U);
+		ensure_equals("cleared size", index.getTotalSize(), (U64)0);
+	}
+
+	template<> template<>
+	void LLDiskCacheIndex_t::test<2>()
+	{
+		set_test_name("eviction takes the least recently used files and leaves static ones");
+		LLDiskCacheIndex index;
+		for (U32 i = 0; i < 5000; ++i)
+		{
+			// access times out of order, so that eviction has to sort
+			index.update(makeName(i), 100, (S64)((i * 7919) % 5000));
+		}
+		// the oldest files, but shipped with the viewer
+		for (U32 i = 0; i < 5000; ++i)
+		{
+			if ((i * 7919) % 5000 < 10)
+			{
+				index.setFlags(makeName(i), LLDiskCacheIndex::FLAG_STATIC);
+			}
+		}
+		ensure_equals("static", index.getStaticCount(), 10U);
+
+		LLDiskCacheIndex::entry_list_t evicted;
+		index.evict(600 * 100 + 50, evicted);
+		ensure_equals("evicted", evicted.size(), (size_t)(5000 - 600));
+		ensure_equals("at the target", index.getTotalSize(), (U64)(600 * 100));
+		for (size_t i = 0; i < evicted.size(); ++i)
+		{
+			ensure("oldest first", !i || evicted[i - 1].mAccessTime <= evicted[i].mAccessTime);
+			ensure("not static", !(evicted[i].mFlags & LLDiskCacheIndex::FLAG_STATIC));
+			ensure("evicted are older than the kept ones", evicted[i].mAccessTime < 5000 - 590);
+		}
+		ensure_equals("static kept", index.getStaticCount(), 10U);
+
+		evicted.clear();
+		index.evict(index.getTotalSize(), evicted);
+		ensure("nothing above the target", evicted.empty());
+
+		// only static files left above the target
+		index.evict(0, evicted);
+		ensure_equals("all but static", index.getEntryCount(), 10U);
+
+		// freed slots are used again
+		for (U32 i = 0; i < 5000; ++i)
+		{
+			index.update(makeName(100000 + i), 1, 6000);
+		}
+		ensure_equals("refilled", index.getEntryCount(), 5010U);
+	}
+
+	template<> template<>
+	void LLDiskCacheIndex_t::test<3>()
+	{
+		set_test_name("a closed index opens again, an open one does not");
+		{
+			LLDiskCacheIndex index;
+			ensure("no journal yet", !index.open(mFileName));
+			for (U32 i = 0; i < 300; ++i)
+			{
+				index.update(makeName(i), i + 1, i);
+			}
+			index.setFlags(makeName(3), LLDiskCacheIndex::FLAG_STATIC);
+			ensure("flush", index.flush());
+			index.remove(makeName(4));
+			index.touch(makeName(5), 1000);
+			index.close();
+		}
+
+		{
+			LLDiskCacheIndex index;
+			ensure("open", index.open(mFileName));
+			ensure_equals("entries", index.getEntryCount(), 299U);
+			ensure_equals("size", index.getTotalSize(), (U64)(300 * 301 / 2 - 5));
+			LLDiskCacheIndex::Entry entry;
+			ensure("removed stays removed", !index.getEntry(makeName(4), entry));
+			ensure("touch kept", index.getEntry(makeName(5), entry) && entry.mAccessTime == 1000);
+			ensure("flags kept", index.getEntry(makeName(3), entry) && entry.mFlags == LLDiskCacheIndex::FLAG_STATIC);
+			index.update("added", 1, 1);
+			ensure("flush", index.flush());
+		}
+
+		// as if the viewer crashed, gone without close() and its lock released
+		LLDiskCacheIndex crashed;
+		ensure("left open", !crashed.open(mFileName));
+		ensure_equals("empty", crashed.getEntryCount(), 0U);
+
+		LLDiskCacheIndex::entry_list_t entries(1);
+		entries[0].mName = "scanned";
+		entries[0].mSize = 42;
+		crashed.rebuild(entries);
+		crashed.close();
+
+		LLDiskCacheIndex rebuilt;
+		ensure("rebuilt", rebuilt.open(mFileName));
+		ensure_equals("rebuilt entries", rebuilt.getEntryCount(), 1U);
+		ensure_equals("rebuilt size", rebuilt.getTotalSize(), (U64)42);
+		rebuilt.close();
+	}
+
+	template<> template<>
+	void LLDiskCacheIndex_t::test<4>()
+	{
+		set_test_name("the journal is compacted as accesses pile up");
+		LLDiskCacheIndex index;
+		index.open(mFileName);
+		for (U32 i = 0; i < 1000; ++i)
+		{
+			index.update(makeName(i), 100, 0);
+		}
+		index.flush();
+		llstat stat_data;
+		ensure("journal", LLFile::stat(mFileName, &stat_data) == 0);
+		const S64 full_size = stat_data.st_size;
+
+		for (S64 now = 1; now <= 50; ++now)
+		{
+			for (U32 i = 0; i < 1000; i += 3)
+			{
+				index.touch(makeName(i), now);
+			}
+			ensure("flush", index.flush());
+		}
+		ensure("stat", LLFile::stat(mFileName, &stat_data) == 0);
+		ensure("bounded", stat_data.st_size < 3 * full_size);
+		index.close();
+
+		ensure("open", index.open(mFileName));
+		LLDiskCacheIndex::Entry entry;
+		ensure("touched", index.getEntry(makeName(999), entry) && entry.mAccessTime == 50);
+		ensure("untouched", index.getEntry(makeName(998), entry) && entry.mAccessTime == 0);
+		index.close();
+	}
+
+	template<> template<>
+	void LLDiskCacheIndex_t::test<5>()
+	{
+		set_test_name("a second viewer gets a read-only index and the owner rescans after it");
+		LLDiskCacheIndex owner;
+		owner.open(mFileName);
+		for (U32 i = 0; i < 10; ++i)
+		{
+			owner.update(makeName(i), 100, 0);
+		}
+		ensure("flush", owner.flush());
+		ensure("owner", !owner.isReadOnly());
+		llstat stat_data;
+		ensure("journal", LLFile::stat(mFileName, &stat_data) == 0);
+		const S64 owner_size = stat_data.st_size;
+
+		{
+			LLDiskCacheIndex second;
+			ensure("open while the owner runs", second.open(mFileName));
+			ensure("read-only", second.isReadOnly());
+			ensure_equals("owner's entries", second.getEntryCount(), 10U);
+			second.update("added", 1, 1);
+			second.remove(makeName(0));
+			ensure("flush", second.flush());
+			ensure("stat", LLFile::stat(mFileName, &stat_data) == 0);
+			ensure_equals("journal untouched", (S64)stat_data.st_size, owner_size);
+			second.close();
+		}
+		ensure("marker", LLFile::isfile(mFileName + ".stale"));
+		owner.close();
+
+		LLDiskCacheIndex next;
+		ensure("rescan", !next.open(mFileName));
+		ensure("owns it", !next.isReadOnly());
+		ensure("marker gone", !LLFile::isfile(mFileName + ".stale"));
+		next.update("scanned", 1, 1);
+		next.close();
+		ensure("trusted again", next.open(mFileName));
+		ensure_equals("scanned entries", next.getEntryCount(), 1U);
+		next.close();
+	}
+}
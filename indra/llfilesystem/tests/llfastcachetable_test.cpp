@@ -0,0 +1,196 @@
+/**
+ * @file llfastcachetable_test.cpp
+ * @brief LLFastCacheTable test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llfastcachetable.h"
+#include "llfile.h"
+#include "llmemory.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLFastCacheTableFixture
+	{
+		LLFastCacheTableFixture()
+		:	mFileName(std::string(LLFile::tmpdir()) + "llfastcachetable_test_" + LLUUID::generateNewID().asString())
+		{
+		}
+
+		~LLFastCacheTableFixture()
+		{
+			LLFile::remove(mFileName, ENOENT);
+		}
+
+		static LLFastCacheTable::Image makeImage(S32 width, S32 height, S32 components, S32 discard)
+		{
+			LLFastCacheTable::Image image;
+			image.mWidth = width;
+			image.mHeight = height;
+			image.mComponents = components;
+			image.mDiscardLevel = discard;
+			return image;
+		}
+
+		static std::vector<U8> makePixels(const LLFastCacheTable::Image& image, U8 seed)
+		{
+			std::vector<U8> pixels(image.getDataSize());
+			for (size_t i = 0; i < pixels.size(); ++i)
+			{
+				pixels[i] = (U8)(seed + i * 13);
+			}
+			return pixels;
+		}
+
+		static bool matches(LLFastCacheTable& table, const LLUUID& id, const LLFastCacheTable::Image& expected,
+							const std::vector<U8>& pixels)
+		{
+			LLFastCacheTable::Image image;
+			U8* data = table.read(id, image);
+			if (!data)
+			{
+				return false;
+			}
+			bool same = image.mWidth == expected.mWidth && image.mHeight == expected.mHeight
+				&& image.mComponents == expected.mComponents && image.mDiscardLevel == expected.mDiscardLevel
+				&& !memcmp(data, &pixels[0], pixels.size());
+			ll_aligned_free_16(data);
+			return same;
+		}
+
+		std::string mFileName;
+	};
+	typedef test_group<LLFastCacheTableFixture> LLFastCacheTable_factory;
+	typedef LLFastCacheTable_factory::object LLFastCacheTable_t;
+	LLFastCacheTable_factory tf("LLFastCacheTable");
+
+	template<> template<>
+	void LLFastCacheTable_t::test<1>()
+	{
+		set_test_name("write and read back");
+		LLFastCacheTable table;
+		ensure("open", table.open(mFileName, 64, 4 * 1024 * 1024));
+		ensure_equals("resolution", table.getResolution(), 64U);
+		ensure_equals("max data size", table.getMaxDataSize(), 64 * 64 * 4);
+
+		LLUUID id = LLUUID::generateNewID();
+		LLFastCacheTable::Image image = makeImage(64, 32, 3, 4);
+		std::vector<U8> pixels = makePixels(image, 7);
+		ensure("write", table.write(id, image, &pixels[0]));
+		ensure("content", matches(table, id, image, pixels));
+		ensure_equals("discard", table.getDiscardLevel(id), 4);
+		ensure_equals("one entry", table.getEntryCount(), 1U);
+
+		LLFastCacheTable::Image missing;
+		ensure("miss", table.read(LLUUID::generateNewID(), missing) == NULL);
+
+		LLFastCacheTable::Image oversized = makeImage(128, 128, 4, 3);
+		std::vector<U8> big = makePixels(oversized, 1);
+		ensure("oversized rejected", !table.write(LLUUID::generateNewID(), oversized, &big[0]));
+	}
+
+	template<> template<>
+	void LLFastCacheTable_t::test<2>()
+	{
+		set_test_name("keeps the most detailed image");
+		LLFastCacheTable table;
+		ensure("open", table.open(mFileName, 64, 4 * 1024 * 1024));
+
+		LLUUID id = LLUUID::generateNewID();
+		LLFastCacheTable::Image small = makeImage(16, 16, 4, 6);
+		LLFastCacheTable::Image large = makeImage(64, 64, 4, 4);
+		std::vector<U8> small_pixels = makePixels(small, 1);
+		std::vector<U8> large_pixels = makePixels(large, 2);
+
+		table.write(id, small, &small_pixels[0]);
+		table.write(id, large, &large_pixels[0]);
+		ensure("upgraded", matches(table, id, large, large_pixels));
+		ensure("write of less detail succeeds", table.write(id, small, &small_pixels[0]));
+		ensure("not downgraded", matches(table, id, large, large_pixels));
+		ensure_equals("one entry", table.getEntryCount(), 1U);
+
+		ensure("remove", table.remove(id));
+		ensure_equals("gone", table.getDiscardLevel(id), -1);
+		ensure_equals("no entries", table.getEntryCount(), 0U);
+		table.write(id, small, &small_pixels[0]);
+		ensure("written again", matches(table, id, small, small_pixels));
+	}
+
+	template<> template<>
+	void LLFastCacheTable_t::test<3>()
+	{
+		set_test_name("eviction stays within the table");
+		LLFastCacheTable table;
+		// Smallest table there is
+		ensure("open", table.open(mFileName, 16, 0));
+		U32 slots = table.getSlotCount();
+
+		LLFastCacheTable::Image image = makeImage(16, 16, 4, 2);
+		std::vector<U8> pixels = makePixels(image, 3);
+		LLUUID last;
+		for (U32 i = 0; i < slots * 8; ++i)
+		{
+			last = LLUUID::generateNewID();
+			ensure("write", table.write(last, image, &pixels[0]));
+		}
+		ensure("bounded", table.getEntryCount() <= slots);
+		ensure("evicted", table.getEvictionCount() > 0);
+		ensure("newest kept", matches(table, last, image, pixels));
+	}
+
+	template<> template<>
+	void LLFastCacheTable_t::test<4>()
+	{
+		set_test_name("persistence and geometry changes");
+		LLUUID id = LLUUID::generateNewID();
+		LLFastCacheTable::Image image = makeImage(32, 32, 4, 5);
+		std::vector<U8> pixels = makePixels(image, 9);
+		{
+			LLFastCacheTable table;
+			ensure("open", table.open(mFileName, 64, 2 * 1024 * 1024));
+			table.write(id, image, &pixels[0]);
+		}
+		{
+			LLFastCacheTable table;
+			ensure("reopen", table.open(mFileName, 64, 2 * 1024 * 1024));
+			ensure("kept across runs", matches(table, id, image, pixels));
+			ensure_equals("entry count kept", table.getEntryCount(), 1U);
+
+			table.clear();
+			ensure("still open", table.isOpen());
+			ensure_equals("cleared", table.getDiscardLevel(id), -1);
+			table.write(id, image, &pixels[0]);
+		}
+		{
+			LLFastCacheTable table;
+			ensure("open at another resolution", table.open(mFileName, 128, 2 * 1024 * 1024));
+			ensure_equals("resolution change discards", table.getDiscardLevel(id), -1);
+			ensure_equals("no entries", table.getEntryCount(), 0U);
+		}
+	}
+}
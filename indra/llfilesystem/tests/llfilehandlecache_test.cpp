@@ -0,0 +1,293 @@
+/**
+ * @file llfilehandlecache_test.cpp
+ * @brief LLFileHandleCache and LLAsyncFileReader test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llasyncfilereader.h"
+#include "../llfilehandlecache.h"
+#include "../lldir.h"
+#include "llfile.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLFileHandleCacheFixture
+	{
+		LLFileHandleCacheFixture()
+		:	mDir(gDirUtilp->add(LLFile::tmpdir(), "llfilehandlecache_test_" + LLUUID::generateNewID().asString()))
+		{
+			LLFile::mkdir(mDir);
+		}
+
+		~LLFileHandleCacheFixture()
+		{
+			for (const std::string& filename : mFiles)
+			{
+				LLFile::remove(filename, ENOENT);
+			}
+			LLFile::rmdir(mDir);
+		}
+
+		// Bytes of file i are (i + offset) & 0xff
+		std::string makeFile(U32 i, S32 size)
+		{
+			const std::string filename = gDirUtilp->add(mDir, llformat("file_%u", i));
+			std::vector<U8> data(size);
+			for (S32 j = 0; j < size; ++j)
+			{
+				data[j] = (U8)(i + j);
+			}
+			LLUniqueFile file = LLFile::fopen(filename, "wb");
+			fwrite(data.data(), 1, size, file);
+			file.close();
+			mFiles.push_back(filename);
+			return filename;
+		}
+
+		static bool checkRange(U32 i, const U8* buffer, S64 offset, S32 size)
+		{
+			for (S32 j = 0; j < size; ++j)
+			{
+				if (buffer[j] != (U8)(i + offset + j))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Reads ranges all over 40 files, some past their end and one of
+		// a file that does not exist
+		void checkReader(LLAsyncFileReader& reader)
+		{
+			const S32 FILES = 40;
+			for (U32 i = 0; i < FILES; ++i)
+			{
+				makeFile(i, 1000 + i * 10);
+			}
+
+			std::vector<std::vector<U8>> buffers;
+			LLAsyncFileReader::request_list_ptr_t requests = std::make_shared<LLAsyncFileReader::request_list_t>();
+			for (U32 i = 0; i < FILES * 3; ++i)
+			{
+				LLAsyncFileReader::Request request;
+				request.mFilename = mFiles[i % FILES];
+				request.mOffset = (i * 37) % 900;
+				request.mSize = 64 + (i % 3) * 100;
+				buffers.emplace_back(request.mSize);
+				requests->push_back(request);
+			}
+			LLAsyncFileReader::Request missing;
+			missing.mFilename = gDirUtilp->add(mDir, "missing");
+			missing.mSize = 10;
+			buffers.emplace_back(10);
+			requests->push_back(missing);
+			for (size_t i = 0; i < requests->size(); ++i)
+			{
+				(*requests)[i].mBuffer = buffers[i].data();
+			}
+
+			reader.read(*requests);
+			for (U32 i = 0; i < FILES * 3; ++i)
+			{
+				const LLAsyncFileReader::Request& request = (*requests)[i];
+				const S32 file_size = 1000 + (i % FILES) * 10;
+				const S32 expected = llmin(request.mSize, (S32)(file_size - request.mOffset));
+				ensure_equals("bytes read", request.mBytesRead, expected);
+				ensure("data", checkRange(i % FILES, request.mBuffer, request.mOffset, expected));
+			}
+			ensure_equals("missing file", requests->back().mBytesRead, -1);
+
+			for (LLAsyncFileReader::Request& request : *requests)
+			{
+				request.mBytesRead = 0;
+				memset(request.mBuffer, 0, request.mSize);
+			}
+			std::mutex mutex;
+			std::condition_variable done;
+			bool finished = false;
+			ensure("posted", reader.readAsync(requests, [&](const LLAsyncFileReader::request_list_ptr_t& batch)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					finished = true;
+					done.notify_one();
+				}));
+			std::unique_lock<std::mutex> lock(mutex);
+			ensure("finished", done.wait_for(lock, std::chrono::seconds(10), [&]() { return finished; }));
+			for (U32 i = 0; i < FILES * 3; ++i)
+			{
+				const LLAsyncFileReader::Request& request = (*requests)[i];
+				ensure("async data", request.mBytesRead > 0 && checkRange(i % FILES, request.mBuffer, request.mOffset, request.mBytesRead));
+			}
+			ensure_equals("async missing file", requests->back().mBytesRead, -1);
+		}
+
+		std::string mDir;
+		std::vector<std::string> mFiles;
+	};
+	typedef test_group<LLFileHandleCacheFixture> LLFileHandleCache_factory;
+	typedef LLFileHandleCache_factory::object LLFileHandleCache_t;
+	LLFileHandleCache_factory tf("LLFileHandleCache");
+
+	template<> template<>
+	void LLFileHandleCache_t::test<1>()
+	{
+		set_test_name("positional reads and writes in every write mode");
+		const std::string filename = gDirUtilp->add(mDir, "written");
+		mFiles.push_back(filename);
+		LLFileHandleCache cache(4);
+
+		ensure("missing file not opened for reading", !cache.get(filename, false));
+		LLFileHandleCache::handle_ptr_t handle = cache.get(filename, true);
+		ensure("created", handle && handle->isWritable());
+
+		const U8 data[] = "0123456789";
+		ensure_equals("replace", handle->replace(data, 10), 10);
+		ensure_equals("append", handle->append(data, 5), (S64)15);
+		ensure_equals("write in the middle", handle->write((const U8*)"ab", 2, 3), 2);
+		ensure_equals("size", handle->getSize(), (S64)15);
+
+		U8 buffer[32] = {};
+		ensure_equals("read past the end is short", handle->read(buffer, 32, 8), 7);
+		ensure("read data", memcmp(buffer, "8901234", 7) == 0);
+		ensure_equals("read at the end", handle->read(buffer, 4, 15), 0);
+
+		ensure_equals("replace truncates", handle->replace(data, 3), 3);
+		ensure_equals("replaced size", handle->getSize(), (S64)3);
+
+		ensure("cached", cache.find(filename) == handle);
+		ensure("writable handle serves reads", cache.get(filename, false) == handle);
+		cache.close(filename);
+		ensure("closed", !cache.find(filename));
+		ensure_equals("still usable by its holder", handle->read(buffer, 3, 0), 3);
+	}
+
+	template<> template<>
+	void LLFileHandleCache_t::test<2>()
+	{
+		set_test_name("least recently used handles are closed first");
+		LLFileHandleCache cache(3);
+		std::vector<std::string> files;
+		for (U32 i = 0; i < 5; ++i)
+		{
+			files.push_back(makeFile(i, 100));
+		}
+
+		LLFileHandleCache::handle_ptr_t first = cache.get(files[0], false);
+		cache.get(files[1], false);
+		cache.get(files[2], false);
+		ensure("hit", cache.get(files[0], false) == first);
+		cache.get(files[3], false);
+		ensure_equals("bounded", cache.getHandleCount(), 3U);
+		ensure("recently used kept", cache.find(files[0]) == first);
+		ensure("least recently used closed", !cache.find(files[1]));
+
+		LLFileHandleCache::handle_ptr_t read_only = cache.find(files[2]);
+		LLFileHandleCache::handle_ptr_t writable = cache.get(files[2], true);
+		ensure("read-only handle replaced", writable != read_only && writable->isWritable());
+		ensure("replacement cached", cache.find(files[2]) == writable);
+
+		cache.setLimit(1);
+		ensure_equals("shrunk", cache.getHandleCount(), 1U);
+		ensure("most recent kept", cache.find(files[2]) == writable);
+
+		cache.setLimit(0);
+		ensure("disabled", !cache.isEnabled());
+		LLFileHandleCache::handle_ptr_t uncached = cache.get(files[4], false);
+		ensure("still opens", uncached != nullptr);
+		ensure_equals("but keeps nothing", cache.getHandleCount(), 0U);
+
+		U8 buffer[10];
+		ensure_equals("evicted handle still reads", first->read(buffer, 10, 50), 10);
+		ensure("evicted data", checkRange(0, buffer, 50, 10));
+	}
+
+	template<> template<>
+	void LLFileHandleCache_t::test<3>()
+	{
+		set_test_name("threads share handles");
+		LLFileHandleCache cache(8);
+		std::vector<std::string> files;
+		for (U32 i = 0; i < 16; ++i)
+		{
+			files.push_back(makeFile(i, 4096));
+		}
+
+		std::atomic<S32> errors(0);
+		std::vector<std::thread> threads;
+		for (U32 t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&, t]()
+				{
+					U8 buffer[128];
+					for (U32 n = 0; n < 2000; ++n)
+					{
+						const U32 i = (n * 7 + t) % 16;
+						const S64 offset = (n * 131) % 3968;
+						LLFileHandleCache::handle_ptr_t handle = cache.get(files[i], false);
+						if (!handle || handle->read(buffer, 128, offset) != 128 || !checkRange(i, buffer, offset, 128))
+						{
+							++errors;
+						}
+					}
+				});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		ensure_equals("errors", (S32)errors, 0);
+		ensure("bounded", cache.getHandleCount() <= 8);
+		ensure("reused handles", cache.getHits() > 0);
+	}
+
+	template<> template<>
+	void LLFileHandleCache_t::test<4>()
+	{
+		set_test_name("batched reads on io_uring, where there is one");
+		LLFileHandleCache cache(16);
+		LLAsyncFileReader reader("LLFileHandleCacheTestRing", cache, 2, true);
+		checkReader(reader);
+		reader.close();
+	}
+
+	template<> template<>
+	void LLFileHandleCache_t::test<5>()
+	{
+		set_test_name("batched reads on worker threads");
+		LLFileHandleCache cache(0);
+		LLAsyncFileReader reader("LLFileHandleCacheTestPool", cache, 3, false);
+		ensure("no io_uring", !reader.usesIOUring());
+		checkReader(reader);
+		reader.close();
+	}
+}
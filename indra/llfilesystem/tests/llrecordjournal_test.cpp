@@ -0,0 +1,200 @@
+/**
+ * @file llrecordjournal_test.cpp
+ * @brief LLRecordJournal test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llrecordjournal.h"
+#include "../lldir.h"
+#include "llfile.h"
+
+#include <map>
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLRecordJournalFixture
+	{
+		typedef std::map<U32, std::string> record_map_t;
+
+		LLRecordJournalFixture()
+		:	mFileName(gDirUtilp->add(LLFile::tmpdir(), "llrecordjournal_test_" + LLUUID::generateNewID().asString())),
+			mID(LLUUID::generateNewID())
+		{
+		}
+
+		~LLRecordJournalFixture()
+		{
+			LLFile::remove(mFileName, ENOENT);
+		}
+
+		static std::string makeData(U32 key, U32 version)
+		{
+			return llformat("record %u version %u", key, version) + std::string(key % 50, 'x');
+		}
+
+		static void add(LLRecordJournal::Batch& batch, U32 key, const std::string& data)
+		{
+			batch.add(key, (const U8*)data.data(), (U32)data.size());
+		}
+
+		bool readAll(record_map_t& records, LLRecordJournal::Stats* stats = nullptr, const LLUUID& id = LLUUID::null)
+		{
+			records.clear();
+			return LLRecordJournal::read(mFileName, id.isNull() ? mID : id,
+										 [&](U32 key, const U8* data, U32 size)
+										 {
+											 records[key] = std::string((const char*)data, size);
+											 return true;
+										 }, stats);
+		}
+
+		std::string mFileName;
+		LLUUID mID;
+	};
+	typedef test_group<LLRecordJournalFixture> LLRecordJournal_factory;
+	typedef LLRecordJournal_factory::object LLRecordJournal_t;
+	LLRecordJournal_factory tf("LLRecordJournal");
+
+	template<> template<>
+	void LLRecordJournal_t::test<1>()
+	{
+		set_test_name("rewrite and read back");
+		LLRecordJournal::Batch batch;
+		record_map_t expected;
+		for (U32 key = 1; key <= 200; ++key)
+		{
+			expected[key] = makeData(key, 0);
+			add(batch, key, expected[key]);
+		}
+		ensure("rewrite", LLRecordJournal::rewrite(mFileName, mID, batch));
+
+		record_map_t records;
+		LLRecordJournal::Stats stats;
+		ensure("read", readAll(records, &stats));
+		ensure("same records", records == expected);
+		ensure_equals("records", stats.mRecords, 200U);
+		ensure_equals("live", stats.mLive, 200U);
+		ensure("not truncated", !stats.mTruncated);
+		ensure("no temporary file left", !LLFile::isfile(mFileName + ".tmp"));
+
+		ensure("other id", !readAll(records, nullptr, LLUUID::generateNewID()));
+		LLFile::remove(mFileName);
+		ensure("missing file", !readAll(records));
+	}
+
+	template<> template<>
+	void LLRecordJournal_t::test<2>()
+	{
+		set_test_name("appends supersede and remove records");
+		record_map_t expected;
+		{
+			LLRecordJournal::Batch batch;
+			for (U32 key = 1; key <= 100; ++key)
+			{
+				expected[key] = makeData(key, 0);
+				add(batch, key, expected[key]);
+			}
+			// Appending to a missing file creates it.
+			ensure("first append", LLRecordJournal::append(mFileName, mID, batch));
+		}
+		{
+			LLRecordJournal::Batch batch;
+			for (U32 key = 10; key <= 20; ++key)
+			{
+				expected[key] = makeData(key, 1);
+				add(batch, key, expected[key]);
+			}
+			for (U32 key = 90; key <= 95; ++key)
+			{
+				expected.erase(key);
+				batch.remove(key);
+			}
+			expected[500] = makeData(500, 1);
+			add(batch, 500, expected[500]);
+			ensure_equals("batch records", batch.getRecordCount(), 18U);
+			ensure("second append", LLRecordJournal::append(mFileName, mID, batch));
+		}
+
+		record_map_t records;
+		LLRecordJournal::Stats stats;
+		ensure("read", readAll(records, &stats));
+		ensure("same records", records == expected);
+		ensure_equals("records", stats.mRecords, 118U);
+		ensure_equals("live", stats.mLive, (U32)expected.size());
+		ensure("no compaction yet", !LLRecordJournal::needsCompaction(stats.mRecords, stats.mLive));
+		ensure("compaction", LLRecordJournal::needsCompaction(1000, 100));
+	}
+
+	template<> template<>
+	void LLRecordJournal_t::test<3>()
+	{
+		set_test_name("partial record at the end");
+		record_map_t expected;
+		LLRecordJournal::Batch batch;
+		for (U32 key = 1; key <= 10; ++key)
+		{
+			expected[key] = makeData(key, 0);
+			add(batch, key, expected[key]);
+		}
+		ensure("rewrite", LLRecordJournal::rewrite(mFileName, mID, batch));
+
+		// An append cut short half way through its record.
+		{
+			LLUniqueFile file = LLFile::fopen(mFileName, "ab");
+			U32 header[2] = { 11, 1000 };
+			fwrite(header, sizeof(header), 1, file);
+			fwrite("partial", 7, 1, file);
+		}
+
+		record_map_t records;
+		LLRecordJournal::Stats stats;
+		ensure("read", readAll(records, &stats));
+		ensure("complete records kept", records == expected);
+		ensure("truncated", stats.mTruncated);
+	}
+
+	template<> template<>
+	void LLRecordJournal_t::test<4>()
+	{
+		set_test_name("damaged file");
+		{
+			LLUniqueFile file = LLFile::fopen(mFileName, "wb");
+			fwrite("not a journal at all, just some text", 36, 1, file);
+		}
+		record_map_t records;
+		ensure("rejected", !readAll(records));
+		ensure("nothing read", records.empty());
+
+		// A rewrite replaces it.
+		LLRecordJournal::Batch batch;
+		add(batch, 1, "one");
+		ensure("rewrite", LLRecordJournal::rewrite(mFileName, mID, batch));
+		ensure("read", readAll(records));
+		ensure_equals("record", records[1], std::string("one"));
+	}
+}
@@ -0,0 +1,195 @@
+/**
+ * @file llslabstore_test.cpp
+ * @brief LLSlabStore test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llslabstore.h"
+#include "../lldir.h"
+#include "llfile.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	static const U32 TEST_SLAB_SIZE = 64 * 1024;
+
+	struct LLSlabStoreFixture
+	{
+		LLSlabStoreFixture()
+		:	mDir(LLFile::tmpdir()),
+			mName("llslabstore_test_" + LLUUID::generateNewID().asString())
+		{
+		}
+
+		~LLSlabStoreFixture()
+		{
+			LLSlabStore::removeFiles(mDir, mName);
+		}
+
+		bool open(LLSlabStore& store, U32 slabs = 4)
+		{
+			return store.open(mDir, mName, (U64)slabs * TEST_SLAB_SIZE, TEST_SLAB_SIZE);
+		}
+
+		static std::vector<U8> makeBlob(S32 size, U8 seed)
+		{
+			std::vector<U8> blob(size);
+			for (S32 i = 0; i < size; ++i)
+			{
+				blob[i] = (U8)(seed + i * 7);
+			}
+			return blob;
+		}
+
+		bool matches(LLSlabStore& store, const LLUUID& id, const std::vector<U8>& expected)
+		{
+			std::vector<U8> buffer(expected.size());
+			S32 bytes = store.read(id, &buffer[0], 0, (S32)buffer.size());
+			return bytes == (S32)expected.size() && buffer == expected;
+		}
+
+		std::string mDir;
+		std::string mName;
+	};
+	typedef test_group<LLSlabStoreFixture> LLSlabStore_factory;
+	typedef LLSlabStore_factory::object LLSlabStore_t;
+	LLSlabStore_factory tf("LLSlabStore");
+
+	template<> template<>
+	void LLSlabStore_t::test<1>()
+	{
+		set_test_name("write and read back");
+		LLSlabStore store;
+		ensure("open", open(store));
+
+		LLUUID id = LLUUID::generateNewID();
+		std::vector<U8> blob = makeBlob(5000, 3);
+		ensure("write", store.write(id, &blob[0], (S32)blob.size()));
+		ensure_equals("size", store.getSize(id), 5000);
+		ensure("content", matches(store, id, blob));
+
+		U8 partial[100];
+		ensure_equals("offset read", store.read(id, partial, 4950, 100), 50);
+		ensure_equals("offset content", partial[0], blob[4950]);
+
+		ensure_equals("missing", store.read(LLUUID::generateNewID(), partial, 0, 100), -1);
+	}
+
+	template<> template<>
+	void LLSlabStore_t::test<2>()
+	{
+		set_test_name("overwrite and remove");
+		LLSlabStore store;
+		ensure("open", open(store));
+
+		LLUUID id = LLUUID::generateNewID();
+		std::vector<U8> first = makeBlob(1000, 1);
+		std::vector<U8> second = makeBlob(3000, 2);
+		store.write(id, &first[0], (S32)first.size());
+		store.write(id, &second[0], (S32)second.size());
+		ensure_equals("one entry", store.getEntryCount(), 1U);
+		ensure("latest content", matches(store, id, second));
+		ensure_equals("live bytes", store.getLiveBytes(), (U64)3000);
+
+		ensure("remove", store.remove(id));
+		ensure("gone", !store.contains(id));
+		ensure_equals("no live bytes", store.getLiveBytes(), (U64)0);
+	}
+
+	template<> template<>
+	void LLSlabStore_t::test<3>()
+	{
+		set_test_name("slab eviction");
+		LLSlabStore store;
+		ensure("open", open(store, 2));
+
+		// Each blob takes a bit more than a third of a slab, so every slab holds two.
+		std::vector<U8> blob = makeBlob(TEST_SLAB_SIZE / 3, 9);
+		std::vector<LLUUID> ids;
+		for (S32 i = 0; i < 4; ++i)
+		{
+			ids.push_back(LLUUID::generateNewID());
+			ensure("write", store.write(ids.back(), &blob[0], (S32)blob.size()));
+		}
+		ensure_equals("nothing evicted yet", store.getEvictionCount(), 0U);
+
+		LLUUID extra = LLUUID::generateNewID();
+		ensure("write past capacity", store.write(extra, &blob[0], (S32)blob.size()));
+		ensure_equals("one slab evicted", store.getEvictionCount(), 1U);
+		ensure("evictions pending", store.hasEvicted());
+
+		std::vector<LLUUID> evicted;
+		store.takeEvicted(evicted);
+		ensure_equals("whole slab dropped", evicted.size(), (size_t)2);
+		ensure("oldest gone", !store.contains(ids[0]) && !store.contains(ids[1]));
+		ensure("newest kept", store.contains(ids[2]) && store.contains(ids[3]) && store.contains(extra));
+
+		std::vector<U8> too_big = makeBlob(TEST_SLAB_SIZE, 0);
+		ensure("oversized blob refused", !store.write(LLUUID::generateNewID(), &too_big[0], (S32)too_big.size()));
+	}
+
+	template<> template<>
+	void LLSlabStore_t::test<4>()
+	{
+		set_test_name("persistence and index rebuild");
+		LLUUID id1 = LLUUID::generateNewID();
+		LLUUID id2 = LLUUID::generateNewID();
+		std::vector<U8> blob1 = makeBlob(2048, 4);
+		std::vector<U8> blob2 = makeBlob(777, 5);
+		{
+			LLSlabStore store;
+			ensure("open", open(store));
+			store.write(id1, &blob1[0], (S32)blob1.size());
+			store.write(id2, &blob2[0], (S32)blob2.size());
+			store.write(id2, &blob1[0], (S32)blob1.size());
+		}
+		{
+			LLSlabStore store;
+			ensure("reopen", open(store));
+			ensure_equals("index reloaded", store.getEntryCount(), 2U);
+			ensure("content 1", matches(store, id1, blob1));
+			ensure("content 2", matches(store, id2, blob1));
+		}
+
+		// Losing the index must not lose the data: the arena is rescanned.
+		LLFile::remove(gDirUtilp->add(mDir, mName + ".slabindex"));
+		{
+			LLSlabStore store;
+			ensure("reopen without index", open(store));
+			ensure_equals("index rebuilt", store.getEntryCount(), 2U);
+			ensure("rebuilt content 1", matches(store, id1, blob1));
+			ensure("newest record wins", matches(store, id2, blob1));
+		}
+
+		// A different geometry discards the arena.
+		{
+			LLSlabStore store;
+			ensure("reopen bigger", open(store, 8));
+			ensure_equals("discarded", store.getEntryCount(), 0U);
+		}
+	}
+}
@@ -38,6 +38,7 @@
 #include "llimagejpeg.h"
 #include "llimagepng.h"
 #include "llimagedxt.h"
+#include "llimagekernels.h" // <FS:Kadah/>
 #include "llmemory.h"
 
 #include <boost/preprocessor.hpp>
@@ -229,6 +230,14 @@ inline void bilinear_scale(
 
 	scale_info_t info(src, srcW, srcH, dstW, dstH, srcStride);
 
+	// <FS:Kadah> SIMD pixel loops
+	LLImageScaleTables tables = { &info.xpoints[0], &info.ystrides[0], &info.xapoints[0], &info.yapoints[0], info.xup_yup };
+	if (LLImageKernels::bilinearScale(tables, ch, srcStride, dst, dstW, dstH, dstStride))
+	{
+		return;
+	}
+	// </FS:Kadah>
+
 	const U8 *sptr;
 	U8 *dptr;
 	U32 x, y;
@@ -595,6 +604,7 @@ void LLImage::initClass(bool use_new_byte_range, S32 minimal_reverse_byte_range_
 	sUseNewByteRange = use_new_byte_range;
     sMinimalReverseByteRangePercent = minimal_reverse_byte_range_percent;
 	sMutex = new LLMutex();
+	LLImageKernels::initClass(); // <FS:Kadah/>
 }
 
 //static
@@ -1181,6 +1191,12 @@ void LLImageRaw::compositeUnscaled4onto3( LLImageRaw* src )
 		return;
 	}
 	// </FS:Beq>
+	// <FS:Kadah> SIMD pixel loops
+	if (LLImageKernels::composite4onto3(src_data, dst_data, pixels))
+	{
+		return;
+	}
+	// </FS:Kadah>
 	while( pixels-- )
 	{
 		U8 alpha = src_data[3];
@@ -1378,6 +1394,12 @@ void LLImageRaw::copyUnscaled4onto3( LLImageRaw* src )
 	S32 pixels = getWidth() * getHeight();
 	U8* src_data = src->getData();
 	U8* dst_data = dst->getData();
+	// <FS:Kadah> SIMD pixel loops
+	if (LLImageKernels::copy4onto3(src_data, dst_data, pixels))
+	{
+		return;
+	}
+	// </FS:Kadah>
 	for( S32 i=0; i<pixels; i++ )
 	{
 		dst_data[0] = src_data[0];
@@ -1400,6 +1422,12 @@ void LLImageRaw::copyUnscaled3onto4( LLImageRaw* src )
 	S32 pixels = getWidth() * getHeight();
 	U8* src_data = src->getData();
 	U8* dst_data = dst->getData();
+	// <FS:Kadah> SIMD pixel loops
+	if (LLImageKernels::copy3onto4(src_data, dst_data, pixels))
+	{
+		return;
+	}
+	// </FS:Kadah>
 	for( S32 i=0; i<pixels; i++ )
 	{
 		dst_data[0] = src_data[0];
@@ -1594,6 +1622,13 @@ void LLImageRaw::copyLineScaled( U8* in, U8* out, S32 in_pixel_len, S32 out_pixe
 	const S32 components = getComponents();
 	llassert( components >= 1 && components <= 4 );
 
+	// <FS:Kadah> SIMD pixel loops
+	if (LLImageKernels::copyLineScaled(in, out, in_pixel_len, out_pixel_len, in_pixel_step, out_pixel_step, components))
+	{
+		return;
+	}
+	// </FS:Kadah>
+
 	const F32 ratio = F32(in_pixel_len) / out_pixel_len; // ratio of old to new
 	const F32 norm_factor = 1.f / ratio;
 
@@ -1708,6 +1743,13 @@ void LLImageRaw::compositeRowScaled4onto3( U8* in, U8* out, S32 in_pixel_len, S3
 {
 	llassert( getComponents() == 3 );
 
+	// <FS:Kadah> SIMD pixel loops
+	if (LLImageKernels::compositeRowScaled4onto3(in, out, in_pixel_len, out_pixel_len))
+	{
+		return;
+	}
+	// </FS:Kadah>
+
 	const S32 IN_COMPONENTS = 4;
 	const S32 OUT_COMPONENTS = 3;
 
@@ -32,6 +32,7 @@
 #include "llmemory.h"
 #include "llsd.h"
 #include <boost/scoped_ptr.hpp>
+#include <thread> // <FS:Kadah/>
 
 // Declare the prototype for this factory function here. It is implemented in
 // other files which define a LLImageJ2CImpl subclass, but only ONE static
@@ -52,6 +53,49 @@ std::string LLImageJ2C::getEngineInfo()
 	return impl->getEngineInfo();
 }
 
+// <FS:Kadah> Intra-image decode threads
+// Below this many decoded pixels starting the codec's threads costs more
+// than it saves.
+static const S32 MIN_THREADED_DECODE_PIXELS = 512 * 512;
+// Past this the threads stop paying for themselves.
+static const U32 MAX_DECODE_THREADS = 4;
+
+std::atomic<U32> LLImageJ2C::sDecodeThreads(1);
+std::atomic<U32> LLImageJ2C::sDecodeMaxQueueDepth(2);
+std::atomic<S32> LLImageJ2C::sPendingDecodes(0);
+
+//static
+void LLImageJ2C::setDecodeThreads(U32 threads, U32 max_queue_depth)
+{
+	if (!threads)
+	{
+		threads = llclamp(std::thread::hardware_concurrency() / 2, 1U, MAX_DECODE_THREADS);
+	}
+	sDecodeThreads = threads;
+	sDecodeMaxQueueDepth = max_queue_depth;
+	LL_DEBUGS("Texture") << "J2C decode threads per image: " << threads << ", while at most "
+			   << max_queue_depth << " decodes are pending" << LL_ENDL;
+}
+
+//static
+void LLImageJ2C::addPendingDecodes(S32 count)
+{
+	sPendingDecodes += count;
+}
+
+//static
+U32 LLImageJ2C::getDecodeThreads(S32 width, S32 height)
+{
+	U32 threads = sDecodeThreads;
+	if (threads <= 1 || width * height < MIN_THREADED_DECODE_PIXELS
+		|| sPendingDecodes > (S32)sDecodeMaxQueueDepth)
+	{
+		return 1;
+	}
+	return threads;
+}
+// </FS:Kadah>
+
 LLImageJ2C::LLImageJ2C() : 	LLImageFormatted(IMG_CODEC_J2C),
 							mMaxBytes(0),
 							mRawDiscardLevel(-1),
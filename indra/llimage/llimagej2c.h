@@ -31,6 +31,7 @@
 #include "llassettype.h"
 #include "llmetricperformancetester.h"
 #include <boost/scoped_ptr.hpp>
+#include <atomic> // <FS:Kadah/>
 
 // JPEG2000 : compression rate used in j2c conversion.
 const F32 DEFAULT_COMPRESSION_RATE = 1.f/8.f;
@@ -79,6 +80,18 @@ public:
 
 	static std::string getEngineInfo();
 
+	// <FS:Kadah> Intra-image decode threads. A single large image may be
+	// decoded by up to threads threads (0 picks a default from the core
+	// count, 1 disables it) while no more than max_queue_depth decodes are
+	// pending; past that the decode workers are already busy with one image
+	// each and extra threads would only compete with them.
+	static void setDecodeThreads(U32 threads, U32 max_queue_depth);
+	// Called by the decode queue as requests come and go.
+	static void addPendingDecodes(S32 count);
+	// Threads the decoder should use for an image of this decoded size now.
+	static U32 getDecodeThreads(S32 width, S32 height);
+	// </FS:Kadah>
+
 protected:
 	friend class LLImageJ2CImpl;
 	friend class LLImageJ2COJ;
@@ -100,6 +113,12 @@ protected:
 
     // Image compression/decompression tester
 	static LLImageCompressionTester* sTesterp;
+
+	// <FS:Kadah> Intra-image decode threads
+	static std::atomic<U32> sDecodeThreads;
+	static std::atomic<U32> sDecodeMaxQueueDepth;
+	static std::atomic<S32> sPendingDecodes;
+	// </FS:Kadah>
 };
 
 // Derive from this class to implement JPEG2000 decoding
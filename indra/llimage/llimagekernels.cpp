@@ -0,0 +1,810 @@
+/**
+ * @file llimagekernels.cpp
+ * @brief Vectorized pixel loops for LLImageRaw scaling, copying and compositing.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagekernels.h"
+#include "llmath.h"
+#include "llprocessor.h"
+
+#include <atomic>
+
+#if LL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+
+// GCC and clang only emit AVX2 instructions for functions built for that
+// target; MSVC accepts the intrinsics anywhere.
+#if LL_GNUC || LL_CLANG
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LL_TARGET_AVX2
+#endif
+#endif // LL_X86
+
+namespace
+{
+	std::atomic<S32> sKernelSet(-1);
+
+	LLImageKernels::EKernelSet detect_kernel_set()
+	{
+#if LL_X86
+		LLProcessorInfo cpu;
+		if (cpu.hasAVX2())
+		{
+			return LLImageKernels::KERNELS_AVX2;
+		}
+		// SSE2 is a build requirement on x86, see llsimdmath.h
+		return LLImageKernels::KERNELS_SSE2;
+#else
+		return LLImageKernels::KERNELS_SCALAR;
+#endif
+	}
+
+	LLImageKernels::EKernelSet active_kernel_set()
+	{
+		S32 set = sKernelSet.load(std::memory_order_relaxed);
+		if (set < 0)
+		{
+			set = LLImageKernels::getBestKernelSet();
+			sKernelSet.store(set, std::memory_order_relaxed);
+		}
+		return (LLImageKernels::EKernelSet)set;
+	}
+
+	// Same as LLImageRaw::fastFractionalMult()
+	inline U8 fast_fractional_mult(U8 a, U8 b)
+	{
+		U32 i = a * b + 128;
+		return U8((i + (i >> 8)) >> 8);
+	}
+
+	void composite_4onto3_scalar(const U8* src, U8* dst, S32 pixels)
+	{
+		for (; pixels > 0; --pixels, src += 4, dst += 3)
+		{
+			U8 alpha = src[3];
+			if (255 == alpha)
+			{
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+			}
+			else if (alpha)
+			{
+				U8 transparency = 255 - alpha;
+				dst[0] = fast_fractional_mult(dst[0], transparency) + fast_fractional_mult(src[0], alpha);
+				dst[1] = fast_fractional_mult(dst[1], transparency) + fast_fractional_mult(src[1], alpha);
+				dst[2] = fast_fractional_mult(dst[2], transparency) + fast_fractional_mult(src[2], alpha);
+			}
+		}
+	}
+
+#if LL_X86
+	//------------------------------------------------------------------------
+	// SSE2: one pixel per register, one component per 32 bit lane, so the
+	// integer math of the scalar scaler carries over unchanged.
+
+	template<U32 ch> inline __m128i load_pixel(const U8* p);
+
+	template<> inline __m128i load_pixel<4>(const U8* p)
+	{
+		S32 v;
+		memcpy(&v, p, sizeof(v));
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+	}
+
+	template<> inline __m128i load_pixel<3>(const U8* p)
+	{
+		// Two loads rather than reading a byte past the end of the image
+		U16 rg;
+		memcpy(&rg, p, sizeof(rg));
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(rg | (p[2] << 16)), zero), zero);
+	}
+
+	// pixel * weight. Pixel components and weights (at most 1 << 14 in the
+	// scaler) both fit the 16 bit halves pmaddwd multiplies.
+	inline __m128i mul_pixel(__m128i pixel, S32 weight)
+	{
+		return _mm_madd_epi16(pixel, _mm_set1_epi32(weight));
+	}
+
+	// Low 32 bits of a * b for non negative lanes; SSE2 has no pmulld.
+	inline __m128i mul_lanes(__m128i a, S32 b)
+	{
+		const __m128i bv = _mm_set1_epi32(b);
+		__m128i even = _mm_mul_epu32(a, bv);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), bv);
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+								  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	// *dptr++ = comp[c] & 0xff
+	template<U32 ch> inline void store_pixel(U8*& dptr, __m128i comp)
+	{
+		__m128i v = _mm_and_si128(comp, _mm_set1_epi32(0xff));
+		v = _mm_packs_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		S32 packed = _mm_cvtsi128_si32(v);
+		memcpy(dptr, &packed, ch);
+		dptr += ch;
+	}
+
+	// Weighted sum of a box column (scaling down vertically)
+	template<U32 ch> inline __m128i sum_column(const U8* pix, U32 src_stride, S32 yap, S32 Cy)
+	{
+		__m128i sum = mul_pixel(load_pixel<ch>(pix), yap);
+		pix += src_stride;
+		S32 j;
+		for (j = (1 << 14) - yap; j > Cy; j -= Cy, pix += src_stride)
+		{
+			sum = _mm_add_epi32(sum, mul_pixel(load_pixel<ch>(pix), Cy));
+		}
+		if (j > 0)
+		{
+			sum = _mm_add_epi32(sum, mul_pixel(load_pixel<ch>(pix), j));
+		}
+		return sum;
+	}
+
+	// Weighted sum of a box row (scaling down horizontally)
+	template<U32 ch> inline __m128i sum_row(const U8* pix, S32 xap, S32 Cx)
+	{
+		__m128i sum = mul_pixel(load_pixel<ch>(pix), xap);
+		pix += ch;
+		S32 j;
+		for (j = (1 << 14) - xap; j > Cx; j -= Cx, pix += ch)
+		{
+			sum = _mm_add_epi32(sum, mul_pixel(load_pixel<ch>(pix), Cx));
+		}
+		if (j > 0)
+		{
+			sum = _mm_add_epi32(sum, mul_pixel(load_pixel<ch>(pix), j));
+		}
+		return sum;
+	}
+
+	// The row functions below mirror the four branches of bilinear_scale()
+	// in llimage.cpp and fill destination row y from column x on.
+
+	template<U32 ch>
+	void scale_row_up_sse2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 x, U32 dst_width)
+	{
+		const U8* sptr = t.mYStrides[y];
+		const S32 yap = t.mYAPoints[y];
+		if (yap > 0)
+		{
+			for (; x < dst_width; ++x)
+			{
+				const S32 xap = t.mXAPoints[x];
+				const U8* pix = sptr + t.mXPoints[x] * ch;
+				__m128i comp;
+				if (xap > 0)
+				{
+					comp = _mm_add_epi32(mul_pixel(load_pixel<ch>(pix), 256 - xap),
+										 mul_pixel(load_pixel<ch>(pix + ch), xap));
+					__m128i cx = _mm_add_epi32(mul_pixel(load_pixel<ch>(pix + src_stride + ch), xap),
+											   mul_pixel(load_pixel<ch>(pix + src_stride), 256 - xap));
+					comp = _mm_srai_epi32(_mm_add_epi32(mul_lanes(cx, yap), mul_lanes(comp, 256 - yap)), 16);
+				}
+				else
+				{
+					comp = mul_pixel(load_pixel<ch>(pix), 256 - yap);
+					comp = _mm_srai_epi32(_mm_add_epi32(comp, mul_pixel(load_pixel<ch>(pix + src_stride), yap)), 8);
+				}
+				store_pixel<ch>(dptr, comp);
+			}
+		}
+		else
+		{
+			// The scalar loop blends the pixel with itself here: a plain copy.
+			for (; x < dst_width; ++x, dptr += ch)
+			{
+				memcpy(dptr, sptr + t.mXPoints[x] * ch, ch);
+			}
+		}
+	}
+
+	template<U32 ch>
+	void scale_row_down_y_sse2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 x, U32 dst_width)
+	{
+		const S32 Cy = t.mYAPoints[y] >> 16;
+		const S32 yap = t.mYAPoints[y] & 0xffff;
+		for (; x < dst_width; ++x)
+		{
+			const U8* pix = t.mYStrides[y] + t.mXPoints[x] * ch;
+			__m128i comp = sum_column<ch>(pix, src_stride, yap, Cy);
+			const S32 xap = t.mXAPoints[x];
+			if (xap > 0)
+			{
+				__m128i cx = sum_column<ch>(pix + ch, src_stride, yap, Cy);
+				comp = _mm_srai_epi32(_mm_add_epi32(mul_lanes(comp, 256 - xap), mul_lanes(cx, xap)), 12);
+			}
+			else
+			{
+				comp = _mm_srai_epi32(comp, 4);
+			}
+			store_pixel<ch>(dptr, _mm_srai_epi32(comp, 10));
+		}
+	}
+
+	template<U32 ch>
+	void scale_row_down_x_sse2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 x, U32 dst_width)
+	{
+		const S32 yap = t.mYAPoints[y];
+		for (; x < dst_width; ++x)
+		{
+			const S32 Cx = t.mXAPoints[x] >> 16;
+			const S32 xap = t.mXAPoints[x] & 0xffff;
+			const U8* pix = t.mYStrides[y] + t.mXPoints[x] * ch;
+			__m128i comp = sum_row<ch>(pix, xap, Cx);
+			if (yap > 0)
+			{
+				__m128i cx = sum_row<ch>(pix + src_stride, xap, Cx);
+				comp = _mm_srai_epi32(_mm_add_epi32(mul_lanes(comp, 256 - yap), mul_lanes(cx, yap)), 12);
+			}
+			else
+			{
+				comp = _mm_srai_epi32(comp, 4);
+			}
+			store_pixel<ch>(dptr, _mm_srai_epi32(comp, 10));
+		}
+	}
+
+	template<U32 ch>
+	void scale_row_down_sse2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 x, U32 dst_width)
+	{
+		const S32 Cy = t.mYAPoints[y] >> 16;
+		const S32 yap = t.mYAPoints[y] & 0xffff;
+		for (; x < dst_width; ++x)
+		{
+			const S32 Cx = t.mXAPoints[x] >> 16;
+			const S32 xap = t.mXAPoints[x] & 0xffff;
+			const U8* sptr = t.mYStrides[y] + t.mXPoints[x] * ch;
+
+			__m128i cx = sum_row<ch>(sptr, xap, Cx);
+			sptr += src_stride;
+			__m128i comp = mul_lanes(_mm_srai_epi32(cx, 5), yap);
+			S32 j;
+			for (j = (1 << 14) - yap; j > Cy; j -= Cy, sptr += src_stride)
+			{
+				cx = sum_row<ch>(sptr, xap, Cx);
+				comp = _mm_add_epi32(comp, mul_lanes(_mm_srai_epi32(cx, 5), Cy));
+			}
+			if (j > 0)
+			{
+				cx = sum_row<ch>(sptr, xap, Cx);
+				comp = _mm_add_epi32(comp, mul_lanes(_mm_srai_epi32(cx, 5), j));
+			}
+			store_pixel<ch>(dptr, _mm_srai_epi32(comp, 23));
+		}
+	}
+
+	template<U32 ch>
+	void bilinear_scale_sse2(const LLImageScaleTables& t, U32 src_stride, U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride)
+	{
+		for (U32 y = 0; y < dst_height; ++y)
+		{
+			U8* dptr = dst + y * dst_stride;
+			switch (t.mXUpYUp)
+			{
+			case 3:
+				scale_row_up_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			case 1:
+				scale_row_down_y_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			case 2:
+				scale_row_down_x_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			default:
+				scale_row_down_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			}
+		}
+	}
+
+	// Four float lanes holding components 0, goff, boff and aoff of a pixel
+	inline __m128 load_components(const U8* p, S32 components, S32 goff, S32 boff)
+	{
+		if (4 == components)
+		{
+			return _mm_cvtepi32_ps(load_pixel<4>(p));
+		}
+		return _mm_cvtepi32_ps(_mm_setr_epi32(p[0], p[goff], p[boff], 0));
+	}
+
+	// U8(ll_round(v)) per lane, packed into the low bytes. Sums are never
+	// negative so truncation matches llfloor().
+	inline S32 round_components(__m128 v)
+	{
+		__m128i rounded = _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+		rounded = _mm_and_si128(rounded, _mm_set1_epi32(0xff));
+		rounded = _mm_packs_epi32(rounded, rounded);
+		return _mm_cvtsi128_si32(_mm_packus_epi16(rounded, rounded));
+	}
+
+	void copy_line_scaled_sse2(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len,
+							   S32 in_pixel_step, S32 out_pixel_step, S32 components)
+	{
+		const F32 ratio = F32(in_pixel_len) / out_pixel_len;
+		const F32 norm_factor = 1.f / ratio;
+
+		const S32 goff = components >= 2 ? 1 : 0;
+		const S32 boff = components >= 3 ? 2 : 0;
+		for (S32 x = 0; x < out_pixel_len; x++)
+		{
+			const F32 sample0 = x * ratio;
+			const F32 sample1 = (x + 1) * ratio;
+			const S32 index0 = llfloor(sample0);
+			const S32 index1 = llfloor(sample1);
+			const F32 fract0 = 1.f - (sample0 - F32(index0));
+			const F32 fract1 = sample1 - F32(index1);
+
+			U8* outp = out + x * out_pixel_step * components;
+			if (index0 == index1)
+			{
+				memcpy(outp, in + index0 * in_pixel_step * components, components);
+				continue;
+			}
+
+			__m128 sum = _mm_mul_ps(load_components(in + index0 * in_pixel_step * components, components, goff, boff),
+									_mm_set1_ps(fract0));
+			for (S32 u = index0 + 1; u < index1; u++)
+			{
+				sum = _mm_add_ps(sum, load_components(in + u * in_pixel_step * components, components, goff, boff));
+			}
+			if (fract1 && index1 < in_pixel_len)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(load_components(in + index1 * in_pixel_step * components, components, goff, boff),
+												 _mm_set1_ps(fract1)));
+			}
+
+			S32 packed = round_components(_mm_mul_ps(sum, _mm_set1_ps(norm_factor)));
+			memcpy(outp, &packed, components);
+		}
+	}
+
+	void composite_row_scaled_4onto3_sse2(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len)
+	{
+		const F32 ratio = F32(in_pixel_len) / out_pixel_len;
+		const F32 norm_factor = 1.f / ratio;
+
+		for (S32 x = 0; x < out_pixel_len; x++, out += 3)
+		{
+			const F32 sample0 = x * ratio;
+			const F32 sample1 = (x + 1) * ratio;
+			const S32 index0 = S32(sample0);
+			const S32 index1 = S32(sample1);
+			const F32 fract0 = 1.f - (sample0 - F32(index0));
+			const F32 fract1 = sample1 - F32(index1);
+
+			U8 scaled[4];
+			if (index0 == index1)
+			{
+				// Replicates the scalar loop, which only reads the first component here.
+				memset(scaled, in[index0 * 4], 4);
+			}
+			else
+			{
+				__m128 sum = _mm_mul_ps(_mm_cvtepi32_ps(load_pixel<4>(in + index0 * 4)), _mm_set1_ps(fract0));
+				for (S32 u = index0 + 1; u < index1; u++)
+				{
+					sum = _mm_add_ps(sum, _mm_cvtepi32_ps(load_pixel<4>(in + u * 4)));
+				}
+				if (fract1 && index1 < in_pixel_len)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(load_pixel<4>(in + index1 * 4)), _mm_set1_ps(fract1)));
+				}
+				S32 packed = round_components(_mm_mul_ps(sum, _mm_set1_ps(norm_factor)));
+				memcpy(scaled, &packed, 4);
+			}
+			composite_4onto3_scalar(scaled, out, 1);
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// AVX2: two pixels per register, one per 128 bit lane. Neighbouring
+	// destination pixels share the vertical weights, so the branches whose
+	// loop counts only depend on y are done in pairs; the rest runs the SSE2
+	// rows, which also pick up odd tails.
+
+	template<U32 ch> LL_TARGET_AVX2 inline __m256i load_pixels(const U8* p0, const U8* p1)
+	{
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(load_pixel<ch>(p0)), load_pixel<ch>(p1), 1);
+	}
+
+	LL_TARGET_AVX2 inline __m256i pair_weights(S32 w0, S32 w1)
+	{
+		return _mm256_setr_epi32(w0, w0, w0, w0, w1, w1, w1, w1);
+	}
+
+	template<U32 ch> LL_TARGET_AVX2 inline void store_pixels(U8*& dptr, __m256i comp)
+	{
+		__m256i v = _mm256_and_si256(comp, _mm256_set1_epi32(0xff));
+		v = _mm256_packs_epi32(v, v);
+		v = _mm256_packus_epi16(v, v);
+		S32 p0 = _mm_cvtsi128_si32(_mm256_castsi256_si128(v));
+		S32 p1 = _mm_cvtsi128_si32(_mm256_extracti128_si256(v, 1));
+		memcpy(dptr, &p0, ch);
+		memcpy(dptr + ch, &p1, ch);
+		dptr += 2 * ch;
+	}
+
+	template<U32 ch>
+	LL_TARGET_AVX2 inline __m256i sum_columns(const U8* p0, const U8* p1, U32 src_stride, S32 yap, S32 Cy)
+	{
+		__m256i sum = _mm256_madd_epi16(load_pixels<ch>(p0, p1), _mm256_set1_epi32(yap));
+		p0 += src_stride;
+		p1 += src_stride;
+		S32 j;
+		for (j = (1 << 14) - yap; j > Cy; j -= Cy, p0 += src_stride, p1 += src_stride)
+		{
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(load_pixels<ch>(p0, p1), _mm256_set1_epi32(Cy)));
+		}
+		if (j > 0)
+		{
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(load_pixels<ch>(p0, p1), _mm256_set1_epi32(j)));
+		}
+		return sum;
+	}
+
+	template<U32 ch>
+	LL_TARGET_AVX2 void scale_row_up_avx2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 dst_width)
+	{
+		const U8* sptr = t.mYStrides[y];
+		const S32 yap = t.mYAPoints[y];
+		U32 x = 0;
+		if (yap > 0)
+		{
+			const __m256i ywt = _mm256_set1_epi32(yap);
+			const __m256i ywt_inv = _mm256_set1_epi32(256 - yap);
+			for (; x + 1 < dst_width; x += 2)
+			{
+				// With a zero horizontal weight the scalar loop only blends
+				// vertically; the full blend with the right neighbour weighted
+				// by zero gives the same result, as long as the neighbour read
+				// stays on the pixel itself (it may be past the row end).
+				const S32 xap0 = t.mXAPoints[x];
+				const S32 xap1 = t.mXAPoints[x + 1];
+				const U8* p0 = sptr + t.mXPoints[x] * ch;
+				const U8* p1 = sptr + t.mXPoints[x + 1] * ch;
+				const U8* r0 = xap0 > 0 ? p0 + ch : p0;
+				const U8* r1 = xap1 > 0 ? p1 + ch : p1;
+				const __m256i wl = pair_weights(256 - xap0, 256 - xap1);
+				const __m256i wr = pair_weights(xap0, xap1);
+
+				__m256i comp = _mm256_add_epi32(_mm256_madd_epi16(load_pixels<ch>(p0, p1), wl),
+												_mm256_madd_epi16(load_pixels<ch>(r0, r1), wr));
+				__m256i cx = _mm256_add_epi32(_mm256_madd_epi16(load_pixels<ch>(r0 + src_stride, r1 + src_stride), wr),
+											  _mm256_madd_epi16(load_pixels<ch>(p0 + src_stride, p1 + src_stride), wl));
+				comp = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(cx, ywt), _mm256_mullo_epi32(comp, ywt_inv)), 16);
+				store_pixels<ch>(dptr, comp);
+			}
+		}
+		scale_row_up_sse2<ch>(t, y, src_stride, dptr, x, dst_width);
+	}
+
+	template<U32 ch>
+	LL_TARGET_AVX2 void scale_row_down_y_avx2(const LLImageScaleTables& t, U32 y, U32 src_stride, U8* dptr, U32 dst_width)
+	{
+		const S32 Cy = t.mYAPoints[y] >> 16;
+		const S32 yap = t.mYAPoints[y] & 0xffff;
+		U32 x = 0;
+		for (; x + 1 < dst_width; x += 2)
+		{
+			const U8* p0 = t.mYStrides[y] + t.mXPoints[x] * ch;
+			const U8* p1 = t.mYStrides[y] + t.mXPoints[x + 1] * ch;
+			__m256i comp = sum_columns<ch>(p0, p1, src_stride, yap, Cy);
+			const S32 xap0 = t.mXAPoints[x];
+			const S32 xap1 = t.mXAPoints[x + 1];
+			if (xap0 > 0 || xap1 > 0)
+			{
+				// (comp * 256) >> 12 == comp >> 4 for a lane with a zero weight
+				__m256i cx = sum_columns<ch>(xap0 > 0 ? p0 + ch : p0, xap1 > 0 ? p1 + ch : p1, src_stride, yap, Cy);
+				comp = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(comp, pair_weights(256 - xap0, 256 - xap1)),
+														  _mm256_mullo_epi32(cx, pair_weights(xap0, xap1))), 12);
+			}
+			else
+			{
+				comp = _mm256_srai_epi32(comp, 4);
+			}
+			store_pixels<ch>(dptr, _mm256_srai_epi32(comp, 10));
+		}
+		scale_row_down_y_sse2<ch>(t, y, src_stride, dptr, x, dst_width);
+	}
+
+	template<U32 ch>
+	LL_TARGET_AVX2 void bilinear_scale_avx2(const LLImageScaleTables& t, U32 src_stride, U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride)
+	{
+		for (U32 y = 0; y < dst_height; ++y)
+		{
+			U8* dptr = dst + y * dst_stride;
+			switch (t.mXUpYUp)
+			{
+			case 3:
+				scale_row_up_avx2<ch>(t, y, src_stride, dptr, dst_width);
+				break;
+			case 1:
+				scale_row_down_y_avx2<ch>(t, y, src_stride, dptr, dst_width);
+				break;
+			case 2:
+				scale_row_down_x_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			default:
+				scale_row_down_sse2<ch>(t, y, src_stride, dptr, 0, dst_width);
+				break;
+			}
+		}
+	}
+
+	// The channel conversions and the composite below work on 8 pixels at a
+	// time: 32 bytes of 4 component pixels against 24 bytes of 3 component
+	// ones, handled as two 12 byte halves (one per 128 bit lane) so pshufb
+	// never has to cross lanes. The 16 byte accesses of the upper half end
+	// 28 bytes in, hence the 10 pixel margin before the scalar tail.
+
+	LL_TARGET_AVX2 inline __m256i load_rgb_halves(const U8* p)
+	{
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+									   _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+	}
+
+	// Writes bytes 0-11 of each lane, plus bytes 12-15 of the upper lane,
+	// which the next 8 pixels or the tail overwrite.
+	LL_TARGET_AVX2 inline void store_rgb_halves(U8* p, __m256i v)
+	{
+		_mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+		_mm_storeu_si128((__m128i*)(p + 12), _mm256_extracti128_si256(v, 1));
+	}
+
+	LL_TARGET_AVX2 void copy_3onto4_avx2(const U8* src, U8* dst, S32 pixels)
+	{
+		const __m256i expand = _mm256_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128,
+												0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+		const __m256i opaque = _mm256_set1_epi32((S32)0xff000000);
+		for (; pixels >= 10; pixels -= 8, src += 24, dst += 32)
+		{
+			__m256i v = _mm256_shuffle_epi8(load_rgb_halves(src), expand);
+			_mm256_storeu_si256((__m256i*)dst, _mm256_or_si256(v, opaque));
+		}
+		for (; pixels > 0; --pixels, src += 3, dst += 4)
+		{
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = 255;
+		}
+	}
+
+	LL_TARGET_AVX2 void copy_4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+	{
+		const __m256i compact = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128,
+												 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+		for (; pixels >= 10; pixels -= 8, src += 32, dst += 24)
+		{
+			store_rgb_halves(dst, _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), compact));
+		}
+		for (; pixels > 0; --pixels, src += 4, dst += 3)
+		{
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+		}
+	}
+
+	// fast_fractional_mult() on 16 bit lanes; every intermediate fits 16 bits.
+	LL_TARGET_AVX2 inline __m256i fast_fractional_mult_avx2(__m256i a, __m256i b)
+	{
+		__m256i i = _mm256_add_epi16(_mm256_mullo_epi16(a, b), _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(i, _mm256_srli_epi16(i, 8)), 8);
+	}
+
+	// The scalar loop special cases alpha 0 and 255, but the blend
+	// dst * (255 - a) + src * a gives the same bytes for both, which lets
+	// the lanes skip the branches.
+	LL_TARGET_AVX2 inline __m256i blend_avx2(__m256i dst, __m256i src, __m256i alpha)
+	{
+		__m256i transparency = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+		__m256i sum = _mm256_add_epi16(fast_fractional_mult_avx2(dst, transparency), fast_fractional_mult_avx2(src, alpha));
+		return _mm256_and_si256(sum, _mm256_set1_epi16(0xff));
+	}
+
+	LL_TARGET_AVX2 void composite_4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+	{
+		const __m256i compact = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128,
+												 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+		// Bytes 12-15 of each lane get a zero alpha and keep their destination value.
+		const __m256i spread_alpha = _mm256_setr_epi8(3, 3, 3, 7, 7, 7, 11, 11, 11, 15, 15, 15, -128, -128, -128, -128,
+													  3, 3, 3, 7, 7, 7, 11, 11, 11, 15, 15, 15, -128, -128, -128, -128);
+		const __m256i zero = _mm256_setzero_si256();
+		for (; pixels >= 10; pixels -= 8, src += 32, dst += 24)
+		{
+			__m256i s = _mm256_loadu_si256((const __m256i*)src);
+			__m256i d = load_rgb_halves(dst);
+			__m256i rgb = _mm256_shuffle_epi8(s, compact);
+			__m256i alpha = _mm256_shuffle_epi8(s, spread_alpha);
+			__m256i lo = blend_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(rgb, zero), _mm256_unpacklo_epi8(alpha, zero));
+			__m256i hi = blend_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(rgb, zero), _mm256_unpackhi_epi8(alpha, zero));
+			store_rgb_halves(dst, _mm256_packus_epi16(lo, hi));
+		}
+		composite_4onto3_scalar(src, dst, pixels);
+	}
+#endif // LL_X86
+}
+
+//static
+void LLImageKernels::initClass()
+{
+	LL_INFOS("ImageKernels") << "Using " << getKernelSetName(getKernelSet()) << " image kernels" << LL_ENDL;
+}
+
+//static
+LLImageKernels::EKernelSet LLImageKernels::getBestKernelSet()
+{
+	static const EKernelSet best = detect_kernel_set();
+	return best;
+}
+
+//static
+LLImageKernels::EKernelSet LLImageKernels::getKernelSet()
+{
+	return active_kernel_set();
+}
+
+//static
+LLImageKernels::EKernelSet LLImageKernels::setKernelSet(EKernelSet set)
+{
+	set = llclamp(set, KERNELS_SCALAR, getBestKernelSet());
+	sKernelSet.store(set, std::memory_order_relaxed);
+	return set;
+}
+
+//static
+const char* LLImageKernels::getKernelSetName(EKernelSet set)
+{
+	switch (set)
+	{
+	case KERNELS_SSE2:
+		return "SSE2";
+	case KERNELS_AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+//static
+bool LLImageKernels::bilinearScale(const LLImageScaleTables& tables, U32 components, U32 src_stride,
+								   U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride)
+{
+#if LL_X86
+	// Single component images stay on the scalar loop: one lane out of four
+	// would do the work. Gathering 3 component pixels costs about what one
+	// register per pixel saves, so those only win with AVX2 pairs, which are
+	// only used when scaling up horizontally.
+	switch (active_kernel_set())
+	{
+	case KERNELS_AVX2:
+		if (4 == components)
+		{
+			bilinear_scale_avx2<4>(tables, src_stride, dst, dst_width, dst_height, dst_stride);
+			return true;
+		}
+		if (3 == components && (tables.mXUpYUp & 1))
+		{
+			bilinear_scale_avx2<3>(tables, src_stride, dst, dst_width, dst_height, dst_stride);
+			return true;
+		}
+		break;
+	case KERNELS_SSE2:
+		if (4 == components)
+		{
+			bilinear_scale_sse2<4>(tables, src_stride, dst, dst_width, dst_height, dst_stride);
+			return true;
+		}
+		break;
+	default:
+		break;
+	}
+#endif
+	return false;
+}
+
+// The channel conversions and the composite need byte shuffles (pshufb),
+// which SSE2 lacks; they only have an AVX2 kernel.
+
+//static
+bool LLImageKernels::copy3onto4(const U8* src, U8* dst, S32 pixels)
+{
+#if LL_X86
+	if (KERNELS_AVX2 == active_kernel_set())
+	{
+		copy_3onto4_avx2(src, dst, pixels);
+		return true;
+	}
+#endif
+	return false;
+}
+
+//static
+bool LLImageKernels::copy4onto3(const U8* src, U8* dst, S32 pixels)
+{
+#if LL_X86
+	if (KERNELS_AVX2 == active_kernel_set())
+	{
+		copy_4onto3_avx2(src, dst, pixels);
+		return true;
+	}
+#endif
+	return false;
+}
+
+//static
+bool LLImageKernels::composite4onto3(const U8* src, U8* dst, S32 pixels)
+{
+#if LL_X86
+	if (KERNELS_AVX2 == active_kernel_set())
+	{
+		composite_4onto3_avx2(src, dst, pixels);
+		return true;
+	}
+#endif
+	return false;
+}
+
+// The line scalers are float code over a variable number of source pixels
+// per destination pixel; AVX2 has nothing to add to the SSE2 version.
+
+//static
+bool LLImageKernels::copyLineScaled(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len,
+									S32 in_pixel_step, S32 out_pixel_step, S32 components)
+{
+#if LL_X86
+	if (active_kernel_set() >= KERNELS_SSE2 && components >= 1 && components <= 4)
+	{
+		copy_line_scaled_sse2(in, out, in_pixel_len, out_pixel_len, in_pixel_step, out_pixel_step, components);
+		return true;
+	}
+#endif
+	return false;
+}
+
+//static
+bool LLImageKernels::compositeRowScaled4onto3(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len)
+{
+#if LL_X86
+	if (active_kernel_set() >= KERNELS_SSE2)
+	{
+		composite_row_scaled_4onto3_sse2(in, out, in_pixel_len, out_pixel_len);
+		return true;
+	}
+#endif
+	return false;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file llimagekernels.h
+ * @brief Vectorized pixel loops for LLImageRaw scaling, copying and compositing.
+ *
+ * @Description:
+ * LLImageRaw keeps its scalar loops as the reference implementation. The
+ * kernels here redo the same integer (and, for the line scalers, float)
+ * arithmetic with SSE2 or AVX2 and therefore produce bit identical output.
+ * The widest kernel set the CPU supports is picked on first use; each entry
+ * point returns false when the active set has no kernel for the request so
+ * the caller falls through to its scalar loop.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEKERNELS_H
+#define LL_LLIMAGEKERNELS_H
+
+// Lookup tables computed by the bilinear scaler in llimage.cpp (scale_info).
+struct LLImageScaleTables
+{
+	const S32* mXPoints;		// source column of each destination column
+	const U8* const* mYStrides;	// source row of each destination row
+	const S32* mXAPoints;		// horizontal weights
+	const S32* mYAPoints;		// vertical weights
+	S32 mXUpYUp;				// bit 0: scaling up horizontally, bit 1: scaling up vertically
+};
+
+class LLImageKernels
+{
+public:
+	typedef enum e_kernel_set
+	{
+		KERNELS_SCALAR = 0,
+		KERNELS_SSE2,
+		KERNELS_AVX2,
+		KERNELS_COUNT
+	} EKernelSet;
+
+	// Logs the kernel set in use. Called by LLImage::initClass().
+	static void initClass();
+
+	// Widest set supported by this CPU.
+	static EKernelSet getBestKernelSet();
+	static EKernelSet getKernelSet();
+	// Selects a kernel set, clamped to getBestKernelSet(). Meant for tests
+	// and benchmarks. Returns the set actually selected.
+	static EKernelSet setKernelSet(EKernelSet set);
+	static const char* getKernelSetName(EKernelSet set);
+
+	// Bilinear scale of a 3 or 4 component image. Everything but the pixel
+	// loops (the lookup tables and the choice of branch) stays in llimage.cpp.
+	static bool bilinearScale(const LLImageScaleTables& tables, U32 components, U32 src_stride,
+							  U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride);
+
+	// Same sized copies between 3 and 4 component pixel runs. Alpha is set to 255 on 3onto4.
+	static bool copy3onto4(const U8* src, U8* dst, S32 pixels);
+	static bool copy4onto3(const U8* src, U8* dst, S32 pixels);
+
+	// Blends a run of 4 component pixels over 3 component ones.
+	static bool composite4onto3(const U8* src, U8* dst, S32 pixels);
+
+	// LLImageRaw::copyLineScaled() and LLImageRaw::compositeRowScaled4onto3().
+	static bool copyLineScaled(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len,
+							   S32 in_pixel_step, S32 out_pixel_step, S32 components);
+	static bool compositeRowScaled4onto3(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len);
+};
+
+#endif // LL_LLIMAGEKERNELS_H
@@ -27,6 +27,7 @@
 #include "linden_common.h"
 #include "llimageworker.h"
 #include "llimagedxt.h"
+#include "llimagej2c.h" // <FS:Kadah/>
 
  // <FS:ND> Image thread pool from CoolVL
 #include "boost/thread.hpp"
@@ -237,10 +238,12 @@ LLImageDecodeThread::ImageRequest::ImageRequest(handle_t handle, LLImageFormatte
 	if (s_ChildThreads > 0)
 		mFlags |= FLAG_ASYNC;
 	// </FS:ND>
+	LLImageJ2C::addPendingDecodes(1); // <FS:Kadah/> Intra-image decode threads
 }
 
 LLImageDecodeThread::ImageRequest::~ImageRequest()
 {
+	LLImageJ2C::addPendingDecodes(-1); // <FS:Kadah/> Intra-image decode threads
 	mDecodedImageRaw = NULL;
 	mDecodedImageAux = NULL;
 	mFormattedImage = NULL;
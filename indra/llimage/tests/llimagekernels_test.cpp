@@ -0,0 +1,207 @@
+/**
+ * @file llimagekernels_test.cpp
+ * @brief LLImageKernels test cases: the SIMD kernels must match the scalar loops bit for bit.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimage.h"
+#include "../llimagekernels.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLImageKernelsFixture
+	{
+		LLImageKernelsFixture()
+		:	mSeed(12345)
+		{
+			LLImage::initClass();
+		}
+
+		~LLImageKernelsFixture()
+		{
+			LLImageKernels::setKernelSet(LLImageKernels::getBestKernelSet());
+			LLImage::cleanupClass();
+		}
+
+		// Noise, with a share of fully transparent and fully opaque alpha
+		// so that the composite special cases get exercised.
+		LLPointer<LLImageRaw> makeImage(U16 width, U16 height, S8 components)
+		{
+			LLPointer<LLImageRaw> image = new LLImageRaw(width, height, components);
+			U8* data = image->getData();
+			S32 size = width * height * components;
+			for (S32 i = 0; i < size; ++i)
+			{
+				mSeed = mSeed * 1103515245 + 12345;
+				data[i] = (U8)(mSeed >> 16);
+				if (4 == components && 3 == i % 4 && (mSeed >> 8) % 3 == 0)
+				{
+					data[i] = (mSeed >> 12) & 1 ? 255 : 0;
+				}
+			}
+			return image;
+		}
+
+		static bool sameData(LLImageRaw* a, LLImageRaw* b)
+		{
+			return a->getWidth() == b->getWidth() && a->getHeight() == b->getHeight()
+				&& a->getComponents() == b->getComponents()
+				&& !memcmp(a->getData(), b->getData(), a->getDataSize());
+		}
+
+		// Runs op with the scalar loops and with every SIMD set this CPU has,
+		// and checks the results against each other.
+		template<typename OP>
+		void ensureSameOnAllSets(const std::string& what, OP op)
+		{
+			LLImageKernels::setKernelSet(LLImageKernels::KERNELS_SCALAR);
+			LLPointer<LLImageRaw> expected = op();
+			for (S32 set = LLImageKernels::KERNELS_SSE2; set < LLImageKernels::KERNELS_COUNT; ++set)
+			{
+				if (LLImageKernels::setKernelSet((LLImageKernels::EKernelSet)set) != set)
+				{
+					break;
+				}
+				LLPointer<LLImageRaw> actual = op();
+				ensure(what + " with " + LLImageKernels::getKernelSetName((LLImageKernels::EKernelSet)set),
+					   sameData(expected, actual));
+			}
+		}
+
+		U32 mSeed;
+	};
+	typedef test_group<LLImageKernelsFixture> LLImageKernels_factory;
+	typedef LLImageKernels_factory::object LLImageKernels_t;
+	LLImageKernels_factory tf("LLImageKernels");
+
+	// Source and destination sizes covering every branch of the bilinear
+	// scaler, odd widths for the pair loops, and the single pixel edges.
+	static const U16 SCALE_SIZES[][4] =
+	{
+		{ 64, 64, 128, 128 },	// up
+		{ 64, 64, 32, 32 },		// down
+		{ 64, 64, 128, 32 },	// up x, down y
+		{ 64, 64, 32, 128 },	// down x, up y
+		{ 37, 53, 101, 77 },
+		{ 101, 77, 37, 53 },
+		{ 37, 77, 101, 53 },
+		{ 101, 53, 37, 77 },
+		{ 300, 200, 299, 201 },
+		{ 1, 1, 7, 5 },
+		{ 7, 5, 1, 1 },
+		{ 2, 2, 3, 3 },
+	};
+
+	template<> template<>
+	void LLImageKernels_t::test<1>()
+	{
+		set_test_name("scale");
+		for (S8 components = 3; components <= 4; ++components)
+		{
+			for (const U16* size : SCALE_SIZES)
+			{
+				LLPointer<LLImageRaw> src = makeImage(size[0], size[1], components);
+				std::string what = llformat("%dx%dx%d to %dx%d", size[0], size[1], components, size[2], size[3]);
+				ensureSameOnAllSets(what, [&]()
+				{
+					return src->scaled(size[2], size[3]);
+				});
+				ensureSameOnAllSets("in place " + what, [&]()
+				{
+					LLPointer<LLImageRaw> image = new LLImageRaw(src->getData(), src->getWidth(), src->getHeight(), src->getComponents());
+					image->scale(size[2], size[3]);
+					return image;
+				});
+			}
+		}
+	}
+
+	template<> template<>
+	void LLImageKernels_t::test<2>()
+	{
+		set_test_name("copy between 3 and 4 components");
+		// 10 pixels is the first size that enters the AVX2 loop.
+		static const U16 widths[] = { 1, 9, 10, 11, 17, 64, 333 };
+		for (U16 width : widths)
+		{
+			LLPointer<LLImageRaw> rgb = makeImage(width, 3, 3);
+			LLPointer<LLImageRaw> rgba = makeImage(width, 3, 4);
+			ensureSameOnAllSets(llformat("3onto4 %d", width), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(width, 3, 4);
+				dst->copy(rgb);
+				return dst;
+			});
+			ensureSameOnAllSets(llformat("4onto3 %d", width), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(width, 3, 3);
+				dst->copy(rgba);
+				return dst;
+			});
+			ensureSameOnAllSets(llformat("scaled 3onto4 %d", width), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(width + 5, 7, 4);
+				dst->copy(rgb);
+				return dst;
+			});
+			ensureSameOnAllSets(llformat("scaled 4onto3 %d", width), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(width + 5, 7, 3);
+				dst->copy(rgba);
+				return dst;
+			});
+		}
+	}
+
+	template<> template<>
+	void LLImageKernels_t::test<3>()
+	{
+		set_test_name("composite");
+		static const U16 sizes[][2] = { { 1, 1 }, { 9, 3 }, { 10, 3 }, { 33, 17 }, { 128, 64 } };
+		for (const U16* size : sizes)
+		{
+			LLPointer<LLImageRaw> src = makeImage(size[0], size[1], 4);
+			LLPointer<LLImageRaw> background = makeImage(size[0], size[1], 3);
+			ensureSameOnAllSets(llformat("unscaled %dx%d", size[0], size[1]), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(background->getData(), size[0], size[1], 3);
+				dst->composite(src);
+				return dst;
+			});
+			// Scaled composite goes through copyLineScaled() and compositeRowScaled4onto3().
+			LLPointer<LLImageRaw> big_background = makeImage(size[0] * 2 + 1, size[1] + 3, 3);
+			ensureSameOnAllSets(llformat("scaled %dx%d", size[0], size[1]), [&]()
+			{
+				LLPointer<LLImageRaw> dst = new LLImageRaw(big_background->getData(), big_background->getWidth(),
+														   big_background->getHeight(), 3);
+				dst->composite(src);
+				return dst;
+			});
+		}
+	}
+}
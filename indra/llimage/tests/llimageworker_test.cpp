@@ -29,6 +29,7 @@
 #include "linden_common.h"
 // Class to test 
 #include "../llimageworker.h"
+#include "../llimagej2c.h"
 // For timer class
 #include "../llcommon/lltimer.h"
 // for lltrace class
@@ -68,6 +69,7 @@ U8* LLImageRaw::allocateData(S32 size) { return NULL; }
 U8* LLImageRaw::reallocateData(S32 size) { return NULL; }
 const U8* LLImageBase::getData() const { return NULL; }
 U8* LLImageBase::getData() { return NULL; }
+void LLImageJ2C::addPendingDecodes(S32 count) { }
 
 // End Stubbing
 // -------------------------------------------------------------------------------------------
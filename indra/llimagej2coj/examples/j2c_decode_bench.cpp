@@ -0,0 +1,153 @@
+/**
+ * @file j2c_decode_bench.cpp
+ * @brief Times J2C decodes at each discard level, single threaded and with intra-image decode threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "llimage.h"
+#include "llimagej2c.h"
+#include "lltimer.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tj2c_decode_bench [options] <file.j2c> ...\n"
+		"\n"
+		"Decodes every file at each discard level, once single threaded and once\n"
+		"with LLImageJ2C intra-image decode threads, checks that both give the\n"
+		"same pixels and reports the time per decode.  Levels below the threaded\n"
+		"size threshold fall back to a single thread and should show no change.\n"
+		"Texture cache bodies need their header entry prepended to be complete\n"
+		"codestreams; files saved with \"Save texture as\" can be used as is.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -t <count>      Decode threads per image, 0 for the default.  Default:  0\n"
+		" -r <count>      Repetitions per measurement.  Default:  5\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+static F64 time_decode(LLImageJ2C* j2c, S32 discard, S32 repeat, LLPointer<LLImageRaw>& raw)
+{
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		j2c->setDiscardLevel(discard);
+		raw = new LLImageRaw;
+		j2c->decode(raw, 0.f);
+	}
+	return (LLTimer::getTotalSeconds() - start) * 1000.0 / repeat;
+}
+
+static bool same_pixels(LLImageRaw* a, LLImageRaw* b)
+{
+	return a->getWidth() == b->getWidth() && a->getHeight() == b->getHeight()
+		&& a->getComponents() == b->getComponents() && a->getData() && b->getData()
+		&& !memcmp(a->getData(), b->getData(), a->getDataSize());
+}
+
+int main(int argc, char** argv)
+{
+	U32 threads = 0;
+	S32 repeat = 5;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-t" && i + 1 < argc)
+		{
+			threads = (U32)llmax(atoi(argv[++i]), 0);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else if (!arg.empty() && arg[0] != '-')
+		{
+			files.push_back(arg);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+	if (files.empty())
+	{
+		usage(std::cerr);
+		return 1;
+	}
+
+	LLImage::initClass();
+	fprintf(stdout, "%s\n", LLImageJ2C::getEngineInfo().c_str());
+
+	F64 total_single = 0.0;
+	F64 total_threaded = 0.0;
+	for (const std::string& filename : files)
+	{
+		LLPointer<LLImageJ2C> j2c = new LLImageJ2C;
+		if (!j2c->loadAndValidate(filename))
+		{
+			std::cerr << "Unable to load " << filename << ": " << LLImage::getLastError() << std::endl;
+			continue;
+		}
+		S32 width = j2c->getWidth();
+		S32 height = j2c->getHeight();
+		fprintf(stdout, "%s (%dx%dx%d, %d bytes)\n", filename.c_str(), width, height,
+				j2c->getComponents(), j2c->getDataSize());
+
+		for (S32 discard = 0; discard <= MAX_DISCARD_LEVEL && (width >> discard) && (height >> discard); ++discard)
+		{
+			LLPointer<LLImageRaw> single;
+			LLPointer<LLImageRaw> threaded;
+
+			LLImageJ2C::setDecodeThreads(1, 0);
+			F64 single_ms = time_decode(j2c, discard, repeat, single);
+
+			LLImageJ2C::setDecodeThreads(threads, 0);
+			U32 used = LLImageJ2C::getDecodeThreads(width >> discard, height >> discard);
+			F64 threaded_ms = time_decode(j2c, discard, repeat, threaded);
+
+			total_single += single_ms;
+			total_threaded += threaded_ms;
+			fprintf(stdout, "  discard %d %5dx%-5d 1 thread %8.3f ms  %u threads %8.3f ms %6.2fx %s\n",
+					discard, single->getWidth(), single->getHeight(), single_ms, used, threaded_ms,
+					threaded_ms > 0.0 ? single_ms / threaded_ms : 0.0,
+					same_pixels(single, threaded) ? "" : "MISMATCH");
+		}
+	}
+	fprintf(stdout, "total: 1 thread %.3f ms, threaded %.3f ms, %.2fx\n", total_single, total_threaded,
+			total_threaded > 0.0 ? total_single / total_threaded : 0.0);
+
+	LLImage::cleanupClass();
+	return 0;
+}
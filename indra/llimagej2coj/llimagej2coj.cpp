@@ -32,6 +32,8 @@
 #include "event.h"
 #include "cio.h"
 
+#include <atomic> // <FS:Kadah/>
+
 #define MAX_ENCODED_DISCARD_LEVELS 5
 
 // Factory function: see declaration in llimagej2c.cpp
@@ -336,7 +338,10 @@ public:
         return true;
     }
 
-    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
+    // <FS:Kadah> Intra-image decode threads
+    //bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
+    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level, U32 threads = 1)
+    // </FS:Kadah>
     {
         parameters.flags &= ~OPJ_DPARAMETERS_DUMP_FLAG;
 
@@ -347,6 +352,15 @@ public:
         opj_set_warning_handler(decoder, opj_warn, this);
         opj_set_error_handler(decoder, opj_error, this);
 
+        // <FS:Kadah> Let the codec spread the code-blocks of this image over
+        // its own threads; needs to happen before opj_read_header.
+        if (threads > 1 && sHasThreads && !opj_codec_set_threads(decoder, threads))
+        {
+            LL_WARNS("OpenJPEG") << "Unable to start " << threads << " decode threads, decoding single threaded" << LL_ENDL;
+            sHasThreads = false;
+        }
+        // </FS:Kadah>
+
         if (stream)
         {
             opj_stream_destroy(stream);
@@ -409,6 +423,9 @@ public:
 
     opj_image_t* getImage() { return image; }
 
+    // <FS:Kadah/> False when this OpenJPEG was built without thread support
+    static std::atomic<bool> sHasThreads;
+
 private:
     opj_dparameters_t         parameters;
     opj_event_mgr_t           event_mgr;
@@ -418,6 +435,8 @@ private:
     opj_codestream_info_v2_t* codestream_info = nullptr;
 };
 
+std::atomic<bool> JPEG2KDecode::sHasThreads(opj_has_thread_support()); // <FS:Kadah/>
+
 class JPEG2KEncode : public JPEG2KBase
 {
 public:
@@ -780,7 +799,12 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     U32 image_channels = 0;
     S32 data_size = base.getDataSize();
     S32 max_bytes = (base.getMaxBytes() ? base.getMaxBytes() : data_size);
-    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    // <FS:Kadah> Intra-image decode threads
+    //bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    S32 discard = llmax(base.mDiscardLevel, (S8)0);
+    U32 threads = LLImageJ2C::getDecodeThreads(base.getWidth() >> discard, base.getHeight() >> discard);
+    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel, threads);
+    // </FS:Kadah>
 
     // set correct channel count early so failed decodes don't miss it...
     S32 channels = (S32)image_channels - first_channel;
@@ -0,0 +1,306 @@
+/**
+ * @file inventory_cache_bench.cpp
+ * @brief Compares loading a synthetic inventory from the gzipped LLSD cache and from the binary cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "llfile.h"
+#include "llinventory.h"
+#include "llinventorycache.h"
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "llsys.h"
+#include "lltimer.h"
+#include "lluuid.h"
+
+static const S32 CACHE_VERSION = 2;
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tinventory_cache_bench [options]\n"
+		"\n"
+		"Builds a synthetic inventory, saves it as the gzipped LLSD lines written\n"
+		"by LLInventoryModel::saveToFile() and as an LLInventoryCacheWriter file,\n"
+		"then times loading it back from both.  The binary cache is loaded once\n"
+		"completely and once with only some of the categories current, the way\n"
+		"LLInventoryModel::loadSkeleton() skips folders whose version changed.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -n <count>      Items in the synthetic inventory.  Default:  200000\n"
+		" -c <count>      Categories in the synthetic inventory.  Default:  4000\n"
+		" -p <percent>    Categories still current for the partial load.\n"
+		"                 Default:  25\n"
+		" -r <count>      Repetitions per measurement.  Default:  5\n"
+		" -d <dir>        Directory for the cache files.  Default:  .\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+typedef std::vector<LLPointer<LLInventoryCategory> > cat_array_t;
+typedef std::vector<LLPointer<LLInventoryItem> > item_array_t;
+
+static void make_inventory(S32 cat_count, S32 item_count, cat_array_t& cats, item_array_t& items)
+{
+	LLUUID owner_id = LLUUID::generateNewID();
+	LLUUID root_id = LLUUID::generateNewID();
+	for (S32 i = 0; i < cat_count; ++i)
+	{
+		const LLUUID& parent_id = i ? cats[rand() % i]->getUUID() : root_id;
+		cats.push_back(new LLInventoryCategory(LLUUID::generateNewID(), parent_id,
+											   LLFolderType::FT_NONE, llformat("Folder %d", i)));
+	}
+	for (S32 i = 0; i < item_count; ++i)
+	{
+		LLPermissions perm;
+		perm.init(LLUUID::generateNewID(), owner_id, LLUUID::generateNewID(), LLUUID::null);
+		perm.initMasks(PERM_ALL, PERM_ALL, PERM_NONE, PERM_NONE, PERM_MOVE | PERM_TRANSFER);
+		items.push_back(new LLInventoryItem(LLUUID::generateNewID(), cats[rand() % cat_count]->getUUID(),
+											perm, LLUUID::generateNewID(),
+											LLAssetType::AT_OBJECT, LLInventoryType::IT_OBJECT,
+											llformat("Inventory item number %d", i), "(No Description)",
+											LLSaleInfo(LLSaleInfo::FS_NOT, 10), 0, 1600000000 + i));
+	}
+}
+
+static size_t file_size(const std::string& filename)
+{
+	llstat stat_data;
+	return LLFile::stat(filename, &stat_data) ? 0 : (size_t)stat_data.st_size;
+}
+
+// Same lines as LLInventoryModel::saveToFile(), gzipped like cache().
+static bool save_llsd(const std::string& filename, const cat_array_t& cats, const item_array_t& items)
+{
+	std::string temp_filename = filename + ".tmp";
+	{
+		std::ofstream out(temp_filename.c_str());
+		LLSD cache_ver;
+		cache_ver["inv_cache_version"] = CACHE_VERSION;
+		out << LLSDOStreamer<LLSDNotationFormatter>(cache_ver) << std::endl;
+		for (const LLPointer<LLInventoryCategory>& cat : cats)
+		{
+			LLSD cat_data = cat->exportLLSD();
+			cat_data["version"] = 1;
+			out << LLSDOStreamer<LLSDNotationFormatter>(cat_data) << std::endl;
+		}
+		for (const LLPointer<LLInventoryItem>& item : items)
+		{
+			out << LLSDOStreamer<LLSDNotationFormatter>(item->asLLSD()) << std::endl;
+		}
+		if (out.fail())
+		{
+			return false;
+		}
+	}
+	bool success = gzip_file(temp_filename, filename);
+	LLFile::remove(temp_filename);
+	return success;
+}
+
+// Same steps as LLInventoryModel::loadSkeleton() and loadFromFile().
+static S32 load_llsd(const std::string& filename)
+{
+	std::string temp_filename = filename + ".tmp";
+	if (!gunzip_file(filename, temp_filename))
+	{
+		return 0;
+	}
+	cat_array_t cats;
+	item_array_t items;
+	{
+		std::ifstream in(temp_filename.c_str());
+		LLPointer<LLSDParser> parser = new LLSDNotationParser();
+		std::string line;
+		while (std::getline(in, line))
+		{
+			LLSD s_item;
+			std::istringstream iss(line);
+			if (parser->parse(iss, s_item, line.length()) == LLSDParser::PARSE_FAILURE)
+			{
+				break;
+			}
+			if (s_item.has("cat_id"))
+			{
+				LLPointer<LLInventoryCategory> cat = new LLInventoryCategory;
+				cat->importLLSD(s_item);
+				cats.push_back(cat);
+			}
+			else if (s_item.has("item_id"))
+			{
+				LLPointer<LLInventoryItem> item = new LLInventoryItem;
+				item->fromLLSD(s_item);
+				items.push_back(item);
+			}
+		}
+	}
+	LLFile::remove(temp_filename);
+	return (S32)items.size();
+}
+
+static S32 load_binary(const std::string& filename, const cat_array_t& skeleton, S32 current_percent)
+{
+	LLInventoryCacheReader reader;
+	if (!reader.open(filename, CACHE_VERSION))
+	{
+		return 0;
+	}
+	cat_array_t cats;
+	item_array_t items;
+	for (size_t i = 0; i < skeleton.size(); ++i)
+	{
+		S32 index = reader.findCategory(skeleton[i]->getUUID());
+		if (index < 0)
+		{
+			continue;
+		}
+		LLPointer<LLInventoryCategory> cat = new LLInventoryCategory;
+		reader.loadCategory(index, cat);
+		cats.push_back(cat);
+		if ((S32)(i % 100) >= current_percent)
+		{
+			// Version changed on the server, the items are fetched instead.
+			continue;
+		}
+		S32 count = reader.getCategoryItemCount(index);
+		for (S32 n = 0; n < count; ++n)
+		{
+			LLPointer<LLInventoryItem> item = new LLInventoryItem;
+			if (reader.loadItem(index, n, item))
+			{
+				items.push_back(item);
+			}
+		}
+	}
+	return (S32)items.size();
+}
+
+int main(int argc, char** argv)
+{
+	S32 item_count = 200000;
+	S32 cat_count = 4000;
+	S32 current_percent = 25;
+	S32 repeat = 5;
+	std::string dir = ".";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-n" && i + 1 < argc)
+		{
+			item_count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-c" && i + 1 < argc)
+		{
+			cat_count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-p" && i + 1 < argc)
+		{
+			current_percent = llclamp(atoi(argv[++i]), 0, 100);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-d" && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	cat_array_t cats;
+	item_array_t items;
+	make_inventory(cat_count, item_count, cats, items);
+
+	std::string llsd_filename = dir + "/inventory_cache_bench.inv.llsd.gz";
+	std::string binary_filename = dir + "/inventory_cache_bench.inv.bin";
+	if (!save_llsd(llsd_filename, cats, items))
+	{
+		std::cerr << "Unable to write " << llsd_filename << std::endl;
+		return 1;
+	}
+	LLInventoryCacheWriter writer(CACHE_VERSION);
+	for (const LLPointer<LLInventoryCategory>& cat : cats)
+	{
+		writer.addCategory(cat, LLUUID::null, 1);
+	}
+	for (const LLPointer<LLInventoryItem>& item : items)
+	{
+		writer.addItem(item);
+	}
+	if (!writer.write(binary_filename))
+	{
+		std::cerr << "Unable to write " << binary_filename << std::endl;
+		return 1;
+	}
+
+	fprintf(stdout, "%d categories, %d items\n", cat_count, item_count);
+	fprintf(stdout, "  llsd.gz %10llu bytes\n", (unsigned long long)file_size(llsd_filename));
+	fprintf(stdout, "  binary  %10llu bytes\n", (unsigned long long)file_size(binary_filename));
+
+	S32 loaded = 0;
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		loaded = load_llsd(llsd_filename);
+	}
+	F64 llsd_seconds = (LLTimer::getTotalSeconds() - start) / repeat;
+	fprintf(stdout, "  llsd           %9.1f ms %7d items\n", llsd_seconds * 1000.0, loaded);
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		loaded = load_binary(binary_filename, cats, 100);
+	}
+	F64 binary_seconds = (LLTimer::getTotalSeconds() - start) / repeat;
+	fprintf(stdout, "  binary         %9.1f ms %7d items %6.2fx\n", binary_seconds * 1000.0, loaded,
+			binary_seconds > 0.0 ? llsd_seconds / binary_seconds : 0.0);
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < repeat; ++i)
+	{
+		loaded = load_binary(binary_filename, cats, current_percent);
+	}
+	F64 partial_seconds = (LLTimer::getTotalSeconds() - start) / repeat;
+	fprintf(stdout, "  binary %3d%%    %9.1f ms %7d items %6.2fx\n", current_percent, partial_seconds * 1000.0, loaded,
+			partial_seconds > 0.0 ? llsd_seconds / partial_seconds : 0.0);
+
+	LLFile::remove(llsd_filename);
+	LLFile::remove(binary_filename);
+	return 0;
+}
@@ -0,0 +1,367 @@
+/**
+ * @file llinventorycache.cpp
+ * @brief Binary, memory mapped inventory cache file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llinventorycache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "llfile.h"
+#include "llinventory.h"
+
+using namespace LLInventoryCacheFormat;
+
+static void add_string(std::string& strings, const std::string& value, U32& offset, U32& length)
+{
+	offset = (U32)strings.size();
+	length = (U32)value.size();
+	strings.append(value);
+}
+
+LLInventoryCacheWriter::LLInventoryCacheWriter(S32 cache_version)
+:	mCacheVersion(cache_version),
+	mWrittenCategories(0),
+	mWrittenItems(0)
+{
+}
+
+void LLInventoryCacheWriter::addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version)
+{
+	PendingCategory pending = { cat, owner_id, version };
+	mCategories.push_back(pending);
+}
+
+void LLInventoryCacheWriter::addItem(const LLInventoryItem* item)
+{
+	mItems.push_back(item);
+}
+
+bool LLInventoryCacheWriter::write(const std::string& filename)
+{
+	mWrittenCategories = 0;
+	mWrittenItems = 0;
+
+	// Categories go out sorted by id, the first of any duplicates wins.
+	std::vector<S32> order(mCategories.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](S32 a, S32 b)
+		{
+			return mCategories[a].mCategory->getUUID() < mCategories[b].mCategory->getUUID();
+		});
+	order.erase(std::unique(order.begin(), order.end(), [this](S32 a, S32 b)
+		{
+			return mCategories[a].mCategory->getUUID() == mCategories[b].mCategory->getUUID();
+		}), order.end());
+
+	std::unordered_map<LLUUID, U32> slots;
+	slots.reserve(order.size());
+	for (U32 i = 0; i < (U32)order.size(); ++i)
+	{
+		slots[mCategories[order[i]].mCategory->getUUID()] = i;
+	}
+
+	// Bucket the items by parent, keeping their order within a category.
+	std::vector<S32> item_slots(mItems.size(), -1);
+	std::vector<U32> counts(order.size(), 0);
+	for (size_t i = 0; i < mItems.size(); ++i)
+	{
+		auto it = slots.find(mItems[i]->getParentUUID());
+		if (it != slots.end())
+		{
+			item_slots[i] = (S32)it->second;
+			++counts[it->second];
+		}
+	}
+
+	std::string strings;
+	std::vector<CategoryRecord> categories(order.size());
+	U32 first_item = 0;
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const PendingCategory& pending = mCategories[order[i]];
+		const LLInventoryCategory* cat = pending.mCategory;
+		CategoryRecord& record = categories[i];
+		record.mID = cat->getUUID();
+		record.mParentID = cat->getParentUUID();
+		record.mOwnerID = pending.mOwnerID;
+		record.mVersion = pending.mVersion;
+		record.mPreferredType = (S32)cat->getPreferredType();
+		add_string(strings, cat->LLInventoryCategory::getName(), record.mNameOffset, record.mNameLength);
+		record.mFirstItem = first_item;
+		record.mItemCount = counts[i];
+		first_item += counts[i];
+	}
+
+	// The getters are called on the base class, the viewer overrides
+	// resolve links and this has to store the link itself.
+	std::vector<ItemRecord> items(first_item);
+	std::vector<U32> next(order.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		next[i] = categories[i].mFirstItem;
+	}
+	for (size_t i = 0; i < mItems.size(); ++i)
+	{
+		if (item_slots[i] < 0)
+		{
+			continue;
+		}
+		const LLInventoryItem* item = mItems[i];
+		const LLPermissions& perm = item->LLInventoryItem::getPermissions();
+		const LLSaleInfo& sale_info = item->LLInventoryItem::getSaleInfo();
+		ItemRecord& record = items[next[item_slots[i]]++];
+		record.mID = item->getUUID();
+		record.mParentID = item->getParentUUID();
+		record.mAssetID = item->LLInventoryItem::getAssetUUID();
+		record.mCreatorID = perm.getCreator();
+		record.mOwnerID = perm.getOwner();
+		record.mLastOwnerID = perm.getLastOwner();
+		record.mGroupID = perm.getGroup();
+		record.mBaseMask = perm.getMaskBase();
+		record.mOwnerMask = perm.getMaskOwner();
+		record.mGroupMask = perm.getMaskGroup();
+		record.mEveryoneMask = perm.getMaskEveryone();
+		record.mNextOwnerMask = perm.getMaskNextOwner();
+		record.mFlags = item->LLInventoryItem::getFlags();
+		record.mSalePrice = sale_info.getSalePrice();
+		record.mCreationDate = (S32)item->LLInventoryItem::getCreationDate();
+		add_string(strings, item->LLInventoryItem::getName(), record.mNameOffset, record.mNameLength);
+		add_string(strings, item->LLInventoryItem::getDescription(), record.mDescOffset, record.mDescLength);
+		record.mType = (S8)item->LLInventoryItem::getType();
+		record.mInventoryType = (S8)item->LLInventoryItem::getInventoryType();
+		record.mSaleType = (S8)sale_info.getSaleType();
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	header.mMagic = MAGIC;
+	header.mFormatVersion = FORMAT_VERSION;
+	header.mCacheVersion = mCacheVersion;
+	header.mCategoryRecordSize = sizeof(CategoryRecord);
+	header.mItemRecordSize = sizeof(ItemRecord);
+	header.mCategoryCount = (U32)categories.size();
+	header.mItemCount = (U32)items.size();
+	header.mStringTableSize = (U32)strings.size();
+
+	std::string temp_filename = filename + ".tmp";
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS() << "Unable to open " << temp_filename << " for writing" << LL_ENDL;
+		return false;
+	}
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if (success && !categories.empty())
+	{
+		success = fwrite(&categories[0], sizeof(CategoryRecord), categories.size(), fp) == categories.size();
+	}
+	if (success && !items.empty())
+	{
+		success = fwrite(&items[0], sizeof(ItemRecord), items.size(), fp) == items.size();
+	}
+	if (success && !strings.empty())
+	{
+		success = fwrite(strings.data(), 1, strings.size(), fp) == strings.size();
+	}
+	success = (fclose(fp) == 0) && success;
+
+	if (success)
+	{
+		// Windows will not rename over an existing file.
+		LLFile::remove(filename, ENOENT);
+		success = (LLFile::rename(temp_filename, filename) == 0);
+	}
+	if (!success)
+	{
+		LL_WARNS() << "Unable to write inventory cache " << filename << LL_ENDL;
+		LLFile::remove(temp_filename, ENOENT);
+		return false;
+	}
+
+	mWrittenCategories = (S32)categories.size();
+	mWrittenItems = (S32)items.size();
+	return true;
+}
+
+LLInventoryCacheReader::LLInventoryCacheReader()
+:	mHeader(NULL),
+	mCategories(NULL),
+	mItems(NULL),
+	mStrings(NULL)
+{
+}
+
+bool LLInventoryCacheReader::open(const std::string& filename, S32 cache_version)
+{
+	close();
+	if (!mFile.open(filename, 0, false))
+	{
+		return false;
+	}
+
+	const U8* data = mFile.getData();
+	size_t size = mFile.getSize();
+	const Header* header = (const Header*)data;
+	if (size < sizeof(Header)
+		|| header->mMagic != MAGIC
+		|| header->mFormatVersion != FORMAT_VERSION
+		|| header->mCategoryRecordSize != sizeof(CategoryRecord)
+		|| header->mItemRecordSize != sizeof(ItemRecord))
+	{
+		LL_WARNS() << "Not an inventory cache file: " << filename << LL_ENDL;
+		mFile.close();
+		return false;
+	}
+	if (header->mCacheVersion != cache_version)
+	{
+		LL_WARNS() << "Inventory cache is out of date" << LL_ENDL;
+		mFile.close();
+		return false;
+	}
+
+	size_t categories_offset = sizeof(Header);
+	size_t items_offset = categories_offset + (size_t)header->mCategoryCount * sizeof(CategoryRecord);
+	size_t strings_offset = items_offset + (size_t)header->mItemCount * sizeof(ItemRecord);
+	if (strings_offset + header->mStringTableSize != size)
+	{
+		LL_WARNS() << "Truncated inventory cache file: " << filename << LL_ENDL;
+		mFile.close();
+		return false;
+	}
+
+	// Check the category records up front so lookups and item ranges can
+	// be trusted, item strings are checked as the items are loaded.
+	const CategoryRecord* categories = (const CategoryRecord*)(data + categories_offset);
+	for (U32 i = 0; i < header->mCategoryCount; ++i)
+	{
+		const CategoryRecord& record = categories[i];
+		if ((U64)record.mFirstItem + record.mItemCount > header->mItemCount
+			|| (U64)record.mNameOffset + record.mNameLength > header->mStringTableSize
+			|| (i > 0 && !(categories[i - 1].mID < record.mID)))
+		{
+			LL_WARNS() << "Damaged inventory cache file: " << filename << LL_ENDL;
+			mFile.close();
+			return false;
+		}
+	}
+
+	mHeader = header;
+	mCategories = categories;
+	mItems = (const ItemRecord*)(data + items_offset);
+	mStrings = (const char*)(data + strings_offset);
+	return true;
+}
+
+void LLInventoryCacheReader::close()
+{
+	mFile.close();
+	mHeader = NULL;
+	mCategories = NULL;
+	mItems = NULL;
+	mStrings = NULL;
+}
+
+S32 LLInventoryCacheReader::findCategory(const LLUUID& id) const
+{
+	if (!mHeader)
+	{
+		return -1;
+	}
+	const CategoryRecord* end = mCategories + mHeader->mCategoryCount;
+	const CategoryRecord* it = std::lower_bound(mCategories, end, id,
+		[](const CategoryRecord& record, const LLUUID& id) { return record.mID < id; });
+	if (it == end || it->mID != id)
+	{
+		return -1;
+	}
+	return (S32)(it - mCategories);
+}
+
+std::string LLInventoryCacheReader::getString(U32 offset, U32 length) const
+{
+	return std::string(mStrings + offset, length);
+}
+
+void LLInventoryCacheReader::loadCategory(S32 index, LLInventoryCategory* cat) const
+{
+	const CategoryRecord& record = mCategories[index];
+	cat->setUUID(record.mID);
+	cat->setParent(record.mParentID);
+	cat->setPreferredType((LLFolderType::EType)record.mPreferredType);
+	cat->rename(getString(record.mNameOffset, record.mNameLength));
+}
+
+bool LLInventoryCacheReader::loadItem(S32 index, S32 n, LLInventoryItem* item) const
+{
+	const CategoryRecord& category = mCategories[index];
+	if (n < 0 || (U32)n >= category.mItemCount)
+	{
+		return false;
+	}
+	const ItemRecord& record = mItems[category.mFirstItem + n];
+	if ((U64)record.mNameOffset + record.mNameLength > mHeader->mStringTableSize
+		|| (U64)record.mDescOffset + record.mDescLength > mHeader->mStringTableSize)
+	{
+		LL_WARNS() << "Damaged inventory cache item " << record.mID << LL_ENDL;
+		return false;
+	}
+
+	LLAssetType::EType type = (LLAssetType::EType)record.mType;
+	if (LLAssetType::lookup(type) == LLAssetType::BADLOOKUP)
+	{
+		// Written by a viewer that knows more asset types than this one.
+		type = LLAssetType::AT_UNKNOWN;
+	}
+
+	LLPermissions perm;
+	perm.init(record.mCreatorID, record.mOwnerID, record.mLastOwnerID, record.mGroupID);
+	perm.setMaskBase(record.mBaseMask);
+	perm.setMaskOwner(record.mOwnerMask);
+	perm.setMaskEveryone(record.mEveryoneMask);
+	perm.setMaskGroup(record.mGroupMask);
+	perm.setMaskNext(record.mNextOwnerMask);
+	perm.fix();
+
+	item->setUUID(record.mID);
+	item->setParent(record.mParentID);
+	item->setAssetUUID(record.mAssetID);
+	item->setType(type);
+	item->setInventoryType((LLInventoryType::EType)record.mInventoryType);
+	// After the inventory type, which may force the masks of landmarks.
+	item->setPermissions(perm);
+	item->setSaleInfo(LLSaleInfo((LLSaleInfo::EForSale)record.mSaleType, record.mSalePrice));
+	item->setFlags(record.mFlags);
+	item->rename(getString(record.mNameOffset, record.mNameLength));
+	item->setDescription(getString(record.mDescOffset, record.mDescLength));
+	item->setCreationDate(record.mCreationDate);
+	return true;
+}
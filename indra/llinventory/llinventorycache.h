@@ -0,0 +1,186 @@
+/**
+ * @file llinventorycache.h
+ * @brief Binary, memory mapped inventory cache file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYCACHE_H
+#define LL_LLINVENTORYCACHE_H
+
+#include <string>
+#include <vector>
+
+#include "llmappedfile.h"
+#include "lluuid.h"
+
+class LLInventoryCategory;
+class LLInventoryItem;
+
+// On disk layout of the inventory cache, all in host byte order:
+//
+//   Header
+//   CategoryRecord * mCategoryCount, sorted by id
+//   ItemRecord * mItemCount, grouped by parent in category order
+//   string table (names and descriptions, not terminated)
+//
+// Each category record points at the contiguous run of its items, so the
+// file doubles as the parent to children index and a reader only decodes
+// the items of the categories it wants.
+namespace LLInventoryCacheFormat
+{
+	const U32 MAGIC = 0x43494946;	// "FIIC"
+	const U32 FORMAT_VERSION = 1;
+
+	struct Header
+	{
+		U32		mMagic;
+		U32		mFormatVersion;
+		S32		mCacheVersion;			// LLInventoryModel::sCurrentInvCacheVersion
+		U32		mCategoryRecordSize;
+		U32		mItemRecordSize;
+		U32		mCategoryCount;
+		U32		mItemCount;
+		U32		mStringTableSize;
+	};
+
+	struct CategoryRecord
+	{
+		LLUUID	mID;
+		LLUUID	mParentID;
+		LLUUID	mOwnerID;
+		S32		mVersion;
+		S32		mPreferredType;
+		U32		mNameOffset;
+		U32		mNameLength;
+		U32		mFirstItem;
+		U32		mItemCount;
+	};
+
+	struct ItemRecord
+	{
+		LLUUID	mID;
+		LLUUID	mParentID;
+		LLUUID	mAssetID;
+		LLUUID	mCreatorID;
+		LLUUID	mOwnerID;
+		LLUUID	mLastOwnerID;
+		LLUUID	mGroupID;
+		U32		mBaseMask;
+		U32		mOwnerMask;
+		U32		mGroupMask;
+		U32		mEveryoneMask;
+		U32		mNextOwnerMask;
+		U32		mFlags;
+		S32		mSalePrice;
+		S32		mCreationDate;
+		U32		mNameOffset;
+		U32		mNameLength;
+		U32		mDescOffset;
+		U32		mDescLength;
+		S8		mType;
+		S8		mInventoryType;
+		S8		mSaleType;
+		U8		mPadding;
+	};
+}
+
+// Collects categories and items and writes them out as one cache file. Only
+// pointers are kept, the objects have to outlive write().
+class LLInventoryCacheWriter
+{
+	LOG_CLASS(LLInventoryCacheWriter);
+public:
+	LLInventoryCacheWriter(S32 cache_version);
+
+	void addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version);
+
+	// Items whose parent was never added are not written.
+	void addItem(const LLInventoryItem* item);
+
+	// Writes to a temporary file next to filename and renames it over
+	// filename once complete, so a reader never sees a partial file.
+	bool write(const std::string& filename);
+
+	// Counts actually written by the last write().
+	S32 getWrittenCategoryCount() const	{ return mWrittenCategories; }
+	S32 getWrittenItemCount() const		{ return mWrittenItems; }
+
+private:
+	struct PendingCategory
+	{
+		const LLInventoryCategory*	mCategory;
+		LLUUID						mOwnerID;
+		S32							mVersion;
+	};
+
+	S32 mCacheVersion;
+	std::vector<PendingCategory> mCategories;
+	std::vector<const LLInventoryItem*> mItems;
+	S32 mWrittenCategories;
+	S32 mWrittenItems;
+};
+
+// Maps a cache file and decodes categories and items on request.
+class LLInventoryCacheReader
+{
+	LOG_CLASS(LLInventoryCacheReader);
+public:
+	LLInventoryCacheReader();
+
+	// Fails if the file is missing, damaged, or was written for another
+	// cache_version.
+	bool open(const std::string& filename, S32 cache_version);
+	void close();
+	bool isOpen() const		{ return mHeader != NULL; }
+
+	S32 getCategoryCount() const	{ return mHeader ? (S32)mHeader->mCategoryCount : 0; }
+	S32 getItemCount() const		{ return mHeader ? (S32)mHeader->mItemCount : 0; }
+
+	// Index of the category with this id, -1 if it is not cached.
+	S32 findCategory(const LLUUID& id) const;
+
+	const LLUUID& getCategoryID(S32 index) const		{ return mCategories[index].mID; }
+	const LLUUID& getCategoryOwnerID(S32 index) const	{ return mCategories[index].mOwnerID; }
+	S32 getCategoryVersion(S32 index) const				{ return mCategories[index].mVersion; }
+	S32 getCategoryItemCount(S32 index) const			{ return (S32)mCategories[index].mItemCount; }
+
+	// Fills id, parent, preferred type and name.
+	void loadCategory(S32 index, LLInventoryCategory* cat) const;
+
+	// Fills item from the n-th item of the category at index. Items whose
+	// asset type this viewer does not know come back as AT_UNKNOWN, like
+	// LLInventoryItem::fromLLSD() would leave them.
+	bool loadItem(S32 index, S32 n, LLInventoryItem* item) const;
+
+private:
+	std::string getString(U32 offset, U32 length) const;
+
+	LLMappedFile mFile;
+	const LLInventoryCacheFormat::Header* mHeader;
+	const LLInventoryCacheFormat::CategoryRecord* mCategories;
+	const LLInventoryCacheFormat::ItemRecord* mItems;
+	const char* mStrings;
+};
+
+#endif // LL_LLINVENTORYCACHE_H
@@ -0,0 +1,211 @@
+/**
+ * @file llinventorycache_test.cpp
+ * @brief Tests for the binary inventory cache file.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llinventorycache.h"
+#include "../llinventory.h"
+#include "lldir.h"
+#include "llfile.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct llinventorycache_data
+	{
+		llinventorycache_data()
+		:	mFilename(gDirUtilp->getTempFilename())
+		{
+		}
+
+		~llinventorycache_data()
+		{
+			LLFile::remove(mFilename, ENOENT);
+		}
+
+		LLPointer<LLInventoryCategory> makeCategory(const std::string& name)
+		{
+			return new LLInventoryCategory(LLUUID::generateNewID(), LLUUID::generateNewID(),
+										   LLFolderType::FT_CLOTHING, name);
+		}
+
+		LLPointer<LLInventoryItem> makeItem(const LLUUID& parent_id, S32 n,
+											LLAssetType::EType type = LLAssetType::AT_OBJECT)
+		{
+			LLPermissions perm;
+			perm.init(LLUUID::generateNewID(), LLUUID::generateNewID(), LLUUID::generateNewID(), LLUUID::null);
+			perm.initMasks(PERM_ALL, PERM_ALL, PERM_NONE, PERM_COPY, PERM_MODIFY | PERM_COPY);
+			return new LLInventoryItem(LLUUID::generateNewID(), parent_id, perm, LLUUID::generateNewID(),
+									   type, LLInventoryType::IT_OBJECT,
+									   llformat("Item %d", n), llformat("Description %d", n),
+									   LLSaleInfo(LLSaleInfo::FS_COPY, 10 + n), 0x1000 + n, 1600000000 + n);
+		}
+
+		void ensureSameItem(const LLInventoryItem* expected, const LLInventoryItem* actual)
+		{
+			ensure_equals("id", actual->getUUID(), expected->getUUID());
+			ensure_equals("parent", actual->getParentUUID(), expected->getParentUUID());
+			ensure_equals("asset", actual->getAssetUUID(), expected->getAssetUUID());
+			ensure_equals("type", actual->getType(), expected->getType());
+			ensure_equals("inventory type", actual->getInventoryType(), expected->getInventoryType());
+			ensure_equals("name", actual->getName(), expected->getName());
+			ensure_equals("description", actual->getDescription(), expected->getDescription());
+			ensure_equals("flags", actual->getFlags(), expected->getFlags());
+			ensure_equals("creation date", actual->getCreationDate(), expected->getCreationDate());
+			ensure("sale info", actual->getSaleInfo() == expected->getSaleInfo());
+			ensure("permissions", actual->getPermissions() == expected->getPermissions());
+		}
+
+		std::string mFilename;
+	};
+	typedef test_group<llinventorycache_data> llinventorycache_test;
+	typedef llinventorycache_test::object llinventorycache_object;
+	tut::llinventorycache_test llinventorycache("LLInventoryCache");
+
+	template<> template<>
+	void llinventorycache_object::test<1>()
+	{
+		set_test_name("round trip");
+		std::vector<LLPointer<LLInventoryCategory> > cats;
+		std::vector<LLPointer<LLInventoryItem> > items;
+		for (S32 i = 0; i < 3; ++i)
+		{
+			cats.push_back(makeCategory(llformat("Folder %d", i)));
+		}
+		// Interleaved on purpose, the writer groups them by parent.
+		for (S32 i = 0; i < 10; ++i)
+		{
+			items.push_back(makeItem(cats[i % 2]->getUUID(), i));
+		}
+
+		LLUUID owner_id = LLUUID::generateNewID();
+		LLInventoryCacheWriter writer(7);
+		for (size_t i = 0; i < cats.size(); ++i)
+		{
+			writer.addCategory(cats[i], owner_id, 100 + (S32)i);
+		}
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			writer.addItem(items[i]);
+		}
+		// Not under any cached category, dropped.
+		LLPointer<LLInventoryItem> orphan = makeItem(LLUUID::generateNewID(), 99);
+		writer.addItem(orphan);
+		ensure("written", writer.write(mFilename));
+		ensure_equals("written categories", writer.getWrittenCategoryCount(), 3);
+		ensure_equals("written items", writer.getWrittenItemCount(), 10);
+
+		LLInventoryCacheReader reader;
+		ensure("opened", reader.open(mFilename, 7));
+		ensure_equals("categories", reader.getCategoryCount(), 3);
+		ensure_equals("items", reader.getItemCount(), 10);
+		ensure_equals("unknown category", reader.findCategory(LLUUID::generateNewID()), -1);
+
+		for (size_t i = 0; i < cats.size(); ++i)
+		{
+			S32 index = reader.findCategory(cats[i]->getUUID());
+			ensure("category found", index >= 0);
+			ensure_equals("version", reader.getCategoryVersion(index), 100 + (S32)i);
+			ensure_equals("owner", reader.getCategoryOwnerID(index), owner_id);
+
+			LLPointer<LLInventoryCategory> cat = new LLInventoryCategory;
+			reader.loadCategory(index, cat);
+			ensure_equals("category id", cat->getUUID(), cats[i]->getUUID());
+			ensure_equals("category parent", cat->getParentUUID(), cats[i]->getParentUUID());
+			ensure_equals("category name", cat->getName(), cats[i]->getName());
+			ensure_equals("preferred type", cat->getPreferredType(), LLFolderType::FT_CLOTHING);
+
+			// Items keep their order within the category.
+			S32 expected_count = i < 2 ? 5 : 0;
+			ensure_equals("item count", reader.getCategoryItemCount(index), expected_count);
+			for (S32 n = 0; n < expected_count; ++n)
+			{
+				LLPointer<LLInventoryItem> item = new LLInventoryItem;
+				ensure("item loaded", reader.loadItem(index, n, item));
+				ensureSameItem(items[n * 2 + i], item);
+			}
+			LLPointer<LLInventoryItem> item = new LLInventoryItem;
+			ensure("past the end", !reader.loadItem(index, expected_count, item));
+		}
+	}
+
+	template<> template<>
+	void llinventorycache_object::test<2>()
+	{
+		set_test_name("rejected files");
+		LLPointer<LLInventoryCategory> cat = makeCategory("Folder");
+		LLPointer<LLInventoryItem> item = makeItem(cat->getUUID(), 0);
+		LLInventoryCacheWriter writer(2);
+		writer.addCategory(cat, LLUUID::null, 1);
+		writer.addItem(item);
+		ensure("written", writer.write(mFilename));
+
+		LLInventoryCacheReader reader;
+		ensure("other cache version", !reader.open(mFilename, 3));
+		ensure("not open", !reader.isOpen());
+		ensure_equals("no categories", reader.findCategory(cat->getUUID()), -1);
+
+		// Cut off the string table.
+		llstat stat_data;
+		ensure_equals("stat", LLFile::stat(mFilename, &stat_data), 0);
+		std::vector<char> data(stat_data.st_size);
+		LLFILE* fp = LLFile::fopen(mFilename, "rb");
+		ensure("read", fp && fread(&data[0], 1, data.size(), fp) == data.size());
+		fclose(fp);
+		fp = LLFile::fopen(mFilename, "wb");
+		fwrite(&data[0], 1, data.size() - 4, fp);
+		fclose(fp);
+		ensure("truncated", !reader.open(mFilename, 2));
+
+		fp = LLFile::fopen(mFilename, "wb");
+		fputs("{inv_cache_version:2}\n", fp);
+		fclose(fp);
+		ensure("legacy cache", !reader.open(mFilename, 2));
+
+		LLFile::remove(mFilename);
+		ensure("missing", !reader.open(mFilename, 2));
+	}
+
+	template<> template<>
+	void llinventorycache_object::test<3>()
+	{
+		set_test_name("unknown asset type");
+		LLPointer<LLInventoryCategory> cat = makeCategory("Folder");
+		LLPointer<LLInventoryItem> item = makeItem(cat->getUUID(), 0, (LLAssetType::EType)120);
+		LLInventoryCacheWriter writer(2);
+		writer.addCategory(cat, LLUUID::null, 1);
+		writer.addItem(item);
+		ensure("written", writer.write(mFilename));
+
+		LLInventoryCacheReader reader;
+		ensure("opened", reader.open(mFilename, 2));
+		LLPointer<LLInventoryItem> loaded = new LLInventoryItem;
+		ensure("item loaded", reader.loadItem(0, 0, loaded));
+		ensure_equals("unknown type", loaded->getType(), LLAssetType::AT_UNKNOWN);
+	}
+}
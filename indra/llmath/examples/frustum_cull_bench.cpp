@@ -0,0 +1,364 @@
+/**
+ * @file frustum_cull_bench.cpp
+ * @brief Times frustum culling synthetic octrees group by group, against testing their flat bounds arrays a block at a time.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "llcamera.h"
+#include "llcullboundsarray.h"
+#include "lloctree.h"
+#include "llrand.h"
+#include "lltimer.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tfrustum_cull_bench [options]\n"
+		"\n"
+		"Builds octrees of synthetic objects spread over a region, the way\n"
+		"LLSpatialPartition groups them, and times culling them against a\n"
+		"turning camera: the recursive traversal testing one group at a\n"
+		"time, the same traversal asking LLCullBoundsPass, which tests the\n"
+		"partition's flat bounds array a block at a time, and testing the\n"
+		"whole array in one go.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -g <count>      Smallest partition in groups.  Default:  10000\n"
+		" -G <count>      Largest partition in groups.  Default:  100000\n"
+		" -f <frames>     Frames per partition.  Default:  240\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+class BenchEntry : public LLRefCount
+{
+	LL_ALIGN_NEW
+public:
+	BenchEntry(const LLVector4a& center, F32 radius)
+	:	mBinRadius(radius),
+		mBinIndex(-1)
+	{
+		mPositionGroup = center;
+		LLVector4a size;
+		size.splat(radius);
+		mExtents[0].setSub(center, size);
+		mExtents[1].setAdd(center, size);
+	}
+
+	const LLVector4a& getPositionGroup() const	{ return mPositionGroup; }
+	F32 getBinRadius() const					{ return mBinRadius; }
+	S32 getBinIndex() const						{ return mBinIndex; }
+	void setBinIndex(S32 index) const			{ mBinIndex = index; }
+
+	LL_ALIGN_16(LLVector4a mPositionGroup);
+	LL_ALIGN_16(LLVector4a mExtents[2]);
+	F32 mBinRadius;
+	mutable S32 mBinIndex;
+};
+
+typedef LLOctreeNode<BenchEntry, LLPointer<BenchEntry> > BenchNode;
+typedef LLOctreeRoot<BenchEntry, LLPointer<BenchEntry> > BenchRoot;
+typedef LLOctreeListener<BenchEntry, LLPointer<BenchEntry> > BenchListener;
+typedef LLOctreeTraveler<BenchEntry, LLPointer<BenchEntry> > BenchTraveler;
+
+// What LLViewerOctreeGroup keeps for culling: its bounds, and with the
+// flat arrays a slot in its partition's one
+class BenchGroup : public BenchListener
+{
+	LL_ALIGN_NEW
+public:
+	BenchGroup(BenchNode* node, LLCullBoundsArray& cull_bounds, LLCullBoundsArray::slot_t cull_slot)
+	:	mNode(node),
+		mCullBounds(cull_bounds),
+		mCullSlot(cull_slot)
+	{
+		mBounds[0] = node->getCenter();
+		mBounds[1] = node->getSize();
+		node->addListener(this);
+	}
+
+	~BenchGroup()
+	{
+		mCullBounds.remove(mCullSlot);
+	}
+
+	virtual void handleInsertion(const LLTreeNode<BenchEntry>* node, BenchEntry* data) {}
+	virtual void handleRemoval(const LLTreeNode<BenchEntry>* node, BenchEntry* data) {}
+	virtual void handleDestruction(const LLTreeNode<BenchEntry>* node) {}
+	virtual void handleStateChange(const LLTreeNode<BenchEntry>* node) {}
+	virtual void handleChildAddition(const BenchNode* parent, BenchNode* child)
+	{
+		new BenchGroup(child, mCullBounds, mCullBounds.add(mCullSlot));
+	}
+	virtual void handleChildRemoval(const BenchNode* parent, const BenchNode* child) {}
+
+	// Tight bounds over children and elements, as LLViewerOctreeGroup::rebound()
+	void rebound()
+	{
+		bool empty = true;
+		for (U32 i = 0; i < mNode->getChildCount(); ++i)
+		{
+			BenchGroup* child = (BenchGroup*)mNode->getChild(i)->getListener(0);
+			child->rebound();
+			grow(child->mExtents, empty);
+		}
+		for (BenchNode::const_element_iter i = mNode->getDataBegin(); i != mNode->getDataEnd(); ++i)
+		{
+			grow((*i)->mExtents, empty);
+		}
+		mBounds[0].setAdd(mExtents[0], mExtents[1]);
+		mBounds[0].mul(0.5f);
+		mBounds[1].setSub(mExtents[1], mExtents[0]);
+		mBounds[1].mul(0.5f);
+		mCullBounds.set(mCullSlot, mBounds[0], mBounds[1]);
+	}
+
+	BenchNode* mNode;
+	LLCullBoundsArray& mCullBounds;
+	LLCullBoundsArray::slot_t mCullSlot;
+	LL_ALIGN_16(LLVector4a mBounds[2]);
+	LL_ALIGN_16(LLVector4a mExtents[2]);
+
+private:
+	void grow(const LLVector4a* extents, bool& empty)
+	{
+		if (empty)
+		{
+			mExtents[0] = extents[0];
+			mExtents[1] = extents[1];
+			empty = false;
+		}
+		else
+		{
+			mExtents[0].setMin(mExtents[0], extents[0]);
+			mExtents[1].setMax(mExtents[1], extents[1]);
+		}
+	}
+};
+
+// LLViewerOctreeCull::traverse(): test a group, skip its branch when it is
+// outside, stop testing below one that is fully inside
+class BenchCull : public BenchTraveler
+{
+public:
+	BenchCull(LLCamera* camera)
+	:	mCamera(camera),
+		mRes(0),
+		mVisible(0)
+	{
+	}
+
+	virtual void traverse(const BenchNode* n)
+	{
+		const BenchGroup* group = (const BenchGroup*)n->getListener(0);
+		if (mRes == 2)
+		{
+			BenchTraveler::traverse(n);
+		}
+		else
+		{
+			mRes = frustumCheck(group);
+			if (mRes)
+			{
+				BenchTraveler::traverse(n);
+			}
+			mRes = 0;
+		}
+	}
+
+	virtual void visit(const BenchNode* branch)
+	{
+		mVisible += 1 + branch->getElementCount();
+	}
+
+	virtual S32 frustumCheck(const BenchGroup* group)
+	{
+		return mCamera->AABBInFrustum(group->mBounds[0], group->mBounds[1]);
+	}
+
+	LLCamera* mCamera;
+	S32 mRes;
+	U64 mVisible;
+};
+
+// The same traversal asking a pass over the flat array, which tests a
+// block of slots the first time one of them is asked for
+class BenchFlatCull : public BenchCull
+{
+public:
+	BenchFlatCull(LLCamera* camera, LLCullBoundsPass& pass)
+	:	BenchCull(camera),
+		mPass(pass)
+	{
+	}
+
+	virtual S32 frustumCheck(const BenchGroup* group)
+	{
+		return mPass.get(group->mCullSlot);
+	}
+
+	LLCullBoundsPass& mPass;
+};
+
+// Frustum planes from the corners of the view volume, as LLViewerCamera
+// derives them
+static void set_frustum(LLCamera& camera, const LLVector3& origin, const LLVector3& look_at)
+{
+	const F32 fov = 1.f;
+	const F32 aspect = 16.f / 9.f;
+	const F32 dist[2] = { 0.5f, 128.f };
+	camera.setView(fov);
+	camera.setAspect(aspect);
+	camera.setNear(dist[0]);
+	camera.setFar(dist[1]);
+	camera.setOriginAndLookAt(origin, LLVector3::z_axis, look_at);
+
+	LLVector3 frust[8];
+	for (S32 i = 0; i < 2; ++i)
+	{
+		const LLVector3 center = origin + camera.getAtAxis() * dist[i];
+		const LLVector3 up = camera.getUpAxis() * (dist[i] * tanf(fov * 0.5f));
+		const LLVector3 right = camera.getLeftAxis() * (-dist[i] * tanf(fov * 0.5f) * aspect);
+		frust[i * 4 + 0] = center - right - up;
+		frust[i * 4 + 1] = center + right - up;
+		frust[i * 4 + 2] = center + right + up;
+		frust[i * 4 + 3] = center - right + up;
+	}
+	camera.calcAgentFrustumPlanes(frust);
+}
+
+// Builds are clustered like a region's: most objects near the ground,
+// many small ones around a few larger ones
+static void populate(BenchRoot& root, LLCullBoundsArray& bounds, U32 groups)
+{
+	LLVector4a center;
+	while (bounds.size() < groups)
+	{
+		const F32 x = ll_frand(256.f);
+		const F32 y = ll_frand(256.f);
+		for (S32 i = 0; i < 32; ++i)
+		{
+			center.set(llclamp(x + ll_frand(16.f) - 8.f, 0.f, 255.f),
+					   llclamp(y + ll_frand(16.f) - 8.f, 0.f, 255.f),
+					   20.f + ll_frand(ll_frand(1.f) < 0.1f ? 200.f : 20.f));
+			const F32 radius = i ? 0.05f + ll_frand(1.f) : 2.f + ll_frand(8.f);
+			root.insert(new BenchEntry(center, radius));
+		}
+	}
+	((BenchGroup*)root.getListener(0))->rebound();
+}
+
+int main(int argc, char** argv)
+{
+	U32 min_groups = 10000;
+	U32 max_groups = 100000;
+	S32 frames = 240;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-g" && i + 1 < argc)
+		{
+			min_groups = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-G" && i + 1 < argc)
+		{
+			max_groups = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-f" && i + 1 < argc)
+		{
+			frames = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	// Small nodes make partitions of this many groups out of a region's
+	// worth of objects
+	gOctreeMaxCapacity = 8;
+	gOctreeMinSize = 0.01f;
+
+	for (U32 groups = min_groups; groups <= max_groups; groups = groups < max_groups ? llmin(groups * 3, max_groups) : groups + 1)
+	{
+		LLCullBoundsArray bounds;
+		LLVector4a center(128.f, 128.f, 128.f);
+		LLVector4a size(128.f, 128.f, 128.f);
+		BenchRoot* root = new BenchRoot(center, size, NULL);
+		new BenchGroup(root, bounds, bounds.add());
+		populate(*root, bounds, groups);
+
+		LLCullBoundsPass pass;
+		std::vector<U8> results;
+		LLCamera camera;
+		const LLVector3 origin(128.f, 128.f, 35.f);
+		F64 recursive_seconds = 0.0;
+		F64 flat_seconds = 0.0;
+		F64 all_seconds = 0.0;
+		U64 recursive_visible = 0;
+		U64 flat_visible = 0;
+		for (S32 frame = 0; frame < frames; ++frame)
+		{
+			const F32 yaw = F_TWO_PI * frame / frames;
+			set_frustum(camera, origin, origin + LLVector3(cosf(yaw), sinf(yaw), -0.2f));
+
+			F64 start = LLTimer::getTotalSeconds();
+			BenchCull recursive(&camera);
+			recursive.traverse(root);
+			recursive_seconds += LLTimer::getTotalSeconds() - start;
+			recursive_visible += recursive.mVisible;
+
+			start = LLTimer::getTotalSeconds();
+			camera.AABBInFrustum(bounds, pass);
+			BenchFlatCull flat(&camera, pass);
+			flat.traverse(root);
+			flat_seconds += LLTimer::getTotalSeconds() - start;
+			flat_visible += flat.mVisible;
+
+			start = LLTimer::getTotalSeconds();
+			camera.AABBInFrustum(bounds, pass);
+			pass.testAll(results);
+			all_seconds += LLTimer::getTotalSeconds() - start;
+		}
+
+		const F64 per_frame = 1000.0 / frames;
+		fprintf(stdout, "%6u groups, %3.0f%% visible   recursive %7.3f ms   flat %7.3f ms  %.2fx%s   whole array %7.3f ms\n",
+				bounds.size(), recursive_visible * 100.0 / ((F64)frames * bounds.size()),
+				recursive_seconds * per_frame, flat_seconds * per_frame,
+				recursive_seconds / llmax(flat_seconds, 1e-9), recursive_visible == flat_visible ? "" : " (MISMATCH)",
+				all_seconds * per_frame);
+
+		delete root;
+	}
+	return 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * @file octree_churn_bench.cpp
+ * @brief Times inserting, moving, traversing and removing elements of a synthetic octree, with and without the node pool.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "lloctree.h"
+#include "llrand.h"
+#include "lltimer.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\toctree_churn_bench [options]\n"
+		"\n"
+		"Fills an octree with synthetic objects spread over a region, moves\n"
+		"some of them every frame the way LLSpatialPartition does, out and\n"
+		"back in from the root, and times that together with inserting,\n"
+		"traversing and removing everything.  Each tree is built once with\n"
+		"its nodes on the heap and once from the node pool, alternating,\n"
+		"and the best of each is reported.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -e <count>      Elements in the tree.  Default:  50000\n"
+		" -f <frames>     Frames of moves, a twentieth of the elements each.  Default:  100\n"
+		" -r <rounds>     Trees built of each kind.  Default:  3\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+class BenchEntry : public LLRefCount
+{
+	LL_ALIGN_NEW
+public:
+	BenchEntry(const LLVector4a& center, F32 radius)
+	:	mBinRadius(radius),
+		mBinIndex(-1)
+	{
+		mPositionGroup = center;
+	}
+
+	const LLVector4a& getPositionGroup() const	{ return mPositionGroup; }
+	F32 getBinRadius() const					{ return mBinRadius; }
+	S32 getBinIndex() const						{ return mBinIndex; }
+	void setBinIndex(S32 index) const			{ mBinIndex = index; }
+	void setPositionGroup(const LLVector4a& center) { mPositionGroup = center; }
+
+	LL_ALIGN_16(LLVector4a mPositionGroup);
+	F32 mBinRadius;
+	mutable S32 mBinIndex;
+};
+
+typedef LLOctreeNode<BenchEntry, LLPointer<BenchEntry> > BenchNode;
+typedef LLOctreeRoot<BenchEntry, LLPointer<BenchEntry> > BenchRoot;
+typedef LLOctreeListener<BenchEntry, LLPointer<BenchEntry> > BenchListener;
+typedef LLOctreeTraveler<BenchEntry, LLPointer<BenchEntry> > BenchTraveler;
+typedef std::vector<LLPointer<BenchEntry> > entry_list_t;
+
+// One per node, as the viewer's octree groups are
+class BenchGroup : public BenchListener
+{
+public:
+	BenchGroup(BenchNode* node)
+	{
+		node->addListener(this);
+	}
+
+	virtual void handleInsertion(const LLTreeNode<BenchEntry>* node, BenchEntry* data) {}
+	virtual void handleRemoval(const LLTreeNode<BenchEntry>* node, BenchEntry* data) {}
+	virtual void handleDestruction(const LLTreeNode<BenchEntry>* node) {}
+	virtual void handleStateChange(const LLTreeNode<BenchEntry>* node) {}
+	virtual void handleChildAddition(const BenchNode* parent, BenchNode* child)
+	{
+		if (!child->getListenerCount())
+		{
+			new BenchGroup(child);
+		}
+	}
+	virtual void handleChildRemoval(const BenchNode* parent, const BenchNode* child) {}
+};
+
+// What a cull does with every node it reaches
+class TouchTraveler : public BenchTraveler
+{
+public:
+	virtual void visit(const BenchNode* branch)
+	{
+		mSum += branch->getCenter()[0] + branch->getSize()[0];
+		for (BenchNode::const_element_iter i = branch->getDataBegin(); i != branch->getDataEnd(); ++i)
+		{
+			mSum += (*i)->getBinRadius();
+		}
+		++mNodes;
+	}
+
+	F32 mSum = 0.f;
+	U32 mNodes = 0;
+};
+
+struct TreeTimes
+{
+	void keepBest(const TreeTimes& other)
+	{
+		mInsert = llmin(mInsert, other.mInsert);
+		mChurn = llmin(mChurn, other.mChurn);
+		mTraverse = llmin(mTraverse, other.mTraverse);
+		mRemove = llmin(mRemove, other.mRemove);
+		mNodes = other.mNodes;
+	}
+
+	F64 mInsert = DBL_MAX;
+	F64 mChurn = DBL_MAX;
+	F64 mTraverse = DBL_MAX;
+	F64 mRemove = DBL_MAX;
+	U32 mNodes = 0;
+};
+
+static LLVector4a random_position()
+{
+	LLVector4a pos;
+	pos.set(ll_frand(256.f), ll_frand(256.f), ll_frand(128.f));
+	return pos;
+}
+
+// Mostly small things with some big ones, as in a region
+static void make_entries(entry_list_t& entries, S32 count)
+{
+	for (S32 i = 0; i < count; ++i)
+	{
+		const F32 radius = ll_frand() < 0.9f ? 0.1f + ll_frand(2.f) : 2.f + ll_frand(30.f);
+		entries.push_back(new BenchEntry(random_position(), radius));
+	}
+}
+
+// How LLSpatialPartition moves an element, out and back in from the root
+static void move(BenchRoot* root, BenchEntry* entry, const LLVector4a& pos)
+{
+	LLPointer<BenchEntry> hold = entry;
+	BenchNode* node = root->getNodeAt(entry);
+	node->remove(entry);
+	entry->setPositionGroup(pos);
+	root->insert(entry);
+}
+
+// Mostly short steps, now and then a jump across the region
+static void churn(BenchRoot* root, entry_list_t& entries, S32 frames, S32 moves_per_frame)
+{
+	for (S32 frame = 0; frame < frames; ++frame)
+	{
+		for (S32 i = 0; i < moves_per_frame; ++i)
+		{
+			BenchEntry* entry = entries[ll_rand((S32)entries.size())];
+			LLVector4a pos = entry->getPositionGroup();
+			LLVector4a step;
+			step.set(ll_frand(8.f) - 4.f, ll_frand(8.f) - 4.f, ll_frand(2.f) - 1.f);
+			pos.add(step);
+			move(root, entry, ll_frand() < 0.05f ? random_position() : pos);
+		}
+		root->balance();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	S32 entry_count = 50000;
+	S32 frames = 100;
+	S32 rounds = 3;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-e" && i + 1 < argc)
+		{
+			entry_count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-f" && i + 1 < argc)
+		{
+			frames = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			rounds = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	// Viewer defaults
+	gOctreeMaxCapacity = 128;
+	gOctreeMinSize = 0.01f;
+
+	const S32 moves = llmax(entry_count / 20, 1);
+	const S32 traversals = 50;
+
+	fprintf(stdout, "%d entries, %d frames of %d moves, best of %d\n", entry_count, frames, moves, rounds);
+
+	// Alternating, the allocator is warmer for later runs
+	TreeTimes best[2];
+	for (S32 round = 0; round < rounds; ++round)
+	{
+		for (S32 pooled = 0; pooled < 2; ++pooled)
+		{
+			entry_list_t entries;
+			make_entries(entries, entry_count);
+
+			TreeTimes times;
+			LLVector4a center, size;
+			center.splat(0.f);
+			size.splat(1.f);
+			BenchRoot* root = new BenchRoot(center, size, NULL, pooled);
+			new BenchGroup(root);
+
+			F64 start = LLTimer::getTotalSeconds();
+			for (LLPointer<BenchEntry>& entry : entries)
+			{
+				root->insert(entry);
+			}
+			times.mInsert = (LLTimer::getTotalSeconds() - start) * 1000.0;
+
+			start = LLTimer::getTotalSeconds();
+			churn(root, entries, frames, moves);
+			times.mChurn = (LLTimer::getTotalSeconds() - start) * 1000.0 / frames;
+
+			TouchTraveler touch;
+			start = LLTimer::getTotalSeconds();
+			for (S32 i = 0; i < traversals; ++i)
+			{
+				touch.traverse(root);
+			}
+			times.mTraverse = (LLTimer::getTotalSeconds() - start) * 1000.0 / traversals;
+			times.mNodes = touch.mNodes / traversals;
+
+			start = LLTimer::getTotalSeconds();
+			for (LLPointer<BenchEntry>& entry : entries)
+			{
+				root->getNodeAt(entry)->remove(entry);
+			}
+			times.mRemove = (LLTimer::getTotalSeconds() - start) * 1000.0;
+			delete root;
+
+			best[pooled].keepBest(times);
+		}
+	}
+
+	for (S32 pooled = 0; pooled < 2; ++pooled)
+	{
+		const TreeTimes& times = best[pooled];
+		fprintf(stdout, "  %s %6u nodes   insert %8.3f ms   churn %7.3f ms per frame   traverse %7.3f ms   remove %8.3f ms\n",
+				pooled ? "pooled" : "heap  ", times.mNodes, times.mInsert, times.mChurn, times.mTraverse, times.mRemove);
+	}
+	return 0;
+}
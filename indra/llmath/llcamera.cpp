@@ -28,6 +28,7 @@
 
 #include "llmath.h"
 #include "llcamera.h"
+#include "llcullboundsarray.h" // <FS:Kadah/> Batched frustum tests
 
 // ---------------- Constructors and destructors ----------------
 
@@ -296,6 +297,31 @@ S32 LLCamera::AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVec
 	return AABBInFrustumNoFarClip(center, radius, mRegionPlanes);
 }
 
+// <FS:Kadah> Batched versions of the four tests above
+void LLCamera::AABBInFrustum(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass, const LLPlane* planes)
+{
+	pass.begin(bounds, planes ? planes : mAgentPlanes, mPlaneMask, llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM));
+}
+
+void LLCamera::AABBInRegionFrustum(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass)
+{
+	AABBInFrustum(bounds, pass, mRegionPlanes);
+}
+
+void LLCamera::AABBInFrustumNoFarClip(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass, const LLPlane* planes)
+{
+	U8 masks[PLANE_MASK_NUM];
+	memcpy(masks, mPlaneMask, sizeof(masks));
+	masks[AGENT_PLANE_FAR] = PLANE_MASK_NONE;
+	pass.begin(bounds, planes ? planes : mAgentPlanes, masks, llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM));
+}
+
+void LLCamera::AABBInRegionFrustumNoFarClip(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass)
+{
+	AABBInFrustumNoFarClip(bounds, pass, mRegionPlanes);
+}
+// </FS:Kadah>
+
 int LLCamera::sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius) 
 {
 	LLVector3 dist = sphere_center-mFrustCenter;
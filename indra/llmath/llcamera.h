@@ -33,6 +33,11 @@
 #include "llplane.h"
 #include "llvector4a.h"
 
+// <FS:Kadah> Batched frustum tests
+class LLCullBoundsArray;
+class LLCullBoundsPass;
+// </FS:Kadah>
+
 const F32 DEFAULT_FIELD_OF_VIEW 	= 60.f * DEG_TO_RAD;
 const F32 DEFAULT_ASPECT_RATIO 		= 640.f / 480.f;
 const F32 DEFAULT_NEAR_PLANE 		= 0.25f;
@@ -208,6 +213,12 @@ public:
 	S32 AABBInRegionFrustum(const LLVector4a& center, const LLVector4a& radius);
 	S32 AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius, const LLPlane* planes = NULL);
 	S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius);
+	// <FS:Kadah> Sets pass up to answer the tests above for every box of bounds
+	void AABBInFrustum(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass, const LLPlane* planes = NULL);
+	void AABBInRegionFrustum(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass);
+	void AABBInFrustumNoFarClip(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass, const LLPlane* planes = NULL);
+	void AABBInRegionFrustumNoFarClip(const LLCullBoundsArray& bounds, LLCullBoundsPass& pass);
+	// </FS:Kadah>
 
 	//does a quick 'n dirty sphere-sphere check
 	S32 sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius); 
@@ -0,0 +1,236 @@
+/**
+ * @file llcullboundsarray.cpp
+ * @brief Bounding boxes of octree groups in structure of arrays form, culled a block at a time.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llcullboundsarray.h"
+
+#include "llcamera.h"
+#include "llplane.h"
+#include "llvector4a.h"
+
+LLCullBoundsArray::LLCullBoundsArray()
+:	mUsed(0),
+	mStamp(0)
+{
+}
+
+LLCullBoundsArray::slot_t LLCullBoundsArray::add(slot_t near)
+{
+	if (near != INVALID_SLOT && mBlocks[near / BLOCK_SIZE].mFree)
+	{
+		return take(near / BLOCK_SIZE);
+	}
+
+	while (!mFreeBlocks.empty())
+	{
+		const U32 block = mFreeBlocks.back();
+		if (mBlocks[block].mFree)
+		{
+			return take(block);
+		}
+		mFreeBlocks.pop_back();
+	}
+
+	Block block;
+	memset(&block, 0, sizeof(Block));
+	block.mFree = 0xff;
+	mBlocks.push_back(block);
+	mFreeBlocks.push_back((U32)mBlocks.size() - 1);
+	return take((U32)mBlocks.size() - 1);
+}
+
+void LLCullBoundsArray::remove(slot_t slot)
+{
+	llassert(slot >= 0 && (U32)slot < getCapacity());
+	Block& block = mBlocks[slot / BLOCK_SIZE];
+	llassert(!(block.mFree & (1 << (slot % BLOCK_SIZE))));
+	if (!block.mFree)
+	{
+		mFreeBlocks.push_back(slot / BLOCK_SIZE);
+	}
+	block.mFree |= 1 << (slot % BLOCK_SIZE);
+	block.mStamp = ++mStamp;
+	--mUsed;
+}
+
+void LLCullBoundsArray::clear()
+{
+	mBlocks.clear();
+	mFreeBlocks.clear();
+	mUsed = 0;
+	++mStamp;
+}
+
+void LLCullBoundsArray::set(slot_t slot, const LLVector4a& center, const LLVector4a& size)
+{
+	llassert(slot >= 0 && (U32)slot < getCapacity());
+	Block& block = mBlocks[slot / BLOCK_SIZE];
+	const U32 i = slot % BLOCK_SIZE;
+	block.mCenterX[i] = center[0];
+	block.mCenterY[i] = center[1];
+	block.mCenterZ[i] = center[2];
+	block.mSizeX[i] = size[0];
+	block.mSizeY[i] = size[1];
+	block.mSizeZ[i] = size[2];
+	block.mStamp = ++mStamp;
+}
+
+LLCullBoundsArray::slot_t LLCullBoundsArray::take(U32 index)
+{
+	Block& block = mBlocks[index];
+	U32 i = 0;
+	while (!(block.mFree & (1 << i)))
+	{
+		++i;
+	}
+	block.mFree &= ~(1 << i);
+	block.mCenterX[i] = block.mCenterY[i] = block.mCenterZ[i] = 0.f;
+	block.mSizeX[i] = block.mSizeY[i] = block.mSizeZ[i] = 0.f;
+	block.mStamp = ++mStamp;
+	++mUsed;
+	return index * BLOCK_SIZE + i;
+}
+
+namespace
+{
+	// 2 where neither, 1 where partial, 0 where outside, as 32 bit lanes
+	inline __m128i classify(__m128 outside, __m128 partial)
+	{
+		const __m128i two = _mm_set1_epi32(2);
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i res = _mm_sub_epi32(two, _mm_and_si128(_mm_castps_si128(partial), one));
+		return _mm_andnot_si128(_mm_castps_si128(outside), res);
+	}
+}
+
+LLCullBoundsPass::LLCullBoundsPass()
+:	mBounds(NULL),
+	mPlaneCount(0)
+{
+}
+
+void LLCullBoundsPass::begin(const LLCullBoundsArray& bounds, const LLPlane* planes, const U8* plane_masks, U32 plane_count)
+{
+	mBounds = &bounds;
+	mPlaneCount = 0;
+	for (U32 i = 0; i < llmin(plane_count, (U32)LLCamera::PLANE_MASK_NUM); ++i)
+	{
+		const U8 mask = plane_masks[i];
+		if (mask >= LLCamera::PLANE_MASK_NUM)
+		{
+			continue;
+		}
+		CullPlane& p = mPlanes[mPlaneCount++];
+		p.mX = _mm_set1_ps(planes[i][0]);
+		p.mY = _mm_set1_ps(planes[i][1]);
+		p.mZ = _mm_set1_ps(planes[i][2]);
+		p.mDist = _mm_set1_ps(-planes[i][3]);
+		p.mSignX = _mm_set1_ps(mask & 1 ? 1.f : -1.f);
+		p.mSignY = _mm_set1_ps(mask & 2 ? 1.f : -1.f);
+		p.mSignZ = _mm_set1_ps(mask & 4 ? 1.f : -1.f);
+	}
+
+	BlockResults untested;
+	memset(&untested, 0, sizeof(untested));
+	mResults.assign(bounds.mBlocks.size(), untested);
+}
+
+void LLCullBoundsPass::end()
+{
+	mBounds = NULL;
+}
+
+void LLCullBoundsPass::testAll(std::vector<U8>& results)
+{
+	const U32 blocks = (U32)mBounds->mBlocks.size();
+	results.resize(blocks * LLCullBoundsArray::BLOCK_SIZE);
+	for (U32 block = 0; block < blocks; ++block)
+	{
+		testBlock(block);
+		memcpy(&results[block * LLCullBoundsArray::BLOCK_SIZE], mResults[block].mResults, LLCullBoundsArray::BLOCK_SIZE);
+	}
+}
+
+// Same operations in the same order as LLCamera::AABBInFrustum(), which
+// goes through LLVector4a::dot3(): (x + y) + z, no fused multiply add.
+// outside collects min corners past a plane, partial max corners.
+void LLCullBoundsPass::testBlock(U32 index)
+{
+	if (index >= mResults.size())
+	{
+		// The array grew since begin()
+		BlockResults untested;
+		memset(&untested, 0, sizeof(untested));
+		mResults.resize(mBounds->mBlocks.size(), untested);
+	}
+
+	const LLCullBoundsArray::Block& block = mBounds->mBlocks[index];
+	BlockResults& results = mResults[index];
+	results.mStamp = llmax(mBounds->getStamp(), (U64)1);
+
+	__m128 outside[2];
+	__m128 partial[2];
+	for (U32 half = 0; half < 2; ++half)
+	{
+		const U32 i = half * 4;
+		const __m128 cx = _mm_load_ps(&block.mCenterX[i]);
+		const __m128 cy = _mm_load_ps(&block.mCenterY[i]);
+		const __m128 cz = _mm_load_ps(&block.mCenterZ[i]);
+		const __m128 sx = _mm_load_ps(&block.mSizeX[i]);
+		const __m128 sy = _mm_load_ps(&block.mSizeY[i]);
+		const __m128 sz = _mm_load_ps(&block.mSizeZ[i]);
+
+		__m128 out = _mm_setzero_ps();
+		__m128 part = _mm_setzero_ps();
+		for (U32 p = 0; p < mPlaneCount; ++p)
+		{
+			const CullPlane& plane = mPlanes[p];
+			const __m128 rx = _mm_mul_ps(sx, plane.mSignX);
+			const __m128 ry = _mm_mul_ps(sy, plane.mSignY);
+			const __m128 rz = _mm_mul_ps(sz, plane.mSignZ);
+
+			__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.mX, _mm_sub_ps(cx, rx)), _mm_mul_ps(plane.mY, _mm_sub_ps(cy, ry))),
+									_mm_mul_ps(plane.mZ, _mm_sub_ps(cz, rz)));
+			out = _mm_or_ps(out, _mm_cmpgt_ps(dot, plane.mDist));
+			// Most of the world is behind a side plane, stop once these are
+			if (_mm_movemask_ps(out) == 0xf)
+			{
+				break;
+			}
+
+			dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.mX, _mm_add_ps(cx, rx)), _mm_mul_ps(plane.mY, _mm_add_ps(cy, ry))),
+							 _mm_mul_ps(plane.mZ, _mm_add_ps(cz, rz)));
+			part = _mm_or_ps(part, _mm_cmpgt_ps(dot, plane.mDist));
+		}
+		outside[half] = out;
+		partial[half] = part;
+	}
+
+	const __m128i packed = _mm_packs_epi32(classify(outside[0], partial[0]), classify(outside[1], partial[1]));
+	_mm_storel_epi64((__m128i*)results.mResults, _mm_packus_epi16(packed, packed));
+}
@@ -0,0 +1,151 @@
+/**
+ * @file llcullboundsarray.h
+ * @brief Bounding boxes of octree groups in structure of arrays form, culled a block at a time.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLCULLBOUNDSARRAY_H
+#define LL_LLCULLBOUNDSARRAY_H
+
+#include <vector>
+#include <emmintrin.h>
+
+class LLPlane;
+class LLVector4a;
+
+// Centers and half sizes of many boxes, kept in blocks of eight with one
+// array per component, so that a camera can test them against its planes
+// several at a time instead of one box per octree node visited.  Owners
+// keep the slot add() gave them and write their box through set() whenever
+// it changes.
+//
+// Every set() stamps the block of its slot, so results worked out earlier
+// can tell whether a box in it moved since.
+class LLCullBoundsArray
+{
+	friend class LLCullBoundsPass;
+public:
+	typedef S32 slot_t;
+	static const slot_t INVALID_SLOT = -1;
+
+	// Boxes tested per iteration, and slots per block
+	static const U32 BLOCK_SIZE = 8;
+
+	LLCullBoundsArray();
+
+	// A free slot in the same block as near when there is one.  Octree
+	// groups pass their parent's slot, a traversal testing the children of
+	// a node then tests as few blocks as it can.
+	slot_t add(slot_t near = INVALID_SLOT);
+	void remove(slot_t slot);
+	void clear();
+
+	void set(slot_t slot, const LLVector4a& center, const LLVector4a& size);
+
+	// Slots in use
+	U32 size() const					{ return mUsed; }
+	// Slots including the free ones, a multiple of BLOCK_SIZE
+	U32 getCapacity() const				{ return (U32)mBlocks.size() * BLOCK_SIZE; }
+
+	U64 getStamp() const				{ return mStamp; }
+	// Whether the block of slot was written after stamp
+	bool changedSince(slot_t slot, U64 stamp) const { return mBlocks[slot / BLOCK_SIZE].mStamp > stamp; }
+
+private:
+	slot_t take(U32 block);
+
+	// Four cache lines, what testing eight boxes reads
+	struct Block
+	{
+		U64 mStamp;						// of the last set() or remove() in the block
+		U8 mFree;						// bit per free slot
+		alignas(16) F32 mCenterX[BLOCK_SIZE];
+		F32 mCenterY[BLOCK_SIZE];
+		F32 mCenterZ[BLOCK_SIZE];
+		F32 mSizeX[BLOCK_SIZE];
+		F32 mSizeY[BLOCK_SIZE];
+		F32 mSizeZ[BLOCK_SIZE];
+	};
+
+	std::vector<Block> mBlocks;
+	std::vector<U32> mFreeBlocks;		// blocks that had a slot freed, some may be full again
+	U32 mUsed;
+	U64 mStamp;
+};
+
+// One set of planes against one LLCullBoundsArray, answering what
+// LLCamera::AABBInFrustum() would for each slot: 0 outside, 1 partly and 2
+// fully inside.  The arithmetic is the same, so are the answers.
+//
+// Nothing is tested up front.  The first get() in a block tests the whole
+// block, so a traversal that never reaches a branch never pays for it.  A
+// block is tested again when one of its boxes was set() since.
+class LLCullBoundsPass
+{
+public:
+	LLCullBoundsPass();
+
+	// Planes with a mask of LLCamera::PLANE_MASK_NUM or above are skipped
+	void begin(const LLCullBoundsArray& bounds, const LLPlane* planes, const U8* plane_masks, U32 plane_count);
+	void end();
+
+	const LLCullBoundsArray* getBounds() const	{ return mBounds; }
+
+	S32 get(LLCullBoundsArray::slot_t slot)
+	{
+		const U32 block = (U32)slot / LLCullBoundsArray::BLOCK_SIZE;
+		if (block >= mResults.size() || !mResults[block].mStamp || mBounds->changedSince(slot, mResults[block].mStamp))
+		{
+			testBlock(block);
+		}
+		return mResults[block].mResults[slot % LLCullBoundsArray::BLOCK_SIZE];
+	}
+
+	// Tests every block now, results[slot] for callers that want them all
+	void testAll(std::vector<U8>& results);
+
+private:
+	void testBlock(U32 block);
+
+	// One plane splatted across a register, with the corner it tests
+	struct CullPlane
+	{
+		__m128 mX, mY, mZ;
+		__m128 mDist;						// -d, what the dot product is compared to
+		__m128 mSignX, mSignY, mSignZ;		// sFrustumScaler[mask] in LLCamera
+	};
+
+	struct BlockResults
+	{
+		U64 mStamp;							// array stamp when tested, 0 until then
+		U8 mResults[LLCullBoundsArray::BLOCK_SIZE];
+	};
+
+	const LLCullBoundsArray* mBounds;
+	CullPlane mPlanes[8];
+	U32 mPlaneCount;
+	std::vector<BlockResults> mResults;
+};
+
+#endif // LL_LLCULLBOUNDSARRAY_H
@@ -22,8 +22,74 @@
  * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
  * $/LicenseInfo$
  */
-#include "stdtypes.h"
+// <FS:Kadah> Pooled octree nodes
+//#include "stdtypes.h"
+#include "linden_common.h"
+#include "lloctree.h"
+// </FS:Kadah>
 
 U32 gOctreeMaxCapacity;
 F32 gOctreeMinSize;
 
+// <FS:Kadah> Pooled octree nodes
+LLOctreeNodePool::LLOctreeNodePool(size_t node_size)
+:	mBlockSize((node_size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE),
+	mNextSlabNodes(MIN_SLAB_NODES),
+	mFree(NULL),
+	mNodeCount(0),
+	mReservedBytes(0)
+{
+}
+
+LLOctreeNodePool::~LLOctreeNodePool()
+{
+	llassert(mNodeCount == 0);
+	for (void* slab : mSlabs)
+	{
+		ll_aligned_free<CACHE_LINE>(slab);
+	}
+}
+
+void* LLOctreeNodePool::allocate()
+{
+	if (!mFree)
+	{
+		addSlab();
+	}
+	FreeBlock* block = mFree;
+	mFree = block->mNext;
+	++mNodeCount;
+	return block;
+}
+
+void LLOctreeNodePool::free(void* node)
+{
+	llassert(mNodeCount > 0);
+	FreeBlock* block = (FreeBlock*)node;
+	block->mNext = mFree;
+	mFree = block;
+	--mNodeCount;
+}
+
+void LLOctreeNodePool::addSlab()
+{
+	const size_t bytes = mBlockSize * mNextSlabNodes;
+	U8* slab = (U8*)ll_aligned_malloc<CACHE_LINE>(bytes);
+	if (!slab)
+	{
+		LL_ERRS() << "Out of memory allocating octree nodes" << LL_ENDL;
+	}
+	mSlabs.push_back(slab);
+	mReservedBytes += bytes;
+
+	// Threaded back to front, the first allocations walk the slab forward
+	for (S32 i = (S32)mNextSlabNodes - 1; i >= 0; --i)
+	{
+		FreeBlock* block = (FreeBlock*)(slab + i * mBlockSize);
+		block->mNext = mFree;
+		mFree = block;
+	}
+	mNextSlabNodes = llmin(mNextSlabNodes * 2, (U32)MAX_SLAB_NODES);
+}
+// </FS:Kadah>
+
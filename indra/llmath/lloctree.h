@@ -31,6 +31,7 @@
 #include "v3math.h"
 #include "llvector4a.h"
 #include <vector>
+#include <boost/container/small_vector.hpp> // <FS:Kadah/> Inline element storage
 
 #include "nd/ndoctreelog.h"
 
@@ -43,6 +44,51 @@
 extern U32 gOctreeMaxCapacity;
 extern float gOctreeMinSize;
 
+// <FS:Kadah> Pooled octree nodes
+// Fixed size blocks for the nodes of one tree.  Slabs start small and
+// double up to MAX_SLAB_NODES, so that the many small trees of volume faces
+// do not reserve much.  Blocks are rounded up to a cache line and reused
+// last freed first, the node a move just emptied is the next one created.
+// A pool lives as long as the last node that came from it.
+class LLOctreeNodePool : public LLRefCount
+{
+public:
+	enum
+	{
+		CACHE_LINE = 64,
+		MIN_SLAB_NODES = 8,
+		MAX_SLAB_NODES = 256
+	};
+
+	LLOctreeNodePool(size_t node_size);
+
+	void* allocate();
+	void free(void* node);
+
+	U32 getNodeCount() const					{ return mNodeCount; }
+	U32 getSlabCount() const					{ return (U32)mSlabs.size(); }
+	size_t getReservedBytes() const				{ return mReservedBytes; }
+
+protected:
+	~LLOctreeNodePool();
+
+private:
+	void addSlab();
+
+	struct FreeBlock
+	{
+		FreeBlock* mNext;
+	};
+
+	size_t mBlockSize;
+	U32 mNextSlabNodes;
+	FreeBlock* mFree;
+	std::vector<void*> mSlabs;
+	U32 mNodeCount;
+	size_t mReservedBytes;
+};
+// </FS:Kadah>
+
 /*#define LL_OCTREE_PARANOIA_CHECK 0
 #if LL_DARWIN
 #define LL_OCTREE_MAX_CAPACITY 32
@@ -91,9 +137,17 @@ class alignas(16) LLOctreeNode : public LLTreeNode<T>
     LL_ALIGN_NEW
 public:
 
+    // <FS:Kadah> Inline element storage
+    enum
+    {
+        INLINE_ELEMENTS = 4 // Most nodes of a settled tree hold a few elements, those need no allocation
+    };
+    // </FS:Kadah>
+
     typedef LLOctreeTraveler<T, T_PTR>                          oct_traveler;
     typedef LLTreeTraveler<T>                                   tree_traveler;
-    typedef std::vector<T_PTR>                                  element_list;
+    //typedef std::vector<T_PTR>                                  element_list;
+    typedef boost::container::small_vector<T_PTR, INLINE_ELEMENTS> element_list; // <FS:Kadah/> Inline element storage
     typedef typename element_list::iterator                     element_iter;
     typedef typename element_list::const_iterator               const_element_iter;
 	typedef typename std::vector<LLTreeListener<T>*>::iterator	tree_listener_iter;
@@ -146,10 +200,42 @@ public:
 
 		for (U32 i = 0; i < getChildCount(); i++)
 		{
-			delete getChild(i);
+			//delete getChild(i);
+			deleteNode(getChild(i)); // <FS:Kadah/> Pooled octree nodes
 		} 
 	}
 
+	// <FS:Kadah> Pooled octree nodes
+	// Children come from the tree's pool when it has one
+	oct_node* createChild(const LLVector4a& center, const LLVector4a& size)
+	{
+		if (mPool.isNull())
+		{
+			return new oct_node(center, size, this);
+		}
+
+		// LL_ALIGN_NEW hides the global placement new
+		oct_node* child = ::new (mPool->allocate()) oct_node(center, size, this);
+		child->mPool = mPool;
+		return child;
+	}
+
+	static void deleteNode(oct_node* node)
+	{
+		if (node->mPool.isNull())
+		{
+			delete node;
+			return;
+		}
+
+		LLPointer<LLOctreeNodePool> pool = node->mPool;
+		node->~oct_node();
+		pool->free(node);
+	}
+
+	LLOctreeNodePool* getPool() const					{ return mPool; }
+	// </FS:Kadah>
+
 	inline const BaseType* getParent()	const			{ return mParent; }
 	inline void setParent(BaseType* parent)				{ mParent = (oct_node*) parent; }
 	inline const LLVector4a& getCenter() const			{ return mCenter; }
@@ -418,7 +504,8 @@ public:
 
 				llassert(size[0] >= gOctreeMinSize*0.5f);
 				//make the new kid
-                child = new oct_node(center, size, this);
+                //child = new oct_node(center, size, this);
+                child = createChild(center, size); // <FS:Kadah/> Pooled octree nodes
 				addChild(child);
 								
 				child->insert(data);
@@ -575,7 +662,8 @@ public:
 		for (U32 i = 0; i < getChildCount(); i++) 
 		{	
 			mChild[i]->destroy();
-			delete mChild[i];
+			//delete mChild[i];
+			deleteNode(mChild[i]); // <FS:Kadah/> Pooled octree nodes
 		}
 	}
 
@@ -637,7 +725,8 @@ public:
 		if (destroy)
 		{
 			mChild[index]->destroy();
-			delete mChild[index];
+			//delete mChild[index];
+			deleteNode(mChild[index]); // <FS:Kadah/> Pooled octree nodes
 		}
 
 		--mChildCount;
@@ -698,11 +787,18 @@ protected:
 	oct_node* mParent;
 	U8 mOctant;
 
-    oct_node* mChild[8];
-	U8 mChildMap[8];
+	// <FS:Kadah> Pooled octree nodes, what a traversal reads next to each other
+	//oct_node* mChild[8];
+	//U8 mChildMap[8];
+	//U32 mChildCount;
 	U32 mChildCount;
+	U8 mChildMap[8];
+	oct_node* mChild[8];
+	// </FS:Kadah>
 
 	element_list mData;
+
+	LLPointer<LLOctreeNodePool> mPool; // <FS:Kadah/> Pooled octree nodes
 }; 
 
 //just like a regular node, except it might expand on insert and compress on balance
@@ -713,12 +809,27 @@ public:
     typedef LLOctreeNode<T, T_PTR> BaseType;
     typedef LLOctreeNode<T, T_PTR> oct_node;
 
+	// <FS:Kadah> Pooled octree nodes
+	//LLOctreeRoot(const LLVector4a& center, 
+	//			 const LLVector4a& size, 
+	//			 BaseType* parent)
+	//:	BaseType(center, size, parent)
+	//{
+	//}
+	// pool_nodes: allocate the nodes of this tree from a pool of its own
+	// instead of one heap allocation each
 	LLOctreeRoot(const LLVector4a& center, 
 				 const LLVector4a& size, 
-				 BaseType* parent)
+				 BaseType* parent,
+				 bool pool_nodes = false)
 	:	BaseType(center, size, parent)
 	{
+		if (pool_nodes)
+		{
+			this->mPool = new LLOctreeNodePool(sizeof(oct_node));
+		}
 	}
+	// </FS:Kadah>
 	
 	bool balance() override
 	{	
@@ -747,7 +858,8 @@ public:
 
 			//destroy child
 			child->clearChildren();
-			delete child;
+			//delete child;
+			oct_node::deleteNode(child); // <FS:Kadah/> Pooled octree nodes
 
 			return false;
 		}
@@ -840,7 +952,8 @@ public:
 				llassert(size[0] >= gOctreeMinSize);
 
 				//copy our children to a new branch
-                oct_node* newnode = new oct_node(center, size, this);
+                //oct_node* newnode = new oct_node(center, size, this);
+                oct_node* newnode = this->createChild(center, size); // <FS:Kadah/> Pooled octree nodes
 				
 				for (U32 i = 0; i < this->getChildCount(); i++)
 				{
@@ -2812,6 +2812,14 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
 	mSculptLevel = 0;
 }
 
+// <FS:Kadah> Mesh decode pipeline: take the faces of a volume decoded off thread without copying them
+void LLVolume::swapVolumeFaces(LLVolume* volume)
+{
+	mVolumeFaces.swap(volume->mVolumeFaces);
+	mSculptLevel = 0;
+}
+// </FS:Kadah>
+
 bool LLVolume::cacheOptimize()
 {
 	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
@@ -5913,7 +5921,8 @@ void LLVolumeFace::createOctree(F32 scaler, const LLVector4a& center, const LLVe
 	ND_OCTREE_LOG << "Creating octree with scale " << scaler << " mNumIndices " << mNumIndices << ND_OCTREE_LOG_END;
     llassert(mNumIndices % 3 == 0);
 
-    mOctree = new LLOctreeRoot<LLVolumeTriangle, LLVolumeTriangle*>(center, size, NULL);
+    //mOctree = new LLOctreeRoot<LLVolumeTriangle, LLVolumeTriangle*>(center, size, NULL);
+    mOctree = new LLOctreeRoot<LLVolumeTriangle, LLVolumeTriangle*>(center, size, NULL, true); // <FS:Kadah/> Pooled octree nodes, built and freed in one go
 	new LLVolumeOctreeListener(mOctree);
     const U32 num_triangles = mNumIndices / 3;
     // Initialize all the triangles we need
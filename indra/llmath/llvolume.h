@@ -1097,6 +1097,7 @@ public:
 	// NaCl End
 
 	void copyVolumeFaces(const LLVolume* volume);
+	void swapVolumeFaces(LLVolume* volume); // <FS:Kadah/> Mesh decode pipeline
 	void copyFacesTo(std::vector<LLVolumeFace> &faces) const;
 	void copyFacesFrom(const std::vector<LLVolumeFace> &faces);
 	bool cacheOptimize();
@@ -0,0 +1,259 @@
+/**
+ * @file llcullboundsarray_test.cpp
+ * @brief LLCullBoundsArray test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llcamera.h"
+#include "../llcullboundsarray.h"
+#include "llrand.h"
+
+namespace
+{
+	// Frustum planes the way LLViewerCamera derives them, from the corners
+	// of the view volume, near ones first
+	void set_frustum(LLCamera& camera, const LLVector3& origin, const LLVector3& look_at, F32 fov, F32 aspect, F32 near_dist, F32 far_dist)
+	{
+		camera.setView(fov);
+		camera.setAspect(aspect);
+		camera.setNear(near_dist);
+		camera.setFar(far_dist);
+		camera.setOriginAndLookAt(origin, LLVector3::z_axis, look_at);
+
+		LLVector3 frust[8];
+		const F32 dist[2] = { near_dist, far_dist };
+		for (S32 i = 0; i < 2; ++i)
+		{
+			const LLVector3 center = origin + camera.getAtAxis() * dist[i];
+			const LLVector3 up = camera.getUpAxis() * (dist[i] * tanf(fov * 0.5f));
+			const LLVector3 right = camera.getLeftAxis() * (-dist[i] * tanf(fov * 0.5f) * aspect);
+			frust[i * 4 + 0] = center - right - up;
+			frust[i * 4 + 1] = center + right - up;
+			frust[i * 4 + 2] = center + right + up;
+			frust[i * 4 + 3] = center - right + up;
+		}
+		camera.calcAgentFrustumPlanes(frust);
+	}
+
+	LLVector3 random_point(F32 range)
+	{
+		return LLVector3(ll_frand(range * 2.f) - range, ll_frand(range * 2.f) - range, ll_frand(range * 2.f) - range);
+	}
+}
+
+namespace tut
+{
+	struct LLCullBoundsArrayData
+	{
+	};
+
+	typedef test_group<LLCullBoundsArrayData> factory;
+	typedef factory::object object;
+}
+
+namespace
+{
+	tut::factory llcullboundsarray_test_factory("LLCullBoundsArray");
+}
+
+namespace tut
+{
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("slots and stamps");
+		LLCullBoundsArray bounds;
+		LLCullBoundsArray::slot_t a = bounds.add();
+		LLCullBoundsArray::slot_t b = bounds.add();
+		LLCullBoundsArray::slot_t c = bounds.add();
+		ensure_equals("size", bounds.size(), 3U);
+		ensure("padded", bounds.getCapacity() >= LLCullBoundsArray::BLOCK_SIZE);
+		ensure_equals("padding", bounds.getCapacity() % LLCullBoundsArray::BLOCK_SIZE, 0U);
+
+		bounds.remove(b);
+		ensure_equals("size after remove", bounds.size(), 2U);
+		ensure_equals("free slot reused", bounds.add(), b);
+
+		const U64 stamp = bounds.getStamp();
+		ensure("unchanged", !bounds.changedSince(a, stamp) && !bounds.changedSince(b, stamp) && !bounds.changedSince(c, stamp));
+		bounds.set(c, LLVector4a(1.f, 2.f, 3.f), LLVector4a(1.f, 1.f, 1.f));
+		ensure("set stamps its block", bounds.changedSince(c, stamp) && bounds.changedSince(a, stamp));
+		LLCullBoundsArray::slot_t far_slot = LLCullBoundsArray::INVALID_SLOT;
+		for (U32 i = 0; i < LLCullBoundsArray::BLOCK_SIZE; ++i)
+		{
+			far_slot = bounds.add();
+		}
+		const U64 later = bounds.getStamp();
+		bounds.set(c, LLVector4a(1.f, 2.f, 3.f), LLVector4a(1.f, 1.f, 1.f));
+		ensure("other blocks untouched", !bounds.changedSince(far_slot, later));
+
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			bounds.add();
+		}
+		ensure_equals("grown", bounds.size(), 1011U);
+		ensure("grown padded", bounds.getCapacity() >= 1011U);
+
+		bounds.clear();
+		ensure_equals("cleared", bounds.size(), 0U);
+		ensure_equals("first slot after clear", bounds.add(), 0);
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("slots near a hint");
+		LLCullBoundsArray bounds;
+		std::vector<LLCullBoundsArray::slot_t> slots;
+		for (U32 i = 0; i < LLCullBoundsArray::BLOCK_SIZE * 3; ++i)
+		{
+			slots.push_back(bounds.add());
+		}
+		const LLCullBoundsArray::slot_t parent = slots[LLCullBoundsArray::BLOCK_SIZE + 2];
+		bounds.remove(slots[LLCullBoundsArray::BLOCK_SIZE + 5]);
+		bounds.remove(slots[3]);
+		ensure_equals("free slot in the hint's block", bounds.add(parent), slots[LLCullBoundsArray::BLOCK_SIZE + 5]);
+		ensure_equals("other free slots after", bounds.add(parent), slots[3]);
+		LLCullBoundsArray::slot_t fresh = bounds.add(parent);
+		ensure("new block when none is free", fresh >= (S32)(LLCullBoundsArray::BLOCK_SIZE * 3));
+		ensure_equals("fills the new block", bounds.add(), fresh + 1);
+		ensure_equals("size", bounds.size(), LLCullBoundsArray::BLOCK_SIZE * 3 + 2);
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("known boxes");
+		LLCamera camera;
+		set_frustum(camera, LLVector3(128.f, 128.f, 30.f), LLVector3(228.f, 128.f, 30.f), 1.f, 1.5f, 0.5f, 100.f);
+
+		LLCullBoundsArray bounds;
+		LLCullBoundsArray::slot_t ahead = bounds.add();
+		LLCullBoundsArray::slot_t behind = bounds.add();
+		LLCullBoundsArray::slot_t around = bounds.add();
+		LLCullBoundsArray::slot_t beyond = bounds.add();
+		bounds.set(ahead, LLVector4a(160.f, 128.f, 30.f), LLVector4a(1.f, 1.f, 1.f));
+		bounds.set(behind, LLVector4a(100.f, 128.f, 30.f), LLVector4a(1.f, 1.f, 1.f));
+		bounds.set(around, LLVector4a(128.f, 128.f, 30.f), LLVector4a(10.f, 10.f, 10.f));
+		bounds.set(beyond, LLVector4a(300.f, 128.f, 30.f), LLVector4a(1.f, 1.f, 1.f));
+
+		LLCullBoundsPass pass;
+		camera.AABBInFrustum(bounds, pass);
+		ensure_equals("ahead is inside", pass.get(ahead), 2);
+		ensure_equals("behind is outside", pass.get(behind), 0);
+		ensure_equals("around the camera is partly inside", pass.get(around), 1);
+		ensure_equals("past the far clip is outside", pass.get(beyond), 0);
+
+		// Tested blocks notice boxes set since
+		bounds.set(behind, LLVector4a(150.f, 128.f, 30.f), LLVector4a(1.f, 1.f, 1.f));
+		ensure_equals("moved in front", pass.get(behind), 2);
+
+		camera.AABBInFrustumNoFarClip(bounds, pass);
+		ensure_equals("past the far clip without it", pass.get(beyond), 2);
+		std::vector<U8> results;
+		pass.testAll(results);
+		ensure_equals("all at once", (S32)results[beyond], 2);
+	}
+
+	template<> template<>
+	void object::test<4>()
+	{
+		set_test_name("same answers as LLCamera one box at a time");
+		const S32 CAMERAS = 40;
+		const S32 BOXES = 2000;
+
+		LLCullBoundsArray bounds;
+		for (S32 i = 0; i < BOXES; ++i)
+		{
+			bounds.add();
+		}
+		std::vector<LLVector4a> centers(BOXES);
+		std::vector<LLVector4a> sizes(BOXES);
+		for (S32 c = 0; c < CAMERAS; ++c)
+		{
+			LLCamera camera;
+			const LLVector3 origin = random_point(100.f);
+			set_frustum(camera, origin, origin + random_point(10.f) + LLVector3(0.f, 0.f, 0.01f),
+						0.2f + ll_frand(2.f), 0.5f + ll_frand(2.f), 0.1f + ll_frand(1.f), 10.f + ll_frand(200.f));
+			if (c % 4 == 3)
+			{
+				LLPlane clip(origin + random_point(20.f), random_point(1.f));
+				camera.setUserClipPlane(clip);
+			}
+			const LLVector3 shift = random_point(256.f);
+			camera.calcRegionFrustumPlanes(shift, 50.f + ll_frand(100.f));
+
+			for (S32 i = 0; i < BOXES; ++i)
+			{
+				// Some empty, some touching a plane exactly
+				const LLVector3 center = origin + random_point(150.f);
+				centers[i].load3(center.mV);
+				sizes[i].set(i % 7 ? ll_frand(20.f) : 0.f, ll_frand(20.f), i % 11 ? ll_frand(20.f) : 0.f);
+				if (i % 13 == 0)
+				{
+					centers[i].load3(origin.mV);
+				}
+				bounds.set(i, centers[i], sizes[i]);
+			}
+			LLCullBoundsPass pass;
+			camera.AABBInFrustum(bounds, pass);
+			for (S32 i = 0; i < BOXES; ++i)
+			{
+				ensure_equals("AABBInFrustum", pass.get(i), camera.AABBInFrustum(centers[i], sizes[i]));
+			}
+			camera.AABBInFrustumNoFarClip(bounds, pass);
+			std::vector<U8> results;
+			pass.testAll(results);
+			for (S32 i = 0; i < BOXES; ++i)
+			{
+				ensure_equals("AABBInFrustumNoFarClip", (S32)results[i], camera.AABBInFrustumNoFarClip(centers[i], sizes[i]));
+			}
+			camera.AABBInRegionFrustum(bounds, pass);
+			for (S32 i = BOXES - 1; i >= 0; --i)
+			{
+				ensure_equals("AABBInRegionFrustum", pass.get(i), camera.AABBInRegionFrustum(centers[i], sizes[i]));
+			}
+			camera.AABBInRegionFrustumNoFarClip(bounds, pass);
+			for (S32 i = 0; i < BOXES; ++i)
+			{
+				ensure_equals("AABBInRegionFrustumNoFarClip", pass.get(i), camera.AABBInRegionFrustumNoFarClip(centers[i], sizes[i]));
+			}
+
+			// Freed slots are handed out again, the next camera sees the
+			// same slots with new boxes
+			for (S32 i = c; i < BOXES; i += 3)
+			{
+				bounds.remove(i);
+			}
+			while (bounds.size() < (U32)BOXES)
+			{
+				bounds.add();
+			}
+		}
+	}
+}
@@ -0,0 +1,346 @@
+/**
+ * @file lloctree_test.cpp
+ * @brief LLOctreeNode and LLOctreeNodePool test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../lloctree.h"
+#include "llrand.h"
+
+namespace
+{
+	class TestEntry : public LLRefCount
+	{
+		LL_ALIGN_NEW
+	public:
+		TestEntry(const LLVector4a& center, F32 radius)
+		:	mBinRadius(radius),
+			mBinIndex(-1)
+		{
+			mPositionGroup = center;
+		}
+
+		const LLVector4a& getPositionGroup() const	{ return mPositionGroup; }
+		F32 getBinRadius() const					{ return mBinRadius; }
+		S32 getBinIndex() const						{ return mBinIndex; }
+		void setBinIndex(S32 index) const			{ mBinIndex = index; }
+		void setPositionGroup(const LLVector4a& center) { mPositionGroup = center; }
+
+		LL_ALIGN_16(LLVector4a mPositionGroup);
+		F32 mBinRadius;
+		mutable S32 mBinIndex;
+	};
+
+	typedef LLOctreeNode<TestEntry, LLPointer<TestEntry> > TestNode;
+	typedef LLOctreeRoot<TestEntry, LLPointer<TestEntry> > TestRoot;
+	typedef LLOctreeListener<TestEntry, LLPointer<TestEntry> > TestListener;
+	typedef LLOctreeTraveler<TestEntry, LLPointer<TestEntry> > TestTraveler;
+	typedef std::vector<LLPointer<TestEntry> > entry_list_t;
+
+	// One per node, as the viewer's octree groups are
+	class CountingListener : public TestListener
+	{
+	public:
+		CountingListener(TestNode* node)
+		{
+			++sLive;
+			node->addListener(this);
+		}
+		~CountingListener()
+		{
+			--sLive;
+		}
+
+		virtual void handleInsertion(const LLTreeNode<TestEntry>* node, TestEntry* data) {}
+		virtual void handleRemoval(const LLTreeNode<TestEntry>* node, TestEntry* data) {}
+		virtual void handleDestruction(const LLTreeNode<TestEntry>* node) { ++sDestroyed; }
+		virtual void handleStateChange(const LLTreeNode<TestEntry>* node) {}
+		virtual void handleChildAddition(const TestNode* parent, TestNode* child)
+		{
+			if (!child->getListenerCount())
+			{
+				new CountingListener(child);
+			}
+		}
+		virtual void handleChildRemoval(const TestNode* parent, const TestNode* child) {}
+
+		static S32 sLive;
+		static S32 sDestroyed;
+	};
+
+	S32 CountingListener::sLive = 0;
+	S32 CountingListener::sDestroyed = 0;
+
+	// Every node's box and contents in traversal order
+	class ShapeTraveler : public TestTraveler
+	{
+	public:
+		virtual void visit(const TestNode* branch)
+		{
+			for (S32 i = 0; i < 3; ++i)
+			{
+				mShape.push_back(branch->getCenter()[i]);
+			}
+			mShape.push_back(branch->getSize()[0]);
+			mShape.push_back((F32)branch->getElementCount());
+			mShape.push_back((F32)branch->getChildCount());
+			for (TestNode::const_element_iter i = branch->getDataBegin(); i != branch->getDataEnd(); ++i)
+			{
+				mShape.push_back((*i)->getPositionGroup()[0]);
+			}
+			++mNodes;
+		}
+
+		std::vector<F32> mShape;
+		U32 mNodes = 0;
+	};
+
+	LLVector4a random_position()
+	{
+		LLVector4a pos;
+		pos.set(ll_frand(256.f), ll_frand(256.f), ll_frand(128.f));
+		return pos;
+	}
+
+	// Mostly small things with some big ones, as in a region
+	void make_entries(entry_list_t& entries, S32 count)
+	{
+		for (S32 i = 0; i < count; ++i)
+		{
+			const F32 radius = ll_frand() < 0.9f ? 0.1f + ll_frand(2.f) : 2.f + ll_frand(30.f);
+			entries.push_back(new TestEntry(random_position(), radius));
+		}
+	}
+
+	TestRoot* make_root(bool pooled)
+	{
+		LLVector4a center, size;
+		center.splat(0.f);
+		size.splat(1.f);
+		TestRoot* root = new TestRoot(center, size, NULL, pooled);
+		new CountingListener(root);
+		return root;
+	}
+
+	// How LLSpatialPartition moves an element, out and back in from the root
+	void move(TestRoot* root, TestEntry* entry, const LLVector4a& pos)
+	{
+		LLPointer<TestEntry> hold = entry;
+		TestNode* node = root->getNodeAt(entry);
+		node->remove(entry);
+		entry->setPositionGroup(pos);
+		root->insert(entry);
+	}
+
+	void remove_all(TestRoot* root, entry_list_t& entries)
+	{
+		for (LLPointer<TestEntry>& entry : entries)
+		{
+			root->getNodeAt(entry)->remove(entry);
+		}
+	}
+}
+
+namespace tut
+{
+	struct LLOctreeData
+	{
+		LLOctreeData()
+		{
+			mMaxCapacity = gOctreeMaxCapacity;
+			mMinSize = gOctreeMinSize;
+			// Viewer defaults
+			gOctreeMaxCapacity = 128;
+			gOctreeMinSize = 0.01f;
+			CountingListener::sLive = 0;
+			CountingListener::sDestroyed = 0;
+		}
+
+		~LLOctreeData()
+		{
+			gOctreeMaxCapacity = mMaxCapacity;
+			gOctreeMinSize = mMinSize;
+		}
+
+		U32 mMaxCapacity;
+		F32 mMinSize;
+	};
+
+	typedef test_group<LLOctreeData> factory;
+	typedef factory::object object;
+}
+
+namespace
+{
+	tut::factory tf("LLOctree");
+}
+
+namespace tut
+{
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("pooled tree takes the same shape as a heap one");
+		gOctreeMaxCapacity = 4;
+		entry_list_t heap_entries;
+		entry_list_t pool_entries;
+		make_entries(heap_entries, 3000);
+		for (LLPointer<TestEntry>& entry : heap_entries)
+		{
+			pool_entries.push_back(new TestEntry(entry->getPositionGroup(), entry->getBinRadius()));
+		}
+
+		TestRoot* heap = make_root(false);
+		TestRoot* pool = make_root(true);
+		ensure("heap tree has no pool", !heap->getPool());
+		ensure("pooled tree has one", pool->getPool() != NULL);
+
+		for (size_t i = 0; i < heap_entries.size(); ++i)
+		{
+			heap->insert(heap_entries[i]);
+			pool->insert(pool_entries[i]);
+		}
+
+		// Same moves in both
+		for (S32 frame = 0; frame < 50; ++frame)
+		{
+			for (S32 i = 0; i < 100; ++i)
+			{
+				const S32 index = ll_rand((S32)heap_entries.size());
+				const LLVector4a pos = random_position();
+				move(heap, heap_entries[index], pos);
+				move(pool, pool_entries[index], pos);
+			}
+			heap->balance();
+			pool->balance();
+
+			ShapeTraveler heap_shape;
+			ShapeTraveler pool_shape;
+			heap_shape.traverse(heap);
+			pool_shape.traverse(pool);
+			ensure("same shape", heap_shape.mShape == pool_shape.mShape);
+			// The root is not pooled
+			ensure_equals("pooled nodes", pool->getPool()->getNodeCount(), pool_shape.mNodes - 1);
+			ensure_equals("a listener per node", CountingListener::sLive, (S32)(heap_shape.mNodes + pool_shape.mNodes));
+		}
+
+		for (size_t i = 0; i < heap_entries.size(); ++i)
+		{
+			ensure("bin index kept", pool_entries[i]->getBinIndex() >= 0);
+			ensure_equals("same bin index", pool_entries[i]->getBinIndex(), heap_entries[i]->getBinIndex());
+		}
+
+		remove_all(heap, heap_entries);
+		remove_all(pool, pool_entries);
+		ensure_equals("emptied tree gives its nodes back", pool->getPool()->getNodeCount(), 0U);
+
+		delete heap;
+		delete pool;
+		ensure_equals("every listener destroyed", CountingListener::sLive, 0);
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("elements past the inline ones");
+		LLPointer<TestEntry> entries[3 * TestNode::INLINE_ELEMENTS];
+		TestRoot* root = make_root(true);
+		LLVector4a pos;
+		pos.set(8.f, 8.f, 8.f);
+		for (U32 i = 0; i < LL_ARRAY_SIZE(entries); ++i)
+		{
+			entries[i] = new TestEntry(pos, 1.f);
+			root->insert(entries[i]);
+			ensure_equals("one reference held by the tree", entries[i]->getNumRefs(), 2);
+		}
+
+		TestNode* node = root->getNodeAt(entries[0]);
+		ensure_equals("all in one node", node->getElementCount(), (U32)LL_ARRAY_SIZE(entries));
+
+		// Back down to the inline ones, from the middle out
+		const U32 keep = TestNode::INLINE_ELEMENTS - 1;
+		for (U32 i = keep; i < LL_ARRAY_SIZE(entries); ++i)
+		{
+			ensure("removed", node->remove(entries[i]));
+			ensure_equals("unbinned", entries[i]->getBinIndex(), -1);
+			ensure_equals("released by the tree", entries[i]->getNumRefs(), 1);
+		}
+		ensure_equals("left", node->getElementCount(), keep);
+		for (U32 i = 0; i < keep; ++i)
+		{
+			S32 index = entries[i]->getBinIndex();
+			ensure("bin index in range", index >= 0 && (U32)index < keep);
+			ensure("bin index points back", *(node->getDataBegin() + index) == entries[i]);
+		}
+
+		delete root;
+		for (U32 i = 0; i < keep; ++i)
+		{
+			ensure_equals("unbinned with the tree", entries[i]->getBinIndex(), -1);
+			ensure_equals("released with the tree", entries[i]->getNumRefs(), 1);
+		}
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("node pool reuse and lifetime");
+		gOctreeMaxCapacity = 2;
+		LLPointer<LLOctreeNodePool> pool;
+		entry_list_t entries;
+		make_entries(entries, 2000);
+		{
+			TestRoot* root = make_root(true);
+			pool = root->getPool();
+			for (LLPointer<TestEntry>& entry : entries)
+			{
+				root->insert(entry);
+			}
+			const U32 nodes = pool->getNodeCount();
+			const U32 slabs = pool->getSlabCount();
+			ensure("nodes made", nodes > 100);
+			ensure("slabs grow", slabs < nodes / LLOctreeNodePool::MIN_SLAB_NODES);
+			ensure("blocks cover whole cache lines", pool->getReservedBytes() % LLOctreeNodePool::CACHE_LINE == 0);
+
+			remove_all(root, entries);
+			ensure_equals("all given back", pool->getNodeCount(), 0U);
+			for (LLPointer<TestEntry>& entry : entries)
+			{
+				root->insert(entry);
+			}
+			ensure_equals("freed blocks reused", pool->getSlabCount(), slabs);
+
+			const S32 destroyed = CountingListener::sDestroyed;
+			delete root;
+			ensure("nodes destroyed with the root", CountingListener::sDestroyed - destroyed > (S32)nodes / 2);
+			ensure_equals("every listener destroyed", CountingListener::sLive, 0);
+		}
+		ensure_equals("pool outlives its root", pool->getNodeCount(), 0U);
+		ensure_equals("only held here now", pool->getNumRefs(), 1);
+	}
+}
@@ -0,0 +1,478 @@
+/**
+ * @file message_replay_bench.cpp
+ * @brief Replays a UDP message stream through LLTemplateMessageReader and reports messages per second.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "linden_common.h"
+
+#include "llhost.h"
+#include "llmath.h"
+#include "llmessagelayout.h"
+#include "llmessagetemplate.h"
+#include "llmessagetemplateparser.h"
+#include "llquaternion.h"
+#include "lltemplatemessagebuilder.h"
+#include "lltemplatemessagereader.h"
+#include "lltimer.h"
+#include "lluuid.h"
+#include "message.h"
+#include "v3dmath.h"
+#include "v3math.h"
+#include "v4math.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tmessage_replay_bench [options]\n"
+		"\n"
+		"Feeds a stream of UDP packets through LLTemplateMessageReader, reading\n"
+		"every field of every message with the typed accessors, and reports the\n"
+		"messages decoded per second.  Without a capture a synthetic stream of\n"
+		"object updates, terse updates and other busy region traffic is used.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -t <file>       Message template.\n"
+		"                 Default:  scripts/messages/message_template.msg\n"
+		" -c <file>       Capture to replay: packets as received, each one\n"
+		"                 preceded by its length as a little endian U32.\n"
+		"                 Appended acks and zero coding are undone here.\n"
+		" -n <count>      Packets in the synthetic stream.  Default:  20000\n"
+		" -r <count>      Times the stream is replayed.  Default:  20\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+typedef std::vector<std::string> packet_list_t;
+
+static bool read_file(const std::string& filename, std::string& data)
+{
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in.is_open())
+	{
+		return false;
+	}
+	std::ostringstream ostr;
+	ostr << in.rdbuf();
+	data = ostr.str();
+	return true;
+}
+
+// Same as LLMessageSystem::zeroCodeExpand(), without the statistics.
+static std::string zero_code_expand(const std::string& packet)
+{
+	if (!(packet[0] & LL_ZERO_CODE_FLAG))
+	{
+		return packet;
+	}
+	std::string out(packet, 0, LL_PACKET_ID_SIZE);
+	out[0] &= ~LL_ZERO_CODE_FLAG;
+	size_t i = LL_PACKET_ID_SIZE;
+	while (i < packet.size())
+	{
+		char c = packet[i++];
+		out += c;
+		if (c)
+		{
+			continue;
+		}
+		// A zero is followed by the length of its run, with each further
+		// zero standing for 256 more.
+		while (i < packet.size() && !packet[i])
+		{
+			out.append(256, '\0');
+			++i;
+		}
+		if (i < packet.size())
+		{
+			out.append((U8)packet[i++] - 1, '\0');
+		}
+	}
+	return out;
+}
+
+// The packets of a capture, as LLMessageSystem::checkMessages() hands them
+// to the reader.
+static bool load_capture(const std::string& filename, packet_list_t& packets)
+{
+	std::string data;
+	if (!read_file(filename, data))
+	{
+		return false;
+	}
+	size_t pos = 0;
+	while (pos + sizeof(U32) <= data.size())
+	{
+		const U8* length_bytes = (const U8*)&data[pos];
+		size_t length = length_bytes[0] | (length_bytes[1] << 8) | (length_bytes[2] << 16) | ((U32)length_bytes[3] << 24);
+		pos += sizeof(U32);
+		if (length > (size_t)MAX_BUFFER_SIZE || pos + length > data.size())
+		{
+			return false;
+		}
+		std::string packet(data, pos, length);
+		pos += length;
+		if (packet.size() < (size_t)LL_MINIMUM_VALID_PACKET_SIZE)
+		{
+			continue;
+		}
+		if (packet[0] & LL_ACK_FLAG)
+		{
+			size_t acks = (U8)packet.back();
+			packet.pop_back();
+			if (packet.size() < acks * sizeof(TPACKETID) + LL_MINIMUM_VALID_PACKET_SIZE)
+			{
+				continue;
+			}
+			packet.resize(packet.size() - acks * sizeof(TPACKETID));
+		}
+		packets.push_back(zero_code_expand(packet));
+	}
+	return pos == data.size();
+}
+
+struct SyntheticMessage
+{
+	const char*	mName;
+	S32			mWeight;		// share of the stream
+	S32			mBlockCount;	// of each Variable block
+};
+
+// Roughly the mix of a busy region while moving around.
+static const SyntheticMessage SYNTHETIC_MESSAGES[] =
+{
+	{ "ImprovedTerseObjectUpdate",	40,	10 },
+	{ "ObjectUpdate",				15,	4 },
+	{ "ObjectUpdateCompressed",		10,	6 },
+	{ "ObjectUpdateCached",			8,	20 },
+	{ "CoarseLocationUpdate",		5,	30 },
+	{ "AvatarAnimation",			8,	3 },
+	{ "AgentUpdate",				6,	1 },
+	{ "PacketAck",					5,	12 },
+	{ "SimStats",					3,	16 },
+};
+
+static void add_random_block(LLTemplateMessageBuilder& builder, const LLMessageLayout& layout, const LLMessageLayout::Block& block)
+{
+	U8 bytes[256];
+	builder.nextBlock(block.mName);
+	for (U32 i = 0; i < block.mVariableCount; ++i)
+	{
+		const LLMessageLayout::Variable& variable = layout.getVariable(block, i);
+		S32 size = variable.mType == MVT_VARIABLE ? rand() % 48 : variable.mSize;
+		for (S32 j = 0; j < size; ++j)
+		{
+			bytes[j] = (U8)(rand() % 3 ? rand() : 0);
+		}
+		builder.addBinaryData(variable.mName, bytes, size);
+	}
+}
+
+static bool make_synthetic(LLTemplateMessageBuilder::message_template_name_map_t& names, S32 count, packet_list_t& packets)
+{
+	S32 total_weight = 0;
+	for (const SyntheticMessage& message : SYNTHETIC_MESSAGES)
+	{
+		if (names.find(LLMessageStringTable::getInstance()->getString(message.mName)) == names.end())
+		{
+			std::cerr << "Template has no " << message.mName << std::endl;
+			return false;
+		}
+		total_weight += message.mWeight;
+	}
+
+	LLTemplateMessageBuilder builder(names);
+	U8 buffer[MAX_BUFFER_SIZE];
+	for (S32 i = 0; i < count; ++i)
+	{
+		S32 pick = rand() % total_weight;
+		const SyntheticMessage* message = SYNTHETIC_MESSAGES;
+		while (pick >= message->mWeight)
+		{
+			pick -= message->mWeight;
+			++message;
+		}
+		char* name = LLMessageStringTable::getInstance()->getString(message->mName);
+		const LLMessageLayout& layout = names[name]->getLayout();
+
+		builder.newMessage(name);
+		for (S32 b = 0; b < layout.getBlockCount(); ++b)
+		{
+			const LLMessageLayout::Block& block = layout.getBlock(b);
+			S32 instances = block.mType == MBT_VARIABLE ? message->mBlockCount : block.mNumber;
+			for (S32 n = 0; n < instances; ++n)
+			{
+				add_random_block(builder, layout, block);
+			}
+		}
+		S32 size = builder.buildMessage(buffer, MAX_BUFFER_SIZE, 0);
+		builder.clearMessage();
+		packets.push_back(std::string((const char*)buffer, size));
+	}
+	return true;
+}
+
+// Reads every field of the current message, as a message handler would.
+static U32 read_fields(LLTemplateMessageReader& reader, const LLMessageLayout& layout)
+{
+	U32 sum = 0;
+	U8 bytes[MAX_BUFFER_SIZE];
+	for (S32 b = 0; b < layout.getBlockCount(); ++b)
+	{
+		const LLMessageLayout::Block& block = layout.getBlock(b);
+		S32 instances = reader.getNumberOfBlocks(block.mName);
+		for (S32 n = 0; n < instances; ++n)
+		{
+			for (U32 i = 0; i < block.mVariableCount; ++i)
+			{
+				const LLMessageLayout::Variable& variable = layout.getVariable(block, i);
+				switch (variable.mType)
+				{
+				case MVT_U8:
+				case MVT_S8:
+				case MVT_BOOL:
+				{
+					U8 value;
+					reader.getU8(block.mName, variable.mName, value, n);
+					sum += value;
+					break;
+				}
+				case MVT_U16:
+				case MVT_S16:
+				{
+					U16 value;
+					reader.getU16(block.mName, variable.mName, value, n);
+					sum += value;
+					break;
+				}
+				case MVT_IP_PORT:
+				{
+					U16 value;
+					reader.getIPPort(block.mName, variable.mName, value, n);
+					sum += value;
+					break;
+				}
+				case MVT_U32:
+				case MVT_S32:
+				case MVT_IP_ADDR:
+				{
+					U32 value;
+					reader.getU32(block.mName, variable.mName, value, n);
+					sum += value;
+					break;
+				}
+				case MVT_F32:
+				{
+					F32 value;
+					reader.getF32(block.mName, variable.mName, value, n);
+					sum += (U32)(value != 0.f);
+					break;
+				}
+				case MVT_U64:
+				case MVT_S64:
+				{
+					U64 value;
+					reader.getU64(block.mName, variable.mName, value, n);
+					sum += (U32)value;
+					break;
+				}
+				case MVT_F64:
+				{
+					F64 value;
+					reader.getF64(block.mName, variable.mName, value, n);
+					sum += (U32)(value != 0.0);
+					break;
+				}
+				case MVT_LLVector3:
+				{
+					LLVector3 value;
+					reader.getVector3(block.mName, variable.mName, value, n);
+					sum += (U32)(value.mV[VX] != 0.f);
+					break;
+				}
+				case MVT_LLVector3d:
+				{
+					LLVector3d value;
+					reader.getVector3d(block.mName, variable.mName, value, n);
+					sum += (U32)(value.mdV[VX] != 0.0);
+					break;
+				}
+				case MVT_LLVector4:
+				{
+					LLVector4 value;
+					reader.getVector4(block.mName, variable.mName, value, n);
+					sum += (U32)(value.mV[VX] != 0.f);
+					break;
+				}
+				case MVT_LLQuaternion:
+				{
+					LLQuaternion value;
+					reader.getQuat(block.mName, variable.mName, value, n);
+					sum += (U32)(value.mQ[VX] != 0.f);
+					break;
+				}
+				case MVT_LLUUID:
+				{
+					LLUUID value;
+					reader.getUUID(block.mName, variable.mName, value, n);
+					sum += value.mData[0];
+					break;
+				}
+				case MVT_VARIABLE:
+				{
+					S32 size = reader.getSize(block.mName, n, variable.mName);
+					if (size > 0)
+					{
+						reader.getBinaryData(block.mName, variable.mName, bytes, size, n);
+						sum += bytes[0];
+					}
+					break;
+				}
+				default:
+				{
+					reader.getBinaryData(block.mName, variable.mName, bytes, variable.mSize, n);
+					sum += bytes[0];
+					break;
+				}
+				}
+			}
+		}
+	}
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	std::string template_file("scripts/messages/message_template.msg");
+	std::string capture_file;
+	S32 count = 20000;
+	S32 repeat = 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-t" && i + 1 < argc)
+		{
+			template_file = argv[++i];
+		}
+		else if (arg == "-c" && i + 1 < argc)
+		{
+			capture_file = argv[++i];
+		}
+		else if (arg == "-n" && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	std::string contents;
+	if (!read_file(template_file, contents))
+	{
+		std::cerr << "Unable to read " << template_file << std::endl;
+		return 1;
+	}
+	LLTemplateTokenizer tokens(contents);
+	LLTemplateParser parsed(tokens);
+	LLTemplateMessageBuilder::message_template_name_map_t names;
+	LLTemplateMessageReader::message_template_number_map_t numbers;
+	for (LLTemplateParser::message_iterator iter = parsed.getMessagesBegin(); iter != parsed.getMessagesEnd(); ++iter)
+	{
+		names[(*iter)->mName] = *iter;
+		numbers[(*iter)->mMessageNumber] = *iter;
+	}
+
+	packet_list_t packets;
+	if (!capture_file.empty())
+	{
+		if (!load_capture(capture_file, packets))
+		{
+			std::cerr << "Unable to read packets from " << capture_file << std::endl;
+			return 1;
+		}
+	}
+	else if (!make_synthetic(names, count, packets))
+	{
+		return 1;
+	}
+
+	LLTemplateMessageReader reader(numbers);
+	LLHost host(0x0100007f, 13000);
+	U64 messages = 0;
+	U64 bytes = 0;
+	U64 rejected = 0;
+	U32 sum = 0;
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 r = 0; r < repeat; ++r)
+	{
+		for (const std::string& packet : packets)
+		{
+			const U8* buffer = (const U8*)packet.data();
+			reader.clearMessage();
+			if (!reader.validateMessage(buffer, (S32)packet.size(), host, true)
+				|| !reader.readMessage(buffer, host))
+			{
+				++rejected;
+				continue;
+			}
+			const LLMessageTemplate* msg_template = names[(char*)reader.getMessageName()];
+			sum += read_fields(reader, const_cast<LLMessageTemplate*>(msg_template)->getLayout());
+			++messages;
+			bytes += packet.size();
+		}
+	}
+	F64 seconds = LLTimer::getTotalSeconds() - start;
+
+	fprintf(stdout, "%s: %d packets, %d replays\n", capture_file.empty() ? "synthetic stream" : capture_file.c_str(),
+			(S32)packets.size(), repeat);
+	fprintf(stdout, "  %llu messages in %.3f s, %.0f messages/s, %.1f MB/s\n", (unsigned long long)messages, seconds,
+			seconds > 0.0 ? messages / seconds : 0.0,
+			seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0);
+	if (rejected)
+	{
+		fprintf(stdout, "  %llu packets rejected\n", (unsigned long long)rejected);
+	}
+	fprintf(stdout, "  checksum %08x\n", sum);
+
+	for (LLTemplateParser::message_iterator iter = parsed.getMessagesBegin(); iter != parsed.getMessagesEnd(); ++iter)
+	{
+		delete *iter;
+	}
+	return 0;
+}
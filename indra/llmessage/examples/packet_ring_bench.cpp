@@ -0,0 +1,158 @@
+/**
+ * @file packet_ring_bench.cpp
+ * @brief Loopback packets per second and system calls per frame of LLPacketRing, with and without batching.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "linden_common.h"
+
+#include "llpacketring.h"
+#include "lltimer.h"
+#include "net.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tpacket_ring_bench [options]\n"
+		"\n"
+		"Sends frames of UDP packets over loopback through one LLPacketRing\n"
+		"and drains them with another, as LLMessageSystem::processAcks() and\n"
+		"checkMessages() do, with and without batching.  Reports packets per\n"
+		"second and the receive and send system calls per frame.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -p <count>      Packets per frame.  Default:  100\n"
+		" -s <bytes>      Packet size.  Default:  600\n"
+		" -f <count>      Frames.  Default:  2000\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+struct Result
+{
+	U64	mReceived;
+	U32	mReceiveCalls;
+	U32	mSendCalls;
+	F64	mSeconds;
+};
+
+static Result run(bool batching, S32 packets, S32 size, S32 frames)
+{
+	S32 receive_socket = -1;
+	S32 send_socket = -1;
+	int receive_port = NET_USE_OS_ASSIGNED_PORT;
+	int send_port = NET_USE_OS_ASSIGNED_PORT;
+	start_net(receive_socket, receive_port);
+	start_net(send_socket, send_port);
+	LLHost receiver_host(ip_string_to_u32(LOOPBACK_ADDRESS_STRING), receive_port);
+
+	LLPacketRing sender;
+	LLPacketRing receiver;
+	sender.setUseBatching(batching);
+	receiver.setUseBatching(batching);
+
+	std::vector<char> data(size, 'x');
+	char buffer[NET_BUFFER_SIZE];
+	Result result = { 0, 0, 0, 0.0 };
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 frame = 0; frame < frames; ++frame)
+	{
+		sender.beginSendBatch();
+		for (S32 i = 0; i < packets; ++i)
+		{
+			sender.sendPacket(send_socket, &data[0], size, receiver_host);
+		}
+		sender.flushSendBatch();
+
+		while (receiver.receivePacket(receive_socket, buffer) > 0)
+		{
+			++result.mReceived;
+		}
+	}
+	result.mSeconds = LLTimer::getTotalSeconds() - start;
+	result.mReceiveCalls = receiver.getAndResetReceiveCalls();
+	result.mSendCalls = sender.getAndResetSendCalls();
+
+	end_net(receive_socket);
+	end_net(send_socket);
+	return result;
+}
+
+static void report(const char* name, const Result& result, S32 packets, S32 frames)
+{
+	U64 sent = (U64)packets * frames;
+	fprintf(stdout, "  %-10s %10.0f packets/s  %7.2f receive + %7.2f send calls/frame",
+			name, result.mSeconds > 0.0 ? result.mReceived / result.mSeconds : 0.0,
+			(F64)result.mReceiveCalls / frames, (F64)result.mSendCalls / frames);
+	if (result.mReceived != sent)
+	{
+		fprintf(stdout, "  (%llu of %llu received)", (unsigned long long)result.mReceived, (unsigned long long)sent);
+	}
+	fprintf(stdout, "\n");
+}
+
+int main(int argc, char** argv)
+{
+	S32 packets = 100;
+	S32 size = 600;
+	S32 frames = 2000;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-p" && i + 1 < argc)
+		{
+			packets = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-s" && i + 1 < argc)
+		{
+			size = llclamp(atoi(argv[++i]), 1, NET_BUFFER_SIZE);
+		}
+		else if (arg == "-f" && i + 1 < argc)
+		{
+			frames = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	if (!batch_packets_supported())
+	{
+		std::cerr << "Batched UDP I/O is not available on this platform; both runs are unbatched." << std::endl;
+	}
+
+	fprintf(stdout, "%d frames of %d packets of %d bytes\n", frames, packets, size);
+	report("unbatched", run(false, packets, size, frames), packets, frames);
+	report("batched", run(true, packets, size, frames), packets, frames);
+	return 0;
+}
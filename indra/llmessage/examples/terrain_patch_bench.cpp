@@ -0,0 +1,282 @@
+/**
+ * @file terrain_patch_bench.cpp
+ * @brief Terrain patches decoded per second, through the old globals and through decompress_patch_block().
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "linden_common.h"
+
+#include "llbitpack.h"
+#include "llmath.h"
+#include "lltimer.h"
+#include "patch_code.h"
+#include "patch_dct.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tterrain_patch_bench [options]\n"
+		"\n"
+		"Decodes LayerData packets the way LLSurface::decompressDCTPatch() does,\n"
+		"once through decode_patch() and decompress_patch() and once through\n"
+		"unpack_patch() and decompress_patch_block() with every IDCT kernel set\n"
+		"this CPU has, and reports the patches decoded per second.  Without a\n"
+		"capture a synthetic region of land patches is coded as the simulator\n"
+		"does.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -c <file>       Capture to replay: the Data field of LayerData\n"
+		"                 messages, each one preceded by its length as a\n"
+		"                 little endian U32.\n"
+		" -l              The capture has 32 bit patch ids (var-regions on\n"
+		"                 OpenSim grids).\n"
+		" -s <16|32>      Patch size of the synthetic region.  Default:  16\n"
+		" -w <meters>     Width of the synthetic region.  Default:  256\n"
+		" -r <count>      Times the packets are decoded.  Default:  20\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+typedef std::vector<std::string> packet_list_t;
+
+static bool load_capture(const std::string& filename, packet_list_t& packets)
+{
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in.is_open())
+	{
+		return false;
+	}
+	std::ostringstream ostr;
+	ostr << in.rdbuf();
+	std::string data = ostr.str();
+
+	size_t pos = 0;
+	while (pos + sizeof(U32) <= data.size())
+	{
+		const U8* length_bytes = (const U8*)&data[pos];
+		size_t length = length_bytes[0] | (length_bytes[1] << 8) | (length_bytes[2] << 16) | ((U32)length_bytes[3] << 24);
+		pos += sizeof(U32);
+		if (pos + length > data.size())
+		{
+			return false;
+		}
+		packets.push_back(data.substr(pos, length));
+		pos += length;
+	}
+	return pos == data.size();
+}
+
+// Rolling hills, coded a row of patches per packet.
+static void make_region(S32 size, S32 width, packet_list_t& packets)
+{
+	const S32 patches_per_edge = width / size;
+	std::vector<F32> heights(width * width);
+	for (S32 y = 0; y < width; y++)
+	{
+		for (S32 x = 0; x < width; x++)
+		{
+			heights[y * width + x] = 22.f + 8.f * sinf(x * 0.05f) * cosf(y * 0.07f) + 3.f * sinf((x + y) * 0.31f);
+		}
+	}
+
+	init_patch_compressor(size, width, 'L');
+	std::vector<U8> buffer(LARGE_PATCH_SIZE * LARGE_PATCH_SIZE * 8 * patches_per_edge);
+	S32 cpatch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+	for (S32 j = 0; j < patches_per_edge; j++)
+	{
+		LLBitPack bitpack(&buffer[0], (U32)buffer.size());
+		LLGroupHeader gopp;
+		get_patch_group_header(&gopp);
+		code_patch_group_header(bitpack, &gopp);
+		for (S32 i = 0; i < patches_per_edge; i++)
+		{
+			F32* patch = &heights[j * size * width + i * size];
+			LLPatchHeader ph;
+			F32 zmax, zmin;
+			prescan_patch(patch, &ph, zmax, zmin);
+			ph.patchids = (i << 5) | j;
+			compress_patch(patch, cpatch, &ph, 10);
+			code_patch_header(bitpack, &ph, cpatch);
+			code_patch(bitpack, cpatch, 0);
+		}
+		code_end_of_data(bitpack);
+		S32 length = bitpack.flushBitPack();
+		packets.push_back(std::string((const char*)&buffer[0], length));
+	}
+}
+
+// Decodes every packet into region, returns the number of patches.
+static S32 decode_packets(const packet_list_t& packets, bool large_patch_ids, bool old_path, std::vector<F32>& region)
+{
+	S32 count = 0;
+	S32 cpatch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+	for (const std::string& packet : packets)
+	{
+		LLBitPack bitpack((U8*)packet.data(), (U32)packet.size());
+		LLGroupHeader gopp;
+		if (old_path)
+		{
+			decode_patch_group_header(bitpack, &gopp);
+			init_patch_decompressor(gopp.patch_size);
+			gopp.stride = LARGE_PATCH_SIZE;
+			set_group_of_patch_header(&gopp);
+		}
+		else
+		{
+			unpack_patch_group_header(bitpack, &gopp);
+		}
+		const S32 size = gopp.patch_size;
+		if (size != NORMAL_PATCH_SIZE && size != LARGE_PATCH_SIZE)
+		{
+			continue;
+		}
+
+		while (true)
+		{
+			LLPatchHeader ph;
+			F32* patch = &region[(count % 64) * LARGE_PATCH_SIZE * LARGE_PATCH_SIZE];
+			if (old_path)
+			{
+				decode_patch_header(bitpack, &ph, large_patch_ids);
+				if (END_OF_PATCHES == ph.quant_wbits)
+				{
+					break;
+				}
+				decode_patch(bitpack, cpatch);
+				decompress_patch(patch, cpatch, &ph);
+			}
+			else
+			{
+				unpack_patch_header(bitpack, &ph, large_patch_ids);
+				if (END_OF_PATCHES == ph.quant_wbits)
+				{
+					break;
+				}
+				unpack_patch(bitpack, cpatch, size, (ph.quant_wbits & 0xf) + 2);
+				decompress_patch_block(patch, LARGE_PATCH_SIZE, size, cpatch, &ph);
+			}
+			count++;
+		}
+	}
+	return count;
+}
+
+int main(int argc, char** argv)
+{
+	std::string capture_file;
+	bool large_patch_ids = false;
+	S32 size = NORMAL_PATCH_SIZE;
+	S32 width = 256;
+	S32 repeat = 20;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if ("-c" == arg && i + 1 < argc)
+		{
+			capture_file = argv[++i];
+		}
+		else if ("-l" == arg)
+		{
+			large_patch_ids = true;
+		}
+		else if ("-s" == arg && i + 1 < argc)
+		{
+			size = (atoi(argv[++i]) == LARGE_PATCH_SIZE) ? LARGE_PATCH_SIZE : NORMAL_PATCH_SIZE;
+		}
+		else if ("-w" == arg && i + 1 < argc)
+		{
+			width = llclamp(atoi(argv[++i]), size, 32 * size);
+		}
+		else if ("-r" == arg && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage("-h" == arg ? std::cout : std::cerr);
+			return "-h" == arg ? 0 : 1;
+		}
+	}
+
+	packet_list_t packets;
+	if (!capture_file.empty())
+	{
+		if (!load_capture(capture_file, packets))
+		{
+			std::cerr << "Unable to read packets from " << capture_file << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		make_region(size, width - width % size, packets);
+	}
+
+	// 64 patches worth of output, so that the stores stay in the cache
+	// but are not optimized away.
+	std::vector<F32> region(64 * LARGE_PATCH_SIZE * LARGE_PATCH_SIZE);
+	std::vector<F32> expected(region.size());
+	decode_packets(packets, large_patch_ids, true, expected);
+
+	fprintf(stdout, "%s: %d packets, %d repeats\n", capture_file.empty() ? "synthetic region" : capture_file.c_str(),
+			(S32)packets.size(), repeat);
+
+	F64 old_rate = 0.0;
+	for (S32 kernels = -1; kernels <= get_best_patch_idct_kernels(); kernels++)
+	{
+		const bool old_path = (kernels < 0);
+		if (!old_path)
+		{
+			set_patch_idct_kernels((EPatchIDCTKernels)kernels);
+		}
+		U64 patches = 0;
+		F64 start = LLTimer::getTotalSeconds();
+		for (S32 r = 0; r < repeat; r++)
+		{
+			patches += decode_packets(packets, large_patch_ids, old_path, region);
+		}
+		F64 seconds = LLTimer::getTotalSeconds() - start;
+		F64 rate = patches / llmax(seconds, 1e-6);
+		if (old_path)
+		{
+			old_rate = rate;
+			fprintf(stdout, "%-28s %12.0f patches/s\n", "decompress_patch()", rate);
+		}
+		else
+		{
+			std::string name = llformat("decompress_patch_block() %s", get_patch_idct_kernels_name((EPatchIDCTKernels)kernels));
+			fprintf(stdout, "%-28s %12.0f patches/s  %5.2fx%s\n", name.c_str(), rate, rate / old_rate,
+					memcmp(&region[0], &expected[0], region.size() * sizeof(F32)) ? "  MISMATCH" : "");
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file llmessagelayout.cpp
+ * @brief Flat, indexed form of a message template for decoding.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmessagelayout.h"
+
+// Canonical names are unique pointers; spread the address bits over the
+// table.
+static U32 hash_name(const char* name, S32 block)
+{
+	U64 key = (U64)(uintptr_t)name + ((U64)(block + 1) << 40);
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (U32)(key >> 32);
+}
+
+LLMessageLayout::LLMessageLayout(const LLMessageTemplate& msg_template)
+:	mSlotMask(0),
+	mMaxFixedSize(0)
+{
+	for (LLMessageTemplate::message_block_map_t::const_iterator iter = msg_template.mMemberBlocks.begin();
+		 iter != msg_template.mMemberBlocks.end(); ++iter)
+	{
+		const LLMessageBlock* mbci = *iter;
+		Block block;
+		block.mName = mbci->mName;
+		block.mType = mbci->mType;
+		block.mNumber = mbci->mNumber;
+		block.mSize = 0;
+		block.mFirstVariable = mVariables.size();
+		block.mVariableCount = 0;
+
+		for (LLMessageBlock::message_variable_map_t::const_iterator var_iter = mbci->mMemberVariables.begin();
+			 var_iter != mbci->mMemberVariables.end(); ++var_iter)
+		{
+			const LLMessageVariable* mvci = *var_iter;
+			Variable variable;
+			variable.mName = mvci->getName();
+			variable.mType = mvci->getType();
+			variable.mSize = mvci->getSize();
+			variable.mOffset = block.mSize;
+			if (block.mSize >= 0)
+			{
+				block.mSize = (MVT_VARIABLE == variable.mType) ? -1 : block.mSize + variable.mSize;
+			}
+			if (MVT_VARIABLE != variable.mType)
+			{
+				mMaxFixedSize = llmax(mMaxFixedSize, variable.mSize);
+			}
+			mVariables.push_back(variable);
+			++block.mVariableCount;
+		}
+		mBlocks.push_back(block);
+	}
+
+	// At most half full, so probes stay short.
+	U32 slots = 8;
+	while (slots < 2 * (mBlocks.size() + mVariables.size()))
+	{
+		slots *= 2;
+	}
+	Slot empty = { NULL, 0, 0 };
+	mSlots.resize(slots, empty);
+	mSlotMask = slots - 1;
+
+	for (S32 i = 0; i < (S32)mBlocks.size(); ++i)
+	{
+		insert(mBlocks[i].mName, -1, i);
+		for (U32 j = 0; j < mBlocks[i].mVariableCount; ++j)
+		{
+			insert(mVariables[mBlocks[i].mFirstVariable + j].mName, i, j);
+		}
+	}
+}
+
+void LLMessageLayout::insert(const char* name, S32 block, S32 index)
+{
+	U32 i = hash_name(name, block) & mSlotMask;
+	while (mSlots[i].mName)
+	{
+		i = (i + 1) & mSlotMask;
+	}
+	mSlots[i].mName = name;
+	mSlots[i].mBlock = block;
+	mSlots[i].mIndex = index;
+}
+
+S32 LLMessageLayout::find(const char* name, S32 block) const
+{
+	U32 i = hash_name(name, block) & mSlotMask;
+	while (mSlots[i].mName)
+	{
+		if (mSlots[i].mName == name && mSlots[i].mBlock == block)
+		{
+			return mSlots[i].mIndex;
+		}
+		i = (i + 1) & mSlotMask;
+	}
+	return -1;
+}
+
+S32 LLMessageLayout::findBlock(const char* name) const
+{
+	return find(name, -1);
+}
+
+S32 LLMessageLayout::findVariable(S32 block, const char* name) const
+{
+	return find(name, block);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file llmessagelayout.h
+ * @brief Flat, indexed form of a message template for decoding.
+ *
+ * @Description:
+ * Built once per LLMessageTemplate, the layout lists the template's blocks
+ * and variables in wire order, with the offset of every variable inside a
+ * block whose size is fixed, and a small open addressed table from the
+ * canonical block and variable names to their indices. Decoding a packet
+ * then only records where each field starts, and looking a field up is a
+ * hash probe and an index instead of two map searches.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESSAGELAYOUT_H
+#define LL_LLMESSAGELAYOUT_H
+
+#include "llmessagetemplate.h"
+
+#include <vector>
+
+class LLMessageLayout
+{
+public:
+	struct Variable
+	{
+		char*				mName;
+		EMsgVariableType	mType;
+		S32					mSize;		// bytes, or bytes of the length for MVT_VARIABLE
+		S32					mOffset;	// from the start of the block, -1 after an MVT_VARIABLE
+	};
+
+	struct Block
+	{
+		char*			mName;
+		EMsgBlockType	mType;
+		S32				mNumber;
+		S32				mSize;			// of one instance, -1 if it holds MVT_VARIABLE data
+		U32				mFirstVariable;
+		U32				mVariableCount;
+	};
+
+	LLMessageLayout(const LLMessageTemplate& msg_template);
+
+	// Names must be the canonical LLMessageStringTable pointers, as for the
+	// LLMessageReader accessors. Both return -1 if there is no such name.
+	S32 findBlock(const char* name) const;
+	// Index of the variable within block.
+	S32 findVariable(S32 block, const char* name) const;
+
+	S32 getBlockCount() const								{ return (S32)mBlocks.size(); }
+	const Block& getBlock(S32 block) const					{ return mBlocks[block]; }
+	const Variable& getVariable(const Block& block, S32 variable) const
+															{ return mVariables[block.mFirstVariable + variable]; }
+
+	// Largest fixed size variable; fields past the end of a packet read as
+	// this many zeros at most.
+	S32 getMaxFixedSize() const								{ return mMaxFixedSize; }
+
+private:
+	struct Slot
+	{
+		const char*	mName;
+		S32			mBlock;	// -1 for the entry of a block itself
+		S32			mIndex;
+	};
+
+	void insert(const char* name, S32 block, S32 index);
+	S32 find(const char* name, S32 block) const;
+
+	std::vector<Block>		mBlocks;
+	std::vector<Variable>	mVariables;
+	std::vector<Slot>		mSlots;
+	U32						mSlotMask;
+	S32						mMaxFixedSize;
+};
+
+#endif // LL_LLMESSAGELAYOUT_H
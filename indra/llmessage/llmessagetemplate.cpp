@@ -27,6 +27,7 @@
 #include "linden_common.h"
 
 #include "llmessagetemplate.h"
+#include "llmessagelayout.h" // <FS:Kadah/>
 
 #include "message.h"
 
@@ -171,6 +172,23 @@ std::ostream& operator<<(std::ostream& s, LLMessageTemplate &msg)
 	return s;
 }
 
+// <FS:Kadah>
+LLMessageTemplate::~LLMessageTemplate()
+{
+	for_each(mMemberBlocks.begin(), mMemberBlocks.end(), DeletePointer());
+	delete mLayout;
+}
+
+const LLMessageLayout& LLMessageTemplate::getLayout()
+{
+	if (!mLayout)
+	{
+		mLayout = new LLMessageLayout(*this);
+	}
+	return *mLayout;
+}
+// </FS:Kadah>
+
 void LLMessageTemplate::banUdp()
 {
 	static const char* deprecation[] = {
@@ -33,6 +33,8 @@
 
 #include "nd/ndexceptions.h" // <FS:ND/> For ndxran
 
+class LLMessageLayout; // <FS:Kadah/>
+
 class LLMsgVarData
 {
 public:
@@ -289,15 +291,19 @@ public:
 		mBanFromTrusted(false),
 		mBanFromUntrusted(false),
 		mHandlerFunc(NULL), 
-		mUserData(NULL)
+		mUserData(NULL),
+		mLayout(NULL) // <FS:Kadah/>
 	{ 
 		mName = LLMessageStringTable::getInstance()->getString(name);
 	}
 
-	~LLMessageTemplate()
-	{
-		for_each(mMemberBlocks.begin(), mMemberBlocks.end(), DeletePointer());
-	}
+	// <FS:Kadah> Also deletes the layout
+	//~LLMessageTemplate()
+	//{
+	//	for_each(mMemberBlocks.begin(), mMemberBlocks.end(), DeletePointer());
+	//}
+	~LLMessageTemplate();
+	// </FS:Kadah>
 
 	void addBlock(LLMessageBlock *blockp)
 	{
@@ -408,6 +414,9 @@ public:
 		return iter != mMemberBlocks.end()? *iter : NULL;
 	}
 
+	// <FS:Kadah/> Compiled on first use, once all blocks have been added.
+	const LLMessageLayout& getLayout();
+
 public:
 	typedef LLIndexedVector<LLMessageBlock*, char*, 8> message_block_map_t;
 	message_block_map_t						mMemberBlocks;
@@ -433,6 +442,8 @@ private:
 	// message handler function (this is set by each application)
 	void									(*mHandlerFunc)(LLMessageSystem *msgsystem, void **user_data);
 	void									**mUserData;
+
+	LLMessageLayout*						mLayout; // <FS:Kadah/>
 };
 
 #endif // LL_LLMESSAGETEMPLATE_H
@@ -59,6 +59,12 @@ LLPacketBuffer::LLPacketBuffer (S32 hSocket)
 	init(hSocket);
 }
 
+// <FS:Kadah> Batched UDP I/O
+LLPacketBuffer::LLPacketBuffer() : mSize(0)
+{
+}
+// </FS:Kadah>
+
 ///////////////////////////////////////////////////////////
 
 LLPacketBuffer::~LLPacketBuffer ()
@@ -74,3 +80,12 @@ void LLPacketBuffer::init (S32 hSocket)
 	mReceivingIF = ::get_receiving_interface();
 }
 
+// <FS:Kadah> Batched UDP I/O
+void LLPacketBuffer::set(S32 size, const LLHost &host, const LLHost &receiving_if)
+{
+	mSize = size;
+	mHost = host;
+	mReceivingIF = receiving_if;
+}
+// </FS:Kadah>
+
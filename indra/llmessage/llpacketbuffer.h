@@ -36,6 +36,9 @@ class LLPacketBuffer
 public:
 	LLPacketBuffer(const LLHost &host, const char *datap, const S32 size);
 	LLPacketBuffer(S32 hSocket);           // receive a packet
+	// <FS:Kadah> Batched UDP I/O
+	LLPacketBuffer();						// empty, filled in place by LLPacketRing
+	// </FS:Kadah>
 	~LLPacketBuffer();
 
 	S32			getSize() const					{ return mSize; }
@@ -44,6 +47,11 @@ public:
 	LLHost		getReceivingInterface() const	{ return mReceivingIF; }
 	void init(S32 hSocket);
 
+	// <FS:Kadah> Batched UDP I/O
+	char		*getWriteData()					{ return mData; }
+	void		set(S32 size, const LLHost &host, const LLHost &receiving_if);
+	// </FS:Kadah>
+
 protected:
 	char	mData[NET_BUFFER_SIZE];        // packet data		/* Flawfinder : ignore */
 	S32		mSize;          // size of buffer in bytes
@@ -55,7 +55,19 @@ LLPacketRing::LLPacketRing () :
 	mInBufferLength(0),
 	mOutBufferLength(0),
 	mDropPercentage(0.0f),
-	mPacketsToDrop(0x0)
+	// <FS:Kadah> Batched UDP I/O
+	//mPacketsToDrop(0x0)
+	mPacketsToDrop(0x0),
+	mUseBatching(FALSE),
+	mReceiveBatchCount(0),
+	mReceiveBatchPos(0),
+	mSendBatchCount(0),
+	mSendBatchSocket(-1),
+	mSendBatchFailures(0),
+	mSendBatchOpen(FALSE),
+	mReceiveCalls(0),
+	mSendCalls(0)
+	// </FS:Kadah>
 {
 }
 
@@ -83,6 +95,28 @@ void LLPacketRing::cleanup ()
 		delete packetp;
 		mSendQueue.pop();
 	}
+
+	// <FS:Kadah> Batched UDP I/O
+	mSendBatchCount = 0;
+	mSendBatchOpen = FALSE;
+	for (LLPacketBuffer* slot : mReceiveBatch)
+	{
+		delete slot;
+	}
+	mReceiveBatch.clear();
+	for (LLPacketBuffer* slot : mSendBatch)
+	{
+		delete slot;
+	}
+	mSendBatch.clear();
+	for (LLPacketBuffer* slot : mFreeBuffers)
+	{
+		delete slot;
+	}
+	mFreeBuffers.clear();
+	mReceiveBatchCount = 0;
+	mReceiveBatchPos = 0;
+	// </FS:Kadah>
 }
 
 ///////////////////////////////////////////////////////////
@@ -116,6 +150,134 @@ void LLPacketRing::setOutBandwidth(const F32 bps)
 {
 	mOutThrottle.setRate(bps);
 }
+
+// <FS:Kadah> Batched UDP I/O
+void LLPacketRing::setUseBatching(const BOOL use_batching)
+{
+	mUseBatching = use_batching && batch_packets_supported();
+	if (mUseBatching && mReceiveBatch.empty())
+	{
+		for (S32 i = 0; i < NET_MAX_BATCH; ++i)
+		{
+			mReceiveBatch.push_back(new LLPacketBuffer());
+			mSendBatch.push_back(new LLPacketBuffer());
+		}
+	}
+}
+
+BOOL LLPacketRing::useReceiveBatch() const
+{
+	return mUseBatching && !LLProxy::isSOCKSProxyEnabled();
+}
+
+LLPacketBuffer *LLPacketRing::nextFromBatch(S32 socket)
+{
+	if (mReceiveBatchPos == mReceiveBatchCount)
+	{
+		char* buffers[NET_MAX_BATCH];
+		S32 sizes[NET_MAX_BATCH];
+		LLHost senders[NET_MAX_BATCH];
+		LLHost receiving_ifs[NET_MAX_BATCH];
+		for (S32 i = 0; i < NET_MAX_BATCH; ++i)
+		{
+			buffers[i] = mReceiveBatch[i]->getWriteData();
+		}
+		mReceiveBatchPos = 0;
+		mReceiveBatchCount = receive_packets(socket, buffers, sizes, senders, receiving_ifs, NET_MAX_BATCH);
+		++mReceiveCalls;
+		for (S32 i = 0; i < mReceiveBatchCount; ++i)
+		{
+			mReceiveBatch[i]->set(sizes[i], senders[i], receiving_ifs[i]);
+		}
+	}
+	if (mReceiveBatchPos == mReceiveBatchCount)
+	{
+		return NULL;
+	}
+	return mReceiveBatch[mReceiveBatchPos++];
+}
+
+LLPacketBuffer *LLPacketRing::takeReceived(S32 socket)
+{
+	if (!useReceiveBatch())
+	{
+		++mReceiveCalls;
+		LLPacketBuffer* packetp = allocateReceived();
+		packetp->init(socket);
+		return packetp;
+	}
+	LLPacketBuffer* packetp = nextFromBatch(socket);
+	if (!packetp)
+	{
+		packetp = allocateReceived();
+		packetp->set(0, LLHost(), LLHost());
+		return packetp;
+	}
+	// Hand the slot over and put a spare one in its place.
+	mReceiveBatch[mReceiveBatchPos - 1] = allocateReceived();
+	return packetp;
+}
+
+LLPacketBuffer *LLPacketRing::allocateReceived()
+{
+	if (mFreeBuffers.empty())
+	{
+		return new LLPacketBuffer();
+	}
+	LLPacketBuffer* packetp = mFreeBuffers.back();
+	mFreeBuffers.pop_back();
+	return packetp;
+}
+
+void LLPacketRing::releaseReceived(LLPacketBuffer *packetp)
+{
+	// One batch worth of spares covers a drained socket, more would only
+	// hold on to what a burst once queued under the in throttle.
+	if (mFreeBuffers.size() < (size_t)NET_MAX_BATCH)
+	{
+		mFreeBuffers.push_back(packetp);
+	}
+	else
+	{
+		delete packetp;
+	}
+}
+
+void LLPacketRing::beginSendBatch()
+{
+	mSendBatchOpen = mUseBatching;
+}
+
+S32 LLPacketRing::flushSendBatch()
+{
+	sendBatch();
+	mSendBatchOpen = FALSE;
+	S32 failures = mSendBatchFailures;
+	mSendBatchFailures = 0;
+	return failures;
+}
+
+void LLPacketRing::sendBatch()
+{
+	if (!mSendBatchCount)
+	{
+		return;
+	}
+	const char* buffers[NET_MAX_BATCH];
+	S32 sizes[NET_MAX_BATCH];
+	LLHost recipients[NET_MAX_BATCH];
+	for (S32 i = 0; i < mSendBatchCount; ++i)
+	{
+		buffers[i] = mSendBatch[i]->getData();
+		sizes[i] = mSendBatch[i]->getSize();
+		recipients[i] = mSendBatch[i]->getHost();
+	}
+	S32 sent = send_packets(mSendBatchSocket, buffers, sizes, recipients, mSendBatchCount);
+	++mSendCalls;
+	mSendBatchFailures += mSendBatchCount - sent;
+	mSendBatchCount = 0;
+}
+// </FS:Kadah>
 ///////////////////////////////////////////////////////////
 S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
 {
@@ -144,7 +306,8 @@ S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
 	// need to set sender IP/port!!
 	mLastSender = packetp->getHost();
 	mLastReceivingIF = packetp->getReceivingInterface();
-	delete packetp;
+	//delete packetp;
+	releaseReceived(packetp); // <FS:Kadah> Batched UDP I/O
 
 	this->mInBufferLength -= packet_size;
 
@@ -167,7 +330,10 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 		while (!done)
 		{
 			LLPacketBuffer *packetp;
-			packetp = new LLPacketBuffer(socket);
+			// <FS:Kadah> Batched UDP I/O
+			//packetp = new LLPacketBuffer(socket);
+			packetp = takeReceived(socket);
+			// </FS:Kadah>
 
 			if (packetp->getSize())
 			{
@@ -181,7 +347,8 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 
 				if (mPacketsToDrop)
 				{
-					delete packetp;
+					//delete packetp;
+					releaseReceived(packetp); // <FS:Kadah> Batched UDP I/O
 					packetp = NULL;
 					packet_size = 0;
 					mPacketsToDrop--;
@@ -196,7 +363,8 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 				{
 					// Toss it.
 					LL_WARNS() << "Throwing away packet, overflowing buffer" << LL_ENDL;
-					delete packetp;
+					//delete packetp;
+					releaseReceived(packetp); // <FS:Kadah> Batched UDP I/O
 					packetp = NULL;
 				}
 				else if (packetp->getSize())
@@ -206,7 +374,8 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 				}
 				else
 				{
-					delete packetp;
+					//delete packetp;
+					releaseReceived(packetp); // <FS:Kadah> Batched UDP I/O
 					packetp = NULL;
 					done = true;
 				}
@@ -224,8 +393,23 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 	else
 	{
 		// no delay, pull straight from net
-		if (LLProxy::isSOCKSProxyEnabled())
+		// <FS:Kadah> Batched UDP I/O
+		//if (LLProxy::isSOCKSProxyEnabled())
+		if (useReceiveBatch())
+		{
+			LLPacketBuffer* packetp = nextFromBatch(socket);
+			if (packetp)
+			{
+				packet_size = packetp->getSize();
+				memcpy(datap, packetp->getData(), packet_size);	/*Flawfinder: ignore*/
+				mLastSender = packetp->getHost();
+				mLastReceivingIF = packetp->getReceivingInterface();
+			}
+		}
+		else if (LLProxy::isSOCKSProxyEnabled())
+		// </FS:Kadah>
 		{
+			++mReceiveCalls; // <FS:Kadah/> Batched UDP I/O
 			U8 buffer[NET_BUFFER_SIZE + SOCKS_HEADER_SIZE];
 			packet_size = receive_packet(socket, static_cast<char*>(static_cast<void*>(buffer)));
 			
@@ -246,11 +430,18 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 		}
 		else
 		{
+			++mReceiveCalls; // <FS:Kadah/> Batched UDP I/O
 			packet_size = receive_packet(socket, datap);
 			mLastSender = ::get_sender();
 		}
 
-		mLastReceivingIF = ::get_receiving_interface();
+		// <FS:Kadah> Batched UDP I/O
+		//mLastReceivingIF = ::get_receiving_interface();
+		if (!useReceiveBatch())
+		{
+			mLastReceivingIF = ::get_receiving_interface();
+		}
+		// </FS:Kadah>
 
 		if (packet_size)  // did we actually get a packet?
 		{
@@ -346,6 +537,22 @@ BOOL LLPacketRing::sendPacket(int h_socket, char * send_buffer, S32 buf_size, LL
 
 BOOL LLPacketRing::sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host)
 {
+	// <FS:Kadah> Batched UDP I/O
+	if (mSendBatchOpen && !LLProxy::isSOCKSProxyEnabled() && buf_size <= NET_BUFFER_SIZE)
+	{
+		if (mSendBatchCount == NET_MAX_BATCH || (mSendBatchCount && h_socket != mSendBatchSocket))
+		{
+			sendBatch();
+		}
+		LLPacketBuffer* packetp = mSendBatch[mSendBatchCount++];
+		memcpy(packetp->getWriteData(), send_buffer, buf_size);	/*Flawfinder: ignore*/
+		packetp->set(buf_size, host, LLHost());
+		mSendBatchSocket = h_socket;
+		// Failures are counted by flushSendBatch().
+		return TRUE;
+	}
+	++mSendCalls;
+	// </FS:Kadah>
 	
 	if (!LLProxy::isSOCKSProxyEnabled())
 	{
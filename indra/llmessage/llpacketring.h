@@ -29,6 +29,7 @@
 #define LL_LLPACKETRING_H
 
 #include <queue>
+#include <vector>
 
 #include "llhost.h"
 #include "llpacketbuffer.h"
@@ -60,6 +61,27 @@ public:
 
 	S32 getAndResetActualInBits()				{ S32 bits = mActualBitsIn; mActualBitsIn = 0; return bits;}
 	S32 getAndResetActualOutBits()				{ S32 bits = mActualBitsOut; mActualBitsOut = 0; return bits;}
+
+	// <FS:Kadah> Batched UDP I/O
+	// With batching, receivePacket() drains the socket NET_MAX_BATCH packets
+	// per system call into preallocated buffers, and packets sent between
+	// beginSendBatch() and flushSendBatch() go out together. Only available
+	// where batch_packets_supported(), and not through a SOCKS proxy.
+	void setUseBatching(const BOOL use_batching);
+	BOOL getUseBatching() const					{ return mUseBatching; }
+	// While the batch is open sendPacket() only queues and returns TRUE, a
+	// packet that then fails is counted by flushSendBatch() instead. Keep
+	// the batch to traffic that survives a lost packet anyway: reliable
+	// resends stay on the unacked list until acked, and a send() that works
+	// is no promise of delivery for the unreliable ones either.
+	void beginSendBatch();
+	// Sends what was gathered; returns the number of packets that failed.
+	S32  flushSendBatch();
+
+	// System calls made to receive and send, for measuring the batching.
+	U32 getAndResetReceiveCalls()				{ U32 calls = mReceiveCalls; mReceiveCalls = 0; return calls; }
+	U32 getAndResetSendCalls()					{ U32 calls = mSendCalls; mSendCalls = 0; return calls; }
+	// </FS:Kadah>
 protected:
 	BOOL mUseInThrottle;
 	BOOL mUseOutThrottle;
@@ -83,8 +105,35 @@ protected:
 	LLHost mLastSender;
 	LLHost mLastReceivingIF;
 
+	// <FS:Kadah> Batched UDP I/O
+	BOOL mUseBatching;
+	std::vector<LLPacketBuffer *> mReceiveBatch;	// received, handed out from mReceiveBatchPos
+	S32 mReceiveBatchCount;
+	S32 mReceiveBatchPos;
+	std::vector<LLPacketBuffer *> mSendBatch;		// waiting for flushSendBatch()
+	std::vector<LLPacketBuffer *> mFreeBuffers;		// received packets done with, for takeReceived()
+	S32 mSendBatchCount;
+	S32 mSendBatchSocket;
+	S32 mSendBatchFailures;
+	BOOL mSendBatchOpen;
+	U32 mReceiveCalls;
+	U32 mSendCalls;
+	// </FS:Kadah>
+
 private:
 	BOOL sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+
+	// <FS:Kadah> Batched UDP I/O
+	BOOL useReceiveBatch() const;
+	// Next received packet, or NULL; the ring keeps it.
+	LLPacketBuffer *nextFromBatch(S32 socket);
+	// Next received packet, never NULL but empty once the socket is drained;
+	// the caller hands it back with releaseReceived().
+	LLPacketBuffer *takeReceived(S32 socket);
+	LLPacketBuffer *allocateReceived();
+	void releaseReceived(LLPacketBuffer *packetp);
+	void sendBatch();
+	// </FS:Kadah>
 };
 
 
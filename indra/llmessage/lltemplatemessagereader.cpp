@@ -29,6 +29,7 @@
 
 #include "llfasttimer.h"
 #include "llmessagebuilder.h"
+#include "llmessagelayout.h" // <FS:Kadah/>
 #include "llmessagetemplate.h"
 #include "llmath.h"
 #include "llquaternion.h"
@@ -44,7 +45,10 @@ LLTemplateMessageReader::LLTemplateMessageReader(message_template_number_map_t&
 												 number_template_map) :
 	mReceiveSize(0),
 	mCurrentRMessageTemplate(NULL),
-	mCurrentRMessageData(NULL),
+	// <FS:Kadah>
+	//mCurrentRMessageData(NULL),
+	mCurrentRMessageLayout(NULL),
+	// </FS:Kadah>
 	mMessageNumbers(number_template_map)
 {
 }
@@ -52,8 +56,10 @@ LLTemplateMessageReader::LLTemplateMessageReader(message_template_number_map_t&
 //virtual 
 LLTemplateMessageReader::~LLTemplateMessageReader()
 {
-	delete mCurrentRMessageData;
-	mCurrentRMessageData = NULL;
+	// <FS:Kadah>
+	//delete mCurrentRMessageData;
+	//mCurrentRMessageData = NULL;
+	// </FS:Kadah>
 }
 
 //virtual
@@ -61,10 +67,31 @@ void LLTemplateMessageReader::clearMessage()
 {
 	mReceiveSize = -1;
 	mCurrentRMessageTemplate = NULL;
-	delete mCurrentRMessageData;
-	mCurrentRMessageData = NULL;
+	// <FS:Kadah> Keep the buffers for the next message
+	//delete mCurrentRMessageData;
+	//mCurrentRMessageData = NULL;
+	mCurrentRMessageLayout = NULL;
+	// </FS:Kadah>
 }
 
+// <FS:Kadah>
+S32 LLTemplateMessageReader::findBlock(const char* blockname, S32 blocknum) const
+{
+	S32 block = mCurrentRMessageLayout->findBlock(blockname);
+	if (block < 0 || blocknum < 0 || blocknum >= mBlockCounts[block])
+	{
+		return -1;
+	}
+	return block;
+}
+
+const LLTemplateMessageReader::Field& LLTemplateMessageReader::getField(S32 block, S32 blocknum, S32 variable) const
+{
+	return mFields[mBlockFields[block] + blocknum * mCurrentRMessageLayout->getBlock(block).mVariableCount + variable];
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Compiled layout lookups instead of the LLMsgData maps
 void LLTemplateMessageReader::getData(const char *blockname, const char *varname, void *datap, S32 size, S32 blocknum, S32 max_size)
 {
 	// is there a message ready to go?
@@ -74,81 +101,82 @@ void LLTemplateMessageReader::getData(const char *blockname, const char *varname
 		return;
 	}
 
-	if (!mCurrentRMessageData)
+	if (!mCurrentRMessageLayout)
 	{
 		LL_ERRS() << "Invalid mCurrentMessageData in getData!" << LL_ENDL;
 		return;
 	}
 
-	char *bnamep = (char *)blockname + blocknum; // this works because it's just a hash.  The bnamep is never derefference
-	char *vnamep = (char *)varname; 
-
-	LLMsgData::msg_blk_data_map_t::const_iterator iter = mCurrentRMessageData->mMemberBlocks.find(bnamep);
-
-	if (iter == mCurrentRMessageData->mMemberBlocks.end())
+	S32 block = findBlock(blockname, blocknum);
+	if (block < 0)
 	{
 		LL_ERRS() << "Block " << blockname << " #" << blocknum
-			<< " not in message " << mCurrentRMessageData->mName << LL_ENDL;
+			<< " not in message " << mCurrentRMessageTemplate->mName << LL_ENDL;
 		return;
 	}
 
-	LLMsgBlkData *msg_block_data = iter->second;
-	LLMsgBlkData::msg_var_data_map_t &var_data_map = msg_block_data->mMemberVarData;
-
-	if (var_data_map.find(vnamep) == var_data_map.end())
+	S32 variable = mCurrentRMessageLayout->findVariable(block, varname);
+	if (variable < 0)
 	{
-		LL_ERRS() << "Variable "<< vnamep << " not in message "
-			<< mCurrentRMessageData->mName<< " block " << bnamep << LL_ENDL;
+		LL_ERRS() << "Variable "<< varname << " not in message "
+			<< mCurrentRMessageTemplate->mName << " block " << blockname << LL_ENDL;
 		return;
 	}
 
-	LLMsgVarData& vardata = msg_block_data->mMemberVarData[vnamep];
+	const Field& field = getField(block, blocknum, variable);
+	const S32 vardata_size = field.mSize;
 
-	if (size && size != vardata.getSize())
+	if (size && size != vardata_size)
 	{
-		LL_ERRS() << "Msg " << mCurrentRMessageData->mName 
-			<< " variable " << vnamep
-			<< " is size " << vardata.getSize()
+		LL_ERRS() << "Msg " << mCurrentRMessageTemplate->mName 
+			<< " variable " << varname
+			<< " is size " << vardata_size
 			<< " but copying into buffer of size " << size
 			<< LL_ENDL;
 		return;
 	}
 
-
-	const S32 vardata_size = vardata.getSize();
+	// The packet is kept as received, little endian.
+	const U8* vardata = mData.data() + field.mOffset;
 	if( max_size >= vardata_size )
 	{   
+#ifdef LL_BIG_ENDIAN
+		htolememcpy(datap, vardata,
+					mCurrentRMessageLayout->getVariable(mCurrentRMessageLayout->getBlock(block), variable).mType,
+					vardata_size);
+#else
 		switch( vardata_size )
 		{ 
 		case 1:
-			*((U8*)datap) = *((U8*)vardata.getData());
+			*((U8*)datap) = *vardata;
 			break;
 		case 2:
-			*((U16*)datap) = *((U16*)vardata.getData());
+			memcpy(datap, vardata, 2);
 			break;
 		case 4:
-			*((U32*)datap) = *((U32*)vardata.getData());
+			memcpy(datap, vardata, 4);
 			break;
 		case 8:
-			((U32*)datap)[0] = ((U32*)vardata.getData())[0];
-			((U32*)datap)[1] = ((U32*)vardata.getData())[1];
+			memcpy(datap, vardata, 8);
 			break;
 		default:
-			memcpy(datap, vardata.getData(), vardata_size);
+			memcpy(datap, vardata, vardata_size);
 			break;
 		}
+#endif
 	}
 	else
 	{
-		LL_WARNS() << "Msg " << mCurrentRMessageData->mName 
-			<< " variable " << vnamep
-			<< " is size " << vardata.getSize()
+		LL_WARNS() << "Msg " << mCurrentRMessageTemplate->mName 
+			<< " variable " << varname
+			<< " is size " << vardata_size
 			<< " but truncated to max size of " << max_size
 			<< LL_ENDL;
 
-		memcpy(datap, vardata.getData(), max_size);
+		memcpy(datap, vardata, max_size);
 	}
 }
+// </FS:Kadah>
 
 S32 LLTemplateMessageReader::getNumberOfBlocks(const char *blockname)
 {
@@ -159,24 +187,32 @@ S32 LLTemplateMessageReader::getNumberOfBlocks(const char *blockname)
 		return -1;
 	}
 
-	if (!mCurrentRMessageData)
+	// <FS:Kadah>
+	//if (!mCurrentRMessageData)
+	if (!mCurrentRMessageLayout)
+	// </FS:Kadah>
 	{
 		LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
 		return -1;
 	}
 
-	char *bnamep = (char *)blockname; 
-
-	LLMsgData::msg_blk_data_map_t::const_iterator iter = mCurrentRMessageData->mMemberBlocks.find(bnamep);
-	
-	if (iter == mCurrentRMessageData->mMemberBlocks.end())
-	{
-		return 0;
-	}
-
-	return (iter->second)->mBlockNumber;
+	// <FS:Kadah>
+	//char *bnamep = (char *)blockname; 
+	//
+	//LLMsgData::msg_blk_data_map_t::const_iterator iter = mCurrentRMessageData->mMemberBlocks.find(bnamep);
+	//
+	//if (iter == mCurrentRMessageData->mMemberBlocks.end())
+	//{
+	//	return 0;
+	//}
+	//
+	//return (iter->second)->mBlockNumber;
+	S32 block = mCurrentRMessageLayout->findBlock(blockname);
+	return block < 0 ? 0 : mBlockCounts[block];
+	// </FS:Kadah>
 }
 
+// <FS:Kadah> Compiled layout lookups instead of the LLMsgData maps
 S32 LLTemplateMessageReader::getSize(const char *blockname, const char *varname)
 {
 	// is there a message ready to go?
@@ -186,43 +222,36 @@ S32 LLTemplateMessageReader::getSize(const char *blockname, const char *varname)
 		return LL_MESSAGE_ERROR;
 	}
 
-	if (!mCurrentRMessageData)
+	if (!mCurrentRMessageLayout)
 	{	// This is a serious error - crash
 		LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
 		return LL_MESSAGE_ERROR;
 	}
 
-	char *bnamep = (char *)blockname; 
-
-	LLMsgData::msg_blk_data_map_t::const_iterator iter = mCurrentRMessageData->mMemberBlocks.find(bnamep);
-	
-	if (iter == mCurrentRMessageData->mMemberBlocks.end())
+	S32 block = findBlock(blockname, 0);
+	if (block < 0)
 	{	// don't crash
-		LL_INFOS() << "Block " << bnamep << " not in message "
-			<< mCurrentRMessageData->mName << LL_ENDL;
+		LL_INFOS() << "Block " << blockname << " not in message "
+			<< mCurrentRMessageTemplate->mName << LL_ENDL;
 		return LL_BLOCK_NOT_IN_MESSAGE;
 	}
 
-	char *vnamep = (char *)varname; 
-
-	LLMsgBlkData* msg_data = iter->second;
-	LLMsgVarData& vardata = msg_data->mMemberVarData[vnamep];
-	
-	if (!vardata.getName())
+	S32 variable = mCurrentRMessageLayout->findVariable(block, varname);
+	if (variable < 0)
 	{	// don't crash
 		LL_INFOS() << "Variable " << varname << " not in message "
-			<< mCurrentRMessageData->mName << " block " << bnamep << LL_ENDL;
+			<< mCurrentRMessageTemplate->mName << " block " << blockname << LL_ENDL;
 		return LL_VARIABLE_NOT_IN_BLOCK;
 	}
 
-	if (mCurrentRMessageTemplate->mMemberBlocks[bnamep]->mType != MBT_SINGLE)
+	if (mCurrentRMessageLayout->getBlock(block).mType != MBT_SINGLE)
 	{	// This is a serious error - crash
-		LL_ERRS() << "Block " << bnamep << " isn't type MBT_SINGLE,"
+		LL_ERRS() << "Block " << blockname << " isn't type MBT_SINGLE,"
 			" use getSize with blocknum argument!" << LL_ENDL;
 		return LL_MESSAGE_ERROR;
 	}
 
-	return vardata.getSize();
+	return getField(block, 0, variable).mSize;
 }
 
 S32 LLTemplateMessageReader::getSize(const char *blockname, S32 blocknum, const char *varname)
@@ -234,36 +263,31 @@ S32 LLTemplateMessageReader::getSize(const char *blockname, S32 blocknum, const
 		return LL_MESSAGE_ERROR;
 	}
 
-	if (!mCurrentRMessageData)
+	if (!mCurrentRMessageLayout)
 	{	// This is a serious error - crash
 		LL_ERRS() << "Invalid mCurrentRMessageData in getData!" << LL_ENDL;
 		return LL_MESSAGE_ERROR;
 	}
 
-	char *bnamep = (char *)blockname + blocknum; 
-	char *vnamep = (char *)varname; 
-
-	LLMsgData::msg_blk_data_map_t::const_iterator iter = mCurrentRMessageData->mMemberBlocks.find(bnamep);
-	
-	if (iter == mCurrentRMessageData->mMemberBlocks.end())
+	S32 block = findBlock(blockname, blocknum);
+	if (block < 0)
 	{	// don't crash
-		LL_INFOS() << "Block " << bnamep << " not in message " 
-			<< mCurrentRMessageData->mName << LL_ENDL;
+		LL_INFOS() << "Block " << blockname << " #" << blocknum << " not in message " 
+			<< mCurrentRMessageTemplate->mName << LL_ENDL;
 		return LL_BLOCK_NOT_IN_MESSAGE;
 	}
 
-	LLMsgBlkData* msg_data = iter->second;
-	LLMsgVarData& vardata = msg_data->mMemberVarData[vnamep];
-	
-	if (!vardata.getName())
+	S32 variable = mCurrentRMessageLayout->findVariable(block, varname);
+	if (variable < 0)
 	{	// don't crash
-		LL_INFOS() << "Variable " << vnamep << " not in message "
-			<<  mCurrentRMessageData->mName << " block " << bnamep << LL_ENDL;
+		LL_INFOS() << "Variable " << varname << " not in message "
+			<< mCurrentRMessageTemplate->mName << " block " << blockname << LL_ENDL;
 		return LL_VARIABLE_NOT_IN_BLOCK;
 	}
 
-	return vardata.getSize();
+	return getField(block, blocknum, variable).mSize;
 }
+// </FS:Kadah>
 
 void LLTemplateMessageReader::getBinaryData(const char *blockname, 
 											const char *varname, void *datap, 
@@ -521,6 +545,12 @@ void LLTemplateMessageReader::logRanOffEndOfPacket( const LLHost& host, const S3
 			<< " bytes at position " << where
 			<< " going past packet end at " << mReceiveSize
 			<< LL_ENDL;
+	// <FS:Kadah> Also used without a message system, by tests and tools
+	if (!gMessageSystem)
+	{
+		return;
+	}
+	// </FS:Kadah>
 	if(gMessageSystem->mVerboseLog)
 	{
 		LL_INFOS() << "MSG: -> " << host << "\tREAD PAST END:\t"
@@ -539,40 +569,47 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 
 	llassert( mReceiveSize >= 0 );
 	llassert( mCurrentRMessageTemplate);
-	llassert( !mCurrentRMessageData );
-	delete mCurrentRMessageData; // just to make sure
+	// <FS:Kadah>
+	//llassert( !mCurrentRMessageData );
+	//delete mCurrentRMessageData; // just to make sure
+	// </FS:Kadah>
 
 	// The offset tells us how may bytes to skip after the end of the
 	// message name.
 	U8 offset = buffer[PHL_OFFSET];
 	S32 decode_pos = LL_PACKET_ID_SIZE + (S32)(mCurrentRMessageTemplate->mFrequency) + offset;
 
-	// create base working data set
-	mCurrentRMessageData = new LLMsgData(mCurrentRMessageTemplate->mName);
-	
-	// loop through the template building the data structure as we go
-	LLMessageTemplate::message_block_map_t::const_iterator iter;
-	for(iter = mCurrentRMessageTemplate->mMemberBlocks.begin();
-		iter != mCurrentRMessageTemplate->mMemberBlocks.end();
-		++iter)
+	// <FS:Kadah> Record where each field is, per the template's compiled
+	// layout, instead of copying every field into an LLMsgData tree.
+	const LLMessageLayout& layout = mCurrentRMessageTemplate->getLayout();
+	const S32 block_count = layout.getBlockCount();
+	const U32 zeros = mReceiveSize;
+	mData.assign(buffer, buffer + mReceiveSize);
+	mData.resize(mReceiveSize + layout.getMaxFixedSize(), 0);
+	mFields.clear();
+	mBlockFields.resize(block_count);
+	mBlockCounts.resize(block_count);
+	mCurrentRMessageLayout = &layout;
+	bool has_blocks = false;
+
+	for (S32 block = 0; block < block_count; ++block)
 	{
-		LLMessageBlock* mbci = *iter;
+		const LLMessageLayout::Block& mbci = layout.getBlock(block);
 		U8	repeat_number;
-		S32	i;
 
 		// how many of this block?
 
-		if (mbci->mType == MBT_SINGLE)
+		if (mbci.mType == MBT_SINGLE)
 		{
 			// just one
 			repeat_number = 1;
 		}
-		else if (mbci->mType == MBT_MULTIPLE)
+		else if (mbci.mType == MBT_MULTIPLE)
 		{
 			// a known number
-			repeat_number = mbci->mNumber;
+			repeat_number = mbci.mNumber;
 		}
-		else if (mbci->mType == MBT_VARIABLE)
+		else if (mbci.mType == MBT_VARIABLE)
 		{
 			// need to read the number from the message
 			// repeat number is a single byte
@@ -597,42 +634,35 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 			return FALSE;
 		}
 
-		LLMsgBlkData* cur_data_block = NULL;
+		mBlockFields[block] = mFields.size();
+		mBlockCounts[block] = repeat_number;
+		has_blocks = has_blocks || repeat_number;
 
-		// now loop through the block
-		for (i = 0; i < repeat_number; i++)
+		for (S32 i = 0; i < repeat_number; i++)
 		{
-			if (i)
-			{
-				// build new name to prevent collisions
-				// TODO: This should really change to a vector
-				cur_data_block = new LLMsgBlkData(mbci->mName, repeat_number);
-				cur_data_block->mName = mbci->mName + i;
-			}
-			else
+			if (mbci.mSize >= 0 && decode_pos + mbci.mSize <= mReceiveSize)
 			{
-				cur_data_block = new LLMsgBlkData(mbci->mName, repeat_number);
+				// All fixed size and all there, the offsets are known.
+				for (U32 v = 0; v < mbci.mVariableCount; ++v)
+				{
+					const LLMessageLayout::Variable& mvci = layout.getVariable(mbci, v);
+					Field field = { (U32)(decode_pos + mvci.mOffset), mvci.mSize };
+					mFields.push_back(field);
+				}
+				decode_pos += mbci.mSize;
+				continue;
 			}
 
-			// add the block to the message
-			mCurrentRMessageData->addBlock(cur_data_block);
-
-			// now read the variables
-			for (LLMessageBlock::message_variable_map_t::const_iterator iter = 
-					 mbci->mMemberVariables.begin();
-				 iter != mbci->mMemberVariables.end(); iter++)
+			for (U32 v = 0; v < mbci.mVariableCount; ++v)
 			{
-				const LLMessageVariable& mvci = **iter;
-
-				// ok, build out the variables
-				// add variable block
-				cur_data_block->addVariable(mvci.getName(), mvci.getType());
+				const LLMessageLayout::Variable& mvci = layout.getVariable(mbci, v);
+				Field field = { zeros, 0 };
 
 				// what type of variable?
-				if (mvci.getType() == MVT_VARIABLE)
+				if (mvci.mType == MVT_VARIABLE)
 				{
 					// variable, get the number of bytes to read from the template
-					S32 data_size = mvci.getSize();
+					S32 data_size = mvci.mSize;
 					U8 tsizeb = 0;
 					U16 tsizeh = 0;
 					U32 tsize = 0;
@@ -666,47 +696,53 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 					}
 					decode_pos += data_size;
 
-					cur_data_block->addData(mvci.getName(), &buffer[decode_pos], tsize, mvci.getType());
+					if (tsize > (U32)llmax(mReceiveSize - decode_pos, 0))
+					{
+						// Only what was received can be read.
+						logRanOffEndOfPacket(sender, decode_pos, tsize);
+					}
+					else if (tsize)
+					{
+						field.mOffset = decode_pos;
+						field.mSize = tsize;
+					}
 					decode_pos += tsize;
 				}
 				else
 				{
 					// fixed!
-					// so, copy data pointer and set data size to fixed size
-					if ((decode_pos + mvci.getSize()) > mReceiveSize)
+					// so, point at the data and set data size to fixed size
+					if ((decode_pos + mvci.mSize) > mReceiveSize)
 					{
-						logRanOffEndOfPacket(sender, decode_pos, mvci.getSize());
-
+						logRanOffEndOfPacket(sender, decode_pos, mvci.mSize);
 						// default to 0s.
-						U32 size = mvci.getSize();
-						std::vector<U8> data(size, 0);
-						cur_data_block->addData(mvci.getName(), &(data[0]), 
-												size, mvci.getType());
 					}
 					else
 					{
-						cur_data_block->addData(mvci.getName(), 
-												&buffer[decode_pos], 
-												mvci.getSize(), 
-												mvci.getType());
+						field.mOffset = decode_pos;
 					}
-					decode_pos += mvci.getSize();
+					field.mSize = mvci.mSize;
+					decode_pos += mvci.mSize;
 				}
+				mFields.push_back(field);
 			}
 		}
 	}
 
-	if (mCurrentRMessageData->mMemberBlocks.empty()
-		&& !mCurrentRMessageTemplate->mMemberBlocks.empty())
+	if (!has_blocks && block_count)
 	{
 		LL_DEBUGS() << "Empty message '" << mCurrentRMessageTemplate->mName << "' (no blocks)" << LL_ENDL;
 		return FALSE;
 	}
+	// </FS:Kadah>
 
 	{
 		static LLTimer decode_timer;
 
-		if(LLMessageReader::getTimeDecodes() || gMessageSystem->getTimingCallback())
+		// <FS:Kadah> Also used without a message system, by tests and tools
+		//if(LLMessageReader::getTimeDecodes() || gMessageSystem->getTimingCallback())
+		if(LLMessageReader::getTimeDecodes() || (gMessageSystem && gMessageSystem->getTimingCallback()))
+		// </FS:Kadah>
 		{
 			decode_timer.reset();
 		}
@@ -716,11 +752,14 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 			LL_WARNS() << "Message from " << sender << " with no handler function received: " << mCurrentRMessageTemplate->mName << LL_ENDL;
 		}
 
-		if(LLMessageReader::getTimeDecodes() || gMessageSystem->getTimingCallback())
+		// <FS:Kadah>
+		//if(LLMessageReader::getTimeDecodes() || gMessageSystem->getTimingCallback())
+		if(LLMessageReader::getTimeDecodes() || (gMessageSystem && gMessageSystem->getTimingCallback()))
+		// </FS:Kadah>
 		{
 			F32 decode_time = decode_timer.getElapsedTimeF32();
 
-			if (gMessageSystem->getTimingCallback())
+			if (gMessageSystem && gMessageSystem->getTimingCallback()) // <FS:Kadah/>
 			{
 				(gMessageSystem->getTimingCallback())(mCurrentRMessageTemplate->mName,
 								decode_time,
@@ -824,9 +863,37 @@ bool LLTemplateMessageReader::isUdpBanned() const
 //virtual 
 void LLTemplateMessageReader::copyToBuilder(LLMessageBuilder& builder) const
 {
-	if(NULL == mCurrentRMessageTemplate)
+	// <FS:Kadah> Builders still take an LLMsgData, so build one here; this
+	// is the rare path (forwarding a message).
+	//if(NULL == mCurrentRMessageTemplate)
+	if(NULL == mCurrentRMessageTemplate || NULL == mCurrentRMessageLayout)
     {
         return;
     }
-	builder.copyFromMessageData(*mCurrentRMessageData);
+	//builder.copyFromMessageData(*mCurrentRMessageData);
+	LLMsgData data(mCurrentRMessageTemplate->mName);
+	for (S32 block = 0; block < mCurrentRMessageLayout->getBlockCount(); ++block)
+	{
+		const LLMessageLayout::Block& mbci = mCurrentRMessageLayout->getBlock(block);
+		for (S32 i = 0; i < mBlockCounts[block]; ++i)
+		{
+			LLMsgBlkData* cur_data_block = new LLMsgBlkData(mbci.mName, mBlockCounts[block]);
+			if (i)
+			{
+				// same naming as the blocks used to have
+				cur_data_block->mName = mbci.mName + i;
+			}
+			data.addBlock(cur_data_block);
+
+			for (U32 v = 0; v < mbci.mVariableCount; ++v)
+			{
+				const LLMessageLayout::Variable& mvci = mCurrentRMessageLayout->getVariable(mbci, v);
+				const Field& field = getField(block, i, v);
+				cur_data_block->addVariable(mvci.mName, mvci.mType);
+				cur_data_block->addData(mvci.mName, mData.data() + field.mOffset, field.mSize, mvci.mType);
+			}
+		}
+	}
+	builder.copyFromMessageData(data);
+	// </FS:Kadah>
 }
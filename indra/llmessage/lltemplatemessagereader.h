@@ -30,7 +30,9 @@
 #include "llmessagereader.h"
 
 #include <map>
+#include <vector> // <FS:Kadah/>
 
+class LLMessageLayout; // <FS:Kadah/>
 class LLMessageTemplate;
 class LLMsgData;
 
@@ -118,9 +120,28 @@ private:
 
 	BOOL decodeData(const U8* buffer, const LLHost& sender );
 
+	// <FS:Kadah> Fields are found through the template's compiled layout
+	// instead of an LLMsgData tree built per packet.
+	struct Field
+	{
+		U32 mOffset; // into mData
+		S32 mSize;
+	};
+	// Layout index of blockname if the message has instance blocknum of it, else -1.
+	S32 findBlock(const char* blockname, S32 blocknum) const;
+	const Field& getField(S32 block, S32 blocknum, S32 variable) const;
+	// </FS:Kadah>
+
 	S32	mReceiveSize;
 	LLMessageTemplate* mCurrentRMessageTemplate;
-	LLMsgData* mCurrentRMessageData;
+	// <FS:Kadah>
+	//LLMsgData* mCurrentRMessageData;
+	const LLMessageLayout* mCurrentRMessageLayout; // NULL until a message is decoded
+	std::vector<U8> mData;			// the packet, then zeros for fields past its end
+	std::vector<Field> mFields;		// per block instance, per variable
+	std::vector<U32> mBlockFields;	// first field of each layout block
+	std::vector<S32> mBlockCounts;	// instances of each layout block
+	// </FS:Kadah>
 	message_template_number_map_t& mMessageNumbers;
 };
 
@@ -778,6 +778,10 @@ void LLMessageSystem::processAcks(LockMessageChecker&, F32 collect_time)
 
 	BOOL dump = FALSE;
 	{
+		// <FS:Kadah> Batched UDP I/O: resends, acks and pings go out together
+		mPacketRing.beginSendBatch();
+		// </FS:Kadah>
+
 		// Check the status of circuits
 		mCircuitInfo.updateWatchDogTimers(this);
 
@@ -797,6 +801,10 @@ void LLMessageSystem::processAcks(LockMessageChecker&, F32 collect_time)
 			mDenyTrustedCircuitSet.clear();
 		}
 
+		// <FS:Kadah> Batched UDP I/O
+		mSendPacketFailureCount += mPacketRing.flushSendBatch();
+		// </FS:Kadah>
+
 		if (mMaxMessageCounts >= 0)
 		{
 			if (mNumMessageCounts >= mMaxMessageCounts)
@@ -658,6 +658,156 @@ BOOL send_packet(int hSocket, const char * sendBuffer, int size, U32 recipient,
 	return success;
 }
 
+// <FS:Kadah> Batched UDP I/O
+#if LL_LINUX
+BOOL batch_packets_supported()
+{
+	return TRUE;
+}
+
+S32 receive_packets(int hSocket, char** buffers, S32* sizes, LLHost* senders, LLHost* receiving_ifs, S32 count)
+{
+	struct mmsghdr msgs[NET_MAX_BATCH];
+	struct iovec iovs[NET_MAX_BATCH];
+	struct sockaddr_in from[NET_MAX_BATCH];
+	char cmsgs[NET_MAX_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+	count = llmin(count, NET_MAX_BATCH);
+	memset(msgs, 0, sizeof(msgs[0]) * count);
+	for (S32 i = 0; i < count; ++i)
+	{
+		iovs[i].iov_base = buffers[i];
+		iovs[i].iov_len = NET_BUFFER_SIZE;
+		msgs[i].msg_hdr.msg_name = &from[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_control = cmsgs[i];
+		msgs[i].msg_hdr.msg_controllen = sizeof(cmsgs[i]);
+	}
+
+	int received = recvmmsg(hSocket, msgs, count, MSG_DONTWAIT, NULL);
+	if (received <= 0)
+	{
+		// Same as receive_packet(), nothing waiting and errors are both zero.
+		return 0;
+	}
+
+	for (int i = 0; i < received; ++i)
+	{
+		sizes[i] = msgs[i].msg_len;
+		senders[i] = LLHost(from[i].sin_addr.s_addr, ntohs(from[i].sin_port));
+
+		U32 dstip = INVALID_HOST_IP_ADDRESS;
+		for (struct cmsghdr* cmsgptr = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsgptr))
+		{
+			if (cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO)
+			{
+				// ipi_spec_dst, as in recvfrom_destip()
+				dstip = ((in_pktinfo*)CMSG_DATA(cmsgptr))->ipi_spec_dst.s_addr;
+			}
+		}
+		receiving_ifs[i] = LLHost(dstip, INVALID_PORT);
+	}
+	return received;
+}
+
+S32 send_packets(int hSocket, const char* const* buffers, const S32* sizes, const LLHost* recipients, S32 count)
+{
+	struct mmsghdr msgs[NET_MAX_BATCH];
+	struct iovec iovs[NET_MAX_BATCH];
+	struct sockaddr_in to[NET_MAX_BATCH];
+
+	S32 sent = 0;
+	while (count > 0)
+	{
+		S32 batch = llmin(count, NET_MAX_BATCH);
+		memset(msgs, 0, sizeof(msgs[0]) * batch);
+		memset(to, 0, sizeof(to[0]) * batch);
+		for (S32 i = 0; i < batch; ++i)
+		{
+			to[i].sin_family = AF_INET;
+			to[i].sin_addr.s_addr = recipients[i].getAddress();
+			to[i].sin_port = htons(recipients[i].getPort());
+			iovs[i].iov_base = (void*)buffers[i];
+			iovs[i].iov_len = sizes[i];
+			msgs[i].msg_hdr.msg_name = &to[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(to[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		S32 done = 0;
+		while (done < batch)
+		{
+			int ret = sendmmsg(hSocket, msgs + done, batch - done, 0);
+			if (ret > 0)
+			{
+				sent += ret;
+				done += ret;
+			}
+			else
+			{
+				// sendmmsg() stops at the first packet that fails; send_packet()
+				// retries and logs that one as it would have been unbatched.
+				if (send_packet(hSocket, buffers[done], sizes[done], recipients[done].getAddress(), recipients[done].getPort()))
+				{
+					++sent;
+				}
+				++done;
+			}
+		}
+
+		buffers += batch;
+		sizes += batch;
+		recipients += batch;
+		count -= batch;
+	}
+	return sent;
+}
+#endif // LL_LINUX
+// </FS:Kadah>
+
 #endif
 
+// <FS:Kadah> Batched UDP I/O
+#if !LL_LINUX
+BOOL batch_packets_supported()
+{
+	return FALSE;
+}
+
+S32 receive_packets(int hSocket, char** buffers, S32* sizes, LLHost* senders, LLHost* receiving_ifs, S32 count)
+{
+	S32 received = 0;
+	while (received < count)
+	{
+		S32 size = receive_packet(hSocket, buffers[received]);
+		if (size <= 0)
+		{
+			break;
+		}
+		sizes[received] = size;
+		senders[received] = get_sender();
+		receiving_ifs[received] = get_receiving_interface();
+		++received;
+	}
+	return received;
+}
+
+S32 send_packets(int hSocket, const char* const* buffers, const S32* sizes, const LLHost* recipients, S32 count)
+{
+	S32 sent = 0;
+	for (S32 i = 0; i < count; ++i)
+	{
+		if (send_packet(hSocket, buffers[i], sizes[i], recipients[i].getAddress(), recipients[i].getPort()))
+		{
+			++sent;
+		}
+	}
+	return sent;
+}
+#endif // !LL_LINUX
+// </FS:Kadah>
+
 //EOF
@@ -45,6 +45,20 @@ S32		receive_packet(int hSocket, char * receiveBuffer);
 
 BOOL	send_packet(int hSocket, const char *sendBuffer, int size, U32 recipient, int nPort);	// Returns TRUE on success.
 
+// <FS:Kadah> Batched UDP I/O
+// Where batch_packets_supported(), receive_packets() and send_packets() move
+// up to NET_MAX_BATCH datagrams with a single system call (recvmmsg and
+// sendmmsg); elsewhere they loop over receive_packet() and send_packet().
+const S32 NET_MAX_BATCH = 32;
+
+BOOL	batch_packets_supported();
+// Receives up to count packets into buffers of NET_BUFFER_SIZE bytes without
+// blocking. Returns the number of packets received, zero if there were none.
+S32		receive_packets(int hSocket, char** buffers, S32* sizes, LLHost* senders, LLHost* receiving_ifs, S32 count);
+// Returns the number of packets sent successfully.
+S32		send_packets(int hSocket, const char* const* buffers, const S32* sizes, const LLHost* recipients, S32 count);
+// </FS:Kadah>
+
 //void	get_sender(char * tmp);
 LLHost	get_sender();
 U32		get_sender_port();
@@ -35,6 +35,65 @@
 
 U32 gPatchSize, gWordBits;
 
+// <FS:Kadah> Thread safe terrain decoding
+namespace
+{
+	// Reads the bits of an LLBitPack in the same order as bitUnpack(), a
+	// byte at a time instead of a bit at a time. sync() hands the position
+	// back to the bit pack.
+	class LLPatchBitReader
+	{
+	public:
+		LLPatchBitReader(LLBitPack &bitpack)
+		:	mBitPack(bitpack),
+			mBits(bitpack.mLoadSize ? (bitpack.mLoad >> (MAX_DATA_BITS - bitpack.mLoadSize)) : 0),
+			mCount(bitpack.mLoadSize),
+			mPos(bitpack.mBufferSize)
+		{
+		}
+
+		// The next count bits, count <= 8, first bit highest.
+		U32 read(U32 count)
+		{
+			if (mCount < count)
+			{
+				// Only the bytes bitUnpack() would have loaded.
+				mBits = (mBits << MAX_DATA_BITS) | mBitPack.mBuffer[mPos++];
+				mCount += MAX_DATA_BITS;
+			}
+			mCount -= count;
+			U32 value = mBits >> mCount;
+			mBits &= (1 << mCount) - 1;
+			return value;
+		}
+
+		// A value of wbits bits, bitUnpack() into a little endian U32.
+		U32 readWord(S32 wbits)
+		{
+			U32 value = 0;
+			for (S32 shift = 0; wbits > 0; shift += MAX_DATA_BITS, wbits -= MAX_DATA_BITS)
+			{
+				value |= read(llmin(wbits, (S32)MAX_DATA_BITS)) << shift;
+			}
+			return value;
+		}
+
+		void sync()
+		{
+			mBitPack.mBufferSize = mPos;
+			mBitPack.mLoadSize = mCount;
+			mBitPack.mLoad = (U8)(mBits << (MAX_DATA_BITS - mCount));
+		}
+
+	private:
+		LLBitPack	&mBitPack;
+		U32			mBits;		// the low mCount bits are still to be read
+		U32			mCount;
+		U32			mPos;
+	};
+}
+// </FS:Kadah>
+
 void	init_patch_coding(LLBitPack &bitpack)
 {
 	bitpack.resetBitPacking();
@@ -204,7 +263,10 @@ void	init_patch_decoding(LLBitPack &bitpack)
 	bitpack.resetBitPacking();
 }
 
-void	decode_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp)
+// <FS:Kadah> Thread safe terrain decoding
+//void	decode_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp)
+void	unpack_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp)
+// </FS:Kadah>
 {
 	U16 retvalu16;
 
@@ -226,12 +288,23 @@ void	decode_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp)
 	bitpack.bitUnpack(&retvalu8, 8);
 	gopp->layer_type = retvalu8;
 
+	// <FS:Kadah> Thread safe terrain decoding
+	//gPatchSize = gopp->patch_size; 
+}
+
+void	decode_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp)
+{
+	unpack_patch_group_header(bitpack, gopp);
 	gPatchSize = gopp->patch_size; 
+	// </FS:Kadah>
 }
 
 // <FS:CR> Aurora Sim
 //void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph)
-void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_patch)
+// <FS:Kadah> Thread safe terrain decoding
+//void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_patch)
+void	unpack_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_patch)
+// </FS:Kadah>
 // </FS:CR> Aurora Sim
 {
 	U8 retvalu8;
@@ -307,13 +380,33 @@ void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_pat
 	ph->patchids = retvalu32;
 // </FS:CR> Aurora Sim
 
-	gWordBits = (ph->quant_wbits & 0xf) + 2;
+	// <FS:Kadah> Thread safe terrain decoding
+	//gWordBits = (ph->quant_wbits & 0xf) + 2;
+}
+
+void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_patch)
+{
+	unpack_patch_header(bitpack, ph, b_large_patch);
+	if (END_OF_PATCHES != ph->quant_wbits)
+	{
+		gWordBits = (ph->quant_wbits & 0xf) + 2;
+	}
 }
 
 void	decode_patch(LLBitPack &bitpack, S32 *patches)
+{
+	unpack_patch(bitpack, patches, gPatchSize, gWordBits);
+}
+
+//void	decode_patch(LLBitPack &bitpack, S32 *patches)
+void	unpack_patch(LLBitPack &bitpack, S32 *patches, S32 patch_size, S32 wbits)
+// </FS:Kadah>
 {
 #ifdef LL_BIG_ENDIAN
-	S32		i, j, patch_size = gPatchSize, wbits = gWordBits;
+	// <FS:Kadah> Thread safe terrain decoding
+	//S32		i, j, patch_size = gPatchSize, wbits = gWordBits;
+	S32		i, j;
+	// </FS:Kadah>
 	U8		tempu8;
 	U16		tempu16;
 	U32		tempu32;
@@ -386,52 +479,87 @@ void	decode_patch(LLBitPack &bitpack, S32 *patches)
 		}
 	}
 #else
-	S32		i, j, patch_size = gPatchSize, wbits = gWordBits;
-	U32		temp;
+	// <FS:Kadah> Thread safe terrain decoding
+	//S32		i, j, patch_size = gPatchSize, wbits = gWordBits;
+	// Read through a local bit buffer instead of bitUnpack() a bit at a
+	// time; the bit pack is left where bitUnpack() would have left it.
+	S32		i, j;
+	LLPatchBitReader reader(bitpack);
 	for (i = 0; i < patch_size*patch_size; i++)
 	{
-		temp = 0;
-		bitpack.bitUnpack((U8 *)&temp, 1);
-		if (temp)
+		if (!reader.read(1))
 		{
-			// either 0 EOB or Value
-			temp = 0;
-			bitpack.bitUnpack((U8 *)&temp, 1);
-			if (temp)
+			patches[i] = 0;
+		}
+		// either 0 EOB or Value
+		else if (reader.read(1))
+		{
+			// value, negative or positive
+			if (reader.read(1))
 			{
-				// value
-				temp = 0;
-				bitpack.bitUnpack((U8 *)&temp, 1);
-				if (temp)
-				{
-					// negative
-					temp = 0;
-					bitpack.bitUnpack((U8 *)&temp, wbits);
-					patches[i] = temp;
-					patches[i] *= -1;
-				}
-				else
-				{
-					// positive
-					temp = 0;
-					bitpack.bitUnpack((U8 *)&temp, wbits);
-					patches[i] = temp;
-				}
+				patches[i] = -(S32)reader.readWord(wbits);
 			}
 			else
 			{
-				for (j = i; j < patch_size*patch_size; j++)
-				{
-					patches[j] = 0;
-				}
-				return;
+				patches[i] = reader.readWord(wbits);
 			}
 		}
 		else
 		{
-			patches[i] = 0;
+			for (j = i; j < patch_size*patch_size; j++)
+			{
+				patches[j] = 0;
+			}
+			break;
 		}
 	}
+	reader.sync();
+//	U32		temp;
+//	for (i = 0; i < patch_size*patch_size; i++)
+//	{
+//		temp = 0;
+//		bitpack.bitUnpack((U8 *)&temp, 1);
+//		if (temp)
+//		{
+//			// either 0 EOB or Value
+//			temp = 0;
+//			bitpack.bitUnpack((U8 *)&temp, 1);
+//			if (temp)
+//			{
+//				// value
+//				temp = 0;
+//				bitpack.bitUnpack((U8 *)&temp, 1);
+//				if (temp)
+//				{
+//					// negative
+//					temp = 0;
+//					bitpack.bitUnpack((U8 *)&temp, wbits);
+//					patches[i] = temp;
+//					patches[i] *= -1;
+//				}
+//				else
+//				{
+//					// positive
+//					temp = 0;
+//					bitpack.bitUnpack((U8 *)&temp, wbits);
+//					patches[i] = temp;
+//				}
+//			}
+//			else
+//			{
+//				for (j = i; j < patch_size*patch_size; j++)
+//				{
+//					patches[j] = 0;
+//				}
+//				return;
+//			}
+//		}
+//		else
+//		{
+//			patches[i] = 0;
+//		}
+//	}
+	// </FS:Kadah>
 #endif
 }
 
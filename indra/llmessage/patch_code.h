@@ -46,4 +46,13 @@ void	decode_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_pat
 // </FS:CR> Aurora Sim
 void	decode_patch(LLBitPack &bitpack, S32 *patches);
 
+// <FS:Kadah> Thread safe terrain decoding
+// Same as the above, without the gPatchSize and gWordBits globals, so that
+// patches can be decoded off the main thread. The word bits of a patch are
+// (ph->quant_wbits & 0xf) + 2.
+void	unpack_patch_group_header(LLBitPack &bitpack, LLGroupHeader *gopp);
+void	unpack_patch_header(LLBitPack &bitpack, LLPatchHeader *ph, BOOL b_large_patch);
+void	unpack_patch(LLBitPack &bitpack, S32 *patches, S32 patch_size, S32 wbits);
+// </FS:Kadah>
+
 #endif
@@ -91,4 +91,27 @@ void init_patch_decompressor(S32 size);
 void decompress_patch(F32 *patch, S32 *cpatch, LLPatchHeader *ph);
 void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph);
 
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+typedef enum e_patch_idct_kernels
+{
+	PATCH_IDCT_SCALAR = 0,
+	PATCH_IDCT_SSE2,
+	PATCH_IDCT_AVX2,
+	PATCH_IDCT_COUNT
+} EPatchIDCTKernels;
+
+// Widest kernels supported by this CPU.
+EPatchIDCTKernels get_best_patch_idct_kernels();
+EPatchIDCTKernels get_patch_idct_kernels();
+// Selects the kernels, clamped to get_best_patch_idct_kernels(). Meant for
+// tests and benchmarks. Returns the kernels actually selected.
+EPatchIDCTKernels set_patch_idct_kernels(EPatchIDCTKernels kernels);
+const char* get_patch_idct_kernels_name(EPatchIDCTKernels kernels);
+
+// Same result as decompress_patch(), without the globals set up by
+// init_patch_decompressor() and set_group_of_patch_header(), so it can run
+// on any thread. Returns FALSE for a patch size other than 16 or 32.
+BOOL decompress_patch_block(F32 *patch, S32 stride, S32 size, const S32 *cpatch, const LLPatchHeader *ph);
+// </FS:Kadah>
+
 #endif
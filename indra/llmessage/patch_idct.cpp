@@ -30,6 +30,25 @@
 //#include "vmath.h"
 #include "v3math.h"
 #include "patch_dct.h"
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+#include "llmemory.h"
+#include "llprocessor.h"
+
+#include <atomic>
+
+#if LL_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+
+// GCC and clang only emit AVX2 instructions for functions built for that
+// target; MSVC accepts the intrinsics anywhere.
+#if LL_GNUC || LL_CLANG
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LL_TARGET_AVX2
+#endif
+#endif // LL_X86
+// </FS:Kadah>
 
 LLGroupHeader	*gGOPP;
 
@@ -39,14 +58,20 @@ void set_group_of_patch_header(LLGroupHeader *gopp)
 }
 
 F32 gPatchDequantizeTable[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-void build_patch_dequantize_table(S32 size)
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+//void build_patch_dequantize_table(S32 size)
+void build_patch_dequantize_table(F32 *table, S32 size)
+// </FS:Kadah>
 {
 	S32 i, j;
 	for (j = 0; j < size; j++)
 	{
 		for (i = 0; i < size; i++)
 		{
-			gPatchDequantizeTable[j*size + i] = (1.f + 2.f*(i+j));
+			// <FS:Kadah> Vectorised, thread safe terrain decompression
+			//gPatchDequantizeTable[j*size + i] = (1.f + 2.f*(i+j));
+			table[j*size + i] = (1.f + 2.f*(i+j));
+			// </FS:Kadah>
 		}
 	}
 }
@@ -55,7 +80,10 @@ S32	gCurrentDeSize = 0;
 
 F32	gPatchICosines[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
 
-void setup_patch_icosines(S32 size)
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+//void setup_patch_icosines(S32 size)
+void setup_patch_icosines(F32 *icosines, S32 size)
+// </FS:Kadah>
 {
 	S32 n, u;
 	F32 oosob = F_PI*0.5f/size;
@@ -64,14 +92,20 @@ void setup_patch_icosines(S32 size)
 	{
 		for (n = 0; n < size; n++)
 		{
-			gPatchICosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
+			// <FS:Kadah> Vectorised, thread safe terrain decompression
+			//gPatchICosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
+			icosines[u*size+n] = cosf((2.f*n+1.f)*u*oosob);
+			// </FS:Kadah>
 		}
 	}
 }
 
 S32	gDeCopyMatrix[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
 
-void build_decopy_matrix(S32 size)
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+//void build_decopy_matrix(S32 size)
+void build_decopy_matrix(S32 *decopy_matrix, S32 size)
+// </FS:Kadah>
 {
 	S32 i, j, count;
 	BOOL	b_diag = FALSE;
@@ -84,7 +118,10 @@ void build_decopy_matrix(S32 size)
 	while (  (i < size)
 		   &&(j < size))
 	{
-		gDeCopyMatrix[j*size + i] = count;
+		// <FS:Kadah> Vectorised, thread safe terrain decompression
+		//gDeCopyMatrix[j*size + i] = count;
+		decopy_matrix[j*size + i] = count;
+		// </FS:Kadah>
 
 		count++;
 
@@ -140,9 +177,14 @@ void init_patch_decompressor(S32 size)
 	if (size != gCurrentDeSize)
 	{
 		gCurrentDeSize = size;
-		build_patch_dequantize_table(size);
-		setup_patch_icosines(size);
-		build_decopy_matrix(size);
+		// <FS:Kadah> Vectorised, thread safe terrain decompression
+		//build_patch_dequantize_table(size);
+		//setup_patch_icosines(size);
+		//build_decopy_matrix(size);
+		build_patch_dequantize_table(gPatchDequantizeTable, size);
+		setup_patch_icosines(gPatchICosines, size);
+		build_decopy_matrix(gDeCopyMatrix, size);
+		// </FS:Kadah>
 	}
 }
 
@@ -682,3 +724,376 @@ void decompress_patchv(LLVector3 *v, S32 *cpatch, LLPatchHeader *ph)
 	}
 }
 
+
+// <FS:Kadah> Vectorised, thread safe terrain decompression
+//
+// The kernels below do the same float operations, in the same order, as
+// idct_patch() and idct_patch_large(): every output starts from OO_SQRT2
+// times the first coefficient and adds the other products one after the
+// other. Only neighbouring outputs are computed side by side, so the result
+// is that of decompress_patch() as long as the compiler keeps the order of
+// float operations (not so under MSVC /fp:fast). No fused multiply-adds for
+// the same reason.
+
+namespace
+{
+	// Per patch size, so that decoding threads need no init_patch_decompressor().
+	struct LLPatchDecompressTables
+	{
+		LL_ALIGN_16(F32 mDequantize[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+		LL_ALIGN_16(F32 mICosines[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+		S32 mDeCopy[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+
+		explicit LLPatchDecompressTables(S32 size)
+		{
+			build_patch_dequantize_table(mDequantize, size);
+			setup_patch_icosines(mICosines, size);
+			build_decopy_matrix(mDeCopy, size);
+		}
+	};
+
+	const LLPatchDecompressTables& get_decompress_tables(S32 size)
+	{
+		static const LLPatchDecompressTables normal_tables(NORMAL_PATCH_SIZE);
+		static const LLPatchDecompressTables large_tables(LARGE_PATCH_SIZE);
+		return (size == NORMAL_PATCH_SIZE) ? normal_tables : large_tables;
+	}
+
+	std::atomic<S32> sIDCTKernels(-1);
+
+	EPatchIDCTKernels detect_patch_idct_kernels()
+	{
+#if LL_X86
+		LLProcessorInfo cpu;
+		if (cpu.hasAVX2())
+		{
+			return PATCH_IDCT_AVX2;
+		}
+		// SSE2 is a build requirement on x86, see llsimdmath.h
+		return PATCH_IDCT_SSE2;
+#else
+		return PATCH_IDCT_SCALAR;
+#endif
+	}
+
+	// The non zero rows and columns of a dequantized block, DC excluded.
+	// Products of zero coefficients only ever add zeros to a sum, so the
+	// kernels skip them: the values are the same, only the sign of a zero
+	// result can differ. Terrain patches rarely have more than a handful of
+	// rows and columns of coefficients.
+	struct LLPatchCoefficients
+	{
+		S32 mRows[LARGE_PATCH_SIZE];
+		S32 mRowCount;
+		S32 mColumns[LARGE_PATCH_SIZE];
+		S32 mColumnCount;
+
+		LLPatchCoefficients(const F32 *block, S32 size)
+		:	mRowCount(0),
+			mColumnCount(0)
+		{
+			U32 rows = 0;
+			U32 columns = 0;
+			for (S32 u = 0; u < size; u++)
+			{
+				for (S32 column = 0; column < size; column++)
+				{
+					if (block[u*size + column] != 0.f)
+					{
+						rows |= 1 << u;
+						columns |= 1 << column;
+					}
+				}
+			}
+			for (S32 u = 1; u < size; u++)
+			{
+				if (rows & (1 << u))
+				{
+					mRows[mRowCount++] = u;
+				}
+				if (columns & (1 << u))
+				{
+					mColumns[mColumnCount++] = u;
+				}
+			}
+		}
+	};
+
+	// Columns first, into temp, then lines back into block, as idct_patch().
+	// Written a row of outputs at a time, which compilers vectorise.
+	template<S32 SIZE>
+	void idct_patch_scalar(F32 *block, const F32 *icosines, const LLPatchCoefficients &coefficients)
+	{
+		F32 temp[SIZE*SIZE];
+		F32 total[SIZE];
+		for (S32 n = 0; n < SIZE; n++)
+		{
+			for (S32 column = 0; column < SIZE; column++)
+			{
+				total[column] = OO_SQRT2*block[column];
+			}
+			for (S32 r = 0; r < coefficients.mRowCount; r++)
+			{
+				const S32 u = coefficients.mRows[r];
+				const F32 icosine = icosines[u*SIZE + n];
+				const F32 *row = block + u*SIZE;
+				for (S32 column = 0; column < SIZE; column++)
+				{
+					total[column] += row[column]*icosine;
+				}
+			}
+			for (S32 column = 0; column < SIZE; column++)
+			{
+				temp[n*SIZE + column] = total[column];
+			}
+		}
+
+		const F32 oosob = 2.f/SIZE;
+		for (S32 line = 0; line < SIZE; line++)
+		{
+			const F32 *linein = temp + line*SIZE;
+			const F32 dc = OO_SQRT2*linein[0];
+			for (S32 n = 0; n < SIZE; n++)
+			{
+				total[n] = dc;
+			}
+			for (S32 c = 0; c < coefficients.mColumnCount; c++)
+			{
+				const S32 u = coefficients.mColumns[c];
+				const F32 coefficient = linein[u];
+				const F32 *row = icosines + u*SIZE;
+				for (S32 n = 0; n < SIZE; n++)
+				{
+					total[n] += coefficient*row[n];
+				}
+			}
+			for (S32 n = 0; n < SIZE; n++)
+			{
+				block[line*SIZE + n] = total[n]*oosob;
+			}
+		}
+	}
+
+#if LL_X86
+	// SSE2: four outputs of a pass at a time, in VECTORS registers held
+	// across the whole sum.
+	template<S32 SIZE>
+	void idct_patch_sse2(F32 *block, const F32 *icosines, const LLPatchCoefficients &coefficients)
+	{
+		const S32 VECTORS = SIZE/4;
+		LL_ALIGN_16(F32 temp[SIZE*SIZE]);
+		__m128 total[VECTORS];
+
+		const __m128 oosqrt2 = _mm_set1_ps(OO_SQRT2);
+		for (S32 n = 0; n < SIZE; n++)
+		{
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				total[v] = _mm_mul_ps(oosqrt2, _mm_load_ps(block + 4*v));
+			}
+			for (S32 r = 0; r < coefficients.mRowCount; r++)
+			{
+				const S32 u = coefficients.mRows[r];
+				const __m128 icosine = _mm_set1_ps(icosines[u*SIZE + n]);
+				const F32 *row = block + u*SIZE;
+				for (S32 v = 0; v < VECTORS; v++)
+				{
+					total[v] = _mm_add_ps(total[v], _mm_mul_ps(_mm_load_ps(row + 4*v), icosine));
+				}
+			}
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				_mm_store_ps(temp + n*SIZE + 4*v, total[v]);
+			}
+		}
+
+		const __m128 oosob = _mm_set1_ps(2.f/SIZE);
+		for (S32 line = 0; line < SIZE; line++)
+		{
+			const F32 *linein = temp + line*SIZE;
+			const __m128 dc = _mm_set1_ps(OO_SQRT2*linein[0]);
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				total[v] = dc;
+			}
+			for (S32 c = 0; c < coefficients.mColumnCount; c++)
+			{
+				const S32 u = coefficients.mColumns[c];
+				const __m128 coefficient = _mm_set1_ps(linein[u]);
+				const F32 *row = icosines + u*SIZE;
+				for (S32 v = 0; v < VECTORS; v++)
+				{
+					total[v] = _mm_add_ps(total[v], _mm_mul_ps(coefficient, _mm_load_ps(row + 4*v)));
+				}
+			}
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				_mm_store_ps(block + line*SIZE + 4*v, _mm_mul_ps(total[v], oosob));
+			}
+		}
+	}
+
+	// AVX2: the same with eight outputs at a time. Unaligned loads, the
+	// blocks are only 16 byte aligned.
+	template<S32 SIZE>
+	LL_TARGET_AVX2 void idct_patch_avx2(F32 *block, const F32 *icosines, const LLPatchCoefficients &coefficients)
+	{
+		const S32 VECTORS = SIZE/8;
+		LL_ALIGN_16(F32 temp[SIZE*SIZE]);
+		__m256 total[VECTORS];
+
+		const __m256 oosqrt2 = _mm256_set1_ps(OO_SQRT2);
+		for (S32 n = 0; n < SIZE; n++)
+		{
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				total[v] = _mm256_mul_ps(oosqrt2, _mm256_loadu_ps(block + 8*v));
+			}
+			for (S32 r = 0; r < coefficients.mRowCount; r++)
+			{
+				const S32 u = coefficients.mRows[r];
+				const __m256 icosine = _mm256_set1_ps(icosines[u*SIZE + n]);
+				const F32 *row = block + u*SIZE;
+				for (S32 v = 0; v < VECTORS; v++)
+				{
+					total[v] = _mm256_add_ps(total[v], _mm256_mul_ps(_mm256_loadu_ps(row + 8*v), icosine));
+				}
+			}
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				_mm256_storeu_ps(temp + n*SIZE + 8*v, total[v]);
+			}
+		}
+
+		const __m256 oosob = _mm256_set1_ps(2.f/SIZE);
+		for (S32 line = 0; line < SIZE; line++)
+		{
+			const F32 *linein = temp + line*SIZE;
+			const __m256 dc = _mm256_set1_ps(OO_SQRT2*linein[0]);
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				total[v] = dc;
+			}
+			for (S32 c = 0; c < coefficients.mColumnCount; c++)
+			{
+				const S32 u = coefficients.mColumns[c];
+				const __m256 coefficient = _mm256_set1_ps(linein[u]);
+				const F32 *row = icosines + u*SIZE;
+				for (S32 v = 0; v < VECTORS; v++)
+				{
+					total[v] = _mm256_add_ps(total[v], _mm256_mul_ps(coefficient, _mm256_loadu_ps(row + 8*v)));
+				}
+			}
+			for (S32 v = 0; v < VECTORS; v++)
+			{
+				_mm256_storeu_ps(block + line*SIZE + 8*v, _mm256_mul_ps(total[v], oosob));
+			}
+		}
+	}
+#endif // LL_X86
+
+	template<S32 SIZE>
+	void idct_patch_block(F32 *block, const F32 *icosines)
+	{
+		const LLPatchCoefficients coefficients(block, SIZE);
+		switch (get_patch_idct_kernels())
+		{
+#if LL_X86
+		case PATCH_IDCT_AVX2:
+			idct_patch_avx2<SIZE>(block, icosines, coefficients);
+			break;
+		case PATCH_IDCT_SSE2:
+			idct_patch_sse2<SIZE>(block, icosines, coefficients);
+			break;
+#endif
+		default:
+			idct_patch_scalar<SIZE>(block, icosines, coefficients);
+			break;
+		}
+	}
+}
+
+EPatchIDCTKernels get_best_patch_idct_kernels()
+{
+	static const EPatchIDCTKernels best = detect_patch_idct_kernels();
+	return best;
+}
+
+EPatchIDCTKernels get_patch_idct_kernels()
+{
+	S32 kernels = sIDCTKernels.load(std::memory_order_relaxed);
+	if (kernels < 0)
+	{
+		kernels = get_best_patch_idct_kernels();
+		sIDCTKernels.store(kernels, std::memory_order_relaxed);
+	}
+	return (EPatchIDCTKernels)kernels;
+}
+
+EPatchIDCTKernels set_patch_idct_kernels(EPatchIDCTKernels kernels)
+{
+	kernels = llclamp(kernels, PATCH_IDCT_SCALAR, get_best_patch_idct_kernels());
+	sIDCTKernels.store(kernels, std::memory_order_relaxed);
+	return kernels;
+}
+
+const char* get_patch_idct_kernels_name(EPatchIDCTKernels kernels)
+{
+	switch (kernels)
+	{
+	case PATCH_IDCT_SSE2:
+		return "SSE2";
+	case PATCH_IDCT_AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+BOOL decompress_patch_block(F32 *patch, S32 stride, S32 size, const S32 *cpatch, const LLPatchHeader *ph)
+{
+	if (size != NORMAL_PATCH_SIZE && size != LARGE_PATCH_SIZE)
+	{
+		return FALSE;
+	}
+	const LLPatchDecompressTables& tables = get_decompress_tables(size);
+
+	S32		i, j;
+	LL_ALIGN_16(F32 block[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE]);
+
+	// Same as decompress_patch() from here on.
+	F32		range = ph->range;
+	S32		prequant = (ph->quant_wbits >> 4) + 2;
+	S32		quantize = 1<<prequant;
+	F32		hmin = ph->dc_offset;
+
+	F32		ooq = 1.f/(F32)quantize;
+	F32		mult = ooq*range;
+	F32		addval = mult*(F32)(1<<(prequant - 1))+hmin;
+
+	for (i = 0; i < size*size; i++)
+	{
+		block[i] = cpatch[tables.mDeCopy[i]]*tables.mDequantize[i];
+	}
+
+	if (size == NORMAL_PATCH_SIZE)
+	{
+		idct_patch_block<NORMAL_PATCH_SIZE>(block, tables.mICosines);
+	}
+	else
+	{
+		idct_patch_block<LARGE_PATCH_SIZE>(block, tables.mICosines);
+	}
+
+	for (j = 0; j < size; j++)
+	{
+		F32 *tpatch = patch + j*stride;
+		const F32 *tblock = block + j*size;
+		for (i = 0; i < size; i++)
+		{
+			tpatch[i] = tblock[i]*mult+addval;
+		}
+	}
+	return TRUE;
+}
+// </FS:Kadah>
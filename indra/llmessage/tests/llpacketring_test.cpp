@@ -0,0 +1,180 @@
+/**
+ * @file llpacketring_test.cpp
+ * @brief Tests for the batched receive and send of LLPacketRing.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llpacketring.h"
+#include "../net.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct LLPacketRingFixture
+	{
+		LLPacketRingFixture()
+		:	mReceiveSocket(-1),
+			mSendSocket(-1),
+			mReceivePort(NET_USE_OS_ASSIGNED_PORT),
+			mSendPort(NET_USE_OS_ASSIGNED_PORT)
+		{
+			start_net(mReceiveSocket, mReceivePort);
+			start_net(mSendSocket, mSendPort);
+			mReceiver = LLHost(ip_string_to_u32(LOOPBACK_ADDRESS_STRING), mReceivePort);
+		}
+
+		~LLPacketRingFixture()
+		{
+			end_net(mReceiveSocket);
+			end_net(mSendSocket);
+		}
+
+		void send(LLPacketRing& ring, S32 count, S32 size = 100, S32 first = 0)
+		{
+			std::vector<char> data(size);
+			for (S32 i = first; i < first + count; ++i)
+			{
+				data[0] = (char)i;
+				ring.sendPacket(mSendSocket, &data[0], size, mReceiver);
+			}
+		}
+
+		// Packets waiting on the receive socket, in order.
+		std::vector<S32> drain(LLPacketRing& ring)
+		{
+			std::vector<S32> received;
+			char buffer[NET_BUFFER_SIZE];
+			// Loopback delivery is not instant; give it a few tries.
+			for (S32 tries = 0; tries < 100; ++tries)
+			{
+				S32 size;
+				while ((size = ring.receivePacket(mReceiveSocket, buffer)) > 0)
+				{
+					received.push_back((U8)buffer[0]);
+					ensure_equals("sender port", ring.getLastSender().getPort(), (U32)mSendPort);
+				}
+				ms_sleep(1);
+				if (!received.empty() && !ring.receivePacket(mReceiveSocket, buffer))
+				{
+					break;
+				}
+			}
+			return received;
+		}
+
+		S32 mReceiveSocket;
+		S32 mSendSocket;
+		int mReceivePort;
+		int mSendPort;
+		LLHost mReceiver;
+	};
+
+	typedef test_group<LLPacketRingFixture> LLPacketRingTestGroup;
+	typedef LLPacketRingTestGroup::object LLPacketRingTestObject;
+	LLPacketRingTestGroup packetRingTestGroup("LLPacketRing");
+
+	template<> template<>
+	void LLPacketRingTestObject::test<1>()
+	{
+		set_test_name("batched receive");
+		LLPacketRing sender;
+		LLPacketRing receiver;
+		receiver.setUseBatching(TRUE);
+
+		send(sender, 50);
+		receiver.getAndResetReceiveCalls();
+		std::vector<S32> received = drain(receiver);
+		ensure_equals("all packets received", received.size(), (size_t)50);
+		for (S32 i = 0; i < 50; ++i)
+		{
+			ensure_equals("in order", received[i], i);
+		}
+		if (receiver.getUseBatching())
+		{
+			ensure("fewer calls than packets", receiver.getAndResetReceiveCalls() < 50);
+		}
+	}
+
+	template<> template<>
+	void LLPacketRingTestObject::test<2>()
+	{
+		set_test_name("send batch waits for the flush");
+		LLPacketRing sender;
+		LLPacketRing receiver;
+		sender.setUseBatching(TRUE);
+
+		sender.beginSendBatch();
+		send(sender, 10);
+		if (sender.getUseBatching())
+		{
+			ms_sleep(5);
+			char buffer[NET_BUFFER_SIZE];
+			ensure_equals("nothing sent before the flush", receiver.receivePacket(mReceiveSocket, buffer), 0);
+			ensure_equals("no send calls before the flush", sender.getAndResetSendCalls(), (U32)0);
+		}
+		// A full batch goes out without waiting for the flush.
+		send(sender, NET_MAX_BATCH, 100, 10);
+		ensure_equals("no failures", sender.flushSendBatch(), 0);
+		if (sender.getUseBatching())
+		{
+			ensure_equals("two send calls", sender.getAndResetSendCalls(), (U32)2);
+		}
+		std::vector<S32> received = drain(receiver);
+		ensure_equals("all packets received", received.size(), (size_t)(10 + NET_MAX_BATCH));
+		for (S32 i = 0; i < 10 + NET_MAX_BATCH; ++i)
+		{
+			ensure_equals("in order", received[i], i);
+		}
+
+		// Outside a batch packets go out at once.
+		send(sender, 1);
+		ensure_equals("unbatched send", drain(receiver).size(), (size_t)1);
+	}
+
+	template<> template<>
+	void LLPacketRingTestObject::test<3>()
+	{
+		set_test_name("in throttle with batching");
+		LLPacketRing sender;
+		LLPacketRing receiver;
+		receiver.setUseBatching(TRUE);
+		receiver.setUseInThrottle(TRUE);
+		receiver.setInBandwidth(8000.f);	// one 1000 byte packet a second
+
+		send(sender, 10, 1000);
+		ms_sleep(20);
+		char buffer[NET_BUFFER_SIZE];
+		S32 delivered = 0;
+		while (receiver.receivePacket(mReceiveSocket, buffer) > 0)
+		{
+			++delivered;
+		}
+		ensure("throttle holds packets back", delivered < 10);
+		ensure_equals("rest is queued", receiver.getAndResetActualInBits(), 10 * 1000 * 8);
+	}
+}
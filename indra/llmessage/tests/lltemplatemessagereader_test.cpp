@@ -0,0 +1,258 @@
+/**
+ * @file lltemplatemessagereader_test.cpp
+ * @brief LLTemplateMessageReader and LLMessageLayout test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../lltemplatemessagereader.h"
+#include "../lltemplatemessagebuilder.h"
+#include "../llmessagelayout.h"
+#include "../llmessagetemplate.h"
+#include "../llmessagetemplateparser.h"
+#include "message.h"
+
+#include "../test/lltut.h"
+
+static const char* TEST_TEMPLATE =
+	"version 2.0\n"
+	"{\n"
+	"	TestMessage Low 1 NotTrusted Unencoded\n"
+	"	{\n"
+	"		Info Single\n"
+	"		{ ID U32 }\n"
+	"		{ Name Variable 1 }\n"
+	"		{ Port U16 }\n"
+	"	}\n"
+	"	{\n"
+	"		Data Variable\n"
+	"		{ Kind U8 }\n"
+	"		{ Key LLUUID }\n"
+	"	}\n"
+	"	{\n"
+	"		Pair Multiple 2\n"
+	"		{ Value S32 }\n"
+	"	}\n"
+	"}\n";
+
+namespace tut
+{
+	struct LLTemplateMessageReaderFixture
+	{
+		LLTemplateMessageReaderFixture()
+		{
+			LLTemplateTokenizer tokens(TEST_TEMPLATE);
+			LLTemplateParser parsed(tokens);
+			mTemplate = *parsed.getMessagesBegin();
+			mNames[mTemplate->mName] = mTemplate;
+			mNumbers[mTemplate->mMessageNumber] = mTemplate;
+
+			mInfo = name("Info");
+			mID = name("ID");
+			mName = name("Name");
+			mPort = name("Port");
+			mData = name("Data");
+			mKind = name("Kind");
+			mKey = name("Key");
+			mPair = name("Pair");
+			mValue = name("Value");
+		}
+
+		~LLTemplateMessageReaderFixture()
+		{
+			delete mTemplate;
+		}
+
+		static char* name(const char* str)
+		{
+			return LLMessageStringTable::getInstance()->getString(str);
+		}
+
+		// TestMessage with data_blocks Data blocks.
+		S32 build(U8* buffer, S32 data_blocks)
+		{
+			LLTemplateMessageBuilder builder(mNames);
+			builder.newMessage(mTemplate->mName);
+			builder.nextBlock(mInfo);
+			builder.addU32(mID, 0xdeadbeef);
+			builder.addString(mName, "layout");
+			builder.addU16(mPort, 13000);
+			for (S32 i = 0; i < data_blocks; ++i)
+			{
+				builder.nextBlock(mData);
+				builder.addU8(mKind, (U8)(i + 1));
+				builder.addUUID(mKey, mKeys[i]);
+			}
+			builder.nextBlock(mPair);
+			builder.addS32(mValue, -1);
+			builder.nextBlock(mPair);
+			builder.addS32(mValue, 77);
+			return builder.buildMessage(buffer, MAX_BUFFER_SIZE, 0);
+		}
+
+		bool read(LLTemplateMessageReader& reader, const U8* buffer, S32 size)
+		{
+			reader.clearMessage();
+			return reader.validateMessage(buffer, size, LLHost()) && reader.readMessage(buffer, LLHost());
+		}
+
+		LLMessageTemplate* mTemplate;
+		LLTemplateMessageBuilder::message_template_name_map_t mNames;
+		LLTemplateMessageReader::message_template_number_map_t mNumbers;
+		LLUUID mKeys[3];
+		char* mInfo;
+		char* mID;
+		char* mName;
+		char* mPort;
+		char* mData;
+		char* mKind;
+		char* mKey;
+		char* mPair;
+		char* mValue;
+	};
+
+	typedef test_group<LLTemplateMessageReaderFixture> LLTemplateMessageReaderTestGroup;
+	typedef LLTemplateMessageReaderTestGroup::object LLTemplateMessageReaderTestObject;
+	LLTemplateMessageReaderTestGroup templateMessageReaderTestGroup("LLTemplateMessageReader");
+
+	template<> template<>
+	void LLTemplateMessageReaderTestObject::test<1>()
+	{
+		set_test_name("layout lookups and offsets");
+		const LLMessageLayout& layout = mTemplate->getLayout();
+		ensure_equals("blocks", layout.getBlockCount(), 3);
+		S32 info = layout.findBlock(mInfo);
+		S32 data = layout.findBlock(mData);
+		ensure_equals("Info", info, 0);
+		ensure_equals("Data", data, 1);
+		ensure_equals("Pair", layout.findBlock(mPair), 2);
+		ensure_equals("not a block", layout.findBlock(mKind), -1);
+
+		ensure_equals("ID", layout.findVariable(info, mID), 0);
+		ensure_equals("Port", layout.findVariable(info, mPort), 2);
+		ensure_equals("Key", layout.findVariable(data, mKey), 1);
+		ensure_equals("Key is not in Info", layout.findVariable(info, mKey), -1);
+
+		ensure_equals("Info has variable data", layout.getBlock(info).mSize, -1);
+		ensure_equals("Data size", layout.getBlock(data).mSize, 1 + UUID_BYTES);
+		ensure_equals("Key offset", layout.getVariable(layout.getBlock(data), 1).mOffset, 1);
+		ensure_equals("largest fixed field", layout.getMaxFixedSize(), UUID_BYTES);
+	}
+
+	template<> template<>
+	void LLTemplateMessageReaderTestObject::test<2>()
+	{
+		set_test_name("typed accessors");
+		for (S32 i = 0; i < 3; ++i)
+		{
+			mKeys[i].generate();
+		}
+		U8 buffer[MAX_BUFFER_SIZE];
+		S32 size = build(buffer, 3);
+
+		LLTemplateMessageReader reader(mNumbers);
+		ensure("read", read(reader, buffer, size));
+		ensure_equals("message", std::string(reader.getMessageName()), "TestMessage");
+
+		U32 id = 0;
+		reader.getU32(mInfo, mID, id);
+		ensure_equals("ID", id, 0xdeadbeef);
+		std::string str;
+		reader.getString(mInfo, mName, str);
+		ensure_equals("Name", str, "layout");
+		ensure_equals("Name size", reader.getSize(mInfo, mName), 7);
+		U16 port = 0;
+		reader.getU16(mInfo, mPort, port);
+		ensure_equals("Port", port, 13000);
+
+		ensure_equals("Data blocks", reader.getNumberOfBlocks(mData), 3);
+		for (S32 i = 0; i < 3; ++i)
+		{
+			U8 kind = 0;
+			LLUUID key;
+			reader.getU8(mData, mKind, kind, i);
+			reader.getUUID(mData, mKey, key, i);
+			ensure_equals("Kind", kind, i + 1);
+			ensure_equals("Key", key, mKeys[i]);
+		}
+		ensure_equals("past the last Data", reader.getSize(mData, 3, mKey), LL_BLOCK_NOT_IN_MESSAGE);
+		ensure_equals("not in Data", reader.getSize(mData, 0, mPort), LL_VARIABLE_NOT_IN_BLOCK);
+
+		S32 first = 0;
+		S32 second = 0;
+		reader.getS32(mPair, mValue, first, 0);
+		reader.getS32(mPair, mValue, second, 1);
+		ensure_equals("first Pair", first, -1);
+		ensure_equals("second Pair", second, 77);
+	}
+
+	template<> template<>
+	void LLTemplateMessageReaderTestObject::test<3>()
+	{
+		set_test_name("no variable blocks, and a packet cut short");
+		U8 buffer[MAX_BUFFER_SIZE];
+		S32 size = build(buffer, 0);
+
+		LLTemplateMessageReader reader(mNumbers);
+		ensure("read", read(reader, buffer, size));
+		ensure_equals("no Data blocks", reader.getNumberOfBlocks(mData), 0);
+		ensure_equals("no Data", reader.getSize(mData, 0, mKind), LL_BLOCK_NOT_IN_MESSAGE);
+
+		// Lose the second Pair and half of the first: both read as zeros.
+		ensure("read short", read(reader, buffer, size - 6));
+		S32 first = 1;
+		S32 second = 1;
+		reader.getS32(mPair, mValue, first, 0);
+		reader.getS32(mPair, mValue, second, 1);
+		ensure_equals("first Pair", first, 0);
+		ensure_equals("second Pair", second, 0);
+		U32 id = 0;
+		reader.getU32(mInfo, mID, id);
+		ensure_equals("ID", id, 0xdeadbeef);
+	}
+
+	template<> template<>
+	void LLTemplateMessageReaderTestObject::test<4>()
+	{
+		set_test_name("copy to a builder");
+		for (S32 i = 0; i < 3; ++i)
+		{
+			mKeys[i].generate();
+		}
+		U8 buffer[MAX_BUFFER_SIZE];
+		S32 size = build(buffer, 2);
+
+		LLTemplateMessageReader reader(mNumbers);
+		ensure("read", read(reader, buffer, size));
+
+		LLTemplateMessageBuilder builder(mNames);
+		builder.newMessage(mTemplate->mName);
+		reader.copyToBuilder(builder);
+		U8 copy[MAX_BUFFER_SIZE];
+		S32 copy_size = builder.buildMessage(copy, MAX_BUFFER_SIZE, 0);
+		ensure_equals("size", copy_size, size);
+		ensure("same packet", !memcmp(copy + LL_PACKET_ID_SIZE, buffer + LL_PACKET_ID_SIZE, size - LL_PACKET_ID_SIZE));
+	}
+}
@@ -0,0 +1,233 @@
+/**
+ * @file patch_idct_test.cpp
+ * @brief Tests for the vectorised, thread safe terrain patch decompression.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../patch_code.h"
+#include "../patch_dct.h"
+#include "llbitpack.h"
+#include "v3math.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct PatchIDCTFixture
+	{
+		PatchIDCTFixture()
+		:	mSeed(12345)
+		{
+		}
+
+		~PatchIDCTFixture()
+		{
+			set_patch_idct_kernels(get_best_patch_idct_kernels());
+		}
+
+		S32 random(S32 range)
+		{
+			mSeed = mSeed * 1103515245 + 12345;
+			return (S32)((mSeed >> 8) % (U32)range);
+		}
+
+		// Quantized coefficients, mostly in the low frequencies as the
+		// simulator sends them, often with a run of zeros up to the end.
+		void makeCoefficients(S32 *cpatch, S32 size, LLPatchHeader &ph)
+		{
+			S32 wbits = 2 + random(14);
+			S32 end = random(2) ? random(size*size) : size*size;
+			for (S32 i = 0; i < size*size; i++)
+			{
+				S32 limit = llmax((1 << wbits) >> (i / 16), 1);
+				cpatch[i] = (i < end) ? random(2*limit + 1) - limit : 0;
+			}
+			ph.dc_offset = (F32)random(4000) * 0.037f - 20.f;
+			ph.range = (U16)(1 + random(500));
+			ph.quant_wbits = (U8)((random(9) << 4) | (wbits - 2));
+			ph.patchids = 0;
+		}
+
+		// The old path, through the globals.
+		static void decompressReference(F32 *patch, S32 stride, S32 size, S32 *cpatch, LLPatchHeader &ph)
+		{
+			LLGroupHeader gopp;
+			gopp.stride = stride;
+			gopp.patch_size = size;
+			gopp.layer_type = 0;
+			init_patch_decompressor(size);
+			set_group_of_patch_header(&gopp);
+			decompress_patch(patch, cpatch, &ph);
+		}
+
+		static bool sameFloats(const F32 *a, const F32 *b, S32 count)
+		{
+#if LL_WINDOWS
+			// /fp:fast is free to reorder the sums of the old path.
+			for (S32 i = 0; i < count; i++)
+			{
+				if (!is_approx_equal_fraction(a[i], b[i], 16))
+				{
+					return false;
+				}
+			}
+			return true;
+#else
+			// Same values, a zero may differ in sign.
+			for (S32 i = 0; i < count; i++)
+			{
+				if (a[i] != b[i])
+				{
+					return false;
+				}
+			}
+			return true;
+#endif
+		}
+
+		U32 mSeed;
+	};
+
+	typedef test_group<PatchIDCTFixture> PatchIDCTTestGroup;
+	typedef PatchIDCTTestGroup::object PatchIDCTTestObject;
+	PatchIDCTTestGroup patchIDCTTestGroup("PatchIDCT");
+
+	template<> template<>
+	void PatchIDCTTestObject::test<1>()
+	{
+		set_test_name("every kernel set matches decompress_patch()");
+		const S32 sizes[] = { NORMAL_PATCH_SIZE, LARGE_PATCH_SIZE };
+		for (S32 size : sizes)
+		{
+			// A stride wider than the patch, as in LLSurface.
+			const S32 stride = size * 4 + 1;
+			std::vector<F32> expected(stride * size);
+			std::vector<F32> actual(stride * size);
+			S32 cpatch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+			for (S32 patch = 0; patch < 200; patch++)
+			{
+				LLPatchHeader ph;
+				makeCoefficients(cpatch, size, ph);
+				decompressReference(&expected[0], stride, size, cpatch, ph);
+				for (S32 kernels = PATCH_IDCT_SCALAR; kernels <= get_best_patch_idct_kernels(); kernels++)
+				{
+					set_patch_idct_kernels((EPatchIDCTKernels)kernels);
+					std::fill(actual.begin(), actual.end(), 0.f);
+					ensure("size accepted", decompress_patch_block(&actual[0], stride, size, cpatch, &ph));
+					for (S32 j = 0; j < size; j++)
+					{
+						ensure(llformat("size %d patch %d row %d, %s kernels", size, patch, j,
+										get_patch_idct_kernels_name((EPatchIDCTKernels)kernels)),
+							   sameFloats(&expected[j * stride], &actual[j * stride], size));
+					}
+				}
+			}
+		}
+
+		F32 patch[NORMAL_PATCH_SIZE*NORMAL_PATCH_SIZE];
+		S32 cpatch[NORMAL_PATCH_SIZE*NORMAL_PATCH_SIZE] = { 0 };
+		LLPatchHeader ph = { 0.f, 1, 0, 0 };
+		ensure("odd patch size refused", !decompress_patch_block(patch, NORMAL_PATCH_SIZE, 24, cpatch, &ph));
+	}
+
+	template<> template<>
+	void PatchIDCTTestObject::test<2>()
+	{
+		set_test_name("unpack_patch() reads what code_patch() wrote");
+		const S32 size = NORMAL_PATCH_SIZE;
+		const S32 patches = 12;
+
+		// A LayerData packet as the simulator codes it.
+		U8 buffer[32768];
+		LLBitPack coder(buffer, sizeof(buffer));
+		LLGroupHeader gopp;
+		gopp.stride = size;
+		gopp.patch_size = size;
+		gopp.layer_type = 'L';
+		code_patch_group_header(coder, &gopp);
+		std::vector<S32> coded(patches * size * size);
+		for (S32 patch = 0; patch < patches; patch++)
+		{
+			S32 *cpatch = &coded[patch * size * size];
+			LLPatchHeader ph;
+			makeCoefficients(cpatch, size, ph);
+			ph.patchids = patch;
+			code_patch_header(coder, &ph, cpatch);
+			code_patch(coder, cpatch, 0);
+		}
+		code_end_of_data(coder);
+		S32 length = coder.flushBitPack();
+
+		// Twice, through the globals and without them.
+		for (S32 pass = 0; pass < 2; pass++)
+		{
+			LLBitPack decoder(buffer, length);
+			LLGroupHeader decoded_gopp;
+			if (pass)
+			{
+				unpack_patch_group_header(decoder, &decoded_gopp);
+			}
+			else
+			{
+				decode_patch_group_header(decoder, &decoded_gopp);
+			}
+			ensure_equals("patch size", (S32)decoded_gopp.patch_size, size);
+
+			S32 count = 0;
+			while (true)
+			{
+				LLPatchHeader ph;
+				if (pass)
+				{
+					unpack_patch_header(decoder, &ph, FALSE);
+				}
+				else
+				{
+					decode_patch_header(decoder, &ph, FALSE);
+				}
+				if (END_OF_PATCHES == ph.quant_wbits)
+				{
+					break;
+				}
+				ensure_equals("patch ids", (S32)ph.patchids, count);
+
+				S32 decoded[size*size];
+				if (pass)
+				{
+					unpack_patch(decoder, decoded, size, (ph.quant_wbits & 0xf) + 2);
+				}
+				else
+				{
+					decode_patch(decoder, decoded);
+				}
+				ensure(llformat("coefficients of patch %d, pass %d", count, pass),
+					   !memcmp(decoded, &coded[count * size * size], sizeof(decoded)));
+				count++;
+			}
+			ensure_equals("all patches", count, patches);
+		}
+	}
+}
@@ -0,0 +1,375 @@
+/**
+ * @file mesh_decode_bench.cpp
+ * @brief Mesh LODs decoded per second and per core through LLMeshDecodePipeline.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "linden_common.h"
+
+#include "lldiriterator.h"
+#include "llfile.h"
+#include "llmeshdecodepipeline.h"
+#include "lloctree.h"
+#include "llsdserialize.h"
+#include "lltimer.h"
+#include "../tests/testmesh.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tmesh_decode_bench [options]\n"
+		"\n"
+		"Feeds the LOD blocks of mesh assets through LLMeshDecodePipeline with\n"
+		"one thread and up to the given number of threads, and reports the\n"
+		"meshes decoded per second overall and per core.  Without a directory\n"
+		"of assets synthetic meshes are decoded.  Then loads the meshes cold,\n"
+		"decoding them into an LLMeshLODCache, and warm, from that cache.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -d <dir>        Directory of raw mesh assets, as the mesh repository\n"
+		"                 downloads them.\n"
+		" -n <count>      Synthetic meshes.  Default:  500\n"
+		" -t <threads>    Largest pool.  Default:  the number of cores\n"
+		" -o              Build the face octrees as well.\n"
+		" -r <count>      Times the LODs are decoded.  Default:  3\n"
+		" -c <dir>        Directory for the decoded LOD cache, emptied of the\n"
+		"                 files the benchmark writes.  Default:  the temp dir\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+struct LODBlock
+{
+	LLVolumeParams mParams;
+	S32 mLOD;
+	std::vector<U8> mData;
+};
+
+typedef std::vector<LODBlock> block_list_t;
+
+static const char* LOD_NAMES[] = { "lowest_lod", "low_lod", "medium_lod", "high_lod" };
+
+static LLVolumeParams mesh_params(const LLUUID& id)
+{
+	LLVolumeParams params;
+	params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+	params.setSculptID(id, LL_SCULPT_TYPE_MESH);
+	return params;
+}
+
+// Splits a mesh asset into its LOD blocks the way LLMeshRepoThread does
+static bool load_asset(const std::string& filename, block_list_t& blocks)
+{
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	if (!in.is_open())
+	{
+		return false;
+	}
+	std::ostringstream ostr;
+	ostr << in.rdbuf();
+	std::string data = ostr.str();
+	if (data.empty())
+	{
+		return false;
+	}
+
+	U32 size = (U32)data.size();
+	U32 header_size = 0;
+	char* start = strip_deprecated_header(&data[0], size, &header_size);
+
+	LLSD header;
+	size_t header_bytes = 0;
+	LLPointer<LLSDBinaryParser> parser = new LLSDBinaryParser;
+	if (parser->parseBuffer((const U8*)start, size, header, size, -1, &header_bytes) <= 0 || !header.isMap())
+	{
+		return false;
+	}
+	header_size += (U32)header_bytes;
+
+	LLUUID id;
+	id.generate(filename);
+	bool found = false;
+	for (S32 lod = 0; lod < 4; ++lod)
+	{
+		const LLSD& entry = header[LOD_NAMES[lod]];
+		S32 offset = header_size + entry["offset"].asInteger();
+		S32 length = entry["size"].asInteger();
+		if (length <= 0 || offset + length > (S32)data.size())
+		{
+			continue;
+		}
+		LODBlock block;
+		block.mParams = mesh_params(id);
+		block.mLOD = lod;
+		block.mData.assign(data.begin() + offset, data.begin() + offset + length);
+		blocks.push_back(block);
+		found = true;
+	}
+	return found;
+}
+
+struct PassStats
+{
+	PassStats() : mSeconds(0.0), mFailed(0), mHits(0), mSecondsSaved(0.0) {}
+	F64 mSeconds;
+	S32 mFailed;
+	S32 mHits;
+	F64 mSecondsSaved;
+};
+
+// Posts every block once from the given source and waits for the results
+static PassStats load_pass(LLMeshDecodePipeline& pipeline, const block_list_t& blocks, LLMeshDecodePipeline::ESource source)
+{
+	PassStats stats;
+	F64 start = LLTimer::getTotalSeconds();
+	for (const LODBlock& block : blocks)
+	{
+		LLMeshDecodePipeline::Request request;
+		request.mMeshParams = block.mParams;
+		request.mLOD = block.mLOD;
+		request.mSourceSize = (U32)block.mData.size();
+		request.mSource = source;
+		if (source != LLMeshDecodePipeline::SOURCE_LOD_CACHE)
+		{
+			request.mData = block.mData;
+		}
+		pipeline.post(request);
+	}
+	std::vector<LLMeshDecodePipeline::Result> results;
+	while (pipeline.getPendingCount() > 0)
+	{
+		results.clear();
+		if (!pipeline.popResults(results))
+		{
+			std::this_thread::yield();
+		}
+		for (const LLMeshDecodePipeline::Result& result : results)
+		{
+			stats.mFailed += result.mVolume.isNull() ? 1 : 0;
+			if (result.mVolume.notNull() && result.mSource == LLMeshDecodePipeline::SOURCE_LOD_CACHE)
+			{
+				++stats.mHits;
+				stats.mSecondsSaved += result.mSecondsSaved;
+			}
+		}
+	}
+	stats.mSeconds = LLTimer::getTotalSeconds() - start;
+	return stats;
+}
+
+// Four LODs per mesh, a face or a few with rings scaled like LOD switches do
+static void make_meshes(S32 count, block_list_t& blocks)
+{
+	for (S32 i = 0; i < count; ++i)
+	{
+		LLUUID id;
+		id.generate(llformat("mesh_decode_bench %d", i));
+		const S32 faces = 1 + i % 4;
+		for (S32 lod = 0; lod < 4; ++lod)
+		{
+			LODBlock block;
+			block.mParams = mesh_params(id);
+			block.mLOD = lod;
+			block.mData = make_mesh_lod(faces, 6 << lod);
+			blocks.push_back(block);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string directory;
+	std::string cache_dir = llformat("%s/mesh_lod_cache_bench", LLFile::tmpdir());
+	S32 count = 500;
+	S32 max_threads = llclamp((S32)std::thread::hardware_concurrency(), 1, 32);
+	bool octrees = false;
+	S32 repeat = 3;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if ("-d" == arg && i + 1 < argc)
+		{
+			directory = argv[++i];
+		}
+		else if ("-n" == arg && i + 1 < argc)
+		{
+			count = llmax(atoi(argv[++i]), 1);
+		}
+		else if ("-t" == arg && i + 1 < argc)
+		{
+			max_threads = llmax(atoi(argv[++i]), 1);
+		}
+		else if ("-o" == arg)
+		{
+			octrees = true;
+		}
+		else if ("-r" == arg && i + 1 < argc)
+		{
+			repeat = llmax(atoi(argv[++i]), 1);
+		}
+		else if ("-c" == arg && i + 1 < argc)
+		{
+			cache_dir = argv[++i];
+		}
+		else
+		{
+			usage("-h" == arg ? std::cout : std::cerr);
+			return "-h" == arg ? 0 : 1;
+		}
+	}
+
+	// What the viewer partitions with, see OctreeMaxNodeCapacity
+	gOctreeMaxCapacity = 128;
+	gOctreeMinSize = 0.01f;
+
+	block_list_t blocks;
+	S32 meshes = 0;
+	if (!directory.empty())
+	{
+		LLDirIterator iter(directory, "*");
+		std::string name;
+		while (iter.next(name))
+		{
+			meshes += load_asset(directory + "/" + name, blocks) ? 1 : 0;
+		}
+		if (blocks.empty())
+		{
+			std::cerr << "No mesh assets in " << directory << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		make_meshes(count, blocks);
+		meshes = count;
+	}
+
+	size_t bytes = 0;
+	for (const LODBlock& block : blocks)
+	{
+		bytes += block.mData.size();
+	}
+	fprintf(stdout, "%s: %d meshes, %d LODs, %.1f MB zipped, %d repeats%s\n",
+			directory.empty() ? "synthetic meshes" : directory.c_str(), meshes, (S32)blocks.size(),
+			bytes / (1024.0 * 1024.0), repeat, octrees ? ", octrees" : "");
+
+	F64 single_rate = 0.0;
+	for (S32 threads = 1; threads <= max_threads; threads = (threads < 4 ? threads + 1 : threads * 2))
+	{
+		// Pools register a listener under their name, give each its own.
+		LLMeshDecodePipeline pipeline(llformat("MeshDecodeBench%d", threads), threads, octrees);
+		pipeline.start();
+
+		std::vector<LLMeshDecodePipeline::Result> results;
+		S32 failed = 0;
+		F64 decode_seconds = 0.0;
+		F64 start = LLTimer::getTotalSeconds();
+		for (S32 r = 0; r < repeat; ++r)
+		{
+			for (const LODBlock& block : blocks)
+			{
+				LLMeshDecodePipeline::Request request;
+				request.mMeshParams = block.mParams;
+				request.mLOD = block.mLOD;
+				request.mData = block.mData;
+				pipeline.post(request);
+			}
+		}
+		while (pipeline.getPendingCount() > 0)
+		{
+			results.clear();
+			if (!pipeline.popResults(results))
+			{
+				std::this_thread::yield();
+			}
+			for (const LLMeshDecodePipeline::Result& result : results)
+			{
+				failed += result.mVolume.isNull() ? 1 : 0;
+				decode_seconds += result.mDecodeSeconds;
+			}
+		}
+		F64 seconds = LLTimer::getTotalSeconds() - start;
+		pipeline.close();
+
+		// A mesh is all of its LODs
+		F64 rate = (F64)meshes * repeat / llmax(seconds, 1e-6);
+		if (threads == 1)
+		{
+			single_rate = rate;
+		}
+		fprintf(stdout, "%2d threads %10.0f meshes/s %10.0f per core  %5.2fx  %6.3f ms per LOD%s\n",
+				threads, rate, rate / threads, rate / single_rate,
+				decode_seconds * 1000.0 / llmax((S32)blocks.size() * repeat, 1),
+				failed ? llformat("  %d FAILED", failed).c_str() : "");
+	}
+
+	// Cold and warm loads through the decoded LOD cache, on all threads
+	LLFile::mkdir(cache_dir);
+	auto cache_path = [cache_dir](const LLUUID& mesh_id, S32 lod)
+	{
+		return llformat("%s/%s_lod%d.mlod", cache_dir.c_str(), mesh_id.asString().c_str(), lod);
+	};
+	for (const LODBlock& block : blocks)
+	{
+		LLFile::remove(cache_path(block.mParams.getSculptID(), block.mLOD), ENOENT);
+	}
+
+	LLMeshDecodePipeline pipeline("MeshDecodeBenchCache", max_threads, octrees);
+	pipeline.setLODCache(new LLMeshLODCache(cache_path));
+	pipeline.start();
+	PassStats cold = load_pass(pipeline, blocks, LLMeshDecodePipeline::SOURCE_NETWORK);
+	PassStats warm = load_pass(pipeline, blocks, LLMeshDecodePipeline::SOURCE_LOD_CACHE);
+	pipeline.close();
+
+	size_t cache_bytes = 0;
+	for (const LODBlock& block : blocks)
+	{
+		const std::string path = cache_path(block.mParams.getSculptID(), block.mLOD);
+		llstat stat_data;
+		if (!LLFile::stat(path, &stat_data))
+		{
+			cache_bytes += stat_data.st_size;
+		}
+		LLFile::remove(path, ENOENT);
+	}
+
+	F64 cold_rate = (F64)meshes / llmax(cold.mSeconds, 1e-6);
+	F64 warm_rate = (F64)meshes / llmax(warm.mSeconds, 1e-6);
+	fprintf(stdout, "\nLOD cache, %d threads, %.1f MB on disk\n", max_threads, cache_bytes / (1024.0 * 1024.0));
+	fprintf(stdout, "  cold %10.0f meshes/s  decode and store%s\n", cold_rate,
+			cold.mFailed ? llformat("  %d FAILED", cold.mFailed).c_str() : "");
+	fprintf(stdout, "  warm %10.0f meshes/s  %5.2fx  %d/%d hits  %.3f s decode saved%s\n",
+			warm_rate, warm_rate / llmax(cold_rate, 1e-6), warm.mHits, (S32)blocks.size(), warm.mSecondsSaved,
+			warm.mFailed ? llformat("  %d FAILED", warm.mFailed).c_str() : "");
+	return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file llmeshdecodepipeline.cpp
+ * @brief Worker threads turning zipped mesh LOD blocks into ready LLVolume faces.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmeshdecodepipeline.h"
+#include "llevents.h"
+#include "lltimer.h"
+#include "llvolumemgr.h"
+
+LLMeshDecodePipeline::LLMeshDecodePipeline(const std::string& name, S32 threads, bool build_octrees,
+										   const decoded_callback_t& callback)
+	// Posting never blocks in practice, the queue holds more than the
+	// repository ever has in flight.
+:	mPool(name, llmax(threads, 1), 1024 * 1024),
+	mThreadCount(llmax(threads, 1)),
+	mBuildOctrees(build_octrees),
+	mCallback(callback),
+	mPending(0)
+{
+}
+
+LLMeshDecodePipeline::~LLMeshDecodePipeline()
+{
+	close();
+
+	Completed completed;
+	while (mCompleted.try_dequeue(completed))
+	{
+		if (completed.mVolume)
+		{
+			completed.mVolume->unref();
+		}
+	}
+}
+
+void LLMeshDecodePipeline::setLODCache(LLMeshLODCache* cache)
+{
+	mLODCache.reset(cache);
+}
+
+void LLMeshDecodePipeline::start()
+{
+	mPool.start();
+}
+
+void LLMeshDecodePipeline::close()
+{
+	mPool.close();
+	// The pool listens for application shutdown under its name; it is going
+	// away before the application does.
+	if (LLEventPumps::instanceExists())
+	{
+		LLEventPumps::instance().obtain("LLApp").stopListening(mPool.getName());
+	}
+}
+
+bool LLMeshDecodePipeline::isOpen()
+{
+	return !mPool.getQueue().isClosed();
+}
+
+bool LLMeshDecodePipeline::post(Request& request)
+{
+	std::shared_ptr<Request> job = std::make_shared<Request>();
+	job->mMeshParams = request.mMeshParams;
+	job->mLOD = request.mLOD;
+	job->mOffset = request.mOffset;
+	job->mSourceSize = request.mSourceSize;
+	job->mSource = request.mSource;
+	job->mData.swap(request.mData);
+
+	++mPending;
+	if (!mPool.getQueue().postIfOpen([this, job]() { process(*job); }))
+	{
+		--mPending;
+		request.mData.swap(job->mData);
+		return false;
+	}
+	return true;
+}
+
+size_t LLMeshDecodePipeline::popResults(std::vector<Result>& results, size_t max_count)
+{
+	size_t count = 0;
+	Completed completed;
+	while (count < max_count && mCompleted.try_dequeue(completed))
+	{
+		Result result;
+		result.mMeshParams = completed.mMeshParams;
+		result.mLOD = completed.mLOD;
+		result.mVolume = completed.mVolume;
+		result.mSource = completed.mSource;
+		result.mDecodeSeconds = completed.mDecodeSeconds;
+		result.mSecondsSaved = completed.mSecondsSaved;
+		if (completed.mVolume)
+		{
+			completed.mVolume->unref(); // now held by result.mVolume
+		}
+		results.push_back(result);
+		--mPending;
+		++count;
+	}
+	return count;
+}
+
+//static
+LLPointer<LLVolume> LLMeshDecodePipeline::decode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size,
+												 bool build_octrees)
+{
+	if (!data || data_size <= 0)
+	{
+		return NULL;
+	}
+
+	// unpackVolumeFaces() inflates, parses and runs cacheOptimize()
+	LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
+	if (!volume->unpackVolumeFaces(data, data_size) || volume->getNumFaces() <= 0)
+	{
+		return NULL;
+	}
+
+	if (build_octrees)
+	{
+		buildOctrees(volume);
+	}
+	return volume;
+}
+
+//static
+void LLMeshDecodePipeline::buildOctrees(LLVolume* volume)
+{
+	for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+	{
+		LLVolumeFace& face = volume->getVolumeFace(i);
+		if (face.mNumIndices >= 3 && !face.getOctree())
+		{
+			face.createOctree();
+		}
+	}
+}
+
+// Runs on the workers
+void LLMeshDecodePipeline::process(Request& request)
+{
+	LLTimer timer;
+	LLPointer<LLVolume> volume;
+	F32 seconds_saved = 0.f;
+	if (request.mSource == SOURCE_LOD_CACHE)
+	{
+		F32 decode_seconds = 0.f;
+		if (mLODCache)
+		{
+			volume = mLODCache->load(request.mMeshParams, request.mLOD, request.mSourceSize, &decode_seconds);
+			if (volume.isNull())
+			{
+				// Stale or damaged, the LOD gets decoded and stored again
+				mLODCache->remove(request.mMeshParams.getSculptID(), request.mLOD);
+			}
+		}
+		seconds_saved = llmax(decode_seconds - timer.getElapsedTimeF32().value(), 0.f);
+	}
+	else
+	{
+		volume = decode(request.mMeshParams, request.mLOD,
+						request.mData.empty() ? NULL : &request.mData[0], (S32)request.mData.size(), false);
+		if (volume.notNull() && mLODCache)
+		{
+			mLODCache->store(request.mMeshParams, request.mLOD, (U32)request.mData.size(),
+							 timer.getElapsedTimeF32(), volume);
+		}
+	}
+	if (volume.notNull() && mBuildOctrees)
+	{
+		buildOctrees(volume);
+	}
+	F32 seconds = timer.getElapsedTimeF32();
+
+	if (mCallback && !mCallback(request, volume.get()))
+	{
+		--mPending;
+		return;
+	}
+
+	Completed completed;
+	completed.mMeshParams = request.mMeshParams;
+	completed.mLOD = request.mLOD;
+	completed.mVolume = volume.get();
+	completed.mSource = request.mSource;
+	completed.mDecodeSeconds = seconds;
+	completed.mSecondsSaved = seconds_saved;
+	if (completed.mVolume)
+	{
+		completed.mVolume->ref(); // handed over with the queue entry
+	}
+	volume = NULL;
+	mCompleted.enqueue(completed);
+}
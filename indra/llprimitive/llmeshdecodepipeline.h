@@ -0,0 +1,169 @@
+/**
+ * @file llmeshdecodepipeline.h
+ * @brief Worker threads turning zipped mesh LOD blocks into ready LLVolume faces.
+ *
+ * @Description:
+ * Mesh LOD blocks are zlib compressed LLSD. Turning one into something the
+ * renderer can use means inflating it, parsing the LLSD, building the
+ * LLVolumeFaces out of the quantised streams, running the vertex cache
+ * optimiser over them and, optionally, building the per face octrees used
+ * for picking. LLMeshDecodePipeline runs all of that on its own thread pool
+ * so that neither the mesh repository thread nor the main thread has to.
+ *
+ * Finished volumes are handed back through a lock free queue which the
+ * consumer (the main thread in the viewer) drains whenever it likes, so
+ * workers never wait on the consumer and the consumer never waits on a
+ * worker.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESHDECODEPIPELINE_H
+#define LL_LLMESHDECODEPIPELINE_H
+
+#include "concurrentqueue.h"
+#include "llmeshlodcache.h"
+#include "llpointer.h"
+#include "llvolume.h"
+#include "threadpool.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class LLMeshDecodePipeline
+{
+	LOG_CLASS(LLMeshDecodePipeline);
+public:
+	enum ESource
+	{
+		SOURCE_NETWORK,		// downloaded
+		SOURCE_ASSET_CACHE,	// read from the local copy of the asset
+		SOURCE_LOD_CACHE	// decoded earlier, see LLMeshLODCache
+	};
+
+	struct Request
+	{
+		Request() : mLOD(0), mOffset(0), mSourceSize(0), mSource(SOURCE_NETWORK) {}
+
+		LLVolumeParams mMeshParams;
+		S32 mLOD;
+		std::vector<U8> mData;	// the zipped LOD block, none for SOURCE_LOD_CACHE
+		S32 mOffset;			// of the block within the mesh asset
+		U32 mSourceSize;		// of the block, for SOURCE_LOD_CACHE
+		ESource mSource;
+	};
+
+	struct Result
+	{
+		LLVolumeParams mMeshParams;
+		S32 mLOD;
+		LLPointer<LLVolume> mVolume; // NULL if the block did not decode
+		ESource mSource;
+		F32 mDecodeSeconds;
+		F32 mSecondsSaved;		// by a SOURCE_LOD_CACHE hit over decoding the block
+	};
+
+	/**
+	 * Called on the worker once a request has been decoded, volume being NULL
+	 * if it failed. Returning false drops the result instead of queueing it
+	 * for popResults(), for instance because the request was retried.
+	 */
+	typedef std::function<bool(const Request& request, const LLVolume* volume)> decoded_callback_t;
+
+	/**
+	 * name is the name of the thread pool, threads its width.
+	 */
+	LLMeshDecodePipeline(const std::string& name, S32 threads, bool build_octrees,
+						 const decoded_callback_t& callback = decoded_callback_t());
+	~LLMeshDecodePipeline();
+
+	/**
+	 * Takes ownership of cache. Blocks decoded from zipped data are stored
+	 * there and SOURCE_LOD_CACHE requests are served from it. Call before
+	 * start().
+	 */
+	void setLODCache(LLMeshLODCache* cache);
+	LLMeshLODCache* getLODCache() const { return mLODCache.get(); }
+
+	void start();
+
+	/**
+	 * Stops accepting requests and joins the workers. Requests still queued
+	 * are not decoded.
+	 */
+	void close();
+
+	bool isOpen();
+	S32 getWidth() const { return mThreadCount; }
+
+	/**
+	 * Threads: any. Queues request for decoding, taking its data. Returns
+	 * false, leaving request untouched, if the pipeline is closed.
+	 */
+	bool post(Request& request);
+
+	/**
+	 * Threads: one consumer at a time. Moves up to max_count finished
+	 * results into results and returns how many were added.
+	 */
+	size_t popResults(std::vector<Result>& results, size_t max_count = 256);
+
+	/**
+	 * Requests posted and not yet popped.
+	 */
+	S32 getPendingCount() const { return mPending; }
+
+	/**
+	 * Decodes one LOD block on the calling thread, including the vertex cache
+	 * optimisation and, if asked for, the face octrees. Returns NULL on failure.
+	 */
+	static LLPointer<LLVolume> decode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size,
+									 bool build_octrees);
+	static void buildOctrees(LLVolume* volume);
+
+private:
+	void process(Request& request);
+
+	// What crosses the queue. The volume carries one reference which the
+	// consumer takes over, as LLPointer copies are not thread safe.
+	struct Completed
+	{
+		LLVolumeParams mMeshParams;
+		S32 mLOD;
+		LLVolume* mVolume;
+		ESource mSource;
+		F32 mDecodeSeconds;
+		F32 mSecondsSaved;
+	};
+
+	LL::ThreadPool mPool;
+	S32 mThreadCount;
+	bool mBuildOctrees;
+	decoded_callback_t mCallback;
+	std::unique_ptr<LLMeshLODCache> mLODCache;
+	moodycamel::ConcurrentQueue<Completed> mCompleted;
+	std::atomic<S32> mPending;
+};
+
+#endif // LL_LLMESHDECODEPIPELINE_H
@@ -0,0 +1,448 @@
+/**
+ * @file llmeshlodcache.cpp
+ * @brief Disk cache of decoded mesh LODs.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmeshlodcache.h"
+#include "hbxxh.h"
+#include "llfile.h"
+#include "llmappedfile.h"
+#include "llvolumemgr.h"
+
+#include <thread>
+
+namespace
+{
+	// "MLOD" read as a little endian U32, so files of the other byte order
+	// are misses too
+	const U32 LOD_CACHE_MAGIC = 0x444f4c4d;
+
+	enum
+	{
+		FACE_HAS_WEIGHTS = 0x1
+	};
+
+	// A stream is quantised over [mMin, mMin + mRange] per component. A
+	// constant component has a range of 0 and comes back exactly.
+	struct StreamDomain
+	{
+		F32 mMin[4];
+		F32 mRange[4];
+	};
+
+	struct FileHeader
+	{
+		U32 mMagic;
+		U32 mVersion;
+		U64 mChecksum;		// of everything after the header
+		U32 mSourceSize;	// of the zipped LOD block this was decoded from
+		U32 mSculptType;	// mirror and invert flags change the faces
+		S32 mLOD;
+		U32 mFaceCount;
+		F32 mDecodeSeconds;	// what decoding the block took
+		U32 mPad[3];
+	};
+
+	struct FaceHeader
+	{
+		U32 mNumVertices;
+		U32 mNumIndices;
+		U32 mFlags;
+		U32 mPad;
+		F32 mExtents[8];
+		F32 mTexCoordExtents[4];
+		StreamDomain mPositionDomain;
+		StreamDomain mNormalDomain;
+		StreamDomain mTexCoordDomain;
+		// From the start of the file
+		U32 mPositionOffset;	// U16 x 3 per vertex
+		U32 mNormalOffset;		// U16 x 3 per vertex
+		U32 mTexCoordOffset;	// U16 x 2 per vertex
+		U32 mWeightOffset;		// U8 joint x 4, then U16 weight x 4 per vertex
+		U32 mIndexOffset;		// U16 per index
+		U32 mEndOffset;
+	};
+
+	static_assert(sizeof(FileHeader) % 4 == 0 && sizeof(FaceHeader) % 4 == 0, "headers keep the streams aligned");
+
+	const F32 QUANTA = 65535.f;
+
+	// Finds the domain of count vectors of components floats, stride floats apart
+	void find_domain(const F32* src, S32 count, S32 components, S32 stride, StreamDomain& domain)
+	{
+		for (S32 c = 0; c < 4; ++c)
+		{
+			domain.mMin[c] = 0.f;
+			domain.mRange[c] = 0.f;
+		}
+		if (count <= 0)
+		{
+			return;
+		}
+		F32 max[4];
+		for (S32 c = 0; c < components; ++c)
+		{
+			domain.mMin[c] = max[c] = src[c];
+		}
+		for (S32 i = 1; i < count; ++i)
+		{
+			const F32* v = src + i * stride;
+			for (S32 c = 0; c < components; ++c)
+			{
+				domain.mMin[c] = llmin(domain.mMin[c], v[c]);
+				max[c] = llmax(max[c], v[c]);
+			}
+		}
+		for (S32 c = 0; c < components; ++c)
+		{
+			domain.mRange[c] = max[c] - domain.mMin[c];
+		}
+	}
+
+	void quantise(const F32* src, S32 count, S32 components, S32 stride, const StreamDomain& domain, U16* dst)
+	{
+		F32 scale[4];
+		for (S32 c = 0; c < components; ++c)
+		{
+			scale[c] = domain.mRange[c] > 0.f ? QUANTA / domain.mRange[c] : 0.f;
+		}
+		for (S32 i = 0; i < count; ++i)
+		{
+			const F32* v = src + i * stride;
+			for (S32 c = 0; c < components; ++c)
+			{
+				*dst++ = (U16)llclamp((v[c] - domain.mMin[c]) * scale[c] + 0.5f, 0.f, QUANTA);
+			}
+		}
+	}
+
+	// Same maths as LLVolume::unpackVolumeFacesInternal()
+	void dequantise3(const U16* src, S32 count, const StreamDomain& domain, LLVector4a* dst)
+	{
+		LLVector4a min;
+		LLVector4a range;
+		min.load3(domain.mMin);
+		range.load3(domain.mRange);
+		for (S32 i = 0; i < count; ++i)
+		{
+			dst->set((F32)src[0], (F32)src[1], (F32)src[2]);
+			dst->div(QUANTA);
+			dst->mul(range);
+			dst->add(min);
+			dst++;
+			src += 3;
+		}
+	}
+
+	size_t align4(size_t offset)
+	{
+		return (offset + 3) & ~(size_t)3;
+	}
+
+	bool in_bounds(U32 offset, size_t length, size_t size)
+	{
+		return offset <= size && length <= size - offset;
+	}
+}
+
+LLMeshLODCache::LLMeshLODCache(const path_func_t& path_func)
+:	mPathFunc(path_func)
+{
+}
+
+bool LLMeshLODCache::exists(const LLUUID& mesh_id, S32 lod) const
+{
+	return LLFile::isfile(mPathFunc(mesh_id, lod));
+}
+
+LLPointer<LLVolume> LLMeshLODCache::load(const LLVolumeParams& mesh_params, S32 lod, U32 source_size,
+										 F32* decode_seconds) const
+{
+	LLMappedFile file;
+	if (!file.open(mPathFunc(mesh_params.getSculptID(), lod), 0, false))
+	{
+		return NULL;
+	}
+
+	LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
+	if (!unpack(file.getData(), file.getSize(), mesh_params, lod, source_size, volume, decode_seconds))
+	{
+		return NULL;
+	}
+	return volume;
+}
+
+bool LLMeshLODCache::store(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, F32 decode_seconds,
+						   const LLVolume* volume) const
+{
+	std::vector<U8> data;
+	if (!pack(mesh_params, lod, source_size, decode_seconds, volume, data))
+	{
+		return false;
+	}
+
+	// Written aside and renamed into place, so a reader never maps half a file
+	const std::string filename = mPathFunc(mesh_params.getSculptID(), lod);
+	const std::string temp_name = llformat("%s.%x.tmp", filename.c_str(),
+										   (U32)std::hash<std::thread::id>()(std::this_thread::get_id()));
+	LLFILE* fp = LLFile::fopen(temp_name, "wb");
+	if (!fp)
+	{
+		return false;
+	}
+	bool written = fwrite(&data[0], 1, data.size(), fp) == data.size();
+	LLFile::close(fp);
+
+	if (written)
+	{
+		LLFile::remove(filename, ENOENT);
+		written = LLFile::rename(temp_name, filename) == 0;
+	}
+	if (!written)
+	{
+		LLFile::remove(temp_name, ENOENT);
+	}
+	return written;
+}
+
+void LLMeshLODCache::remove(const LLUUID& mesh_id, S32 lod) const
+{
+	LLFile::remove(mPathFunc(mesh_id, lod), ENOENT);
+}
+
+//static
+bool LLMeshLODCache::pack(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, F32 decode_seconds,
+						  const LLVolume* volume, std::vector<U8>& out)
+{
+	const S32 face_count = volume ? volume->getNumVolumeFaces() : 0;
+	if (face_count <= 0)
+	{
+		return false;
+	}
+
+	// Lay the file out first
+	std::vector<FaceHeader> faces(face_count);
+	size_t offset = sizeof(FileHeader) + face_count * sizeof(FaceHeader);
+	for (S32 i = 0; i < face_count; ++i)
+	{
+		const LLVolumeFace& face = volume->getVolumeFace(i);
+		FaceHeader& header = faces[i];
+		memset(&header, 0, sizeof(FaceHeader));
+		const size_t vertices = face.mNumVertices;
+		header.mNumVertices = face.mNumVertices;
+		header.mNumIndices = face.mNumIndices;
+		header.mFlags = (face.mWeights && vertices) ? FACE_HAS_WEIGHTS : 0;
+		memcpy(header.mExtents, face.mExtents[0].getF32ptr(), 4 * sizeof(F32));
+		memcpy(header.mExtents + 4, face.mExtents[1].getF32ptr(), 4 * sizeof(F32));
+		memcpy(header.mTexCoordExtents, face.mTexCoordExtents, sizeof(header.mTexCoordExtents));
+
+		header.mPositionOffset = (U32)offset;
+		offset = align4(offset + vertices * 3 * sizeof(U16));
+		header.mNormalOffset = (U32)offset;
+		offset = align4(offset + vertices * 3 * sizeof(U16));
+		header.mTexCoordOffset = (U32)offset;
+		offset = align4(offset + vertices * 2 * sizeof(U16));
+		header.mWeightOffset = (U32)offset;
+		if (header.mFlags & FACE_HAS_WEIGHTS)
+		{
+			offset = align4(offset + vertices * 4 * (sizeof(U8) + sizeof(U16)));
+		}
+		header.mIndexOffset = (U32)offset;
+		offset = align4(offset + face.mNumIndices * sizeof(U16));
+		header.mEndOffset = (U32)offset;
+	}
+	if (offset > U32_MAX)
+	{
+		return false;
+	}
+
+	out.assign(offset, 0);
+	for (S32 i = 0; i < face_count; ++i)
+	{
+		const LLVolumeFace& face = volume->getVolumeFace(i);
+		FaceHeader& header = faces[i];
+		const S32 vertices = face.mNumVertices;
+		if (vertices > 0)
+		{
+			find_domain(face.mPositions[0].getF32ptr(), vertices, 3, 4, header.mPositionDomain);
+			quantise(face.mPositions[0].getF32ptr(), vertices, 3, 4, header.mPositionDomain,
+					 (U16*)&out[header.mPositionOffset]);
+			find_domain(face.mNormals[0].getF32ptr(), vertices, 3, 4, header.mNormalDomain);
+			quantise(face.mNormals[0].getF32ptr(), vertices, 3, 4, header.mNormalDomain,
+					 (U16*)&out[header.mNormalOffset]);
+			find_domain(face.mTexCoords[0].mV, vertices, 2, 2, header.mTexCoordDomain);
+			quantise(face.mTexCoords[0].mV, vertices, 2, 2, header.mTexCoordDomain,
+					 (U16*)&out[header.mTexCoordOffset]);
+		}
+		if (header.mFlags & FACE_HAS_WEIGHTS)
+		{
+			// Each weight is a joint index plus the influence of that joint
+			U8* joints = &out[header.mWeightOffset];
+			U16* influences = (U16*)(joints + vertices * 4);
+			for (S32 v = 0; v < vertices; ++v)
+			{
+				const F32* weights = face.mWeights[v].getF32ptr();
+				for (S32 c = 0; c < 4; ++c)
+				{
+					S32 joint = llclamp((S32)weights[c], 0, 255);
+					*joints++ = (U8)joint;
+					*influences++ = (U16)llclamp((weights[c] - joint) * QUANTA + 0.5f, 0.f, QUANTA);
+				}
+			}
+		}
+		if (face.mNumIndices > 0)
+		{
+			memcpy(&out[header.mIndexOffset], face.mIndices, face.mNumIndices * sizeof(U16));
+		}
+	}
+	memcpy(&out[sizeof(FileHeader)], &faces[0], face_count * sizeof(FaceHeader));
+
+	FileHeader header;
+	memset(&header, 0, sizeof(FileHeader));
+	header.mMagic = LOD_CACHE_MAGIC;
+	header.mVersion = VERSION;
+	header.mSourceSize = source_size;
+	header.mSculptType = mesh_params.getSculptType();
+	header.mLOD = lod;
+	header.mFaceCount = face_count;
+	header.mDecodeSeconds = decode_seconds;
+	header.mChecksum = HBXXH64::digest(&out[sizeof(FileHeader)], out.size() - sizeof(FileHeader));
+	memcpy(&out[0], &header, sizeof(FileHeader));
+	return true;
+}
+
+//static
+bool LLMeshLODCache::unpack(const U8* data, size_t size, const LLVolumeParams& mesh_params, S32 lod, U32 source_size,
+							LLVolume* volume, F32* decode_seconds)
+{
+	if (!data || size < sizeof(FileHeader))
+	{
+		return false;
+	}
+	const FileHeader* header = (const FileHeader*)data;
+	if (header->mMagic != LOD_CACHE_MAGIC || header->mVersion != VERSION
+		|| header->mSourceSize != source_size || header->mLOD != lod
+		|| header->mSculptType != mesh_params.getSculptType()
+		|| header->mFaceCount == 0
+		|| !in_bounds(sizeof(FileHeader), (size_t)header->mFaceCount * sizeof(FaceHeader), size)
+		|| header->mChecksum != HBXXH64::digest(data + sizeof(FileHeader), size - sizeof(FileHeader)))
+	{
+		return false;
+	}
+
+	// The checksum vouches for the bytes, the bounds still need checking in
+	// case a different build wrote them
+	const FaceHeader* faces = (const FaceHeader*)(data + sizeof(FileHeader));
+	LLVolume::face_list_t& volume_faces = volume->getVolumeFaces();
+	volume_faces.resize(header->mFaceCount);
+	for (U32 i = 0; i < header->mFaceCount; ++i)
+	{
+		const FaceHeader& face_header = faces[i];
+		const size_t vertices = face_header.mNumVertices;
+		const bool has_weights = (face_header.mFlags & FACE_HAS_WEIGHTS) != 0;
+		if (vertices > 65536
+			|| !in_bounds(face_header.mPositionOffset, vertices * 3 * sizeof(U16), size)
+			|| !in_bounds(face_header.mNormalOffset, vertices * 3 * sizeof(U16), size)
+			|| !in_bounds(face_header.mTexCoordOffset, vertices * 2 * sizeof(U16), size)
+			|| (has_weights && !in_bounds(face_header.mWeightOffset, vertices * 4 * (sizeof(U8) + sizeof(U16)), size))
+			|| !in_bounds(face_header.mIndexOffset, face_header.mNumIndices * sizeof(U16), size))
+		{
+			volume_faces.clear();
+			return false;
+		}
+
+		LLVolumeFace& face = volume_faces[i];
+		face.resizeVertices(face_header.mNumVertices);
+		face.resizeIndices(face_header.mNumIndices);
+		if (has_weights)
+		{
+			face.allocateWeights(face_header.mNumVertices);
+		}
+		if ((vertices && !face.mPositions) || (face_header.mNumIndices && !face.mIndices)
+			|| (has_weights && !face.mWeights))
+		{
+			LL_WARNS() << "Failed to allocate face " << i << " of " << header->mFaceCount << LL_ENDL;
+			volume_faces.clear();
+			return false;
+		}
+
+		dequantise3((const U16*)(data + face_header.mPositionOffset), face.mNumVertices,
+					face_header.mPositionDomain, face.mPositions);
+		dequantise3((const U16*)(data + face_header.mNormalOffset), face.mNumVertices,
+					face_header.mNormalDomain, face.mNormals);
+
+		const U16* tc = (const U16*)(data + face_header.mTexCoordOffset);
+		const StreamDomain& tc_domain = face_header.mTexCoordDomain;
+		for (S32 v = 0; v < face.mNumVertices; ++v)
+		{
+			face.mTexCoords[v].set(tc_domain.mMin[0] + (F32)tc[0] / QUANTA * tc_domain.mRange[0],
+								   tc_domain.mMin[1] + (F32)tc[1] / QUANTA * tc_domain.mRange[1]);
+			tc += 2;
+		}
+
+		if (has_weights)
+		{
+			const U8* joints = data + face_header.mWeightOffset;
+			const U16* influences = (const U16*)(joints + vertices * 4);
+			for (S32 v = 0; v < face.mNumVertices; ++v)
+			{
+				F32 weights[4];
+				for (S32 c = 0; c < 4; ++c)
+				{
+					weights[c] = (F32)*joints++ + (F32)*influences++ / QUANTA;
+				}
+				face.mWeights[v].loadua(weights);
+			}
+		}
+
+		if (face.mNumIndices > 0)
+		{
+			const U16* indices = (const U16*)(data + face_header.mIndexOffset);
+			for (S32 j = 0; j < face.mNumIndices; ++j)
+			{
+				if (indices[j] >= face.mNumVertices)
+				{
+					volume_faces.clear();
+					return false;
+				}
+			}
+			memcpy(face.mIndices, indices, face.mNumIndices * sizeof(U16));
+		}
+
+		face.mExtents[0].loadua(face_header.mExtents);
+		face.mExtents[1].loadua(face_header.mExtents + 4);
+		memcpy(face.mTexCoordExtents, face_header.mTexCoordExtents, sizeof(face.mTexCoordExtents));
+		// Stored after LLVolume::cacheOptimize()
+		face.mOptimized = TRUE;
+	}
+
+	if (decode_seconds)
+	{
+		*decode_seconds = header->mDecodeSeconds;
+	}
+	return true;
+}
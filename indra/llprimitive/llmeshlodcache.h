@@ -0,0 +1,96 @@
+/**
+ * @file llmeshlodcache.h
+ * @brief Disk cache of decoded mesh LODs.
+ *
+ * @Description:
+ * Mesh assets are cached as downloaded: zipped LLSD. Loading one LOD from
+ * there means inflating it, parsing the LLSD, dequantising the streams into
+ * LLVolumeFaces and running the vertex cache optimiser, every time.
+ * LLMeshLODCache keeps the result of all that instead, one file per mesh LOD
+ * holding the optimised vertex and index streams of every face, quantised to
+ * 16 bits over the range each stream covers. Skin weights are kept as a joint
+ * index byte and a 16 bit influence each. Loading is one mapped read, a
+ * checksum, and a pass turning the streams back into floats.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESHLODCACHE_H
+#define LL_LLMESHLODCACHE_H
+
+#include "llpointer.h"
+#include "llvolume.h"
+
+#include <functional>
+
+class LLMeshLODCache
+{
+	LOG_CLASS(LLMeshLODCache);
+public:
+	// Bump whenever the layout of the files changes, older files are misses
+	static const U32 VERSION = 1;
+
+	// Where the decoded LOD of a mesh lives
+	typedef std::function<std::string(const LLUUID& mesh_id, S32 lod)> path_func_t;
+
+	LLMeshLODCache(const path_func_t& path_func);
+
+	std::string getFilename(const LLUUID& mesh_id, S32 lod) const { return mPathFunc(mesh_id, lod); }
+
+	/**
+	 * Threads: any. Whether a decoded LOD is on disk, without checking it
+	 * still matches the asset.
+	 */
+	bool exists(const LLUUID& mesh_id, S32 lod) const;
+
+	/**
+	 * Threads: any. Loads a decoded LOD, NULL if there is none or it does
+	 * not match mesh_params and source_size, the size of the zipped LOD
+	 * block in the mesh asset. decode_seconds is set to what decoding the
+	 * block took when it was stored.
+	 */
+	LLPointer<LLVolume> load(const LLVolumeParams& mesh_params, S32 lod, U32 source_size,
+							 F32* decode_seconds = NULL) const;
+
+	/**
+	 * Threads: any, but not twice at once for the same LOD. Stores the faces
+	 * of volume, freshly unpacked from a block of source_size bytes.
+	 */
+	bool store(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, F32 decode_seconds,
+			   const LLVolume* volume) const;
+
+	void remove(const LLUUID& mesh_id, S32 lod) const;
+
+	/**
+	 * The file format, for those keeping the bytes themselves.
+	 */
+	static bool pack(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, F32 decode_seconds,
+					 const LLVolume* volume, std::vector<U8>& out);
+	static bool unpack(const U8* data, size_t size, const LLVolumeParams& mesh_params, S32 lod, U32 source_size,
+					   LLVolume* volume, F32* decode_seconds = NULL);
+
+private:
+	path_func_t mPathFunc;
+};
+
+#endif // LL_LLMESHLODCACHE_H
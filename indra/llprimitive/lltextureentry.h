@@ -160,7 +160,11 @@ public:
 	U8	 getMediaTexGen() const { return mMediaFlags; }
     F32  getGlow() const { return mGlow; }
 	const LLMaterialID& getMaterialID() const { return mMaterialID; };
-	const LLMaterialPtr getMaterialParams() const { return mMaterial; };
+	// <FS:Kadah> By reference, face geometry is rebuilt on worker threads and
+	// the reference count of a shared material is not atomic
+	//const LLMaterialPtr getMaterialParams() const { return mMaterial; };
+	const LLMaterialPtr& getMaterialParams() const { return mMaterial; };
+	// </FS:Kadah>
 
     // *NOTE: it is possible for hasMedia() to return true, but getMediaData() to return NULL.
     // CONVERSELY, it is also possible for hasMedia() to return false, but getMediaData()
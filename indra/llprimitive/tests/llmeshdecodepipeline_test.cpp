@@ -0,0 +1,214 @@
+/**
+ * @file llmeshdecodepipeline_test.cpp
+ * @brief Tests for LLMeshDecodePipeline.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llmeshdecodepipeline.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "lloctree.h"
+#include "lltimer.h"
+#include "testmesh.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	LLVolumeParams mesh_params(const LLUUID& id)
+	{
+		LLVolumeParams params;
+		params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+		params.setSculptID(id, LL_SCULPT_TYPE_MESH);
+		return params;
+	}
+
+	// Pops until count results arrived or ten seconds passed
+	void wait_for_results(LLMeshDecodePipeline& pipeline, std::vector<LLMeshDecodePipeline::Result>& results, size_t count)
+	{
+		LLTimer timer;
+		while (results.size() < count && timer.getElapsedTimeF32() < 10.f)
+		{
+			if (!pipeline.popResults(results))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	void ensure_same_faces(const std::string& msg, const LLVolume* volume, const LLVolume* expected)
+	{
+		tut::ensure_equals(msg + " faces", volume->getNumVolumeFaces(), expected->getNumVolumeFaces());
+		for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+		{
+			const LLVolumeFace& face = volume->getVolumeFace(i);
+			const LLVolumeFace& expected_face = expected->getVolumeFace(i);
+			tut::ensure_equals(msg + " vertices", face.mNumVertices, expected_face.mNumVertices);
+			tut::ensure_equals(msg + " indices", face.mNumIndices, expected_face.mNumIndices);
+			tut::ensure(msg + " positions", !memcmp(face.mPositions, expected_face.mPositions, face.mNumVertices * sizeof(LLVector4a)));
+			tut::ensure(msg + " index list", !memcmp(face.mIndices, expected_face.mIndices, face.mNumIndices * sizeof(U16)));
+		}
+	}
+}
+
+namespace tut
+{
+	struct LLMeshDecodePipelineFixture
+	{
+		LLMeshDecodePipelineFixture()
+		{
+			// What the viewer partitions with, see OctreeMaxNodeCapacity
+			gOctreeMaxCapacity = 128;
+			gOctreeMinSize = 0.01f;
+		}
+	};
+
+	typedef test_group<LLMeshDecodePipelineFixture> LLMeshDecodePipelineTestGroup;
+	typedef LLMeshDecodePipelineTestGroup::object LLMeshDecodePipelineTestObject;
+	LLMeshDecodePipelineTestGroup meshDecodePipelineTestGroup("LLMeshDecodePipeline");
+
+	template<> template<>
+	void LLMeshDecodePipelineTestObject::test<1>()
+	{
+		set_test_name("workers decode as the repository thread did");
+		LLMeshDecodePipeline pipeline("LLMeshDecodePipelineTest1", 3, true);
+		pipeline.start();
+
+		const S32 MESHES = 24;
+		std::vector<std::vector<U8> > blocks;
+		std::vector<LLUUID> ids;
+		for (S32 i = 0; i < MESHES; ++i)
+		{
+			blocks.push_back(make_mesh_lod(1 + i % 4, 8 + i));
+			ids.push_back(LLUUID::generateNewID());
+
+			LLMeshDecodePipeline::Request request;
+			request.mMeshParams = mesh_params(ids.back());
+			request.mLOD = i % 4;
+			request.mData = blocks.back();
+			ensure("posted", pipeline.post(request));
+			ensure("data taken", request.mData.empty());
+		}
+
+		std::vector<LLMeshDecodePipeline::Result> results;
+		wait_for_results(pipeline, results, MESHES);
+		ensure_equals("all decoded", results.size(), (size_t)MESHES);
+		ensure_equals("nothing pending", pipeline.getPendingCount(), 0);
+
+		for (const LLMeshDecodePipeline::Result& result : results)
+		{
+			S32 i = (S32)(std::find(ids.begin(), ids.end(), result.mMeshParams.getSculptID()) - ids.begin());
+			ensure("known mesh", i < MESHES);
+			ensure_equals("lod", result.mLOD, i % 4);
+			ensure("volume", result.mVolume.notNull());
+
+			LLPointer<LLVolume> expected = LLMeshDecodePipeline::decode(result.mMeshParams, result.mLOD,
+																		  &blocks[i][0], (S32)blocks[i].size(), false);
+			ensure("inline decode", expected.notNull());
+			ensure_same_faces("worker", result.mVolume, expected);
+			for (S32 f = 0; f < result.mVolume->getNumVolumeFaces(); ++f)
+			{
+				ensure("octree built", result.mVolume->getVolumeFace(f).getOctree() != NULL);
+			}
+		}
+		pipeline.close();
+	}
+
+	template<> template<>
+	void LLMeshDecodePipelineTestObject::test<2>()
+	{
+		set_test_name("the callback sees failures and can drop results");
+		std::atomic<S32> failures(0);
+		LLMeshDecodePipeline pipeline("LLMeshDecodePipelineTest2", 2, false,
+									  [&failures](const LLMeshDecodePipeline::Request& request, const LLVolume* volume)
+									  {
+										  if (!volume)
+										  {
+											  ++failures;
+											  // retried elsewhere, as a broken cache entry would be
+											  return request.mSource == LLMeshDecodePipeline::SOURCE_NETWORK;
+										  }
+										  return true;
+									  });
+		pipeline.start();
+
+		LLMeshDecodePipeline::Request good;
+		good.mMeshParams = mesh_params(LLUUID::generateNewID());
+		good.mData = make_mesh_lod(2, 12);
+		pipeline.post(good);
+
+		LLMeshDecodePipeline::Request cached;
+		cached.mMeshParams = mesh_params(LLUUID::generateNewID());
+		cached.mData.assign(200, 0x5a);
+		cached.mSource = LLMeshDecodePipeline::SOURCE_ASSET_CACHE;
+		pipeline.post(cached);
+
+		LLMeshDecodePipeline::Request downloaded;
+		downloaded.mMeshParams = mesh_params(LLUUID::generateNewID());
+		downloaded.mData.assign(200, 0xa5);
+		pipeline.post(downloaded);
+
+		std::vector<LLMeshDecodePipeline::Result> results;
+		wait_for_results(pipeline, results, 2);
+		LLTimer timer;
+		while (pipeline.getPendingCount() > 0 && timer.getElapsedTimeF32() < 10.f)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		ensure_equals("failures", (S32)failures, 2);
+		ensure_equals("cache failure dropped", results.size(), (size_t)2);
+		ensure_equals("nothing pending", pipeline.getPendingCount(), 0);
+		for (const LLMeshDecodePipeline::Result& result : results)
+		{
+			bool is_good = result.mMeshParams.getSculptID() == good.mMeshParams.getSculptID();
+			ensure("only the downloaded failure is reported", is_good || result.mMeshParams.getSculptID() == downloaded.mMeshParams.getSculptID());
+			ensure_equals("volume only when decoded", result.mVolume.notNull(), is_good);
+		}
+		pipeline.close();
+	}
+
+	template<> template<>
+	void LLMeshDecodePipelineTestObject::test<3>()
+	{
+		set_test_name("a closed pipeline hands requests back");
+		LLMeshDecodePipeline pipeline("LLMeshDecodePipelineTest3", 1, false);
+		pipeline.start();
+		ensure("open", pipeline.isOpen());
+		pipeline.close();
+		ensure("closed", !pipeline.isOpen());
+
+		LLMeshDecodePipeline::Request request;
+		request.mMeshParams = mesh_params(LLUUID::generateNewID());
+		request.mData = make_mesh_lod(1, 8);
+		const size_t size = request.mData.size();
+		ensure("refused", !pipeline.post(request));
+		ensure_equals("data kept", request.mData.size(), size);
+		ensure_equals("nothing pending", pipeline.getPendingCount(), 0);
+	}
+}
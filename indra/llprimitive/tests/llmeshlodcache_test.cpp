@@ -0,0 +1,272 @@
+/**
+ * @file llmeshlodcache_test.cpp
+ * @brief Tests for LLMeshLODCache.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llmeshlodcache.h"
+
+#include <thread>
+
+#include "llfile.h"
+#include "../llmeshdecodepipeline.h"
+#include "lloctree.h"
+#include "lltimer.h"
+#include "llvolumemgr.h"
+#include "testmesh.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	LLVolumeParams mesh_params(const LLUUID& id, U8 sculpt_flags = 0)
+	{
+		LLVolumeParams params;
+		params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+		params.setSculptID(id, LL_SCULPT_TYPE_MESH | sculpt_flags);
+		return params;
+	}
+
+	std::string cache_path(const LLUUID& mesh_id, S32 lod)
+	{
+		return llformat("%s/llmeshlodcache_test_%s_%d.lod", LLFile::tmpdir(), mesh_id.asString().c_str(), lod);
+	}
+
+	// Every stream within a 16 bit step of the face extents
+	void ensure_close(const std::string& msg, const LLVolume* volume, const LLVolume* expected)
+	{
+		tut::ensure_equals(msg + " faces", volume->getNumVolumeFaces(), expected->getNumVolumeFaces());
+		for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+		{
+			const LLVolumeFace& face = volume->getVolumeFace(i);
+			const LLVolumeFace& expected_face = expected->getVolumeFace(i);
+			tut::ensure_equals(msg + " vertices", face.mNumVertices, expected_face.mNumVertices);
+			tut::ensure_equals(msg + " indices", face.mNumIndices, expected_face.mNumIndices);
+			tut::ensure(msg + " index list", !memcmp(face.mIndices, expected_face.mIndices, face.mNumIndices * sizeof(U16)));
+			tut::ensure(msg + " extents", !memcmp(face.mExtents, expected_face.mExtents, 2 * sizeof(LLVector4a)));
+			tut::ensure(msg + " optimized", face.mOptimized);
+
+			LLVector4a size;
+			size.setSub(expected_face.mExtents[1], expected_face.mExtents[0]);
+			const F32 position_step = llmax(size[0], size[1], size[2]) / 65535.f;
+			for (S32 v = 0; v < face.mNumVertices; ++v)
+			{
+				for (S32 c = 0; c < 3; ++c)
+				{
+					tut::ensure(msg + " position", fabsf(face.mPositions[v][c] - expected_face.mPositions[v][c]) <= position_step);
+					tut::ensure(msg + " normal", fabsf(face.mNormals[v][c] - expected_face.mNormals[v][c]) <= 2.f / 65535.f);
+				}
+				for (S32 c = 0; c < 2; ++c)
+				{
+					tut::ensure(msg + " texcoord", fabsf(face.mTexCoords[v].mV[c] - expected_face.mTexCoords[v].mV[c]) <= 1.f / 65535.f);
+				}
+			}
+
+			tut::ensure_equals(msg + " weighted", face.mWeights != NULL, expected_face.mWeights != NULL);
+			for (S32 v = 0; face.mWeights && v < face.mNumVertices; ++v)
+			{
+				for (S32 c = 0; c < 4; ++c)
+				{
+					F32 weight = face.mWeights[v][c];
+					F32 expected_weight = expected_face.mWeights[v][c];
+					tut::ensure_equals(msg + " joint", (S32)weight, (S32)expected_weight);
+					tut::ensure(msg + " weight", fabsf(weight - expected_weight) <= 1.f / 65535.f);
+				}
+			}
+		}
+	}
+}
+
+namespace tut
+{
+	struct LLMeshLODCacheFixture
+	{
+		LLMeshLODCacheFixture()
+		:	mCache(cache_path)
+		{
+			gOctreeMaxCapacity = 128;
+			gOctreeMinSize = 0.01f;
+		}
+
+		~LLMeshLODCacheFixture()
+		{
+			for (const LLUUID& id : mIDs)
+			{
+				for (S32 lod = 0; lod < 4; ++lod)
+				{
+					mCache.remove(id, lod);
+				}
+			}
+		}
+
+		LLUUID newID()
+		{
+			mIDs.push_back(LLUUID::generateNewID());
+			return mIDs.back();
+		}
+
+		LLMeshLODCache mCache;
+		std::vector<LLUUID> mIDs;
+	};
+
+	typedef test_group<LLMeshLODCacheFixture> LLMeshLODCacheTestGroup;
+	typedef LLMeshLODCacheTestGroup::object LLMeshLODCacheTestObject;
+	LLMeshLODCacheTestGroup meshLODCacheTestGroup("LLMeshLODCache");
+
+	template<> template<>
+	void LLMeshLODCacheTestObject::test<1>()
+	{
+		set_test_name("unpacked faces match the decoded ones");
+		for (S32 rigged = 0; rigged < 2; ++rigged)
+		{
+			std::vector<U8> block = make_mesh_lod(3, 17, 0.2f, rigged);
+			LLVolumeParams params = mesh_params(newID(), rigged ? LL_SCULPT_FLAG_MIRROR : 0);
+			LLPointer<LLVolume> decoded = LLMeshDecodePipeline::decode(params, 2, &block[0], (S32)block.size(), false);
+			ensure("decoded", decoded.notNull());
+
+			std::vector<U8> packed;
+			ensure("packed", LLMeshLODCache::pack(params, 2, (U32)block.size(), 0.25f, decoded, packed));
+			LLPointer<LLVolume> volume = new LLVolume(params, LLVolumeLODGroup::getVolumeScaleFromDetail(2));
+			F32 decode_seconds = 0.f;
+			ensure("unpacked", LLMeshLODCache::unpack(&packed[0], packed.size(), params, 2, (U32)block.size(),
+													  volume, &decode_seconds));
+			ensure_equals("decode time", decode_seconds, 0.25f);
+			ensure_close(rigged ? "rigged" : "static", volume, decoded);
+		}
+	}
+
+	template<> template<>
+	void LLMeshLODCacheTestObject::test<2>()
+	{
+		set_test_name("anything that does not match is a miss");
+		std::vector<U8> block = make_mesh_lod(2, 9);
+		LLVolumeParams params = mesh_params(newID());
+		LLPointer<LLVolume> decoded = LLMeshDecodePipeline::decode(params, 1, &block[0], (S32)block.size(), false);
+		std::vector<U8> packed;
+		LLMeshLODCache::pack(params, 1, (U32)block.size(), 0.f, decoded, packed);
+
+		LLPointer<LLVolume> volume = new LLVolume(params, 1.f);
+		ensure("other LOD", !LLMeshLODCache::unpack(&packed[0], packed.size(), params, 2, (U32)block.size(), volume));
+		ensure("other source", !LLMeshLODCache::unpack(&packed[0], packed.size(), params, 1, (U32)block.size() + 1, volume));
+		ensure("other flags", !LLMeshLODCache::unpack(&packed[0], packed.size(),
+													   mesh_params(params.getSculptID(), LL_SCULPT_FLAG_INVERT), 1,
+													   (U32)block.size(), volume));
+		ensure("truncated", !LLMeshLODCache::unpack(&packed[0], packed.size() - 4, params, 1, (U32)block.size(), volume));
+		std::vector<U8> damaged = packed;
+		damaged[damaged.size() / 2] ^= 0x10;
+		ensure("damaged", !LLMeshLODCache::unpack(&damaged[0], damaged.size(), params, 1, (U32)block.size(), volume));
+		damaged = packed;
+		damaged[4] += 1;
+		ensure("other version", !LLMeshLODCache::unpack(&damaged[0], damaged.size(), params, 1, (U32)block.size(), volume));
+		ensure("intact", LLMeshLODCache::unpack(&packed[0], packed.size(), params, 1, (U32)block.size(), volume));
+	}
+
+	template<> template<>
+	void LLMeshLODCacheTestObject::test<3>()
+	{
+		set_test_name("stored LODs load back from disk");
+		std::vector<U8> block = make_mesh_lod(4, 20, 0.1f, true);
+		LLVolumeParams params = mesh_params(newID());
+		LLPointer<LLVolume> decoded = LLMeshDecodePipeline::decode(params, 3, &block[0], (S32)block.size(), false);
+
+		ensure("nothing yet", !mCache.exists(params.getSculptID(), 3));
+		ensure("no load yet", mCache.load(params, 3, (U32)block.size()).isNull());
+		ensure("stored", mCache.store(params, 3, (U32)block.size(), 0.5f, decoded));
+		ensure("exists", mCache.exists(params.getSculptID(), 3));
+		ensure("other LOD", !mCache.exists(params.getSculptID(), 2));
+
+		F32 decode_seconds = 0.f;
+		LLPointer<LLVolume> loaded = mCache.load(params, 3, (U32)block.size(), &decode_seconds);
+		ensure("loaded", loaded.notNull());
+		ensure_equals("decode time", decode_seconds, 0.5f);
+		ensure_close("loaded", loaded, decoded);
+
+		mCache.remove(params.getSculptID(), 3);
+		ensure("removed", !mCache.exists(params.getSculptID(), 3));
+	}
+
+	template<> template<>
+	void LLMeshLODCacheTestObject::test<4>()
+	{
+		set_test_name("the decode pipeline fills the cache and serves from it");
+		LLMeshDecodePipeline pipeline("LLMeshLODCacheTest", 2, true);
+		pipeline.setLODCache(new LLMeshLODCache(cache_path));
+		pipeline.start();
+
+		std::vector<U8> block = make_mesh_lod(2, 12);
+		const U32 source_size = (U32)block.size();
+		LLVolumeParams params = mesh_params(newID());
+		std::vector<LLMeshDecodePipeline::Result> results;
+		auto wait_for_result = [&]()
+		{
+			LLTimer timer;
+			results.clear();
+			while (results.empty() && timer.getElapsedTimeF32() < 10.f)
+			{
+				if (!pipeline.popResults(results))
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+			ensure_equals("one result", results.size(), (size_t)1);
+		};
+
+		LLMeshDecodePipeline::Request cold;
+		cold.mMeshParams = params;
+		cold.mLOD = 1;
+		cold.mData = block;
+		pipeline.post(cold);
+		wait_for_result();
+		ensure("cold decoded", results[0].mVolume.notNull());
+		ensure_equals("cold source", results[0].mSource, LLMeshDecodePipeline::SOURCE_NETWORK);
+		ensure("stored", mCache.exists(params.getSculptID(), 1));
+		LLPointer<LLVolume> expected = results[0].mVolume;
+
+		LLMeshDecodePipeline::Request warm;
+		warm.mMeshParams = params;
+		warm.mLOD = 1;
+		warm.mSourceSize = source_size;
+		warm.mSource = LLMeshDecodePipeline::SOURCE_LOD_CACHE;
+		pipeline.post(warm);
+		wait_for_result();
+		ensure("warm loaded", results[0].mVolume.notNull());
+		ensure_equals("warm source", results[0].mSource, LLMeshDecodePipeline::SOURCE_LOD_CACHE);
+		ensure("warm saved time", results[0].mSecondsSaved >= 0.f);
+		ensure_close("warm", results[0].mVolume, expected);
+		for (S32 f = 0; f < results[0].mVolume->getNumVolumeFaces(); ++f)
+		{
+			ensure("octree built", results[0].mVolume->getVolumeFace(f).getOctree() != NULL);
+		}
+
+		// The asset changed size: a miss, and the stale entry goes
+		warm.mSourceSize = source_size + 1;
+		pipeline.post(warm);
+		wait_for_result();
+		ensure("stale", results[0].mVolume.isNull());
+		ensure("stale entry removed", !mCache.exists(params.getSculptID(), 1));
+		pipeline.close();
+	}
+}
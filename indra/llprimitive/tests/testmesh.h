@@ -0,0 +1,127 @@
+/**
+ * @file testmesh.h
+ * @brief Synthetic mesh assets for the llprimitive tests and benchmarks.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_TESTMESH_H
+#define LL_TESTMESH_H
+
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "v2math.h"
+#include "v3math.h"
+
+#include <string>
+#include <vector>
+
+// A mesh LOD block as the uploader writes it: faces of quantised streams in
+// zipped binary LLSD. Each face is a bumpy sphere of rings x rings vertices,
+// weighted to up to four joints when rigged.
+inline std::vector<U8> make_mesh_lod(S32 faces, S32 rings, F32 bumpiness = 0.1f, bool rigged = false)
+{
+	rings = llmax(rings, 3);
+	LLSD mdl = LLSD::emptyArray();
+	for (S32 f = 0; f < faces; ++f)
+	{
+		std::vector<U8> pos;
+		std::vector<U8> norm;
+		std::vector<U8> tc;
+		std::vector<U8> idx;
+		std::vector<U8> weights;
+		auto push_u16 = [](std::vector<U8>& out, F32 value)
+		{
+			U16 v = (U16)llclamp(value * 65535.f + 0.5f, 0.f, 65535.f);
+			out.push_back(v & 0xff);
+			out.push_back(v >> 8);
+		};
+
+		for (S32 j = 0; j < rings; ++j)
+		{
+			for (S32 i = 0; i < rings; ++i)
+			{
+				F32 u = (F32)i / (rings - 1);
+				F32 v = (F32)j / (rings - 1);
+				F32 theta = u * F_TWO_PI;
+				F32 phi = v * F_PI;
+				LLVector3 n(sinf(phi) * cosf(theta), sinf(phi) * sinf(theta), cosf(phi));
+				F32 r = 0.5f * (1.f - bumpiness + bumpiness * sinf(theta * 5.f + f) * sinf(phi * 3.f));
+				for (S32 c = 0; c < 3; ++c)
+				{
+					push_u16(pos, n.mV[c] * r + 0.5f);
+					push_u16(norm, n.mV[c] * 0.5f + 0.5f);
+				}
+				push_u16(tc, u);
+				push_u16(tc, v);
+
+				if (rigged)
+				{
+					const S32 influences = 1 + (i + j) % 4;
+					for (S32 k = 0; k < influences; ++k)
+					{
+						weights.push_back((U8)((i + k * 7 + f) % 40));
+						push_u16(weights, (k + 1.f) / (influences + 1.f));
+					}
+					if (influences < 4)
+					{
+						weights.push_back(0xff);
+					}
+				}
+			}
+		}
+		for (S32 j = 0; j < rings - 1; ++j)
+		{
+			for (S32 i = 0; i < rings - 1; ++i)
+			{
+				U16 quad[6] = { (U16)(j * rings + i), (U16)(j * rings + i + 1), (U16)((j + 1) * rings + i),
+								(U16)(j * rings + i + 1), (U16)((j + 1) * rings + i + 1), (U16)((j + 1) * rings + i) };
+				for (U16 index : quad)
+				{
+					idx.push_back(index & 0xff);
+					idx.push_back(index >> 8);
+				}
+			}
+		}
+
+		LLSD face;
+		face["PositionDomain"]["Min"] = LLVector3(-0.5f, -0.5f, -0.5f).getValue();
+		face["PositionDomain"]["Max"] = LLVector3(0.5f, 0.5f, 0.5f).getValue();
+		face["TexCoord0Domain"]["Min"] = LLVector2(0.f, 0.f).getValue();
+		face["TexCoord0Domain"]["Max"] = LLVector2(1.f, 1.f).getValue();
+		face["Position"] = pos;
+		face["Normal"] = norm;
+		face["TexCoord0"] = tc;
+		face["TriangleList"] = idx;
+		if (rigged)
+		{
+			face["Weights"] = weights;
+		}
+		mdl.append(face);
+	}
+
+	std::string zipped = zip_llsd(mdl);
+	return std::vector<U8>(zipped.begin(), zipped.end());
+}
+
+#endif // LL_TESTMESH_H
@@ -875,7 +875,12 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage)
 	mIndexLocked(false),
 	mFinal(false),
 	mEmpty(true),
+	mStaged(false), // <FS:Kadah/>
 	mMappable(false),
+	// <FS:Kadah>
+	mStagedData(NULL),
+	mStagedIndexData(NULL),
+	// </FS:Kadah>
 	mFence(NULL)
 {
 	mMappable = (mUsage == GL_DYNAMIC_DRAW_ARB && !sDisableVBOMapping);
@@ -937,6 +942,7 @@ S32 LLVertexBuffer::getSize() const
 //virtual
 LLVertexBuffer::~LLVertexBuffer()
 {
+	releaseStaging(); // <FS:Kadah/>
 	destroyGLBuffer();
 	destroyGLIndices();
 
@@ -1450,6 +1456,12 @@ bool expand_region(LLVertexBuffer::MappedRegion& region, S32 index, S32 count)
 U8* LLVertexBuffer::mapVertexBuffer(S32 type, S32 index, S32 count, bool map_range)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+	// <FS:Kadah> May be on a worker thread, stay away from GL
+	if (mStaged)
+	{
+		return mapStagedVertexBuffer(type, index, count);
+	}
+	// </FS:Kadah>
 	bindGLBuffer(true);
 	if (mFinal)
 	{
@@ -1627,6 +1639,12 @@ U8* LLVertexBuffer::mapVertexBuffer(S32 type, S32 index, S32 count, bool map_ran
 U8* LLVertexBuffer::mapIndexBuffer(S32 index, S32 count, bool map_range)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+	// <FS:Kadah> May be on a worker thread, stay away from GL
+	if (mStaged)
+	{
+		return mapStagedIndexBuffer(index, count);
+	}
+	// </FS:Kadah>
 	bindGLIndices(true);
 	if (mFinal)
 	{
@@ -1785,6 +1803,150 @@ U8* LLVertexBuffer::mapIndexBuffer(S32 index, S32 count, bool map_range)
 	}
 }
 
+// <FS:Kadah> Staging
+bool LLVertexBuffer::stage()
+{
+	if (mStaged)
+	{
+		return true;
+	}
+	if (mFinal || (!mSize && !mIndicesSize))
+	{
+		return false;
+	}
+
+	// Pad like the real buffers, face rebuilds write whole LLVector4a's.
+	if (mSize)
+	{
+		mStagedData = (U8*)ll_aligned_malloc_16(mSize + 16);
+	}
+	if (mIndicesSize)
+	{
+		mStagedIndexData = (U8*)ll_aligned_malloc_16(mIndicesSize + 16);
+	}
+	if ((mSize && !mStagedData) || (mIndicesSize && !mStagedIndexData))
+	{
+		releaseStaging();
+		return false;
+	}
+
+	// Client side buffers can be read back, keep what is not rewritten so a
+	// partially written range ends up the same as when written in place.
+	if (!mMappable)
+	{
+		if (mStagedData && mMappedData)
+		{
+			memcpy(mStagedData, mMappedData, mSize);
+		}
+		if (mStagedIndexData && mMappedIndexData)
+		{
+			memcpy(mStagedIndexData, mMappedIndexData, mIndicesSize);
+		}
+	}
+
+	mStaged = true;
+	return true;
+}
+
+void LLVertexBuffer::unstage()
+{
+	if (!mStaged)
+	{
+		return;
+	}
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VERTEX;
+	mStaged = false;
+
+	for (const MappedRegion& region : mStagedVertexRegions)
+	{
+		U8* dst = mapVertexBuffer(region.mType, region.mIndex, region.mCount, false);
+		if (dst)
+		{
+			memcpy(dst, mStagedData + mOffsets[region.mType] + sTypeSize[region.mType] * region.mIndex,
+				   sTypeSize[region.mType] * region.mCount);
+		}
+	}
+
+	for (const MappedRegion& region : mStagedIndexRegions)
+	{
+		U8* dst = mapIndexBuffer(region.mIndex, region.mCount, false);
+		if (dst)
+		{
+			memcpy(dst, mStagedIndexData + sizeof(U16) * region.mIndex, sizeof(U16) * region.mCount);
+		}
+	}
+
+	releaseStaging();
+}
+
+void LLVertexBuffer::releaseStaging()
+{
+	ll_aligned_free_16(mStagedData);
+	ll_aligned_free_16(mStagedIndexData);
+	mStagedData = NULL;
+	mStagedIndexData = NULL;
+	mStagedVertexRegions.clear();
+	mStagedIndexRegions.clear();
+	mStaged = false;
+}
+
+U8* LLVertexBuffer::mapStagedVertexBuffer(S32 type, S32 index, S32 count)
+{
+	if (!mStagedData)
+	{
+		return NULL;
+	}
+	if (count == -1)
+	{
+		count = mNumVerts - index;
+	}
+
+	bool merged = false;
+	for (MappedRegion& region : mStagedVertexRegions)
+	{
+		if (region.mType == type && expand_region(region, index, count))
+		{
+			merged = true;
+			break;
+		}
+	}
+	if (!merged)
+	{
+		mStagedVertexRegions.push_back(MappedRegion(type, index, count));
+	}
+
+	return mStagedData + mOffsets[type] + sTypeSize[type] * index;
+}
+
+U8* LLVertexBuffer::mapStagedIndexBuffer(S32 index, S32 count)
+{
+	if (!mStagedIndexData)
+	{
+		return NULL;
+	}
+	if (count == -1)
+	{
+		count = mNumIndices - index;
+	}
+
+	bool merged = false;
+	for (MappedRegion& region : mStagedIndexRegions)
+	{
+		if (expand_region(region, index, count))
+		{
+			merged = true;
+			break;
+		}
+	}
+	if (!merged)
+	{
+		mStagedIndexRegions.push_back(MappedRegion(TYPE_INDEX, index, count));
+	}
+
+	return mStagedIndexData + sizeof(U16) * index;
+}
+// </FS:Kadah>
+
 void LLVertexBuffer::unmapBuffer()
 {
 	if (!useVBOs())
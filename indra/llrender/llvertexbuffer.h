@@ -229,6 +229,11 @@ protected:
 	bool	updateNumVerts(S32 nverts);
 	bool	updateNumIndices(S32 nindices); 
 	void	unmapBuffer();
+	// <FS:Kadah> Staged counterparts of mapVertexBuffer()/mapIndexBuffer()
+	U8*		mapStagedVertexBuffer(S32 type, S32 index, S32 count);
+	U8*		mapStagedIndexBuffer(S32 index, S32 count);
+	void	releaseStaging();
+	// </FS:Kadah>
 		
 public:
 	LLVertexBuffer(U32 typemask, S32 usage);
@@ -244,6 +249,19 @@ public:
     void	setBufferFast(U32 data_mask); 	// calls setupVertexBufferFast(), assumes data_mask is not 0 among other assumptions
 
 	void flush(); //flush pending data to GL memory
+
+	// <FS:Kadah> Staging for geometry that is built off the render thread.
+	// While a buffer is staged, mapVertexBuffer(), mapIndexBuffer() and the
+	// strider getters hand out pointers into a client side copy and make no
+	// GL calls, so a worker thread may fill the buffer (one thread per
+	// buffer). unstage() must be called on the render thread; it copies the
+	// ranges that were written into the buffer and leaves them mapped for
+	// flush(), exactly as if they had been written there directly.
+	bool stage();
+	void unstage();
+	bool isStaged() const					{ return mStaged; }
+	// </FS:Kadah>
+
 	// allocate buffer
 	bool	allocateBuffer(S32 nverts, S32 nindices, bool create);
 	virtual bool resizeBuffer(S32 newnverts, S32 newnindices);
@@ -330,6 +348,7 @@ protected:
 	U32		mIndexLocked : 1;			// if true, index buffer is being or has been written to in client memory
 	U32		mFinal : 1;			// if true, buffer can not be mapped again
 	U32		mEmpty : 1;			// if true, client buffer is empty (or NULL). Old values have been discarded.	
+	U32		mStaged : 1;		// <FS:Kadah/> if true, map calls go to mStagedData/mStagedIndexData
 	
 	mutable bool	mMappable;     // if true, use memory mapping to upload data (otherwise doublebuffer and use glBufferSubData)
 
@@ -338,6 +357,13 @@ protected:
 	std::vector<MappedRegion> mMappedVertexRegions;
 	std::vector<MappedRegion> mMappedIndexRegions;
 
+	// <FS:Kadah> Client side copies and written ranges while staged
+	U8*		mStagedData;
+	U8*		mStagedIndexData;
+	std::vector<MappedRegion> mStagedVertexRegions;
+	std::vector<MappedRegion> mStagedIndexRegions;
+	// </FS:Kadah>
+
 	mutable LLGLFence* mFence;
 
 	void placeFence() const;
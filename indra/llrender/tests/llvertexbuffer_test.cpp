@@ -0,0 +1,304 @@
+/**
+ * @file llvertexbuffer_test.cpp
+ * @brief LLVertexBuffer staging tests, packing volume faces on worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <thread>
+#include <vector>
+
+#include "../llvertexbuffer.h"
+#include "llmatrix4a.h"
+#include "llvolume.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	static const U32 FACE_MASK = LLVertexBuffer::MAP_VERTEX | LLVertexBuffer::MAP_NORMAL | LLVertexBuffer::MAP_TEXCOORD0;
+
+	struct Placement
+	{
+		const LLVolumeFace*	mFace;
+		LLMatrix4a			mMat;
+		S32					mGeomIndex;
+		S32					mIndicesIndex;
+	};
+
+	// One vertex buffer of a spatial group and the faces packed into it.
+	struct GroupBuffer
+	{
+		LLPointer<LLVertexBuffer>	mBuffer;
+		std::vector<Placement>		mFaces;
+	};
+
+	// The per face work of LLFace::getGeometryVolume() for an unbumped,
+	// untextured face: positions through the object matrix, normals,
+	// texture coordinates and indices offset to the face's vertices.
+	static void pack_face(LLVertexBuffer* buffer, const Placement& placement)
+	{
+		const LLVolumeFace& vf = *placement.mFace;
+
+		LLStrider<U16> indices;
+		buffer->getIndexStrider(indices, placement.mIndicesIndex, vf.mNumIndices);
+		for (S32 i = 0; i < vf.mNumIndices; ++i)
+		{
+			indices[i] = vf.mIndices[i] + placement.mGeomIndex;
+		}
+
+		LLStrider<LLVector4a> verts;
+		buffer->getVertexStrider(verts, placement.mGeomIndex, vf.mNumVertices);
+		for (S32 i = 0; i < vf.mNumVertices; ++i)
+		{
+			placement.mMat.affineTransform(vf.mPositions[i], verts[i]);
+		}
+
+		LLStrider<LLVector3> normals;
+		buffer->getNormalStrider(normals, placement.mGeomIndex, vf.mNumVertices);
+		for (S32 i = 0; i < vf.mNumVertices; ++i)
+		{
+			normals[i].set(vf.mNormals[i].getF32ptr());
+		}
+
+		LLStrider<LLVector2> tex_coords;
+		buffer->getTexCoord0Strider(tex_coords, placement.mGeomIndex, vf.mNumVertices);
+		for (S32 i = 0; i < vf.mNumVertices; ++i)
+		{
+			tex_coords[i] = vf.mTexCoords[i];
+		}
+	}
+
+	struct LLVertexBufferFixture
+	{
+		LLVertexBufferFixture()
+		:	mEnableVBOs(LLVertexBuffer::sEnableVBOs)
+		{
+			// Client side arrays, no GL context needed.
+			LLVertexBuffer::sEnableVBOs = false;
+
+			const U8 shapes[][2] =
+			{
+				{ LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE },
+				{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_LINE },
+				{ LL_PCODE_PROFILE_CIRCLE_HALF, LL_PCODE_PATH_CIRCLE },
+				{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_CIRCLE },
+			};
+			for (const U8* shape : shapes)
+			{
+				LLVolumeParams params;
+				params.setType(shape[0], shape[1]);
+				params.setBeginAndEndS(0.f, 1.f);
+				params.setBeginAndEndT(0.f, 1.f);
+				params.setRatio(1.f);
+				params.setShear(0.f);
+				mVolumes.push_back(new LLVolume(params, 2.f));
+			}
+		}
+
+		~LLVertexBufferFixture()
+		{
+			LLVertexBuffer::sEnableVBOs = mEnableVBOs;
+		}
+
+		// Spreads every face of every volume, at a few positions, over
+		// buffer_count buffers, packed back to back as genDrawInfo() does.
+		std::vector<GroupBuffer> makeGroup(S32 buffer_count)
+		{
+			std::vector<GroupBuffer> group(buffer_count);
+			std::vector<S32> verts(buffer_count, 0);
+			std::vector<S32> indices(buffer_count, 0);
+			S32 next = 0;
+			for (S32 copy = 0; copy < 3; ++copy)
+			{
+				for (const LLPointer<LLVolume>& volume : mVolumes)
+				{
+					for (S32 f = 0; f < volume->getNumVolumeFaces(); ++f)
+					{
+						const LLVolumeFace& vf = volume->getVolumeFace(f);
+						Placement placement;
+						placement.mFace = &vf;
+						placement.mMat.setIdentity();
+						placement.mMat.mMatrix[3].set((F32)copy, (F32)f, 2.f * next, 1.f);
+						placement.mGeomIndex = verts[next];
+						placement.mIndicesIndex = indices[next];
+						group[next].mFaces.push_back(placement);
+						verts[next] += vf.mNumVertices;
+						indices[next] += vf.mNumIndices;
+						next = (next + 1) % buffer_count;
+					}
+				}
+			}
+			for (S32 i = 0; i < buffer_count; ++i)
+			{
+				group[i].mBuffer = new LLVertexBuffer(FACE_MASK, 0);
+				group[i].mBuffer->allocateBuffer(verts[i], indices[i], true);
+			}
+			return group;
+		}
+
+		bool mEnableVBOs;
+		std::vector<LLPointer<LLVolume> > mVolumes;
+	};
+
+	static void ensure_same_data(const std::string& msg, LLVertexBuffer* expected, LLVertexBuffer* actual)
+	{
+		ensure_equals(msg + " verts", actual->getNumVerts(), expected->getNumVerts());
+		ensure_equals(msg + " indices", actual->getNumIndices(), expected->getNumIndices());
+		const S32 types[] = { LLVertexBuffer::TYPE_VERTEX, LLVertexBuffer::TYPE_NORMAL, LLVertexBuffer::TYPE_TEXCOORD0 };
+		for (S32 type : types)
+		{
+			S32 offset = expected->getOffset(type);
+			S32 bytes = LLVertexBuffer::sTypeSize[type] * expected->getNumVerts();
+			ensure(msg + llformat(" type %d", type),
+				   0 == memcmp(expected->getMappedData() + offset, actual->getMappedData() + offset, bytes));
+		}
+		ensure(msg + " index data",
+			   0 == memcmp(expected->getMappedIndices(), actual->getMappedIndices(), sizeof(U16) * expected->getNumIndices()));
+	}
+
+	typedef test_group<LLVertexBufferFixture> factory;
+	typedef factory::object object;
+}
+
+namespace
+{
+	tut::factory tf("LLVertexBuffer");
+}
+
+namespace tut
+{
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("group packed on worker threads matches the serial path");
+		const S32 BUFFERS = 5;
+		std::vector<GroupBuffer> serial = makeGroup(BUFFERS);
+		std::vector<GroupBuffer> parallel = makeGroup(BUFFERS);
+
+		for (GroupBuffer& buffer : serial)
+		{
+			for (const Placement& placement : buffer.mFaces)
+			{
+				pack_face(buffer.mBuffer, placement);
+			}
+			buffer.mBuffer->flush();
+		}
+
+		// As LLFaceGeometryBuilder: stage on this thread, one worker per
+		// buffer in face order, unstage and flush on this thread.
+		for (GroupBuffer& buffer : parallel)
+		{
+			ensure("stage", buffer.mBuffer->stage());
+		}
+		std::vector<std::thread> workers;
+		for (GroupBuffer& buffer : parallel)
+		{
+			workers.push_back(std::thread([&buffer]()
+			{
+				for (const Placement& placement : buffer.mFaces)
+				{
+					pack_face(buffer.mBuffer, placement);
+				}
+			}));
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		for (GroupBuffer& buffer : parallel)
+		{
+			buffer.mBuffer->unstage();
+			ensure("unstaged", !buffer.mBuffer->isStaged());
+			buffer.mBuffer->flush();
+		}
+
+		for (S32 i = 0; i < BUFFERS; ++i)
+		{
+			ensure_same_data(llformat("buffer %d", i), serial[i].mBuffer, parallel[i].mBuffer);
+		}
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("staged writes stay out of the buffer until unstage");
+		std::vector<GroupBuffer> group = makeGroup(1);
+		LLVertexBuffer* buffer = group[0].mBuffer;
+		const Placement& first = group[0].mFaces[0];
+		const Placement& second = group[0].mFaces[1];
+
+		pack_face(buffer, first);
+		buffer->flush();
+		std::vector<U8> before(buffer->getMappedData(), buffer->getMappedData() + buffer->getSize());
+
+		S32 mapped_count = LLVertexBuffer::sMappedCount;
+		ensure("stage", buffer->stage());
+		ensure("staged", buffer->isStaged());
+		pack_face(buffer, second);
+		ensure("not locked while staged", !buffer->isLocked());
+		ensure_equals("no mapping while staged", LLVertexBuffer::sMappedCount, mapped_count);
+		ensure("buffer untouched while staged",
+			   0 == memcmp(&before[0], buffer->getMappedData(), buffer->getSize()));
+
+		buffer->unstage();
+		buffer->flush();
+
+		// The first face survives, the second one has arrived.
+		LLStrider<LLVector4a> verts;
+		buffer->getVertexStrider(verts, 0, -1);
+		LLVector4a expected;
+		first.mMat.affineTransform(first.mFace->mPositions[0], expected);
+		ensure("first face kept", verts[first.mGeomIndex].equals3(expected));
+		second.mMat.affineTransform(second.mFace->mPositions[0], expected);
+		ensure("second face written", verts[second.mGeomIndex].equals3(expected));
+
+		LLStrider<U16> indices;
+		buffer->getIndexStrider(indices, 0, -1);
+		ensure_equals("second face indices", (S32)indices[second.mIndicesIndex],
+					  second.mFace->mIndices[0] + second.mGeomIndex);
+		buffer->flush();
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("unstage without writes changes nothing");
+		std::vector<GroupBuffer> group = makeGroup(1);
+		LLVertexBuffer* buffer = group[0].mBuffer;
+		for (const Placement& placement : group[0].mFaces)
+		{
+			pack_face(buffer, placement);
+		}
+		buffer->flush();
+		std::vector<U8> before(buffer->getMappedData(), buffer->getMappedData() + buffer->getSize());
+
+		ensure("stage", buffer->stage());
+		ensure("stage twice", buffer->stage());
+		buffer->unstage();
+		ensure("not locked", !buffer->isLocked());
+		ensure("unchanged", 0 == memcmp(&before[0], buffer->getMappedData(), buffer->getSize()));
+	}
+}
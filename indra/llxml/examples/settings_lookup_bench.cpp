@@ -0,0 +1,147 @@
+/**
+ * @file settings_lookup_bench.cpp
+ * @brief Times reading settings by name, through LLCachedControl and through LLControlSlots.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "linden_common.h"
+
+#include "llcontrol.h"
+#include "lltimer.h"
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tsettings_lookup_bench [options]\n"
+		"\n"
+		"Declares a control group about as large as gSavedSettings and\n"
+		"reads a handful of its F32 controls over and over: by name with\n"
+		"getF32(), through a function local LLCachedControl that looks the\n"
+		"control up again on every read, through a static LLCachedControl,\n"
+		"and through LLControlSlots.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -n <reads>      Reads timed for each way.  Default:  2000000\n"
+		" -c <count>      Controls in the group.  Default:  2000\n"
+		" -r <count>      Controls read, spread over the group.  Default:  16\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	S32 lookups = 2000000;
+	S32 controls = 2000;
+	S32 read = 16;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-n" && i + 1 < argc)
+		{
+			lookups = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-c" && i + 1 < argc)
+		{
+			controls = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-r" && i + 1 < argc)
+		{
+			read = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+	read = llmin(read, controls);
+
+	LLControlGroup group("bench");
+	std::vector<std::string> names;
+	for (S32 i = 0; i < controls; ++i)
+	{
+		names.push_back(llformat("BenchSetting%04d", i));
+		group.declareF32(names.back(), (F32)i, "Benchmark setting");
+	}
+	// The reads spread over the group as the hot call sites do
+	std::vector<const char*> read_names;
+	for (S32 i = 0; i < read; ++i)
+	{
+		read_names.push_back(names[i * controls / read].c_str());
+	}
+	LLControlSlots<F32> slots;
+	slots.bind(group, &read_names[0], read);
+	std::vector<LLCachedControl<F32> > cached;
+	for (S32 i = 0; i < read; ++i)
+	{
+		cached.push_back(LLCachedControl<F32>(group, read_names[i]));
+	}
+
+	F64 sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+	F64 start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < lookups; ++i)
+	{
+		sum[0] += group.getF32(read_names[i % read]);
+	}
+	F64 by_name = LLTimer::getTotalSeconds() - start;
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < lookups; ++i)
+	{
+		LLCachedControl<F32> control(group, read_names[i % read]);
+		sum[1] += control;
+	}
+	F64 local_cached = LLTimer::getTotalSeconds() - start;
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < lookups; ++i)
+	{
+		sum[2] += cached[i % read];
+	}
+	F64 static_cached = LLTimer::getTotalSeconds() - start;
+
+	start = LLTimer::getTotalSeconds();
+	for (S32 i = 0; i < lookups; ++i)
+	{
+		sum[3] += slots.get(i % read);
+	}
+	F64 indexed = LLTimer::getTotalSeconds() - start;
+
+	// The sums also keep the reads from being optimized away
+	const bool match = sum[1] == sum[0] && sum[2] == sum[0] && sum[3] == sum[0];
+	const F64 ns = 1.0e9 / lookups;
+	fprintf(stdout, "%d reads of %d out of %d controls%s\n", lookups, read, controls, match ? "" : " (MISMATCH)");
+	fprintf(stdout, "  getF32 by name          %7.2f ns\n", by_name * ns);
+	fprintf(stdout, "  local LLCachedControl   %7.2f ns\n", local_cached * ns);
+	fprintf(stdout, "  static LLCachedControl  %7.2f ns\n", static_cached * ns);
+	fprintf(stdout, "  LLControlSlots          %7.2f ns, %.1fx faster than by name\n", indexed * ns, by_name / llmax(indexed, 1e-9));
+	return match ? 0 : 1;
+}
@@ -35,6 +35,10 @@
 #include "llinstancetracker.h"
 
 #include <vector>
+// <FS:Kadah> Indexed control slots
+#include <atomic>
+#include <memory>
+// </FS:Kadah>
 
 // *NOTE: boost::visit_each<> generates warning 4675 on .net 2003
 // Disable the warning for the boost includes.
@@ -478,6 +482,69 @@ private:
 	LLPointer<LLControlCache<T> > mCachedControlPtr;
 };
 
+// <FS:Kadah> Indexed control slots
+//! A fixed table of controls read by index instead of by name.
+
+//! bind() looks each name up once and keeps a copy of its value in a slot,
+//! which the control's commit signal updates like LLControlCache does.
+//! get() is then an array read, without the string compare of the name
+//! lookup or the reference counted cache per call site.  The slots are
+//! atomic so that threads other than the one setting a control can read
+//! it.  Names missing from the group or of another type than T keep T()
+//! and are warned about.
+template <typename T>
+class LLControlSlots
+{
+public:
+	LLControlSlots() : mCount(0) {}
+
+	void bind(LLControlGroup& group, const char* const* names, U32 count)
+	{
+		mConnections.clear();
+		mSlots.reset(new std::atomic<T>[count]);
+		mCount = count;
+		const eControlType type = get_control_type<T>();
+		for (U32 i = 0; i < count; ++i)
+		{
+			mSlots[i].store(T(), std::memory_order_relaxed);
+			LLControlVariablePtr controlp = group.getControl(names[i]);
+			if (controlp.isNull())
+			{
+				LL_WARNS() << "Control named \"" << names[i] << "\" not found." << LL_ENDL;
+				continue;
+			}
+			if (controlp->type() != type)
+			{
+				LL_WARNS() << "Control named \"" << names[i] << "\" is not of the indexed type." << LL_ENDL;
+				continue;
+			}
+			mSlots[i].store(convert_from_llsd<T>(controlp->get(), type, names[i]), std::memory_order_relaxed);
+
+			// Group 0 like LLControlCache, the gSavedSettings handlers see the new value first
+			std::atomic<T>* slot = &mSlots[i];
+			mConnections.emplace_back(controlp->getSignal()->connect(0,
+				[slot, type](LLControlVariable*, const LLSD& newvalue, const LLSD&)
+				{
+					slot->store(convert_from_llsd<T>(newvalue, type, ""), std::memory_order_relaxed);
+				}));
+		}
+	}
+
+	T get(U32 index) const
+	{
+		llassert(index < mCount);
+		return mSlots[index].load(std::memory_order_relaxed);
+	}
+
+	U32 size() const { return mCount; }
+
+private:
+	std::unique_ptr<std::atomic<T>[]>	mSlots;
+	U32									mCount;
+	std::vector<boost::signals2::scoped_connection>	mConnections;
+};
+// </FS:Kadah>
+
 template <> eControlType get_control_type<U32>();
 template <> eControlType get_control_type<S32>();
 template <> eControlType get_control_type<F32>();
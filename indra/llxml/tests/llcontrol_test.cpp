@@ -151,4 +151,38 @@ namespace tut
 		ensure("listener fired on changed setting", mListenerFired);
 	}
 
+	//indexed slots
+	template<> template<>
+	void control_group_t::test<5>()
+	{
+		mCG->declareBOOL("SlotBool", TRUE, "Indexed bool");
+		mCG->declareF32("SlotFloat", 2.5f, "Indexed float");
+		mCG->declareU32("SlotUnsigned", 7, "Indexed unsigned");
+		const char* const bool_names[] = { "SlotBool", "SlotMissing", "SlotFloat" };
+		const char* const float_names[] = { "SlotFloat" };
+		LLControlSlots<bool> bools;
+		LLControlSlots<F32> floats;
+		bools.bind(*mCG, bool_names, 3);
+		floats.bind(*mCG, float_names, 1);
+		ensure_equals("slot count", bools.size(), 3U);
+		ensure("bound value", bools.get(0));
+		ensure("missing control is default", !bools.get(1));
+		ensure("control of other type is default", !bools.get(2));
+		ensure_equals("float value", floats.get(0), 2.5f);
+
+		mCG->setBOOL("SlotBool", FALSE);
+		mCG->setF32("SlotFloat", 4.f);
+		ensure("slot follows the control", !bools.get(0));
+		ensure_equals("float slot follows the control", floats.get(0), 4.f);
+
+		// Rebinding drops the old connections
+		const char* const unsigned_names[] = { "SlotUnsigned" };
+		LLControlSlots<U32> unsigneds;
+		unsigneds.bind(*mCG, unsigned_names, 1);
+		floats.bind(*mCG, bool_names, 1);
+		mCG->setU32("SlotUnsigned", 9);
+		ensure_equals("unsigned slot follows the control", unsigneds.get(0), 9U);
+		ensure("rebound slot is default", floats.get(0) == 0.f);
+	}
+
 }
@@ -0,0 +1,214 @@
+/**
+ * @file surface_edit_bench.cpp
+ * @brief Times updating terrain heights and normals after terraform strokes, whole patches against dirty rects.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../llsurfacekernels.h"
+
+#include "llrand.h"
+#include "lltimer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\tsurface_edit_bench [options]\n"
+		"\n"
+		"Applies random terraform strokes to a region's worth of heights,\n"
+		"the whole patch the simulator sends for each, and times bringing\n"
+		"the heights and normals up to date: copying the patch and redoing\n"
+		"every normal it touches one at a time, against copying what\n"
+		"changed and redoing the normals around it a row at a time.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -e <count>      Terraform strokes.  Default:  2000\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+// A region's surface, as LLSurface lays it out: 256 grids, 16 per patch
+// and a buffer row and column on the north and east
+static const U32 GRIDS = 256;
+static const U32 STRIDE = GRIDS + 1;
+static const U32 PATCH = 16;
+static const F32 METERS_PER_GRID = 1.f;
+
+static void make_terrain(std::vector<F32>& heights)
+{
+	heights.resize(STRIDE*STRIDE);
+	for (U32 j = 0; j < STRIDE; j++)
+	{
+		for (U32 i = 0; i < STRIDE; i++)
+		{
+			heights[i + j*STRIDE] = 20.f + 8.f*sinf(i*0.05f)*cosf(j*0.07f) + ll_frand(0.5f);
+		}
+	}
+}
+
+// What the simulator sends for a terraform stroke: the whole patch, with
+// a few heights raised around x, y
+static void make_edit(const std::vector<F32>& heights, U32 patch_x, U32 patch_y, U32 x, U32 y, S32 radius,
+					  std::vector<F32>& patch)
+{
+	patch.resize(PATCH*PATCH);
+	for (U32 j = 0; j < PATCH; j++)
+	{
+		for (U32 i = 0; i < PATCH; i++)
+		{
+			F32 height = heights[patch_x*PATCH + i + (patch_y*PATCH + j)*STRIDE];
+			S32 dx = (S32)i - (S32)x;
+			S32 dy = (S32)j - (S32)y;
+			if (dx*dx + dy*dy <= radius*radius)
+			{
+				height += 0.25f;
+			}
+			patch[i + j*PATCH] = height;
+		}
+	}
+}
+
+// Recomputes the normals in rect, clamped to where all samples are on
+// the surface
+static void update_normals(const std::vector<F32>& heights, std::vector<LLVector3>& normals, LLRect rect, bool vectorised)
+{
+	rect.intersectWith(LLRect(2, STRIDE - 2, STRIDE - 2, 2));
+	for (S32 y = rect.mBottom; y < rect.mTop; y++)
+	{
+		if (vectorised)
+		{
+			calc_surface_normals_row(&heights[0], &normals[0], STRIDE, rect.mLeft, rect.mRight, y, 2, METERS_PER_GRID);
+		}
+		else
+		{
+			for (S32 x = rect.mLeft; x < rect.mRight; x++)
+			{
+				normals[x + y*STRIDE] = calc_surface_normal(&heights[0], STRIDE, x, y, 2, METERS_PER_GRID);
+			}
+		}
+	}
+}
+
+struct Edit
+{
+	U32 mPatchX, mPatchY, mX, mY;
+	S32 mRadius;
+};
+
+int main(int argc, char** argv)
+{
+	S32 edit_count = 2000;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-e" && i + 1 < argc)
+		{
+			edit_count = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	std::vector<F32> start_heights;
+	make_terrain(start_heights);
+	std::vector<LLVector3> start_normals(STRIDE*STRIDE);
+	update_normals(start_heights, start_normals, LLRect(0, STRIDE, STRIDE, 0), false);
+
+	std::vector<Edit> edits(edit_count);
+	for (Edit& edit : edits)
+	{
+		edit.mPatchX = ll_rand(GRIDS/PATCH);
+		edit.mPatchY = ll_rand(GRIDS/PATCH);
+		edit.mX = ll_rand(PATCH);
+		edit.mY = ll_rand(PATCH);
+		edit.mRadius = ll_rand(4);
+	}
+
+	std::vector<F32> patch;
+	F64 seconds[2];
+	std::vector<LLVector3> normals[2];
+	for (S32 pass = 0; pass < 2; pass++)
+	{
+		const bool dirty_rect = pass == 1;
+		std::vector<F32> heights = start_heights;
+		normals[pass] = start_normals;
+
+		F64 elapsed = 0.0;
+		for (const Edit& edit : edits)
+		{
+			make_edit(heights, edit.mPatchX, edit.mPatchY, edit.mX, edit.mY, edit.mRadius, patch);
+
+			F64 start = LLTimer::getTotalSeconds();
+			F32* dataz = &heights[edit.mPatchX*PATCH + edit.mPatchY*PATCH*STRIDE];
+			LLRect rect;
+			if (dirty_rect)
+			{
+				// Copy what changed, then the normals two grids around it
+				rect = copy_changed_heights(dataz, STRIDE, &patch[0], PATCH, PATCH);
+				rect.stretch(2);
+			}
+			else
+			{
+				// Copy the patch, then all normals of it and the edges of
+				// its neighbors
+				for (U32 j = 0; j < PATCH; j++)
+				{
+					memcpy(dataz + j*STRIDE, &patch[j*PATCH], PATCH*sizeof(F32));
+				}
+				rect.setOriginAndSize(-2, -2, PATCH + 4, PATCH + 4);
+			}
+			rect.translate(edit.mPatchX*PATCH, edit.mPatchY*PATCH);
+			update_normals(heights, normals[pass], rect, dirty_rect);
+			elapsed += LLTimer::getTotalSeconds() - start;
+		}
+		seconds[pass] = elapsed;
+	}
+
+	// Both ways have to end up with the same surface
+	F32 max_diff = 0.f;
+	for (U32 i = 0; i < STRIDE*STRIDE; i++)
+	{
+		for (S32 k = 0; k < 3; k++)
+		{
+			max_diff = llmax(max_diff, fabsf(normals[1][i].mV[k] - normals[0][i].mV[k]));
+		}
+	}
+	const bool match = max_diff < 1.e-5f;
+
+	fprintf(stdout, "%d height edits%s\n", edit_count, match ? "" : " (MISMATCH)");
+	fprintf(stdout, "  whole patch  %8.3f us per edit\n", seconds[0] * 1000000.0 / edit_count);
+	fprintf(stdout, "  dirty rect   %8.3f us per edit, %.2fx\n", seconds[1] * 1000000.0 / edit_count,
+			seconds[0] / llmax(seconds[1], 1e-9));
+	return match ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file texture_priority_bench.cpp
+ * @brief Times a decode priority pass walking texture objects against selecting from LLTexturePriorityTable.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../lltexturepriority.h"
+
+#include "llgltexture.h"
+#include "llimage.h"
+#include "llrand.h"
+#include "lltimer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+typedef LLTexturePriorityTable::slot_t slot_t;
+
+static void usage(std::ostream& out)
+{
+	out << "\n"
+		"usage:\ttexture_priority_bench [options]\n"
+		"\n"
+		"Times a decode priority pass over a synthetic texture list two\n"
+		"ways: walking one heap object per texture the way\n"
+		"calcDecodePriority() does, and picking the changed textures out of\n"
+		"an LLTexturePriorityTable.\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		" -t <count>      Textures in the list.  Default:  50000\n"
+		" -p <passes>     Passes timed each way.  Default:  20\n"
+		" -h              print this help\n"
+		<< std::endl;
+}
+
+// Inputs as a scene produces them: most textures on screen at some size,
+// some off screen, some loaded, a few boosted or still waiting for their
+// GL texture
+static void randomize(LLTexturePriorityTable& table, slot_t slot)
+{
+	const S32 boosts[] = { LLGLTexture::BOOST_NONE, LLGLTexture::BOOST_NONE, LLGLTexture::BOOST_NONE,
+						   LLGLTexture::BOOST_AVATAR, LLGLTexture::BOOST_SELECTED, LLGLTexture::BOOST_HIGH,
+						   LLGLTexture::BOOST_SUPER_HIGH, LLGLTexture::BOOST_UI, LLGLTexture::BOOST_ICON };
+	table.setVirtualSize(slot, ll_rand(8) ? ll_frand(1024.f*1024.f) : 0.f);
+	table.setBoostLevel(slot, boosts[ll_rand(LL_ARRAY_SIZE(boosts))]);
+	table.setDiscardLevels(slot, ll_rand(MAX_DISCARD_LEVEL + 2) - 1, ll_rand(MAX_DISCARD_LEVEL + 2));
+	U32 flags = 0;
+	switch (ll_rand(16))
+	{
+	case 0: flags = LLTexturePriorityTable::FULLY_LOADED; break;
+	case 1: flags = LLTexturePriorityTable::MISSING_ASSET; break;
+	case 2: flags = LLTexturePriorityTable::WAITING_CREATE; break;
+	default: break;
+	}
+	table.setFlags(slot, flags);
+}
+
+// The texture side of calcDecodePriority() as the viewer walks it: one
+// heap object per texture, its inputs behind virtual calls and the on
+// screen size taken over its faces.
+class FakeFace
+{
+public:
+	FakeFace(F32 size) : mVirtualSize(size) {}
+	virtual ~FakeFace() {}
+	virtual F32 getVirtualSize() const { return mVirtualSize; }
+private:
+	F32 mVirtualSize;
+	char mPadding[200];
+};
+
+class FakeTexture
+{
+public:
+	virtual ~FakeTexture()
+	{
+		for (FakeFace* face : mFaces)
+		{
+			delete face;
+		}
+	}
+	virtual BOOL isFullyLoaded() const { return mFullyLoaded; }
+	virtual S32 getBoostLevel() const { return mBoostLevel; }
+	virtual S32 getDiscardLevel() const { return mDiscardLevel; }
+	virtual S32 getDesiredDiscardLevel() const { return mDesiredDiscardLevel; }
+
+	F32 calcDecodePriority() const
+	{
+		if (isFullyLoaded())
+		{
+			return -1.f;
+		}
+		F32 virtual_size = 0.f;
+		for (FakeFace* face : mFaces)
+		{
+			virtual_size = llmax(virtual_size, face->getVirtualSize());
+		}
+		const S32 cur = getDiscardLevel();
+		const S32 desired = getDesiredDiscardLevel();
+		if (cur >= 0 && desired >= cur)
+		{
+			return -2.f;
+		}
+		S32 ddiscard = llclamp(cur - desired, -1, 4);
+		return (ddiscard + 1) * 100000.f + llmin(sqrtf(virtual_size), 999.f) + 1000.f * getBoostLevel();
+	}
+
+	std::vector<FakeFace*> mFaces;
+	BOOL mFullyLoaded;
+	S32 mBoostLevel;
+	S32 mDiscardLevel;
+	S32 mDesiredDiscardLevel;
+	char mPadding[400];
+};
+
+int main(int argc, char** argv)
+{
+	S32 texture_count = 50000;
+	S32 passes = 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-t" && i + 1 < argc)
+		{
+			texture_count = llmax(atoi(argv[++i]), 1);
+		}
+		else if (arg == "-p" && i + 1 < argc)
+		{
+			passes = llmax(atoi(argv[++i]), 1);
+		}
+		else
+		{
+			usage(std::cerr);
+			return arg == "-h" ? 0 : 1;
+		}
+	}
+
+	LLTexturePriorityTable table;
+	std::vector<FakeTexture*> textures;
+	for (S32 i = 0; i < texture_count; i++)
+	{
+		randomize(table, table.add(NULL));
+
+		FakeTexture* texture = new FakeTexture;
+		texture->mFullyLoaded = ll_rand(16) == 0;
+		texture->mBoostLevel = ll_rand(3);
+		texture->mDiscardLevel = ll_rand(MAX_DISCARD_LEVEL + 2) - 1;
+		texture->mDesiredDiscardLevel = ll_rand(MAX_DISCARD_LEVEL + 1);
+		for (S32 f = ll_rand(4); f >= 0; f--)
+		{
+			texture->mFaces.push_back(new FakeFace(ll_frand(1024.f*1024.f)));
+		}
+		textures.push_back(texture);
+	}
+	// The texture list is a map keyed by id, visit in an order unrelated
+	// to allocation
+	std::shuffle(textures.begin(), textures.end(), std::mt19937(1234));
+
+	F64 start = LLTimer::getTotalSeconds();
+	F64 sum = 0.0;
+	for (S32 pass = 0; pass < passes; pass++)
+	{
+		for (FakeTexture* texture : textures)
+		{
+			sum += texture->calcDecodePriority();
+		}
+	}
+	F64 object_ms = (LLTimer::getTotalSeconds() - start) * 1000.0 / passes;
+
+	std::vector<slot_t> selected;
+	start = LLTimer::getTotalSeconds();
+	for (S32 pass = 0; pass < passes; pass++)
+	{
+		selected.clear();
+		table.selectChanged(128, selected);
+	}
+	F64 table_ms = (LLTimer::getTotalSeconds() - start) * 1000.0 / passes;
+
+	// The sum keeps the object walk from being optimized away
+	fprintf(stdout, "%d textures, %d passes (%g)\n", texture_count, passes, sum);
+	fprintf(stdout, "  object walk  %8.3f ms per pass\n", object_ms);
+	fprintf(stdout, "  table        %8.3f ms per pass, %.2fx, %u selected\n", table_ms,
+			object_ms / llmax(table_ms, 1e-9), (U32)selected.size());
+
+	for (FakeTexture* texture : textures)
+	{
+		delete texture;
+	}
+	return 0;
+}
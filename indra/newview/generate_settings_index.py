@@ -0,0 +1,113 @@
+# @file generate_settings_index.py
+# @brief Generate the indexed settings enums from app_settings/settings.xml.
+#
+# $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+# Phoenix Firestorm Viewer Source Code
+# Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation;
+# version 2.1 of the License only.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+# The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+# http://www.firestormviewer.org
+# $/LicenseInfo$
+
+# usage: generate_settings_index.py <settings.xml> <output base name>
+#
+# Writes <base>.h with one enum per scalar setting type, the enumerators
+# named after the settings in name order, and <base>.cpp with the names
+# behind them.  LLViewerControlIndex binds the enums to gSavedSettings.
+# Files whose contents would not change are left alone, so that editing a
+# setting's value or comment does not rebuild what includes the header.
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+# settings.xml type, enum, count enumerator, names array
+TYPES = [
+    ("Boolean", "EBool", "BOOL_COUNT", "BOOL_NAMES"),
+    ("S32", "ES32", "S32_COUNT", "S32_NAMES"),
+    ("U32", "EU32", "U32_COUNT", "U32_NAMES"),
+    ("F32", "EF32", "F32_COUNT", "F32_NAMES"),
+]
+
+IDENTIFIER = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+def read_settings(path):
+    root = ET.parse(path).getroot()
+    settings = root.find("map")
+    children = list(settings)
+    by_type = dict((t[0], []) for t in TYPES)
+    seen = set()
+    for key, value in zip(children[0::2], children[1::2]):
+        name = key.text
+        if name in seen:
+            sys.exit("%s: %s is declared twice" % (path, name))
+        seen.add(name)
+        fields = list(value)
+        control_type = None
+        for field, field_value in zip(fields[0::2], fields[1::2]):
+            if field.text == "Type":
+                control_type = field_value.text
+        if control_type in by_type:
+            by_type[control_type].append(name)
+    for names in by_type.values():
+        names.sort()
+    return by_type
+
+def enumerator(name):
+    # A few settings start with a digit
+    return name if IDENTIFIER.match(name) else "_" + name
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, "w") as f:
+        f.write(text)
+
+def main(settings_path, base):
+    by_type = read_settings(settings_path)
+    header_name = os.path.basename(base) + ".h"
+    guard = "LL_" + re.sub(r"[^A-Z0-9]", "_", header_name.upper())
+    notice = "// Generated from app_settings/settings.xml by generate_settings_index.py, do not edit.\n"
+
+    header = [notice, "\n#ifndef %s\n#define %s\n\nnamespace LLSavedSettings\n{\n" % (guard, guard)]
+    for control_type, enum, count, names in TYPES:
+        header.append("\tenum %s\n\t{\n" % enum)
+        for name in by_type[control_type]:
+            header.append("\t\t%s,\n" % enumerator(name))
+        header.append("\t\t%s\n\t};\n\n" % count)
+    for control_type, enum, count, names in TYPES:
+        header.append("\textern const char* const %s[];\n" % names)
+    header.append("}\n\n#endif\n")
+
+    source = [notice, '\n#include "llviewerprecompiledheaders.h"\n#include "%s"\n\nnamespace LLSavedSettings\n{\n' % header_name]
+    for control_type, enum, count, names in TYPES:
+        source.append("\tconst char* const %s[] =\n\t{\n" % names)
+        for name in by_type[control_type]:
+            source.append('\t\t"%s",\n' % name)
+        source.append("\t\tnullptr\n\t};\n\n")
+    source.append("}\n")
+
+    write_if_changed(base + ".h", "".join(header))
+    write_if_changed(base + ".cpp", "".join(source))
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("usage: %s <settings.xml> <output base name>" % sys.argv[0])
+    main(sys.argv[1], sys.argv[2])
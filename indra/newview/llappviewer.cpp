@@ -237,6 +237,7 @@
 
 // includes for idle() idleShutdown()
 #include "llviewercontrol.h"
+#include "llviewercontrolindex.h" // <FS:Kadah/> Indexed settings
 #include "lleventnotifier.h"
 #include "llcallbacklist.h"
 #include "lldeferredsounds.h"
@@ -2590,6 +2591,10 @@ bool LLAppViewer::initThreads()
 	//<FS:ND> Image thread pool from CoolVL
 	U32 imageThreads = gSavedSettings.getU32("FSImageDecodeThreads");
 	// </FS:ND>
+	// <FS:Kadah> Intra-image decode threads
+	LLImageJ2C::setDecodeThreads(gSavedSettings.getU32("FSImageDecodeThreadsPerImage"),
+								 gSavedSettings.getU32("FSImageDecodeThreadsPerImageMaxQueue"));
+	// </FS:Kadah>
 
 	// Image decoding
 	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true, imageThreads);
@@ -2978,6 +2983,10 @@ bool LLAppViewer::initConfiguration()
 	}
 	//</FS:Techwolf Lupindo>
 
+	// <FS:Kadah> Every setting is declared now, the user settings loaded later reach the slots through the commit signals
+	gSavedSettingsIndex.bind(gSavedSettings);
+	// </FS:Kadah>
+
 	initStrings(); // setup paths for LLTrans based on settings files only
 	// - set procedural settings
 	// Note: can't use LL_PATH_PER_SL_ACCOUNT for any of these since we haven't logged in yet
@@ -4939,7 +4948,10 @@ U32 LLAppViewer::getObjectCacheVersion()
 {
 	// Viewer object cache version, change if object update
 	// format changes. JC
-	const U32 INDRA_OBJECT_CACHE_VERSION = 15;
+	// <FS:Kadah> Region files are record journals now
+	//const U32 INDRA_OBJECT_CACHE_VERSION = 15;
+	const U32 INDRA_OBJECT_CACHE_VERSION = 16;
+	// </FS:Kadah>
 
 	return INDRA_OBJECT_CACHE_VERSION;
 }
@@ -5053,6 +5065,7 @@ bool LLAppViewer::initCache()
     // LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info);
     LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info, gSavedSettings.getF32("FSDiskCacheHighWaterPercent"), gSavedSettings.getF32("FSDiskCacheLowWaterPercent"));
 	// </FS:Beq>
+    LLDiskCache::getInstance()->setFileHandleLimit(gSavedSettings.getU32("FSAssetFileHandles")); // <FS:Kadah/> Open file handles
 
 	if (!read_only)
 	{
@@ -6129,7 +6142,10 @@ void LLAppViewer::idleNetwork()
 			}
 
 			// Handle per-frame message system processing.
-			lmc.processAcks(gSavedSettings.getF32("AckCollectTime"));
+			// <FS:Kadah> Indexed settings
+			//lmc.processAcks(gSavedSettings.getF32("AckCollectTime"));
+			lmc.processAcks(gSavedSettingsIndex.get(LLSavedSettings::AckCollectTime));
+			// </FS:Kadah>
 		}
 
 #ifdef TIME_THROTTLE_MESSAGES
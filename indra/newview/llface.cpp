@@ -1335,6 +1335,52 @@ void push_for_transform(LLVertexBuffer* buff, U32 source_count, U32 dest_count)
 	}
 }
 
+// <FS:Kadah> Everything getGeometryVolume() does to state outside of this
+// face and its vertex buffer range, so the rest can run on another thread.
+void LLFace::prepareGeometryVolume(const S32 &f, bool force_rebuild)
+{
+	LLVOVolume* vobj = (LLVOVolume*) (LLViewerObject*) mVObjp;
+	LLVolume* volume = vobj ? vobj->getVolume() : NULL;
+	if (!volume || volume->getNumVolumeFaces() <= f || mVertexBuffer.isNull())
+	{
+		return;
+	}
+
+	BOOL full_rebuild = force_rebuild || mDrawablep->isState(LLDrawable::REBUILD_VOLUME);
+	bool rebuild_pos = full_rebuild || mDrawablep->isState(LLDrawable::REBUILD_POSITION);
+	bool rebuild_tcoord = full_rebuild || mDrawablep->isState(LLDrawable::REBUILD_TCOORD);
+
+	if (mDrawablep->isStatic())
+	{
+		setState(GLOBAL);
+	}
+	else
+	{
+		clearState(GLOBAL);
+	}
+
+	const LLTextureEntry* tep = mVObjp->getTE(f);
+	bool gen_tangents = rebuild_pos && mVertexBuffer->hasDataType(LLVertexBuffer::TYPE_TANGENT);
+	if (rebuild_tcoord)
+	{
+		// The draw info is registered before the worker gets to the face.
+		if (isState(TEXTURE_ANIM) && !vobj->mTexAnimMode)
+		{
+			clearState(TEXTURE_ANIM);
+		}
+
+		U8 texgen = tep ? tep->getTexGen() : LLTextureEntry::TEX_GEN_DEFAULT;
+		gen_tangents |= (tep && tep->getBumpmap()) || texgen != LLTextureEntry::TEX_GEN_DEFAULT;
+	}
+
+	// The volume can be shared by several objects being rebuilt at once.
+	if (gen_tangents)
+	{
+		volume->genTangents(f);
+	}
+}
+// </FS:Kadah>
+
 BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 							   const S32 &f,
 								const LLMatrix4& mat_vert_in, const LLMatrix3& mat_norm_in,
@@ -168,6 +168,11 @@ public:
 						const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
 						const U16 &index_offset,
 						bool force_rebuild = false);
+	// <FS:Kadah> Render thread half of a getGeometryVolume() that is run
+	// elsewhere (see LLFaceGeometryBuilder): updates the face state the
+	// draw info code reads and generates the shared volume's tangents.
+	void prepareGeometryVolume(const S32 &f, bool force_rebuild = false);
+	// </FS:Kadah>
 
 	// For avatar
 	U16			 getGeometryAvatar(
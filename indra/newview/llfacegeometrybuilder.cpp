@@ -0,0 +1,182 @@
+/**
+ * @file llfacegeometrybuilder.cpp
+ * @brief Rebuilds the vertex buffer geometry of faces on the "General" thread pool.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfacegeometrybuilder.h"
+
+#include "lldrawable.h"
+#include "llface.h"
+#include "llvertexbuffer.h"
+#include "llviewercontrol.h"
+#include "llvolume.h"
+#include "parallelfor.h"
+#include "pipeline.h"
+
+// The faces of a buffer are packed by one thread, a single buffer has
+// nothing to share.
+static const U32 MIN_PARALLEL_BUFFERS = 2;
+// Packing a face takes one to two microseconds (the synthetic faces of
+// llvertexbuffer_test), posting to a pool thread and hearing back from it 10
+// to 30. With fewer faces the render thread is done before a helper starts.
+static const U32 MIN_PARALLEL_FACES = 16;
+
+LLFaceGeometryBuilder::LLFaceGeometryBuilder()
+{
+}
+
+LLFaceGeometryBuilder::~LLFaceGeometryBuilder()
+{
+	llassert(mJobs.empty());
+}
+
+// static
+bool LLFaceGeometryBuilder::isEnabled()
+{
+	static LLCachedControl<bool> parallel_rebuild(gSavedSettings, "FSParallelGeometryRebuild", false);
+	static LLCachedControl<bool> use_transform_feedback(gSavedSettings, "RenderUseTransformFeedback", false);
+
+	return parallel_rebuild
+		&& !use_transform_feedback
+		&& !gPipeline.hasRenderDebugMask(LLPipeline::RENDER_DEBUG_OCTREE);
+}
+
+void LLFaceGeometryBuilder::add(LLFace* facep, const LLVolume& volume, S32 f,
+								const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
+								U16 index_offset, bool force_rebuild)
+{
+	LLVertexBuffer* buffer = facep->getVertexBuffer();
+	if (!buffer)
+	{
+		return;
+	}
+
+	if (mJobs.empty())
+	{
+		mBuffers.clear(); // from the last run()
+	}
+
+	facep->prepareGeometryVolume(f, force_rebuild);
+
+	Job job;
+	job.mFace = facep;
+	job.mVolume = &volume;
+	job.mTE = f;
+	job.mMatVert = mat_vert;
+	job.mMatNormal = mat_normal;
+	job.mIndexOffset = index_offset;
+	job.mForceRebuild = force_rebuild;
+	job.mSuccess = false;
+
+	U32 i = 0;
+	while (i < mBuffers.size() && mBuffers[i] != buffer)
+	{
+		++i;
+	}
+	if (i == mBuffers.size())
+	{
+		mBuffers.push_back(buffer);
+		mBufferJobs.push_back(job_list_t());
+	}
+	mBufferJobs[i].push_back((U32)mJobs.size());
+	mJobs.push_back(job);
+}
+
+void LLFaceGeometryBuilder::run(std::vector<LLFace*>* failed)
+{
+	if (mJobs.empty())
+	{
+		return;
+	}
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_FACE;
+
+	if (mBuffers.size() < MIN_PARALLEL_BUFFERS || mJobs.size() < MIN_PARALLEL_FACES)
+	{
+		for (const job_list_t& list : mBufferJobs)
+		{
+			runJobs(mJobs, list);
+		}
+	}
+	else
+	{
+		runParallel();
+	}
+
+	for (const Job& job : mJobs)
+	{
+		if (!job.mSuccess && failed)
+		{
+			failed->push_back(job.mFace);
+		}
+	}
+
+	mJobs.clear();
+	mBufferJobs.clear();
+}
+
+void LLFaceGeometryBuilder::runParallel()
+{
+	// Buffers that can't be staged are rebuilt here, before anything runs.
+	std::vector<job_list_t> lists;
+	lists.reserve(mBuffers.size());
+	for (U32 i = 0; i < mBuffers.size(); ++i)
+	{
+		if (mBuffers[i]->stage())
+		{
+			lists.push_back(mBufferJobs[i]);
+		}
+		else
+		{
+			runJobs(mJobs, mBufferJobs[i]);
+		}
+	}
+
+	// Buffers are independent of each other, the faces of one are packed in order
+	LL::parallelFor("General", lists.size(), [this, &lists](size_t i)
+	{
+		runJobs(mJobs, lists[i]);
+	});
+
+	{
+        LL_PROFILE_ZONE_NAMED_CATEGORY_FACE("face geometry - unstage");
+		for (LLVertexBuffer* buffer : mBuffers)
+		{
+			buffer->unstage();
+		}
+	}
+}
+
+// static
+void LLFaceGeometryBuilder::runJobs(std::vector<Job>& jobs, const job_list_t& list)
+{
+	for (U32 index : list)
+	{
+		Job& job = jobs[index];
+		job.mSuccess = job.mFace->getGeometryVolume(*job.mVolume, job.mTE,
+			job.mMatVert, job.mMatNormal, job.mIndexOffset, job.mForceRebuild);
+	}
+}
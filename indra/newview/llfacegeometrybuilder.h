@@ -0,0 +1,95 @@
+/**
+ * @file llfacegeometrybuilder.h
+ * @brief Rebuilds the vertex buffer geometry of faces on the "General" thread pool.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFACEGEOMETRYBUILDER_H
+#define LL_LLFACEGEOMETRYBUILDER_H
+
+#include "v4math.h"
+#include "m3math.h"
+#include "m4math.h"
+
+#include <vector>
+
+class LLFace;
+class LLVolume;
+class LLVertexBuffer;
+
+// Collects the LLFace::getGeometryVolume() calls of a spatial group rebuild
+// and runs them in one go. The faces of one vertex buffer are rebuilt in
+// order by one thread, into a staged copy of the buffer (see
+// LLVertexBuffer::stage()); different buffers are rebuilt in parallel on the
+// "General" pool, with the render thread taking its share. Only the copy of
+// the written ranges into the GL buffers is left to the render thread.
+class LLFaceGeometryBuilder
+{
+public:
+	LLFaceGeometryBuilder();
+	~LLFaceGeometryBuilder();
+
+	// False when faces have to be rebuilt in place, for settings that
+	// rebuild through GL (transform feedback) or debug displays.
+	static bool isEnabled();
+
+	// Queues the rebuild of facep and does the part of it that touches
+	// shared state right away. The matrices are copied, the volume and the
+	// face must stay alive until run().
+	void add(LLFace* facep, const LLVolume& volume, S32 f,
+			 const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
+			 U16 index_offset, bool force_rebuild = false);
+
+	// Rebuilds all queued faces and leaves their buffers mapped, ready for
+	// flush(). Faces whose rebuild failed are added to failed, if given.
+	void run(std::vector<LLFace*>* failed = NULL);
+
+	bool empty() const				{ return mJobs.empty(); }
+	// Buffers written by the last run(), in the order they were first used.
+	const std::vector<LLVertexBuffer*>& getBuffers() const { return mBuffers; }
+
+private:
+	struct Job
+	{
+		LLFace*			mFace;
+		const LLVolume*	mVolume;
+		S32				mTE;
+		LLMatrix4		mMatVert;
+		LLMatrix3		mMatNormal;
+		U16				mIndexOffset;
+		bool			mForceRebuild;
+		bool			mSuccess;
+	};
+	typedef std::vector<U32> job_list_t;
+
+	void runParallel();
+	static void runJobs(std::vector<Job>& jobs, const job_list_t& list);
+
+	std::vector<Job>				mJobs;
+	// Jobs per buffer, in the order the buffers were first used
+	std::vector<LLVertexBuffer*>	mBuffers;
+	std::vector<job_list_t>			mBufferJobs;
+};
+
+#endif // LL_LLFACEGEOMETRYBUILDER_H
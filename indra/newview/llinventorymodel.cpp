@@ -57,6 +57,8 @@
 #include "llcallbacklist.h"
 #include "llvoavatarself.h"
 #include "llgesturemgr.h"
+#include "llsdarena.h" // <FS:Kadah/>
+#include "llinventorycache.h" // <FS:Kadah/>
 #include "llsdserialize.h"
 #include "llsdutil.h"
 #include "bufferarray.h"
@@ -99,6 +101,7 @@ BOOL LLInventoryModel::sFirstTimeInViewer2 = TRUE;
 //BOOL decompress_file(const char* src_filename, const char* dst_filename);
 static const char PRODUCTION_CACHE_FORMAT_STRING[] = "%s.inv.llsd";
 static const char GRID_CACHE_FORMAT_STRING[] = "%s.%s.inv.llsd";
+static const char BINARY_CACHE_EXTENSION[] = ".bin"; // <FS:Kadah/> replaces ".llsd"
 static const char * const LOG_INV("Inventory");
 
 struct InventoryIDPtrLess
@@ -2130,6 +2133,16 @@ std::string LLInventoryModel::getInvCacheAddres(const LLUUID& owner_id)
     return inventory_addr;
 }
 
+// <FS:Kadah> Binary inventory cache
+//static
+std::string LLInventoryModel::getInvBinaryCacheAddres(const LLUUID& owner_id)
+{
+	std::string inventory_addr = getInvCacheAddres(owner_id);
+	inventory_addr.replace(inventory_addr.rfind('.'), std::string::npos, BINARY_CACHE_EXTENSION);
+	return inventory_addr;
+}
+// </FS:Kadah>
+
 void LLInventoryModel::cache(
 	const LLUUID& parent_folder_id,
 	const LLUUID& agent_id)
@@ -2150,12 +2163,28 @@ void LLInventoryModel::cache(
 		items,
 		INCLUDE_TRASH,
 		can_cache);
+    // <FS:Kadah> Binary inventory cache. The other format is removed so a
+    // stale copy of it is never picked up after switching back.
+    std::string binary_filename = getInvBinaryCacheAddres(agent_id);
+    std::string gzip_filename = getInvCacheAddres(agent_id);
+    gzip_filename.append(".gz");
+    if (gSavedSettings.getBOOL("FSBinaryInventoryCache"))
+    {
+        if (saveToCacheFile(binary_filename, categories, items))
+        {
+            LLFile::remove(gzip_filename, ENOENT);
+        }
+        return;
+    }
+    LLFile::remove(binary_filename, ENOENT);
+    // </FS:Kadah>
     // Use temporary file to avoid potential conflicts with other
     // instances (even a 'read only' instance unzips into a file)
     std::string temp_file = gDirUtilp->getTempFilename();
 	saveToFile(temp_file, categories, items);
-    std::string gzip_filename = getInvCacheAddres(agent_id);
-	gzip_filename.append(".gz");
+    // <FS:Kadah/> moved above
+    //std::string gzip_filename = getInvCacheAddres(agent_id);
+	//gzip_filename.append(".gz");
 	if(gzip_file(temp_file, gzip_filename))
 	{
 		LL_DEBUGS(LOG_INV) << "Successfully compressed " << temp_file << " to " << gzip_filename << LL_ENDL;
@@ -2441,6 +2470,15 @@ bool LLInventoryModel::loadSkeleton(
 			LLFile::remove(inventory_filename);
 		}
 
+		// <FS:Kadah> Binary inventory cache
+		inventory_filename = getInvBinaryCacheAddres(owner_id);
+		if (LLFile::isfile(inventory_filename))
+		{
+			LL_INFOS("LLInventoryModel") << "Purging inventory cache file: " << inventory_filename << LL_ENDL;
+			LLFile::remove(inventory_filename);
+		}
+		// </FS:Kadah>
+
 		// also delete library cache if inventory cache is purged, so issues with EEP settings going missing
 		// and bridge objects not being found can be resolved
 		// <FS:Beq> correct OS library owner.
@@ -2460,6 +2498,15 @@ bool LLInventoryModel::loadSkeleton(
 			LLFile::remove(inventory_filename);
 		}
 
+		// <FS:Kadah> Binary inventory cache
+		inventory_filename = getInvBinaryCacheAddres(gInventory.getLibraryOwnerID());
+		if (LLFile::isfile(inventory_filename))
+		{
+			LL_INFOS("LLInventoryModel") << "Purging library cache file: " << inventory_filename << LL_ENDL;
+			LLFile::remove(inventory_filename);
+		}
+		// </FS:Kadah>
+
 		LL_INFOS("LLInventoryModel") << "Clear inventory cache marker removed: " << delete_cache_marker << LL_ENDL;
 		LLFile::remove(delete_cache_marker);
 	}
@@ -2521,7 +2568,13 @@ bool LLInventoryModel::loadSkeleton(
 		const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
 		std::string gzip_filename(inventory_filename);
 		gzip_filename.append(".gz");
-		LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+		// <FS:Kadah> Binary inventory cache, the gzipped LLSD one is only
+		// read when there is no binary cache yet.
+		std::string binary_filename = getInvBinaryCacheAddres(owner_id);
+		bool use_binary_cache = gSavedSettings.getBOOL("FSBinaryInventoryCache") && LLFile::isfile(binary_filename);
+		bool cache_loaded = false;
+		// </FS:Kadah>
+		LLFILE* fp = use_binary_cache ? NULL : LLFile::fopen(gzip_filename, "rb"); // <FS:Kadah/>
 		bool remove_inventory_file = false;
 		if(fp)
 		{
@@ -2540,7 +2593,19 @@ bool LLInventoryModel::loadSkeleton(
 			}
 		}
 		bool is_cache_obsolete = false;
-		if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+		// <FS:Kadah> Binary inventory cache
+		//if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+		if (use_binary_cache)
+		{
+			cat_array_t skeleton(temp_cats.begin(), temp_cats.end());
+			cache_loaded = loadFromCacheFile(binary_filename, skeleton, categories, items, categories_to_update, is_cache_obsolete);
+		}
+		else
+		{
+			cache_loaded = loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete);
+		}
+		if (cache_loaded)
+		// </FS:Kadah>
 		{
 			// We were able to find a cache of files. So, use what we
 			// found to generate a set of categories we should add. We
@@ -2731,7 +2796,10 @@ bool LLInventoryModel::loadSkeleton(
 		{
 			// If out of date, remove the gzipped file too.
 			LL_WARNS(LOG_INV) << "Inv cache out of date, removing" << LL_ENDL;
-			LLFile::remove(gzip_filename);
+			// <FS:Kadah> Binary inventory cache
+			//LLFile::remove(gzip_filename);
+			LLFile::remove(use_binary_cache ? binary_filename : gzip_filename);
+			// </FS:Kadah>
 		}
 		categories.clear(); // will unref and delete entries
 	}
@@ -3193,6 +3261,10 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 
 	std::string line;
 	LLPointer<LLSDParser> parser = new LLSDNotationParser();
+	// <FS:Kadah> Each line is dropped before the next one is parsed, let
+	// them share the same few arena blocks instead of the heap.
+	LLSDArena arena;
+	// </FS:Kadah>
 	while (std::getline(file, line)) 
 	{
 		LLSD s_item;
@@ -3341,6 +3413,100 @@ bool LLInventoryModel::saveToFile(const std::string& filename,
     return true;
 }
 
+// <FS:Kadah> Binary inventory cache
+// static
+bool LLInventoryModel::loadFromCacheFile(const std::string& filename,
+										 const LLInventoryModel::cat_array_t& skeleton,
+										 LLInventoryModel::cat_array_t& categories,
+										 LLInventoryModel::item_array_t& items,
+										 LLInventoryModel::changed_items_t& cats_to_update,
+										 bool& is_cache_obsolete)
+{
+	LL_INFOS(LOG_INV) << "loading inventory from: (" << filename << ")" << LL_ENDL;
+
+	// A damaged or out of date file gets removed like an obsolete LLSD cache.
+	is_cache_obsolete = true;
+	LLInventoryCacheReader reader;
+	if (!reader.open(filename, sCurrentInvCacheVersion))
+	{
+		return false;
+	}
+	is_cache_obsolete = false;
+
+	for (const LLPointer<LLViewerInventoryCategory>& skeleton_cat : skeleton)
+	{
+		S32 index = reader.findCategory(skeleton_cat->getUUID());
+		if (index < 0)
+		{
+			continue;
+		}
+		LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(reader.getCategoryOwnerID(index));
+		reader.loadCategory(index, inv_cat);
+		inv_cat->setVersion(reader.getCategoryVersion(index));
+		categories.push_back(inv_cat);
+		if (inv_cat->getVersion() != skeleton_cat->getVersion())
+		{
+			// loadSkeleton() drops these items, don't decode them.
+			continue;
+		}
+
+		S32 count = reader.getCategoryItemCount(index);
+		for (S32 n = 0; n < count; ++n)
+		{
+			LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
+			if (!reader.loadItem(index, n, inv_item))
+			{
+				continue;
+			}
+			if (inv_item->getUUID().isNull())
+			{
+				LL_WARNS(LOG_INV) << "Ignoring inventory with null item id: "
+					<< inv_item->getName() << LL_ENDL;
+			}
+			else if (inv_item->getType() == LLAssetType::AT_UNKNOWN)
+			{
+				cats_to_update.insert(inv_item->getParentUUID());
+			}
+			else
+			{
+				items.push_back(inv_item);
+			}
+		}
+	}
+	return true;
+}
+
+// static
+bool LLInventoryModel::saveToCacheFile(const std::string& filename,
+									   const cat_array_t& categories,
+									   const item_array_t& items)
+{
+	LL_INFOS(LOG_INV) << "saving inventory to: (" << filename << ")" << LL_ENDL;
+
+	LLInventoryCacheWriter writer(sCurrentInvCacheVersion);
+	for (const LLPointer<LLViewerInventoryCategory>& cat : categories)
+	{
+		if (cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
+		{
+			writer.addCategory(cat, cat->getOwnerID(), cat->getVersion());
+		}
+	}
+	for (const LLPointer<LLViewerInventoryItem>& item : items)
+	{
+		writer.addItem(item);
+	}
+	if (!writer.write(filename))
+	{
+		LL_WARNS(LOG_INV) << "Unable to save inventory to: " << filename << LL_ENDL;
+		return false;
+	}
+
+	LL_INFOS(LOG_INV) << "Inventory saved: " << writer.getWrittenCategoryCount() << " categories, "
+					  << writer.getWrittenItemCount() << " items." << LL_ENDL;
+	return true;
+}
+// </FS:Kadah>
+
 // message handling functionality
 // static
 void LLInventoryModel::registerCallbacks(LLMessageSystem* msg)
@@ -205,6 +205,7 @@ public:
 	void createCommonSystemCategories();
 
 	static std::string getInvCacheAddres(const LLUUID& owner_id);
+	static std::string getInvBinaryCacheAddres(const LLUUID& owner_id); // <FS:Kadah/>
 
 	// Call on logout to save a terse representation.
 	void cache(const LLUUID& parent_folder_id, const LLUUID& agent_id);
@@ -716,6 +717,19 @@ protected:
 	static bool saveToFile(const std::string& filename,
 						   const cat_array_t& categories,
 						   const item_array_t& items); 
+	// <FS:Kadah> Binary cache, see LLInventoryCacheReader. Only the cached
+	// categories that are also in the skeleton are materialised, and only
+	// the items of those whose version is still current.
+	static bool loadFromCacheFile(const std::string& filename,
+								  const cat_array_t& skeleton,
+								  cat_array_t& categories,
+								  item_array_t& items,
+								  changed_items_t& cats_to_update,
+								  bool& is_cache_obsolete);
+	static bool saveToCacheFile(const std::string& filename,
+								const cat_array_t& categories,
+								const item_array_t& items);
+	// </FS:Kadah>
 
 	//--------------------------------------------------------------------
 	// Message handling functionality
@@ -44,12 +44,15 @@
 #include "llimagej2c.h"
 #include "llhost.h"
 #include "llmath.h"
+#include "llmeshdecodepipeline.h" // <FS:Kadah/> Mesh decode pipeline
+#include "llmeshlodcache.h" // <FS:Kadah/> Decoded mesh LOD cache
 #include "llnotificationsutil.h"
 #include "llsd.h"
 #include "llsdutil_math.h"
 #include "llsdserialize.h"
 #include "llthread.h"
 #include "llfilesystem.h"
+#include "lldiskcache.h" // <FS:Kadah/> Decoded mesh LOD cache
 #include "llviewercontrol.h"
 #include "llviewerinventory.h"
 #include "llviewermenufile.h"
@@ -231,6 +234,9 @@
 //     sCacheBytesWritten              "
 //     sCacheReads                     "
 //     sCacheWrites                    "
+//     sLODCacheHits                   none            rw.main.none <FS:Kadah/> Decoded mesh LOD cache
+//     sLODCacheMisses                 "
+//     sLODCacheSecondsSaved           "
 //     mLoadingMeshes                  mMeshMutex [4]  rw.main.none, rw.any.mMeshMutex
 //     mSkinMap                        none            rw.main.none
 //     mDecompositionMap               none            rw.main.none
@@ -405,6 +411,11 @@ U32 LLMeshRepository::sCacheBytesSkins = 0;
 U32 LLMeshRepository::sCacheBytesDecomps = 0;
 U32 LLMeshRepository::sCacheReads = 0;
 U32 LLMeshRepository::sCacheWrites = 0;
+// <FS:Kadah> Decoded mesh LOD cache
+U32 LLMeshRepository::sLODCacheHits = 0;
+U32 LLMeshRepository::sLODCacheMisses = 0;
+F64 LLMeshRepository::sLODCacheSecondsSaved = 0.0;
+// </FS:Kadah>
 U32 LLMeshRepository::sMaxLockHoldoffs = 0;
 	
 LLDeadmanTimer LLMeshRepository::sQuiescentTimer(15.0, false);	// true -> gather cpu metrics
@@ -847,6 +858,83 @@ void log_upload_error(LLCore::HttpStatus status, const LLSD& content,
 	gMeshRepo.uploadError(args);
 }
 
+// <FS:Kadah> Decoded mesh LOD cache
+// Decoded LODs sit next to the assets, so the disk cache purges them too.
+static std::string mesh_lod_cache_path(const LLUUID& mesh_id, S32 lod)
+{
+	return LLDiskCache::getInstance()->metaDataToFilepath(mesh_id.asString(), LLAssetType::AT_MESH, llformat("lod%d", lod));
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Mesh decode pipeline
+// Runs on the decode workers once a LOD block has been decoded.
+static bool on_lod_decoded(LLMeshRepoThread* thread, const LLMeshDecodePipeline::Request& request, const LLVolume* volume)
+{
+	const LLUUID& mesh_id = request.mMeshParams.getSculptID();
+	if (volume)
+	{
+		if (request.mSource == LLMeshDecodePipeline::SOURCE_NETWORK)
+		{
+			// good fetch from sim, write to cache
+			LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+			S32 size = (S32)request.mData.size();
+			if (file.getSize() >= request.mOffset + size)
+			{
+				file.seek(request.mOffset);
+				file.write(&request.mData[0], size);
+				LLMeshRepository::sCacheBytesWritten += size;
+				++LLMeshRepository::sCacheWrites;
+			}
+		}
+		if (request.mSource == LLMeshDecodePipeline::SOURCE_LOD_CACHE)
+		{
+			LLDiskCache::getInstance()->updateFileAccessTime(mesh_lod_cache_path(mesh_id, request.mLOD));
+		}
+		// <FS:Kadah> Disk cache index
+		else if (thread->mDecodePipeline->getLODCache())
+		{
+			// Decoded LODs are stored behind LLFileSystem's back
+			const std::string lod_path = mesh_lod_cache_path(mesh_id, request.mLOD);
+			llstat lod_stat;
+			if (LLFile::stat(lod_path, &lod_stat) == 0)
+			{
+				LLDiskCache::getInstance()->updateFileSize(lod_path, lod_stat.st_size);
+			}
+		}
+		// </FS:Kadah>
+		return true;
+	}
+
+	if (request.mSource == LLMeshDecodePipeline::SOURCE_LOD_CACHE)
+	{
+		// The pipeline dropped the stale entry, load the LOD the long way.
+		LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Decoded LOD " << request.mLOD << " for ID " << mesh_id
+							<< " is stale, reloading." << LL_ENDL;
+		LLDiskCache::getInstance()->removeFileEntry(mesh_lod_cache_path(mesh_id, request.mLOD)); // <FS:Kadah/> Disk cache index
+		thread->lockAndLoadMeshLOD(request.mMeshParams, request.mLOD);
+		return false;
+	}
+
+	if (request.mSource == LLMeshDecodePipeline::SOURCE_ASSET_CACHE)
+	{
+		// Reading from the cache failed, fetch from the sim instead. The cached
+		// asset stays, the other blocks in it may be fine and the response
+		// overwrites this one.
+		LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " LOD " << request.mLOD
+							<< " did not decode, refetching." << LL_ENDL;
+		thread->lockAndLoadMeshLOD(request.mMeshParams, request.mLOD, true);
+		return false;
+	}
+
+	LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mesh_id
+					   << " LOD: " << request.mLOD
+					   << " Data size: " << request.mData.size()
+					   << " Not retrying."
+					   << LL_ENDL;
+	return true; // notifyLoadedMeshes() marks it unavailable
+}
+// </FS:Kadah>
+
 LLMeshRepoThread::LLMeshRepoThread()
 : LLThread("mesh repo"),
   mHttpRequest(NULL),
@@ -857,7 +945,8 @@ LLMeshRepoThread::LLMeshRepoThread()
   mHttpLegacyPolicyClass(LLCore::HttpRequest::DEFAULT_POLICY_ID), // <FS:Ansariel> [UDP Assets]
   mHttpLargePolicyClass(LLCore::HttpRequest::DEFAULT_POLICY_ID),
   mLegacyGetMeshVersion(0), // <FS:Ansariel> [UDP Assets]
-  mHttpPriority(0)
+  mHttpPriority(0),
+  mDecodePipeline(NULL) // <FS:Kadah/> Mesh decode pipeline
 {
 	LLAppCoreHttp & app_core_http(LLAppViewer::instance()->getAppCoreHttp());
 
@@ -876,6 +965,28 @@ LLMeshRepoThread::LLMeshRepoThread()
 	mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
 	mHttpLegacyPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH1); // <FS:Ansariel> [UDP Assets]
 	mHttpLargePolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_LARGE_MESH);
+
+	// <FS:Kadah> Mesh decode pipeline
+	LLSD pool_sizes{ gSavedSettings.getLLSD("ThreadPoolSizes") };
+	LLSD size_spec{ pool_sizes["MeshDecode"] };
+	S32 decode_threads = size_spec.isInteger() ? size_spec.asInteger() : 2;
+	if (decode_threads > 0)
+	{
+		LL_INFOS(LOG_MESH) << "Decoding meshes on " << decode_threads << " threads" << LL_ENDL;
+		mDecodePipeline = new LLMeshDecodePipeline("MeshDecode", decode_threads, gSavedSettings.getBOOL("FSMeshDecodeOctrees"),
+												   [this](const LLMeshDecodePipeline::Request& request, const LLVolume* volume)
+												   {
+													   return on_lod_decoded(this, request, volume);
+												   });
+		// <FS:Kadah> Decoded mesh LOD cache
+		if (gSavedSettings.getBOOL("FSMeshLODCache"))
+		{
+			mDecodePipeline->setLODCache(new LLMeshLODCache(mesh_lod_cache_path));
+		}
+		// </FS:Kadah>
+		mDecodePipeline->start();
+	}
+	// </FS:Kadah>
 }
 
 
@@ -886,6 +997,11 @@ LLMeshRepoThread::~LLMeshRepoThread()
 					   << ", Max Lock Holdoffs:  " << LLMeshRepository::sMaxLockHoldoffs
 					   << LL_ENDL;
 
+	// <FS:Kadah> Mesh decode pipeline: the workers use the mutexes below
+	delete mDecodePipeline;
+	mDecodePipeline = NULL;
+	// </FS:Kadah>
+
 	mHttpRequestSet.clear();
     mHttpHeaders.reset();
 
@@ -973,7 +1089,10 @@ void LLMeshRepoThread::run()
                     // failed to load before, wait a bit
                     incomplete.push_front(req);
                 }
-                else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry()))
+                // <FS:Kadah> Mesh decode pipeline
+                //else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry()))
+                else if (!fetchMeshLOD(req.mMeshParams, req.mLOD, req.canRetry(), req.mSkipCache))
+                // </FS:Kadah>
                 {
                     if (req.canRetry())
                     {
@@ -1210,16 +1329,23 @@ void LLMeshRepoThread::loadMeshPhysicsShape(const LLUUID& mesh_id)
 	mPhysicsShapeRequests.insert(UUIDBasedRequest(mesh_id));
 }
 
-void LLMeshRepoThread::lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
+// <FS:Kadah> Mesh decode pipeline
+//void LLMeshRepoThread::lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
+void LLMeshRepoThread::lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool skip_cache)
+// </FS:Kadah>
 {
 	if (!LLAppViewer::isExiting())
 	{
-		loadMeshLOD(mesh_params, lod);
+		//loadMeshLOD(mesh_params, lod);
+		loadMeshLOD(mesh_params, lod, skip_cache); // <FS:Kadah> Mesh decode pipeline
 	}
 }
 
 
-void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
+// <FS:Kadah> Mesh decode pipeline
+//void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
+void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool skip_cache)
+// </FS:Kadah>
 { //could be called from any thread
 	const LLUUID& mesh_id = mesh_params.getSculptID();
 	LLMutexLock lock(mMutex);
@@ -1228,7 +1354,8 @@ void LLMeshRepoThread::loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
 	if (iter != mMeshHeader.end())
 	{ //if we have the header, request LOD byte range
 
-		LODRequest req(mesh_params, lod);
+		//LODRequest req(mesh_params, lod);
+		LODRequest req(mesh_params, lod, skip_cache); // <FS:Kadah> Mesh decode pipeline
 		{
 			mLODReqQ.push(req);
 			LLMeshRepository::sLODProcessing++;
@@ -1831,7 +1958,10 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params, bool c
 }
 
 //return false if failed to get mesh lod.
-bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry)
+// <FS:Kadah> Mesh decode pipeline
+//bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry)
+bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry, bool skip_cache)
+// </FS:Kadah>
 {
 	if (!mHeaderMutex)
 	{
@@ -1861,10 +1991,20 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 				
 		if (version <= MAX_MESH_VERSION && offset >= 0 && size > 0)
 		{
+			// <FS:Kadah> Decoded mesh LOD cache
+			if (!skip_cache && queueLODCacheLoad(mesh_params, lod, offset, size))
+			{
+				LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the LOD cache." << LL_ENDL;
+				return true;
+			}
+			// </FS:Kadah>
 
 			//check cache for mesh asset
 			LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
-			if (file.getSize() >= offset+size)
+			// <FS:Kadah> Mesh decode pipeline
+			//if (file.getSize() >= offset+size)
+			if (!skip_cache && file.getSize() >= offset+size)
+			// </FS:Kadah>
 			{
 				U8* buffer = new(std::nothrow) U8[size];
 				if (!buffer)
@@ -1886,6 +2026,15 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 					zero = buffer[i] > 0 ? false : true;
 				}
 
+				// <FS:Kadah> Mesh decode pipeline
+				if (!zero && queueLODDecode(mesh_params, lod, buffer, size, offset, true))
+				{
+					delete[] buffer;
+					LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
+					return true;
+				}
+				// </FS:Kadah>
+
 				if (!zero)
 				{ //attempt to parse
 					if (lodReceived(mesh_params, lod, buffer, size) == MESH_OK)
@@ -1975,9 +2124,14 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
 
 		data_size = dsize;
 
-		boost::iostreams::stream<boost::iostreams::array_source> stream(result_ptr, data_size);
-
-		if (!LLSDSerialize::fromBinary(header, stream, data_size))
+		// <FS:Kadah> Parse the header in place
+		//boost::iostreams::stream<boost::iostreams::array_source> stream(result_ptr, data_size);
+		//
+		//if (!LLSDSerialize::fromBinary(header, stream, data_size))
+		size_t header_bytes = 0;
+		LLPointer<LLSDBinaryParser> parser = new LLSDBinaryParser;
+		if (!parser->parseBuffer((const U8*)result_ptr, data_size, header, data_size, -1, &header_bytes))
+		// </FS:Kadah>
 		{
 			LL_WARNS(LOG_MESH) << "Mesh header parse error.  Not a valid mesh asset!  ID:  " << mesh_id
 							   << LL_ENDL;
@@ -1998,7 +2152,7 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
 		// make sure there is at least one lod, function returns -1 and marks as 404 otherwise
 		else if (LLMeshRepository::getActualMeshLOD(header, 0) >= 0)
 		{
-			header_size += stream.tellg();
+			header_size += (U32)header_bytes; // <FS:Kadah/> was stream.tellg()
 		}
 	}
 	else
@@ -2036,6 +2190,44 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
 	return MESH_OK;
 }
 
+// <FS:Kadah> Mesh decode pipeline
+bool LLMeshRepoThread::queueLODDecode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, S32 offset, bool from_cache)
+{
+	if (!mDecodePipeline || !data || data_size <= 0)
+	{
+		return false;
+	}
+
+	LLMeshDecodePipeline::Request request;
+	request.mMeshParams = mesh_params;
+	request.mLOD = lod;
+	request.mData.assign(data, data + data_size);
+	request.mOffset = offset;
+	request.mSourceSize = data_size;
+	request.mSource = from_cache ? LLMeshDecodePipeline::SOURCE_ASSET_CACHE : LLMeshDecodePipeline::SOURCE_NETWORK;
+	return mDecodePipeline->post(request);
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Decoded mesh LOD cache
+bool LLMeshRepoThread::queueLODCacheLoad(const LLVolumeParams& mesh_params, S32 lod, S32 offset, S32 size)
+{
+	if (!mDecodePipeline || !mDecodePipeline->getLODCache()
+		|| !mDecodePipeline->getLODCache()->exists(mesh_params.getSculptID(), lod))
+	{
+		return false;
+	}
+
+	LLMeshDecodePipeline::Request request;
+	request.mMeshParams = mesh_params;
+	request.mLOD = lod;
+	request.mOffset = offset;
+	request.mSourceSize = size;
+	request.mSource = LLMeshDecodePipeline::SOURCE_LOD_CACHE;
+	return mDecodePipeline->post(request);
+}
+// </FS:Kadah>
+
 EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
 {
 	if (data == NULL || data_size == 0)
@@ -2980,6 +3172,41 @@ void LLMeshRepoThread::notifyLoadedMeshes()
 		return;
 	}
 
+	// <FS:Kadah> Mesh decode pipeline
+	if (mDecodePipeline && mDecodePipeline->getPendingCount() > 0)
+	{
+		std::vector<LLMeshDecodePipeline::Result> decoded;
+		while (mDecodePipeline->popResults(decoded) > 0)
+		{
+		}
+		update_metrics = update_metrics || !decoded.empty();
+
+		const bool lod_cache = mDecodePipeline->getLODCache() != NULL; // <FS:Kadah/> Decoded mesh LOD cache
+		for (const LLMeshDecodePipeline::Result& result : decoded)
+		{
+			if (result.mVolume.notNull())
+			{
+				// <FS:Kadah> Decoded mesh LOD cache
+				if (result.mSource == LLMeshDecodePipeline::SOURCE_LOD_CACHE)
+				{
+					++LLMeshRepository::sLODCacheHits;
+					LLMeshRepository::sLODCacheSecondsSaved += result.mSecondsSaved;
+				}
+				else if (lod_cache)
+				{
+					++LLMeshRepository::sLODCacheMisses;
+				}
+				// </FS:Kadah>
+				gMeshRepo.notifyMeshLoaded(result.mMeshParams, result.mVolume);
+			}
+			else
+			{
+				gMeshRepo.notifyMeshUnavailable(result.mMeshParams, result.mLOD);
+			}
+		}
+	}
+	// </FS:Kadah>
+
 	if (!mLoadedQ.empty())
 	{
 		std::deque<LoadedMesh> loaded_queue;
@@ -3441,6 +3668,13 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
 	if ((!MESH_LOD_PROCESS_FAILED)
 		&& ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
 	{
+		// <FS:Kadah> Mesh decode pipeline: the workers write the cache once the block decoded
+		if (gMeshRepo.mThread->queueLODDecode(mMeshParams, mLOD, data, data_size, mOffset, false))
+		{
+			return;
+		}
+		// </FS:Kadah>
+
 		EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size);
 		if (result == MESH_OK)
 		{
@@ -4247,7 +4481,11 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
 			LLVolume* sys_volume = LLPrimitive::getVolumeManager()->refVolume(mesh_params, detail);
 			if (sys_volume)
 			{
-				sys_volume->copyVolumeFaces(volume);
+				// <FS:Kadah> Mesh decode pipeline: volume is a throwaway, move its
+				// faces over so the octrees built by the decode workers survive.
+				//sys_volume->copyVolumeFaces(volume);
+				sys_volume->swapVolumeFaces(volume);
+				// </FS:Kadah>
 				sys_volume->setMeshAssetLoaded(TRUE);
 				LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
 			}
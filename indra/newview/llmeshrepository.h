@@ -194,6 +194,8 @@ private:
     LLFrameTimer mTimer;
 };
 
+class LLMeshDecodePipeline; // <FS:Kadah/> Mesh decode pipeline
+
 class LLMeshRepoThread : public LLThread
 {
 public:
@@ -235,9 +237,14 @@ public:
 		LLVolumeParams  mMeshParams;
 		S32 mLOD;
 		F32 mScore;
-
-		LODRequest(const LLVolumeParams&  mesh_params, S32 lod)
-			: RequestStats(), mMeshParams(mesh_params), mLOD(lod), mScore(0.f)
+		bool mSkipCache; // <FS:Kadah/> Mesh decode pipeline, the cached copy did not decode
+
+		// <FS:Kadah> Mesh decode pipeline
+		//LODRequest(const LLVolumeParams&  mesh_params, S32 lod)
+		//	: RequestStats(), mMeshParams(mesh_params), mLOD(lod), mScore(0.f)
+		LODRequest(const LLVolumeParams&  mesh_params, S32 lod, bool skip_cache = false)
+			: RequestStats(), mMeshParams(mesh_params), mLOD(lod), mScore(0.f), mSkipCache(skip_cache)
+		// </FS:Kadah>
 		{
 		}
 	};
@@ -314,6 +321,13 @@ public:
 	typedef boost::unordered_map<LLUUID, std::vector<S32> > pending_lod_map;
 	pending_lod_map mPendingLOD;
 
+	// <FS:Kadah> Mesh decode pipeline. When set, LOD blocks are decoded on
+	// its workers instead of by lodReceived(), and the finished volumes are
+	// picked up by notifyLoadedMeshes() from a lock free queue rather than
+	// through mLoadedQ and mMutex.
+	LLMeshDecodePipeline* mDecodePipeline;
+	// </FS:Kadah>
+
 	// llcorehttp library interface objects.
 	LLCore::HttpStatus					mHttpStatus;
 	LLCore::HttpRequest *				mHttpRequest;
@@ -340,13 +354,29 @@ public:
 
 	virtual void run();
 
-	void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
-	void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
+	// <FS:Kadah> Mesh decode pipeline. skip_cache fetches the LOD from the
+	// sim even when the asset cache holds it.
+	//void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
+	//void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
+	void lockAndLoadMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool skip_cache = false);
+	void loadMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool skip_cache = false);
+	// </FS:Kadah>
 
 	bool fetchMeshHeader(const LLVolumeParams& mesh_params, bool can_retry = true);
-	bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
+	// <FS:Kadah> Mesh decode pipeline
+	//bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
+	bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true, bool skip_cache = false);
+	// </FS:Kadah>
 	EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
 	EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+	// <FS:Kadah> Mesh decode pipeline. Hands a LOD block to the decode
+	// workers; false if there are none and lodReceived() has to do it.
+	bool queueLODDecode(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size, S32 offset, bool from_cache);
+	// </FS:Kadah>
+	// <FS:Kadah> Decoded mesh LOD cache. Hands a LOD that was decoded
+	// before to the decode workers; false if it is not in the cache.
+	bool queueLODCacheLoad(const LLVolumeParams& mesh_params, S32 lod, S32 offset, S32 size);
+	// </FS:Kadah>
 	bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
 	bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
 	EMeshProcessingResult physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -578,6 +608,11 @@ public:
     static U32 sCacheBytesDecomps;
 	static U32 sCacheReads;						
 	static U32 sCacheWrites;
+	// <FS:Kadah> Decoded mesh LOD cache
+	static U32 sLODCacheHits;
+	static U32 sLODCacheMisses;					// LODs decoded from zipped data while the cache was on
+	static F64 sLODCacheSecondsSaved;			// decode time the hits did not spend
+	// </FS:Kadah>
 	static U32 sMaxLockHoldoffs;				// Maximum sequential locking failures
 	
 	static LLDeadmanTimer sQuiescentTimer;		// Time-to-complete-mesh-downloads after significant events
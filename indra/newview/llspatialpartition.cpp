@@ -418,6 +418,7 @@ void LLSpatialGroup::shift(const LLVector4a &offset)
 	mOctreeNode->setCenter(t);
 	mOctreeNode->updateMinMax();
 	mBounds[0].add(offset);
+	writeCullBounds(); // <FS:Kadah/> Flat frustum culling
 	mExtents[0].add(offset);
 	mExtents[1].add(offset);
 	mObjectBounds[0].add(offset);
@@ -758,6 +759,7 @@ void LLSpatialGroup::handleRemoval(const TreeNode* node, LLViewerOctreeEntry* en
 
 void LLSpatialGroup::handleDestruction(const TreeNode* node)
 {
+	releaseCullBounds(); // <FS:Kadah/> Flat frustum culling
 	if(isDead())
 	{
 		return;
@@ -56,6 +56,7 @@ class LLSpatialPartition;
 class LLSpatialBridge;
 class LLSpatialGroup;
 class LLViewerRegion;
+class LLFaceGeometryBuilder; // <FS:Kadah/>
 
 void pushVerts(LLFace* face, U32 mask);
 //<FS:BEQ> Make helper functions externally visible for use from viewerwindow
@@ -663,7 +664,10 @@ class LLVolumeGeometryManager: public LLGeometryManager
 	virtual void rebuildMesh(LLSpatialGroup* group);
 	virtual void getGeometry(LLSpatialGroup* group);
     virtual void addGeometryCount(LLSpatialGroup* group, U32& vertex_count, U32& index_count);
-	U32 genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort = FALSE, BOOL batch_textures = FALSE, BOOL rigged = FALSE);
+	// <FS:Kadah> Face geometry can be left to a builder, run after the last batch
+	//U32 genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort = FALSE, BOOL batch_textures = FALSE, BOOL rigged = FALSE);
+	U32 genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort = FALSE, BOOL batch_textures = FALSE, BOOL rigged = FALSE, LLFaceGeometryBuilder* builder = NULL);
+	// </FS:Kadah>
 	void registerFace(LLSpatialGroup* group, LLFace* facep, U32 type);
 
 private:
@@ -894,6 +894,10 @@ bool idle_startup()
 				msg->mPacketRing.setUseOutThrottle(TRUE);
 				msg->mPacketRing.setOutBandwidth(outBandwidth);
 			}
+
+			// <FS:Kadah> Batched UDP I/O
+			msg->mPacketRing.setUseBatching(gSavedSettings.getBOOL("FSBatchedUDP"));
+			// </FS:Kadah>
 		}
 
 		LL_INFOS("AppInit") << "Message System Initialized." << LL_ENDL;
@@ -44,6 +44,7 @@
 #include "llviewercontrol.h"
 #include "llviewertexture.h"
 #include "llsurfacepatch.h"
+#include "llsurfacekernels.h" // <FS:Kadah/> Dirty rect terrain updates
 #include "llvosurfacepatch.h"
 #include "llvowater.h"
 #include "pipeline.h"
@@ -870,41 +871,140 @@ BOOL LLSurface::idleUpdate(F32 max_update_time)
 
 void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL b_large_patch) 
 {
+	// <FS:Kadah> Background terrain decoding
+	DecodedPatches decoded;
+	decodeDCTPatches(bitpack, *gopp, b_large_patch, bitpack.mMaxSize, decoded);
+	applyDecodedPatches(decoded, b_large_patch);
+//
+//	LLPatchHeader  ph;
+//	S32 j, i;
+//	S32 patch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+//	LLSurfacePatch *patchp;
+//
+//	init_patch_decompressor(gopp->patch_size);
+//	gopp->stride = mGridsPerEdge;
+//	set_group_of_patch_header(gopp);
+//
+//	while (1)
+//	{
+//// <FS:CR> Aurora Sim
+//		//decode_patch_header(bitpack, &ph);
+//		decode_patch_header(bitpack, &ph, b_large_patch);
+//// </FS:CR> Aurora Sim
+//		if (ph.quant_wbits == END_OF_PATCHES)
+//		{
+//			break;
+//		}
+//
+//// <FS:CR> Aurora Sim
+//		//i = ph.patchids >> 5;
+//		//j = ph.patchids & 0x1F;
+//		if (b_large_patch)
+//		{
+//			i = ph.patchids >> 16; //x
+//			j = ph.patchids & 0xFFFF; //y
+//		}
+//		else
+//		{
+//			i = ph.patchids >> 5; //x
+//			j = ph.patchids & 0x1F; //y
+//		}
+//// </FS:CR> Aurora Sim
+//
+//		if ((i >= mPatchesPerEdge) || (j >= mPatchesPerEdge))
+//		{
+//			LL_WARNS() << "Received invalid terrain packet - patch header patch ID incorrect!" 
+//				<< " patches per edge " << mPatchesPerEdge
+//				<< " i " << i
+//				<< " j " << j
+//				<< " dc_offset " << ph.dc_offset
+//				<< " range " << (S32)ph.range
+//				<< " quant_wbits " << (S32)ph.quant_wbits
+//				<< " patchids " << (S32)ph.patchids
+//				<< LL_ENDL;
+//			return;
+//		}
+//
+//		patchp = &mPatchList[j*mPatchesPerEdge + i];
+//
+//
+//		decode_patch(bitpack, patch);
+//		decompress_patch(patchp->getDataZ(), patch, &ph);
+//
+//		// Update edges for neighbors.  Need to guarantee that this gets done before we generate vertical stats.
+//		patchp->updateNorthEdge();
+//		patchp->updateEastEdge();
+//		if (patchp->getNeighborPatch(WEST))
+//		{
+//			patchp->getNeighborPatch(WEST)->updateEastEdge();
+//		}
+//		if (patchp->getNeighborPatch(SOUTHWEST))
+//		{
+//			patchp->getNeighborPatch(SOUTHWEST)->updateEastEdge();
+//			patchp->getNeighborPatch(SOUTHWEST)->updateNorthEdge();
+//		}
+//		if (patchp->getNeighborPatch(SOUTH))
+//		{
+//			patchp->getNeighborPatch(SOUTH)->updateNorthEdge();
+//		}
+//
+//		// Dirty patch statistics, and flag that the patch has data.
+//		patchp->dirtyZ();
+//		patchp->setHasReceivedData();
+//	}
+	// </FS:Kadah>
+}
 
-	LLPatchHeader  ph;
-	S32 j, i;
-	S32 patch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
-	LLSurfacePatch *patchp;
-
-	init_patch_decompressor(gopp->patch_size);
-	gopp->stride = mGridsPerEdge;
-	set_group_of_patch_header(gopp);
+// <FS:Kadah> Background terrain decoding
+//static
+void LLSurface::decodeDCTPatches(LLBitPack &bitpack, const LLGroupHeader &gopp, BOOL b_large_patch,
+								 U32 data_size, DecodedPatches &decoded)
+{
+	const S32 size = gopp.patch_size;
+	if (size != NORMAL_PATCH_SIZE && size != LARGE_PATCH_SIZE)
+	{
+		LL_WARNS() << "Received invalid terrain packet - patch size " << size << LL_ENDL;
+		return;
+	}
+	decoded.mPatchSize = size;
 
-	while (1)
+	LLPatchHeader ph;
+	S32 patch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
+	// Stop at the end of the packet rather than read past it.
+	while (bitpack.mBufferSize < data_size)
 	{
-// <FS:CR> Aurora Sim
-		//decode_patch_header(bitpack, &ph);
-		decode_patch_header(bitpack, &ph, b_large_patch);
-// </FS:CR> Aurora Sim
+		unpack_patch_header(bitpack, &ph, b_large_patch);
 		if (ph.quant_wbits == END_OF_PATCHES)
 		{
 			break;
 		}
 
-// <FS:CR> Aurora Sim
-		//i = ph.patchids >> 5;
-		//j = ph.patchids & 0x1F;
+		unpack_patch(bitpack, patch, size, (ph.quant_wbits & 0xf) + 2);
+		decoded.mPatchIDs.push_back(ph.patchids);
+		decoded.mHeights.resize(decoded.mHeights.size() + size*size);
+		decompress_patch_block(&decoded.mHeights[decoded.mHeights.size() - size*size], size, size, patch, &ph);
+	}
+}
+
+void LLSurface::applyDecodedPatches(const DecodedPatches &decoded, BOOL b_large_patch)
+{
+	S32 j, i;
+	LLSurfacePatch *patchp;
+	const S32 size = decoded.mPatchSize;
+
+	for (size_t k = 0; k < decoded.mPatchIDs.size(); k++)
+	{
+		const U32 patchids = decoded.mPatchIDs[k];
 		if (b_large_patch)
 		{
-			i = ph.patchids >> 16; //x
-			j = ph.patchids & 0xFFFF; //y
+			i = patchids >> 16; //x
+			j = patchids & 0xFFFF; //y
 		}
 		else
 		{
-			i = ph.patchids >> 5; //x
-			j = ph.patchids & 0x1F; //y
+			i = patchids >> 5; //x
+			j = patchids & 0x1F; //y
 		}
-// </FS:CR> Aurora Sim
 
 		if ((i >= mPatchesPerEdge) || (j >= mPatchesPerEdge))
 		{
@@ -912,42 +1012,56 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL
 				<< " patches per edge " << mPatchesPerEdge
 				<< " i " << i
 				<< " j " << j
-				<< " dc_offset " << ph.dc_offset
-				<< " range " << (S32)ph.range
-				<< " quant_wbits " << (S32)ph.quant_wbits
-				<< " patchids " << (S32)ph.patchids
+				<< " patchids " << (S32)patchids
 				<< LL_ENDL;
 			return;
 		}
 
 		patchp = &mPatchList[j*mPatchesPerEdge + i];
 
-
-		decode_patch(bitpack, patch);
-		decompress_patch(patchp->getDataZ(), patch, &ph);
+		const F32 *heights = &decoded.mHeights[k*size*size];
+		F32 *dataz = patchp->getDataZ();
+		// Terraforming resends whole patches for a few changed heights, only
+		// update what changed.
+		const LLRect changed = copy_changed_heights(dataz, mGridsPerEdge, heights, size, size);
+		const BOOL first_data = !patchp->getHasReceivedData();
+		if (!first_data && changed.isEmpty())
+		{
+			continue;
+		}
 
 		// Update edges for neighbors.  Need to guarantee that this gets done before we generate vertical stats.
+		// Our own buffer edges come from the neighbors, the neighbors' ones
+		// only change with our first column and row.
 		patchp->updateNorthEdge();
 		patchp->updateEastEdge();
-		if (patchp->getNeighborPatch(WEST))
+		if (patchp->getNeighborPatch(WEST) && (first_data || changed.mLeft == 0))
 		{
 			patchp->getNeighborPatch(WEST)->updateEastEdge();
 		}
-		if (patchp->getNeighborPatch(SOUTHWEST))
+		if (patchp->getNeighborPatch(SOUTHWEST) && (first_data || changed.mLeft == 0 || changed.mBottom == 0))
 		{
 			patchp->getNeighborPatch(SOUTHWEST)->updateEastEdge();
 			patchp->getNeighborPatch(SOUTHWEST)->updateNorthEdge();
 		}
-		if (patchp->getNeighborPatch(SOUTH))
+		if (patchp->getNeighborPatch(SOUTH) && (first_data || changed.mBottom == 0))
 		{
 			patchp->getNeighborPatch(SOUTH)->updateNorthEdge();
 		}
 
 		// Dirty patch statistics, and flag that the patch has data.
-		patchp->dirtyZ();
+		if (first_data)
+		{
+			patchp->dirtyZ();
+		}
+		else
+		{
+			patchp->dirtyZ(changed);
+		}
 		patchp->setHasReceivedData();
 	}
 }
+// </FS:Kadah>
 
 
 // Retrurns TRUE if "position" is within the bounds of surface.
@@ -1437,7 +1551,10 @@ BOOL LLSurface::generateWaterTexture(const F32 x, const F32 y,
 	x_begin = ll_round(x * scale_inv);
 	y_begin = ll_round(y * scale_inv);
 	x_end = ll_round((x + width) * scale_inv);
-	y_end = ll_round((y + width) * scale_inv);
+	// <FS:Kadah> Dirty rect terrain updates: patches ask for any rect now
+	//y_end = ll_round((y + width) * scale_inv);
+	y_end = ll_round((y + height) * scale_inv);
+	// </FS:Kadah>
 
 	if (x_end > tex_width)
 	{
@@ -88,6 +88,24 @@ public:
 	void rebuildWater();
 // </FS:CR> Aurora Sim
 	virtual void decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL b_large_patch);
+	// <FS:Kadah> Background terrain decoding
+	// Height fields of the patches of one LayerData packet, in packet order.
+	class DecodedPatches
+	{
+	public:
+		DecodedPatches() : mPatchSize(0) {}
+
+		S32 mPatchSize;
+		std::vector<U32> mPatchIDs;		// as LLPatchHeader::patchids
+		std::vector<F32> mHeights;		// mPatchSize*mPatchSize per patch
+	};
+	// Decodes the patches following gopp in bitpack, touches no surface or
+	// global, so it can run on any thread. data_size is the size of the
+	// packet, decoding stops at its end.
+	static void decodeDCTPatches(LLBitPack &bitpack, const LLGroupHeader &gopp, BOOL b_large_patch,
+								 U32 data_size, DecodedPatches &decoded);
+	void applyDecodedPatches(const DecodedPatches &decoded, BOOL b_large_patch);
+	// </FS:Kadah>
 	virtual void updatePatchVisibilities(LLAgent &agent);
 
 	inline F32 getZ(const U32 k) const				{ return mSurfaceZ[k]; }
@@ -0,0 +1,177 @@
+/**
+ * @file llsurfacekernels.cpp
+ * @brief Height field kernels shared by the terrain surface patches.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llsurfacekernels.h"
+
+#include "llvector4a.h"
+
+LLRect copy_changed_heights(F32 *dst, U32 dst_stride, const F32 *src, U32 src_stride, U32 size)
+{
+	S32 left = size;
+	S32 right = 0;
+	S32 bottom = size;
+	S32 top = 0;
+
+	for (U32 j = 0; j < size; j++)
+	{
+		F32 *dst_row = dst + j*dst_stride;
+		const F32 *src_row = src + j*src_stride;
+
+		// Most rows of a resent patch are unchanged, only look closer at the
+		// ones that are not.
+		if (!memcmp(dst_row, src_row, size*sizeof(F32)))
+		{
+			continue;
+		}
+
+		// memcmp() also tells -0 from 0 apart, which compare equal here.
+		// Copying those is harmless, only don't grow the rect for them.
+		U32 first = 0;
+		while (first < size && dst_row[first] == src_row[first])
+		{
+			first++;
+		}
+		if (first < size)
+		{
+			U32 last = size - 1;
+			while (last > first && dst_row[last] == src_row[last])
+			{
+				last--;
+			}
+			left = llmin(left, (S32)first);
+			right = llmax(right, (S32)last + 1);
+			bottom = llmin(bottom, (S32)j);
+			top = (S32)j + 1;
+		}
+		memcpy(dst_row, src_row, size*sizeof(F32));
+	}
+
+	LLRect changed;
+	if (left < right)
+	{
+		changed.set(left, top, right, bottom);
+	}
+	return changed;
+}
+
+LLVector3 calc_surface_normal(const F32 *dataz, U32 row_stride, U32 x, U32 y, U32 stride, F32 meters_per_grid)
+{
+	const F32 mpg = meters_per_grid * stride;
+
+	LLVector3 p00(-mpg, -mpg, *(dataz + (x - stride) + (y - stride)*row_stride));
+	LLVector3 p01(-mpg, +mpg, *(dataz + (x - stride) + (y + stride)*row_stride));
+	LLVector3 p10(+mpg, -mpg, *(dataz + (x + stride) + (y - stride)*row_stride));
+	LLVector3 p11(+mpg, +mpg, *(dataz + (x + stride) + (y + stride)*row_stride));
+
+	LLVector3 c1 = p11 - p00;
+	LLVector3 c2 = p01 - p10;
+
+	LLVector3 normal = c1;
+	normal %= c2;
+	normal.normVec();
+	return normal;
+}
+
+void calc_surface_normals_row(const F32 *dataz, LLVector3 *datanorm, U32 row_stride,
+							  U32 x_begin, U32 x_end, U32 y, U32 stride, F32 meters_per_grid)
+{
+	const F32 mpg = meters_per_grid * stride;
+	// The diagonals only differ in z, so the cross product of
+	// c1 = (2 mpg, 2 mpg, dz1) and c2 = (-2 mpg, 2 mpg, dz2) reduces to
+	// (a dz2 - a dz1, -a dz1 - a dz2, a a + a a) with a = 2 mpg.  These are
+	// the operations LLVector3 does, in its order, so the results match
+	// calc_surface_normal().
+	const F32 a = mpg - (-mpg);
+	LLVector4a va;
+	va.splat(a);
+	LLVector4a vneg_a;
+	vneg_a.splat(-a);
+	LLVector4a vz;
+	vz.splat(a*a + a*a);
+	LLVector4a vz2;
+	vz2.setMul(vz, vz);
+	LLVector4a one;
+	one.splat(1.f);
+
+	const F32 *row_south = dataz + (y - stride)*row_stride;
+	const F32 *row_north = dataz + (y + stride)*row_stride;
+	LLVector3 *norm = datanorm + y*row_stride;
+
+	U32 x = x_begin;
+	for (; x + 4 <= x_end; x += 4)
+	{
+		LLVector4a z00, z01, z10, z11;
+		z00.loadua(row_south + x - stride);
+		z01.loadua(row_north + x - stride);
+		z10.loadua(row_south + x + stride);
+		z11.loadua(row_north + x + stride);
+
+		LLVector4a dz1, dz2;
+		dz1.setSub(z11, z00);
+		dz2.setSub(z01, z10);
+
+		LLVector4a nx, ny, t;
+		nx.setMul(va, dz2);
+		t.setMul(dz1, va);
+		nx.sub(t);
+		ny.setMul(dz1, vneg_a);
+		t.setMul(dz2, va);
+		ny.sub(t);
+
+		LLVector4a mag;
+		mag.setMul(nx, nx);
+		t.setMul(ny, ny);
+		mag.add(t);
+		mag.add(vz2);
+		mag = _mm_sqrt_ps(mag);
+
+		// The z term keeps mag well above FP_MAG_THRESHOLD, no need for
+		// normVec()'s zero length case.
+		LLVector4a oomag;
+		oomag.setDiv(one, mag);
+		nx.mul(oomag);
+		ny.mul(oomag);
+		LLVector4a nz;
+		nz.setMul(vz, oomag);
+
+		LL_ALIGN_16(F32 out[3][4]);
+		nx.store4a(out[0]);
+		ny.store4a(out[1]);
+		nz.store4a(out[2]);
+		for (U32 k = 0; k < 4; k++)
+		{
+			norm[x + k].set(out[0][k], out[1][k], out[2][k]);
+		}
+	}
+
+	for (; x < x_end; x++)
+	{
+		norm[x] = calc_surface_normal(dataz, row_stride, x, y, stride, meters_per_grid);
+	}
+}
@@ -0,0 +1,53 @@
+/**
+ * @file llsurfacekernels.h
+ * @brief Height field kernels shared by the terrain surface patches.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSURFACEKERNELS_H
+#define LL_LLSURFACEKERNELS_H
+
+#include "llrect.h"
+#include "v3math.h"
+
+// Height fields here are laid out as in LLSurface: rows of row_stride
+// heights, x along the row and y across rows.  Rects are in grids and follow
+// GL_QUAD conventions, the right and top edges are not part of the rect.
+
+// Copies a size x size block of heights into dst and returns the bounding rect
+// of the heights that changed, relative to the block.  The rect is empty when
+// the block already held these heights.
+LLRect copy_changed_heights(F32 *dst, U32 dst_stride, const F32 *src, U32 src_stride, U32 size);
+
+// Normal at x, y from the four heights stride grids away along the
+// diagonals, the same construction as LLSurfacePatch::calcNormal().  All
+// four samples must lie inside the height field.
+LLVector3 calc_surface_normal(const F32 *dataz, U32 row_stride, U32 x, U32 y, U32 stride, F32 meters_per_grid);
+
+// calc_surface_normal() for the vertices [x_begin, x_end) of row y, four at
+// a time.
+void calc_surface_normals_row(const F32 *dataz, LLVector3 *datanorm, U32 row_stride,
+							  U32 x_begin, U32 x_end, U32 y, U32 stride, F32 meters_per_grid);
+
+#endif // LL_LLSURFACEKERNELS_H
@@ -36,6 +36,7 @@
 #include "llsky.h"
 #include "llviewercamera.h"
 #include "llregionhandle.h" // <FS:CR> Aurora Sim
+#include "llsurfacekernels.h" // <FS:Kadah/> Dirty rect terrain updates
 
 // For getting composition values
 #include "llviewerregion.h"
@@ -47,6 +48,42 @@ extern bool gShiftFrame;
 extern U64MicrosecondsImplicit gFrameTime;
 extern LLPipeline gPipeline;
 
+// <FS:Kadah> Dirty rect terrain updates
+namespace
+{
+	// Grows rect to also cover other.  Empty rects cover nothing.
+	void add_dirty_rect(LLRect &rect, const LLRect &other)
+	{
+		if (other.isEmpty())
+		{
+			return;
+		}
+		if (rect.isEmpty())
+		{
+			rect = other;
+		}
+		else
+		{
+			rect.unionWith(other);
+		}
+	}
+
+	// The part of a size x size patch to regenerate the texture for: dirty
+	// grown by border, or all of it when nothing in particular is dirty.
+	LLRect get_update_rect(const LLRect &dirty, S32 border, S32 size)
+	{
+		LLRect rect(0, size, size, 0);
+		if (dirty.notEmpty())
+		{
+			LLRect grown = dirty;
+			grown.stretch(border);
+			rect.intersectWith(grown);
+		}
+		return rect;
+	}
+}
+// </FS:Kadah>
+
 LLSurfacePatch::LLSurfacePatch() 
 :	mHasReceivedData(FALSE),
 	mSTexUpdate(FALSE),
@@ -418,6 +455,44 @@ void LLSurfacePatch::calcNormal(const U32 x, const U32 y, const U32 stride)
 	*(mDataNorm + surface_stride * y + x) = normal;
 }
 
+// <FS:Kadah> Dirty rect terrain updates
+void LLSurfacePatch::calcNormals(const LLRect &rect)
+{
+	const S32 patch_width = mSurfacep->mPVArray.mPatchWidth;
+	const U32 surface_stride = mSurfacep->getGridsPerEdge();
+	const F32 meters_per_grid = mSurfacep->getMetersPerGrid();
+	const S32 STRIDE = 2;
+
+	// Away from the patch edges all four samples are in this patch, those
+	// normals go through the vectorised row kernel.  calcNormal() does the
+	// rest, where samples come from the neighbours or get clamped.
+	const S32 inner_begin = llmax(rect.mLeft, STRIDE);
+	const S32 inner_end = llmin(rect.mRight, patch_width - STRIDE);
+
+	for (S32 y = rect.mBottom; y < rect.mTop; y++)
+	{
+		if (y < STRIDE || y >= patch_width - STRIDE || inner_begin >= inner_end)
+		{
+			for (S32 x = rect.mLeft; x < rect.mRight; x++)
+			{
+				calcNormal(x, y, STRIDE);
+			}
+			continue;
+		}
+
+		for (S32 x = rect.mLeft; x < inner_begin; x++)
+		{
+			calcNormal(x, y, STRIDE);
+		}
+		calc_surface_normals_row(mDataZ, mDataNorm, surface_stride, inner_begin, inner_end, y, STRIDE, meters_per_grid);
+		for (S32 x = inner_end; x < rect.mRight; x++)
+		{
+			calcNormal(x, y, STRIDE);
+		}
+	}
+}
+// </FS:Kadah>
+
 const LLVector3 &LLSurfacePatch::getNormal(const U32 x, const U32 y) const
 {
 	U32 surface_stride = mSurfacep->getGridsPerEdge();
@@ -526,16 +601,28 @@ void LLSurfacePatch::updateNormals()
 
 	BOOL dirty_patch = FALSE;
 
-	U32 i, j;
+	// <FS:Kadah> Dirty rect terrain updates
+	// Collect what is invalid and recompute it in one pass at the end,
+	// after the z fixups below.
+	const S32 gpe = grids_per_patch_edge;
+	LLRect invalid_rects[7];
+	S32 invalid_count = 0;
+	// </FS:Kadah>
+
+	U32 i;
+	//U32 i, j; // <FS:Kadah/> Dirty rect terrain updates
 	// update the east edge
 	if (mNormalsInvalid[EAST] || mNormalsInvalid[NORTHEAST] || mNormalsInvalid[SOUTHEAST])
 	{
-		for (j = 0; j <= grids_per_patch_edge; j++)
-		{
-			calcNormal(grids_per_patch_edge, j, 2);
-			calcNormal(grids_per_patch_edge - 1, j, 2);
-			calcNormal(grids_per_patch_edge - 2, j, 2);
-		}
+		// <FS:Kadah> Dirty rect terrain updates
+		//for (j = 0; j <= grids_per_patch_edge; j++)
+		//{
+		//	calcNormal(grids_per_patch_edge, j, 2);
+		//	calcNormal(grids_per_patch_edge - 1, j, 2);
+		//	calcNormal(grids_per_patch_edge - 2, j, 2);
+		//}
+		invalid_rects[invalid_count++].setOriginAndSize(gpe - 2, 0, 3, gpe + 1);
+		// </FS:Kadah>
 
 		dirty_patch = TRUE;
 	}
@@ -555,12 +642,15 @@ void LLSurfacePatch::updateNormals()
 		*/
 // </FS:CR> Aurora Sim
 
-		for (i = 0; i <= grids_per_patch_edge; i++)
-		{
-			calcNormal(i, grids_per_patch_edge, 2);
-			calcNormal(i, grids_per_patch_edge - 1, 2);
-			calcNormal(i, grids_per_patch_edge - 2, 2);
-		}
+		// <FS:Kadah> Dirty rect terrain updates
+		//for (i = 0; i <= grids_per_patch_edge; i++)
+		//{
+		//	calcNormal(i, grids_per_patch_edge, 2);
+		//	calcNormal(i, grids_per_patch_edge - 1, 2);
+		//	calcNormal(i, grids_per_patch_edge - 2, 2);
+		//}
+		invalid_rects[invalid_count++].setOriginAndSize(0, gpe - 2, gpe + 1, 3);
+		// </FS:Kadah>
 
 		dirty_patch = TRUE;
 	}
@@ -578,11 +668,14 @@ void LLSurfacePatch::updateNormals()
 		}
 // </FS:CR> Aurora Sim
 
-		for (j = 0; j < grids_per_patch_edge; j++)
-		{
-			calcNormal(0, j, 2);
-			calcNormal(1, j, 2);
-		}
+		// <FS:Kadah> Dirty rect terrain updates
+		//for (j = 0; j < grids_per_patch_edge; j++)
+		//{
+		//	calcNormal(0, j, 2);
+		//	calcNormal(1, j, 2);
+		//}
+		invalid_rects[invalid_count++].setOriginAndSize(0, 0, 2, gpe);
+		// </FS:Kadah>
 		dirty_patch = TRUE;
 	}
 
@@ -600,11 +693,14 @@ void LLSurfacePatch::updateNormals()
 		}
 // </FS:CR> Aurora Sim
 
-		for (i = 0; i < grids_per_patch_edge; i++)
-		{
-			calcNormal(i, 0, 2);
-			calcNormal(i, 1, 2);
-		}
+		// <FS:Kadah> Dirty rect terrain updates
+		//for (i = 0; i < grids_per_patch_edge; i++)
+		//{
+		//	calcNormal(i, 0, 2);
+		//	calcNormal(i, 1, 2);
+		//}
+		invalid_rects[invalid_count++].setOriginAndSize(0, 0, gpe, 2);
+		// </FS:Kadah>
 		dirty_patch = TRUE;
 	}
 
@@ -702,26 +798,55 @@ void LLSurfacePatch::updateNormals()
 			// We've got a northeast patch in the same surface.
 			// The z and normals will be handled by that patch.
 		}
-		calcNormal(grids_per_patch_edge, grids_per_patch_edge, 2);
-		calcNormal(grids_per_patch_edge, grids_per_patch_edge - 1, 2);
-		calcNormal(grids_per_patch_edge - 1, grids_per_patch_edge, 2);
-		calcNormal(grids_per_patch_edge - 1, grids_per_patch_edge - 1, 2);
+		// <FS:Kadah> Dirty rect terrain updates
+		//calcNormal(grids_per_patch_edge, grids_per_patch_edge, 2);
+		//calcNormal(grids_per_patch_edge, grids_per_patch_edge - 1, 2);
+		//calcNormal(grids_per_patch_edge - 1, grids_per_patch_edge, 2);
+		//calcNormal(grids_per_patch_edge - 1, grids_per_patch_edge - 1, 2);
+		invalid_rects[invalid_count++].setOriginAndSize(gpe - 1, gpe - 1, 2, 2);
+		// </FS:Kadah>
 		dirty_patch = TRUE;
 	}
 
 	// update the middle normals
 	if (mNormalsInvalid[MIDDLE])
 	{
-		for (j=2; j < grids_per_patch_edge - 2; j++)
-		{
-			for (i=2; i < grids_per_patch_edge - 2; i++)
-			{
-				calcNormal(i, j, 2);
-			}
-		}
+		// <FS:Kadah> Dirty rect terrain updates
+		//for (j=2; j < grids_per_patch_edge - 2; j++)
+		//{
+		//	for (i=2; i < grids_per_patch_edge - 2; i++)
+		//	{
+		//		calcNormal(i, j, 2);
+		//	}
+		//}
+		invalid_rects[invalid_count++].setOriginAndSize(2, 2, gpe - 4, gpe - 4);
+		// </FS:Kadah>
 		dirty_patch = TRUE;
 	}
 
+	// <FS:Kadah> Dirty rect terrain updates
+	// Normals around heights changed through dirtyZ(rect)
+	if (mNormalsDirtyRect.notEmpty())
+	{
+		invalid_rects[invalid_count++] = mNormalsDirtyRect;
+		mNormalsDirtyRect = LLRect();
+		dirty_patch = TRUE;
+	}
+
+	if (mNormalsInvalid[MIDDLE])
+	{
+		// All of it is invalid, the edges and the middle cover the whole
+		// patch.  Do it in one pass instead of band by band.
+		invalid_rects[0].setOriginAndSize(0, 0, gpe + 1, gpe + 1);
+		invalid_count = 1;
+	}
+
+	for (S32 k = 0; k < invalid_count; k++)
+	{
+		calcNormals(invalid_rects[k]);
+	}
+	// </FS:Kadah>
+
 	if (dirty_patch)
 	{
 		mSurfacep->dirtySurfacePatch(this);
@@ -826,9 +951,17 @@ BOOL LLSurfacePatch::updateTexture()
 			LLVLComposition* comp = regionp->getComposition();
 			if (!mHeightsGenerated)
 			{
-				F32 patch_size = meters_per_grid*(grids_per_patch_edge+1);
-				if (comp->generateHeights((F32)origin_region[VX], (F32)origin_region[VY],
-										  patch_size, patch_size))
+				// <FS:Kadah> Dirty rect terrain updates
+				//F32 patch_size = meters_per_grid*(grids_per_patch_edge+1);
+				//if (comp->generateHeights((F32)origin_region[VX], (F32)origin_region[VY],
+				//						  patch_size, patch_size))
+				// Composition values interpolate the heights, regenerate one
+				// grid around the ones that changed.
+				const LLRect rect = get_update_rect(mTexDirtyRect, 1, (S32)grids_per_patch_edge + 1);
+				if (comp->generateHeights((F32)origin_region[VX] + meters_per_grid*rect.mLeft,
+										  (F32)origin_region[VY] + meters_per_grid*rect.mBottom,
+										  meters_per_grid*rect.getWidth(), meters_per_grid*rect.getHeight()))
+				// </FS:Kadah>
 				{
 					mHeightsGenerated = TRUE;
 				}
@@ -868,21 +1001,39 @@ void LLSurfacePatch::updateGL()
 	LLVLComposition* comp = regionp->getComposition();
 	
 	updateCompositionStats();
-	F32 tex_patch_size = meters_per_grid*grids_per_patch_edge;
-	if (comp->generateTexture((F32)origin_region[VX], (F32)origin_region[VY],
-							  tex_patch_size, tex_patch_size))
+	// <FS:Kadah> Dirty rect terrain updates
+	//F32 tex_patch_size = meters_per_grid*grids_per_patch_edge;
+	//if (comp->generateTexture((F32)origin_region[VX], (F32)origin_region[VY],
+	//						  tex_patch_size, tex_patch_size))
+	//{
+	//	mSTexUpdate = FALSE;
+	//
+	//	// Also generate the water texture
+	//	mSurfacep->generateWaterTexture((F32)origin_region.mdV[VX], (F32)origin_region.mdV[VY],
+	//									tex_patch_size, tex_patch_size);
+	//}
+	// Texels blend the composition values around them, which were
+	// regenerated one grid around the changed heights.
+	const LLRect rect = get_update_rect(mTexDirtyRect, 2, (S32)grids_per_patch_edge);
+	const F32 tex_x = (F32)origin_region[VX] + meters_per_grid*rect.mLeft;
+	const F32 tex_y = (F32)origin_region[VY] + meters_per_grid*rect.mBottom;
+	const F32 tex_width = meters_per_grid*rect.getWidth();
+	const F32 tex_height = meters_per_grid*rect.getHeight();
+	if (comp->generateTexture(tex_x, tex_y, tex_width, tex_height))
 	{
 		mSTexUpdate = FALSE;
+		mTexDirtyRect = LLRect();
 
 		// Also generate the water texture
-		mSurfacep->generateWaterTexture((F32)origin_region.mdV[VX], (F32)origin_region.mdV[VY],
-										tex_patch_size, tex_patch_size);
+		mSurfacep->generateWaterTexture(tex_x, tex_y, tex_width, tex_height);
 	}
+	// </FS:Kadah>
 }
 
 void LLSurfacePatch::dirtyZ()
 {
 	mSTexUpdate = TRUE;
+	mTexDirtyRect = LLRect(); // <FS:Kadah/> Dirty rect terrain updates: all of it
 
 	// Invalidate all normals in this patch
 	U32 i;
@@ -910,6 +1061,69 @@ void LLSurfacePatch::dirtyZ()
 	mLastUpdateTime = gFrameTime;
 }
 
+// <FS:Kadah> Dirty rect terrain updates
+void LLSurfacePatch::dirtyZ(const LLRect &rect)
+{
+	const S32 grids_per_patch_edge = mSurfacep->getGridsPerPatchEdge();
+	const LLRect patch_rect(0, grids_per_patch_edge + 1, grids_per_patch_edge + 1, 0);
+
+	LLRect dirty_rect = rect;
+	dirty_rect.intersectWith(patch_rect);
+	if (dirty_rect.isEmpty())
+	{
+		return;
+	}
+
+	// An empty texture rect already means all of it
+	if (!mSTexUpdate || mTexDirtyRect.notEmpty())
+	{
+		add_dirty_rect(mTexDirtyRect, dirty_rect);
+	}
+	mSTexUpdate = TRUE;
+
+	// calcNormal() samples two grids away along the diagonals
+	LLRect normals_rect = dirty_rect;
+	normals_rect.stretch(2);
+	normals_rect.intersectWith(patch_rect);
+	add_dirty_rect(mNormalsDirtyRect, normals_rect);
+
+	// The normals within two grids of an edge sample the neighbor across it,
+	// only invalidate the neighbors whose normals read these heights.
+	BOOL near_edge[8];
+	near_edge[EAST] = dirty_rect.mRight > grids_per_patch_edge - 2;
+	near_edge[NORTH] = dirty_rect.mTop > grids_per_patch_edge - 2;
+	near_edge[WEST] = dirty_rect.mLeft < 3;
+	near_edge[SOUTH] = dirty_rect.mBottom < 3;
+	near_edge[NORTHEAST] = near_edge[NORTH] && near_edge[EAST];
+	near_edge[NORTHWEST] = near_edge[NORTH] && near_edge[WEST];
+	near_edge[SOUTHWEST] = near_edge[SOUTH] && near_edge[WEST];
+	near_edge[SOUTHEAST] = near_edge[SOUTH] && near_edge[EAST];
+
+	// The northeast corner may be filled in from this patch's own heights
+	if (near_edge[NORTHEAST])
+	{
+		mNormalsInvalid[NORTHEAST] = TRUE;
+	}
+
+	for (U32 i = 0; i < 8; i++)
+	{
+		if (near_edge[i] && getNeighborPatch(i))
+		{
+			getNeighborPatch(i)->mNormalsInvalid[gDirOpposite[i]] = TRUE;
+			getNeighborPatch(i)->dirty();
+			if (i < 4)
+			{
+				getNeighborPatch(i)->mNormalsInvalid[gDirAdjacent[gDirOpposite[i]][0]] = TRUE;
+				getNeighborPatch(i)->mNormalsInvalid[gDirAdjacent[gDirOpposite[i]][1]] = TRUE;
+			}
+		}
+	}
+
+	dirty();
+	mLastUpdateTime = gFrameTime;
+}
+// </FS:Kadah>
+
 
 const U64 &LLSurfacePatch::getLastUpdateTime() const
 {
@@ -30,6 +30,7 @@
 #include "v3math.h"
 #include "v3dmath.h"
 #include "llpointer.h"
+#include "llrect.h" // <FS:Kadah/> Dirty rect terrain updates
 
 class LLSurface;
 class LLVOSurfacePatch;
@@ -87,6 +88,10 @@ public:
 	void updateGL();
 
 	void dirtyZ(); // Dirty the z values of this patch
+	// <FS:Kadah> Dirty rect terrain updates
+	// Dirty the z values in rect, in grids from the patch origin
+	void dirtyZ(const LLRect &rect);
+	// </FS:Kadah>
 	void setHasReceivedData();
 	BOOL getHasReceivedData() const;
 
@@ -103,6 +108,7 @@ public:
 	LLVector2 getTexCoords(const U32 x, const U32 y) const;
 
 	void calcNormal(const U32 x, const U32 y, const U32 stride);
+	void calcNormals(const LLRect &rect); // <FS:Kadah/> Dirty rect terrain updates
 	const LLVector3 &getNormal(const U32 x, const U32 y) const;
 
 	void eval(const U32 x, const U32 y, const U32 stride,
@@ -145,6 +151,10 @@ public:
 protected:
 	LLSurfacePatch *mNeighborPatches[8]; // Adjacent patches
 	BOOL mNormalsInvalid[9];  // Which normals are invalid
+	// <FS:Kadah> Dirty rect terrain updates
+	LLRect mNormalsDirtyRect;	// Normals to recompute on top of mNormalsInvalid
+	LLRect mTexDirtyRect;		// Grids to regenerate the texture for, all when empty
+	// </FS:Kadah>
 
 	BOOL mDirty;
 	BOOL mDirtyZStats;
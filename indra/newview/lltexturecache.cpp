@@ -33,6 +33,8 @@
 #include "llimage.h"
 #include "llimagej2c.h" // for version control
 #include "lllfsthread.h"
+#include "llslabstore.h" // <FS:Kadah> Slab arena texture bodies
+#include "llfastcachetable.h" // <FS:Kadah> Fast cache v2
 #include "llviewercontrol.h"
 
 // Included to allow LLTextureCache::purgeTextures() to pause watchdog timeout
@@ -46,6 +48,14 @@
 //  First TEXTURE_CACHE_ENTRY_SIZE bytes of each texture in texture.entries in same order
 // cache/textures/[0-F]/UUID.texture
 //  Actual texture body files
+// <FS:Kadah> Slab arena texture bodies
+// cache/textures/texture.slabs, texture.slabindex
+//  Texture bodies when FSTextureCacheSlabStore is enabled, replacing the body files
+// </FS:Kadah>
+// <FS:Kadah> Fast cache v2
+// cache/textures/FastCache2.cache
+//  Decoded mips keyed by UUID, replacing FastCache.cache unless FSFastCacheSize is 0
+// </FS:Kadah>
 
 //note: there is no good to define 1024 for TEXTURE_CACHE_ENTRY_SIZE while FIRST_PACKET_SIZE is 600 on sim side.
 const S32 TEXTURE_CACHE_ENTRY_SIZE = FIRST_PACKET_SIZE;//1024;
@@ -492,8 +502,13 @@ bool LLTextureCacheRemoteWorker::doRead()
 	// Fourth state / stage : read the rest of the data from the UUID based cached file
 	if (!done && (mState == BODY))
 	{
-		std::string filename = mCache->getTextureFileName(mID);
-		S32 filesize = LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
+		// <FS:Kadah> Slab arena texture bodies
+		//std::string filename = mCache->getTextureFileName(mID);
+		//S32 filesize = LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
+		LLSlabStore* slabs = mCache->mSlabStore;
+		std::string filename = slabs ? std::string() : mCache->getTextureFileName(mID);
+		S32 filesize = slabs ? llmax(slabs->getSize(mID), 0) : LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
+		// </FS:Kadah>
 
 		if (filesize && (filesize + TEXTURE_CACHE_ENTRY_SIZE) > mOffset)
 		{
@@ -534,10 +549,17 @@ bool LLTextureCacheRemoteWorker::doRead()
 				mReadData = data;
 
 				// Read the data at last
-				S32 bytes_read = LLAPRFile::readEx(filename, 
-												 mReadData + data_offset,
-												 file_offset, file_size,
-												 mCache->getLocalAPRFilePool());
+				// <FS:Kadah> Slab arena texture bodies
+				//S32 bytes_read = LLAPRFile::readEx(filename, 
+				//								 mReadData + data_offset,
+				//								 file_offset, file_size,
+				//								 mCache->getLocalAPRFilePool());
+				S32 bytes_read = slabs ? slabs->read(mID, mReadData + data_offset, file_offset, file_size)
+									   : LLAPRFile::readEx(filename,
+														   mReadData + data_offset,
+														   file_offset, file_size,
+														   mCache->getLocalAPRFilePool());
+				// </FS:Kadah>
 				if (bytes_read != file_size)
 				{
 					LL_WARNS() << "LLTextureCacheWorker: "  << mID
@@ -632,6 +654,13 @@ bool LLTextureCacheRemoteWorker::doWrite()
 		else
 		{
 			alreadyCached = mCache->updateEntry(idx, entry, mImageSize, mDataSize); // update the existing entry.
+			// <FS:Kadah> Fast cache v2: entries are keyed by id rather than by
+			// header entry, so later and more detailed writes can refresh them.
+			if (mCache->mFastCacheTable && mRawImage.notNull() && !mRawImage->isBufferInvalid() && mRawImage->getData())
+			{
+				mCache->writeToFastCacheTable(mID, mRawImage, mRawDiscardLevel);
+			}
+			// </FS:Kadah>
 		}
 
 		if (!done)
@@ -726,13 +755,37 @@ bool LLTextureCacheRemoteWorker::doWrite()
 			S32 file_size = mDataSize - TEXTURE_CACHE_ENTRY_SIZE;
 
 			{
-				// build the cache file name from the UUID
-				std::string filename = mCache->getTextureFileName(mID);
-				// 			LL_INFOS() << "Writing Body: " << filename << " Bytes: " << file_offset+file_size << LL_ENDL;
-				S32 bytes_written = LLAPRFile::writeEx(filename,
+				// <FS:Kadah> Slab arena texture bodies
+				//// build the cache file name from the UUID
+				//std::string filename = mCache->getTextureFileName(mID);
+				//// 			LL_INFOS() << "Writing Body: " << filename << " Bytes: " << file_offset+file_size << LL_ENDL;
+				//S32 bytes_written = LLAPRFile::writeEx(filename,
+				//									   mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
+				//									   0, file_size,
+				//									   mCache->getLocalAPRFilePool());
+				S32 bytes_written = 0;
+				if (LLSlabStore* slabs = mCache->mSlabStore)
+				{
+					if (slabs->write(mID, mWriteData + TEXTURE_CACHE_ENTRY_SIZE, file_size))
+					{
+						bytes_written = file_size;
+					}
+					if (slabs->hasEvicted())
+					{
+						// Let the control thread drop the header entries of the evicted slab
+						mCache->mDoPurge = TRUE;
+					}
+				}
+				else
+				{
+					// build the cache file name from the UUID
+					std::string filename = mCache->getTextureFileName(mID);
+					bytes_written = LLAPRFile::writeEx(filename,
 													   mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
 													   0, file_size,
 													   mCache->getLocalAPRFilePool());
+				}
+				// </FS:Kadah>
 				if (bytes_written <= 0)
 				{
 					LL_WARNS() << "LLTextureCacheWorker: " << mID
@@ -841,7 +894,9 @@ LLTextureCache::LLTextureCache(bool threaded)
 	  mDoPurge(FALSE),
 	  mFastCachep(NULL),
 	  mFastCachePoolp(NULL),
-	  mFastCachePadBuffer(NULL)
+	  mFastCachePadBuffer(NULL),
+	  mSlabStore(NULL), // <FS:Kadah> Slab arena texture bodies
+	  mFastCacheTable(NULL) // <FS:Kadah> Fast cache v2
 {
     mHeaderAPRFilePoolp = new LLVolatileAPRPool(); // is_local = true, because this pool is for headers, headers are under own mutex
 }
@@ -854,6 +909,8 @@ LLTextureCache::~LLTextureCache()
 	delete mFastCachePoolp;
 	delete mHeaderAPRFilePoolp;
 	ll_aligned_free_16(mFastCachePadBuffer);
+	delete mSlabStore; // <FS:Kadah> Slab arena texture bodies; saves the slab index
+	delete mFastCacheTable; // <FS:Kadah> Fast cache v2
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -995,6 +1052,8 @@ const char* old_textures_dirname = "textures";
 //change the location of the texture cache to prevent from being deleted by old version viewers.
 const char* textures_dirname = "texturecache";
 const char* fast_cache_filename = "FastCache.cache";
+const char* slab_store_name = "texture"; // <FS:Kadah> Slab arena texture bodies
+const char* fast_cache_table_filename = "FastCache2.cache"; // <FS:Kadah> Fast cache v2
 
 void LLTextureCache::setDirNames(ELLPath location)
 {
@@ -1064,6 +1123,16 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, BOOL texture_cache
 			<< " Textures size: " << sCacheMaxTexturesSize / (1024 * 1024) << " MB" << LL_ENDL;
 
 	setDirNames(location);
+
+	// <FS:Kadah> Slab arena texture bodies. Bodies written with one layout are
+	// invisible to the other one, so switching layouts is treated as a mismatch.
+	bool use_slabs = !mReadOnly && gSavedSettings.getBOOL("FSTextureCacheSlabStore");
+	if (!mReadOnly && use_slabs != LLSlabStore::exists(mTexturesDirName, slab_store_name))
+	{
+		LL_INFOS("TextureCache") << "Texture body layout changed, purging." << LL_ENDL;
+		texture_cache_mismatch = TRUE;
+	}
+	// </FS:Kadah>
 	
 	if(texture_cache_mismatch) 
 	{
@@ -1091,12 +1160,27 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, BOOL texture_cache
 			std::string dirname = mTexturesDirName + gDirUtilp->getDirDelimiter() + subdirs[i];
 			LLFile::mkdir(dirname);
 		}
+
+		// <FS:Kadah> Slab arena texture bodies
+		if (use_slabs && !mSlabStore)
+		{
+			mSlabStore = new LLSlabStore();
+			openSlabStore(true);
+		}
+		// </FS:Kadah>
 	}
 	readHeaderCache();
 	purgeTextures(true); // calc mTexturesSize and make some room in the texture cache if we need it
 
 	llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
-	openFastCache(true);
+	// <FS:Kadah> Fast cache v2
+	//openFastCache(true);
+	openFastCacheTable();
+	if (!mFastCacheTable)
+	{
+		openFastCache(true);
+	}
+	// </FS:Kadah>
 
 	return max_size; // unused cache space
 }
@@ -1364,7 +1448,11 @@ bool LLTextureCache::updateEntry(S32& idx, Entry& entry, S32 new_image_size, S32
 		
 		writeEntryToHeaderImmediately(idx, entry, update_header) ;
 	
-		if (mTexturesSizeTotal > sCacheMaxTexturesSize)
+		// <FS:Kadah> Slab arena texture bodies: the arena keeps itself within
+		// budget, only evicted slabs need their header entries dropped.
+		//if (mTexturesSizeTotal > sCacheMaxTexturesSize)
+		if (mSlabStore ? mSlabStore->hasEvicted() : mTexturesSizeTotal > sCacheMaxTexturesSize)
+		// </FS:Kadah>
 		{
 			purge = true;
 		}
@@ -1634,6 +1722,23 @@ void LLTextureCache::clearCorruptedCache()
 
 void LLTextureCache::purgeAllTextures(bool purge_directories)
 {
+	// <FS:Kadah> Fast cache v2: unmap the table before its file goes away
+	bool reopen_fast_cache = mFastCacheTable && mFastCacheTable->isOpen();
+	if (reopen_fast_cache)
+	{
+		mFastCacheTable->close();
+	}
+	// </FS:Kadah>
+
+	// <FS:Kadah> Slab arena texture bodies: unmap the arena before its files go away
+	bool reopen_slabs = mSlabStore && mSlabStore->isOpen();
+	if (reopen_slabs)
+	{
+		mSlabStore->close();
+		LLSlabStore::removeFiles(mTexturesDirName, slab_store_name);
+	}
+	// </FS:Kadah>
+
 	if (!mReadOnly)
 	{
 // <FS:ND> Windows can be really slow deleting a huge texture cache.
@@ -1702,6 +1807,21 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
 	setEntriesHeader();
 	writeEntriesHeader();
 
+	// <FS:Kadah> Slab arena texture bodies
+	if (reopen_slabs && LLFile::isdir(mTexturesDirName))
+	{
+		openSlabStore(false);
+	}
+	// </FS:Kadah>
+
+	// <FS:Kadah> Fast cache v2. Without a directory the table stays closed,
+	// reads and writes then simply miss.
+	if (reopen_fast_cache && LLFile::isdir(mTexturesDirName))
+	{
+		openFastCacheTable();
+	}
+	// </FS:Kadah>
+
 	LL_INFOS() << "The entire texture cache is cleared." << LL_ENDL ;
 }
 
@@ -1730,6 +1850,25 @@ void LLTextureCache::purgeTexturesLazy(F32 time_limit_sec)
 			return; // nothing to purge
 		}
 
+		// <FS:Kadah> Slab arena texture bodies: the arena already evicted the
+		// oldest slab, only the header entries of its bodies need to go.
+		if (mSlabStore)
+		{
+			std::vector<LLUUID> evicted;
+			mSlabStore->takeEvicted(evicted);
+			for (const LLUUID& id : evicted)
+			{
+				id_map_t::iterator iter = mHeaderIDMap.find(id);
+				if (iter != mHeaderIDMap.end())
+				{
+					mPurgeEntryList.push_back(std::pair<S32, Entry>(iter->second, entries[iter->second]));
+				}
+			}
+			LL_DEBUGS("TextureCache") << "Formed slab eviction list of " << mPurgeEntryList.size() << " entries" << LL_ENDL;
+			return;
+		}
+		// </FS:Kadah>
+
 		// Use mTexturesSizeMap to collect UUIDs of textures with bodies
 		typedef std::set<std::pair<U32, S32> > time_idx_set_t;
 		std::set<std::pair<U32, S32> > time_idx_set;
@@ -1780,7 +1919,8 @@ void LLTextureCache::purgeTexturesLazy(F32 time_limit_sec)
 			mPurgeEntryList.pop_back();
 			// make sure record is still valid
 			id_map_t::iterator iter_header = mHeaderIDMap.find(entry.mID);
-			if (iter_header != mHeaderIDMap.end() && iter_header->second == idx)
+			if (iter_header != mHeaderIDMap.end() && iter_header->second == idx
+				&& !(mSlabStore && mSlabStore->contains(entry.mID))) // <FS:Kadah> rewritten since its slab got evicted
 			{
 				std::string tex_filename = getTextureFileName(entry.mID);
 				removeEntry(idx, entry, tex_filename);
@@ -1814,6 +1954,38 @@ void LLTextureCache::purgeTextures(bool validate)
 	{
 		return; // nothing to purge
 	}
+
+	// <FS:Kadah> Slab arena texture bodies: the arena keeps itself within budget
+	// by evicting whole slabs. All that is left to do here is to drop the
+	// header entries whose body the arena no longer has (evicted, or lost
+	// because the viewer did not shut down cleanly).
+	if (mSlabStore)
+	{
+		std::vector<LLUUID> evicted;
+		mSlabStore->takeEvicted(evicted); // the contains() check below covers them
+		S32 purge_count = 0;
+		std::string no_filename;
+		for (U32 idx = 0; idx < num_entries; ++idx)
+		{
+			Entry& entry = entries[idx];
+			if (entry.mImageSize > entry.mBodySize && entry.mBodySize > 0 && !mSlabStore->contains(entry.mID))
+			{
+				removeEntry((S32)idx, entry, no_filename);
+				++purge_count;
+			}
+		}
+		writeEntriesAndClose(entries);
+		LLAppViewer::instance()->resumeMainloopTimeout();
+
+		LL_INFOS("TextureCache") << "TEXTURE CACHE (slabs):"
+				<< " PURGED: " << purge_count
+				<< " ENTRIES: " << num_entries
+				<< " CACHE SIZE: " << mTexturesSizeTotal / (1024 * 1024) << " MB"
+				<< " ARENA: " << mSlabStore->getLiveBytes() / (1024 * 1024) << " / " << mSlabStore->getCapacity() / (1024 * 1024) << " MB"
+				<< LL_ENDL;
+		return;
+	}
+	// </FS:Kadah>
 	
 	// Use mTexturesSizeMap to collect UUIDs of textures with bodies
 	typedef std::set<std::pair<U32,S32> > time_idx_set_t;
@@ -2078,6 +2250,20 @@ LLTextureCache::handle_t LLTextureCache::writeToCache(const LLUUID& id, U32 prio
 //called in the main thread
 LLPointer<LLImageRaw> LLTextureCache::readFromFastCache(const LLUUID& id, S32& discardlevel)
 {
+	// <FS:Kadah> Fast cache v2
+	if (mFastCacheTable)
+	{
+		LLFastCacheTable::Image image;
+		U8* data = mFastCacheTable->read(id, image);
+		if (!data)
+		{
+			return NULL;
+		}
+		discardlevel = image.mDiscardLevel;
+		return new LLImageRaw(data, image.mWidth, image.mHeight, image.mComponents, true);
+	}
+	// </FS:Kadah>
+
 	U32 offset;
 	{
 		LLMutexLock lock(&mHeaderMutex);
@@ -2142,6 +2328,13 @@ bool LLTextureCache::writeToFastCache(LLUUID image_id, S32 id, LLPointer<LLImage
 		return false;
 	}
 
+	// <FS:Kadah> Fast cache v2
+	if (mFastCacheTable)
+	{
+		return writeToFastCacheTable(image_id, raw, discardlevel);
+	}
+	// </FS:Kadah>
+
 	S32 w, h, c;
 	w = raw->getWidth();
 	h = raw->getHeight();
@@ -2208,6 +2401,105 @@ bool LLTextureCache::writeToFastCache(LLUUID image_id, S32 id, LLPointer<LLImage
 	return true;
 }
 
+// <FS:Kadah> Slab arena texture bodies
+void LLTextureCache::openSlabStore(bool first_time)
+{
+	if (mSlabStore && !mSlabStore->open(mTexturesDirName, slab_store_name, (U64)sCacheMaxTexturesSize))
+	{
+		if (!first_time)
+		{
+			// The cache workers may be using mSlabStore, it must outlive them.
+			// Closed, it just misses.
+			LL_WARNS("TextureCache") << "Unable to reopen the texture slab arena, it stays closed." << LL_ENDL;
+			return;
+		}
+		LL_WARNS("TextureCache") << "Unable to open the texture slab arena, using one file per texture." << LL_ENDL;
+		delete mSlabStore;
+		mSlabStore = NULL;
+	}
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Fast cache v2
+void LLTextureCache::openFastCacheTable()
+{
+	U32 size_mb = gSavedSettings.getU32("FSFastCacheSize");
+	if (mReadOnly || !size_mb)
+	{
+		return;
+	}
+	std::string filename = gDirUtilp->add(mTexturesDirName, fast_cache_table_filename);
+	if (mFastCacheTable)
+	{
+		// Reopened while the cache workers may be reading mFastCacheTable, it
+		// must outlive them. Closed, it just misses.
+		if (!mFastCacheTable->open(filename, gSavedSettings.getU32("FSFastCacheResolution"), (U64)size_mb * 1024 * 1024))
+		{
+			LL_WARNS("TextureCache") << "Unable to reopen the fast cache table, it stays closed." << LL_ENDL;
+		}
+		return;
+	}
+
+	// First open, nothing reads the table yet
+	LLFastCacheTable* table = new LLFastCacheTable();
+	if (!table->open(filename, gSavedSettings.getU32("FSFastCacheResolution"), (U64)size_mb * 1024 * 1024))
+	{
+		LL_WARNS("TextureCache") << "Unable to open the fast cache table, using the 16x16 fast cache." << LL_ENDL;
+		delete table;
+		return;
+	}
+	mFastCacheTable = table;
+}
+
+// Called from the cache writers, any thread
+bool LLTextureCache::writeToFastCacheTable(const LLUUID& image_id, LLPointer<LLImageRaw> raw, S32 discardlevel)
+{
+	S32 w = raw->getWidth();
+	S32 h = raw->getHeight();
+	S32 c = raw->getComponents();
+
+	// Search for a discard level that will fit into a slot
+	const S32 max_data_size = mFastCacheTable->getMaxDataSize();
+	S32 i = 0;
+	while (((w >> i) * (h >> i) * c) > max_data_size)
+	{
+		++i;
+	}
+	w >>= i;
+	h >>= i;
+	if (w * h * c <= 0)
+	{
+		return true; // too thin to keep, not an error
+	}
+
+	// The table never trades detail away, don't scale for nothing
+	S32 cached_discard = mFastCacheTable->getDiscardLevel(image_id);
+	if (cached_discard >= 0 && cached_discard <= discardlevel + i)
+	{
+		return true;
+	}
+
+	if (i)
+	{
+		// Make a duplicate to keep the original raw image untouched.
+		raw = raw->duplicate();
+		if (raw->isBufferInvalid())
+		{
+			LL_WARNS() << "Invalid image duplicate buffer" << LL_ENDL;
+			return false;
+		}
+		raw->scale(w, h);
+	}
+
+	LLFastCacheTable::Image image;
+	image.mWidth = raw->getWidth();
+	image.mHeight = raw->getHeight();
+	image.mComponents = raw->getComponents();
+	image.mDiscardLevel = discardlevel + i;
+	return mFastCacheTable->write(image_id, image, raw->getData());
+}
+// </FS:Kadah>
+
 void LLTextureCache::openFastCache(bool first_time)
 {
 	if(!mFastCachep)
@@ -2302,6 +2594,13 @@ void LLTextureCache::removeCachedTexture(const LLUUID& id)
 		mTexturesSizeMap.erase(id);
 	}
 	mHeaderIDMap.erase(id);
+	// <FS:Kadah> Slab arena texture bodies
+	if (mSlabStore)
+	{
+		mSlabStore->remove(id);
+		return;
+	}
+	// </FS:Kadah>
 	// We are inside header's mutex so mHeaderAPRFilePoolp is safe to use,
 	// but getLocalAPRFilePool() is not safe, it might be in use by worker
 	LLAPRFile::remove(getTextureFileName(id), mHeaderAPRFilePoolp);
@@ -2314,7 +2613,14 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 
 	if(idx >= 0) //valid entry
 	{
-		if (entry.mBodySize == 0)	// Always attempt to remove when mBodySize > 0.
+		// <FS:Kadah> Slab arena texture bodies: there is no body file to look for
+		//if (entry.mBodySize == 0)	// Always attempt to remove when mBodySize > 0.
+		if (mSlabStore)
+		{
+			mSlabStore->remove(entry.mID);
+		}
+		else if (entry.mBodySize == 0)	// Always attempt to remove when mBodySize > 0.
+		// </FS:Kadah>
 		{
 		  // Sanity check. Shouldn't exist when body size is 0.
 		  // We are inside header's mutex so mHeaderAPRFilePoolp is safe to use,
@@ -2337,6 +2643,13 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 		mFreeList.insert(idx);	
 	}
 
+	// <FS:Kadah> Slab arena texture bodies
+	if (mSlabStore)
+	{
+		file_maybe_exists = false;
+	}
+	// </FS:Kadah>
+
 	if (file_maybe_exists)
 	{
 		LLAPRFile::remove(filename, mHeaderAPRFilePoolp);		
@@ -37,6 +37,8 @@
 class LLImageFormatted;
 class LLTextureCacheWorker;
 class LLImageRaw;
+class LLSlabStore; // <FS:Kadah> Slab arena texture bodies
+class LLFastCacheTable; // <FS:Kadah> Fast cache v2
 
 class LLTextureCache : public LLWorkerThread
 {
@@ -186,6 +188,12 @@ private:
 	void lockHeaders() { mHeaderMutex.lock(); }
 	void unlockHeaders() { mHeaderMutex.unlock(); }
 	
+	void openSlabStore(bool first_time); // <FS:Kadah> Slab arena texture bodies
+	// <FS:Kadah> Fast cache v2
+	void openFastCacheTable();
+	bool writeToFastCacheTable(const LLUUID& image_id, LLPointer<LLImageRaw> raw, S32 discardlevel);
+	// </FS:Kadah>
+
 	void openFastCache(bool first_time = false);
 	void closeFastCache(bool forced = false);
 	bool writeToFastCache(LLUUID image_id, S32 cache_id, LLPointer<LLImageRaw> raw, S32 discardlevel);	
@@ -239,6 +247,17 @@ private:
 	S64 mTexturesSizeTotal;
 	LLAtomicBool mDoPurge;
 
+	// <FS:Kadah> Slab arena texture bodies. When set, bodies live in a single
+	// memory mapped arena instead of one file per texture in mTexturesDirName.
+	LLSlabStore* mSlabStore;
+	// </FS:Kadah>
+
+	// <FS:Kadah> Fast cache v2. When set, the fast cache keeps decoded mips of
+	// up to FSFastCacheResolution pixels per texture, keyed by UUID, instead
+	// of one 16x16 image per header entry in mFastCacheFileName.
+	LLFastCacheTable* mFastCacheTable;
+	// </FS:Kadah>
+
 	typedef std::map<S32, Entry> idx_entry_map_t;
 	idx_entry_map_t mUpdatedEntryMap;
 	typedef std::vector<std::pair<S32, Entry> > idx_entry_vector_t;
@@ -75,6 +75,17 @@ LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheReadLatency("texture
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDecodeLatency("texture_decode_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheWriteLatency("texture_write_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexFetchLatency("texture_fetch_latency");
+// <FS:Kadah> Fetch scheduler
+LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sHttpQueueWaitTime("texture_http_queue_wait");
+LLTrace::CountStatHandle<F64> LLTextureFetch::sHttpCanceled("texture_http_canceled");
+LLTrace::CountStatHandle<F64Bytes> LLTextureFetch::sHttpWastedBytes("texture_http_wasted_bytes");
+// </FS:Kadah>
+// <FS:Kadah> Fast cache v2
+LLTrace::CountStatHandle<F64> LLTextureFetch::sFastCacheHit("texture_fast_cache_hit");
+LLTrace::CountStatHandle<F64> LLTextureFetch::sFastCacheAttempt("texture_fast_cache_attempt");
+LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > LLTextureFetch::sFastCacheHitRate("texture_fast_cache_hits");
+LLTrace::CountStatHandle<F64Bytes> LLTextureFetch::sFastCacheBytesSaved("texture_fast_cache_bytes_saved");
+// </FS:Kadah>
 
 LLTextureFetchTester* LLTextureFetch::sTesterp = NULL ;
 const std::string sTesterName("TextureFetchTester");
@@ -534,12 +545,15 @@ private:
 	bool acquireHttpSemaphore()
 		{
 			llassert(! mHttpHasResource);
-			if (mFetcher->mHttpSemaphore >= mFetcher->mHttpHighWater)
+			// <FS:Kadah> Fetch scheduler
+			//if (mFetcher->mHttpSemaphore >= mFetcher->mHttpHighWater)
+			if (! mFetcher->acquireHttpSlot(mHttpPolicyClass))
+			// </FS:Kadah>
 			{
 				return false;
 			}
 			mHttpHasResource = true;
-			mFetcher->mHttpSemaphore++;
+			//mFetcher->mHttpSemaphore++; // <FS:Kadah/> Fetch scheduler
 			return true;
 		}
 
@@ -549,8 +563,11 @@ private:
 		{
 			llassert(mHttpHasResource);
 			mHttpHasResource = false;
-			mFetcher->mHttpSemaphore--;
-			llassert_always(mFetcher->mHttpSemaphore >= 0);
+			// <FS:Kadah> Fetch scheduler
+			//mFetcher->mHttpSemaphore--;
+			//llassert_always(mFetcher->mHttpSemaphore >= 0);
+			mFetcher->releaseHttpSlot(mHttpPolicyClass);
+			// </FS:Kadah>
 		}
 	
 private:
@@ -656,6 +673,7 @@ private:
 	U32						mHttpReplySize,				// Actual received data size
 							mHttpReplyOffset;			// Actual received data offset
 	bool					mHttpHasResource;			// Counts against Fetcher's mHttpSemaphore
+	bool					mHttpCancelRequested;		// <FS:Kadah/> Fetch scheduler: active request canceled, texture went off screen
 
 	// State history
 	U32						mCacheReadCount,
@@ -974,6 +992,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
 	  mHttpReplySize(0U),
 	  mHttpReplyOffset(0U),
 	  mHttpHasResource(false),
+	  mHttpCancelRequested(false), // <FS:Kadah/> Fetch scheduler
 	  mCacheReadCount(0U),
 	  mCacheWriteCount(0U),
 	  mResourceWaitCount(0U),
@@ -1195,6 +1214,27 @@ bool LLTextureFetchWorker::doWork(S32 param)
 			LL_DEBUGS(LOG_TXT) << mID << " abort: mImagePriority < F_ALMOST_ZERO" << LL_ENDL;
 			return true; // abort
 		}
+		// <FS:Kadah> Fetch scheduler
+		// Went off screen while waiting for a request slot, give up the
+		// place in the queue.  INIT keeps the url for when it is wanted
+		// again.
+		else if (mState == WAIT_HTTP_RESOURCE2)
+		{
+			LL_DEBUGS(LOG_TXT) << mID << " abort: mImagePriority < F_ALMOST_ZERO in WAIT_HTTP_RESOURCE2" << LL_ENDL;
+			mFetcher->removeHttpWaiter(mID);
+			setState(INIT);
+			add(LLTextureFetch::sHttpCanceled, 1.0);
+			return true; // abort
+		}
+		// Or before its bytes arrived, the canceled reply ends up in
+		// WAIT_HTTP_REQ.
+		else if (mState == WAIT_HTTP_REQ && mHttpActive && ! mHttpCancelRequested)
+		{
+			LL_DEBUGS(LOG_TXT) << mID << " canceling HTTP request: mImagePriority < F_ALMOST_ZERO" << LL_ENDL;
+			mFetcher->getHttpRequest().requestCancel(mHttpHandle, LLCore::HttpHandler::ptr_t());
+			mHttpCancelRequested = true;
+		}
+		// </FS:Kadah>
 	}
 	// <FS:Ansariel> OpenSim compatibility
 	//if(mState > CACHE_POST && !mCanUseHTTP)
@@ -1556,11 +1596,17 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		//
 		// If it looks like we're busy, keep this request here.
 		// Otherwise, advance into the HTTP states.
-		if (mFetcher->getHttpWaitersCount() || ! acquireHttpSemaphore())
+		// <FS:Kadah> Fetch scheduler
+		//if (mFetcher->getHttpWaitersCount() || ! acquireHttpSemaphore())
+		if (mFetcher->getHttpWaitersCount(mHttpPolicyClass) || ! acquireHttpSemaphore())
+		// </FS:Kadah>
 		{
 			setState(WAIT_HTTP_RESOURCE2);
 			setPriority(LLWorkerThread::PRIORITY_LOW | mWorkPriority);
-			mFetcher->addHttpWaiter(this->mID);
+			// <FS:Kadah> Fetch scheduler
+			//mFetcher->addHttpWaiter(this->mID);
+			mFetcher->addHttpWaiter(this->mID, mHttpPolicyClass, mImagePriority);
+			// </FS:Kadah>
 			++mResourceWaitCount;
 			return false;
 		}
@@ -1653,6 +1699,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		
 		mRequestedDeltaTimer.reset();
 		mLoaded = FALSE;
+		mHttpCancelRequested = false; // <FS:Kadah/> Fetch scheduler
 		mGetStatus = LLCore::HttpStatus();
 		mGetReason.clear();
 		LL_DEBUGS(LOG_TXT) << "HTTP GET: " << mID << " Offset: " << mRequestedOffset
@@ -1716,6 +1763,24 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		// call releaseHttpSemaphore().
 		if (mLoaded)
 		{
+			// <FS:Kadah> Fetch scheduler
+			// Canceled before anything arrived.  Keep what we have and
+			// the url, the texture may be wanted again.
+			static const LLCore::HttpStatus http_canceled(LLCore::HttpStatus::LLCORE, LLCore::HE_OP_CANCELED);
+			if (mHttpCancelRequested)
+			{
+				mHttpCancelRequested = false;
+				if (mRequestedSize < 0 && http_canceled == mGetStatus)
+				{
+					setState(INIT);
+					releaseHttpSemaphore();
+					add(LLTextureFetch::sHttpCanceled, 1.0);
+					LL_DEBUGS(LOG_TXT) << mID << " abort: HTTP request canceled" << LL_ENDL;
+					return true; // abort
+				}
+			}
+			// </FS:Kadah>
+
 			S32 cur_size = mFormattedImage.notNull() ? mFormattedImage->getDataSize() : 0;
 			if (mRequestedSize < 0)
 			{
@@ -2188,6 +2253,15 @@ void LLTextureFetchWorker::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRe
 	}
 	
 	S32BytesImplicit data_size = callbackHttpGet(response, partial, success);
+
+	// <FS:Kadah> Fetch scheduler
+	// Nobody wants these any more, they arrived before the cancel did or
+	// the request was deleted while in flight
+	if (data_size > 0 && (mImagePriority < F_ALMOST_ZERO || getFlags(LLWorkerClass::WCF_DELETE_REQUESTED)))
+	{
+		add(LLTextureFetch::sHttpWastedBytes, F64Bytes(data_size.value()));
+	}
+	// </FS:Kadah>
 			
 	if (log_texture_traffic && data_size > 0)
 	{
@@ -2679,7 +2753,10 @@ LLTextureFetch::LLTextureFetch(LLTextureCache* cache, LLImageDecodeThread* image
 	mHttpMetricsPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_REPORTING);
 	mHttpHighWater = HTTP_NONPIPE_REQUESTS_HIGH_WATER;
 	mHttpLowWater = HTTP_NONPIPE_REQUESTS_LOW_WATER;
-	mHttpSemaphore = 0;
+	// <FS:Kadah> Fetch scheduler
+	//mHttpSemaphore = 0;
+	mHttpScheduler.setLimits(mHttpPolicyClass, mHttpLowWater, mHttpHighWater);
+	// </FS:Kadah>
 
 	// Conditionally construct debugger object after 'this' is
 	// fully initialized.
@@ -2722,7 +2799,8 @@ LLTextureFetch::~LLTextureFetch()
 		delete req;
 	}
 
-	mHttpWaitResource.clear();
+	//mHttpWaitResource.clear();
+	mHttpScheduler.clear(); // <FS:Kadah/> Fetch scheduler
 	
 	delete mHttpRequest;
 	mHttpRequest = NULL;
@@ -3129,6 +3207,15 @@ bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
 	{
 		worker->lockWorkMutex();										// +Mw
 		worker->setImagePriority(priority);
+		// <FS:Kadah> Fetch scheduler
+		// Move it in the wait queue too, so what is on screen now gets the
+		// next free request slot
+		if (LLTextureFetchWorker::WAIT_HTTP_RESOURCE2 == worker->mState)
+		{
+			LLMutexLock lock(&mNetworkQueueMutex);						// +Mfnq
+			mHttpScheduler.updatePriority(id, worker->mImagePriority);
+		}																// -Mfnq
+		// </FS:Kadah>
 		worker->unlockWorkMutex();										// -Mw
 		res = true;
 	}
@@ -3203,6 +3290,12 @@ void LLTextureFetch::commonUpdate()
 		mHttpHighWater = HTTP_NONPIPE_REQUESTS_HIGH_WATER;
 		mHttpLowWater = HTTP_NONPIPE_REQUESTS_LOW_WATER;
 	}
+	// <FS:Kadah> Fetch scheduler
+	{
+		LLMutexLock lock(&mNetworkQueueMutex);							// +Mfnq
+		mHttpScheduler.setLimits(mHttpPolicyClass, mHttpLowWater, mHttpHighWater);
+	}																	// -Mfnq
+	// </FS:Kadah>
 
 	// Release waiters
 	releaseHttpWaiters();
@@ -3833,9 +3926,16 @@ void LLTextureFetch::dump()
 	}
 
 	LL_INFOS(LOG_TXT) << "LLTextureFetch WAIT_HTTP_RESOURCE:" << LL_ENDL;
-	for (wait_http_res_queue_t::const_iterator iter(mHttpWaitResource.begin());
-		 mHttpWaitResource.end() != iter;
+	// <FS:Kadah> Fetch scheduler
+	//for (wait_http_res_queue_t::const_iterator iter(mHttpWaitResource.begin());
+	//	 mHttpWaitResource.end() != iter;
+	//	 ++iter)
+	std::vector<LLUUID> waiters;
+	mHttpScheduler.getQueued(waiters);
+	for (std::vector<LLUUID>::const_iterator iter(waiters.begin());
+		 waiters.end() != iter;
 		 ++iter)
+	// </FS:Kadah>
 	{
 		LL_INFOS(LOG_TXT) << " ID: " << (*iter) << LL_ENDL;
 	}
@@ -3846,10 +3946,16 @@ void LLTextureFetch::dump()
 // HTTP Resource Waiting Methods
 
 // Threads:  Ttf
-void LLTextureFetch::addHttpWaiter(const LLUUID & tid)
+// <FS:Kadah> Fetch scheduler
+//void LLTextureFetch::addHttpWaiter(const LLUUID & tid)
+void LLTextureFetch::addHttpWaiter(const LLUUID & tid, LLCore::HttpRequest::policy_t policy, F32 priority)
+// </FS:Kadah>
 {
 	mNetworkQueueMutex.lock();											// +Mfnq
-	mHttpWaitResource.insert(tid);
+	// <FS:Kadah> Fetch scheduler
+	//mHttpWaitResource.insert(tid);
+	mHttpScheduler.push(tid, policy, priority, LLTimer::getTotalSeconds());
+	// </FS:Kadah>
 	mNetworkQueueMutex.unlock();										// -Mfnq
 }
 
@@ -3857,11 +3963,14 @@ void LLTextureFetch::addHttpWaiter(const LLUUID & tid)
 void LLTextureFetch::removeHttpWaiter(const LLUUID & tid)
 {
 	mNetworkQueueMutex.lock();											// +Mfnq
-	wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
-	if (mHttpWaitResource.end() != iter)
-	{
-		mHttpWaitResource.erase(iter);
-	}
+	// <FS:Kadah> Fetch scheduler
+	//wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
+	//if (mHttpWaitResource.end() != iter)
+	//{
+	//	mHttpWaitResource.erase(iter);
+	//}
+	mHttpScheduler.remove(tid);
+	// </FS:Kadah>
 	mNetworkQueueMutex.unlock();										// -Mfnq
 }
 
@@ -3869,15 +3978,40 @@ void LLTextureFetch::removeHttpWaiter(const LLUUID & tid)
 bool LLTextureFetch::isHttpWaiter(const LLUUID & tid)
 {
 	mNetworkQueueMutex.lock();											// +Mfnq
-	wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
-	const bool ret(mHttpWaitResource.end() != iter);
+	// <FS:Kadah> Fetch scheduler
+	//wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
+	//const bool ret(mHttpWaitResource.end() != iter);
+	const bool ret(mHttpScheduler.isQueued(tid));
+	// </FS:Kadah>
 	mNetworkQueueMutex.unlock();										// -Mfnq
 	return ret;
 }
 
+// <FS:Kadah> Fetch scheduler
+// Threads:  T*
+bool LLTextureFetch::acquireHttpSlot(LLCore::HttpRequest::policy_t policy)
+{
+	LLMutexLock lock(&mNetworkQueueMutex);								// +Mfnq
+	return mHttpScheduler.acquire(policy);
+}																		// -Mfnq
+
+// Threads:  T*
+void LLTextureFetch::releaseHttpSlot(LLCore::HttpRequest::policy_t policy)
+{
+	LLMutexLock lock(&mNetworkQueueMutex);								// +Mfnq
+	mHttpScheduler.release(policy);
+}																		// -Mfnq
+// </FS:Kadah>
+
 // Release as many requests as permitted from the WAIT_HTTP_RESOURCE2
 // state to the SEND_HTTP_REQ state based on their current priority.
 //
+// <FS:Kadah> Fetch scheduler
+// The waiters are kept in priority order by mHttpScheduler now, which
+// hands out the ones to release.  They stay listed as waiters until
+// released below, so deleteOK() still holds off deleting them meanwhile.
+// </FS:Kadah>
+//
 // This data structures and code associated with this looks a bit
 // indirect and naive but it's done in the name of safety.  An
 // ordered container may become invalid from time to time due to
@@ -3890,80 +4024,137 @@ bool LLTextureFetch::isHttpWaiter(const LLUUID & tid)
 // Locks:  -Mw (must not hold any worker when called)
 void LLTextureFetch::releaseHttpWaiters()
 {
-	// Use mHttpSemaphore rather than mHTTPTextureQueue.size()
-	// to avoid a lock.  
-	if (mHttpSemaphore >= mHttpLowWater)
-		return;
-	S32 needed(mHttpHighWater - mHttpSemaphore);
-	if (needed <= 0)
-	{
-		// Would only happen if High/LowWater were changed behind
-		// our back.  In that case, defer fill until usage falls within
-		// limits.
-		return;
-	}
-
-	// Quickly make a copy of all the LLUIDs.  Get off the
-	// mutex as early as possible.
-	typedef std::vector<LLUUID> uuid_vec_t;
-	uuid_vec_t tids;
-
+	// <FS:Kadah> Fetch scheduler
+//	// Use mHttpSemaphore rather than mHTTPTextureQueue.size()
+//	// to avoid a lock.  
+//	if (mHttpSemaphore >= mHttpLowWater)
+//		return;
+//	S32 needed(mHttpHighWater - mHttpSemaphore);
+//	if (needed <= 0)
+//	{
+//		// Would only happen if High/LowWater were changed behind
+//		// our back.  In that case, defer fill until usage falls within
+//		// limits.
+//		return;
+//	}
+//
+//	// Quickly make a copy of all the LLUIDs.  Get off the
+//	// mutex as early as possible.
+//	typedef std::vector<LLUUID> uuid_vec_t;
+//	uuid_vec_t tids;
+//
+//	{
+//		LLMutexLock lock(&mNetworkQueueMutex);							// +Mfnq
+//
+//		if (mHttpWaitResource.empty())
+//			return;
+//		tids.reserve(mHttpWaitResource.size());
+//		tids.assign(mHttpWaitResource.begin(), mHttpWaitResource.end());
+//	}																	// -Mfnq
+//
+//	// Now lookup the UUUIDs to find valid requests and sort
+//	// them in priority order, highest to lowest.  We're going
+//	// to modify priority later as a side-effect of releasing
+//	// these objects.  That, in turn, would violate the partial
+//	// ordering assumption of std::set, std::map, etc. so we
+//	// don't use those containers.  We use a vector and an explicit
+//	// sort to keep the containers valid later.
+//	typedef std::vector<LLTextureFetchWorker *> worker_list_t;
+//	worker_list_t tids2;
+//
+//	tids2.reserve(tids.size());
+//	for (uuid_vec_t::iterator iter(tids.begin());
+//		 tids.end() != iter;
+//		 ++iter)
+//	{
+//		LLTextureFetchWorker * worker(getWorker(* iter));
+//		if (worker)
+//		{
+//			tids2.push_back(worker);
+//		}
+//		else
+//		{
+//			// If worker isn't found, this should be due to a request
+//			// for deletion.  We signal our recognition that this
+//			// uuid shouldn't be used for resource waiting anymore by
+//			// erasing it from the resource waiter list.  That allows
+//			// deleteOK to do final deletion on the worker.
+//			removeHttpWaiter(* iter);
+//		}
+//	}
+//	tids.clear();
+//
+//	// Sort into priority order, if necessary and only as much as needed
+//	if (tids2.size() > needed)
+//	{
+//		LLTextureFetchWorker::Compare compare;
+//		std::partial_sort(tids2.begin(), tids2.begin() + needed, tids2.end(), compare);
+//	}
+//
+//	// Release workers up to the high water mark.  Since we aren't
+//	// holding any locks at this point, we can be in competition
+//	// with other callers.  Do defensive things like getting
+//	// refreshed counts of requests and checking if someone else
+//	// has moved any worker state around....
+//	for (worker_list_t::iterator iter2(tids2.begin()); tids2.end() != iter2; ++iter2)
+//	{
+//		LLTextureFetchWorker * worker(* iter2);
+//
+//		worker->lockWorkMutex();										// +Mw
+//		if (LLTextureFetchWorker::WAIT_HTTP_RESOURCE2 != worker->mState)
+//		{
+//			// Not in expected state, remove it, try the next one
+//			worker->unlockWorkMutex();									// -Mw
+//			LL_WARNS(LOG_TXT) << "Resource-waited texture " << worker->mID
+//							  << " in unexpected state:  " << worker->mState
+//							  << ".  Removing from wait list."
+//							  << LL_ENDL;
+//			removeHttpWaiter(worker->mID);
+//			continue;
+//		}
+//
+//		if (! worker->acquireHttpSemaphore())
+//		{
+//			// Out of active slots, quit
+//			worker->unlockWorkMutex();									// -Mw
+//			break;
+//		}
+//
+//		worker->setState(LLTextureFetchWorker::SEND_HTTP_REQ);
+//		worker->setPriority(LLWorkerThread::PRIORITY_HIGH | worker->mWorkPriority);
+//		worker->unlockWorkMutex();										// -Mw
+//
+//		removeHttpWaiter(worker->mID);
+//	}
+	typedef LLTextureFetchScheduler::request_list_t request_list_t;
+	request_list_t ready;
 	{
 		LLMutexLock lock(&mNetworkQueueMutex);							// +Mfnq
-
-		if (mHttpWaitResource.empty())
-			return;
-		tids.reserve(mHttpWaitResource.size());
-		tids.assign(mHttpWaitResource.begin(), mHttpWaitResource.end());
+		mHttpScheduler.popReady(ready);
 	}																	// -Mfnq
+	if (ready.empty())
+	{
+		return;
+	}
 
-	// Now lookup the UUUIDs to find valid requests and sort
-	// them in priority order, highest to lowest.  We're going
-	// to modify priority later as a side-effect of releasing
-	// these objects.  That, in turn, would violate the partial
-	// ordering assumption of std::set, std::map, etc. so we
-	// don't use those containers.  We use a vector and an explicit
-	// sort to keep the containers valid later.
-	typedef std::vector<LLTextureFetchWorker *> worker_list_t;
-	worker_list_t tids2;
-
-	tids2.reserve(tids.size());
-	for (uuid_vec_t::iterator iter(tids.begin());
-		 tids.end() != iter;
-		 ++iter)
+	// Release them highest first.  Since we aren't holding any locks at
+	// this point, we can be in competition with other callers.  Do
+	// defensive things like checking if someone else has moved any worker
+	// state around....
+	const F64 now = LLTimer::getTotalSeconds();
+	for (request_list_t::iterator iter(ready.begin()); ready.end() != iter; ++iter)
 	{
-		LLTextureFetchWorker * worker(getWorker(* iter));
-		if (worker)
-		{
-			tids2.push_back(worker);
-		}
-		else
+		LLTextureFetchWorker * worker(getWorker(iter->mID));
+		if (! worker)
 		{
 			// If worker isn't found, this should be due to a request
 			// for deletion.  We signal our recognition that this
 			// uuid shouldn't be used for resource waiting anymore by
 			// erasing it from the resource waiter list.  That allows
 			// deleteOK to do final deletion on the worker.
-			removeHttpWaiter(* iter);
+			removeHttpWaiter(iter->mID);
+			continue;
 		}
-	}
-	tids.clear();
-
-	// Sort into priority order, if necessary and only as much as needed
-	if (tids2.size() > needed)
-	{
-		LLTextureFetchWorker::Compare compare;
-		std::partial_sort(tids2.begin(), tids2.begin() + needed, tids2.end(), compare);
-	}
-
-	// Release workers up to the high water mark.  Since we aren't
-	// holding any locks at this point, we can be in competition
-	// with other callers.  Do defensive things like getting
-	// refreshed counts of requests and checking if someone else
-	// has moved any worker state around....
-	for (worker_list_t::iterator iter2(tids2.begin()); tids2.end() != iter2; ++iter2)
-	{
-		LLTextureFetchWorker * worker(* iter2);
 
 		worker->lockWorkMutex();										// +Mw
 		if (LLTextureFetchWorker::WAIT_HTTP_RESOURCE2 != worker->mState)
@@ -3980,24 +4171,32 @@ void LLTextureFetch::releaseHttpWaiters()
 
 		if (! worker->acquireHttpSemaphore())
 		{
-			// Out of active slots, quit
+			// Out of active slots, put this one and the rest back
 			worker->unlockWorkMutex();									// -Mw
+			LLMutexLock lock(&mNetworkQueueMutex);						// +Mfnq
+			for (; ready.end() != iter; ++iter)
+			{
+				mHttpScheduler.restore(*iter);
+			}
 			break;
-		}
-		
+		}																// -Mfnq
+
 		worker->setState(LLTextureFetchWorker::SEND_HTTP_REQ);
 		worker->setPriority(LLWorkerThread::PRIORITY_HIGH | worker->mWorkPriority);
 		worker->unlockWorkMutex();										// -Mw
 
 		removeHttpWaiter(worker->mID);
+		sample(sHttpQueueWaitTime, F32Seconds(now - iter->mQueuedTime));
 	}
+	// </FS:Kadah>
 }
 
 // Threads:  T*
 void LLTextureFetch::cancelHttpWaiters()
 {
 	mNetworkQueueMutex.lock();											// +Mfnq
-	mHttpWaitResource.clear();
+	//mHttpWaitResource.clear();
+	mHttpScheduler.clear(); // <FS:Kadah/> Fetch scheduler
 	mNetworkQueueMutex.unlock();										// -Mfnq
 }
 
@@ -4005,11 +4204,21 @@ void LLTextureFetch::cancelHttpWaiters()
 int LLTextureFetch::getHttpWaitersCount()
 {
 	mNetworkQueueMutex.lock();											// +Mfnq
-	int ret(mHttpWaitResource.size());
+	//int ret(mHttpWaitResource.size());
+	int ret(mHttpScheduler.size()); // <FS:Kadah/> Fetch scheduler
 	mNetworkQueueMutex.unlock();										// -Mfnq
 	return ret;
 }
 
+// <FS:Kadah> Fetch scheduler
+// Threads:  T*
+int LLTextureFetch::getHttpWaitersCount(LLCore::HttpRequest::policy_t policy)
+{
+	LLMutexLock lock(&mNetworkQueueMutex);								// +Mfnq
+	return mHttpScheduler.size(policy);
+}																		// -Mfnq
+// </FS:Kadah>
+
 
 // Threads:  T*
 void LLTextureFetch::updateStateStats(U32 cache_read, U32 cache_write, U32 res_wait)
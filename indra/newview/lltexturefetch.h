@@ -42,6 +42,7 @@
 #include "httphandler.h"
 #include "lltrace.h"
 #include "llviewertexture.h"
+#include "lltexturefetchscheduler.h" // <FS:Kadah/> Fetch scheduler
 
 class LLViewerTexture;
 class LLTextureFetchWorker;
@@ -189,8 +190,11 @@ public:
 	// ----------------------------------
 	// HTTP resource waiting methods
 
+	// <FS:Kadah> Fetch scheduler
     // Threads:  T*
-	void addHttpWaiter(const LLUUID & tid);
+	//void addHttpWaiter(const LLUUID & tid);
+	void addHttpWaiter(const LLUUID & tid, LLCore::HttpRequest::policy_t policy, F32 priority);
+	// </FS:Kadah>
 
     // Threads:  T*
 	void removeHttpWaiter(const LLUUID & tid);
@@ -215,6 +219,20 @@ public:
 
     // Threads:  T*
 	int getHttpWaitersCount();
+
+	// <FS:Kadah> Fetch scheduler
+	// Threads:  T*
+	int getHttpWaitersCount(LLCore::HttpRequest::policy_t policy);
+
+	// Take and give back one of the policy class's active request slots
+	// (the old resource semaphore).
+	//
+	// Threads:  T*
+	bool acquireHttpSlot(LLCore::HttpRequest::policy_t policy);
+
+	// Threads:  T*
+	void releaseHttpSlot(LLCore::HttpRequest::policy_t policy);
+	// </FS:Kadah>
 	// ----------------------------------
 	// Stats management
 
@@ -322,6 +340,17 @@ public:
 	static LLTrace::SampleStatHandle<F32Seconds> sCacheWriteLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sTexFetchLatency;
     static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sCacheHitRate;
+	// <FS:Kadah> Fetch scheduler
+	static LLTrace::SampleStatHandle<F32Seconds> sHttpQueueWaitTime;	// WAIT_HTTP_RESOURCE2 to SEND_HTTP_REQ
+	static LLTrace::CountStatHandle<F64> sHttpCanceled;					// fetches dropped after going off screen
+	static LLTrace::CountStatHandle<F64Bytes> sHttpWastedBytes;			// received for textures no longer wanted
+	// </FS:Kadah>
+	// <FS:Kadah> Fast cache v2
+	static LLTrace::CountStatHandle<F64> sFastCacheHit;
+	static LLTrace::CountStatHandle<F64> sFastCacheAttempt;
+	static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sFastCacheHitRate;
+	static LLTrace::CountStatHandle<F64Bytes> sFastCacheBytesSaved;		// decoded pixels painted without a decode
+	// </FS:Kadah>
 
 private:
 	LLMutex mQueueMutex;        //to protect mRequestMap and mCommands only
@@ -386,10 +415,15 @@ private:
 	// Originally implemented as a traditional semaphore (heading towards
 	// zero), it now is an outstanding request count that is allowed to
 	// exceed the high water level (but not go below zero).
-	LLAtomicS32							mHttpSemaphore;					// Ttf
-	
-	typedef std::set<LLUUID> wait_http_res_queue_t;
-	wait_http_res_queue_t				mHttpWaitResource;				// Mfnq
+	// <FS:Kadah> Fetch scheduler
+	// Kept per policy class by mHttpScheduler, together with the
+	// waiters in priority order.
+	//LLAtomicS32							mHttpSemaphore;					// Ttf
+	//
+	//typedef std::set<LLUUID> wait_http_res_queue_t;
+	//wait_http_res_queue_t				mHttpWaitResource;				// Mfnq
+	LLTextureFetchScheduler				mHttpScheduler;					// Mfnq
+	// </FS:Kadah>
 
 	// Cumulative stats on the states/requests issued by
 	// textures running through here.
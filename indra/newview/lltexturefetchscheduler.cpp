@@ -0,0 +1,274 @@
+/**
+ * @file lltexturefetchscheduler.cpp
+ * @brief Queue of texture fetches waiting for an HTTP request slot.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturefetchscheduler.h"
+
+LLTextureFetchScheduler::PolicyQueue::PolicyQueue()
+:	mLowWater(S32_MAX),
+	mHighWater(S32_MAX),
+	mActive(0)
+{
+}
+
+void LLTextureFetchScheduler::setLimits(policy_t policy, S32 low_water, S32 high_water)
+{
+	PolicyQueue& queue = mPolicies[policy];
+	queue.mLowWater = low_water;
+	queue.mHighWater = high_water;
+}
+
+bool LLTextureFetchScheduler::acquire(policy_t policy)
+{
+	PolicyQueue& queue = mPolicies[policy];
+	if (queue.mActive >= queue.mHighWater)
+	{
+		return false;
+	}
+	queue.mActive++;
+	return true;
+}
+
+void LLTextureFetchScheduler::release(policy_t policy)
+{
+	PolicyQueue& queue = mPolicies[policy];
+	queue.mActive--;
+	llassert_always(queue.mActive >= 0);
+}
+
+S32 LLTextureFetchScheduler::getActive(policy_t policy) const
+{
+	policy_map_t::const_iterator iter = mPolicies.find(policy);
+	return iter != mPolicies.end() ? iter->second.mActive : 0;
+}
+
+void LLTextureFetchScheduler::push(const LLUUID& id, policy_t policy, F32 priority, F64 now)
+{
+	index_map_t::iterator iter = mIndex.find(id);
+	if (iter != mIndex.end())
+	{
+		if (iter->second.mIndex != POPPED && iter->second.mPolicy == policy)
+		{
+			updatePriority(id, priority);
+			return;
+		}
+		remove(id);
+	}
+
+	Request request;
+	request.mID = id;
+	request.mPolicy = policy;
+	request.mPriority = priority;
+	request.mQueuedTime = now;
+	insert(mPolicies[policy], request);
+}
+
+bool LLTextureFetchScheduler::updatePriority(const LLUUID& id, F32 priority)
+{
+	index_map_t::iterator iter = mIndex.find(id);
+	if (iter == mIndex.end() || iter->second.mIndex == POPPED)
+	{
+		return false;
+	}
+
+	PolicyQueue& queue = mPolicies[iter->second.mPolicy];
+	const S32 index = iter->second.mIndex;
+	const F32 old_priority = queue.mHeap[index].mPriority;
+	queue.mHeap[index].mPriority = priority;
+	if (priority > old_priority)
+	{
+		siftUp(queue, index);
+	}
+	else if (priority < old_priority)
+	{
+		siftDown(queue, index);
+	}
+	return true;
+}
+
+bool LLTextureFetchScheduler::remove(const LLUUID& id)
+{
+	index_map_t::iterator iter = mIndex.find(id);
+	if (iter == mIndex.end())
+	{
+		return false;
+	}
+
+	const Location location = iter->second;
+	mIndex.erase(iter);
+	if (location.mIndex != POPPED)
+	{
+		erase(mPolicies[location.mPolicy], location.mIndex);
+	}
+	return true;
+}
+
+bool LLTextureFetchScheduler::isQueued(const LLUUID& id) const
+{
+	return mIndex.find(id) != mIndex.end();
+}
+
+S32 LLTextureFetchScheduler::size(policy_t policy) const
+{
+	policy_map_t::const_iterator iter = mPolicies.find(policy);
+	return iter != mPolicies.end() ? (S32)iter->second.mHeap.size() : 0;
+}
+
+void LLTextureFetchScheduler::getQueued(std::vector<LLUUID>& ids) const
+{
+	for (const index_map_t::value_type& entry : mIndex)
+	{
+		ids.push_back(entry.first);
+	}
+}
+
+void LLTextureFetchScheduler::clear()
+{
+	for (policy_map_t::value_type& entry : mPolicies)
+	{
+		entry.second.mHeap.clear();
+	}
+	mIndex.clear();
+}
+
+void LLTextureFetchScheduler::popReady(request_list_t& ready)
+{
+	for (policy_map_t::value_type& entry : mPolicies)
+	{
+		PolicyQueue& queue = entry.second;
+		if (queue.mActive >= queue.mLowWater)
+		{
+			continue;
+		}
+
+		S32 needed = queue.mHighWater - queue.mActive;
+		while (needed-- > 0 && !queue.mHeap.empty())
+		{
+			ready.push_back(queue.mHeap.front());
+			mIndex[queue.mHeap.front().mID].mIndex = POPPED;
+			erase(queue, 0);
+		}
+	}
+}
+
+void LLTextureFetchScheduler::restore(const Request& request)
+{
+	index_map_t::iterator iter = mIndex.find(request.mID);
+	if (iter != mIndex.end() && iter->second.mIndex == POPPED)
+	{
+		mIndex.erase(iter);
+		insert(mPolicies[request.mPolicy], request);
+	}
+}
+
+// Higher priority first, then the one waiting longer
+// static
+bool LLTextureFetchScheduler::higher(const Request& a, const Request& b)
+{
+	return a.mPriority > b.mPriority || (a.mPriority == b.mPriority && a.mQueuedTime < b.mQueuedTime);
+}
+
+void LLTextureFetchScheduler::insert(PolicyQueue& queue, const Request& request)
+{
+	Location& location = mIndex[request.mID];
+	location.mPolicy = request.mPolicy;
+	location.mIndex = (S32)queue.mHeap.size();
+	queue.mHeap.push_back(request);
+	siftUp(queue, location.mIndex);
+}
+
+// Leaves mIndex of the erased request alone
+void LLTextureFetchScheduler::erase(PolicyQueue& queue, S32 index)
+{
+	const S32 last = (S32)queue.mHeap.size() - 1;
+	if (index != last)
+	{
+		const Request erased = queue.mHeap[index];
+		place(queue, index, queue.mHeap[last]);
+		queue.mHeap.pop_back();
+		if (higher(queue.mHeap[index], erased))
+		{
+			siftUp(queue, index);
+		}
+		else
+		{
+			siftDown(queue, index);
+		}
+	}
+	else
+	{
+		queue.mHeap.pop_back();
+	}
+}
+
+void LLTextureFetchScheduler::siftUp(PolicyQueue& queue, S32 index)
+{
+	const Request request = queue.mHeap[index];
+	while (index > 0)
+	{
+		const S32 parent = (index - 1) / 2;
+		if (!higher(request, queue.mHeap[parent]))
+		{
+			break;
+		}
+		place(queue, index, queue.mHeap[parent]);
+		index = parent;
+	}
+	place(queue, index, request);
+}
+
+void LLTextureFetchScheduler::siftDown(PolicyQueue& queue, S32 index)
+{
+	const Request request = queue.mHeap[index];
+	const S32 count = (S32)queue.mHeap.size();
+	while (true)
+	{
+		S32 child = index * 2 + 1;
+		if (child >= count)
+		{
+			break;
+		}
+		if (child + 1 < count && higher(queue.mHeap[child + 1], queue.mHeap[child]))
+		{
+			child++;
+		}
+		if (!higher(queue.mHeap[child], request))
+		{
+			break;
+		}
+		place(queue, index, queue.mHeap[child]);
+		index = child;
+	}
+	place(queue, index, request);
+}
+
+void LLTextureFetchScheduler::place(PolicyQueue& queue, S32 index, const Request& request)
+{
+	queue.mHeap[index] = request;
+	mIndex[request.mID].mIndex = index;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file lltexturefetchscheduler.h
+ * @brief Queue of texture fetches waiting for an HTTP request slot.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREFETCHSCHEDULER_H
+#define LL_LLTEXTUREFETCHSCHEDULER_H
+
+#include "lluuid.h"
+#include "httprequest.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Texture fetches waiting in WAIT_HTTP_RESOURCE2 for an HTTP request slot,
+// one indexed max-heap per HTTP policy class.  Reprioritising or removing
+// a waiting fetch is O(log n) and releasing the next ones does not sort
+// the whole wait list.  Each policy class also counts its active requests
+// against its own low and high water levels.
+//
+// Not locked, LLTextureFetch holds its network queue mutex around every
+// call.
+class LLTextureFetchScheduler
+{
+public:
+	typedef LLCore::HttpRequest::policy_t policy_t;
+
+	struct Request
+	{
+		LLUUID mID;
+		policy_t mPolicy;
+		F32 mPriority;
+		F64 mQueuedTime;	// for the queue wait time stat
+	};
+	typedef std::vector<Request> request_list_t;
+
+	// Once a class has low_water requests active nothing more is released,
+	// below it is filled up to high_water.  Classes without limits are not
+	// limited.
+	void setLimits(policy_t policy, S32 low_water, S32 high_water);
+
+	// Request slots, a fetch holds one from SEND_HTTP_REQ until its reply
+	// has been handled
+	bool acquire(policy_t policy);
+	void release(policy_t policy);
+	S32 getActive(policy_t policy) const;
+
+	// Queues id, or moves it to its new priority if already queued
+	void push(const LLUUID& id, policy_t policy, F32 priority, F64 now);
+	// Returns false if id is not queued
+	bool updatePriority(const LLUUID& id, F32 priority);
+	bool remove(const LLUUID& id);
+	// Also true between popReady() and remove() or restore()
+	bool isQueued(const LLUUID& id) const;
+	S32 size() const { return (S32)mIndex.size(); }
+	S32 size(policy_t policy) const;
+	void getQueued(std::vector<LLUUID>& ids) const;
+	// Drops every queued request, the active counts stay
+	void clear();
+
+	// Appends the highest priority requests of every class with fewer
+	// than its low water active, as many as it has slots up to its high
+	// water, highest first within a class.  They stay isQueued() until the
+	// caller has moved them on with remove(), or put them back with
+	// restore().
+	void popReady(request_list_t& ready);
+	void restore(const Request& request);
+
+private:
+	struct PolicyQueue
+	{
+		PolicyQueue();
+
+		S32 mLowWater;
+		S32 mHighWater;
+		S32 mActive;
+		std::vector<Request> mHeap;
+	};
+
+	// Heap position of a queued request, POPPED after popReady()
+	struct Location
+	{
+		policy_t mPolicy;
+		S32 mIndex;
+	};
+	static const S32 POPPED = -1;
+
+	static bool higher(const Request& a, const Request& b);
+	void insert(PolicyQueue& queue, const Request& request);
+	void erase(PolicyQueue& queue, S32 index);
+	void siftUp(PolicyQueue& queue, S32 index);
+	void siftDown(PolicyQueue& queue, S32 index);
+	void place(PolicyQueue& queue, S32 index, const Request& request);
+
+	typedef std::map<policy_t, PolicyQueue> policy_map_t;
+	policy_map_t mPolicies;
+	typedef std::unordered_map<LLUUID, Location, FSUUIDHash> index_map_t;
+	index_map_t mIndex;
+};
+
+#endif // LL_LLTEXTUREFETCHSCHEDULER_H
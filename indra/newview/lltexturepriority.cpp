@@ -0,0 +1,294 @@
+/**
+ * @file lltexturepriority.cpp
+ * @brief Structure of arrays table of texture decode priority inputs.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturepriority.h"
+
+#include "llgltexture.h"
+#include "llimage.h"
+
+#include <emmintrin.h>
+
+// Same scale as calcDecodePriority()
+static const F32 PRIORITY_DELTA_DISCARD_LEVEL_FACTOR = 100000.f;
+static const F32 MAX_DELTA_DISCARD_LEVEL_FOR_PRIORITY = 4.f;
+static const F32 MAX_PRIORITY_PIXEL = 999.f;
+static const F32 PRIORITY_BOOST_LEVEL_FACTOR = 1000.f;
+static const F32 PRIORITY_BOOST_HIGH_FACTOR = 10000000.f;
+
+// Estimates more than this far apart are a change worth re-evaluating for,
+// LLViewerTextureList ignores anything closer.
+static const F32 CHANGE_LOW = 0.8f;
+static const F32 CHANGE_HIGH = 1.25f;
+
+LLTexturePriorityTable::LLTexturePriorityTable()
+:	mSize(0)
+{
+}
+
+void LLTexturePriorityTable::grow()
+{
+	// Multiple of four, selectChanged() works on whole groups
+	const U32 capacity = ((U32)mVirtualSize.size() + llmax((U32)mVirtualSize.size() / 2, 64U)) & ~3U;
+	mVirtualSize.resize(capacity, 0.f);
+	mBoostLevel.resize(capacity, 0.f);
+	mCurrentDiscard.resize(capacity, -1.f);
+	mDesiredDiscard.resize(capacity, 0.f);
+	mFlags.resize(capacity, FREE);
+	mEstimate.resize(capacity, 0.f);
+	mEvaluated.resize(capacity, 0.f);
+	mTextures.resize(capacity, NULL);
+}
+
+LLTexturePriorityTable::slot_t LLTexturePriorityTable::add(LLViewerFetchedTexture* texture)
+{
+	slot_t slot;
+	if (!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		if (mSize == mVirtualSize.size())
+		{
+			grow();
+		}
+		slot = mSize++;
+	}
+
+	mVirtualSize[slot] = 0.f;
+	mBoostLevel[slot] = 0.f;
+	mCurrentDiscard[slot] = -1.f;
+	mDesiredDiscard[slot] = 0.f;
+	mFlags[slot] = 0;
+	mEstimate[slot] = 0.f;
+	mEvaluated[slot] = 0.f;
+	mTextures[slot] = texture;
+	return slot;
+}
+
+void LLTexturePriorityTable::remove(slot_t slot)
+{
+	llassert(slot >= 0 && (U32)slot < mSize && !(mFlags[slot] & FREE));
+	mFlags[slot] = FREE;
+	mTextures[slot] = NULL;
+	mFreeSlots.push_back(slot);
+}
+
+void LLTexturePriorityTable::clear()
+{
+	mVirtualSize.clear();
+	mBoostLevel.clear();
+	mCurrentDiscard.clear();
+	mDesiredDiscard.clear();
+	mFlags.clear();
+	mEstimate.clear();
+	mEvaluated.clear();
+	mTextures.clear();
+	mFreeSlots.clear();
+	mSize = 0;
+}
+
+F32 LLTexturePriorityTable::estimate(slot_t slot) const
+{
+	const U32 flags = mFlags[slot];
+	const F32 boost = mBoostLevel[slot];
+	const F32 cur = mCurrentDiscard[slot];
+	const F32 desired = mDesiredDiscard[slot];
+	const F32 pixel = sqrtf(mVirtualSize[slot]);
+
+	F32 priority;
+	if (flags & FULLY_LOADED)
+	{
+		return -1.f;
+	}
+	else if (flags & MISSING_ASSET)
+	{
+		priority = 0.f;
+	}
+	else if (cur >= 0.f && desired >= cur)
+	{
+		priority = -2.f;
+	}
+	else if (desired > MAX_DISCARD_LEVEL)
+	{
+		priority = -4.f;
+	}
+	else if (boost == LLGLTexture::BOOST_UI || boost == LLGLTexture::BOOST_ICON)
+	{
+		priority = 1.f;
+	}
+	else if (pixel < 0.001f)
+	{
+		priority = boost > LLGLTexture::BOOST_SELECTED ? 1.f : -5.f;
+	}
+	else
+	{
+		F32 ddiscard;
+		if (cur < 0.f)
+		{
+			// No data yet, calcDecodePriority() goes by log2 of the pixel size
+			U32 bits;
+			memcpy(&bits, &pixel, sizeof(bits));
+			S32 exponent = (S32)((bits >> 23) & 0xff) - 127;
+			ddiscard = llclamp((F32)exponent, 0.f, MAX_DELTA_DISCARD_LEVEL_FOR_PRIORITY);
+		}
+		else
+		{
+			ddiscard = llclamp(cur - desired, -1.f, MAX_DELTA_DISCARD_LEVEL_FOR_PRIORITY);
+		}
+		priority = (ddiscard + 1.f) * PRIORITY_DELTA_DISCARD_LEVEL_FACTOR;
+	}
+
+	if (priority > 0.f)
+	{
+		priority += llmin(pixel, MAX_PRIORITY_PIXEL) + PRIORITY_BOOST_LEVEL_FACTOR * boost;
+		if (boost > LLGLTexture::BOOST_SUPER_HIGH)
+		{
+			priority += PRIORITY_BOOST_HIGH_FACTOR;
+		}
+	}
+	return priority;
+}
+
+void LLTexturePriorityTable::selectChanged(U32 count, std::vector<slot_t>& selected)
+{
+	LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+	mCandidates.clear();
+	if (!count || !mSize)
+	{
+		return;
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 minus_one = _mm_set1_ps(-1.f);
+	const __m128 max_ddiscard = _mm_set1_ps(MAX_DELTA_DISCARD_LEVEL_FOR_PRIORITY);
+	const __m128 max_discard = _mm_set1_ps((F32)MAX_DISCARD_LEVEL);
+	const __m128 min_pixel = _mm_set1_ps(0.001f);
+	const __m128 max_pixel = _mm_set1_ps(MAX_PRIORITY_PIXEL);
+	const __m128 discard_factor = _mm_set1_ps(PRIORITY_DELTA_DISCARD_LEVEL_FACTOR);
+	const __m128 boost_factor = _mm_set1_ps(PRIORITY_BOOST_LEVEL_FACTOR);
+	const __m128 boost_high = _mm_set1_ps(PRIORITY_BOOST_HIGH_FACTOR);
+	const __m128 boost_ui = _mm_set1_ps((F32)LLGLTexture::BOOST_UI);
+	const __m128 boost_icon = _mm_set1_ps((F32)LLGLTexture::BOOST_ICON);
+	const __m128 boost_selected = _mm_set1_ps((F32)LLGLTexture::BOOST_SELECTED);
+	const __m128 boost_super_high = _mm_set1_ps((F32)LLGLTexture::BOOST_SUPER_HIGH);
+	const __m128 change_low = _mm_set1_ps(CHANGE_LOW);
+	const __m128 change_high = _mm_set1_ps(CHANGE_HIGH);
+	const __m128i skip_flags = _mm_set1_epi32(FREE | WAITING_CREATE);
+	const __m128i loaded_flag = _mm_set1_epi32(FULLY_LOADED);
+	const __m128i missing_flag = _mm_set1_epi32(MISSING_ASSET);
+	const __m128i izero = _mm_setzero_si128();
+	const __m128i exponent_bias = _mm_set1_epi32(127);
+
+	// Padding slots are FREE, so whole groups of four are always valid
+	const U32 end = (mSize + 3) & ~3U;
+	for (U32 i = 0; i < end; i += 4)
+	{
+		const __m128 boost = _mm_loadu_ps(&mBoostLevel[i]);
+		const __m128 cur = _mm_loadu_ps(&mCurrentDiscard[i]);
+		const __m128 desired = _mm_loadu_ps(&mDesiredDiscard[i]);
+		const __m128i flags = _mm_loadu_si128((const __m128i*)&mFlags[i]);
+		const __m128 pixel = _mm_sqrt_ps(_mm_loadu_ps(&mVirtualSize[i]));
+
+		// The branches of estimate(), last one first so the earlier ones
+		// win where several match
+		const __m128 no_data = _mm_cmplt_ps(cur, zero);
+		const __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(pixel), 23), exponent_bias);
+		__m128 ddiscard = _mm_or_ps(
+			_mm_and_ps(no_data, _mm_max_ps(_mm_cvtepi32_ps(exponent), zero)),
+			_mm_andnot_ps(no_data, _mm_max_ps(_mm_sub_ps(cur, desired), minus_one)));
+		ddiscard = _mm_min_ps(ddiscard, max_ddiscard);
+		__m128 priority = _mm_mul_ps(_mm_add_ps(ddiscard, one), discard_factor);
+
+		const __m128 offscreen = _mm_cmplt_ps(pixel, min_pixel);
+		const __m128 offscreen_priority = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(boost, boost_selected), one),
+			_mm_andnot_ps(_mm_cmpgt_ps(boost, boost_selected), _mm_set1_ps(-5.f)));
+		priority = _mm_or_ps(_mm_and_ps(offscreen, offscreen_priority), _mm_andnot_ps(offscreen, priority));
+
+		const __m128 ui = _mm_or_ps(_mm_cmpeq_ps(boost, boost_ui), _mm_cmpeq_ps(boost, boost_icon));
+		priority = _mm_or_ps(_mm_and_ps(ui, one), _mm_andnot_ps(ui, priority));
+
+		const __m128 not_needed = _mm_cmpgt_ps(desired, max_discard);
+		priority = _mm_or_ps(_mm_and_ps(not_needed, _mm_set1_ps(-4.f)), _mm_andnot_ps(not_needed, priority));
+
+		const __m128 have_data = _mm_and_ps(_mm_cmpge_ps(cur, zero), _mm_cmpge_ps(desired, cur));
+		priority = _mm_or_ps(_mm_and_ps(have_data, _mm_set1_ps(-2.f)), _mm_andnot_ps(have_data, priority));
+
+		const __m128 missing = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(flags, missing_flag), izero));
+		priority = _mm_andnot_ps(missing, priority);
+
+		// Pixel and boost terms on top of anything wanted
+		const __m128 wanted = _mm_cmpgt_ps(priority, zero);
+		__m128 extra = _mm_add_ps(_mm_min_ps(pixel, max_pixel), _mm_mul_ps(boost_factor, boost));
+		extra = _mm_add_ps(extra, _mm_and_ps(_mm_cmpgt_ps(boost, boost_super_high), boost_high));
+		priority = _mm_add_ps(priority, _mm_and_ps(wanted, extra));
+
+		const __m128 loaded = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(flags, loaded_flag), izero));
+		priority = _mm_or_ps(_mm_and_ps(loaded, minus_one), _mm_andnot_ps(loaded, priority));
+
+		_mm_storeu_ps(&mEstimate[i], priority);
+
+		// Changed when the non negative parts differ by the margin
+		const __m128 now = _mm_max_ps(priority, zero);
+		const __m128 then = _mm_max_ps(_mm_loadu_ps(&mEvaluated[i]), zero);
+		__m128 changed = _mm_or_ps(_mm_cmplt_ps(now, _mm_mul_ps(then, change_low)),
+								   _mm_cmpgt_ps(now, _mm_mul_ps(then, change_high)));
+		const __m128i skip = _mm_cmpgt_epi32(_mm_and_si128(flags, skip_flags), izero);
+		changed = _mm_andnot_ps(_mm_castsi128_ps(skip), changed);
+
+		S32 mask = _mm_movemask_ps(changed);
+		while (mask)
+		{
+			const S32 lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+			mask &= mask - 1;
+			mCandidates.push_back(std::make_pair(mEstimate[i + lane], (slot_t)(i + lane)));
+		}
+	}
+
+	// Top count by estimate
+	typedef std::pair<F32, slot_t> candidate_t;
+	auto higher = [](const candidate_t& a, const candidate_t& b) { return a.first > b.first; };
+	if (mCandidates.size() > count)
+	{
+		std::nth_element(mCandidates.begin(), mCandidates.begin() + count, mCandidates.end(), higher);
+		mCandidates.resize(count);
+	}
+	std::sort(mCandidates.begin(), mCandidates.end(), higher);
+	for (const candidate_t& candidate : mCandidates)
+	{
+		selected.push_back(candidate.second);
+	}
+}
+
+void LLTexturePriorityTable::setEvaluated(slot_t slot)
+{
+	mEvaluated[slot] = estimate(slot);
+}
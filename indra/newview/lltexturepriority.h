@@ -0,0 +1,107 @@
+/**
+ * @file lltexturepriority.h
+ * @brief Structure of arrays table of texture decode priority inputs.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREPRIORITY_H
+#define LL_LLTEXTUREPRIORITY_H
+
+#include <vector>
+
+class LLViewerFetchedTexture;
+
+// What LLViewerFetchedTexture::calcDecodePriority() reads, copied into one
+// array per input so the whole texture list can be estimated in a single
+// pass over contiguous memory.  Textures push their inputs in as they change
+// (faces adding texture stats, boosts, fetches completing).  Each frame
+// selectChanged() picks the textures whose estimate moved enough to be worth
+// the full, object chasing calcDecodePriority() again.
+//
+// The estimate follows the main branches of calcDecodePriority() but leaves
+// out the additional priority and large image adjustments.  It only decides
+// who gets re-evaluated, calcDecodePriority() still sets the priority.
+class LLTexturePriorityTable
+{
+public:
+	typedef S32 slot_t;
+	static const slot_t INVALID_SLOT = -1;
+
+	enum EFlags
+	{
+		FREE = 1 << 0,			// slot is not in use
+		FULLY_LOADED = 1 << 1,	// nothing left to fetch
+		MISSING_ASSET = 1 << 2,
+		WAITING_CREATE = 1 << 3	// priority is frozen until the GL texture exists
+	};
+
+	LLTexturePriorityTable();
+
+	slot_t add(LLViewerFetchedTexture* texture);
+	void remove(slot_t slot);
+	void clear();
+
+	LLViewerFetchedTexture* getTexture(slot_t slot) const	{ return mTextures[slot]; }
+	U32 size() const										{ return mSize - (U32)mFreeSlots.size(); }
+
+	void setVirtualSize(slot_t slot, F32 virtual_size)		{ mVirtualSize[slot] = virtual_size; }
+	void setBoostLevel(slot_t slot, S32 boost_level)		{ mBoostLevel[slot] = (F32)boost_level; }
+	void setDiscardLevels(slot_t slot, S32 current, S32 desired)
+	{
+		mCurrentDiscard[slot] = (F32)current;
+		mDesiredDiscard[slot] = (F32)desired;
+	}
+	void setFlags(slot_t slot, U32 flags)					{ mFlags[slot] = flags; }
+
+	// Estimates every slot and appends up to count slots whose estimate is
+	// more than 20% (the margin LLViewerTextureList ignores) away from the
+	// estimate when they were last evaluated, highest estimate first.
+	void selectChanged(U32 count, std::vector<slot_t>& selected);
+
+	// The texture in slot just had its priority recalculated
+	void setEvaluated(slot_t slot);
+
+	// Scalar estimate of one slot, what selectChanged() computes four at a
+	// time.
+	F32 estimate(slot_t slot) const;
+
+private:
+	void grow();
+
+	// Kept padded to a multiple of four slots, the padding is FREE
+	std::vector<F32> mVirtualSize;
+	std::vector<F32> mBoostLevel;
+	std::vector<F32> mCurrentDiscard;
+	std::vector<F32> mDesiredDiscard;
+	std::vector<U32> mFlags;
+	std::vector<F32> mEstimate;		// from the last selectChanged()
+	std::vector<F32> mEvaluated;	// estimate when last evaluated
+	std::vector<LLViewerFetchedTexture*> mTextures;
+
+	U32 mSize;
+	std::vector<slot_t> mFreeSlots;
+	std::vector<std::pair<F32, slot_t> > mCandidates;
+};
+
+#endif // LL_LLTEXTUREPRIORITY_H
@@ -102,6 +102,7 @@
 #include "fsradar.h"
 #include "llavataractions.h"
 #include "lldiskcache.h"
+#include "llimagej2c.h" // <FS:Kadah/>
 #include "llfloaterreg.h"
 #include "llfloatersidepanelcontainer.h"
 #include "llhudtext.h"
@@ -1101,6 +1102,21 @@ void handleDiskCacheLowWaterPctChanged(const LLSD& newValue)
 }
 // </FS:Beq>
 
+// <FS:Kadah> Open file handles
+void handleAssetFileHandlesChanged(const LLSD& newValue)
+{
+	LLDiskCache::getInstance()->setFileHandleLimit(newValue.asInteger());
+}
+// </FS:Kadah>
+
+// <FS:Kadah> Intra-image decode threads
+void handleImageDecodeThreadsPerImageChanged(const LLSD& newValue)
+{
+	LLImageJ2C::setDecodeThreads(gSavedSettings.getU32("FSImageDecodeThreadsPerImage"),
+								 gSavedSettings.getU32("FSImageDecodeThreadsPerImageMaxQueue"));
+}
+// </FS:Kadah>
+
 void handleTargetFPSChanged(const LLSD& newValue)
 {
     const auto targetFPS = gSavedSettings.getU32("TargetFPS");
@@ -1482,6 +1498,12 @@ void settings_setup_listeners()
 	setting_setup_signal_listener(gSavedSettings, "FSDiskCacheHighWaterPercent", handleDiskCacheHighWaterPctChanged);
 	setting_setup_signal_listener(gSavedSettings, "FSDiskCacheLowWaterPercent", handleDiskCacheLowWaterPctChanged);
 	// </FS:Beq>
+	setting_setup_signal_listener(gSavedSettings, "FSAssetFileHandles", handleAssetFileHandlesChanged); // <FS:Kadah/> Open file handles
+
+	// <FS:Kadah> Intra-image decode threads
+	setting_setup_signal_listener(gSavedSettings, "FSImageDecodeThreadsPerImage", handleImageDecodeThreadsPerImageChanged);
+	setting_setup_signal_listener(gSavedSettings, "FSImageDecodeThreadsPerImageMaxQueue", handleImageDecodeThreadsPerImageChanged);
+	// </FS:Kadah>
 
 	// <FS:Zi> Handle IME text input getting enabled or disabled
 #if LL_SDL2
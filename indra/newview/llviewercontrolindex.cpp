@@ -0,0 +1,40 @@
+/**
+ * @file llviewercontrolindex.cpp
+ * @brief Indexed reads of the scalar settings in gSavedSettings.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llviewercontrolindex.h"
+
+LLViewerControlIndex gSavedSettingsIndex;
+
+void LLViewerControlIndex::bind(LLControlGroup& group)
+{
+	mBools.bind(group, LLSavedSettings::BOOL_NAMES, LLSavedSettings::BOOL_COUNT);
+	mS32s.bind(group, LLSavedSettings::S32_NAMES, LLSavedSettings::S32_COUNT);
+	mU32s.bind(group, LLSavedSettings::U32_NAMES, LLSavedSettings::U32_COUNT);
+	mF32s.bind(group, LLSavedSettings::F32_NAMES, LLSavedSettings::F32_COUNT);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file llviewercontrolindex.h
+ * @brief Indexed reads of the scalar settings in gSavedSettings.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVIEWERCONTROLINDEX_H
+#define LL_LLVIEWERCONTROLINDEX_H
+
+#include "llcontrol.h"
+#include "llviewercontrolindex_gen.h"
+
+// The boolean, integer and float settings of app_settings/settings.xml, read
+// by the enums generate_settings_index.py writes for them:
+//
+//   F32 far_clip = gSavedSettingsIndex.get(LLSavedSettings::RenderFarClip);
+//
+// Each read is an array load, where gSavedSettings.getF32() looks the name
+// up in the control map and a function local LLCachedControl looks it up in
+// the cache instances.  A setting of the wrong type or one missing from
+// settings.xml does not compile.  Settings are bound once the defaults are
+// loaded, before that every value reads as zero.
+class LLViewerControlIndex
+{
+public:
+	void bind(LLControlGroup& group);
+
+	bool get(LLSavedSettings::EBool index) const { return mBools.get(index); }
+	S32 get(LLSavedSettings::ES32 index) const { return mS32s.get(index); }
+	U32 get(LLSavedSettings::EU32 index) const { return mU32s.get(index); }
+	F32 get(LLSavedSettings::EF32 index) const { return mF32s.get(index); }
+
+private:
+	LLControlSlots<bool>	mBools;
+	LLControlSlots<S32>		mS32s;
+	LLControlSlots<U32>		mU32s;
+	LLControlSlots<F32>		mF32s;
+};
+
+extern LLViewerControlIndex gSavedSettingsIndex;
+
+#endif // LL_LLVIEWERCONTROLINDEX_H
@@ -34,6 +34,7 @@
 #include "llagent.h"
 #include "llagentcamera.h"
 #include "llviewercontrol.h"
+#include "llviewercontrolindex.h" // <FS:Kadah/> Indexed settings
 #include "llcoord.h"
 #include "llcriticaldamp.h"
 #include "lldir.h"
@@ -258,7 +259,10 @@ void display_stats()
 		LLMemory::logMemoryInfo(TRUE) ;
 		gRecentMemoryTime.reset();
 	}
-    F32 asset_storage_log_freq = gSavedSettings.getF32("AssetStorageLogFrequency");
+    // <FS:Kadah> Indexed settings
+    //F32 asset_storage_log_freq = gSavedSettings.getF32("AssetStorageLogFrequency");
+    F32 asset_storage_log_freq = gSavedSettingsIndex.get(LLSavedSettings::AssetStorageLogFrequency);
+    // </FS:Kadah>
     if (asset_storage_log_freq > 0.f && gAssetStorageLogTime.getElapsedTimeF32() >= asset_storage_log_freq)
     {
 		LL_PROFILE_ZONE_NAMED_CATEGORY_DISPLAY("DS - Asset Storage");
@@ -401,7 +405,10 @@ static void update_tp_display(bool minimized)
 		// Make the user wait while content "pre-caches"
 		{
 			F32 arrival_fraction = (gTeleportArrivalTimer.getElapsedTimeF32() / teleport_arrival_delay());
-			if (arrival_fraction > 1.f || gSavedSettings.getBOOL("FSDisableTeleportScreens"))
+			// <FS:Kadah> Indexed settings
+			//if (arrival_fraction > 1.f || gSavedSettings.getBOOL("FSDisableTeleportScreens"))
+			if (arrival_fraction > 1.f || gSavedSettingsIndex.get(LLSavedSettings::FSDisableTeleportScreens))
+			// </FS:Kadah>
 			{
 				arrival_fraction = 1.f;
 				//LLFirstUse::useTeleport();
@@ -718,11 +725,18 @@ void display(BOOL rebuild, F32 zoom_factor, int subfield, BOOL for_snapshot)
 			gSavedSettings.setF32("FSSavedRenderFarClip", 0.0f);
 		}
 
+		// <FS:Kadah> Indexed settings
+		//if (gTeleportArrivalTimer.getElapsedTimeF32() >=
+		//	(F32)gSavedSettings.getU32("FSRenderFarClipSteppingInterval"))
 		if (gTeleportArrivalTimer.getElapsedTimeF32() >=
-			(F32)gSavedSettings.getU32("FSRenderFarClipSteppingInterval"))
+			(F32)gSavedSettingsIndex.get(LLSavedSettings::FSRenderFarClipSteppingInterval))
+		// </FS:Kadah>
 		{
 			gTeleportArrivalTimer.reset();
-			F32 current = gSavedSettings.getF32("RenderFarClip");
+			// <FS:Kadah> Indexed settings
+			//F32 current = gSavedSettings.getF32("RenderFarClip");
+			F32 current = gSavedSettingsIndex.get(LLSavedSettings::RenderFarClip);
+			// </FS:Kadah>
 			if (gSavedDrawDistance > current)
 			{
 				current *= 2.0f;
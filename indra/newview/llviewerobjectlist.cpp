@@ -1067,6 +1067,10 @@ void LLViewerObjectList::update(LLAgent &agent)
 	}
 	else
 	{
+		// <FS:Kadah> Parallel motion evaluation
+		LLVOAvatar::updateMotionsParallel(idle_list, idle_count);
+		// </FS:Kadah>
+
 		for (std::vector<LLViewerObject*>::iterator idle_iter = idle_list.begin();
 			idle_iter != idle_end; idle_iter++)
 		{
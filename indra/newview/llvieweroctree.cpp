@@ -460,7 +460,11 @@ LLViewerOctreeGroup::~LLViewerOctreeGroup()
 LLViewerOctreeGroup::LLViewerOctreeGroup(OctreeNode* node)
 :	mOctreeNode(node),
 	mAnyVisible(0),
-	mState(CLEAN)
+	mState(CLEAN),
+	// <FS:Kadah> Flat frustum culling
+	mCullBounds(NULL),
+	mCullSlot(LLCullBoundsArray::INVALID_SLOT)
+	// </FS:Kadah>
 {
 	LLVector4a tmp;
 	tmp.splat(0.f);
@@ -602,6 +606,7 @@ void LLViewerOctreeGroup::rebound()
 		mBounds[1].mul(0.5f);
 	}
 	
+	writeCullBounds(); // <FS:Kadah/> Flat frustum culling
 	clearState(DIRTY);
 
 	return;
@@ -637,6 +642,7 @@ void LLViewerOctreeGroup::handleDestruction(const TreeNode* node)
 		}
 	}
 	mOctreeNode = NULL;
+	releaseCullBounds(); // <FS:Kadah/> Flat frustum culling
 }
 	
 //virtual 
@@ -673,6 +679,28 @@ void LLViewerOctreeGroup::handleChildRemoval(const OctreeNode* parent, const Oct
 	unbound();
 }
 
+// <FS:Kadah> Flat frustum culling
+void LLViewerOctreeGroup::writeCullBounds()
+{
+	if (mCullBounds)
+	{
+		mCullBounds->set(mCullSlot, mBounds[0], mBounds[1]);
+	}
+}
+
+// Groups can outlive their node and the partition, give the slot back
+// while the array is still there
+void LLViewerOctreeGroup::releaseCullBounds()
+{
+	if (mCullBounds)
+	{
+		mCullBounds->remove(mCullSlot);
+		mCullBounds = NULL;
+		mCullSlot = LLCullBoundsArray::INVALID_SLOT;
+	}
+}
+// </FS:Kadah>
+
 LLViewerOctreeGroup* LLViewerOctreeGroup::getParent()
 {
 	if (isDead())
@@ -874,11 +902,19 @@ LLOcclusionCullingGroup::LLOcclusionCullingGroup(OctreeNode* node, LLViewerOctre
 		mOcclusionState[i] = parent ? SG_STATE_INHERIT_MASK & parent->mOcclusionState[i] : 0;
 		mVisible[i] = 0;
 	}
+
+	// <FS:Kadah> Flat frustum culling, next to the parent so that siblings
+	// share a block
+	mCullBounds = &part->mGroupCullBounds;
+	mCullSlot = mCullBounds->add(parent && parent->mCullBounds == mCullBounds ? parent->mCullSlot : LLCullBoundsArray::INVALID_SLOT);
+	writeCullBounds();
+	// </FS:Kadah>
 }
 
 LLOcclusionCullingGroup::~LLOcclusionCullingGroup()
 {
 	releaseOcclusionQueryObjectNames();
+	releaseCullBounds(); // <FS:Kadah/> Flat frustum culling
 }
 
 BOOL LLOcclusionCullingGroup::needsUpdate()
@@ -1324,7 +1360,8 @@ LLViewerOctreePartition::LLViewerOctreePartition() :
 	center.splat(0.f);
 	size.splat(1.f);
 
-	mOctree = new OctreeRoot(center,size, NULL);
+	//mOctree = new OctreeRoot(center,size, NULL);
+	mOctree = new OctreeRoot(center,size, NULL, true); // <FS:Kadah/> Pooled octree nodes, objects moving churn them
 }
 	
 LLViewerOctreePartition::~LLViewerOctreePartition()
@@ -1348,6 +1385,8 @@ BOOL LLViewerOctreePartition::isOcclusionEnabled()
 //class LLViewerOctreeCull definitions
 //-----------------------------------------------------------------------------------
 
+bool LLViewerOctreeCull::sFlatFrustumCull = false; // <FS:Kadah/> Flat frustum culling
+
 //virtual 
 bool LLViewerOctreeCull::earlyFail(LLViewerOctreeGroup* group)
 {	
@@ -1386,10 +1425,51 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
 	}
 }
 	
+// <FS:Kadah> Flat frustum culling
+// A culler walks one partition with one camera, each kind of test sets its
+// pass up the first time a group of that partition asks.  The groups of a
+// partition all share its array.
+S32 LLViewerOctreeCull::flatFrustumCheck(const LLViewerOctreeGroup* group, EFlatCull mode)
+{
+	if (!sFlatFrustumCull || !group->mCullBounds)
+	{
+		return -1;
+	}
+
+	LLCullBoundsPass& pass = mFlatPasses[mode];
+	if (pass.getBounds() != group->mCullBounds)
+	{
+		switch (mode)
+		{
+		case FLAT_CULL_FRUSTUM:
+			mCamera->AABBInFrustum(*group->mCullBounds, pass);
+			break;
+		case FLAT_CULL_FRUSTUM_NO_FAR_CLIP:
+			mCamera->AABBInFrustumNoFarClip(*group->mCullBounds, pass);
+			break;
+		case FLAT_CULL_REGION:
+			mCamera->AABBInRegionFrustum(*group->mCullBounds, pass);
+			break;
+		default:
+			mCamera->AABBInRegionFrustumNoFarClip(*group->mCullBounds, pass);
+			break;
+		}
+	}
+	return pass.get(group->mCullSlot);
+}
+// </FS:Kadah>
+
 //------------------------------------------
 //agent space group culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
 {
+	// <FS:Kadah> Flat frustum culling
+	S32 res = flatFrustumCheck(group, FLAT_CULL_FRUSTUM_NO_FAR_CLIP);
+	if (res >= 0)
+	{
+		return res;
+	}
+	// </FS:Kadah>
 	return mCamera->AABBInFrustumNoFarClip(group->mBounds[0], group->mBounds[1]);
 }
 
@@ -1400,6 +1480,13 @@ S32 LLViewerOctreeCull::AABBSphereIntersectGroupExtents(const LLViewerOctreeGrou
 
 S32 LLViewerOctreeCull::AABBInFrustumGroupBounds(const LLViewerOctreeGroup* group)
 {
+	// <FS:Kadah> Flat frustum culling
+	S32 res = flatFrustumCheck(group, FLAT_CULL_FRUSTUM);
+	if (res >= 0)
+	{
+		return res;
+	}
+	// </FS:Kadah>
 	return mCamera->AABBInFrustum(group->mBounds[0], group->mBounds[1]);
 }
 //------------------------------------------
@@ -1426,11 +1513,25 @@ S32 LLViewerOctreeCull::AABBInFrustumObjectBounds(const LLViewerOctreeGroup* gro
 //local regional space group culling
 S32 LLViewerOctreeCull::AABBInRegionFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
 {
+	// <FS:Kadah> Flat frustum culling
+	S32 res = flatFrustumCheck(group, FLAT_CULL_REGION_NO_FAR_CLIP);
+	if (res >= 0)
+	{
+		return res;
+	}
+	// </FS:Kadah>
 	return mCamera->AABBInRegionFrustumNoFarClip(group->mBounds[0], group->mBounds[1]);
 }
 
 S32 LLViewerOctreeCull::AABBInRegionFrustumGroupBounds(const LLViewerOctreeGroup* group)
 {
+	// <FS:Kadah> Flat frustum culling
+	S32 res = flatFrustumCheck(group, FLAT_CULL_REGION);
+	if (res >= 0)
+	{
+		return res;
+	}
+	// </FS:Kadah>
 	return mCamera->AABBInRegionFrustum(group->mBounds[0], group->mBounds[1]);
 }
 
@@ -38,6 +38,7 @@
 #include "llquaternion.h"
 #include "lloctree.h"
 #include "llviewercamera.h"
+#include "llcullboundsarray.h" // <FS:Kadah/> Flat frustum culling
 
 class LLViewerRegion;
 class LLViewerOctreeEntryData;
@@ -205,6 +206,10 @@ public:
 	LLViewerOctreeGroup(const LLViewerOctreeGroup& rhs)
 	{
 		*this = rhs;
+		// <FS:Kadah> Flat frustum culling, a copy has no slot of its own
+		mCullBounds = NULL;
+		mCullSlot = LLCullBoundsArray::INVALID_SLOT;
+		// </FS:Kadah>
 	}
 
 	bool removeFromGroup(LLViewerOctreeEntryData* data);
@@ -252,6 +257,10 @@ public:
 	
 protected:
 	void checkStates();
+	// <FS:Kadah> Flat frustum culling
+	void writeCullBounds();
+	void releaseCullBounds();
+	// </FS:Kadah>
 private:
 	virtual bool boundObjects(BOOL empty, LLVector4a& minOut, LLVector4a& maxOut);			
 
@@ -267,6 +276,10 @@ protected:
 	S32         mAnyVisible; //latest visible to any camera
 	S32         mVisible[LLViewerCamera::NUM_CAMERAS];	
 
+	// <FS:Kadah> Flat frustum culling
+	LLCullBoundsArray*        mCullBounds; // mBounds are copied to this slot of the partition's array
+	LLCullBoundsArray::slot_t mCullSlot;
+	// </FS:Kadah>
 };//LL_ALIGN_POSTFIX(16);
 
 //octree group which has capability to support occlusion culling
@@ -299,6 +312,10 @@ public:
 	LLOcclusionCullingGroup(const LLOcclusionCullingGroup& rhs) : LLViewerOctreeGroup(rhs)
 	{
 		*this = rhs;
+		// <FS:Kadah> Flat frustum culling
+		mCullBounds = NULL;
+		mCullSlot = LLCullBoundsArray::INVALID_SLOT;
+		// </FS:Kadah>
 	}	
 
 	void setOcclusionState(U32 state, S32 mode = STATE_MODE_SINGLE);
@@ -363,6 +380,7 @@ public:
 	BOOL             mOcclusionEnabled; // if TRUE, occlusion culling is performed
 	U32              mLODSeed;
 	U32              mLODPeriod;	//number of frames between LOD updates for a given spatial group (staggered by mLODSeed)
+	LLCullBoundsArray mGroupCullBounds; // <FS:Kadah/> Bounds of every group, for flat frustum culling
 };
 
 class LLViewerOctreeCull : public OctreeTraveler
@@ -399,6 +417,20 @@ protected:
 	virtual S32 frustumCheck(const LLViewerOctreeGroup* group) = 0;
 	virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group) = 0;
 
+	// <FS:Kadah> Flat frustum culling
+	enum EFlatCull
+	{
+		FLAT_CULL_FRUSTUM = 0,
+		FLAT_CULL_FRUSTUM_NO_FAR_CLIP,
+		FLAT_CULL_REGION,
+		FLAT_CULL_REGION_NO_FAR_CLIP,
+		FLAT_CULL_COUNT
+	};
+	// The group bounds test answered from the partition's array, -1 when
+	// the group has no slot in one or flat culling is off
+	S32 flatFrustumCheck(const LLViewerOctreeGroup* group, EFlatCull mode);
+	// </FS:Kadah>
+
 	bool checkProjectionArea(const LLVector4a& center, const LLVector4a& size, const LLVector3& shift, F32 pixel_threshold, F32 near_radius);
 	virtual bool checkObjects(const OctreeNode* branch, const LLViewerOctreeGroup* group);
 	virtual void preprocess(LLViewerOctreeGroup* group);
@@ -408,6 +440,10 @@ protected:
 protected:
 	LLCamera *mCamera;
 	S32 mRes;
+	LLCullBoundsPass mFlatPasses[FLAT_CULL_COUNT]; // <FS:Kadah/> Flat frustum culling
+
+public:
+	static bool sFlatFrustumCull; // <FS:Kadah/> Flat frustum culling
 };
 
 //scan the octree, output the info of each node for debug use.
@@ -699,6 +699,12 @@ LLViewerTexture::LLViewerTexture(const LLImageRaw* raw, BOOL usemipmaps) :
 LLViewerTexture::~LLViewerTexture()
 {
 	// LL_DEBUGS("Avatar") << mID << LL_ENDL;
+	// <FS:Kadah> Texture priority table
+	if (mPrioritySlot != LLTexturePriorityTable::INVALID_SLOT)
+	{
+		gTextureList.mPriorityTable.remove(mPrioritySlot);
+	}
+	// </FS:Kadah>
 	cleanup();
 	sImageCount--;
 }
@@ -711,6 +717,7 @@ void LLViewerTexture::init(bool firstinit)
 	mMaxVirtualSizeResetInterval = 1;
 	mMaxVirtualSizeResetCounter = mMaxVirtualSizeResetInterval;
 	mAdditionalDecodePriority = 0.f;	
+	mPrioritySlot = LLTexturePriorityTable::INVALID_SLOT; // <FS:Kadah/> Texture priority table
 	mParcelMedia = NULL;
 	
 	memset(&mNumVolumes, 0, sizeof(U32)* LLRender::NUM_VOLUME_TEXTURE_CHANNELS);
@@ -785,6 +792,12 @@ void LLViewerTexture::setBoostLevel(S32 level)
 	if(mBoostLevel != level)
 	{
 		mBoostLevel = level;
+		// <FS:Kadah> Texture priority table
+		if (mPrioritySlot != LLTexturePriorityTable::INVALID_SLOT)
+		{
+			gTextureList.mPriorityTable.setBoostLevel(mPrioritySlot, mBoostLevel);
+		}
+		// </FS:Kadah>
 		if(mBoostLevel != LLViewerTexture::BOOST_NONE && 
 			mBoostLevel != LLViewerTexture::BOOST_ALM && 
 			mBoostLevel != LLViewerTexture::BOOST_SELECTED && 
@@ -889,6 +902,17 @@ void LLViewerTexture::addTextureStats(F32 virtual_size, BOOL needs_gltexture) co
 	{
 		mMaxVirtualSize = virtual_size;
 	}
+	// <FS:Kadah> Texture priority table
+	else
+	{
+		return;
+	}
+
+	if (mPrioritySlot != LLTexturePriorityTable::INVALID_SLOT)
+	{
+		gTextureList.mPriorityTable.setVirtualSize(mPrioritySlot, mMaxVirtualSize);
+	}
+	// </FS:Kadah>
 }
 
 void LLViewerTexture::resetTextureStats()
@@ -896,6 +920,12 @@ void LLViewerTexture::resetTextureStats()
 	mMaxVirtualSize = 0.0f;
 	mAdditionalDecodePriority = 0.f;	
 	mMaxVirtualSizeResetCounter = 0;
+	// <FS:Kadah> Texture priority table
+	if (mPrioritySlot != LLTexturePriorityTable::INVALID_SLOT)
+	{
+		gTextureList.mPriorityTable.setVirtualSize(mPrioritySlot, mMaxVirtualSize);
+	}
+	// </FS:Kadah>
 }
 
 //virtual 
@@ -1283,6 +1313,7 @@ void LLViewerFetchedTexture::loadFromFastCache()
     mInFastCacheList = FALSE;
 
     add(LLTextureFetch::sCacheAttempt, 1.0);
+    add(LLTextureFetch::sFastCacheAttempt, 1.0); // <FS:Kadah/> Fast cache v2
 
     LLTimer fastCacheTimer;
 	mRawImage = LLAppViewer::getTextureCache()->readFromFastCache(getID(), mRawDiscardLevel);
@@ -1293,6 +1324,11 @@ void LLViewerFetchedTexture::loadFromFastCache()
         add(LLTextureFetch::sCacheHit, 1.0);
         record(LLTextureFetch::sCacheHitRate, LLUnits::Ratio::fromValue(1));
         sample(LLTextureFetch::sCacheReadLatency, cachReadTime);
+        // <FS:Kadah> Fast cache v2
+        add(LLTextureFetch::sFastCacheHit, 1.0);
+        record(LLTextureFetch::sFastCacheHitRate, LLUnits::Ratio::fromValue(1));
+        add(LLTextureFetch::sFastCacheBytesSaved, F64Bytes(mRawImage->getDataSize()));
+        // </FS:Kadah>
 
 		mFullWidth  = mRawImage->getWidth()  << mRawDiscardLevel;
 		mFullHeight = mRawImage->getHeight() << mRawDiscardLevel;
@@ -1312,6 +1348,7 @@ void LLViewerFetchedTexture::loadFromFastCache()
             {
                 // Shouldn't do anything usefull since texures in fast cache are 16x16,
                 // it is here in case fast cache changes.
+                // <FS:Kadah/> It does now, the fast cache keeps up to FSFastCacheResolution pixels.
                 S32 expected_width = mKnownDrawWidth > 0 ? mKnownDrawWidth : DEFAULT_ICON_DIMENTIONS;
                 S32 expected_height = mKnownDrawHeight > 0 ? mKnownDrawHeight : DEFAULT_ICON_DIMENTIONS;
                 if (mRawImage && (mRawImage->getWidth() > expected_width || mRawImage->getHeight() > expected_height))
@@ -1329,6 +1366,7 @@ void LLViewerFetchedTexture::loadFromFastCache()
     else
     {
         record(LLTextureFetch::sCacheHitRate, LLUnits::Ratio::fromValue(0));
+        record(LLTextureFetch::sFastCacheHitRate, LLUnits::Ratio::fromValue(0)); // <FS:Kadah/> Fast cache v2
     }
 }
 
@@ -2086,6 +2124,35 @@ F32 LLViewerFetchedTexture::maxDecodePriority()
 	return max_priority;
 }
 
+// <FS:Kadah> Texture priority table
+void LLViewerFetchedTexture::updatePriorityInputs()
+{
+	if (mPrioritySlot == LLTexturePriorityTable::INVALID_SLOT)
+	{
+		return;
+	}
+
+	LLTexturePriorityTable& table = gTextureList.mPriorityTable;
+	U32 flags = 0;
+	if (mNeedsCreateTexture)
+	{
+		flags |= LLTexturePriorityTable::WAITING_CREATE;
+	}
+	if (mFullyLoaded && !mForceToSaveRawImage)
+	{
+		flags |= LLTexturePriorityTable::FULLY_LOADED;
+	}
+	if (mIsMissingAsset)
+	{
+		flags |= LLTexturePriorityTable::MISSING_ASSET;
+	}
+	table.setFlags(mPrioritySlot, flags);
+	table.setDiscardLevels(mPrioritySlot, getCurrentDiscardLevelForFetching(), mDesiredDiscardLevel);
+	table.setBoostLevel(mPrioritySlot, mBoostLevel);
+	table.setVirtualSize(mPrioritySlot, mMaxVirtualSize);
+}
+// </FS:Kadah>
+
 //============================================================================
 
 void LLViewerFetchedTexture::setDecodePriority(F32 priority)
@@ -154,6 +154,11 @@ public:
 
 	virtual F32  getMaxVirtualSize() ;
 
+	// <FS:Kadah> Texture priority table
+	S32 getPrioritySlot() const { return mPrioritySlot; }
+	void setPrioritySlot(S32 slot) { mPrioritySlot = slot; }
+	// </FS:Kadah>
+
 	LLFrameTimer* getLastReferencedTimer() {return &mLastReferencedTimer ;}
 	
 	S32 getFullWidth() const { return mFullWidth; }
@@ -212,6 +217,7 @@ protected:
 	mutable S32  mMaxVirtualSizeResetInterval;
 	mutable F32 mAdditionalDecodePriority;  // priority add to mDecodePriority.
 	LLFrameTimer mLastReferencedTimer;	
+	S32 mPrioritySlot; // <FS:Kadah/> Texture priority table: slot in gTextureList.mPriorityTable, -1 when not listed
 
 	ll_face_list_t    mFaceList[LLRender::NUM_TEXTURE_CHANNELS]; //reverse pointer pointing to the faces using this image as texture
 	U32               mNumFaces[LLRender::NUM_TEXTURE_CHANNELS];
@@ -376,6 +382,7 @@ public:
 
 	virtual void processTextureStats() ;
 	F32  calcDecodePriority() ;
+	void updatePriorityInputs(); // <FS:Kadah/> Texture priority table: copy what calcDecodePriority() reads into the table
 
 	BOOL needsAux() const { return mNeedsAux; }
 
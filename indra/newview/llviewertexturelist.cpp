@@ -365,6 +365,14 @@ void LLViewerTextureList::shutdown()
 	mImagesWithChangedPriorities.clear();
 	// </FS:ND>
 	
+	// <FS:Kadah> Texture priority table
+	for (uuid_map_t::value_type& entry : mUUIDMap)
+	{
+		entry.second->setPrioritySlot(LLTexturePriorityTable::INVALID_SLOT);
+	}
+	mPriorityTable.clear();
+	// </FS:Kadah>
+
 	mUUIDMap.clear();
 	
 	mImageList.clear();
@@ -751,12 +759,26 @@ void LLViewerTextureList::addImage(LLViewerFetchedTexture *new_image, ETexListTy
 	if (image)
 	{
 		LL_INFOS() << "Image with ID " << image_id << " already in list" << LL_ENDL;
+		// <FS:Kadah> Texture priority table
+		if (image != new_image && image->getPrioritySlot() != LLTexturePriorityTable::INVALID_SLOT)
+		{
+			mPriorityTable.remove(image->getPrioritySlot());
+			image->setPrioritySlot(LLTexturePriorityTable::INVALID_SLOT);
+		}
+		// </FS:Kadah>
 	}
 	sNumImages++;
 
 	addImageToList(new_image);
 	mUUIDMap[key] = new_image;
 	new_image->setTextureListType(tex_type);
+	// <FS:Kadah> Texture priority table
+	if (new_image->getPrioritySlot() == LLTexturePriorityTable::INVALID_SLOT)
+	{
+		new_image->setPrioritySlot(mPriorityTable.add(new_image));
+	}
+	new_image->updatePriorityInputs();
+	// </FS:Kadah>
 	// <FS:Beq/> FIRE-30559 texture fetch speedup for user previews (based on patches from Oren Hurvitz)
 	gTextureList.recalcImageDecodePriority(new_image);
 }
@@ -774,6 +796,14 @@ void LLViewerTextureList::deleteImage(LLViewerFetchedTexture *image)
 		// <FS:Beq/> FIRE-30559 texture fetch speedup for user previews (based on patches from Oren Hurvitz)
 		mImagesWithChangedPriorities.erase(image);
 
+		// <FS:Kadah> Texture priority table
+		if (image->getPrioritySlot() != LLTexturePriorityTable::INVALID_SLOT)
+		{
+			mPriorityTable.remove(image->getPrioritySlot());
+			image->setPrioritySlot(LLTexturePriorityTable::INVALID_SLOT);
+		}
+		// </FS:Kadah>
+
 		LLTextureKey key(image->getID(), (ETexListType)image->getTextureListType());
 		llverify(mUUIDMap.erase(key) == 1);
 		sNumImages--;
@@ -1022,6 +1052,31 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 		updateOneImageDecodePriority(imagep);
 	}
 
+	// <FS:Kadah> Texture priority table
+	// Then the textures whose estimated priority moved the most since they
+	// were last evaluated, found in one pass over the whole table instead
+	// of waiting for the round robin below to reach them.
+	static LLCachedControl<S32> priority_updates(gSavedSettings, "FSTexturePriorityUpdates");
+	if (priority_updates > 0)
+	{
+		static std::vector<LLTexturePriorityTable::slot_t> selected;
+		selected.clear();
+		mPriorityTable.selectChanged(priority_updates, selected);
+		for (LLTexturePriorityTable::slot_t slot : selected)
+		{
+			LLPointer<LLViewerFetchedTexture> imagep = mPriorityTable.getTexture(slot);
+			updateOneImageDecodePriority(imagep);
+			// Also when updateOneImageDecodePriority() returned early, so an
+			// inactive texture is not picked again every frame
+			if (imagep->getPrioritySlot() != LLTexturePriorityTable::INVALID_SLOT)
+			{
+				imagep->updatePriorityInputs();
+				mPriorityTable.setEvaluated(imagep->getPrioritySlot());
+			}
+		}
+	}
+	// </FS:Kadah>
+
 	// Second, process all of the images
 	uuid_map_t::iterator iter = mUUIDMap.upper_bound(mLastUpdateKey);
 	while ((update_counter-- > 0) && !mUUIDMap.empty())
@@ -1127,6 +1182,13 @@ void LLViewerTextureList::updateOneImageDecodePriority(LLPointer<LLViewerFetched
 		imagep->setDecodePriority(decode_priority);
 		mImageList.insert(imagep);
 	}
+	// <FS:Kadah> Texture priority table
+	if (imagep->getPrioritySlot() != LLTexturePriorityTable::INVALID_SLOT)
+	{
+		imagep->updatePriorityInputs();
+		mPriorityTable.setEvaluated(imagep->getPrioritySlot());
+	}
+	// </FS:Kadah>
 }
 // </FS:Beq> FIRE-30559 
 
@@ -1325,6 +1387,7 @@ F32 LLViewerTextureList::updateImagesFetchTextures(F32 max_time)
 	{
 		LLViewerFetchedTexture* imagep = *iter3++;
         imagep->updateFetch();
+		imagep->updatePriorityInputs(); // <FS:Kadah/> Texture priority table
 
 		if (min_count <= min_update_count)
 		{
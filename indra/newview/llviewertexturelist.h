@@ -32,6 +32,7 @@
 #include "llgl.h"
 #include "llviewertexture.h"
 #include "llui.h"
+#include "lltexturepriority.h" // <FS:Kadah/> Texture priority table
 #include <list>
 #include <set>
 #include <deque>
@@ -237,6 +238,11 @@ public:
 	// to the head(-ish) of the line.)
 	void recalcImageDecodePriority(LLPointer<LLViewerFetchedTexture> image);
 	// </FS:Beq>
+
+	// <FS:Kadah> Texture priority table
+	// Decode priority inputs of every texture in mUUIDMap
+	LLTexturePriorityTable mPriorityTable;
+	// </FS:Kadah>
 private:
     typedef std::map< LLTextureKey, LLPointer<LLViewerFetchedTexture> > uuid_map_t;
     uuid_map_t mUUIDMap;
@@ -828,6 +828,11 @@ public:
 				addText(xpos, ypos, llformat("%.3f/%.3f MB Mesh Cache Read/Write ", LLMeshRepository::sCacheBytesRead/(1024.f*1024.f), LLMeshRepository::sCacheBytesWritten/(1024.f*1024.f)));
                 ypos += y_inc;
 
+				// <FS:Kadah> Decoded mesh LOD cache
+				addText(xpos, ypos, llformat("%d/%d Mesh LOD Cache Hits/Misses, %.2f s Decode Saved", LLMeshRepository::sLODCacheHits, LLMeshRepository::sLODCacheMisses, LLMeshRepository::sLODCacheSecondsSaved));
+				ypos += y_inc;
+				// </FS:Kadah>
+
                 addText(xpos, ypos, llformat("%.3f/%.3f MB Mesh Skins/Decompositions Memory", LLMeshRepository::sCacheBytesSkins / (1024.f*1024.f), LLMeshRepository::sCacheBytesDecomps / (1024.f*1024.f)));
                 ypos += y_inc;
 
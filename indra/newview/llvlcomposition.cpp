@@ -128,7 +128,10 @@ BOOL LLVLComposition::generateHeights(const F32 x, const F32 y,
 	x_begin = ll_round( x * mScaleInv );
 	y_begin = ll_round( y * mScaleInv );
 	x_end = ll_round( (x + width) * mScaleInv );
-	y_end = ll_round( (y + width) * mScaleInv );
+	// <FS:Kadah> Dirty rect terrain updates: patches ask for any rect now
+	//y_end = ll_round( (y + width) * mScaleInv );
+	y_end = ll_round( (y + height) * mScaleInv );
+	// </FS:Kadah>
 
 	if (x_end > mWidth)
 	{
@@ -340,7 +343,10 @@ BOOL LLVLComposition::generateTexture(const F32 x, const F32 y,
 	x_begin = (S32)(x * mScaleInv);
 	y_begin = (S32)(y * mScaleInv);
 	x_end = ll_round( (x + width) * mScaleInv );
-	y_end = ll_round( (y + width) * mScaleInv );
+	// <FS:Kadah> Dirty rect terrain updates: patches ask for any rect now
+	//y_end = ll_round( (y + width) * mScaleInv );
+	y_end = ll_round( (y + height) * mScaleInv );
+	// </FS:Kadah>
 
 	if (x_end > mWidth)
 	{
@@ -393,7 +399,17 @@ BOOL LLVLComposition::generateTexture(const F32 x, const F32 y,
 	tex_x_ratiof = (F32)mWidth*mScale / (F32)tex_width;
 	tex_y_ratiof = (F32)mWidth*mScale / (F32)tex_height;
 
-	LLPointer<LLImageRaw> raw = new LLImageRaw(tex_width, tex_height, tex_comps);
+	// <FS:Kadah> Dirty rect terrain updates
+	// Only the texels in the rect are written and uploaded, keep the
+	// region sized buffer around instead of allocating one per patch.
+	//LLPointer<LLImageRaw> raw = new LLImageRaw(tex_width, tex_height, tex_comps);
+	if (mTexRaw.isNull() || mTexRaw->getWidth() != tex_width || mTexRaw->getHeight() != tex_height
+		|| mTexRaw->getComponents() != tex_comps)
+	{
+		mTexRaw = new LLImageRaw(tex_width, tex_height, tex_comps);
+	}
+	LLPointer<LLImageRaw> raw = mTexRaw;
+	// </FS:Kadah>
 	U8 *rawp = raw->getData();
 
 	F32 st_x_stride, st_y_stride;
@@ -75,6 +75,7 @@ protected:
 
 	LLPointer<LLViewerFetchedTexture> mDetailTextures[CORNER_COUNT];
 	LLPointer<LLImageRaw> mRawImages[CORNER_COUNT];
+	LLPointer<LLImageRaw> mTexRaw; // <FS:Kadah/> Dirty rect terrain updates: texture scratch
 
 	F32 mStartHeight[CORNER_COUNT];
 	F32 mHeightRange[CORNER_COUNT];
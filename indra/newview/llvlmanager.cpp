@@ -35,6 +35,11 @@
 #include "llframetimer.h"
 #include "llsurface.h"
 #include "llbitpack.h"
+// <FS:Kadah> Background terrain decoding
+#include "workqueue.h"
+
+#include <atomic>
+// </FS:Kadah>
 
 const	char	LAND_LAYER_CODE					= 'L';
 const	char	WIND_LAYER_CODE					= '7';
@@ -51,8 +56,56 @@ const	char	AURORA_CLOUD_LAYER_CODE			= ':';
 
 LLVLManager gVLManager;
 
+// <FS:Kadah> Background terrain decoding
+struct LLVLManager::LandJob
+{
+	LandJob(LLVLData *datap, BOOL b_large_patch)
+	:	mData(datap),
+		mLargePatch(b_large_patch),
+		mDone(false)
+	{
+	}
+
+	~LandJob()
+	{
+		delete mData;
+	}
+
+	// Any thread. Reads the packet bytes only, never the region.
+	void decode()
+	{
+		LLBitPack bit_pack(mData->mData, mData->mSize);
+		LLGroupHeader goph;
+		unpack_patch_group_header(bit_pack, &goph);
+		LLSurface::decodeDCTPatches(bit_pack, goph, mLargePatch, mData->mSize, mPatches);
+		mDone.store(true, std::memory_order_release);
+	}
+
+	LLVLData *mData;
+	BOOL mLargePatch;
+	LLSurface::DecodedPatches mPatches;
+	std::atomic<bool> mDone;
+};
+
+// Later packets overwrite earlier ones, so jobs are applied in arrival
+// order even if they finish out of order.
+void LLVLManager::applyLandJobs()
+{
+	while (!mLandJobs.empty() && mLandJobs.front()->mDone.load(std::memory_order_acquire))
+	{
+		land_job_ptr_t job = mLandJobs.front();
+		mLandJobs.pop_front();
+		job->mData->mRegionp->getLand().applyDecodedPatches(job->mPatches, job->mLargePatch);
+	}
+}
+// </FS:Kadah>
+
 LLVLManager::~LLVLManager()
 {
+	// <FS:Kadah> Background terrain decoding
+	// Jobs still decoding hold their own reference.
+	mLandJobs.clear();
+	// </FS:Kadah>
 	S32 i;
 	for (i = 0; i < mPacketData.size(); i++)
 	{
@@ -102,26 +155,50 @@ void LLVLManager::unpackData(const S32 num_packets)
 {
 	static LLFrameTimer decode_timer;
 	
+	// <FS:Kadah> Background terrain decoding
+	applyLandJobs();
+	LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+	// </FS:Kadah>
+
 	S32 i;
 	for (i = 0; i < mPacketData.size(); i++)
 	{
 		LLVLData *datap = mPacketData[i];
 
+		// <FS:Kadah> Background terrain decoding
+		// Land is decoded on the General thread pool, or right here
+		// without one, and handed to the surface by applyLandJobs().
+		if (LAND_LAYER_CODE == datap->mType || AURORA_LAND_LAYER_CODE == datap->mType)
+		{
+			land_job_ptr_t job = std::make_shared<LandJob>(datap, AURORA_LAND_LAYER_CODE == datap->mType);
+			mPacketData[i] = NULL;
+			mLandJobs.push_back(job);
+			if (!general_queue || !general_queue->postIfOpen([job]() { job->decode(); }))
+			{
+				job->decode();
+			}
+			continue;
+		}
+		// </FS:Kadah>
+
 		LLBitPack bit_pack(datap->mData, datap->mSize);
 		LLGroupHeader goph;
 
 		decode_patch_group_header(bit_pack, &goph);
-		if (LAND_LAYER_CODE == datap->mType)
-		{
-			datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, FALSE);
-		}
+		// <FS:Kadah> Background terrain decoding
+		//if (LAND_LAYER_CODE == datap->mType)
+		//{
+		//	datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, FALSE);
+		//}
 // <FS:CR> Aurora Sim
-		else if (AURORA_LAND_LAYER_CODE == datap->mType)
-		{
-			datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, TRUE);
-		}
+		//else if (AURORA_LAND_LAYER_CODE == datap->mType)
+		//{
+		//	datap->mRegionp->getLand().decompressDCTPatch(bit_pack, &goph, TRUE);
+		//}
 		//else if (WIND_LAYER_CODE == datap->mType)
-		else if (WIND_LAYER_CODE == datap->mType || AURORA_WIND_LAYER_CODE == datap->mType)
+		//else if (WIND_LAYER_CODE == datap->mType || AURORA_WIND_LAYER_CODE == datap->mType)
+		if (WIND_LAYER_CODE == datap->mType || AURORA_WIND_LAYER_CODE == datap->mType)
+		// </FS:Kadah>
 // </FS:CR> Aurora Sim
 		{
 			datap->mRegionp->mWind.decompress(bit_pack, &goph);
@@ -146,6 +223,7 @@ void LLVLManager::unpackData(const S32 num_packets)
 	}
 	mPacketData.clear();
 
+	applyLandJobs(); // <FS:Kadah/> The ones decoded right here
 }
 
 void LLVLManager::resetBitCounts()
@@ -175,6 +253,20 @@ S32Bytes LLVLManager::getTotalBytes() const
 
 void LLVLManager::cleanupData(LLViewerRegion *regionp)
 {
+	// <FS:Kadah> Background terrain decoding
+	for (std::deque<land_job_ptr_t>::iterator iter = mLandJobs.begin(); iter != mLandJobs.end(); )
+	{
+		if ((*iter)->mData->mRegionp == regionp)
+		{
+			iter = mLandJobs.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+	// </FS:Kadah>
+
 	S32 cur = 0;
 	while (cur < mPacketData.size())
 	{
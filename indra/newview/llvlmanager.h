@@ -30,6 +30,10 @@
 // This class manages the data coming in for viewer layers from the network.
 
 #include "stdtypes.h"
+// <FS:Kadah> Background terrain decoding
+#include <deque>
+#include <memory>
+// </FS:Kadah>
 
 class LLVLData;
 class LLViewerRegion;
@@ -53,6 +57,16 @@ public:
 
 	void cleanupData(LLViewerRegion *regionp);
 protected:
+	// <FS:Kadah> Background terrain decoding
+	// A land packet being decoded on the General thread pool. Applied to
+	// the surface in arrival order once done.
+	struct LandJob;
+	typedef std::shared_ptr<LandJob> land_job_ptr_t;
+
+	void applyLandJobs();
+
+	std::deque<land_job_ptr_t> mLandJobs;
+	// </FS:Kadah>
 
 	std::vector<LLVLData *> mPacketData;
 	U32Bits mLandBits;
@@ -701,6 +701,8 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 	mNeedsSkin(FALSE),
 	mLastSkinTime(0.f),
 	mUpdatePeriod(1),
+	mParallelMotionCandidate(false), // <FS:Kadah/> Parallel motion evaluation
+	mParallelMotionFrame(U32_MAX), // <FS:Kadah/> Parallel motion evaluation
 	mOverallAppearance(AOA_INVISIBLE),
 	mVisualComplexityStale(true),
 	mVisuallyMuteSetting(AV_RENDER_NORMALLY),
@@ -5233,6 +5235,11 @@ bool LLVOAvatar::computeNeedsUpdate()
 bool LLVOAvatar::updateCharacter(LLAgent &agent)
 {	
 	updateDebugText();
+
+	// <FS:Kadah> Parallel motion evaluation
+	const bool motions_updated = (mParallelMotionFrame == LLFrameTimer::getFrameCount());
+	mParallelMotionCandidate = false;
+	// </FS:Kadah>
 	
 	if (!mIsBuilt)
 	{
@@ -5275,7 +5282,13 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
 	//--------------------------------------------------------------------
 	if (!needs_update && !isSelf())
 	{
-		updateMotions(LLCharacter::HIDDEN_UPDATE);
+		// <FS:Kadah> Parallel motion evaluation
+		//updateMotions(LLCharacter::HIDDEN_UPDATE);
+		if (!motions_updated)
+		{
+			updateMotions(LLCharacter::HIDDEN_UPDATE);
+		}
+		// </FS:Kadah>
 		return FALSE;
 	}
 
@@ -5335,16 +5348,35 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
 	// update animations
 	if (!visible)
 	{
-		updateMotions(LLCharacter::HIDDEN_UPDATE);
+		// <FS:Kadah> Parallel motion evaluation
+		//updateMotions(LLCharacter::HIDDEN_UPDATE);
+		if (!motions_updated)
+		{
+			updateMotions(LLCharacter::HIDDEN_UPDATE);
+		}
+		// </FS:Kadah>
 	}
 	else if (mSpecialRenderMode == 1) // Animation Preview
 	{
-		updateMotions(LLCharacter::FORCE_UPDATE);
+		// <FS:Kadah> Parallel motion evaluation
+		//updateMotions(LLCharacter::FORCE_UPDATE);
+		if (!motions_updated)
+		{
+			updateMotions(LLCharacter::FORCE_UPDATE);
+		}
+		// </FS:Kadah>
 	}
 	else
 	{
 		// Might be better to do HIDDEN_UPDATE if cloud
-		updateMotions(LLCharacter::NORMAL_UPDATE);
+		// <FS:Kadah> Parallel motion evaluation
+		//updateMotions(LLCharacter::NORMAL_UPDATE);
+		if (!motions_updated)
+		{
+			updateMotions(LLCharacter::NORMAL_UPDATE);
+		}
+		mParallelMotionCandidate = true;
+		// </FS:Kadah>
 	}
 
 	// Special handling for sitting on ground.
@@ -5380,6 +5412,58 @@ bool LLVOAvatar::updateCharacter(LLAgent &agent)
 	return visible;
 }
 
+// <FS:Kadah> Parallel motion evaluation
+// The keyframe updates and pose blend of an avatar take about 10 us
+// (llmotioncontroller_test, 100 avatars), a pool thread answers a post after
+// 10 to 30 us. The main thread gets through fewer avatars on its own before
+// a helper would take one.
+static const size_t MIN_PARALLEL_MOTION_AVATARS = 4;
+
+// static
+void LLVOAvatar::updateMotionsParallel(const std::vector<LLViewerObject*>& objects, U32 count)
+{
+	static LLCachedControl<bool> parallel_motion_update(gSavedSettings, "FSParallelMotionUpdate", false);
+	if (!parallel_motion_update)
+	{
+		return;
+	}
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_AVATAR;
+
+	// Only avatars that updateCharacter() gave a regular update last frame.
+	// Self stays serial, its animations drive the camera and the agent.
+	std::vector<LLCharacter*> characters;
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLViewerObject* objectp = objects[i];
+		if (!objectp->isAvatar() || objectp->isDead())
+		{
+			continue;
+		}
+		LLVOAvatar* avatarp = (LLVOAvatar*)objectp;
+		if (avatarp->mParallelMotionCandidate && avatarp->mIsBuilt && !avatarp->isSelf()
+			&& avatarp->mSpecialRenderMode == 0)
+		{
+			characters.push_back(avatarp);
+		}
+	}
+	if (characters.size() < MIN_PARALLEL_MOTION_AVATARS)
+	{
+		return;
+	}
+
+	LLCharacter::updateMotionsParallel(characters);
+
+	const U32 frame = LLFrameTimer::getFrameCount();
+	for (LLCharacter* character : characters)
+	{
+		LLVOAvatar* avatarp = (LLVOAvatar*)character;
+		avatarp->mParallelMotionFrame = frame;
+		// set again by updateCharacter() if it still wants a regular update
+		avatarp->mParallelMotionCandidate = false;
+	}
+}
+// </FS:Kadah>
+
 //-----------------------------------------------------------------------------
 // updateHeadOffset()
 //-----------------------------------------------------------------------------
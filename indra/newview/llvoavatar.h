@@ -279,6 +279,14 @@ public:
     void			updateOrientation(LLAgent &agent, F32 speed, F32 delta_time);
     void			updateTimeStep();
     void			updateRootPositionAndRotation(LLAgent &agent, F32 speed, bool was_sit_ground_constrained);
+
+	// <FS:Kadah> Parallel motion evaluation
+	// Updates the motions of the avatars among the first count objects that
+	// had a regular motion update last frame, with the keyframe sampling and
+	// pose blending spread over the General thread pool. Called ahead of
+	// their idleUpdate(); updateCharacter() then skips its own update.
+	static void		updateMotionsParallel(const std::vector<LLViewerObject*>& objects, U32 count);
+	// </FS:Kadah>
     
 	void 			idleUpdateVoiceVisualizer(bool voice_enabled);
 	void 			idleUpdateMisc(bool detailed_update);
@@ -555,6 +563,10 @@ private:
 	F32			mLastSkinTime; //value of gFrameTimeSeconds at last skin update
 
 	S32	 		mUpdatePeriod;
+	// <FS:Kadah> Parallel motion evaluation
+	bool		mParallelMotionCandidate;	// had a regular motion update last frame
+	U32			mParallelMotionFrame;		// frame updateMotionsParallel() updated the motions
+	// </FS:Kadah>
 	S32  		mNumInitFaces; //number of faces generated when creating the avatar drawable, does not inculde splitted faces due to long vertex buffer.
 
 	// the isTooComplex method uses these mutable values to avoid recalculating too frequently
@@ -35,6 +35,7 @@
 #include "pipeline.h"
 #include "llagentcamera.h"
 #include "llmemory.h"
+#include "workqueue.h" // <FS:Kadah/>
 
 //static variables
 U32 LLVOCacheEntry::sMinFrameRange = 0;
@@ -70,6 +71,7 @@ LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &
 	mHitCount(0),
 	mDupeCount(0),
 	mCRCChangeCount(0),
+	mDirty(true), // <FS:Kadah/>
 	mState(INACTIVE),
 	mSceneContrib(0.f),
 	mValid(TRUE),
@@ -90,6 +92,7 @@ LLVOCacheEntry::LLVOCacheEntry()
 	mDupeCount(0),
 	mCRCChangeCount(0),
 	mBuffer(NULL),
+	mDirty(false), // <FS:Kadah/>
 	mState(INACTIVE),
 	mSceneContrib(0.f),
 	mValid(TRUE),
@@ -102,6 +105,7 @@ LLVOCacheEntry::LLVOCacheEntry()
 LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
 :	LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY), 
 	mBuffer(NULL),
+	mDirty(false), // <FS:Kadah/>
 	mUpdateFlags(-1),
 	mState(INACTIVE),
 	mSceneContrib(0.f),
@@ -164,6 +168,57 @@ LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
 	}
 }
 
+// <FS:Kadah> Same layout as LLVOCacheEntry(LLAPRFile*) reads, from a record
+// already in memory.
+LLVOCacheEntry::LLVOCacheEntry(const U8* data_buffer, S32 size)
+:	LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY), 
+	mBuffer(NULL),
+	mDirty(false),
+	mUpdateFlags(-1),
+	mState(INACTIVE),
+	mSceneContrib(0.f),
+	mValid(FALSE),
+	mParentID(0),
+	mBSphereRadius(-1.0f)
+{
+	S32 body_size = -1;
+	bool success = size > ENTRY_HEADER_SIZE;
+
+	mDP.assignBuffer(mBuffer, 0);
+
+	if (success)
+	{
+		memcpy(&mLocalID, data_buffer, sizeof(U32));
+		memcpy(&mCRC, data_buffer + sizeof(U32), sizeof(U32));
+		memcpy(&mHitCount, data_buffer + (2 * sizeof(U32)), sizeof(S32));
+		memcpy(&mDupeCount, data_buffer + (3 * sizeof(U32)), sizeof(S32));
+		memcpy(&mCRCChangeCount, data_buffer + (4 * sizeof(U32)), sizeof(S32));
+		memcpy(&body_size, data_buffer + (5 * sizeof(U32)), sizeof(S32));
+
+		if ((body_size > MAX_ENTRY_BODY_SIZE) || (body_size < 1) || (ENTRY_HEADER_SIZE + body_size != size))
+		{
+			LL_WARNS() << "Bogus cache entry, size " << body_size << " in a record of " << size << LL_ENDL;
+			success = false;
+		}
+	}
+	if (success)
+	{
+		mBuffer = new U8[body_size];
+		memcpy(mBuffer, data_buffer + ENTRY_HEADER_SIZE, body_size);
+		mDP.assignBuffer(mBuffer, body_size);
+	}
+	else
+	{
+		mLocalID = 0;
+		mCRC = 0;
+		mHitCount = 0;
+		mDupeCount = 0;
+		mCRCChangeCount = 0;
+		mEntry = NULL;
+	}
+}
+// </FS:Kadah>
+
 LLVOCacheEntry::~LLVOCacheEntry()
 {
 	mDP.freeBuffer();
@@ -175,6 +230,7 @@ void LLVOCacheEntry::updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp)
 	{
 		mCRC = crc;
 		mCRCChangeCount++;
+		mDirty = true; // <FS:Kadah/>
 	}
 
 	mDP.freeBuffer();
@@ -1073,6 +1129,7 @@ LLVOCache::LLVOCache(bool read_only) :
 
 LLVOCache::~LLVOCache()
 {
+	waitForAllWrites(); // <FS:Kadah/>
 	if(mEnabled)
 	{
 		writeCacheHeader();
@@ -1151,6 +1208,8 @@ void LLVOCache::removeCache(ELLPath location, bool started)
 
 	LL_INFOS() << "about to remove the object cache due to settings." << LL_ENDL ;
 
+	waitForAllWrites(); // <FS:Kadah/>
+
 	std::string mask = "*";
 	std::string cache_dir = gDirUtilp->getExpandedFilename(location, object_cache_dirname);
 	LL_INFOS() << "Removing cache at " << cache_dir << LL_ENDL;
@@ -1175,6 +1234,8 @@ void LLVOCache::removeCache()
 		return ;
 	}
 
+	waitForAllWrites(); // <FS:Kadah/>
+
 	std::string mask = "*";
 	LL_INFOS() << "Removing object cache at " << mObjectCacheDirName << LL_ENDL;
 	gDirUtilp->deleteFilesInDir(mObjectCacheDirName, mask); 
@@ -1230,7 +1291,7 @@ void LLVOCache::clearCacheInMemory()
 		mHandleEntryMap.clear();
 		mNumEntries = 0 ;
 	}
-
+	mJournalInfo.clear(); // <FS:Kadah/>
 }
 
 void LLVOCache::getObjectCacheFilename(U64 handle, std::string& filename) 
@@ -1254,6 +1315,10 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 
 	std::string filename;
 	getObjectCacheFilename(entry->mHandle, filename);
+	// <FS:Kadah> Don't let a queued write bring the file back
+	waitForWrites(entry->mHandle);
+	mJournalInfo.erase(entry->mHandle);
+	// </FS:Kadah>
 	LLAPRFile::remove(filename, mLocalAPRFilePoolp);
 	entry->mTime = INVALID_TIME ;
 	updateEntry(entry) ; //update the head file.
@@ -1420,45 +1485,78 @@ void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
 		return ;
 	}
 
-	bool success = true ;
-	{
-		std::string filename;
-		LLUUID cache_id;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
-	
-		success = check_read(&apr_file, cache_id.mData, UUID_BYTES);
-	
-		if(success)
-		{		
-			if(cache_id != id)
-			{
-				LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
-				success = false ;
-			}
+	// <FS:Kadah> Region files are record journals; read the whole file in
+	// one go and replay it instead of two small reads per entry.
+	//bool success = true ;
+	//{
+	//	std::string filename;
+	//	LLUUID cache_id;
+	//	getObjectCacheFilename(handle, filename);
+	//	LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
+	//
+	//	success = check_read(&apr_file, cache_id.mData, UUID_BYTES);
+	//
+	//	if(success)
+	//	{		
+	//		if(cache_id != id)
+	//		{
+	//			LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
+	//			success = false ;
+	//		}
+
+	//		if(success)
+	//		{
+	//			S32 num_entries;  // if removal was enabled during write num_entries might be wrong
+	//			success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
+	//
+	//			if(success)
+	//			{
+	//				for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
+	//				{
+	//					LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
+	//					if (!entry->getLocalID())
+	//					{
+	//						LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
+	//						success = false ;
+	//						break ;
+	//					}
+	//					cache_entry_map[entry->getLocalID()] = entry;
+	//				}
+	//			}
+	//		}
+	//	}		
+	//}
+	//
+	std::string filename;
+	getObjectCacheFilename(handle, filename);
+	waitForWrites(handle);
 
-			if(success)
+	LLRecordJournal::Stats stats;
+	bool success = LLRecordJournal::read(filename, id,
+		[&](U32 local_id, const U8* data, U32 size)
+		{
+			LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(data, (S32)size);
+			if (!entry->getLocalID() || entry->getLocalID() != local_id)
 			{
-				S32 num_entries;  // if removal was enabled during write num_entries might be wrong
-				success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
-	
-				if(success)
-				{
-					for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
-					{
-						LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
-						if (!entry->getLocalID())
-						{
-							LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
-							success = false ;
-							break ;
-						}
-						cache_entry_map[entry->getLocalID()] = entry;
-					}
-				}
+				LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
+				return false;
 			}
-		}		
+			cache_entry_map[local_id] = entry;
+			return true;
+		}, &stats);
+
+	if (success && !stats.mTruncated)
+	{
+		JournalInfo& info = mJournalInfo[handle];
+		info.mRecords = stats.mRecords;
+		info.mLive = stats.mLive;
 	}
+	else
+	{
+		// Rewrite it on the next save.
+		mJournalInfo.erase(handle);
+	}
+	// </FS:Kadah>
 	
 	if(!success)
 	{
@@ -1541,65 +1639,145 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
 		return ; //nothing changed, no need to update.
 	}
 
-	//write to cache file
+	// <FS:Kadah> Append the entries that changed since they were last
+	// written, or rewrite the file when this session hasn't read it (or read
+	// a damaged one) or most of its records have been superseded. The file
+	// is written on the General thread pool.
+	////write to cache file
+	//bool success = true ;
+	//{
+	//	std::string filename;
+	//	getObjectCacheFilename(handle, filename);
+	//	LLAPRFile apr_file(filename, APR_CREATE|APR_WRITE|APR_BINARY|APR_TRUNCATE, mLocalAPRFilePoolp);
+	//
+	//	success = check_write(&apr_file, (void*)id.mData, UUID_BYTES);
+	//
+	//	if(success)
+	//	{
+	//		S32 num_entries = cache_entry_map.size(); // if removal is enabled num_entries might be wrong
+	//		success = check_write(&apr_file, &num_entries, sizeof(S32));
+    //        if (success)
+    //        {
+    //            const S32 buffer_size = 32768; //should be large enough for couple MAX_ENTRY_BODY_SIZE
+    //            U8 data_buffer[buffer_size]; // generaly entries are fairly small, so collect them and drop onto disk in one go
+    //            S32 size_in_buffer = 0;
+
+    //            // This can have a lot of entries, so might be better to dump them into buffer first and write in one go.
+    //            for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+    //            {
+    //                if (!removal_enabled || iter->second->isValid())
+    //                {
+    //                    S32 size = iter->second->writeToBuffer(data_buffer + size_in_buffer);
+
+    //                    if (size > ENTRY_HEADER_SIZE) // body is minimum of 1
+    //                    {
+    //                        size_in_buffer += size;
+    //                    }
+    //                    else
+    //                    {
+    //                        success = false;
+    //                        break;
+    //                    }
+
+    //                    // Make sure we have space in buffer for next element
+    //                    if (buffer_size - size_in_buffer < MAX_ENTRY_BODY_SIZE + ENTRY_HEADER_SIZE)
+    //                    {
+    //                        success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
+    //                        size_in_buffer = 0;
+    //                        if (!success)
+    //                        {
+    //                            break;
+    //                        }
+    //                    }
+    //                }
+    //            }
+
+    //            if (success && size_in_buffer > 0)
+    //            {
+    //                // final write
+    //                success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
+    //                size_in_buffer = 0;
+    //            }
+    //        }
+	//	}
+	//}
 	bool success = true ;
+	U8 data_buffer[ENTRY_HEADER_SIZE + MAX_ENTRY_BODY_SIZE];
+	PendingWrite write;
+	U32 live = 0;
+	// A failed write removed the file, what this session knew about it is gone
+	bool failed = false;
+	mPendingWrites.update_one([&](PendingWrites& pending)
 	{
-		std::string filename;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_CREATE|APR_WRITE|APR_BINARY|APR_TRUNCATE, mLocalAPRFilePoolp);
-	
-		success = check_write(&apr_file, (void*)id.mData, UUID_BYTES);
-	
-		if(success)
+		failed = pending.mFailed.erase(handle) > 0;
+	});
+	if (failed)
+	{
+		mJournalInfo.erase(handle);
+	}
+	journal_info_map_t::iterator info = mJournalInfo.find(handle);
+	write.mRewrite = info == mJournalInfo.end();
+	if (!write.mRewrite)
+	{
+		for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+		{
+			if (removal_enabled && !iter->second->isValid())
+			{
+				write.mBatch.remove(iter->first);
+				continue;
+			}
+			++live;
+			if (iter->second->isDirty())
+			{
+				S32 size = iter->second->writeToBuffer(data_buffer);
+				success = size > ENTRY_HEADER_SIZE; // body is minimum of 1
+				if (success)
+				{
+					write.mBatch.add(iter->first, data_buffer, size);
+				}
+			}
+		}
+		if (success && LLRecordJournal::needsCompaction(info->second.mRecords + write.mBatch.getRecordCount(), live))
+		{
+			write.mRewrite = true;
+			write.mBatch = LLRecordJournal::Batch();
+		}
+	}
+	if (success && write.mRewrite)
+	{
+		live = 0;
+		for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
 		{
-			S32 num_entries = cache_entry_map.size(); // if removal is enabled num_entries might be wrong
-			success = check_write(&apr_file, &num_entries, sizeof(S32));
-            if (success)
-            {
-                const S32 buffer_size = 32768; //should be large enough for couple MAX_ENTRY_BODY_SIZE
-                U8 data_buffer[buffer_size]; // generaly entries are fairly small, so collect them and drop onto disk in one go
-                S32 size_in_buffer = 0;
-
-                // This can have a lot of entries, so might be better to dump them into buffer first and write in one go.
-                for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
-                {
-                    if (!removal_enabled || iter->second->isValid())
-                    {
-                        S32 size = iter->second->writeToBuffer(data_buffer + size_in_buffer);
-
-                        if (size > ENTRY_HEADER_SIZE) // body is minimum of 1
-                        {
-                            size_in_buffer += size;
-                        }
-                        else
-                        {
-                            success = false;
-                            break;
-                        }
-
-                        // Make sure we have space in buffer for next element
-                        if (buffer_size - size_in_buffer < MAX_ENTRY_BODY_SIZE + ENTRY_HEADER_SIZE)
-                        {
-                            success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
-                            size_in_buffer = 0;
-                            if (!success)
-                            {
-                                break;
-                            }
-                        }
-                    }
-                }
-
-                if (success && size_in_buffer > 0)
-                {
-                    // final write
-                    success = check_write(&apr_file, (void*)data_buffer, size_in_buffer);
-                    size_in_buffer = 0;
-                }
-            }
+			if (!removal_enabled || iter->second->isValid())
+			{
+				S32 size = iter->second->writeToBuffer(data_buffer);
+				success = size > ENTRY_HEADER_SIZE;
+				if (success)
+				{
+					write.mBatch.add(iter->first, data_buffer, size);
+					++live;
+				}
+			}
 		}
 	}
 
+	if (success && (write.mRewrite || !write.mBatch.empty()))
+	{
+		for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+		{
+			iter->second.get()->setDirty(false);
+		}
+
+		JournalInfo& journal = mJournalInfo[handle];
+		journal.mRecords = write.mRewrite ? write.mBatch.getRecordCount() : journal.mRecords + write.mBatch.getRecordCount();
+		journal.mLive = live;
+
+		getObjectCacheFilename(handle, write.mFilename);
+		write.mID = id;
+		queueWrite(handle, write);
+	}
+	// </FS:Kadah>
+
 	if(!success)
 	{
 		removeEntry(entry) ;
@@ -1607,3 +1785,93 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
 
 	return ;
 }
+
+// <FS:Kadah> Region journal writes. Writes of one region stay in order and
+// run one at a time; different regions can be written in parallel.
+void LLVOCache::queueWrite(U64 handle, PendingWrite& write)
+{
+	bool start = false;
+	mPendingWrites.update_all([&](PendingWrites& pending)
+	{
+		std::deque<PendingWrite>& queue = pending.mQueues[handle];
+		start = queue.empty();
+		queue.push_back(std::move(write));
+	});
+	if (!start)
+	{
+		return; // already draining
+	}
+
+	LL::WorkQueue::ptr_t general_queue = LL::WorkQueue::getInstance("General");
+	if (!general_queue || !general_queue->postIfOpen([this, handle]() { runWrites(handle); }))
+	{
+		// No thread pool (yet, or any more), write it now.
+		runWrites(handle);
+	}
+}
+
+void LLVOCache::runWrites(U64 handle)
+{
+	while (true)
+	{
+		// Only this call pops the queue, and deque::push_back() keeps
+		// references to the front valid.
+		bool skip = false;
+		const PendingWrite* write = mPendingWrites.get([handle, &skip](const PendingWrites& pending)
+		{
+			const PendingWrite* front = &pending.mQueues.find(handle)->second.front();
+			// An append to the file a failed write removed would leave only
+			// the changes in it
+			skip = !front->mRewrite && pending.mFailed.count(handle);
+			return front;
+		});
+
+		bool success = skip
+			|| (write->mRewrite
+				? LLRecordJournal::rewrite(write->mFilename, write->mID, write->mBatch)
+				: LLRecordJournal::append(write->mFilename, write->mID, write->mBatch));
+		if (!success)
+		{
+			// The next read misses, and the next save rewrites the region.
+			LL_WARNS() << "Failed to write object cache file " << write->mFilename << LL_ENDL;
+			LLFile::remove(write->mFilename, ENOENT);
+		}
+
+		bool done = false;
+		mPendingWrites.update_all([&](PendingWrites& pending)
+		{
+			if (!success)
+			{
+				pending.mFailed.insert(handle);
+			}
+			pending_write_map_t::iterator iter = pending.mQueues.find(handle);
+			iter->second.pop_front();
+			done = iter->second.empty();
+			if (done)
+			{
+				pending.mQueues.erase(iter);
+			}
+		});
+		if (done)
+		{
+			return;
+		}
+	}
+}
+
+void LLVOCache::waitForWrites(U64 handle)
+{
+	mPendingWrites.wait([handle](const PendingWrites& pending)
+	{
+		return pending.mQueues.find(handle) == pending.mQueues.end();
+	});
+}
+
+void LLVOCache::waitForAllWrites()
+{
+	mPendingWrites.wait([](const PendingWrites& pending)
+	{
+		return pending.mQueues.empty();
+	});
+}
+// </FS:Kadah>
@@ -32,6 +32,11 @@
 #include "lldir.h"
 #include "llvieweroctree.h"
 #include "llapr.h"
+#include "llcond.h" // <FS:Kadah/>
+#include "llrecordjournal.h" // <FS:Kadah/>
+
+#include <deque> // <FS:Kadah/>
+#include <set> // <FS:Kadah/>
 
 //---------------------------------------------------------------------------
 // Cache entries
@@ -84,6 +89,7 @@ protected:
 public:
 	LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &dp);
 	LLVOCacheEntry(LLAPRFile* apr_file);
+	LLVOCacheEntry(const U8* data_buffer, S32 size); // <FS:Kadah/> from a region journal record
 	LLVOCacheEntry();	
 
 	void updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp);
@@ -133,6 +139,11 @@ public:
 	void setUpdateFlags(U32 flags) {mUpdateFlags = flags;}
 	U32  getUpdateFlags() const    {return mUpdateFlags;}
 
+	// <FS:Kadah> Changed since it was last written to the region cache file
+	void setDirty(bool dirty) {mDirty = dirty;}
+	bool isDirty() const      {return mDirty;}
+	// </FS:Kadah>
+
 	static void updateDebugSettings();
 	static F32  getSquaredPixelThreshold(bool is_front);
 
@@ -155,6 +166,7 @@ protected:
 	S32							mCRCChangeCount;
 	LLDataPackerBinaryBuffer	mDP;
 	U8							*mBuffer;
+	bool						mDirty; // <FS:Kadah/>
 
 	F32                         mSceneContrib; //projected scene contributuion of this object.
 	U32                         mState; //high 16 bits reserved for special use.
@@ -283,6 +295,37 @@ private:
 	void removeEntry(HeaderEntryInfo* entry) ;
 	void purgeEntries(U32 size);
 	BOOL updateEntry(const HeaderEntryInfo* entry);
+
+	// <FS:Kadah> Region files are LLRecordJournals written on the General thread pool
+	struct PendingWrite
+	{
+		std::string mFilename;
+		LLUUID mID;
+		LLRecordJournal::Batch mBatch;
+		bool mRewrite;
+	};
+	typedef std::map<U64, std::deque<PendingWrite> > pending_write_map_t;
+	struct PendingWrites
+	{
+		pending_write_map_t mQueues;
+		// Regions whose file a failed write removed. Appends are skipped
+		// until the save path has noticed and queued a rewrite.
+		std::set<U64> mFailed;
+	};
+
+	// What is in a region file, as far as this session knows.
+	struct JournalInfo
+	{
+		U32 mRecords;
+		U32 mLive;
+	};
+	typedef std::map<U64, JournalInfo> journal_info_map_t;
+
+	void queueWrite(U64 handle, PendingWrite& write);
+	void runWrites(U64 handle); // drains the writes of one region, in order
+	void waitForWrites(U64 handle);
+	void waitForAllWrites();
+	// </FS:Kadah>
 	
 private:
 	bool                 mEnabled;
@@ -296,6 +339,10 @@ private:
 	LLVolatileAPRPool*   mLocalAPRFilePoolp ; 	
 	header_entry_queue_t mHeaderEntryQueue;
 	handle_entry_map_t   mHandleEntryMap;	
+	// <FS:Kadah>
+	journal_info_map_t   mJournalInfo;
+	LLCond<PendingWrites> mPendingWrites; // shared with the thread pool
+	// </FS:Kadah>
 };
 
 #endif
@@ -51,6 +51,7 @@
 #include "lldrawpoolavatar.h"
 #include "lldrawpoolbump.h"
 #include "llface.h"
+#include "llfacegeometrybuilder.h" // <FS:Kadah/>
 #include "llspatialpartition.h"
 #include "llhudmanager.h"
 #include "llflexibleobject.h"
@@ -6356,21 +6357,50 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
     U32 extra_mask = LLVertexBuffer::MAP_TEXTURE_INDEX;
     BOOL alpha_sort = TRUE;
     BOOL rigged = FALSE;
+    // <FS:Kadah> Pack the faces of all batches in one go, on the thread pool
+    LLFaceGeometryBuilder builder;
+    LLFaceGeometryBuilder* builderp = (!LLPipeline::sDelayVBUpdate && LLFaceGeometryBuilder::isEnabled()) ? &builder : NULL;
+    // </FS:Kadah>
     for (int i = 0; i < 2; ++i) //two sets, static and rigged)
     {
-        geometryBytes += genDrawInfo(group, simple_mask | extra_mask, sSimpleFaces[i], simple_count[i], FALSE, batch_textures, rigged);
-        geometryBytes += genDrawInfo(group, fullbright_mask | extra_mask, sFullbrightFaces[i], fullbright_count[i], FALSE, batch_textures, rigged);
-        geometryBytes += genDrawInfo(group, alpha_mask | extra_mask, sAlphaFaces[i], alpha_count[i], alpha_sort, batch_textures, rigged);
-        geometryBytes += genDrawInfo(group, bump_mask | extra_mask, sBumpFaces[i], bump_count[i], FALSE, FALSE, rigged);
-        geometryBytes += genDrawInfo(group, norm_mask | extra_mask, sNormFaces[i], norm_count[i], FALSE, FALSE, rigged);
-        geometryBytes += genDrawInfo(group, spec_mask | extra_mask, sSpecFaces[i], spec_count[i], FALSE, FALSE, rigged);
-        geometryBytes += genDrawInfo(group, normspec_mask | extra_mask, sNormSpecFaces[i], normspec_count[i], FALSE, FALSE, rigged);
+        // <FS:Kadah> Parallel geometry rebuild
+        //geometryBytes += genDrawInfo(group, simple_mask | extra_mask, sSimpleFaces[i], simple_count[i], FALSE, batch_textures, rigged);
+        //geometryBytes += genDrawInfo(group, fullbright_mask | extra_mask, sFullbrightFaces[i], fullbright_count[i], FALSE, batch_textures, rigged);
+        //geometryBytes += genDrawInfo(group, alpha_mask | extra_mask, sAlphaFaces[i], alpha_count[i], alpha_sort, batch_textures, rigged);
+        //geometryBytes += genDrawInfo(group, bump_mask | extra_mask, sBumpFaces[i], bump_count[i], FALSE, FALSE, rigged);
+        //geometryBytes += genDrawInfo(group, norm_mask | extra_mask, sNormFaces[i], norm_count[i], FALSE, FALSE, rigged);
+        //geometryBytes += genDrawInfo(group, spec_mask | extra_mask, sSpecFaces[i], spec_count[i], FALSE, FALSE, rigged);
+        //geometryBytes += genDrawInfo(group, normspec_mask | extra_mask, sNormSpecFaces[i], normspec_count[i], FALSE, FALSE, rigged);
+        geometryBytes += genDrawInfo(group, simple_mask | extra_mask, sSimpleFaces[i], simple_count[i], FALSE, batch_textures, rigged, builderp);
+        geometryBytes += genDrawInfo(group, fullbright_mask | extra_mask, sFullbrightFaces[i], fullbright_count[i], FALSE, batch_textures, rigged, builderp);
+        geometryBytes += genDrawInfo(group, alpha_mask | extra_mask, sAlphaFaces[i], alpha_count[i], alpha_sort, batch_textures, rigged, builderp);
+        geometryBytes += genDrawInfo(group, bump_mask | extra_mask, sBumpFaces[i], bump_count[i], FALSE, FALSE, rigged, builderp);
+        geometryBytes += genDrawInfo(group, norm_mask | extra_mask, sNormFaces[i], norm_count[i], FALSE, FALSE, rigged, builderp);
+        geometryBytes += genDrawInfo(group, spec_mask | extra_mask, sSpecFaces[i], spec_count[i], FALSE, FALSE, rigged, builderp);
+        geometryBytes += genDrawInfo(group, normspec_mask | extra_mask, sNormSpecFaces[i], normspec_count[i], FALSE, FALSE, rigged, builderp);
+        // </FS:Kadah>
 
         // for rigged set, add weights and disable alpha sorting (rigged items use depth buffer)
         extra_mask |= LLVertexBuffer::MAP_WEIGHT4;
         rigged = TRUE;
     }
 
+    // <FS:Kadah> Parallel geometry rebuild
+    if (builderp && !builder.empty())
+    {
+        std::vector<LLFace*> failed;
+        builder.run(&failed);
+        if (!failed.empty())
+        {
+            LL_WARNS() << "Failed to get geometry for " << failed.size() << " face(s)!" << LL_ENDL;
+        }
+        for (LLVertexBuffer* buffer : builder.getBuffers())
+        {
+            buffer->flush();
+        }
+    }
+    // </FS:Kadah>
+
 	group->mGeometryBytes = geometryBytes;
 
 	if (!LLPipeline::sDelayVBUpdate)
@@ -6416,6 +6446,11 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 			U32 buffer_count = 0;
 
             std::unique_ptr<LLPerfStats::RecordAttachmentTime> ratPtr{};
+			// <FS:Kadah> Parallel geometry rebuild
+			LLFaceGeometryBuilder builder;
+			bool use_builder = LLFaceGeometryBuilder::isEnabled();
+			std::vector<LLDrawable*> rebuilt_drawables;
+			// </FS:Kadah>
 			for (LLSpatialGroup::element_iter drawable_iter = group->getDataBegin(); drawable_iter != group->getDataEnd(); ++drawable_iter)
 			{
 				LLDrawable* drawablep = (LLDrawable*)(*drawable_iter)->getDrawable();
@@ -6462,6 +6497,14 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 						if (face)
 						{
 							LLVertexBuffer* buff = face->getVertexBuffer();
+							// <FS:Kadah> Parallel geometry rebuild
+							if (buff && use_builder)
+							{
+								builder.add(face, *volume, face->getTEOffset(),
+									vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), face->getGeomIndex());
+							}
+							else
+							// </FS:Kadah>
 							if (buff)
 							{
 								if (!face->getGeometryVolume(*volume, face->getTEOffset(), 
@@ -6485,9 +6528,45 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 						vobj->updateRelativeXform();
 					}
 
+					// <FS:Kadah> The builder still reads the rebuild flags
+					//drawablep->clearState(LLDrawable::REBUILD_ALL);
+					if (use_builder)
+					{
+						rebuilt_drawables.push_back(drawablep);
+					}
+					else
+					{
+						drawablep->clearState(LLDrawable::REBUILD_ALL);
+					}
+					// </FS:Kadah>
+				}
+			}
+
+			// <FS:Kadah> Parallel geometry rebuild
+			if (use_builder)
+			{
+				std::vector<LLFace*> failed;
+				builder.run(&failed);
+				if (!failed.empty())
+				{ //something's gone wrong with the vertex buffer accounting, rebuild this group 
+					group->dirtyGeom();
+					gPipeline.markRebuild(group, TRUE);
+				}
+
+				for (LLVertexBuffer* buff : builder.getBuffers())
+				{
+					if (buff->isLocked() && buffer_count < MAX_BUFFER_COUNT)
+					{
+						locked_buffer[buffer_count++] = buff;
+					}
+				}
+
+				for (LLDrawable* drawablep : rebuilt_drawables)
+				{
 					drawablep->clearState(LLDrawable::REBUILD_ALL);
 				}
 			}
+			// </FS:Kadah>
 
 			{
 				LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("rebuildMesh - flush");
@@ -6592,7 +6671,10 @@ struct CompareBatchBreakerRigged
     }
 };
 
-U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort, BOOL batch_textures, BOOL rigged)
+// <FS:Kadah> Face geometry can be left to a builder
+//U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort, BOOL batch_textures, BOOL rigged)
+U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace** faces, U32 face_count, BOOL distance_sort, BOOL batch_textures, BOOL rigged, LLFaceGeometryBuilder* builder)
+// </FS:Kadah>
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
@@ -6919,6 +7001,14 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 
 					U32 te_idx = facep->getTEOffset();
 
+					// <FS:Kadah> Parallel geometry rebuild
+					if (builder)
+					{
+						builder->add(facep, *volume, te_idx,
+							vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset, true);
+					}
+					else
+					// </FS:Kadah>
 					if (!facep->getGeometryVolume(*volume, te_idx, 
 						vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset,true))
 					{
@@ -678,6 +678,7 @@ void LLPipeline::init()
 	connectRefreshCachedSettingsSafe("FSFocusPointFollowsPointer");
 	connectRefreshCachedSettingsSafe("FSFocusPointLocked");
     // </FS:Beq>
+	connectRefreshCachedSettingsSafe("FSFlatFrustumCull"); // <FS:Kadah/> Flat frustum culling
 }
 
 LLPipeline::~LLPipeline()
@@ -1296,6 +1297,7 @@ void LLPipeline::refreshCachedSettings()
 	exoPostProcess::instance().ExodusRenderPostSettingsUpdate();	// <FS:CR> Import Vignette from Exodus
 
 	RenderAutoHideSurfaceAreaLimit = gSavedSettings.getF32("RenderAutoHideSurfaceAreaLimit");
+	LLViewerOctreeCull::sFlatFrustumCull = gSavedSettings.getBOOL("FSFlatFrustumCull"); // <FS:Kadah/> Flat frustum culling
 	RenderSpotLight = nullptr;
 	updateRenderDeferred();
 
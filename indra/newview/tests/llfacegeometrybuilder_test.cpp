@@ -0,0 +1,432 @@
+/**
+ * @file llfacegeometrybuilder_test.cpp
+ * @brief Tests for LLFaceGeometryBuilder, the batched face geometry rebuild of a spatial group.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../test/lltut.h"
+
+#include "../llfacegeometrybuilder.h"
+
+#include "../llface.h"
+#include "../llviewercontrol.h"
+#include "../pipeline.h"
+#include "llevents.h"
+#include "llmatrix4a.h"
+#include "llvolume.h"
+#include "threadpool.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+//----------------------------------------------------------------------------
+// Stubs
+//----------------------------------------------------------------------------
+LLControlGroup gSavedSettings("Global");
+
+LLCullResult::LLCullResult() {}
+LLPipeline::LLPipeline() : mRenderDebugMask(0) {}
+LLPipeline::~LLPipeline() {}
+LLPipeline gPipeline;
+
+namespace
+{
+	// What the builder did with a face
+	struct FaceRecord
+	{
+		FaceRecord() : mPrepared(0), mPreparedOnMain(false), mSequence(-1), mStaged(false) {}
+		S32 mPrepared;
+		bool mPreparedOnMain;
+		S32 mSequence;				// order of the getGeometryVolume() calls
+		std::thread::id mThread;
+		bool mStaged;				// the buffer was staged while it ran
+	};
+
+	std::map<const LLFace*, FaceRecord> sRecords;	// filled in before run(), one writer per face
+	std::set<const LLFace*> sFailing;
+	std::atomic<S32> sSequence(0);
+	std::thread::id sMainThread;
+}
+
+void LLFace::init(LLDrawable* drawablep, LLViewerObject* objp)
+{
+	mGeomIndex = 0;
+	mIndicesIndex = 0;
+	mGeomCount = 0;
+	mIndicesCount = 0;
+}
+
+void LLFace::destroy()
+{
+	mVertexBuffer = NULL;
+}
+
+void LLFace::setGeomIndex(U16 idx)
+{
+	mGeomIndex = idx;
+}
+
+void LLFace::setIndicesIndex(S32 idx)
+{
+	mIndicesIndex = idx;
+}
+
+void LLFace::setVertexBuffer(LLVertexBuffer* buffer)
+{
+	mVertexBuffer = buffer;
+}
+
+void LLFace::prepareGeometryVolume(const S32 &f, bool force_rebuild)
+{
+	FaceRecord& record = sRecords[this];
+	++record.mPrepared;
+	record.mPreparedOnMain = std::this_thread::get_id() == sMainThread;
+}
+
+// The per face work of the real one for an unbumped, untextured face:
+// positions through the object matrix, normals, texture coordinates and
+// indices offset to the face's vertices.
+BOOL LLFace::getGeometryVolume(const LLVolume& volume, const S32 &f,
+							   const LLMatrix4& mat_vert_in, const LLMatrix3& mat_normal_in,
+							   const U16 &index_offset, bool force_rebuild)
+{
+	FaceRecord& record = sRecords[this];
+	record.mSequence = sSequence++;
+	record.mThread = std::this_thread::get_id();
+	record.mStaged = mVertexBuffer->isStaged();
+	if (sFailing.count(this))
+	{
+		return FALSE;
+	}
+
+	const LLVolumeFace& vf = volume.getVolumeFace(f);
+	LLMatrix4a mat_vert;
+	mat_vert.loadu(mat_vert_in);
+
+	LLStrider<U16> indices;
+	mVertexBuffer->getIndexStrider(indices, mIndicesIndex, vf.mNumIndices);
+	for (S32 i = 0; i < vf.mNumIndices; ++i)
+	{
+		indices[i] = vf.mIndices[i] + index_offset;
+	}
+
+	LLStrider<LLVector4a> verts;
+	mVertexBuffer->getVertexStrider(verts, mGeomIndex, vf.mNumVertices);
+	for (S32 i = 0; i < vf.mNumVertices; ++i)
+	{
+		mat_vert.affineTransform(vf.mPositions[i], verts[i]);
+	}
+
+	LLStrider<LLVector3> normals;
+	mVertexBuffer->getNormalStrider(normals, mGeomIndex, vf.mNumVertices);
+	for (S32 i = 0; i < vf.mNumVertices; ++i)
+	{
+		normals[i].set(vf.mNormals[i].getF32ptr());
+	}
+
+	LLStrider<LLVector2> tex_coords;
+	mVertexBuffer->getTexCoord0Strider(tex_coords, mGeomIndex, vf.mNumVertices);
+	for (S32 i = 0; i < vf.mNumVertices; ++i)
+	{
+		tex_coords[i] = vf.mTexCoords[i];
+	}
+	return TRUE;
+}
+
+namespace tut
+{
+	static const U32 FACE_MASK = LLVertexBuffer::MAP_VERTEX | LLVertexBuffer::MAP_NORMAL | LLVertexBuffer::MAP_TEXCOORD0;
+
+	// A face of one of the volumes, placed in a buffer of the group
+	struct GroupFace
+	{
+		LLFace*			mFace;
+		const LLVolume*	mVolume;
+		S32				mTE;
+		LLMatrix4		mMatVert;
+	};
+
+	struct Group
+	{
+		~Group()
+		{
+			for (GroupFace& face : mFaces)
+			{
+				delete face.mFace;
+			}
+		}
+
+		std::vector<LLPointer<LLVertexBuffer> >	mBuffers;
+		std::vector<GroupFace>					mFaces;	// in rebuild order
+	};
+
+	struct LLFaceGeometryBuilderFixture
+	{
+		LLFaceGeometryBuilderFixture()
+		:	mEnableVBOs(LLVertexBuffer::sEnableVBOs),
+			mPool("General", 3)
+		{
+			// Client side arrays, no GL context needed.
+			LLVertexBuffer::sEnableVBOs = false;
+			mPool.start();
+			sMainThread = std::this_thread::get_id();
+			sRecords.clear();
+			sFailing.clear();
+
+			const U8 shapes[][2] =
+			{
+				{ LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE },
+				{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_LINE },
+				{ LL_PCODE_PROFILE_CIRCLE_HALF, LL_PCODE_PATH_CIRCLE },
+				{ LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PATH_CIRCLE },
+			};
+			for (const U8* shape : shapes)
+			{
+				LLVolumeParams params;
+				params.setType(shape[0], shape[1]);
+				params.setBeginAndEndS(0.f, 1.f);
+				params.setBeginAndEndT(0.f, 1.f);
+				params.setRatio(1.f);
+				params.setShear(0.f);
+				mVolumes.push_back(new LLVolume(params, 2.f));
+			}
+		}
+
+		~LLFaceGeometryBuilderFixture()
+		{
+			// The next test starts a pool of the same name
+			mPool.close();
+			LLEventPumps::instance().obtain("LLApp").stopListening(mPool.getName());
+			LLVertexBuffer::sEnableVBOs = mEnableVBOs;
+		}
+
+		// Spreads every face of every volume, at copies positions, over
+		// buffer_count buffers, packed back to back as genDrawInfo() does.
+		void makeGroup(Group& group, S32 buffer_count, S32 copies)
+		{
+			std::vector<S32> verts(buffer_count, 0);
+			std::vector<S32> indices(buffer_count, 0);
+			std::vector<LLFace*> faces;
+			S32 next = 0;
+			for (S32 copy = 0; copy < copies; ++copy)
+			{
+				for (const LLPointer<LLVolume>& volume : mVolumes)
+				{
+					for (S32 f = 0; f < volume->getNumVolumeFaces(); ++f)
+					{
+						const LLVolumeFace& vf = volume->getVolumeFace(f);
+						GroupFace face;
+						face.mFace = new LLFace(NULL, NULL);
+						face.mFace->setGeomIndex(verts[next]);
+						face.mFace->setIndicesIndex(indices[next]);
+						face.mVolume = volume;
+						face.mTE = f;
+						face.mMatVert.setTranslation((F32)copy, (F32)f, 2.f * next);
+						group.mFaces.push_back(face);
+						faces.push_back(face.mFace);
+						verts[next] += vf.mNumVertices;
+						indices[next] += vf.mNumIndices;
+						next = (next + 1) % buffer_count;
+					}
+				}
+			}
+			for (S32 i = 0; i < buffer_count; ++i)
+			{
+				group.mBuffers.push_back(new LLVertexBuffer(FACE_MASK, 0));
+				group.mBuffers[i]->allocateBuffer(verts[i], indices[i], true);
+			}
+			for (size_t i = 0; i < faces.size(); ++i)
+			{
+				faces[i]->setVertexBuffer(group.mBuffers[i % buffer_count]);
+			}
+		}
+
+		// What LLVolumeGeometryManager does without the builder
+		static void rebuildInPlace(Group& group)
+		{
+			for (GroupFace& face : group.mFaces)
+			{
+				face.mFace->getGeometryVolume(*face.mVolume, face.mTE, face.mMatVert, LLMatrix3(),
+											  face.mFace->getGeomIndex());
+			}
+			flush(group);
+		}
+
+		static void rebuildWithBuilder(Group& group, std::vector<LLFace*>* failed = NULL)
+		{
+			LLFaceGeometryBuilder builder;
+			for (GroupFace& face : group.mFaces)
+			{
+				builder.add(face.mFace, *face.mVolume, face.mTE, face.mMatVert, LLMatrix3(),
+							face.mFace->getGeomIndex());
+			}
+			builder.run(failed);
+			ensure("emptied", builder.empty());
+			ensure_equals("buffers", builder.getBuffers().size(), group.mBuffers.size());
+			for (size_t i = 0; i < group.mBuffers.size(); ++i)
+			{
+				ensure("buffers in first use order", builder.getBuffers()[i] == group.mBuffers[i].get());
+			}
+			flush(group);
+		}
+
+		static void flush(Group& group)
+		{
+			for (LLPointer<LLVertexBuffer>& buffer : group.mBuffers)
+			{
+				ensure("unstaged", !buffer->isStaged());
+				buffer->flush();
+			}
+		}
+
+		bool mEnableVBOs;
+		LL::ThreadPool mPool;
+		std::vector<LLPointer<LLVolume> > mVolumes;
+	};
+
+	static void ensure_same_data(const std::string& msg, LLVertexBuffer* expected, LLVertexBuffer* actual)
+	{
+		ensure_equals(msg + " verts", actual->getNumVerts(), expected->getNumVerts());
+		ensure_equals(msg + " indices", actual->getNumIndices(), expected->getNumIndices());
+		const S32 types[] = { LLVertexBuffer::TYPE_VERTEX, LLVertexBuffer::TYPE_NORMAL, LLVertexBuffer::TYPE_TEXCOORD0 };
+		for (S32 type : types)
+		{
+			S32 offset = expected->getOffset(type);
+			S32 bytes = LLVertexBuffer::sTypeSize[type] * expected->getNumVerts();
+			ensure(msg + llformat(" type %d", type),
+				   0 == memcmp(expected->getMappedData() + offset, actual->getMappedData() + offset, bytes));
+		}
+		ensure(msg + " index data",
+			   0 == memcmp(expected->getMappedIndices(), actual->getMappedIndices(), sizeof(U16) * expected->getNumIndices()));
+	}
+
+	typedef test_group<LLFaceGeometryBuilderFixture> LLFaceGeometryBuilder_factory;
+	typedef LLFaceGeometryBuilder_factory::object LLFaceGeometryBuilder_t;
+	LLFaceGeometryBuilder_factory tf("LLFaceGeometryBuilder");
+
+	template<> template<>
+	void LLFaceGeometryBuilder_t::test<1>()
+	{
+		set_test_name("a group rebuilt on the General pool matches the in-place rebuild");
+		const S32 BUFFERS = 5;
+		Group serial;
+		Group parallel;
+		makeGroup(serial, BUFFERS, 3);
+		makeGroup(parallel, BUFFERS, 3);
+		rebuildInPlace(serial);
+		sSequence = 0;
+		rebuildWithBuilder(parallel);
+
+		for (S32 i = 0; i < BUFFERS; ++i)
+		{
+			ensure_same_data(llformat("buffer %d", i), serial.mBuffers[i], parallel.mBuffers[i]);
+		}
+
+		// One thread per buffer, in the order the faces were added, into
+		// the staged copy
+		for (S32 i = 0; i < BUFFERS; ++i)
+		{
+			S32 last = -1;
+			std::thread::id thread;
+			for (size_t f = i; f < parallel.mFaces.size(); f += BUFFERS)
+			{
+				const FaceRecord& record = sRecords[parallel.mFaces[f].mFace];
+				ensure_equals("prepared once", record.mPrepared, 1);
+				ensure("prepared on the calling thread", record.mPreparedOnMain);
+				ensure("rebuilt", record.mSequence >= 0);
+				ensure("in order", record.mSequence > last);
+				ensure("staged", record.mStaged);
+				ensure("one thread per buffer", f == (size_t)i || record.mThread == thread);
+				last = record.mSequence;
+				thread = record.mThread;
+			}
+		}
+	}
+
+	template<> template<>
+	void LLFaceGeometryBuilder_t::test<2>()
+	{
+		set_test_name("a small group is rebuilt in place on the calling thread");
+		Group group;
+		makeGroup(group, 1, 1);
+		ensure("fewer faces than are worth posting", group.mFaces.size() < 16);
+		rebuildWithBuilder(group);
+
+		Group expected;
+		makeGroup(expected, 1, 1);
+		rebuildInPlace(expected);
+		ensure_same_data("buffer", expected.mBuffers[0], group.mBuffers[0]);
+
+		for (GroupFace& face : group.mFaces)
+		{
+			const FaceRecord& record = sRecords[face.mFace];
+			ensure("on the calling thread", record.mThread == sMainThread);
+			ensure("not staged", !record.mStaged);
+		}
+	}
+
+	template<> template<>
+	void LLFaceGeometryBuilder_t::test<3>()
+	{
+		set_test_name("failed faces are handed back");
+		Group group;
+		makeGroup(group, 4, 3);
+		sFailing.insert(group.mFaces[2].mFace);
+		sFailing.insert(group.mFaces[group.mFaces.size() - 1].mFace);
+
+		std::vector<LLFace*> failed;
+		rebuildWithBuilder(group, &failed);
+		ensure_equals("failed", failed.size(), (size_t)2);
+		ensure("both", sFailing.count(failed[0]) && sFailing.count(failed[1]) && failed[0] != failed[1]);
+		for (GroupFace& face : group.mFaces)
+		{
+			ensure("the others ran too", sRecords[face.mFace].mSequence >= 0);
+		}
+	}
+
+	template<> template<>
+	void LLFaceGeometryBuilder_t::test<4>()
+	{
+		set_test_name("follows FSParallelGeometryRebuild, and stays off with transform feedback or the octree display");
+		gSavedSettings.declareBOOL("FSParallelGeometryRebuild", FALSE, "", LLControlVariable::PERSIST_NO);
+		gSavedSettings.declareBOOL("RenderUseTransformFeedback", FALSE, "", LLControlVariable::PERSIST_NO);
+		ensure("off", !LLFaceGeometryBuilder::isEnabled());
+
+		gSavedSettings.setBOOL("FSParallelGeometryRebuild", TRUE);
+		ensure("on", LLFaceGeometryBuilder::isEnabled());
+
+		gSavedSettings.setBOOL("RenderUseTransformFeedback", TRUE);
+		ensure("transform feedback", !LLFaceGeometryBuilder::isEnabled());
+		gSavedSettings.setBOOL("RenderUseTransformFeedback", FALSE);
+
+		gPipeline.setAllRenderDebugDisplays();
+		ensure("octree display", !LLFaceGeometryBuilder::isEnabled());
+		gPipeline.clearAllRenderDebugDisplays();
+		ensure("on again", LLFaceGeometryBuilder::isEnabled());
+		gSavedSettings.setBOOL("FSParallelGeometryRebuild", FALSE);
+	}
+}
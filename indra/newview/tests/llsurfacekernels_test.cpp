@@ -0,0 +1,242 @@
+/**
+ * @file llsurfacekernels_test.cpp
+ * @brief Tests and update cost harness for the terrain height field kernels.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../test/lltut.h"
+
+#include "../llsurfacekernels.h"
+
+#include "llrand.h"
+
+namespace
+{
+	// A region's surface, as LLSurface lays it out: 256 grids, 16 per patch
+	// and a buffer row and column on the north and east
+	const U32 GRIDS = 256;
+	const U32 STRIDE = GRIDS + 1;
+	const U32 PATCH = 16;
+	const F32 METERS_PER_GRID = 1.f;
+
+	void make_terrain(std::vector<F32>& heights)
+	{
+		heights.resize(STRIDE*STRIDE);
+		for (U32 j = 0; j < STRIDE; j++)
+		{
+			for (U32 i = 0; i < STRIDE; i++)
+			{
+				heights[i + j*STRIDE] = 20.f + 8.f*sinf(i*0.05f)*cosf(j*0.07f) + ll_frand(0.5f);
+			}
+		}
+	}
+
+	// What the simulator sends for a terraform stroke: the whole patch, with
+	// a few heights raised around x, y
+	void make_edit(const std::vector<F32>& heights, U32 patch_x, U32 patch_y, U32 x, U32 y, S32 radius,
+				   std::vector<F32>& patch)
+	{
+		patch.resize(PATCH*PATCH);
+		for (U32 j = 0; j < PATCH; j++)
+		{
+			for (U32 i = 0; i < PATCH; i++)
+			{
+				F32 height = heights[patch_x*PATCH + i + (patch_y*PATCH + j)*STRIDE];
+				S32 dx = (S32)i - (S32)x;
+				S32 dy = (S32)j - (S32)y;
+				if (dx*dx + dy*dy <= radius*radius)
+				{
+					height += 0.25f;
+				}
+				patch[i + j*PATCH] = height;
+			}
+		}
+	}
+
+	// Recomputes the normals in rect, clamped to where all samples are on
+	// the surface
+	void update_normals(const std::vector<F32>& heights, std::vector<LLVector3>& normals, LLRect rect, bool vectorised)
+	{
+		rect.intersectWith(LLRect(2, STRIDE - 2, STRIDE - 2, 2));
+		for (S32 y = rect.mBottom; y < rect.mTop; y++)
+		{
+			if (vectorised)
+			{
+				calc_surface_normals_row(&heights[0], &normals[0], STRIDE, rect.mLeft, rect.mRight, y, 2, METERS_PER_GRID);
+			}
+			else
+			{
+				for (S32 x = rect.mLeft; x < rect.mRight; x++)
+				{
+					normals[x + y*STRIDE] = calc_surface_normal(&heights[0], STRIDE, x, y, 2, METERS_PER_GRID);
+				}
+			}
+		}
+	}
+}
+
+namespace tut
+{
+	struct LLSurfaceKernelsFixture
+	{
+	};
+
+	typedef test_group<LLSurfaceKernelsFixture> LLSurfaceKernelsTestGroup;
+	typedef LLSurfaceKernelsTestGroup::object LLSurfaceKernelsTestObject;
+	LLSurfaceKernelsTestGroup surfaceKernelsTestGroup("LLSurfaceKernels");
+
+	template<> template<>
+	void LLSurfaceKernelsTestObject::test<1>()
+	{
+		set_test_name("vectorised normals match calc_surface_normal");
+		std::vector<F32> heights;
+		make_terrain(heights);
+		std::vector<LLVector3> normals(STRIDE*STRIDE);
+
+		// Odd spans leave a remainder for the scalar tail
+		for (U32 y = 2; y < STRIDE - 2; y += 3)
+		{
+			const U32 x_begin = 2 + y % 5;
+			calc_surface_normals_row(&heights[0], &normals[0], STRIDE, x_begin, STRIDE - 2, y, 2, METERS_PER_GRID);
+			for (U32 x = x_begin; x < STRIDE - 2; x++)
+			{
+				LLVector3 expected = calc_surface_normal(&heights[0], STRIDE, x, y, 2, METERS_PER_GRID);
+				for (S32 k = 0; k < 3; k++)
+				{
+					// Exact unless the compiler fuses the scalar multiply adds
+					ensure_approximately_equals("normal", normals[x + y*STRIDE].mV[k], expected.mV[k], 20);
+				}
+			}
+		}
+	}
+
+	template<> template<>
+	void LLSurfaceKernelsTestObject::test<2>()
+	{
+		set_test_name("copy_changed_heights");
+		std::vector<F32> heights;
+		make_terrain(heights);
+		std::vector<F32> patch;
+
+		// Same heights, nothing changed
+		make_edit(heights, 3, 5, 100, 100, 0, patch);
+		LLRect changed = copy_changed_heights(&heights[3*PATCH + 5*PATCH*STRIDE], STRIDE, &patch[0], PATCH, PATCH);
+		ensure("unchanged", changed.isEmpty());
+
+		make_edit(heights, 3, 5, 6, 9, 2, patch);
+		changed = copy_changed_heights(&heights[3*PATCH + 5*PATCH*STRIDE], STRIDE, &patch[0], PATCH, PATCH);
+		ensure_equals("left", changed.mLeft, 4);
+		ensure_equals("right", changed.mRight, 9);
+		ensure_equals("bottom", changed.mBottom, 7);
+		ensure_equals("top", changed.mTop, 12);
+		ensure_equals("copied", heights[3*PATCH + 6 + (5*PATCH + 9)*STRIDE], patch[6 + 9*PATCH]);
+
+		// -0 and 0 are the same height
+		heights[0] = 0.f;
+		make_edit(heights, 0, 0, 100, 100, 0, patch);
+		patch[0] = -0.f;
+		changed = copy_changed_heights(&heights[0], STRIDE, &patch[0], PATCH, PATCH);
+		ensure("signed zero", changed.isEmpty());
+
+		// Edits on the patch corners
+		make_edit(heights, 0, 0, 15, 0, 0, patch);
+		changed = copy_changed_heights(&heights[0], STRIDE, &patch[0], PATCH, PATCH);
+		ensure("southeast corner", changed == LLRect(15, 1, 16, 0));
+		make_edit(heights, 0, 0, 0, 15, 0, patch);
+		changed = copy_changed_heights(&heights[0], STRIDE, &patch[0], PATCH, PATCH);
+		ensure("northwest corner", changed == LLRect(0, 16, 1, 15));
+	}
+
+	template<> template<>
+	void LLSurfaceKernelsTestObject::test<3>()
+	{
+		set_test_name("dirty rect updates match whole patch updates");
+		const S32 EDITS = 200;
+
+		std::vector<F32> start_heights;
+		make_terrain(start_heights);
+		std::vector<LLVector3> start_normals(STRIDE*STRIDE);
+		update_normals(start_heights, start_normals, LLRect(0, STRIDE, STRIDE, 0), false);
+
+		struct Edit
+		{
+			U32 mPatchX, mPatchY, mX, mY;
+			S32 mRadius;
+		};
+		std::vector<Edit> edits(EDITS);
+		for (Edit& edit : edits)
+		{
+			edit.mPatchX = ll_rand(GRIDS/PATCH);
+			edit.mPatchY = ll_rand(GRIDS/PATCH);
+			edit.mX = ll_rand(PATCH);
+			edit.mY = ll_rand(PATCH);
+			edit.mRadius = ll_rand(4);
+		}
+
+		std::vector<F32> patch;
+		std::vector<LLVector3> normals[2];
+		for (S32 pass = 0; pass < 2; pass++)
+		{
+			const bool dirty_rect = pass == 1;
+			std::vector<F32> heights = start_heights;
+			normals[pass] = start_normals;
+
+			for (const Edit& edit : edits)
+			{
+				make_edit(heights, edit.mPatchX, edit.mPatchY, edit.mX, edit.mY, edit.mRadius, patch);
+
+				F32* dataz = &heights[edit.mPatchX*PATCH + edit.mPatchY*PATCH*STRIDE];
+				LLRect rect;
+				if (dirty_rect)
+				{
+					// Copy what changed, then the normals two grids around it
+					rect = copy_changed_heights(dataz, STRIDE, &patch[0], PATCH, PATCH);
+					rect.stretch(2);
+				}
+				else
+				{
+					// Copy the patch, then all normals of it and the edges
+					// of its neighbors
+					for (U32 j = 0; j < PATCH; j++)
+					{
+						memcpy(dataz + j*STRIDE, &patch[j*PATCH], PATCH*sizeof(F32));
+					}
+					rect.setOriginAndSize(-2, -2, PATCH + 4, PATCH + 4);
+				}
+				rect.translate(edit.mPatchX*PATCH, edit.mPatchY*PATCH);
+				update_normals(heights, normals[pass], rect, dirty_rect);
+			}
+		}
+
+		for (U32 i = 0; i < STRIDE*STRIDE; i++)
+		{
+			for (S32 k = 0; k < 3; k++)
+			{
+				ensure_approximately_equals("normal", normals[1][i].mV[k], normals[0][i].mV[k], 20);
+			}
+		}
+	}
+}
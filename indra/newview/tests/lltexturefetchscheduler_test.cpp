@@ -0,0 +1,400 @@
+/**
+ * @file lltexturefetchscheduler_test.cpp
+ * @brief Tests and camera pan simulation for LLTextureFetchScheduler.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../test/lltut.h"
+
+#include "../lltexturefetchscheduler.h"
+
+#include "llmath.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+namespace
+{
+	typedef LLTextureFetchScheduler::policy_t policy_t;
+	typedef LLTextureFetchScheduler::request_list_t request_list_t;
+
+	const policy_t TEXTURE_POLICY = 1;
+	const policy_t BAKE_POLICY = 2;
+
+	LLUUID make_id(U32 n)
+	{
+		LLUUID id;
+		memcpy(id.mData, &n, sizeof(n));
+		id.mData[15] = 1;
+		return id;
+	}
+
+	// Angle between a bearing and the view direction
+	F32 off_view(F32 bearing, F32 camera)
+	{
+		F32 angle = fmodf(bearing - camera, F_TWO_PI);
+		if (angle < 0.f)
+		{
+			angle += F_TWO_PI;
+		}
+		return llmin(angle, F_TWO_PI - angle);
+	}
+
+	// A region's worth of textures around the camera, each at a bearing
+	struct SimTexture
+	{
+		enum EState { IDLE, WAITING, ACTIVE, DONE };
+
+		LLUUID mID;
+		policy_t mPolicy;
+		F32 mBearing;
+		F32 mSize;			// bytes
+		F32 mReceived;
+		F64 mStartTime;		// when the first byte may arrive
+		F32 mOffScreenTime;
+		F32 mPriority;		// what the viewer last told the fetcher
+		EState mState;
+	};
+
+	struct SimResult
+	{
+		F64 mUsefulBytes;
+		F64 mWastedBytes;
+		S32 mCanceled;
+		F64 mTotalWait;
+		F64 mMaxWait;
+		S32 mReleased;
+		S32 mMaxActive[3];
+		S32 mAcquireFailures;
+	};
+
+	// Pans the camera around a scene of textures and fetches them from a
+	// stand-in for the texture service, one shared link with a fixed
+	// latency, through an LLTextureFetchScheduler the way LLTextureFetch
+	// uses it.  With cancel, what stays off screen for the hold time is
+	// dropped from the queue or canceled in flight, as the worker does
+	// when its priority goes to zero.
+	SimResult simulate(bool cancel)
+	{
+		const S32 TEXTURES = 3000;
+		const F32 FOV = 1.2f;
+		const F32 PAN_RATE = 0.15f;				// radians per second
+		const F32 STEP = 0.05f;
+		const F32 DURATION = 40.f;
+		const F32 HOLD_TIME = 5.f;				// LLViewerFetchedTexture's MAX_HOLD_TIME
+		const F32 BANDWIDTH = 1000.f * 1024.f;	// bytes per second
+		const F32 LATENCY = 0.15f;
+
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<F32> bearing(0.f, F_TWO_PI);
+		std::uniform_real_distribution<F32> size(16.f * 1024.f, 256.f * 1024.f);
+		std::vector<SimTexture> textures(TEXTURES);
+		for (S32 i = 0; i < TEXTURES; i++)
+		{
+			SimTexture& texture = textures[i];
+			texture.mID = make_id(i);
+			texture.mPolicy = i % 10 ? TEXTURE_POLICY : BAKE_POLICY;
+			texture.mBearing = bearing(rng);
+			texture.mSize = size(rng);
+			texture.mReceived = 0.f;
+			texture.mStartTime = 0.0;
+			texture.mOffScreenTime = 0.f;
+			texture.mPriority = 0.f;
+			texture.mState = SimTexture::IDLE;
+		}
+
+		std::map<LLUUID, S32> index;
+		for (S32 i = 0; i < TEXTURES; i++)
+		{
+			index[textures[i].mID] = i;
+		}
+
+		LLTextureFetchScheduler scheduler;
+		scheduler.setLimits(TEXTURE_POLICY, 20, 40);
+		scheduler.setLimits(BAKE_POLICY, 2, 4);
+
+		SimResult result;
+		memset(&result, 0, sizeof(result));
+		F64 now = 0.0;
+		F32 camera = 0.f;
+		request_list_t ready;
+		std::vector<S32> active;
+		for (F32 t = 0.f; t < DURATION; t += STEP, now += STEP)
+		{
+			camera += PAN_RATE * STEP;
+
+			for (SimTexture& texture : textures)
+			{
+				F32 off = off_view(texture.mBearing, camera);
+				bool on_screen = off < FOV * 0.5f;
+				texture.mOffScreenTime = on_screen ? 0.f : texture.mOffScreenTime + STEP;
+
+				F32 priority = texture.mPriority;
+				if (on_screen)
+				{
+					// Centre of the view first, bigger ones first
+					priority = 1000.f * (1.f - off / FOV) + texture.mSize / 1024.f;
+				}
+				else if (texture.mOffScreenTime > HOLD_TIME)
+				{
+					priority = 0.f;
+				}
+				if (priority == texture.mPriority)
+				{
+					continue;
+				}
+				texture.mPriority = priority;
+
+				if (texture.mState == SimTexture::IDLE && priority > 0.f)
+				{
+					texture.mState = SimTexture::WAITING;
+					scheduler.push(texture.mID, texture.mPolicy, priority, now);
+				}
+				else if (texture.mState == SimTexture::WAITING)
+				{
+					if (cancel && priority <= 0.f)
+					{
+						scheduler.remove(texture.mID);
+						texture.mState = SimTexture::IDLE;
+						result.mCanceled++;
+					}
+					else
+					{
+						scheduler.updatePriority(texture.mID, priority);
+					}
+				}
+			}
+
+			ready.clear();
+			scheduler.popReady(ready);
+			for (const LLTextureFetchScheduler::Request& request : ready)
+			{
+				if (!scheduler.acquire(request.mPolicy))
+				{
+					result.mAcquireFailures++;
+				}
+				scheduler.remove(request.mID);
+				SimTexture& texture = textures[index[request.mID]];
+				texture.mState = SimTexture::ACTIVE;
+				texture.mStartTime = now + LATENCY;
+				active.push_back(index[request.mID]);
+				result.mTotalWait += now - request.mQueuedTime;
+				result.mMaxWait = llmax(result.mMaxWait, now - request.mQueuedTime);
+				result.mReleased++;
+			}
+
+			for (policy_t policy = TEXTURE_POLICY; policy <= BAKE_POLICY; policy++)
+			{
+				result.mMaxActive[policy] = llmax(result.mMaxActive[policy], scheduler.getActive(policy));
+			}
+
+			// The link is shared evenly by whatever is past its latency
+			S32 streaming = 0;
+			for (S32 i : active)
+			{
+				streaming += textures[i].mStartTime <= now;
+			}
+			const F32 share = streaming ? BANDWIDTH * STEP / streaming : 0.f;
+			for (std::vector<S32>::iterator iter = active.begin(); iter != active.end(); )
+			{
+				SimTexture& texture = textures[*iter];
+				if (cancel && texture.mPriority <= 0.f)
+				{
+					// Canceled in flight, what arrived so far is lost
+					result.mWastedBytes += texture.mReceived;
+					result.mCanceled++;
+					texture.mReceived = 0.f;
+					texture.mState = SimTexture::IDLE;
+				}
+				else if (texture.mStartTime <= now)
+				{
+					texture.mReceived = llmin(texture.mReceived + share, texture.mSize);
+					if (texture.mReceived < texture.mSize)
+					{
+						++iter;
+						continue;
+					}
+					if (texture.mPriority <= 0.f)
+					{
+						result.mWastedBytes += texture.mSize;
+					}
+					else
+					{
+						result.mUsefulBytes += texture.mSize;
+					}
+					texture.mState = SimTexture::DONE;
+				}
+				else
+				{
+					++iter;
+					continue;
+				}
+				scheduler.release(texture.mPolicy);
+				iter = active.erase(iter);
+			}
+		}
+		return result;
+	}
+}
+
+namespace tut
+{
+	struct LLTextureFetchSchedulerFixture
+	{
+	};
+
+	typedef test_group<LLTextureFetchSchedulerFixture> LLTextureFetchSchedulerTestGroup;
+	typedef LLTextureFetchSchedulerTestGroup::object LLTextureFetchSchedulerTestObject;
+	LLTextureFetchSchedulerTestGroup textureFetchSchedulerTestGroup("LLTextureFetchScheduler");
+
+	template<> template<>
+	void LLTextureFetchSchedulerTestObject::test<1>()
+	{
+		set_test_name("released highest priority first after reprioritising");
+		const S32 REQUESTS = 500;
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<F32> priority(0.f, 1000.f);
+
+		LLTextureFetchScheduler scheduler;
+		std::map<LLUUID, F32> expected;
+		for (S32 i = 0; i < REQUESTS; i++)
+		{
+			F32 p = priority(rng);
+			scheduler.push(make_id(i), TEXTURE_POLICY, p, i);
+			expected[make_id(i)] = p;
+		}
+		for (S32 i = 0; i < REQUESTS * 4; i++)
+		{
+			LLUUID id = make_id(rng() % REQUESTS);
+			if (expected.count(id))
+			{
+				if (rng() % 8)
+				{
+					F32 p = priority(rng);
+					ensure("reprioritised", scheduler.updatePriority(id, p));
+					expected[id] = p;
+				}
+				else
+				{
+					ensure("removed", scheduler.remove(id));
+					expected.erase(id);
+				}
+			}
+			else
+			{
+				ensure("not queued", !scheduler.updatePriority(id, 1.f));
+			}
+		}
+		ensure_equals("size", scheduler.size(), (S32)expected.size());
+		ensure_equals("class size", scheduler.size(TEXTURE_POLICY), (S32)expected.size());
+
+		// Unlimited class, everything comes out in order
+		request_list_t ready;
+		scheduler.popReady(ready);
+		ensure_equals("all ready", ready.size(), expected.size());
+		for (size_t i = 0; i < ready.size(); i++)
+		{
+			ensure_equals("priority", ready[i].mPriority, expected[ready[i].mID]);
+			ensure("order", i == 0 || ready[i - 1].mPriority >= ready[i].mPriority);
+			ensure("still queued", scheduler.isQueued(ready[i].mID));
+		}
+		ensure_equals("heap empty", scheduler.size(TEXTURE_POLICY), 0);
+
+		// Put back, they come out in the same order again
+		for (const LLTextureFetchScheduler::Request& request : ready)
+		{
+			scheduler.restore(request);
+		}
+		request_list_t again;
+		scheduler.popReady(again);
+		ensure_equals("restored", again.size(), ready.size());
+		for (size_t i = 0; i < again.size(); i++)
+		{
+			ensure_equals("same priority", again[i].mPriority, ready[i].mPriority);
+			ensure_equals("same queued time", again[i].mQueuedTime, ready[i].mQueuedTime);
+			ensure("removed after release", scheduler.remove(again[i].mID));
+		}
+		ensure_equals("drained", scheduler.size(), 0);
+	}
+
+	template<> template<>
+	void LLTextureFetchSchedulerTestObject::test<2>()
+	{
+		set_test_name("per policy class limits");
+		LLTextureFetchScheduler scheduler;
+		scheduler.setLimits(TEXTURE_POLICY, 2, 4);
+		scheduler.setLimits(BAKE_POLICY, 1, 1);
+		for (S32 i = 0; i < 10; i++)
+		{
+			scheduler.push(make_id(i), i < 5 ? TEXTURE_POLICY : BAKE_POLICY, (F32)i, 0.0);
+		}
+
+		request_list_t ready;
+		scheduler.popReady(ready);
+		ensure_equals("high water of each", ready.size(), (size_t)5);
+		ensure_equals("textures first", ready[0].mID, make_id(4));
+		ensure_equals("then bake", ready[4].mID, make_id(9));
+		for (const LLTextureFetchScheduler::Request& request : ready)
+		{
+			ensure("acquired", scheduler.acquire(request.mPolicy));
+			scheduler.remove(request.mID);
+		}
+		ensure("texture class full", !scheduler.acquire(TEXTURE_POLICY));
+		ensure("bake class full", !scheduler.acquire(BAKE_POLICY));
+		ensure("other class unlimited", scheduler.acquire(3));
+
+		// Nothing until a class is below its low water
+		ready.clear();
+		scheduler.release(TEXTURE_POLICY);
+		scheduler.release(TEXTURE_POLICY);
+		scheduler.popReady(ready);
+		ensure("at low water", ready.empty());
+		scheduler.release(TEXTURE_POLICY);
+		scheduler.popReady(ready);
+		ensure_equals("refilled to high water", ready.size(), (size_t)1);
+		ensure_equals("last texture", ready[0].mID, make_id(0));
+		ensure_equals("bakes still waiting", scheduler.size(BAKE_POLICY), 4);
+	}
+
+	template<> template<>
+	void LLTextureFetchSchedulerTestObject::test<3>()
+	{
+		set_test_name("camera pan");
+		SimResult keep = simulate(false);
+		SimResult cancel = simulate(true);
+
+		ensure_equals("released without a slot", keep.mAcquireFailures + cancel.mAcquireFailures, 0);
+		ensure("texture limit", cancel.mMaxActive[TEXTURE_POLICY] <= 40);
+		ensure("bake limit", cancel.mMaxActive[BAKE_POLICY] <= 4);
+		ensure("canceled", cancel.mCanceled > 0);
+		ensure("less wasted", cancel.mWastedBytes < keep.mWastedBytes * 0.75);
+		ensure("more useful", cancel.mUsefulBytes >= keep.mUsefulBytes);
+		ensure("shorter mean wait", cancel.mTotalWait / cancel.mReleased < keep.mTotalWait / keep.mReleased);
+		// Nothing sits at the bottom of the queue behind what is in view
+		ensure("shorter wait", cancel.mMaxWait < keep.mMaxWait * 0.5);
+	}
+}
@@ -0,0 +1,193 @@
+/**
+ * @file lltexturepriority_test.cpp
+ * @brief Tests and frame cost harness for LLTexturePriorityTable.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "../llviewerprecompiledheaders.h"
+
+#include "../test/lltut.h"
+
+#include "../lltexturepriority.h"
+
+#include "llgltexture.h"
+#include "llimage.h"
+#include "llrand.h"
+
+#include <algorithm>
+
+namespace
+{
+	typedef LLTexturePriorityTable::slot_t slot_t;
+
+	// Inputs as a scene produces them: most textures on screen at some
+	// size, some off screen, some loaded, a few boosted or still waiting
+	// for their GL texture.  Returns the flags set.
+	U32 randomize(LLTexturePriorityTable& table, slot_t slot)
+	{
+		const S32 boosts[] = { LLGLTexture::BOOST_NONE, LLGLTexture::BOOST_NONE, LLGLTexture::BOOST_NONE,
+							   LLGLTexture::BOOST_AVATAR, LLGLTexture::BOOST_SELECTED, LLGLTexture::BOOST_HIGH,
+							   LLGLTexture::BOOST_SUPER_HIGH, LLGLTexture::BOOST_UI, LLGLTexture::BOOST_ICON };
+		table.setVirtualSize(slot, ll_rand(8) ? ll_frand(1024.f*1024.f) : 0.f);
+		table.setBoostLevel(slot, boosts[ll_rand(LL_ARRAY_SIZE(boosts))]);
+		table.setDiscardLevels(slot, ll_rand(MAX_DISCARD_LEVEL + 2) - 1, ll_rand(MAX_DISCARD_LEVEL + 2));
+		U32 flags = 0;
+		switch (ll_rand(16))
+		{
+		case 0: flags = LLTexturePriorityTable::FULLY_LOADED; break;
+		case 1: flags = LLTexturePriorityTable::MISSING_ASSET; break;
+		case 2: flags = LLTexturePriorityTable::WAITING_CREATE; break;
+		default: break;
+		}
+		table.setFlags(slot, flags);
+		return flags;
+	}
+
+	bool changed(F32 now, F32 then)
+	{
+		now = llmax(now, 0.f);
+		then = llmax(then, 0.f);
+		return now < then * 0.8f || now > then * 1.25f;
+	}
+}
+
+namespace tut
+{
+	struct LLTexturePriorityFixture
+	{
+	};
+
+	typedef test_group<LLTexturePriorityFixture> LLTexturePriorityTestGroup;
+	typedef LLTexturePriorityTestGroup::object LLTexturePriorityTestObject;
+	LLTexturePriorityTestGroup texturePriorityTestGroup("LLTexturePriorityTable");
+
+	template<> template<>
+	void LLTexturePriorityTestObject::test<1>()
+	{
+		set_test_name("selection matches the scalar estimate");
+		// Not a multiple of four, the last group is part padding
+		const S32 TEXTURES = 1003;
+		LLTexturePriorityTable table;
+		std::vector<U32> flags(TEXTURES);
+		std::vector<F32> evaluated(TEXTURES, 0.f);
+		for (S32 i = 0; i < TEXTURES; i++)
+		{
+			ensure_equals("slot", table.add(NULL), i);
+			flags[i] = randomize(table, i);
+		}
+
+		for (S32 round = 0; round < 20; round++)
+		{
+			std::vector<slot_t> expected;
+			for (S32 i = 0; i < TEXTURES; i++)
+			{
+				if (!(flags[i] & LLTexturePriorityTable::WAITING_CREATE) && changed(table.estimate(i), evaluated[i]))
+				{
+					expected.push_back(i);
+				}
+			}
+
+			std::vector<slot_t> selected;
+			table.selectChanged(TEXTURES, selected);
+			ensure("some changed", !expected.empty());
+			for (size_t i = 1; i < selected.size(); i++)
+			{
+				ensure("highest first", table.estimate(selected[i - 1]) >= table.estimate(selected[i]));
+			}
+			std::vector<slot_t> sorted(selected);
+			std::sort(sorted.begin(), sorted.end());
+			ensure("changed slots", sorted == expected);
+
+			// A limited selection is the top of the full one
+			std::vector<slot_t> top;
+			table.selectChanged(16, top);
+			ensure_equals("top count", top.size(), llmin(selected.size(), (size_t)16));
+			for (size_t i = 0; i < top.size(); i++)
+			{
+				ensure_equals("top estimate", table.estimate(top[i]), table.estimate(selected[i]));
+			}
+
+			// Half get evaluated, the rest keep their old estimate, then
+			// the scene moves
+			for (slot_t slot : selected)
+			{
+				if (ll_rand(2))
+				{
+					table.setEvaluated(slot);
+					evaluated[slot] = table.estimate(slot);
+				}
+			}
+			for (S32 i = 0; i < TEXTURES / 10; i++)
+			{
+				S32 slot = ll_rand(TEXTURES);
+				flags[slot] = randomize(table, slot);
+			}
+		}
+	}
+
+	template<> template<>
+	void LLTexturePriorityTestObject::test<2>()
+	{
+		set_test_name("evaluated and removed slots are not selected");
+		LLTexturePriorityTable table;
+		std::vector<slot_t> slots;
+		for (S32 i = 0; i < 100; i++)
+		{
+			slot_t slot = table.add(NULL);
+			table.setVirtualSize(slot, 64.f*64.f);
+			table.setDiscardLevels(slot, -1, 0);
+			slots.push_back(slot);
+		}
+
+		std::vector<slot_t> selected;
+		table.selectChanged(1000, selected);
+		ensure_equals("new textures", selected.size(), (size_t)100);
+
+		for (slot_t slot : slots)
+		{
+			table.setEvaluated(slot);
+		}
+		selected.clear();
+		table.selectChanged(1000, selected);
+		ensure("nothing changed", selected.empty());
+
+		// Within the margin
+		table.setVirtualSize(slots[3], 65.f*65.f);
+		// Half way loaded, the discard difference halved
+		table.setDiscardLevels(slots[5], 2, 0);
+		table.remove(slots[7]);
+		table.setDiscardLevels(slots[9], 2, 0);
+		table.setFlags(slots[9], LLTexturePriorityTable::WAITING_CREATE);
+		selected.clear();
+		table.selectChanged(1000, selected);
+		ensure_equals("one changed", selected.size(), (size_t)1);
+		ensure_equals("loading texture", selected[0], slots[5]);
+		ensure_equals("size", table.size(), 99U);
+
+		// Freed slots are handed out again
+		ensure_equals("reused", table.add(NULL), slots[7]);
+		table.clear();
+		ensure_equals("cleared", table.size(), 0U);
+	}
+}